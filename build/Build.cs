@@ -128,6 +128,7 @@ class AlphaVssBuild : NukeBuild
        .Executes(() =>
        {
           BuildProject("AlphaVSS.Common", Configuration, "AnyCPU");
+          BuildProject("AlphaVSS.Simulation", Configuration, "AnyCPU");
 
           BuildPlatformProject("core31");
           BuildPlatformProject("net45");
@@ -161,6 +162,17 @@ class AlphaVssBuild : NukeBuild
           }
        });
 
+   Target Test => _ => _
+      .DependsOn(Compile)
+      .Executes(() =>
+      {
+         var project = Solution.AllProjects.FirstOrDefault(p => p.Name == "AlphaVSS.Common.Tests").NotNull($"Unable to find project named AlphaVSS.Common.Tests in solution {Solution.Name}");
+
+         DotNetTasks.DotNetTest(_ => _
+            .SetProjectFile(project)
+            .SetConfiguration(Configuration));
+      });
+
    Target DocMetadata => _ => _
       .DependsOn(Compile)
       .Executes(() =>
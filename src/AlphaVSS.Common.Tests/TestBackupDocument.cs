@@ -0,0 +1,101 @@
+
+using System;
+using System.Globalization;
+using System.Text;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   /// <summary>
+   /// Builds saved Backup Components Documents in the form returned by <see cref="IVssBackupComponents.SaveAsXml"/>.
+   /// </summary>
+   internal sealed class TestBackupDocument
+   {
+      private readonly StringBuilder m_xml = new StringBuilder();
+      private bool m_inWriter;
+      private bool m_inComponent;
+
+      public TestBackupDocument(Guid snapshotSetId, VssBackupType backupType)
+      {
+         m_xml.AppendFormat(CultureInfo.InvariantCulture,
+            "<BACKUP_COMPONENTS xmlns=\"x-schema:#VssComponentMetadata\" version=\"1.2\" bootableSystemStateBackup=\"no\" selectComponents=\"yes\" backupType=\"{0}\" partialFileSupport=\"yes\" snapshotSetId=\"{1}\">",
+            backupType.ToString().ToUpperInvariant(), snapshotSetId.ToString("D"));
+         m_xml.Append("<Schema name=\"VssComponentMetadata\" xmlns=\"urn:schemas-microsoft-com:xml-data\"><ElementType name=\"COMPONENT\" content=\"eltOnly\"/></Schema>");
+      }
+
+      public TestBackupDocument Writer(Guid instanceId, Guid writerId)
+      {
+         EndWriter();
+         m_xml.AppendFormat(CultureInfo.InvariantCulture, "<WRITER_COMPONENTS instanceId=\"{0}\" writerId=\"{1}\">", instanceId.ToString("D"), writerId.ToString("D"));
+         m_xml.Append("<WRITER_METADATA><![CDATA[opaque]]></WRITER_METADATA>");
+         m_inWriter = true;
+         return this;
+      }
+
+      public TestBackupDocument Component(string logicalPath, string componentName, string componentType, bool backupSucceeded, string backupStamp, string previousBackupStamp, string backupOptions)
+      {
+         EndComponent();
+         m_xml.Append("<COMPONENT");
+         Attribute("logicalPath", logicalPath);
+         Attribute("componentName", componentName);
+         Attribute("componentType", componentType);
+         Attribute("backupSucceeded", backupSucceeded ? "yes" : "no");
+         Attribute("backupStamp", backupStamp);
+         Attribute("previousBackupStamp", previousBackupStamp);
+         Attribute("backupOptions", backupOptions);
+         m_xml.Append("><COMPONENT_METADATA><![CDATA[blob]]></COMPONENT_METADATA>");
+         m_inComponent = true;
+         return this;
+      }
+
+      public TestBackupDocument PartialFile(string path, string fileSpecification, string ranges, string metadata)
+      {
+         m_xml.Append("<PARTIAL_FILE");
+         Attribute("path", path);
+         Attribute("filespec", fileSpecification);
+         Attribute("ranges", ranges);
+         Attribute("metadata", metadata);
+         m_xml.Append("/>");
+         return this;
+      }
+
+      public TestBackupDocument DifferencedFile(string path, string fileSpecification, bool recursive, DateTime lastModifyTime)
+      {
+         m_xml.Append("<DIFFERENCED_FILE");
+         Attribute("path", path);
+         Attribute("filespec", fileSpecification);
+         Attribute("recursive", recursive ? "yes" : "no");
+         Attribute("lastModifyTime", "0x" + lastModifyTime.ToFileTimeUtc().ToString("X", CultureInfo.InvariantCulture));
+         m_xml.Append("/>");
+         return this;
+      }
+
+      public override string ToString()
+      {
+         EndWriter();
+         return m_xml + "</BACKUP_COMPONENTS>";
+      }
+
+      private void Attribute(string name, string value)
+      {
+         if (value != null)
+            m_xml.Append(' ').Append(name).Append("=\"").Append(value.Replace("&", "&amp;").Replace("\"", "&quot;").Replace("<", "&lt;")).Append('"');
+      }
+
+      private void EndComponent()
+      {
+         if (m_inComponent)
+            m_xml.Append("</COMPONENT>");
+
+         m_inComponent = false;
+      }
+
+      private void EndWriter()
+      {
+         EndComponent();
+         if (m_inWriter)
+            m_xml.Append("</WRITER_COMPONENTS>");
+
+         m_inWriter = false;
+      }
+   }
+}
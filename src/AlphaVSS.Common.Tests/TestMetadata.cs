@@ -0,0 +1,41 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   /// <summary>
+   /// Builds captured writer metadata for tests, without VSS.
+   /// </summary>
+   internal static class TestMetadata
+   {
+      public static VssWMFileDescriptor File(string path, string fileSpecification, bool isRecursive)
+      {
+         return new VssWMFileDescriptor(null, VssFileSpecificationBackupType.FullBackupRequired, fileSpecification, path, isRecursive);
+      }
+
+      public static VssCapturedComponent Component(string componentName, params VssWMFileDescriptor[] files)
+      {
+         return Component(VssComponentType.FileGroup, null, componentName, files, new VssWMFileDescriptor[0], new VssWMFileDescriptor[0]);
+      }
+
+      public static VssCapturedComponent Component(VssComponentType type, string logicalPath, string componentName, 
+         IEnumerable<VssWMFileDescriptor> files, IEnumerable<VssWMFileDescriptor> databaseFiles, IEnumerable<VssWMFileDescriptor> databaseLogFiles)
+      {
+         return new VssCapturedComponent(type, logicalPath, componentName, null, null, false, false, true, true, VssComponentFlags.None,
+            files, databaseFiles, databaseLogFiles, new VssWMDependency[0]);
+      }
+
+      public static VssCapturedWriterMetadata Writer(string writerName, IEnumerable<VssCapturedComponent> components, params VssWMFileDescriptor[] excludeFiles)
+      {
+         return Writer(Guid.NewGuid(), writerName, components, excludeFiles, new VssWMFileDescriptor[0]);
+      }
+
+      public static VssCapturedWriterMetadata Writer(Guid writerId, string writerName, IEnumerable<VssCapturedComponent> components, 
+         IEnumerable<VssWMFileDescriptor> excludeFiles, IEnumerable<VssWMFileDescriptor> excludeFromSnapshotFiles)
+      {
+         return new VssCapturedWriterMetadata(Guid.NewGuid(), writerId, writerName, null, VssUsageType.UserData, VssSourceType.NonTransactedDB,
+            VssBackupSchema.Undefined, new Version(1, 0), null, new VssWMFileDescriptor[0], excludeFiles, excludeFromSnapshotFiles, components, null);
+      }
+   }
+}
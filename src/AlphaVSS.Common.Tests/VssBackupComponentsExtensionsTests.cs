@@ -0,0 +1,226 @@
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Reflection;
+using System.Runtime.ExceptionServices;
+using System.Runtime.Serialization;
+using System.Threading;
+using System.Threading.Tasks;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public class VssBackupComponentsExtensionsTests
+   {
+      private static readonly TimeSpan s_reportInterval = TimeSpan.FromMilliseconds(10);
+
+      [Fact]
+      public async Task GatherWriterMetadataAsync_WithProgress_ReportsPendingAndFinalSamples()
+      {
+         using (IVssBackupComponents backupComponents = CreateFactory(TimeSpan.FromMilliseconds(200)).CreateVssBackupComponents())
+         {
+            Assert.IsAssignableFrom<IVssProgressBackupComponents>(backupComponents);
+            backupComponents.InitializeForBackup(null);
+            RecordingProgress progress = new RecordingProgress();
+
+            await backupComponents.GatherWriterMetadataAsync(progress, s_reportInterval);
+
+            AssertSamples(progress.Samples, VssError.AsyncFinished);
+         }
+      }
+
+      [Fact]
+      public async Task GatherWriterStatusAsync_WithProgress_ReportsWriterStatusCapturedBeforeStart()
+      {
+         using (IVssBackupComponents backupComponents = CreateFactory(TimeSpan.Zero).CreateVssBackupComponents())
+         {
+            backupComponents.InitializeForBackup(null);
+            backupComponents.GatherWriterMetadata();
+            RecordingProgress first = new RecordingProgress();
+            RecordingProgress second = new RecordingProgress();
+
+            await backupComponents.GatherWriterStatusAsync(first, s_reportInterval);
+            await backupComponents.GatherWriterStatusAsync(second, s_reportInterval);
+
+            Assert.Null(first.Samples.Last().WriterStatus);
+            Assert.Equal(2, second.Samples.Last().WriterStatus.Count);
+         }
+      }
+
+      [Fact]
+      public async Task GatherWriterMetadataAsync_WithoutProgressInterface_ReportsSamplesOfFallback()
+      {
+         using (IVssBackupComponents backupComponents = ForwardingProxy.Create(CreateFactory(TimeSpan.FromMilliseconds(200)).CreateVssBackupComponents()))
+         {
+            Assert.False(backupComponents is IVssProgressBackupComponents);
+            backupComponents.InitializeForBackup(null);
+            RecordingProgress progress = new RecordingProgress();
+
+            await backupComponents.GatherWriterMetadataAsync(progress, s_reportInterval);
+
+            AssertSamples(progress.Samples, VssError.AsyncFinished);
+            Assert.Equal(2, backupComponents.WriterMetadata.Count);
+         }
+      }
+
+      [Fact]
+      public async Task GatherWriterMetadataAsync_WithoutProgressInterface_ReportsCancellation()
+      {
+         using (IVssBackupComponents backupComponents = ForwardingProxy.Create(CreateFactory(TimeSpan.FromSeconds(30)).CreateVssBackupComponents()))
+         using (CancellationTokenSource cancellation = new CancellationTokenSource(TimeSpan.FromMilliseconds(100)))
+         {
+            backupComponents.InitializeForBackup(null);
+            RecordingProgress progress = new RecordingProgress();
+
+            await Assert.ThrowsAnyAsync<OperationCanceledException>(() => backupComponents.GatherWriterMetadataAsync(progress, s_reportInterval, cancellation.Token));
+
+            AssertSamples(progress.Samples, VssError.AsyncCanceled);
+         }
+      }
+
+      [Fact]
+      public void GatherWriterMetadataAsync_InvalidProgressArguments_Throws()
+      {
+         using (IVssBackupComponents backupComponents = CreateFactory(TimeSpan.Zero).CreateVssBackupComponents())
+         using (IVssBackupComponents proxy = ForwardingProxy.Create(CreateFactory(TimeSpan.Zero).CreateVssBackupComponents()))
+         {
+            foreach (IVssBackupComponents target in new[] { backupComponents, proxy })
+            {
+               target.InitializeForBackup(null);
+               Assert.Throws<ArgumentNullException>(() => target.GatherWriterMetadataAsync(null, s_reportInterval));
+               Assert.Throws<ArgumentOutOfRangeException>(() => target.GatherWriterMetadataAsync(new RecordingProgress(), TimeSpan.Zero));
+               Assert.Throws<ArgumentOutOfRangeException>(() => target.GatherWriterMetadataAsync(new RecordingProgress(), TimeSpan.FromDays(50)));
+            }
+         }
+
+         Assert.Throws<ArgumentNullException>(() => VssBackupComponentsExtensions.GatherWriterMetadataAsync(null, new RecordingProgress(), s_reportInterval));
+      }
+
+      [Fact]
+      public void CaptureWriterMetadata_WithoutBatchInterface_CapturesWriterMetadata()
+      {
+         using (IVssBackupComponents backupComponents = CreateFactory(TimeSpan.Zero).CreateVssBackupComponents())
+         using (IVssBackupComponents proxy = ForwardingProxy.Create(CreateFactory(TimeSpan.Zero).CreateVssBackupComponents()))
+         {
+            Assert.IsAssignableFrom<IVssBatchBackupComponents>(backupComponents);
+            Assert.False(proxy is IVssBatchBackupComponents);
+            foreach (IVssBackupComponents target in new[] { backupComponents, proxy })
+            {
+               target.InitializeForBackup(null);
+               Assert.Throws<VssBadStateException>(() => target.CaptureWriterMetadata());
+
+               target.GatherWriterMetadata();
+               IList<VssCapturedWriterMetadata> captured = target.CaptureWriterMetadata();
+
+               Assert.Equal(target.WriterMetadata.Select(writer => writer.InstanceId), captured.Select(writer => writer.InstanceId));
+               Assert.Equal(new[] { "First Writer", "Second Writer" }, captured.Select(writer => writer.WriterName));
+            }
+         }
+
+         Assert.Throws<ArgumentNullException>(() => VssBackupComponentsExtensions.CaptureWriterMetadata(null));
+      }
+
+      [Fact]
+      public void AddComponents_InvalidElement_ThrowsNamingIndexAndProcessesNothing()
+      {
+         VssSimulationOptions options = new VssSimulationOptions();
+         VssSimulatedWriter writer = new VssSimulatedWriter(Guid.NewGuid(), Guid.NewGuid(), "Writer");
+         writer.AddComponent(VssComponentType.FileGroup, null, "Files");
+         options.Writers.Add(writer);
+         VssComponentSelection valid = new VssComponentSelection(writer.InstanceId, writer.WriterId, VssComponentType.FileGroup, null, "Files");
+
+         // The constructor refuses a null component name, but a deserialized selection may lack one.
+         VssComponentSelection unnamed = (VssComponentSelection)FormatterServices.GetUninitializedObject(typeof(VssComponentSelection));
+
+         using (IVssBackupComponents backupComponents = new VssSimulatedFactory(options).CreateVssBackupComponents())
+         using (IVssBackupComponents proxy = ForwardingProxy.Create(new VssSimulatedFactory(options).CreateVssBackupComponents()))
+         {
+            foreach (IVssBackupComponents target in new[] { backupComponents, proxy })
+            {
+               target.InitializeForBackup(null);
+               target.SetBackupState(true, false, VssBackupType.Full, false);
+               target.GatherWriterMetadata();
+
+               ArgumentException nullElement = Assert.Throws<ArgumentException>(() => target.AddComponents(new[] { valid, null }));
+               Assert.Equal("components", nullElement.ParamName);
+               Assert.Contains("index 1", nullElement.Message);
+
+               ArgumentException nullName = Assert.Throws<ArgumentException>(() => target.AddComponents(new[] { valid, valid, unnamed }));
+               Assert.Contains("index 2", nullName.Message);
+
+               nullName = Assert.Throws<ArgumentException>(() => target.SetBackupSucceeded(new[] { unnamed, valid }, true));
+               Assert.Contains("index 0", nullName.Message);
+
+               Assert.Empty(target.WriterComponents);
+               Assert.Empty(target.AddComponents(new[] { valid }));
+               Assert.Single(target.WriterComponents);
+            }
+         }
+      }
+
+      private static void AssertSamples(IList<VssAsyncProgress> samples, VssError status)
+      {
+         Assert.True(samples.Count >= 2, "No sample was reported while the operation was pending.");
+         Assert.All(samples.Take(samples.Count - 1), sample => Assert.Equal(VssError.AsyncPending, sample.Status));
+         Assert.Equal(status, samples.Last().Status);
+         Assert.True(samples.Last().IsCompleted);
+      }
+
+      private static VssSimulatedFactory CreateFactory(TimeSpan operationLatency)
+      {
+         VssSimulationOptions options = new VssSimulationOptions { OperationLatency = operationLatency };
+         options.Writers.Add(new VssSimulatedWriter(Guid.NewGuid(), Guid.NewGuid(), "First Writer"));
+         options.Writers.Add(new VssSimulatedWriter(Guid.NewGuid(), Guid.NewGuid(), "Second Writer"));
+         return new VssSimulatedFactory(options);
+      }
+
+      // Records the samples synchronously, unlike Progress<T>, which posts them to the thread pool.
+      private sealed class RecordingProgress : IProgress<VssAsyncProgress>
+      {
+         private readonly List<VssAsyncProgress> m_samples = new List<VssAsyncProgress>();
+
+         public IList<VssAsyncProgress> Samples
+         {
+            get
+            {
+               lock (m_samples)
+                  return m_samples.ToList();
+            }
+         }
+
+         public void Report(VssAsyncProgress value)
+         {
+            lock (m_samples)
+               m_samples.Add(value);
+         }
+      }
+
+      // Forwards every call to another backup components object, exposing only IVssBackupComponents, like a third party
+      // implementation that does not implement the optional interfaces.
+      public class ForwardingProxy : DispatchProxy
+      {
+         private IVssBackupComponents m_target;
+
+         public static IVssBackupComponents Create(IVssBackupComponents target)
+         {
+            IVssBackupComponents proxy = Create<IVssBackupComponents, ForwardingProxy>();
+            ((ForwardingProxy)(object)proxy).m_target = target;
+            return proxy;
+         }
+
+         protected override object Invoke(MethodInfo targetMethod, object[] args)
+         {
+            try
+            {
+               return targetMethod.Invoke(m_target, args);
+            }
+            catch (TargetInvocationException ex)
+            {
+               ExceptionDispatchInfo.Capture(ex.InnerException).Throw();
+               throw;
+            }
+         }
+      }
+   }
+}
@@ -0,0 +1,139 @@
+
+using System;
+using System.Threading;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public class VssBackupComponentsPoolTests
+   {
+      private static readonly TimeSpan s_timeout = TimeSpan.FromSeconds(10);
+
+      [Fact]
+      public void Rent_ReturnsInitializedObject_AndReplenishesInBackground()
+      {
+         CountingFactory factory = new CountingFactory();
+         using (VssBackupComponentsPool pool = new VssBackupComponentsPool(factory, 2))
+         {
+            pool.Fill();
+            Assert.Equal(2, pool.Count);
+            Assert.Equal(2, factory.Attempts);
+
+            using (IVssBackupComponents backupComponents = pool.Rent())
+            {
+               backupComponents.SetBackupState(false, false, VssBackupType.Full, false);
+               Assert.True(SpinWait.SpinUntil(() => pool.Count == 2, s_timeout));
+               Assert.Equal(3, factory.Attempts);
+            }
+         }
+      }
+
+      [Fact]
+      public void Rent_AfterBackgroundFailure_StopsReplenishingUntilCreatedOnCallingThread()
+      {
+         CountingFactory factory = new CountingFactory();
+         using (VssBackupComponentsPool pool = new VssBackupComponentsPool(factory, 2))
+         {
+            pool.Fill();
+            factory.Fail = true;
+
+            // The background replacement of the first object fails, which stops the pool.
+            pool.Rent().Dispose();
+            Assert.True(SpinWait.SpinUntil(() => factory.Attempts == 3, s_timeout));
+            Thread.Sleep(50);
+
+            pool.Rent().Dispose();
+            Assert.Equal(0, pool.Count);
+            Assert.Throws<VssUnexpectedErrorException>(() => pool.Rent());
+            Thread.Sleep(50);
+            Assert.Equal(4, factory.Attempts);
+
+            // An object created on the calling thread restarts the pool.
+            factory.Fail = false;
+            pool.Rent().Dispose();
+            Assert.True(SpinWait.SpinUntil(() => pool.Count == 2, s_timeout));
+            Assert.Equal(7, factory.Attempts);
+         }
+      }
+
+      [Fact]
+      public void Dispose_DisposesIdleObjects_AndRejectsFurtherCalls()
+      {
+         VssBackupComponentsPool pool = new VssBackupComponentsPool(new CountingFactory(), 1);
+         pool.Fill();
+         pool.Dispose();
+         pool.Dispose();
+
+         Assert.Equal(0, pool.Count);
+         Assert.Throws<ObjectDisposedException>(() => pool.Rent());
+         Assert.Throws<ObjectDisposedException>(() => pool.Fill());
+      }
+
+      [Fact]
+      public void Constructor_InvalidArguments_Throws()
+      {
+         Assert.Throws<ArgumentNullException>(() => new VssBackupComponentsPool(null, 1));
+         Assert.Throws<ArgumentOutOfRangeException>(() => new VssBackupComponentsPool(new CountingFactory(), 0));
+      }
+
+      [Fact]
+      public void WarmUp_ReturnsProviders()
+      {
+         VssSimulationOptions options = new VssSimulationOptions { ProviderId = Guid.NewGuid() };
+         IVssFactoryProvider factoryProvider = new SimulatedFactoryProvider(new VssSimulatedFactory(options));
+
+         Assert.Equal(options.ProviderId, Assert.Single(factoryProvider.WarmUp()).ProviderId);
+         Assert.Throws<ArgumentNullException>(() => VssFactoryProviderExtensions.WarmUp(null));
+      }
+
+      // Creates simulated backup components objects, counting the attempts, and failing them while Fail is set.
+      private sealed class CountingFactory : IVssFactory
+      {
+         private readonly VssSimulatedFactory m_factory = new VssSimulatedFactory();
+         private int m_attempts;
+
+         public int Attempts => Volatile.Read(ref m_attempts);
+
+         public volatile bool Fail;
+
+         public IVssBackupComponents CreateVssBackupComponents()
+         {
+            Interlocked.Increment(ref m_attempts);
+            if (Fail)
+               throw new VssUnexpectedErrorException();
+
+            return m_factory.CreateVssBackupComponents();
+         }
+
+         public IVssSnapshotManagement CreateVssSnapshotManagement()
+         {
+            return m_factory.CreateVssSnapshotManagement();
+         }
+
+         public IVssExamineWriterMetadata CreateVssExamineWriterMetadata(string xml)
+         {
+            return m_factory.CreateVssExamineWriterMetadata(xml);
+         }
+
+         public IVssInfoProvider GetInfoProvider()
+         {
+            return m_factory.GetInfoProvider();
+         }
+      }
+
+      private sealed class SimulatedFactoryProvider : IVssFactoryProvider
+      {
+         private readonly IVssFactory m_factory;
+
+         public SimulatedFactoryProvider(IVssFactory factory)
+         {
+            m_factory = factory;
+         }
+
+         public IVssFactory GetVssFactory()
+         {
+            return m_factory;
+         }
+      }
+   }
+}
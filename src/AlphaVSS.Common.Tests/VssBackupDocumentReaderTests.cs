@@ -0,0 +1,170 @@
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public class VssBackupDocumentReaderTests
+   {
+      private static readonly Guid SnapshotSetId = new Guid("0b7a4c9e-2d31-4f8a-9e56-1c3d5b7f9a20");
+      private static readonly Guid WriterId = new Guid("a65faa63-5ea8-4ebc-9dbd-a0c4db26912a");
+      private static readonly Guid InstanceId = new Guid("c3a1e5f2-6b7d-4e89-a012-3456789abcde");
+      private static readonly Guid OtherWriterId = new Guid("afbab4a2-367d-4d15-a586-71dbb18f8485");
+      private static readonly DateTime ModifyTime = new DateTime(2020, 3, 1, 12, 0, 0, DateTimeKind.Utc);
+
+      [Fact]
+      public void Constructor_ReadsHeader()
+      {
+         using (VssBackupDocumentReader reader = new VssBackupDocumentReader(new StringReader(CreateDocument().ToString())))
+         {
+            Assert.Equal("1.2", reader.Header.Version);
+            Assert.Equal(VssBackupType.Incremental, reader.Header.BackupType);
+            Assert.Equal(SnapshotSetId, reader.Header.SnapshotSetId);
+            Assert.True(reader.Header.SelectComponents);
+            Assert.False(reader.Header.BootableSystemStateBackup);
+            Assert.True(reader.Header.PartialFileSupport);
+            Assert.Null(reader.Current);
+         }
+      }
+
+      [Fact]
+      public void Read_ReturnsComponentsInDocumentOrder()
+      {
+         List<VssBackupDocumentComponent> components;
+         using (MemoryStream stream = new MemoryStream(Encoding.UTF8.GetBytes(CreateDocument().ToString())))
+         using (VssBackupDocumentReader reader = new VssBackupDocumentReader(stream))
+         {
+            components = reader.ReadComponents().ToList();
+            Assert.False(reader.Read());
+            Assert.Null(reader.Current);
+         }
+
+         Assert.Equal(3, components.Count);
+
+         VssBackupDocumentComponent database = components[0];
+         Assert.Equal(new VssComponentKey(InstanceId, WriterId, "Server", "Db1"), database.Key);
+         Assert.Equal(VssComponentType.Database, database.ComponentType);
+         Assert.True(database.BackupSucceeded);
+         Assert.Equal("stamp-2", database.BackupStamp);
+         Assert.Equal("stamp-1", database.PreviousBackupStamp);
+         Assert.Equal("options & more", database.BackupOptions);
+
+         VssPartialFileInfo partialFile = Assert.Single(database.PartialFiles);
+         Assert.Equal(@"C:\Db\", partialFile.Path);
+         Assert.Equal("db1.mdf", partialFile.FileName);
+         Assert.Equal("0:4096,8192:4096", partialFile.Range);
+         Assert.Equal("meta", partialFile.Metadata);
+
+         VssDifferencedFileInfo differencedFile = Assert.Single(database.DifferencedFiles);
+         Assert.Equal(@"C:\Db\Logs", differencedFile.Path);
+         Assert.Equal("*.ldf", differencedFile.FileSpecification);
+         Assert.True(differencedFile.IsRecursive);
+         Assert.Equal(ModifyTime, differencedFile.LastModifyTime);
+
+         Assert.Equal("Db2", components[1].Key.ComponentName);
+         Assert.False(components[1].BackupSucceeded);
+         Assert.Empty(components[1].PartialFiles);
+
+         Assert.Equal(OtherWriterId, components[2].Key.WriterId);
+         Assert.Equal(String.Empty, components[2].Key.LogicalPath);
+         Assert.Equal(VssComponentType.FileGroup, components[2].ComponentType);
+      }
+
+      [Fact]
+      public void Constructor_NotABackupComponentsDocument_Throws()
+      {
+         Assert.Throws<VssInvalidXmlDocumentException>(() => new VssBackupDocumentReader(new StringReader("<WRITER_METADATA/>")));
+      }
+
+      [Fact]
+      public void Read_MalformedDocument_Throws()
+      {
+         string xml = CreateDocument().ToString();
+         using (VssBackupDocumentReader reader = new VssBackupDocumentReader(new StringReader(xml.Substring(0, xml.IndexOf("</COMPONENT>", StringComparison.Ordinal) + 4))))
+         {
+            Assert.Throws<VssInvalidXmlDocumentException>(() => reader.ReadComponents().ToList());
+         }
+      }
+
+      [Fact]
+      public void Catalog_FindsComponentsByPathAndBackupStamp()
+      {
+         VssBackupCatalog catalog = new VssBackupCatalog();
+         catalog.Add("full", new StringReader(new TestBackupDocument(Guid.NewGuid(), VssBackupType.Full)
+            .Writer(InstanceId, WriterId)
+            .Component("Server", "Db1", "database", true, "stamp-1", null, null)
+            .ToString()));
+         VssBackupDocumentHeader header = catalog.Add("incremental", new StringReader(CreateDocument().ToString()));
+
+         Assert.Equal(SnapshotSetId, header.SnapshotSetId);
+         Assert.Equal(2, catalog.DocumentCount);
+         Assert.Equal(3, catalog.GetDocument("INCREMENTAL").Count);
+
+         IList<VssBackupCatalogEntry> backups = catalog.Find(WriterId, "server", "db1");
+         Assert.Equal(new[] { "full", "incremental" }, backups.Select(entry => entry.DocumentId));
+
+         VssBackupCatalogEntry basis = Assert.Single(catalog.FindByBackupStamp(backups[1].PreviousBackupStamp));
+         Assert.Equal("full", basis.DocumentId);
+
+         Assert.True(catalog.Remove("full"));
+         Assert.Empty(catalog.FindByBackupStamp("stamp-1"));
+      }
+
+      [Fact]
+      public void Diff_ReportsAddedRemovedAndChangedComponents()
+      {
+         string previous = new TestBackupDocument(Guid.NewGuid(), VssBackupType.Full)
+            .Writer(InstanceId, WriterId)
+            .Component("Server", "Db1", "database", true, "stamp-1", null, "options & more")
+            .PartialFile(@"C:\Db\", "db1.mdf", "0:4096", "meta")
+            .Component("Server", "Db2", "database", true, "stamp-1", null, null)
+            .Component("Server", "Removed", "database", true, "stamp-1", null, null)
+            .ToString();
+
+         VssBackupDocumentDiff diff = VssBackupDocumentDiff.Compare(new StringReader(previous), new StringReader(CreateDocument().ToString()));
+
+         Assert.False(diff.IsEmpty);
+         Assert.Equal("Files", Assert.Single(diff.Added).Key.ComponentName);
+         Assert.Equal("Removed", Assert.Single(diff.Removed).Key.ComponentName);
+         Assert.Equal(2, diff.Matched.Count);
+         Assert.Equal(VssBackupDocumentChanges.BackupStamp | VssBackupDocumentChanges.PreviousBackupStamp | VssBackupDocumentChanges.PartialFileRanges | VssBackupDocumentChanges.DifferencedFiles,
+            diff.Matched[0].Changes);
+         Assert.Equal(VssBackupDocumentChanges.BackupSucceeded | VssBackupDocumentChanges.BackupStamp | VssBackupDocumentChanges.PreviousBackupStamp,
+            diff.Matched[1].Changes);
+
+         IList<VssComponentSelection> selections = diff.CreateSelections();
+         Assert.Equal(new[] { "Files", "Db1", "Db2" }, selections.Select(selection => selection.ComponentName));
+         Assert.Null(selections[0].PreviousBackupStamp);
+         Assert.Equal("stamp-1", selections[1].PreviousBackupStamp);
+         Assert.Equal("options & more", selections[1].BackupOptions);
+      }
+
+      [Fact]
+      public void Diff_IdenticalDocuments_IsEmpty()
+      {
+         string xml = CreateDocument().ToString();
+
+         VssBackupDocumentDiff diff = VssBackupDocumentDiff.Compare(new StringReader(xml), new StringReader(xml));
+
+         Assert.True(diff.IsEmpty);
+         Assert.Empty(diff.Changed);
+         Assert.Equal(3, diff.Matched.Count);
+      }
+
+      private static TestBackupDocument CreateDocument()
+      {
+         return new TestBackupDocument(SnapshotSetId, VssBackupType.Incremental)
+            .Writer(InstanceId, WriterId)
+            .Component("Server", "Db1", "database", true, "stamp-2", "stamp-1", "options & more")
+            .PartialFile(@"C:\Db\", "db1.mdf", "0:4096,8192:4096", "meta")
+            .DifferencedFile(@"C:\Db\Logs", "*.ldf", true, ModifyTime)
+            .Component("Server", "Db2", "database", false, "stamp-2", "stamp-1", null)
+            .Writer(Guid.NewGuid(), OtherWriterId)
+            .Component(null, "Files", "filegroup", true, null, null, null);
+      }
+   }
+}
@@ -0,0 +1,95 @@
+
+using System;
+using System.IO;
+using System.Text;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public class VssBinaryXmlEncodingTests
+   {
+      [Theory]
+      [InlineData(false)]
+      [InlineData(true)]
+      public void Encode_BackupComponentsDocument_RoundTrips(bool compress)
+      {
+         string xml = CreateBackupDocument(50);
+
+         byte[] encoded = VssBinaryXmlEncoding.Encode(xml, compress);
+
+         Assert.Equal(xml, VssBinaryXmlEncoding.Decode(encoded));
+         Assert.True(encoded.Length < Encoding.UTF8.GetByteCount(xml) / 2, String.Format("{0} bytes encoded from {1} characters.", encoded.Length, xml.Length));
+      }
+
+      [Theory]
+      [InlineData("<?xml version=\"1.0\"?>\r\n<WRITER_METADATA version='1.1'>\r\n  <!-- comment -->\r\n  <?pi data?>\r\n  <IDENTIFICATION writerId=\"a\" />\r\n  <TEXT>some text</TEXT>\r\n</WRITER_METADATA>")]
+      [InlineData("<a><b/><c x=\"1\"/></a>")]
+      [InlineData("<a><b /><c x=\"1\" /></a>")]
+      [InlineData("<a><b/><c /></a>")]
+      [InlineData("<a x=\"&amp;&lt;&quot;\">&#65;&gt;<![CDATA[<raw & data>]]></a>")]
+      [InlineData("<a>\u00e9\u4e2d\U0001F600</a>")]
+      [InlineData("<a><b></a>")]
+      [InlineData("not xml at all")]
+      [InlineData("")]
+      public void Encode_ArbitraryDocument_RoundTripsExactly(string xml)
+      {
+         Assert.Equal(xml, VssBinaryXmlEncoding.Decode(VssBinaryXmlEncoding.Encode(xml, false)));
+         Assert.Equal(xml, VssBinaryXmlEncoding.Decode(VssBinaryXmlEncoding.Encode(xml, true)));
+      }
+
+      [Fact]
+      public void Encode_LongValues_RoundTrip()
+      {
+         string blob = new string('x', 100000);
+         string xml = "<a v=\"" + blob + "\"><b>" + blob + "</b><b>" + blob + "</b></a>";
+
+         Assert.Equal(xml, VssBinaryXmlEncoding.Decode(VssBinaryXmlEncoding.Encode(xml, false)));
+      }
+
+      [Fact]
+      public void Encode_Stream_DecodesFromStream()
+      {
+         string xml = CreateBackupDocument(3);
+         using (MemoryStream stream = new MemoryStream())
+         {
+            stream.WriteByte(0xFF);
+            VssBinaryXmlEncoding.Encode(xml, stream, true);
+
+            stream.Position = 1;
+            Assert.Equal(xml, VssBinaryXmlEncoding.Decode(stream));
+         }
+      }
+
+      [Fact]
+      public void Decode_InvalidData_Throws()
+      {
+         Assert.Throws<InvalidDataException>(() => VssBinaryXmlEncoding.Decode(new byte[0]));
+         Assert.Throws<InvalidDataException>(() => VssBinaryXmlEncoding.Decode(Encoding.ASCII.GetBytes("<xml/>")));
+
+         byte[] encoded = VssBinaryXmlEncoding.Encode("<a/>", false);
+         encoded[4] = 0xFF;
+         Assert.Throws<InvalidDataException>(() => VssBinaryXmlEncoding.Decode(encoded));
+      }
+
+      [Fact]
+      public void Encode_Null_Throws()
+      {
+         Assert.Throws<ArgumentNullException>(() => VssBinaryXmlEncoding.Encode(null, false));
+         Assert.Throws<ArgumentNullException>(() => VssBinaryXmlEncoding.Decode((byte[])null));
+      }
+
+      private static string CreateBackupDocument(int componentCount)
+      {
+         Guid writerId = Guid.NewGuid();
+         TestBackupDocument document = new TestBackupDocument(Guid.NewGuid(), VssBackupType.Full).Writer(Guid.NewGuid(), writerId);
+         for (int i = 0; i < componentCount; i++)
+         {
+            document.Component("Server\\Instance", "Database" + i, "database", true, "stamp", null, null)
+               .PartialFile(@"C:\Program Files\Server\Data\", "Database" + i + ".mdf", "0:65536", null)
+               .DifferencedFile(@"C:\Program Files\Server\Logs", "*.ldf", false, new DateTime(2020, 1, 1, 0, 0, 0, DateTimeKind.Utc));
+         }
+
+         return document.ToString();
+      }
+   }
+}
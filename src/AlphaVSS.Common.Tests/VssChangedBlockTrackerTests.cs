@@ -0,0 +1,210 @@
+
+using System;
+using System.IO;
+using System.Linq;
+using System.Threading.Tasks;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public sealed class VssChangedBlockTrackerTests : IDisposable
+   {
+      private const string Volume = @"C:\";
+      private const string FilePath = @"Data\file.bin";
+      private const int BlockSize = 4096;
+
+      private readonly string m_root;
+      private readonly string m_file;
+      private readonly VssChangedBlockTracker m_tracker;
+
+      public VssChangedBlockTrackerTests()
+      {
+         m_root = Path.Combine(Path.GetTempPath(), "AlphaVSS.Tests." + Guid.NewGuid().ToString("N"));
+         Directory.CreateDirectory(m_root);
+         m_file = Path.Combine(m_root, "file.bin");
+         m_tracker = new VssChangedBlockTracker(Path.Combine(m_root, "cbt")) { BlockSize = BlockSize };
+      }
+
+      public void Dispose()
+      {
+         Directory.Delete(m_root, true);
+      }
+
+      [Fact]
+      public async Task ComputeChangesAsync_WithoutBaseline_ReportsWholeFile()
+      {
+         WriteFile(CreateContents(10 * BlockSize + 100));
+
+         VssChangedBlockResult result = await ComputeChangesAsync();
+
+         Assert.False(result.HasBaseline);
+         Assert.Equal(-1, result.PreviousLength);
+         Assert.False(result.WasTruncated);
+         Assert.Equal(10 * BlockSize + 100, result.Length);
+         Assert.Equal(11, result.BlockCount);
+         Assert.Equal(11, result.ChangedBlockCount);
+         Assert.Equal(new VssFileRange(0, 10 * BlockSize + 100), Assert.Single(result.ChangedRanges));
+      }
+
+      [Fact]
+      public async Task ComputeChangesAsync_AfterCommit_ReportsOnlyChangedBlocks()
+      {
+         byte[] contents = CreateContents(10 * BlockSize);
+         WriteFile(contents);
+         m_tracker.Commit(await ComputeChangesAsync());
+
+         VssChangedBlockResult unchanged = await ComputeChangesAsync();
+         Assert.True(unchanged.HasBaseline);
+         Assert.Equal(contents.Length, unchanged.PreviousLength);
+         Assert.Equal(0, unchanged.ChangedBlockCount);
+         Assert.Empty(unchanged.ChangedRanges);
+
+         contents[2 * BlockSize + 17]++;
+         contents[3 * BlockSize]++;
+         contents[7 * BlockSize + 5]++;
+         WriteFile(contents);
+
+         VssChangedBlockResult changed = await ComputeChangesAsync();
+         Assert.Equal(3, changed.ChangedBlockCount);
+         Assert.Equal(new[] { new VssFileRange(2 * BlockSize, 2 * BlockSize), new VssFileRange(7 * BlockSize, BlockSize) }, changed.ChangedRanges.ToArray());
+      }
+
+      [Fact]
+      public async Task ComputeChangesAsync_TruncatedFile_ReportsTruncation()
+      {
+         byte[] contents = CreateContents(10 * BlockSize);
+         WriteFile(contents);
+         m_tracker.Commit(await ComputeChangesAsync());
+
+         WriteFile(contents.Take(4 * BlockSize + 10).ToArray());
+         VssChangedBlockResult result = await ComputeChangesAsync();
+
+         Assert.True(result.WasTruncated);
+         Assert.Equal(10 * BlockSize, result.PreviousLength);
+         Assert.Equal(4 * BlockSize + 10, result.Length);
+         Assert.Equal(new VssFileRange(4 * BlockSize, 10), Assert.Single(result.ChangedRanges));
+      }
+
+      [Fact]
+      public async Task ComputeChangesAsync_ExtendedFile_ReportsNewBlocks()
+      {
+         byte[] contents = CreateContents(4 * BlockSize);
+         WriteFile(contents);
+         m_tracker.Commit(await ComputeChangesAsync());
+
+         WriteFile(contents.Concat(CreateContents(BlockSize + 1)).ToArray());
+         VssChangedBlockResult result = await ComputeChangesAsync();
+
+         Assert.False(result.WasTruncated);
+         Assert.Equal(new VssFileRange(4 * BlockSize, BlockSize + 1), Assert.Single(result.ChangedRanges));
+      }
+
+      [Fact]
+      public async Task ComputeChangesAsync_EmptyFile_HasNoBlocks()
+      {
+         WriteFile(new byte[0]);
+
+         VssChangedBlockResult result = await ComputeChangesAsync();
+
+         Assert.Equal(0, result.Length);
+         Assert.Equal(0, result.BlockCount);
+         Assert.Empty(result.ChangedRanges);
+      }
+
+      [Fact]
+      public async Task ComputeChangesAsync_LargerThanChunk_AlignsBlocksAcrossChunks()
+      {
+         // 12 KB blocks do not divide the 16 MB chunks the file is read in.
+         m_tracker.BlockSize = 3 * 4096;
+         byte[] contents = CreateContents(17 * 1024 * 1024 + 3);
+         WriteFile(contents);
+         m_tracker.Commit(await ComputeChangesAsync());
+
+         int offset = 16 * 1024 * 1024 + 5;
+         contents[offset]++;
+         WriteFile(contents);
+         VssChangedBlockResult result = await ComputeChangesAsync();
+
+         long blockOffset = offset / m_tracker.BlockSize * (long)m_tracker.BlockSize;
+         Assert.Equal(new VssFileRange(blockOffset, m_tracker.BlockSize), Assert.Single(result.ChangedRanges));
+      }
+
+      [Fact]
+      public async Task ComputeChangesAsync_NonSeekableStream_MatchesFileStream()
+      {
+         byte[] contents = CreateContents(5 * BlockSize + 1);
+         WriteFile(contents);
+         m_tracker.Commit(await ComputeChangesAsync());
+
+         contents[BlockSize]++;
+         VssChangedBlockResult result = await m_tracker.ComputeChangesAsync(Volume, FilePath, new NonSeekableStream(contents));
+
+         Assert.Equal(contents.Length, result.Length);
+         Assert.Equal(new VssFileRange(BlockSize, BlockSize), Assert.Single(result.ChangedRanges));
+      }
+
+      [Fact]
+      public async Task ComputeChangesAsync_BlockSizeChanged_DiscardsBaseline()
+      {
+         WriteFile(CreateContents(8 * BlockSize));
+         m_tracker.Commit(await ComputeChangesAsync());
+
+         m_tracker.BlockSize = 2 * BlockSize;
+         VssChangedBlockResult result = await ComputeChangesAsync();
+
+         Assert.False(result.HasBaseline);
+         Assert.Equal(4, result.ChangedBlockCount);
+      }
+
+      [Fact]
+      public async Task Remove_And_Clear_DiscardBaselines()
+      {
+         WriteFile(CreateContents(BlockSize));
+         m_tracker.Commit(await ComputeChangesAsync());
+         m_tracker.Commit(await m_tracker.ComputeChangesAsync(Volume, "other.bin", new MemoryStream(new byte[1])));
+
+         m_tracker.Remove(@"c:", @"\" + FilePath.ToUpperInvariant());
+         Assert.False((await ComputeChangesAsync()).HasBaseline);
+         Assert.True((await m_tracker.ComputeChangesAsync(Volume, "other.bin", new MemoryStream(new byte[1]))).HasBaseline);
+
+         m_tracker.Clear();
+         Assert.False((await m_tracker.ComputeChangesAsync(Volume, "other.bin", new MemoryStream(new byte[1]))).HasBaseline);
+      }
+
+      [Fact]
+      public void BlockSize_Invalid_Throws()
+      {
+         Assert.Throws<ArgumentOutOfRangeException>(() => m_tracker.BlockSize = 0);
+         Assert.Throws<ArgumentOutOfRangeException>(() => m_tracker.BlockSize = 1000);
+         Assert.Throws<ArgumentOutOfRangeException>(() => m_tracker.BlockSize = 32 * 1024 * 1024);
+      }
+
+      private async Task<VssChangedBlockResult> ComputeChangesAsync()
+      {
+         using (FileStream stream = new FileStream(m_file, FileMode.Open, FileAccess.Read, FileShare.Read, 1, FileOptions.Asynchronous))
+            return await m_tracker.ComputeChangesAsync(Volume, FilePath, stream);
+      }
+
+      private void WriteFile(byte[] contents)
+      {
+         File.WriteAllBytes(m_file, contents);
+      }
+
+      private static byte[] CreateContents(int length)
+      {
+         byte[] contents = new byte[length];
+         new Random(length).NextBytes(contents);
+         return contents;
+      }
+
+      private sealed class NonSeekableStream : MemoryStream
+      {
+         public NonSeekableStream(byte[] contents)
+            : base(contents, false)
+         {
+         }
+
+         public override bool CanSeek => false;
+      }
+   }
+}
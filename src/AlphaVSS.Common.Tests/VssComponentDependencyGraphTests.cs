@@ -0,0 +1,191 @@
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public class VssComponentDependencyGraphTests
+   {
+      private static readonly Guid s_databaseWriterId = new Guid("a1a1a1a1-0000-0000-0000-000000000001");
+      private static readonly Guid s_sharedWriterId = new Guid("b2b2b2b2-0000-0000-0000-000000000002");
+
+      private readonly VssSimulatedWriter m_database;
+      private readonly VssSimulatedWriter m_shared;
+      private readonly VssSimulatedWriter m_sharedSecondInstance;
+      private readonly VssComponentDependencyGraph m_graph;
+
+      // Database (selectable)          Shared, two instances
+      //   Database\Logs -> Shared\Data   Data
+      // Reports -> Nowhere (unresolved)  Left -> Right, Right -> Left
+      //                                  Self -> Self
+      //
+      // Dependencies resolve to the components of every instance of the writer class, so the Left and Right components of 
+      // both instances form a single cycle, and so do the Self components.
+      public VssComponentDependencyGraphTests()
+      {
+         m_database = new VssSimulatedWriter(s_databaseWriterId, Guid.NewGuid(), "Database Writer");
+         m_database.AddComponent(VssComponentType.Database, null, "Database");
+         m_database.AddComponent(VssComponentType.Database, "Database", "Logs").Dependencies.Add(new VssWMDependency(s_sharedWriterId, "Shared", "Data"));
+         m_database.AddComponent(VssComponentType.FileGroup, null, "Reports").Dependencies.Add(new VssWMDependency(Guid.NewGuid(), null, "Nowhere"));
+
+         m_shared = CreateSharedWriter();
+         m_sharedSecondInstance = CreateSharedWriter();
+         m_graph = new VssComponentDependencyGraph(new IVssExamineWriterMetadata[] { m_database, m_shared, m_sharedSecondInstance });
+      }
+
+      [Fact]
+      public void Constructor_ResolvesDependenciesAcrossWriterInstances()
+      {
+         Assert.Equal(3 + 2 * 4, m_graph.Count);
+         Assert.Equal(new[] { Key(m_shared, "Shared", "Data"), Key(m_sharedSecondInstance, "Shared", "Data") }, m_graph.GetDependencies(Key(m_database, "Database", "Logs")));
+         Assert.Equal(new[] { Key(m_sharedSecondInstance, null, "Self") }, m_graph.GetDependencies(Key(m_shared, null, "Self")));
+
+         KeyValuePair<VssComponentKey, VssWMDependency> unresolved = Assert.Single(m_graph.UnresolvedDependencies);
+         Assert.Equal(Key(m_database, null, "Reports"), unresolved.Key);
+         Assert.Equal("Nowhere", unresolved.Value.ComponentName);
+         Assert.Same(m_shared, m_graph.GetWriter(Key(m_shared, null, "Left")));
+         Assert.Equal("Left", m_graph.GetComponent(Key(m_shared, null, "Left")).ComponentName);
+      }
+
+      [Fact]
+      public void Cycles_ReportsStronglyConnectedComponentsOfMoreThanOneComponent()
+      {
+         IList<IList<VssComponentKey>> cycles = m_graph.Cycles;
+
+         Assert.Equal(2, cycles.Count);
+         Assert.Equal(new[] { Key(m_shared, null, "Left"), Key(m_shared, null, "Right"), Key(m_sharedSecondInstance, null, "Left"), Key(m_sharedSecondInstance, null, "Right") }.OrderBy(key => key.ToString()),
+            cycles[0].OrderBy(key => key.ToString()));
+         Assert.Equal(new[] { Key(m_shared, null, "Self"), Key(m_sharedSecondInstance, null, "Self") }.OrderBy(key => key.ToString()), cycles[1].OrderBy(key => key.ToString()));
+      }
+
+      [Fact]
+      public void Cycles_LongChain_DoesNotExhaustStack()
+      {
+         // A chain of 100,000 components whose last component depends on the first, i.e. a single cycle.
+         const int Length = 100000;
+         VssSimulatedWriter writer = new VssSimulatedWriter(Guid.NewGuid(), Guid.NewGuid(), "Chain Writer");
+         for (int i = 0; i < Length; i++)
+            writer.AddComponent(VssComponentType.FileGroup, null, "C" + i).Dependencies.Add(new VssWMDependency(writer.WriterId, null, "C" + ((i + 1) % Length)));
+
+         VssComponentDependencyGraph graph = new VssComponentDependencyGraph(new[] { writer });
+
+         Assert.Equal(Length, Assert.Single(graph.Cycles).Count);
+         Assert.Equal(Length, graph.GetClosure(new[] { graph.Keys[Length / 2] }).Count);
+      }
+
+      [Fact]
+      public void Cycles_Acyclic_ReportsNone()
+      {
+         VssComponentDependencyGraph graph = new VssComponentDependencyGraph(new[] { m_database });
+
+         Assert.Empty(graph.Cycles);
+      }
+
+      [Fact]
+      public void GetClosure_IncludesSubcomponentsAndTransitiveDependencies()
+      {
+         IList<VssComponentKey> closure = m_graph.GetClosure(new[] { Key(m_database, null, "Database") });
+
+         Assert.Equal(new[]
+         {
+            Key(m_database, null, "Database"),
+            Key(m_database, "Database", "Logs"),
+            Key(m_shared, "Shared", "Data"),
+            Key(m_sharedSecondInstance, "Shared", "Data"),
+         }, closure);
+      }
+
+      [Fact]
+      public void GetIndependentGroups_UnitesDependenciesComponentSetsAndCycles()
+      {
+         IList<IList<VssComponentKey>> groups = m_graph.GetIndependentGroups(new[]
+         {
+            Key(m_shared, null, "Right"),
+            Key(m_database, null, "Reports"),
+            Key(m_database, "Database", "Logs"),
+            Key(m_database, null, "Database"),
+         });
+
+         Assert.Equal(3, groups.Count);
+         Assert.Equal(new[] { Key(m_database, null, "Database"), Key(m_database, "Database", "Logs"), Key(m_shared, "Shared", "Data"), Key(m_sharedSecondInstance, "Shared", "Data") }, groups[0]);
+         Assert.Equal(new[] { Key(m_database, null, "Reports") }, groups[1]);
+         Assert.Equal(new[] { Key(m_shared, null, "Left"), Key(m_shared, null, "Right"), Key(m_sharedSecondInstance, null, "Left"), Key(m_sharedSecondInstance, null, "Right") }, groups[2]);
+      }
+
+      [Fact]
+      public void GetIndependentGroups_SharedDependency_JoinsGroups()
+      {
+         VssSimulatedWriter writer = new VssSimulatedWriter(s_databaseWriterId, Guid.NewGuid(), "Second Database Writer");
+         writer.AddComponent(VssComponentType.Database, null, "First").Dependencies.Add(new VssWMDependency(s_databaseWriterId, null, "Common"));
+         writer.AddComponent(VssComponentType.Database, null, "Second").Dependencies.Add(new VssWMDependency(s_databaseWriterId, null, "Common"));
+         writer.AddComponent(VssComponentType.Database, null, "Common");
+         writer.AddComponent(VssComponentType.Database, null, "Alone");
+         VssComponentDependencyGraph graph = new VssComponentDependencyGraph(new[] { writer });
+
+         IList<IList<VssComponentKey>> groups = graph.GetIndependentGroups(graph.Keys);
+
+         Assert.Equal(2, groups.Count);
+         Assert.Equal(new[] { "First", "Second", "Common" }, groups[0].Select(key => key.ComponentName));
+         Assert.Equal("Alone", Assert.Single(groups[1]).ComponentName);
+      }
+
+      [Fact]
+      public void Plan_OmitsMembersOfSelectedComponentSets()
+      {
+         IList<VssComponentSelection> plan = m_graph.Plan(new[] { Key(m_database, null, "Database") });
+
+         Assert.Equal(new[] { "Database", "Data", "Data" }, plan.Select(selection => selection.ComponentName));
+         Assert.Equal(new[] { m_database.InstanceId, m_shared.InstanceId, m_sharedSecondInstance.InstanceId }, plan.Select(selection => selection.InstanceId));
+         Assert.Equal(VssComponentType.Database, plan[0].ComponentType);
+         Assert.Equal("Shared", plan[1].LogicalPath);
+      }
+
+      [Fact]
+      public void Plan_NonSelectableParent_AddsSubcomponents()
+      {
+         VssSimulatedWriter writer = new VssSimulatedWriter(Guid.NewGuid(), Guid.NewGuid(), "Writer");
+         writer.AddComponent(VssComponentType.FileGroup, null, "Root").Selectable = false;
+         writer.AddComponent(VssComponentType.FileGroup, "Root", "First");
+         writer.AddComponent(VssComponentType.FileGroup, @"Root\First", "Nested");
+         writer.AddComponent(VssComponentType.FileGroup, "Root", "Second");
+         VssComponentDependencyGraph graph = new VssComponentDependencyGraph(new[] { writer });
+
+         IList<VssComponentSelection> plan = graph.Plan(new[] { Key(writer, null, "Root") });
+
+         Assert.Equal(new[] { "Root", "First", "Second" }, plan.Select(selection => selection.ComponentName));
+      }
+
+      [Fact]
+      public void InvalidArguments_Throw()
+      {
+         VssSimulatedWriter duplicate = new VssSimulatedWriter(Guid.NewGuid(), Guid.NewGuid(), "Duplicate Writer");
+         duplicate.AddComponent(VssComponentType.FileGroup, null, "Twice");
+         duplicate.AddComponent(VssComponentType.FileGroup, null, "twice");
+
+         Assert.Throws<ArgumentNullException>(() => new VssComponentDependencyGraph(null));
+         Assert.Throws<ArgumentException>(() => new VssComponentDependencyGraph(new IVssExamineWriterMetadata[] { null }));
+         Assert.Throws<ArgumentException>(() => new VssComponentDependencyGraph(new[] { duplicate }));
+         Assert.Throws<ArgumentNullException>(() => m_graph.GetClosure(null));
+         Assert.Throws<ArgumentNullException>(() => m_graph.Contains(null));
+         Assert.Throws<ArgumentException>(() => m_graph.GetClosure(new[] { new VssComponentKey(Guid.NewGuid(), Guid.NewGuid(), null, "Unknown") }));
+         Assert.False(m_graph.Contains(new VssComponentKey(m_database.InstanceId, m_database.WriterId, null, "Unknown")));
+      }
+
+      private static VssSimulatedWriter CreateSharedWriter()
+      {
+         VssSimulatedWriter writer = new VssSimulatedWriter(s_sharedWriterId, Guid.NewGuid(), "Shared Writer");
+         writer.AddComponent(VssComponentType.FileGroup, "Shared", "Data");
+         writer.AddComponent(VssComponentType.FileGroup, null, "Left").Dependencies.Add(new VssWMDependency(s_sharedWriterId, null, "Right"));
+         writer.AddComponent(VssComponentType.FileGroup, null, "Right").Dependencies.Add(new VssWMDependency(s_sharedWriterId, null, "Left"));
+         writer.AddComponent(VssComponentType.FileGroup, null, "Self").Dependencies.Add(new VssWMDependency(s_sharedWriterId, null, "Self"));
+         return writer;
+      }
+
+      private static VssComponentKey Key(IVssExamineWriterMetadata writer, string logicalPath, string componentName)
+      {
+         return new VssComponentKey(writer.InstanceId, writer.WriterId, logicalPath, componentName);
+      }
+   }
+}
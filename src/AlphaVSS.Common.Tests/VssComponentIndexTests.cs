@@ -0,0 +1,129 @@
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public class VssComponentIndexTests
+   {
+      private static readonly Guid s_writerId = new Guid("c3c3c3c3-0000-0000-0000-000000000003");
+
+      private readonly VssSimulatedWriter m_first;
+      private readonly VssSimulatedWriter m_second;
+      private readonly VssComponentIndex<IVssWMComponent> m_index;
+
+      public VssComponentIndexTests()
+      {
+         m_first = CreateWriter();
+         m_second = CreateWriter();
+         m_second.AddComponent(VssComponentType.FileGroup, @"Data\Sub", "Extra");
+         m_index = VssComponentIndex.Create(new IVssExamineWriterMetadata[] { m_first, m_second });
+      }
+
+      [Fact]
+      public void Find_WriterInstance_IgnoresCaseAndTrailingBackslash()
+      {
+         IVssWMComponent component = m_first.Components[1];
+
+         Assert.Equal(11, m_index.Count);
+         Assert.Same(component, m_index.Find(m_first.InstanceId, s_writerId, VssComponentType.FileGroup, "Data", "Sub"));
+         Assert.Same(component, m_index.Find(m_first.InstanceId, s_writerId, VssComponentType.FileGroup, @"DATA\", "sub"));
+         Assert.Same(m_first.Components[0], m_index.Find(m_first.InstanceId, s_writerId, VssComponentType.Database, null, "Data"));
+         Assert.Same(m_first.Components[0], m_index.Find(m_first.InstanceId, s_writerId, VssComponentType.Database, "", "Data"));
+      }
+
+      [Fact]
+      public void Find_Mismatch_ReturnsNull()
+      {
+         Assert.Null(m_index.Find(m_first.InstanceId, s_writerId, VssComponentType.Database, "Data", "Sub"));
+         Assert.Null(m_index.Find(m_first.InstanceId, s_writerId, VssComponentType.FileGroup, @"Data\Sub", "Extra"));
+         Assert.Null(m_index.Find(Guid.NewGuid(), s_writerId, VssComponentType.FileGroup, "Data", "Sub"));
+         Assert.Throws<ArgumentNullException>(() => m_index.Find(m_first.InstanceId, s_writerId, VssComponentType.FileGroup, "Data", null));
+      }
+
+      [Fact]
+      public void Find_WriterClass_ReturnsEveryInstanceOrderedByInstanceId()
+      {
+         IList<KeyValuePair<VssComponentKey, IVssWMComponent>> matches = m_index.Find(s_writerId, VssComponentType.FileGroup, "data", "SUB");
+
+         Assert.Equal(new[] { m_first.InstanceId, m_second.InstanceId }.OrderBy(id => id), matches.Select(match => match.Key.InstanceId));
+         Assert.All(matches, match => Assert.Equal("Sub", match.Value.ComponentName));
+         Assert.Empty(m_index.Find(s_writerId, VssComponentType.Database, "Data", "Sub"));
+         Assert.Empty(m_index.Find(Guid.NewGuid(), VssComponentType.FileGroup, "Data", "Sub"));
+      }
+
+      [Fact]
+      public void GetSubtree_ReturnsComponentAndDescendantsOnly()
+      {
+         IList<KeyValuePair<VssComponentKey, IVssWMComponent>> subtree = m_index.GetSubtree(m_first.InstanceId, s_writerId, "Data");
+
+         // "Data!" sorts between "Data" and "Data\", and "DataFiles" shares the prefix without the separator; neither belongs 
+         // to the subtree.
+         Assert.Equal(new[] { "Data", @"Data\Sub", @"Data\Sub\Deep" }, subtree.Select(pair => pair.Key.FullPath));
+         Assert.Equal(subtree, m_index.GetSubtree(m_first.InstanceId, s_writerId, @"data\"));
+      }
+
+      [Fact]
+      public void GetSubtree_WriterClass_ReturnsEveryInstance()
+      {
+         IList<KeyValuePair<VssComponentKey, IVssWMComponent>> subtree = m_index.GetSubtree(s_writerId, @"Data\Sub");
+
+         Assert.Equal(5, subtree.Count);
+         Assert.Equal(new[] { @"Data\Sub", @"Data\Sub", @"Data\Sub\Deep", @"Data\Sub\Deep", @"Data\Sub\Extra" }, subtree.Select(pair => pair.Key.FullPath));
+      }
+
+      [Fact]
+      public void GetSubtree_EmptyPath_ReturnsWholeWriter()
+      {
+         Assert.Equal(m_first.Components.Count, m_index.GetSubtree(m_first.InstanceId, s_writerId, null).Count);
+         Assert.Equal(m_index.Count, m_index.GetSubtree(s_writerId, String.Empty).Count);
+         Assert.Empty(m_index.GetSubtree(Guid.NewGuid(), null));
+      }
+
+      [Fact]
+      public void Create_WriterComponents_IndexesBackupComponentsDocument()
+      {
+         VssSimulationOptions options = new VssSimulationOptions();
+         options.Writers.Add(m_first);
+         using (IVssBackupComponents backupComponents = new VssSimulatedFactory(options).CreateVssBackupComponents())
+         {
+            backupComponents.InitializeForBackup(null);
+            backupComponents.SetBackupState(true, false, VssBackupType.Full, false);
+            backupComponents.GatherWriterMetadata();
+            backupComponents.AddComponent(m_first.InstanceId, s_writerId, VssComponentType.FileGroup, "Data", "Sub");
+
+            VssComponentIndex<IVssComponent> index = VssComponentIndex.Create(backupComponents.WriterComponents);
+
+            Assert.Equal(1, index.Count);
+            Assert.Equal("Sub", index.Find(m_first.InstanceId, s_writerId, VssComponentType.FileGroup, "Data", "Sub").ComponentName);
+            Assert.Null(index.Find(m_first.InstanceId, s_writerId, VssComponentType.Database, "Data", "Sub"));
+         }
+      }
+
+      [Fact]
+      public void Create_InvalidArguments_Throws()
+      {
+         VssSimulatedWriter duplicate = new VssSimulatedWriter(s_writerId, Guid.NewGuid(), "Duplicate Writer");
+         duplicate.AddComponent(VssComponentType.FileGroup, "Path", "Twice");
+         duplicate.AddComponent(VssComponentType.Database, @"path\", "TWICE");
+
+         Assert.Throws<ArgumentNullException>(() => VssComponentIndex.Create((IEnumerable<IVssExamineWriterMetadata>)null));
+         Assert.Throws<ArgumentNullException>(() => VssComponentIndex.Create((IEnumerable<IVssWriterComponents>)null));
+         Assert.Throws<ArgumentException>(() => VssComponentIndex.Create(new IVssExamineWriterMetadata[] { null }));
+         Assert.Throws<ArgumentException>(() => VssComponentIndex.Create(new[] { duplicate }));
+      }
+
+      private static VssSimulatedWriter CreateWriter()
+      {
+         VssSimulatedWriter writer = new VssSimulatedWriter(s_writerId, Guid.NewGuid(), "Indexed Writer");
+         writer.AddComponent(VssComponentType.Database, null, "Data");
+         writer.AddComponent(VssComponentType.FileGroup, "Data", "Sub");
+         writer.AddComponent(VssComponentType.FileGroup, @"Data\Sub", "Deep");
+         writer.AddComponent(VssComponentType.FileGroup, null, "Data!");
+         writer.AddComponent(VssComponentType.FileGroup, null, "DataFiles");
+         return writer;
+      }
+   }
+}
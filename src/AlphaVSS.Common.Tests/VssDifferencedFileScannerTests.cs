@@ -0,0 +1,175 @@
+
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public sealed class VssDifferencedFileScannerTests : IDisposable
+   {
+      private static readonly DateTime s_since = new DateTime(2020, 1, 1, 0, 0, 0, DateTimeKind.Utc);
+
+      private readonly string m_root;
+
+      public VssDifferencedFileScannerTests()
+      {
+         m_root = Path.Combine(Path.GetTempPath(), "AlphaVSS.Tests." + Guid.NewGuid().ToString("N"));
+         CreateFile(@"a.txt", true);
+         CreateFile(@"old.txt", false);
+         CreateFile(@"a.log", true);
+         CreateFile(@"Sub\b.txt", true);
+         CreateFile(@"Sub\b.log", true);
+         CreateFile(@"Sub\Deeper\c.txt", true);
+         CreateFile(@"Other\d.txt", true);
+      }
+
+      public void Dispose()
+      {
+         Directory.Delete(m_root, true);
+      }
+
+      [Fact]
+      public void Scan_ReturnsMatchingFilesChangedSinceLastModifyTime()
+      {
+         VssDifferencedFileInfo spec = Spec("", "*.txt", false);
+
+         VssDifferencedFileRecord record = Assert.Single(new VssDifferencedFileScanner().Scan(new[] { spec }));
+
+         Assert.Equal(FullPath("a.txt"), record.Path);
+         Assert.Equal(1, record.Length);
+         Assert.Same(spec, record.DifferencedFile);
+      }
+
+      [Fact]
+      public void Scan_Recursive_DescendsIntoSubdirectories()
+      {
+         string[] paths = Scan(new VssDifferencedFileScanner { MaxDegreeOfParallelism = 3 }, Spec("", "*.txt", true));
+
+         Assert.Equal(FullPaths("a.txt", @"Other\d.txt", @"Sub\b.txt", @"Sub\Deeper\c.txt"), paths);
+      }
+
+      [Fact]
+      public void Scan_NoLastModifyTime_ReturnsAllMatchingFiles()
+      {
+         VssDifferencedFileInfo spec = new VssDifferencedFileInfo(m_root, "*.txt", false, DateTime.MinValue);
+
+         Assert.Equal(FullPaths("a.txt", "old.txt"), Scan(new VssDifferencedFileScanner(), spec));
+      }
+
+      [Fact]
+      public void Scan_NestedRootBelowRecursiveSpecification_ReturnsEachFileOnce()
+      {
+         VssDifferencedFileInfo all = Spec("", "*.txt", true);
+         VssDifferencedFileInfo sub = Spec("Sub", "*", false);
+         VssDifferencedFileInfo deeper = Spec(@"Sub\Deeper", "*.txt", true);
+
+         Dictionary<string, VssDifferencedFileRecord> records = new VssDifferencedFileScanner().Scan(new[] { all, sub, deeper }).ToDictionary(record => record.Path);
+
+         Assert.Equal(FullPaths("a.txt", @"Other\d.txt", @"Sub\b.log", @"Sub\b.txt", @"Sub\Deeper\c.txt"), records.Keys.OrderBy(path => path, StringComparer.Ordinal).ToArray());
+         Assert.Same(all, records[FullPath("a.txt")].DifferencedFile);
+         Assert.Same(sub, records[FullPath(@"Sub\b.log")].DifferencedFile);
+         Assert.Same(sub, records[FullPath(@"Sub\b.txt")].DifferencedFile);
+         Assert.Same(deeper, records[FullPath(@"Sub\Deeper\c.txt")].DifferencedFile);
+      }
+
+      [Fact]
+      public void Scan_NestedRootBelowNonRecursiveSpecification_IsScannedSeparately()
+      {
+         string[] paths = Scan(new VssDifferencedFileScanner(), Spec("", "*.txt", false), Spec("Sub", "*.txt", false));
+
+         Assert.Equal(FullPaths("a.txt", @"Sub\b.txt"), paths);
+      }
+
+      [Fact]
+      public void Scan_MissingDirectory_IsSkipped()
+      {
+         Assert.Empty(Scan(new VssDifferencedFileScanner(), Spec("Missing", "*", true)));
+      }
+
+      [Fact]
+      public void Scan_SnapshotRoot_MapsPathsBelowVolume()
+      {
+         string volume = Path.Combine(Path.GetTempPath(), "AlphaVSS.Volume." + Guid.NewGuid().ToString("N"));
+         VssDifferencedFileScanner scanner = new VssDifferencedFileScanner(volume, m_root);
+         VssDifferencedFileInfo mapped = new VssDifferencedFileInfo(Path.Combine(volume, "Sub"), "*.txt", false, s_since);
+         VssDifferencedFileInfo outside = new VssDifferencedFileInfo(Path.Combine(m_root, "Other"), "*", false, s_since);
+
+         Assert.Equal(FullPaths(@"Sub\b.txt"), Scan(scanner, mapped, outside));
+      }
+
+      [Fact]
+      public void Scan_StoppedEarly_CancelsWalk()
+      {
+         VssDifferencedFileScanner scanner = new VssDifferencedFileScanner { BoundedCapacity = 1 };
+
+         Assert.Single(scanner.Scan(new[] { Spec("", "*", true) }).Take(1));
+      }
+
+      [Fact]
+      public async Task ScanAsync_PassesFilesToCallback()
+      {
+         ConcurrentBag<string> paths = new ConcurrentBag<string>();
+
+         long count = await new VssDifferencedFileScanner().ScanAsync(new[] { Spec("", "*.log", true) }, record => paths.Add(record.Path));
+
+         Assert.Equal(2, count);
+         Assert.Equal(FullPaths("a.log", @"Sub\b.log"), paths.OrderBy(path => path, StringComparer.Ordinal).ToArray());
+      }
+
+      [Fact]
+      public async Task ScanAsync_Canceled_Throws()
+      {
+         using (CancellationTokenSource cancellation = new CancellationTokenSource())
+         {
+            cancellation.Cancel();
+
+            await Assert.ThrowsAnyAsync<OperationCanceledException>(() => new VssDifferencedFileScanner().ScanAsync(new[] { Spec("", "*", true) }, record => { }, cancellation.Token));
+         }
+      }
+
+      [Fact]
+      public void Scan_InvalidArguments_Throws()
+      {
+         VssDifferencedFileScanner scanner = new VssDifferencedFileScanner();
+
+         Assert.Throws<ArgumentNullException>(() => scanner.Scan(null));
+         Assert.Throws<ArgumentException>(() => scanner.Scan(new VssDifferencedFileInfo[] { null }));
+         Assert.Throws<ArgumentNullException>(() => scanner.ScanAsync(new VssDifferencedFileInfo[0], null));
+         Assert.Throws<ArgumentOutOfRangeException>(() => scanner.MaxDegreeOfParallelism = 0);
+      }
+
+      private VssDifferencedFileInfo Spec(string directory, string fileSpecification, bool isRecursive)
+      {
+         return new VssDifferencedFileInfo(FullPath(directory), fileSpecification, isRecursive, s_since);
+      }
+
+      private string FullPath(string relativePath)
+      {
+         return Path.Combine(m_root, relativePath.Replace('\\', Path.DirectorySeparatorChar));
+      }
+
+      // Returns the full paths, sorted like the paths returned by Scan below.
+      private string[] FullPaths(params string[] relativePaths)
+      {
+         return relativePaths.Select(FullPath).OrderBy(path => path, StringComparer.Ordinal).ToArray();
+      }
+
+      private void CreateFile(string relativePath, bool changed)
+      {
+         string path = FullPath(relativePath);
+         Directory.CreateDirectory(Path.GetDirectoryName(path));
+         File.WriteAllText(path, "x");
+         File.SetLastWriteTimeUtc(path, changed ? s_since.AddDays(1) : s_since.AddDays(-1));
+      }
+
+      private static string[] Scan(VssDifferencedFileScanner scanner, params VssDifferencedFileInfo[] differencedFiles)
+      {
+         return scanner.Scan(differencedFiles).Select(record => record.Path).OrderBy(path => path, StringComparer.Ordinal).ToArray();
+      }
+   }
+}
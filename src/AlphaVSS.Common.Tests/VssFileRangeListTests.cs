@@ -0,0 +1,163 @@
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Threading.Tasks;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public class VssFileRangeListTests
+   {
+      [Theory]
+      [InlineData(null, "")]
+      [InlineData("", "")]
+      [InlineData("  ", "")]
+      [InlineData("0:16", "0x0:0x10")]
+      [InlineData("0x10:0x20", "0x10:0x20")]
+      [InlineData(" 0X10 : 0x20 , 64:16 ", "0x10:0x20,0x40:0x10")]
+      [InlineData("100:10,0:10", "0x0:0xa,0x64:0xa")]
+      [InlineData("0:10,5:10", "0x0:0xf")]
+      [InlineData("0:10,10:10", "0x0:0x14")]
+      [InlineData("0:100,10:10", "0x0:0x64")]
+      [InlineData("0:0,5:0,8:2", "0x8:0x2")]
+      [InlineData("0x7FFFFFFFFFFFFFFE:1", "0x7ffffffffffffffe:0x1")]
+      public void Parse_ReturnsNormalizedRanges(string ranges, string expected)
+      {
+         Assert.Equal(expected, VssFileRangeList.Parse(ranges).ToString());
+      }
+
+      [Theory]
+      [InlineData("0")]
+      [InlineData("0:")]
+      [InlineData(":10")]
+      [InlineData("0:10,")]
+      [InlineData("0:10;20:10")]
+      [InlineData("0x:10")]
+      [InlineData("-1:10")]
+      [InlineData("0:0xG")]
+      [InlineData("0x8000000000000000:1")]
+      [InlineData("99999999999999999999:1")]
+      [InlineData("0x7FFFFFFFFFFFFFFF:1")]
+      public void Parse_InvalidRanges_Throws(string ranges)
+      {
+         VssFileRangeList result;
+         Assert.False(VssFileRangeList.TryParse(ranges, out result));
+         Assert.Null(result);
+         Assert.Throws<FormatException>(() => VssFileRangeList.Parse(ranges));
+      }
+
+      [Fact]
+      public void Parse_ManyUnsortedRanges_MatchesConstructor()
+      {
+         Random random = new Random(17);
+         List<VssFileRange> ranges = Enumerable.Range(0, 5000).Select(i => new VssFileRange(random.Next(0, 1000000), random.Next(0, 100))).ToList();
+
+         VssFileRangeList parsed = VssFileRangeList.Parse(String.Join(",", ranges.Select(range => range.Offset + ":" + range.Length)));
+
+         Assert.Equal(new VssFileRangeList(ranges).ToList(), parsed.ToList());
+         Assert.Equal(ranges.Where(range => range.Length > 0).SelectMany(range => Enumerable.Range(0, (int)range.Length).Select(i => range.Offset + i)).Distinct().LongCount(),
+            parsed.TotalLength);
+         for (int i = 1; i < parsed.Count; i++)
+            Assert.True(parsed[i - 1].End < parsed[i].Offset);
+      }
+
+      [Theory]
+      [InlineData(0, "0x0:0x10,0x20:0x10,0x38:0x8,0x100:0x10")]
+      [InlineData(8, "0x0:0x10,0x20:0x20,0x100:0x10")]
+      [InlineData(16, "0x0:0x40,0x100:0x10")]
+      [InlineData(1000, "0x0:0x110")]
+      public void Coalesce_MergesRangesSeparatedBySmallGaps(long maxGap, string expected)
+      {
+         VssFileRangeList ranges = VssFileRangeList.Parse("0:0x10,0x20:0x10,0x38:8,0x100:0x10");
+
+         Assert.Equal(expected, String.Join(",", ranges.Coalesce(maxGap)));
+      }
+
+      [Fact]
+      public void Coalesce_NegativeGap_Throws()
+      {
+         Assert.Throws<ArgumentOutOfRangeException>(() => VssFileRangeList.Empty.Coalesce(-1));
+      }
+
+      [Theory]
+      [InlineData(0)]
+      [InlineData(4096)]
+      [InlineData(Int64.MaxValue)]
+      public async Task CopyTo_CopiesExactlyTheBytesOfTheRanges(long maxGap)
+      {
+         // Ranges spanning several windows of the copy buffer, separated by gaps of various sizes.
+         byte[] data = new byte[5 * 1024 * 1024];
+         new Random(3).NextBytes(data);
+         VssFileRangeList ranges = VssFileRangeList.Parse("0:1,2:3,4096:1048576,1052700:10,2097152:1048577,4194304:1048576");
+         byte[] expected = ranges.SelectMany(range => data.Skip((int)range.Offset).Take((int)range.Length)).ToArray();
+
+         using (MemoryStream source = new MemoryStream(data, false))
+         using (MemoryStream destination = new MemoryStream())
+         {
+            Assert.Equal(ranges.TotalLength, ranges.CopyTo(source, destination, maxGap));
+            Assert.Equal(expected, destination.ToArray());
+         }
+
+         using (MemoryStream source = new MemoryStream(data, false))
+         using (MemoryStream destination = new MemoryStream())
+         {
+            Assert.Equal(ranges.TotalLength, await ranges.CopyToAsync(source, destination, maxGap));
+            Assert.Equal(expected, destination.ToArray());
+         }
+      }
+
+      [Fact]
+      public void CopyTo_SourceEndsBeforeLastRange_Throws()
+      {
+         VssFileRangeList ranges = VssFileRangeList.Parse("0:10,90:20");
+
+         using (MemoryStream source = new MemoryStream(new byte[100], false))
+         {
+            Assert.Throws<EndOfStreamException>(() => ranges.CopyTo(source, Stream.Null, 0));
+         }
+      }
+
+      [Fact]
+      public void CopyTo_InvalidArguments_Throws()
+      {
+         VssFileRangeList ranges = VssFileRangeList.Parse("0:10");
+
+         Assert.Throws<ArgumentNullException>(() => ranges.CopyTo(null, Stream.Null, 0));
+         Assert.Throws<ArgumentNullException>(() => ranges.CopyTo(Stream.Null, null, 0));
+         Assert.Throws<ArgumentOutOfRangeException>(() => ranges.CopyTo(Stream.Null, Stream.Null, -1));
+      }
+
+      [Fact]
+      public void RangesFile_RoundTrips()
+      {
+         VssFileRangeList ranges = VssFileRangeList.Parse("0x1000:0x200,0:0x10,0x7FFFFFFF0000:0x10000");
+         using (MemoryStream stream = new MemoryStream())
+         {
+            ranges.WriteRangesFile(stream);
+            Assert.Equal(8 + 16 * ranges.Count, stream.Length);
+
+            stream.Position = 0;
+            Assert.Equal(ranges.ToList(), VssFileRangeList.ReadRangesFile(stream).ToList());
+         }
+      }
+
+      [Fact]
+      public void ReadRangesFile_Truncated_Throws()
+      {
+         using (MemoryStream stream = new MemoryStream())
+         {
+            using (BinaryWriter writer = new BinaryWriter(stream, System.Text.Encoding.UTF8, true))
+            {
+               writer.Write(2UL);
+               writer.Write(0L);
+               writer.Write(10L);
+            }
+
+            stream.Position = 0;
+            Assert.Throws<InvalidDataException>(() => VssFileRangeList.ReadRangesFile(stream));
+         }
+      }
+   }
+}
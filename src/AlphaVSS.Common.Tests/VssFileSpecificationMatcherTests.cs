@@ -0,0 +1,136 @@
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Xunit;
+
+using static Alphaleonis.Win32.Vss.Tests.TestMetadata;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public class VssFileSpecificationMatcherTests
+   {
+      [Theory]
+      [InlineData(@"C:\Data\file.txt", true)]
+      [InlineData(@"c:\DATA\FILE.TXT", true)]
+      [InlineData(@"C:/Data/file.txt", true)]
+      [InlineData(@"\\?\C:\Data\file.txt", true)]
+      [InlineData(@"C:\Data\file.log", false)]
+      [InlineData(@"C:\Data\Sub\file.txt", false)]
+      [InlineData(@"C:\Other\file.txt", false)]
+      public void Classify_NonRecursiveExtension_MatchesOnlyFilesInDirectory(string path, bool expected)
+      {
+         VssFileSpecificationMatcher matcher = CreateMatcher(Component("Data", File(@"C:\Data", "*.txt", false)));
+
+         Assert.Equal(expected, matcher.Classify(path).Count == 1);
+      }
+
+      [Theory]
+      [InlineData(@"C:\Data\file.txt", true)]
+      [InlineData(@"C:\Data\Sub\file.txt", true)]
+      [InlineData(@"C:\Data\Sub\Deeper\file.txt", true)]
+      [InlineData(@"C:\Data\Sub\file.log", false)]
+      [InlineData(@"C:\DataOther\file.txt", false)]
+      public void Classify_RecursiveExtension_MatchesFilesInSubdirectories(string path, bool expected)
+      {
+         VssFileSpecificationMatcher matcher = CreateMatcher(Component("Data", File(@"C:\Data", "*.txt", true)));
+
+         Assert.Equal(expected, matcher.Classify(path).Count == 1);
+      }
+
+      [Theory]
+      [InlineData("*", "file.txt", true)]
+      [InlineData("*.*", "file.txt", true)]
+      [InlineData("*.*", "file", true)]
+      [InlineData("file.txt", "FILE.TXT", true)]
+      [InlineData("file.txt", "file.txt2", false)]
+      [InlineData("*.txt", "file.TXT", true)]
+      [InlineData("*.txt", "file.txt.bak", false)]
+      [InlineData("data?.db", "data1.db", true)]
+      [InlineData("data?.db", "data12.db", false)]
+      [InlineData("log*.*", "log.1", true)]
+      [InlineData("log*.*", "catalog.1", false)]
+      [InlineData("*log", "catalog", true)]
+      public void Classify_MatchesWildcardFileSpecifications(string fileSpecification, string name, bool expected)
+      {
+         VssFileSpecificationMatcher matcher = CreateMatcher(Component("Data", File(@"C:\Data", fileSpecification, false)));
+
+         Assert.Equal(expected, matcher.Classify(@"C:\Data\" + name).Count == 1);
+      }
+
+      [Fact]
+      public void Classify_ReportsRoleWriterAndComponent_FromLeastToMostSpecificDirectory()
+      {
+         VssCapturedComponent database = Component(VssComponentType.Database, null, "Db",
+            new VssWMFileDescriptor[0], new[] { File(@"C:\Db", "*.mdf", false) }, new[] { File(@"C:\Db", "*.ldf", false) });
+         VssCapturedComponent everything = Component("Everything", File(@"C:\", "*", true));
+         VssCapturedWriterMetadata writer = Writer("Writer", new[] { database, everything });
+         VssFileSpecificationMatcher matcher = new VssFileSpecificationMatcher(new[] { writer });
+
+         IList<VssFileSpecificationMatch> matches = matcher.Classify(@"C:\Db\data.mdf");
+
+         Assert.Equal(2, matches.Count);
+         Assert.Same(everything, matches[0].Component);
+         Assert.Equal(VssFileSpecificationRole.File, matches[0].Role);
+         Assert.Same(database, matches[1].Component);
+         Assert.Same(writer, matches[1].Writer);
+         Assert.Equal(VssFileSpecificationRole.DatabaseFile, matches[1].Role);
+         Assert.Equal(VssFileSpecificationRole.DatabaseLogFile, matcher.Classify(@"C:\Db\data.ldf").Last().Role);
+         Assert.Equal(3, matcher.DescriptorCount);
+      }
+
+      [Fact]
+      public void IsExcluded_ReportsExcludeFilesAndExcludeFromSnapshotFiles()
+      {
+         VssCapturedWriterMetadata writer = Writer(Guid.NewGuid(), "Writer", new[] { Component("Data", File(@"C:\Data", "*", true)) },
+            new[] { File(@"C:\Data\Temp", "*", true) }, new[] { File(@"C:\Data", "*.lock", false) });
+         VssFileSpecificationMatcher matcher = new VssFileSpecificationMatcher(new[] { writer });
+
+         Assert.False(matcher.IsExcluded(@"C:\Data\file.txt"));
+         Assert.True(matcher.IsExcluded(@"C:\Data\Temp\Sub\file.txt"));
+         Assert.True(matcher.IsExcluded(@"C:\Data\file.lock"));
+         Assert.Contains(matcher.Classify(@"C:\Data\file.lock"), match => match.Role == VssFileSpecificationRole.ExcludeFromSnapshotFile);
+      }
+
+      [Fact]
+      public void Classify_ExpandsEnvironmentVariablesInDescriptorPaths()
+      {
+         string name = "ALPHAVSS_TEST_" + Guid.NewGuid().ToString("N");
+         Environment.SetEnvironmentVariable(name, @"D:\Expanded");
+         try
+         {
+            VssFileSpecificationMatcher matcher = CreateMatcher(Component("Data", File("%" + name + @"%\Data", "*", false)));
+
+            Assert.Single(matcher.Classify(@"D:\Expanded\Data\file.txt"));
+         }
+         finally
+         {
+            Environment.SetEnvironmentVariable(name, null);
+         }
+      }
+
+      [Fact]
+      public void Classify_AddsToCallerCollection()
+      {
+         VssFileSpecificationMatcher matcher = CreateMatcher(Component("Data", File(@"C:\Data", "*", true)));
+         List<VssFileSpecificationMatch> matches = new List<VssFileSpecificationMatch>();
+
+         Assert.Equal(1, matcher.Classify(@"C:\Data\a.txt", matches));
+         Assert.Equal(1, matcher.Classify(@"C:\Data\b.txt", matches));
+         Assert.Equal(0, matcher.Classify(@"E:\c.txt", matches));
+         Assert.Equal(2, matches.Count);
+      }
+
+      [Fact]
+      public void Constructor_NullWriter_Throws()
+      {
+         Assert.Throws<ArgumentNullException>(() => new VssFileSpecificationMatcher(null));
+         Assert.Throws<ArgumentException>(() => new VssFileSpecificationMatcher(new IVssExamineWriterMetadata[] { null }));
+      }
+
+      private static VssFileSpecificationMatcher CreateMatcher(params VssCapturedComponent[] components)
+      {
+         return new VssFileSpecificationMatcher(new[] { Writer("Writer", components) });
+      }
+   }
+}
@@ -0,0 +1,107 @@
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading.Tasks;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public class VssInstrumentationListenerTests
+   {
+      [Fact]
+      public void PhaseCompleted_IsAggregatedByNameAndResult()
+      {
+         string phase = "Phase" + Guid.NewGuid().ToString("N");
+         using (VssInstrumentationListener listener = new VssInstrumentationListener(false))
+         {
+            VssEventSource.Log.PhaseStarted(phase);
+            VssEventSource.Log.PhaseCompleted(phase, 0, 2.0);
+            VssEventSource.Log.PhaseCompleted(phase, 0, 4.0);
+            VssEventSource.Log.PhaseCompleted(phase, unchecked((int)VssError.Unexpected), 6.0);
+
+            VssLatencyHistogram histogram = listener.GetPhaseLatencies()[phase];
+            Assert.Equal(3, histogram.Count);
+            Assert.Equal(TimeSpan.FromMilliseconds(2), histogram.Minimum);
+            Assert.Equal(TimeSpan.FromMilliseconds(6), histogram.Maximum);
+
+            IReadOnlyDictionary<VssError, long> results = listener.GetResultCounts(phase);
+            Assert.Equal(2, results[VssError.Success]);
+            Assert.Equal(1, results[VssError.Unexpected]);
+            Assert.False(listener.GetComCallLatencies().ContainsKey(phase));
+         }
+      }
+
+      [Fact]
+      public void ComCallCompleted_IsRecordedOnlyWhenRequested()
+      {
+         string method = "Method" + Guid.NewGuid().ToString("N");
+         using (VssInstrumentationListener phasesOnly = new VssInstrumentationListener(false))
+         using (VssInstrumentationListener listener = new VssInstrumentationListener(true))
+         {
+            VssEventSource.Log.ComCallCompleted(method, 0, 1.0);
+
+            Assert.Equal(1, listener.GetComCallLatencies()[method].Count);
+            Assert.False(listener.GetPhaseLatencies().ContainsKey(method));
+            Assert.False(phasesOnly.GetComCallLatencies().ContainsKey(method));
+         }
+      }
+
+      [Fact]
+      public void WriterCounts_KeepsMostRecentCounts()
+      {
+         using (VssInstrumentationListener listener = new VssInstrumentationListener())
+         {
+            listener.Reset();
+            Assert.Equal(-1, listener.WriterMetadataCount);
+            Assert.Equal(-1, listener.WriterStatusCount);
+
+            VssEventSource.Log.WriterCounts(3, -1);
+            VssEventSource.Log.WriterCounts(5, 4);
+
+            Assert.Equal(5, listener.WriterMetadataCount);
+            Assert.Equal(4, listener.WriterStatusCount);
+         }
+      }
+
+      [Fact]
+      public void Reset_DiscardsEverything()
+      {
+         string phase = "Phase" + Guid.NewGuid().ToString("N");
+         using (VssInstrumentationListener listener = new VssInstrumentationListener())
+         {
+            VssEventSource.Log.PhaseCompleted(phase, 0, 1.0);
+            VssEventSource.Log.WriterCounts(1, 1);
+
+            listener.Reset();
+
+            Assert.False(listener.GetPhaseLatencies().ContainsKey(phase));
+            Assert.Empty(listener.GetResultCounts(phase));
+            Assert.Equal(-1, listener.WriterMetadataCount);
+         }
+      }
+
+      [Fact]
+      public async Task SimulatedOperation_IsRecordedAsPhase()
+      {
+         VssSimulationOptions options = new VssSimulationOptions();
+         options.Writers.Add(new VssSimulatedWriter(Guid.NewGuid(), Guid.NewGuid(), "Writer"));
+         using (VssInstrumentationListener listener = new VssInstrumentationListener(false))
+         using (IVssBackupComponents backupComponents = new VssSimulatedFactory(options).CreateVssBackupComponents())
+         {
+            backupComponents.InitializeForBackup(null);
+            await backupComponents.GatherWriterMetadataAsync();
+
+            Assert.True(listener.GetPhaseLatencies()["GatherWriterMetadata"].Count >= 1);
+            Assert.True(listener.GetResultCounts("GatherWriterMetadata")[VssError.AsyncFinished] >= 1);
+         }
+      }
+
+      [Fact]
+      public void GetResultCounts_Null_Throws()
+      {
+         using (VssInstrumentationListener listener = new VssInstrumentationListener())
+            Assert.Throws<ArgumentNullException>(() => listener.GetResultCounts(null));
+      }
+   }
+}
@@ -0,0 +1,111 @@
+
+using System;
+using System.Threading.Tasks;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public class VssLatencyHistogramTests
+   {
+      [Fact]
+      public void Empty_ReportsZero()
+      {
+         VssLatencyHistogram histogram = new VssLatencyHistogram();
+
+         Assert.Equal(0, histogram.Count);
+         Assert.Equal(TimeSpan.Zero, histogram.Total);
+         Assert.Equal(TimeSpan.Zero, histogram.Mean);
+         Assert.Equal(TimeSpan.Zero, histogram.Minimum);
+         Assert.Equal(TimeSpan.Zero, histogram.Maximum);
+         Assert.Equal(TimeSpan.Zero, histogram.GetPercentile(50));
+      }
+
+      [Fact]
+      public void Record_TracksExactMinimumMaximumTotalAndMean()
+      {
+         VssLatencyHistogram histogram = new VssLatencyHistogram();
+
+         histogram.Record(3.0);
+         histogram.Record(TimeSpan.FromMilliseconds(1));
+         histogram.Record(-5.0);
+         histogram.Record(8.0);
+
+         Assert.Equal(4, histogram.Count);
+         Assert.Equal(TimeSpan.Zero, histogram.Minimum);
+         Assert.Equal(TimeSpan.FromMilliseconds(8), histogram.Maximum);
+         Assert.Equal(TimeSpan.FromMilliseconds(12), histogram.Total);
+         Assert.Equal(TimeSpan.FromMilliseconds(3), histogram.Mean);
+      }
+
+      [Fact]
+      public void GetPercentile_ReturnsUpperBoundOfBucketLimitedToMaximum()
+      {
+         VssLatencyHistogram histogram = new VssLatencyHistogram();
+
+         // 1000 microseconds fall into the bucket [512, 1024), 5000 into [4096, 8192) and 1 into the first bucket.
+         for (int i = 0; i < 90; i++)
+            histogram.Record(1.0);
+         for (int i = 0; i < 9; i++)
+            histogram.Record(5.0);
+         histogram.Record(0.001);
+
+         Assert.Equal(TimeSpan.FromTicks(1 * 10), histogram.GetPercentile(0));
+         Assert.Equal(TimeSpan.FromTicks(1 * 10), histogram.GetPercentile(1));
+         Assert.Equal(TimeSpan.FromTicks(1023 * 10), histogram.GetPercentile(50));
+         Assert.Equal(TimeSpan.FromTicks(1023 * 10), histogram.GetPercentile(75));
+         Assert.Equal(TimeSpan.FromMilliseconds(5), histogram.GetPercentile(95));
+         Assert.Equal(TimeSpan.FromMilliseconds(5), histogram.GetPercentile(100));
+      }
+
+      [Fact]
+      public void GetPercentile_StaysWithinFactorOfTwo()
+      {
+         VssLatencyHistogram histogram = new VssLatencyHistogram();
+         for (int i = 1; i <= 1000; i++)
+            histogram.Record(i * 0.1);
+
+         for (int percentile = 1; percentile <= 100; percentile++)
+         {
+            double expected = percentile * 10 * 0.1;
+            double actual = histogram.GetPercentile(percentile).TotalMilliseconds;
+            Assert.InRange(actual, expected, expected * 2);
+         }
+      }
+
+      [Fact]
+      public void GetPercentile_OutOfRange_Throws()
+      {
+         VssLatencyHistogram histogram = new VssLatencyHistogram();
+
+         Assert.Throws<ArgumentOutOfRangeException>(() => histogram.GetPercentile(-1));
+         Assert.Throws<ArgumentOutOfRangeException>(() => histogram.GetPercentile(100.5));
+      }
+
+      [Fact]
+      public void Record_Concurrently_CountsEveryDuration()
+      {
+         VssLatencyHistogram histogram = new VssLatencyHistogram();
+
+         Parallel.For(0, 10000, i => histogram.Record(i % 100));
+
+         Assert.Equal(10000, histogram.Count);
+         Assert.Equal(TimeSpan.FromMilliseconds(99), histogram.Maximum);
+         Assert.Equal(TimeSpan.FromMilliseconds(495000), histogram.Total);
+      }
+
+      [Fact]
+      public void Reset_DiscardsRecordedDurations()
+      {
+         VssLatencyHistogram histogram = new VssLatencyHistogram();
+         histogram.Record(2.0);
+
+         histogram.Reset();
+         histogram.Record(1.0);
+
+         Assert.Equal(1, histogram.Count);
+         Assert.Equal(TimeSpan.FromMilliseconds(1), histogram.Minimum);
+         Assert.Equal(TimeSpan.FromMilliseconds(1), histogram.Maximum);
+         Assert.Equal(TimeSpan.FromMilliseconds(1), histogram.GetPercentile(100));
+      }
+   }
+}
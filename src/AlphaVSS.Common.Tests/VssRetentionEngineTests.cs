@@ -0,0 +1,178 @@
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public class VssRetentionEngineTests
+   {
+      [Fact]
+      public async Task ApplyAsync_ProviderAndAttributeScope_DeletesExpiredSnapshotSets()
+      {
+         VssSimulatedFactory factory = CreateFactory(4);
+         VssRetentionEngine engine = new VssRetentionEngine(factory) { BatchSize = 2 };
+
+         VssRetentionResult result = await engine.ApplyAsync(new VssRetentionPolicy(), new VssRetentionScope { ProviderId = factory.Options.ProviderId, Attributes = VssVolumeSnapshotAttributes.ClientAccessible });
+
+         Assert.False(result.WasCanceled);
+         Assert.Empty(result.Failures);
+         Assert.Equal(3, result.Deleted.Count);
+         Assert.Equal(3, result.DeletedSnapshotCount);
+         Assert.Equal(result.Plan.Retained.Single().SnapshotSetId, Assert.Single(QuerySnapshots(factory)).SnapshotSetId);
+      }
+
+      [Fact]
+      public async Task ApplyAsync_SnapshotSetScope_IgnoresSnapshotsOutsideScope()
+      {
+         VssSimulatedFactory factory = CreateFactory(4);
+         List<Guid> setIds = QuerySnapshots(factory).Select(snapshot => snapshot.SnapshotSetId).ToList();
+         VssRetentionScope scope = new VssRetentionScope();
+         scope.SnapshotSetIds.Add(setIds[0]);
+         scope.SnapshotSetIds.Add(setIds[1]);
+
+         VssRetentionResult result = await new VssRetentionEngine(factory).ApplyAsync(new VssRetentionPolicy { KeepLatest = 0 }, scope);
+
+         Assert.Equal(2, result.Plan.Entries.Count);
+         Assert.Equal(2, result.Deleted.Count);
+         Assert.Equal(setIds.Skip(2).OrderBy(id => id), QuerySnapshots(factory).Select(snapshot => snapshot.SnapshotSetId).OrderBy(id => id));
+      }
+
+      [Fact]
+      public async Task ApplyAsync_OtherProvider_DeletesNothing()
+      {
+         VssSimulatedFactory factory = CreateFactory(3);
+
+         VssRetentionResult result = await new VssRetentionEngine(factory).ApplyAsync(new VssRetentionPolicy { KeepLatest = 0 }, new VssRetentionScope { ProviderId = Guid.NewGuid(), Attributes = VssVolumeSnapshotAttributes.ClientAccessible });
+
+         Assert.Empty(result.Plan.Entries);
+         Assert.Equal(3, QuerySnapshots(factory).Count);
+      }
+
+      [Fact]
+      public async Task ApplyAsync_WithoutScope_Throws()
+      {
+         VssSimulatedFactory factory = CreateFactory(3);
+         VssRetentionEngine engine = new VssRetentionEngine(factory);
+         VssRetentionPolicy policy = new VssRetentionPolicy { KeepLatest = 0 };
+
+         await Assert.ThrowsAsync<ArgumentNullException>(() => engine.ApplyAsync(null, new VssRetentionScope { ProviderId = Guid.Empty }));
+         await Assert.ThrowsAsync<ArgumentNullException>(() => engine.ApplyAsync(policy, null));
+         await Assert.ThrowsAsync<ArgumentException>(() => engine.ApplyAsync(policy, new VssRetentionScope()));
+         await Assert.ThrowsAsync<ArgumentException>(() => engine.ApplyAsync(policy, new VssRetentionScope { Attributes = VssVolumeSnapshotAttributes.Persistent }));
+         Assert.Equal(3, QuerySnapshots(factory).Count);
+      }
+
+      [Fact]
+      public async Task ApplyAsync_ProviderOnlyScope_Throws()
+      {
+         // The provider of the caller also creates the system restore points and the shadow copies of shared folders.
+         VssSimulatedFactory factory = CreateFactory(3);
+         VssRetentionScope scope = new VssRetentionScope { ProviderId = factory.Options.ProviderId, Attributes = VssVolumeSnapshotAttributes.Persistent };
+
+         Assert.True(scope.IsEmpty);
+         ArgumentException exception = await Assert.ThrowsAsync<ArgumentException>(() => new VssRetentionEngine(factory).ApplyAsync(new VssRetentionPolicy { KeepLatest = 0 }, scope));
+         Assert.Equal("scope", exception.ParamName);
+         Assert.Equal(3, QuerySnapshots(factory).Count);
+      }
+
+      [Fact]
+      public async Task ApplyAsync_CanceledWhileDeleting_ReturnsPartialResult()
+      {
+         using (CancellationTokenSource cancellation = new CancellationTokenSource())
+         {
+            // The first backup components object queries the snapshots, and each of the others deletes a batch of one set; 
+            // the cancellation is requested while creating the one for the third batch.
+            CancelingFactory factory = new CancelingFactory(CreateFactory(6), 4, cancellation);
+            VssRetentionEngine engine = new VssRetentionEngine(factory) { BatchSize = 1 };
+
+            VssRetentionResult result = await engine.ApplyAsync(new VssRetentionPolicy(), new VssRetentionScope { Attributes = VssVolumeSnapshotAttributes.ClientAccessible }, cancellation.Token);
+
+            Assert.True(result.WasCanceled);
+            Assert.Empty(result.Failures);
+            Assert.Equal(2, result.Deleted.Count);
+            Assert.Equal(3, result.Canceled.Count);
+            Assert.Equal(result.Plan.Deleted.Select(entry => entry.SnapshotSetId).OrderBy(id => id), result.Deleted.Concat(result.Canceled).Select(entry => entry.SnapshotSetId).OrderBy(id => id));
+            Assert.Equal(2, result.DeletedSnapshotCount);
+            Assert.Equal(4, QuerySnapshots(factory).Count);
+         }
+      }
+
+      [Fact]
+      public async Task ExecuteAsync_CanceledBeforeStart_ReportsAllSetsCanceled()
+      {
+         VssSimulatedFactory factory = CreateFactory(3);
+         VssRetentionPlan plan = new VssRetentionPolicy { KeepLatest = 0 }.CreatePlan(QuerySnapshots(factory), DateTime.Now);
+         using (CancellationTokenSource cancellation = new CancellationTokenSource())
+         {
+            cancellation.Cancel();
+
+            VssRetentionResult result = await new VssRetentionEngine(factory).ExecuteAsync(plan, cancellation.Token);
+
+            Assert.True(result.WasCanceled);
+            Assert.Empty(result.Deleted);
+            Assert.Equal(plan.Deleted, result.Canceled);
+            Assert.Equal(3, QuerySnapshots(factory).Count);
+         }
+      }
+
+      private static VssSimulatedFactory CreateFactory(int snapshotCount)
+      {
+         VssSimulationOptions options = new VssSimulationOptions { SnapshotCount = snapshotCount };
+         options.Volumes.Add(@"D:\");
+         return new VssSimulatedFactory(options);
+      }
+
+      private static IList<VssSnapshotProperties> QuerySnapshots(IVssFactory factory)
+      {
+         using (IVssBackupComponents backupComponents = factory.CreateVssBackupComponents())
+         {
+            backupComponents.InitializeForBackup(null);
+            backupComponents.SetContext(VssSnapshotContext.All);
+            return backupComponents.QuerySnapshots().ToList();
+         }
+      }
+
+      // Requests the cancellation when the specified backup components object is created.
+      private sealed class CancelingFactory : IVssFactory
+      {
+         private readonly IVssFactory m_factory;
+         private readonly CancellationTokenSource m_cancellation;
+         private readonly int m_cancelAt;
+         private int m_created;
+
+         public CancelingFactory(IVssFactory factory, int cancelAt, CancellationTokenSource cancellation)
+         {
+            m_factory = factory;
+            m_cancelAt = cancelAt;
+            m_cancellation = cancellation;
+         }
+
+         public IVssBackupComponents CreateVssBackupComponents()
+         {
+            if (Interlocked.Increment(ref m_created) == m_cancelAt)
+               m_cancellation.Cancel();
+
+            return m_factory.CreateVssBackupComponents();
+         }
+
+         public IVssSnapshotManagement CreateVssSnapshotManagement()
+         {
+            return m_factory.CreateVssSnapshotManagement();
+         }
+
+         public IVssExamineWriterMetadata CreateVssExamineWriterMetadata(string xml)
+         {
+            return m_factory.CreateVssExamineWriterMetadata(xml);
+         }
+
+         public IVssInfoProvider GetInfoProvider()
+         {
+            return m_factory.GetInfoProvider();
+         }
+      }
+   }
+}
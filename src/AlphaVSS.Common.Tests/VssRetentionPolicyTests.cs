@@ -0,0 +1,160 @@
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public class VssRetentionPolicyTests
+   {
+      // A Monday.
+      private static readonly DateTime s_now = new DateTime(2020, 6, 15, 12, 0, 0);
+
+      [Fact]
+      public void CreatePlan_KeepDaily_RetainsMostRecentSetOfEachDay()
+      {
+         VssSnapshotProperties[] snapshots = Snapshots(
+            s_now.AddHours(-1), s_now.AddHours(-2), new DateTime(2020, 6, 14, 20, 0, 0), new DateTime(2020, 6, 14, 8, 0, 0),
+            new DateTime(2020, 6, 13, 12, 0, 0), new DateTime(2020, 6, 12, 12, 0, 0));
+
+         VssRetentionPlan plan = new VssRetentionPolicy { KeepDaily = 3 }.CreatePlan(snapshots, s_now);
+
+         Assert.Equal(SetIds(snapshots, 0, 1, 2, 3, 4, 5), plan.Entries.Select(entry => entry.SnapshotSetId));
+         Assert.Equal(SetIds(snapshots, 0, 2, 4), plan.Retained.Select(entry => entry.SnapshotSetId));
+         Assert.Equal(SetIds(snapshots, 5, 3, 1), plan.Deleted.Select(entry => entry.SnapshotSetId));
+         Assert.Equal(VssRetentionReasons.Latest | VssRetentionReasons.Daily, plan.Entries[0].Reasons);
+         Assert.Equal(VssRetentionReasons.Daily, plan.Entries[2].Reasons);
+         Assert.All(plan.Deleted, entry => Assert.Equal(VssRetentionReasons.None, entry.Reasons));
+      }
+
+      [Fact]
+      public void CreatePlan_GroupsSnapshotsBySet()
+      {
+         Guid setId = Guid.NewGuid();
+         VssSnapshotProperties first = Snapshot(setId, s_now.AddMinutes(-10), @"C:\");
+         VssSnapshotProperties second = Snapshot(setId, s_now.AddMinutes(-9), @"D:\");
+
+         VssRetentionPlan plan = new VssRetentionPolicy().CreatePlan(new[] { second, first }, s_now);
+
+         VssRetentionPlanEntry entry = Assert.Single(plan.Entries);
+         Assert.Equal(setId, entry.SnapshotSetId);
+         Assert.Equal(first.CreationTimestamp, entry.CreationTimestamp);
+         Assert.Equal(2, entry.Snapshots.Count);
+         Assert.True(entry.IsRetained);
+      }
+
+      [Fact]
+      public void CreatePlan_MinimumAge_RetainsYoungerSets()
+      {
+         VssSnapshotProperties[] snapshots = Snapshots(s_now.AddHours(-1), s_now.AddHours(-23), s_now.AddHours(-25));
+
+         VssRetentionPlan plan = new VssRetentionPolicy { KeepLatest = 0, MinimumAge = TimeSpan.FromDays(1) }.CreatePlan(snapshots, s_now);
+
+         Assert.Equal(SetIds(snapshots, 0, 1), plan.Retained.Select(entry => entry.SnapshotSetId));
+         Assert.All(plan.Retained, entry => Assert.Equal(VssRetentionReasons.MinimumAge, entry.Reasons));
+         Assert.Equal(SetIds(snapshots, 2), plan.Deleted.Select(entry => entry.SnapshotSetId));
+      }
+
+      [Fact]
+      public void CreatePlan_KeepWeekly_UsesFirstDayOfWeek()
+      {
+         // A Sunday, the Monday before, and the Saturday before that.
+         VssSnapshotProperties[] snapshots = Snapshots(new DateTime(2020, 6, 14, 12, 0, 0), new DateTime(2020, 6, 8, 12, 0, 0), new DateTime(2020, 6, 6, 12, 0, 0));
+
+         VssRetentionPlan monday = new VssRetentionPolicy { KeepLatest = 0, KeepWeekly = 2 }.CreatePlan(snapshots, s_now);
+         VssRetentionPlan sunday = new VssRetentionPolicy { KeepLatest = 0, KeepWeekly = 2, FirstDayOfWeek = DayOfWeek.Sunday }.CreatePlan(snapshots, s_now);
+
+         Assert.Equal(SetIds(snapshots, 0, 2), monday.Retained.Select(entry => entry.SnapshotSetId));
+         Assert.Equal(SetIds(snapshots, 0, 1), sunday.Retained.Select(entry => entry.SnapshotSetId));
+         Assert.All(sunday.Retained, entry => Assert.Equal(VssRetentionReasons.Weekly, entry.Reasons));
+      }
+
+      [Fact]
+      public void CreatePlan_KeepMonthlyAndYearly_CombinesReasons()
+      {
+         VssSnapshotProperties[] snapshots = Snapshots(new DateTime(2020, 6, 1), new DateTime(2020, 5, 20), new DateTime(2020, 5, 10),
+            new DateTime(2019, 12, 31), new DateTime(2019, 6, 1), new DateTime(2018, 1, 1));
+
+         VssRetentionPlan plan = new VssRetentionPolicy { KeepLatest = 0, KeepMonthly = 2, KeepYearly = 2 }.CreatePlan(snapshots, s_now);
+
+         Assert.Equal(SetIds(snapshots, 0, 1, 3), plan.Retained.Select(entry => entry.SnapshotSetId));
+         Assert.Equal(VssRetentionReasons.Monthly | VssRetentionReasons.Yearly, plan.Retained[0].Reasons);
+         Assert.Equal(VssRetentionReasons.Monthly, plan.Retained[1].Reasons);
+         Assert.Equal(VssRetentionReasons.Yearly, plan.Retained[2].Reasons);
+         Assert.Equal(SetIds(snapshots, 5, 4, 2), plan.Deleted.Select(entry => entry.SnapshotSetId));
+      }
+
+      [Fact]
+      public void CreatePlan_MaxSnapshotsPerVolume_DeletesOldestRetainedSetsOfVolume()
+      {
+         VssSnapshotProperties[] snapshots =
+         {
+            Snapshot(Guid.NewGuid(), new DateTime(2020, 6, 15, 11, 0, 0), @"C:\"),
+            Snapshot(Guid.NewGuid(), new DateTime(2020, 6, 14, 12, 0, 0), @"C:\"),
+            Snapshot(Guid.NewGuid(), new DateTime(2020, 6, 13, 12, 0, 0), @"c:\"),
+            Snapshot(Guid.NewGuid(), new DateTime(2020, 6, 12, 12, 0, 0), @"C:\"),
+            Snapshot(Guid.NewGuid(), new DateTime(2020, 6, 11, 12, 0, 0), @"D:\")
+         };
+
+         VssRetentionPlan plan = new VssRetentionPolicy { KeepDaily = 10, MaxSnapshotsPerVolume = 2 }.CreatePlan(snapshots, s_now);
+
+         Assert.Equal(SetIds(snapshots, 0, 1, 4), plan.Retained.Select(entry => entry.SnapshotSetId));
+         Assert.Equal(SetIds(snapshots, 3, 2), plan.Deleted.Select(entry => entry.SnapshotSetId));
+         Assert.All(plan.Deleted, entry =>
+         {
+            Assert.True(entry.ExceedsVolumeLimit);
+            Assert.Equal(VssRetentionReasons.Daily, entry.Reasons);
+         });
+      }
+
+      [Fact]
+      public void CreatePlan_MaxSnapshotsPerVolume_KeepsProtectedSets()
+      {
+         VssSnapshotProperties[] snapshots = Snapshots(s_now.AddHours(-1), s_now.AddHours(-2), s_now.AddHours(-3));
+
+         VssRetentionPlan plan = new VssRetentionPolicy { KeepLatest = 3, MaxSnapshotsPerVolume = 1 }.CreatePlan(snapshots, s_now);
+
+         Assert.Equal(3, plan.Retained.Count);
+         Assert.Empty(plan.Deleted);
+      }
+
+      [Fact]
+      public void CreatePlan_NoSnapshots_ReturnsEmptyPlan()
+      {
+         VssRetentionPlan plan = new VssRetentionPolicy().CreatePlan(new VssSnapshotProperties[0], s_now);
+
+         Assert.Empty(plan.Entries);
+         Assert.Empty(plan.Retained);
+         Assert.Empty(plan.Deleted);
+      }
+
+      [Fact]
+      public void CreatePlan_InvalidArguments_Throws()
+      {
+         VssRetentionPolicy policy = new VssRetentionPolicy();
+
+         Assert.Throws<ArgumentNullException>(() => policy.CreatePlan(null, s_now));
+         Assert.Throws<ArgumentException>(() => policy.CreatePlan(new VssSnapshotProperties[] { null }, s_now));
+         Assert.Throws<ArgumentOutOfRangeException>(() => policy.KeepDaily = -1);
+         Assert.Throws<ArgumentOutOfRangeException>(() => policy.MinimumAge = TimeSpan.FromSeconds(-1));
+      }
+
+      // Creates one snapshot set per timestamp.
+      private static VssSnapshotProperties[] Snapshots(params DateTime[] timestamps)
+      {
+         return timestamps.Select(timestamp => Snapshot(Guid.NewGuid(), timestamp, @"C:\")).ToArray();
+      }
+
+      private static VssSnapshotProperties Snapshot(Guid snapshotSetId, DateTime creationTimestamp, string volume)
+      {
+         return new VssSnapshotProperties(Guid.NewGuid(), snapshotSetId, 1, null, volume, null, null, null, null, Guid.Empty,
+            (VssVolumeSnapshotAttributes)VssSnapshotContext.ClientAccessible, creationTimestamp, VssSnapshotState.Created);
+      }
+
+      private static IEnumerable<Guid> SetIds(VssSnapshotProperties[] snapshots, params int[] indices)
+      {
+         return indices.Select(index => snapshots[index].SnapshotSetId);
+      }
+   }
+}
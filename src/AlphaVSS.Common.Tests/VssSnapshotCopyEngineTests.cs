@@ -0,0 +1,207 @@
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public sealed class VssSnapshotCopyEngineTests : IDisposable
+   {
+      private readonly string m_root;
+      private readonly string m_source;
+      private readonly string m_destination;
+
+      public VssSnapshotCopyEngineTests()
+      {
+         m_root = Path.Combine(Path.GetTempPath(), "AlphaVSS.Tests." + Guid.NewGuid().ToString("N"));
+         m_source = Path.Combine(m_root, "Source");
+         m_destination = Path.Combine(m_root, "Destination");
+         Directory.CreateDirectory(m_source);
+      }
+
+      public void Dispose()
+      {
+         if (Directory.Exists(m_root))
+            Directory.Delete(m_root, true);
+      }
+
+      [Fact]
+      public async Task CopyAsync_SmallAndLargeFiles_CopiesContents()
+      {
+         VssSnapshotCopyEngine engine = new VssSnapshotCopyEngine(m_source, m_destination) { BufferSize = 4096, SmallFileThreshold = 1024 };
+         string[] paths = { "empty.bin", "small.bin", Path.Combine("a", "b", "large.bin"), Path.Combine("a", "exact.bin") };
+         byte[][] contents = { new byte[0], CreateContent(100), CreateContent(3 * 4096 + 17), CreateContent(4096) };
+         for (int i = 0; i < paths.Length; i++)
+            CreateFile(paths[i], contents[i]);
+         List<VssFileCopyResult> reported = new List<VssFileCopyResult>();
+
+         VssFileCopySummary summary = await engine.CopyAsync(paths, new SynchronousProgress(reported));
+
+         Assert.False(summary.IsCanceled);
+         Assert.Equal(0, summary.FailedCount);
+         Assert.Equal(contents.Sum(content => (long)content.Length), summary.BytesCopied);
+         Assert.Equal(paths, summary.Results.Select(result => result.RelativePath));
+         Assert.Equal(paths.OrderBy(path => path), reported.Select(result => result.RelativePath).OrderBy(path => path));
+         for (int i = 0; i < paths.Length; i++)
+         {
+            Assert.True(summary.Results[i].Succeeded);
+            Assert.Equal(contents[i].Length, summary.Results[i].BytesCopied);
+            Assert.Equal(contents[i], File.ReadAllBytes(Path.Combine(m_destination, paths[i])));
+            Assert.Equal(File.GetLastWriteTimeUtc(Path.Combine(m_source, paths[i])), File.GetLastWriteTimeUtc(Path.Combine(m_destination, paths[i])));
+         }
+      }
+
+      [Fact]
+      public async Task CopyAsync_ManyFiles_CopiesEveryFileOnce()
+      {
+         VssSnapshotCopyEngine engine = new VssSnapshotCopyEngine(m_source, m_destination) { MaxDegreeOfParallelism = 8 };
+         string[] paths = Enumerable.Range(0, 500).Select(i => Path.Combine((i % 7).ToString(), i + ".txt")).ToArray();
+         foreach (string path in paths)
+            CreateFile(path, System.Text.Encoding.UTF8.GetBytes(path));
+
+         VssFileCopySummary summary = await engine.CopyAsync(paths);
+
+         Assert.Equal(0, summary.FailedCount);
+         Assert.All(paths, path => Assert.Equal(path, File.ReadAllText(Path.Combine(m_destination, path))));
+      }
+
+      [Fact]
+      public async Task CopyAsync_MissingFile_ReportsErrorAndCopiesOthers()
+      {
+         VssSnapshotCopyEngine engine = new VssSnapshotCopyEngine(m_source, m_destination);
+         CreateFile("present.bin", CreateContent(10));
+
+         VssFileCopySummary summary = await engine.CopyAsync(new[] { "missing.bin", "present.bin" });
+
+         Assert.Equal(1, summary.FailedCount);
+         Assert.IsAssignableFrom<IOException>(summary.Results[0].Exception);
+         Assert.True(summary.Results[1].Succeeded);
+         Assert.Equal(10, summary.BytesCopied);
+      }
+
+      [Theory]
+      [InlineData("../outside.bin")]
+      [InlineData("a/../../outside.bin")]
+      [InlineData("a/../../Destination/outside.bin")]
+      [InlineData("..")]
+      [InlineData(".")]
+      [InlineData("")]
+      public async Task CopyAsync_PathOutsideOfRoots_IsRefused(string path)
+      {
+         VssSnapshotCopyEngine engine = new VssSnapshotCopyEngine(m_source, m_destination);
+         File.WriteAllText(Path.Combine(m_root, "outside.bin"), "outside");
+
+         VssFileCopySummary summary = await engine.CopyAsync(new[] { path });
+
+         Assert.IsType<ArgumentException>(Assert.Single(summary.Results).Exception);
+         Assert.False(File.Exists(Path.Combine(m_destination, "outside.bin")));
+         Assert.False(Directory.Exists(Path.Combine(m_root, "Destination", "Destination")));
+      }
+
+      [Fact]
+      public async Task CopyAsync_RootedPath_IsRefused()
+      {
+         VssSnapshotCopyEngine engine = new VssSnapshotCopyEngine(m_source, m_destination);
+         string rooted = Path.Combine(m_root, "outside.bin");
+         File.WriteAllText(rooted, "outside");
+
+         VssFileCopySummary summary = await engine.CopyAsync(new[] { rooted });
+
+         Assert.IsType<ArgumentException>(Assert.Single(summary.Results).Exception);
+      }
+
+      [Fact]
+      public async Task CopyAsync_Canceled_ReturnsResultsOfCopiedAndSkippedFiles()
+      {
+         VssSnapshotCopyEngine engine = new VssSnapshotCopyEngine(m_source, m_destination) { MaxDegreeOfParallelism = 1 };
+         string[] paths = Enumerable.Range(0, 10).Select(i => i + ".bin").ToArray();
+         foreach (string path in paths)
+            CreateFile(path, CreateContent(100));
+
+         using (CancellationTokenSource cancellation = new CancellationTokenSource())
+         {
+            // Progress is reported on the worker, so the cancellation is observed before the fourth file is started.
+            int reported = 0;
+            VssFileCopySummary summary = await engine.CopyAsync(paths, new SynchronousProgress(result =>
+            {
+               if (++reported == 3)
+                  cancellation.Cancel();
+            }), cancellation.Token);
+
+            Assert.True(summary.IsCanceled);
+            Assert.Equal(paths, summary.Results.Select(result => result.RelativePath));
+            Assert.All(summary.Results.Take(3), result => Assert.True(result.Succeeded));
+            Assert.All(summary.Results.Skip(3), result => Assert.IsType<OperationCanceledException>(result.Exception));
+            Assert.Equal(7, summary.FailedCount);
+            Assert.Equal(300, summary.BytesCopied);
+            Assert.False(File.Exists(Path.Combine(m_destination, paths[3])));
+         }
+      }
+
+      [Fact]
+      public async Task CopyAsync_CanceledBeforeStart_SkipsEveryFile()
+      {
+         VssSnapshotCopyEngine engine = new VssSnapshotCopyEngine(m_source, m_destination);
+         CreateFile("file.bin", CreateContent(1));
+
+         VssFileCopySummary summary = await engine.CopyAsync(new[] { "file.bin" }, null, new CancellationToken(true));
+
+         Assert.True(summary.IsCanceled);
+         Assert.IsType<OperationCanceledException>(Assert.Single(summary.Results).Exception);
+         Assert.False(Directory.Exists(m_destination));
+      }
+
+      [Fact]
+      public async Task CopyAsync_InvalidArguments_Throws()
+      {
+         VssSnapshotCopyEngine engine = new VssSnapshotCopyEngine(m_source, m_destination);
+
+         await Assert.ThrowsAsync<ArgumentNullException>(() => engine.CopyAsync(null));
+         await Assert.ThrowsAsync<ArgumentException>(() => engine.CopyAsync(new[] { "a", null }));
+         Assert.Throws<ArgumentNullException>(() => new VssSnapshotCopyEngine(null, m_destination));
+         Assert.Throws<ArgumentNullException>(() => new VssSnapshotCopyEngine(m_source, null));
+         Assert.Throws<ArgumentOutOfRangeException>(() => engine.MaxDegreeOfParallelism = 0);
+         Assert.Throws<ArgumentOutOfRangeException>(() => engine.BufferSize = 0);
+         Assert.Throws<ArgumentOutOfRangeException>(() => engine.SmallFileThreshold = -1);
+      }
+
+      private void CreateFile(string relativePath, byte[] content)
+      {
+         string path = Path.Combine(m_source, relativePath);
+         Directory.CreateDirectory(Path.GetDirectoryName(path));
+         File.WriteAllBytes(path, content);
+      }
+
+      private static byte[] CreateContent(int length)
+      {
+         byte[] content = new byte[length];
+         new Random(length).NextBytes(content);
+         return content;
+      }
+
+      // Invokes the handler on the reporting thread, unlike Progress<T>, which posts to the thread pool.
+      private sealed class SynchronousProgress : IProgress<VssFileCopyResult>
+      {
+         private readonly Action<VssFileCopyResult> m_handler;
+
+         public SynchronousProgress(List<VssFileCopyResult> results)
+            : this(result => { lock (results) results.Add(result); })
+         {
+         }
+
+         public SynchronousProgress(Action<VssFileCopyResult> handler)
+         {
+            m_handler = handler;
+         }
+
+         public void Report(VssFileCopyResult value)
+         {
+            m_handler(value);
+         }
+      }
+   }
+}
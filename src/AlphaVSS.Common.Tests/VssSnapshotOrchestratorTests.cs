@@ -0,0 +1,174 @@
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public class VssSnapshotOrchestratorTests
+   {
+      private static readonly string[] s_volumes = { @"C:\", @"D:\", @"E:\", @"F:\" };
+
+      [Fact]
+      public void Partition_WithoutConstraints_ReturnsOneGroupPerVolume()
+      {
+         IList<IList<string>> groups = VssSnapshotOrchestrator.Partition(new[] { @"C:\", @"D:\", @"c:" }, null);
+
+         Assert.Equal(2, groups.Count);
+         Assert.Equal(new[] { @"C:\" }, groups[0]);
+         Assert.Equal(new[] { @"D:\" }, groups[1]);
+      }
+
+      [Fact]
+      public void Partition_MergesVolumesOfOverlappingConstraints()
+      {
+         IList<IList<string>> groups = VssSnapshotOrchestrator.Partition(s_volumes,
+            new[] { new[] { @"F:\", @"D:" }, new[] { @"d:\", @"G:\" }, new[] { @"C:\" } });
+
+         Assert.Equal(3, groups.Count);
+         Assert.Equal(new[] { @"C:\" }, groups[0]);
+         Assert.Equal(new[] { @"D:\", @"F:\", @"G:\" }, groups[1]);
+         Assert.Equal(new[] { @"E:\" }, groups[2]);
+      }
+
+      [Fact]
+      public void Partition_NullElement_Throws()
+      {
+         Assert.Throws<ArgumentNullException>(() => VssSnapshotOrchestrator.Partition(null, null));
+         Assert.Throws<ArgumentException>(() => VssSnapshotOrchestrator.Partition(new[] { @"C:\", null }, null));
+         Assert.Throws<ArgumentException>(() => VssSnapshotOrchestrator.Partition(s_volumes, new[] { new[] { @"C:\" }, null }));
+      }
+
+      [Fact]
+      public async Task CreateSnapshotSetsAsync_ConcurrentGroups_TakeTurnsCreatingSnapshotSets()
+      {
+         VssSimulatedFactory factory = CreateFactory();
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(factory) { MaxDegreeOfParallelism = s_volumes.Length, RetryCount = 0 };
+
+         IList<VssSnapshotGroupResult> results = await orchestrator.CreateSnapshotSetsAsync(VssSnapshotOrchestrator.Partition(s_volumes, null));
+         try
+         {
+            Assert.Equal(s_volumes.Length, results.Count);
+            for (int i = 0; i < results.Count; i++)
+            {
+               Assert.True(results[i].Succeeded, results[i].Exception?.ToString());
+               Assert.Equal(s_volumes[i], Assert.Single(results[i].Snapshots).OriginalVolumeName);
+               Assert.Equal(results[i].SnapshotSetId, results[i].Snapshots[0].SnapshotSetId);
+               Assert.True(results[i].SnapshotTime >= factory.Options.SnapshotLatency - TimeSpan.FromMilliseconds(15));
+            }
+
+            Assert.Equal(results.Count, results.Select(result => result.SnapshotSetId).Distinct().Count());
+            Assert.Contains(results, result => result.QueueTime >= factory.Options.SnapshotLatency);
+         }
+         finally
+         {
+            foreach (VssSnapshotGroupResult result in results)
+               result.BackupComponents?.Dispose();
+         }
+      }
+
+      [Fact]
+      public async Task CreateSnapshotSetsAsync_FailedGroup_DoesNotBlockOtherGroups()
+      {
+         VssSimulatedFactory factory = CreateFactory();
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(factory) { MaxDegreeOfParallelism = 3, RetryCount = 0 };
+
+         IList<VssSnapshotGroupResult> results = await orchestrator.CreateSnapshotSetsAsync(new[] { new[] { @"C:\" }, new[] { @"Z:\" }, new[] { @"D:\" } });
+         try
+         {
+            Assert.True(results[0].Succeeded, results[0].Exception?.ToString());
+            Assert.IsType<VssVolumeNotSupportedException>(results[1].Exception);
+            Assert.Null(results[1].BackupComponents);
+            Assert.Empty(results[1].Snapshots);
+            Assert.True(results[2].Succeeded, results[2].Exception?.ToString());
+         }
+         finally
+         {
+            foreach (VssSnapshotGroupResult result in results)
+               result.BackupComponents?.Dispose();
+         }
+      }
+
+      [Fact]
+      public async Task CreateSnapshotSetsAsync_OtherRequesterInProgress_RetriesStartSnapshotSet()
+      {
+         VssSimulatedFactory factory = CreateFactory();
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(factory) { RetryCount = 20, RetryDelay = TimeSpan.FromMilliseconds(20) };
+
+         using (IVssBackupComponents other = factory.CreateVssBackupComponents())
+         {
+            other.InitializeForBackup(null);
+            other.StartSnapshotSet();
+
+            Task<IList<VssSnapshotGroupResult>> creation = orchestrator.CreateSnapshotSetsAsync(new[] { new[] { @"C:\" } });
+            await Task.Delay(TimeSpan.FromMilliseconds(100));
+            Assert.False(creation.IsCompleted);
+
+            other.AbortBackup();
+            VssSnapshotGroupResult result = Assert.Single(await creation);
+            Assert.True(result.Succeeded, result.Exception?.ToString());
+            result.BackupComponents.Dispose();
+         }
+      }
+
+      [Fact]
+      public async Task CreateSnapshotSetsAsync_OtherRequesterInProgress_FailsOnceRetriesAreExhausted()
+      {
+         VssSimulatedFactory factory = CreateFactory();
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(factory) { RetryCount = 2, RetryDelay = TimeSpan.FromMilliseconds(10) };
+
+         using (IVssBackupComponents other = factory.CreateVssBackupComponents())
+         {
+            other.InitializeForBackup(null);
+            other.StartSnapshotSet();
+
+            IList<VssSnapshotGroupResult> results = await orchestrator.CreateSnapshotSetsAsync(new[] { new[] { @"C:\" }, new[] { @"D:\" } });
+
+            Assert.All(results, result => Assert.IsType<VssSnapshotSetInProgressException>(result.Exception));
+            Assert.Empty(other.QuerySnapshots());
+         }
+      }
+
+      [Fact]
+      public async Task CreateSnapshotSetsAsync_Canceled_FailsGroups()
+      {
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(CreateFactory());
+         using (CancellationTokenSource cancellation = new CancellationTokenSource())
+         {
+            cancellation.Cancel();
+
+            IList<VssSnapshotGroupResult> results = await orchestrator.CreateSnapshotSetsAsync(new[] { new[] { @"C:\" } }, cancellation.Token);
+
+            Assert.IsAssignableFrom<OperationCanceledException>(Assert.Single(results).Exception);
+         }
+      }
+
+      [Fact]
+      public async Task CreateSnapshotSetsAsync_InvalidGroups_Throws()
+      {
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(CreateFactory());
+
+         await Assert.ThrowsAsync<ArgumentNullException>(() => orchestrator.CreateSnapshotSetsAsync(null));
+         await Assert.ThrowsAsync<ArgumentException>(() => orchestrator.CreateSnapshotSetsAsync(new[] { new string[0] }));
+         await Assert.ThrowsAsync<ArgumentException>(() => orchestrator.CreateSnapshotSetsAsync(new[] { new[] { @"C:\", null } }));
+      }
+
+      private static VssSimulatedFactory CreateFactory()
+      {
+         VssSimulationOptions options = new VssSimulationOptions
+         {
+            OperationLatency = TimeSpan.FromMilliseconds(10),
+            SnapshotLatency = TimeSpan.FromMilliseconds(40)
+         };
+
+         options.Volumes.Clear();
+         foreach (string volume in s_volumes)
+            options.Volumes.Add(volume);
+
+         return new VssSimulatedFactory(options);
+      }
+   }
+}
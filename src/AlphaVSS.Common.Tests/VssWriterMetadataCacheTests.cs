@@ -0,0 +1,130 @@
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Xunit;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   public sealed class VssWriterMetadataCacheTests : IDisposable
+   {
+      private readonly string m_root;
+      private readonly VssWriterMetadataCache m_cache;
+      private readonly VssSimulationOptions m_options;
+      private readonly VssSimulatedFactory m_factory;
+
+      public VssWriterMetadataCacheTests()
+      {
+         m_root = Path.Combine(Path.GetTempPath(), "AlphaVSS.Tests." + Guid.NewGuid().ToString("N"));
+         m_cache = new VssWriterMetadataCache(m_root);
+         m_options = new VssSimulationOptions();
+         m_options.Writers.Add(CreateWriter("First Writer", new Version(1, 0)));
+         m_options.Writers.Add(CreateWriter("Second Writer", new Version(2, 1)));
+         m_factory = new VssSimulatedFactory(m_options);
+      }
+
+      public void Dispose()
+      {
+         if (Directory.Exists(m_root))
+            Directory.Delete(m_root, true);
+      }
+
+      [Fact]
+      public async Task RefreshAsync_EmptyCache_ReportsAllWritersAddedAndStoresThem()
+      {
+         VssWriterMetadataDiff diff = await RefreshAsync(m_cache.Load(m_factory));
+
+         Assert.Equal(m_options.Writers.Select(writer => writer.InstanceId).OrderBy(id => id), diff.Added.Select(writer => writer.InstanceId).OrderBy(id => id));
+         Assert.Empty(diff.Removed);
+         Assert.Empty(diff.Changed);
+
+         IList<VssCapturedWriterMetadata> cached = m_cache.Load(m_factory);
+         Assert.Equal(2, cached.Count);
+         VssCapturedWriterMetadata second = m_cache.Load(m_factory, m_options.Writers[1].WriterId, m_options.Writers[1].InstanceId);
+         Assert.Equal("Second Writer", second.WriterName);
+         Assert.Equal(new Version(2, 1), second.Version);
+         Assert.Equal(m_options.Writers[1].Components.Single().ComponentName, second.Components.Single().ComponentName);
+      }
+
+      [Fact]
+      public async Task RefreshAsync_UnchangedWriters_ReportsNoDifference()
+      {
+         await RefreshAsync(m_cache.Load(m_factory));
+
+         VssWriterMetadataDiff diff = await RefreshAsync(m_cache.Load(m_factory));
+
+         Assert.True(diff.IsEmpty);
+      }
+
+      [Fact]
+      public async Task RefreshAsync_ChangedWriters_ReportsAddedRemovedAndChanged()
+      {
+         await RefreshAsync(m_cache.Load(m_factory));
+         VssSimulatedWriter removed = m_options.Writers[1];
+         m_options.Writers.RemoveAt(1);
+         m_options.Writers[0].Version = new Version(1, 1);
+         m_options.Writers.Add(CreateWriter("Third Writer", new Version(3, 0)));
+
+         VssWriterMetadataDiff diff = await RefreshAsync(m_cache.Load(m_factory));
+
+         Assert.Equal(m_options.Writers[1].InstanceId, Assert.Single(diff.Added).InstanceId);
+         Assert.Equal(removed.InstanceId, Assert.Single(diff.Removed).InstanceId);
+         Assert.Equal(m_options.Writers[0].InstanceId, Assert.Single(diff.Changed).InstanceId);
+         Assert.Equal(m_options.Writers.Select(writer => writer.InstanceId).OrderBy(id => id), m_cache.Load(m_factory).Select(writer => writer.InstanceId).OrderBy(id => id));
+      }
+
+      [Fact]
+      public void Load_DamagedEntry_DiscardsEntry()
+      {
+         m_cache.StoreAll(m_options.Writers);
+         string path = Directory.GetFiles(m_root).First();
+         File.AppendAllText(path, "<!-- damaged -->");
+
+         IList<VssCapturedWriterMetadata> cached = m_cache.Load(m_factory);
+
+         Assert.Single(cached);
+         Assert.False(File.Exists(path));
+      }
+
+      [Fact]
+      public void StoreAll_RemovesEntriesOfOtherWriters()
+      {
+         m_cache.StoreAll(m_options.Writers);
+
+         m_cache.StoreAll(m_options.Writers.Take(1));
+
+         Assert.Equal(m_options.Writers[0].InstanceId, Assert.Single(m_cache.Load(m_factory)).InstanceId);
+         Assert.Null(m_cache.Load(m_factory, m_options.Writers[1].WriterId, m_options.Writers[1].InstanceId));
+      }
+
+      [Fact]
+      public void Compare_SameDocument_ReportsNoDifference()
+      {
+         IList<VssCapturedWriterMetadata> first = VssCapturedWriterMetadata.Capture(m_options.Writers);
+         IList<VssCapturedWriterMetadata> second = VssCapturedWriterMetadata.Capture(m_options.Writers.Reverse());
+
+         Assert.True(VssWriterMetadataCache.Compare(first, second).IsEmpty);
+         Assert.Throws<ArgumentNullException>(() => VssWriterMetadataCache.Compare(null, second));
+         Assert.Throws<ArgumentNullException>(() => VssWriterMetadataCache.Compare(first, null));
+      }
+
+      private async Task<VssWriterMetadataDiff> RefreshAsync(IList<VssCapturedWriterMetadata> cached)
+      {
+         using (IVssBackupComponents backupComponents = m_factory.CreateVssBackupComponents())
+         {
+            backupComponents.InitializeForBackup(null);
+            return await m_cache.RefreshAsync(backupComponents, cached, CancellationToken.None);
+         }
+      }
+
+      private static VssSimulatedWriter CreateWriter(string name, Version version)
+      {
+         VssSimulatedWriter writer = new VssSimulatedWriter(Guid.NewGuid(), Guid.NewGuid(), name) { Version = version };
+         writer.AddComponent(VssComponentType.FileGroup, null, name.Replace(' ', '_')).Files.Add(new VssWMFileDescriptor(null, VssFileSpecificationBackupType.FullBackupRequired, "*", @"C:\" + name, true));
+         return writer;
+      }
+   }
+}
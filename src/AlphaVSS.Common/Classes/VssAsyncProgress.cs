@@ -0,0 +1,74 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A status sample of a long-running asynchronous VSS operation, reported periodically by the <see cref="IProgress{T}"/>
+   /// based asynchronous methods of <see cref="IVssProgressBackupComponents"/>.
+   /// </summary>
+   [Serializable]
+   public class VssAsyncProgress
+   {
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssAsyncProgress"/> class.
+      /// </summary>
+      /// <param name="elapsed">The time elapsed since the operation was started.</param>
+      /// <param name="status">The status of the operation when the sample was taken.</param>
+      /// <param name="writerStatus">The status of the writers when the operation was started, or <see langword="null"/> if the status was not available.</param>
+      public VssAsyncProgress(TimeSpan elapsed, VssError status, IReadOnlyList<VssWriterStatusInfo> writerStatus)
+      {
+         Elapsed = elapsed;
+         Status = status;
+         WriterStatus = writerStatus;
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the time elapsed since the operation was started.
+      /// </summary>
+      public TimeSpan Elapsed { get; private set; }
+
+      /// <summary>
+      /// Gets the status of the operation as reported by VSS when the sample was taken.
+      /// </summary>
+      /// <value>
+      /// <see cref="VssError.AsyncPending"/> while the operation is in progress, <see cref="VssError.AsyncFinished"/> or
+      /// <see cref="VssError.AsyncCanceled"/> once it has completed, or the error code of the operation if it failed.
+      /// </value>
+      public VssError Status { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the operation had completed (successfully or not) when the sample was taken.
+      /// </summary>
+      public bool IsCompleted
+      {
+         get
+         {
+            return Status != VssError.AsyncPending;
+         }
+      }
+
+      /// <summary>
+      /// Gets the status of the writers when the operation was started.
+      /// </summary>
+      /// <value>
+      /// The status of each writer, as returned by <see cref="IVssBackupComponents.WriterStatus"/>, or <see langword="null"/>
+      /// if the writer status could not be retrieved when the operation was started.
+      /// </value>
+      /// <remarks>
+      /// The writer status reflects the result of the last call to <see cref="IVssBackupComponents.GatherWriterStatus"/> made 
+      /// before the operation was started. It is retrieved once, before the operation is started, since VSS does not 
+      /// support retrieving it while the operation is in progress; every sample of the operation reports the same list.
+      /// </remarks>
+      public IReadOnlyList<VssWriterStatusInfo> WriterStatus { get; private set; }
+
+      #endregion
+   }
+}
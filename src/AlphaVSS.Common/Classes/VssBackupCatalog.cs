@@ -0,0 +1,303 @@
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// An in-memory index over the components of many saved Backup Components Documents, for planning restores without 
+   /// instantiating VSS.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///     Documents are added by streaming them through a <see cref="VssBackupDocumentReader"/>, so adding a document needs 
+   ///     memory proportional to its number of components only. Lookups by component and by backup stamp are hash lookups, 
+   ///     independent of the number of documents in the catalog. Strings repeating across documents, such as logical paths and 
+   ///     component names, are shared.
+   ///   </para>
+   ///   <para>
+   ///     All members of this class are thread safe.
+   ///   </para>
+   /// </remarks>
+   public sealed class VssBackupCatalog
+   {
+      #region Private Fields
+
+      private readonly object m_lock = new object();
+      private readonly VssStringPool m_pool = new VssStringPool();
+      private readonly Dictionary<string, List<VssBackupCatalogEntry>> m_documents = new Dictionary<string, List<VssBackupCatalogEntry>>(StringComparer.OrdinalIgnoreCase);
+      private readonly Dictionary<string, List<VssBackupCatalogEntry>> m_byComponent = new Dictionary<string, List<VssBackupCatalogEntry>>(StringComparer.OrdinalIgnoreCase);
+      private readonly Dictionary<string, List<VssBackupCatalogEntry>> m_byBackupStamp = new Dictionary<string, List<VssBackupCatalogEntry>>(StringComparer.Ordinal);
+      private int m_count;
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the number of documents in the catalog.
+      /// </summary>
+      public int DocumentCount
+      {
+         get
+         {
+            lock (m_lock)
+            {
+               return m_documents.Count;
+            }
+         }
+      }
+
+      /// <summary>
+      /// Gets the number of components in the catalog, over all documents.
+      /// </summary>
+      public int Count
+      {
+         get
+         {
+            lock (m_lock)
+            {
+               return m_count;
+            }
+         }
+      }
+
+      /// <summary>
+      /// Gets the ids of the documents in the catalog.
+      /// </summary>
+      public IList<string> DocumentIds
+      {
+         get
+         {
+            lock (m_lock)
+            {
+               return m_documents.Keys.ToList().AsReadOnly();
+            }
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Adds the saved Backup Components Document in the specified file to the catalog, using the full path of the file as its id.
+      /// </summary>
+      /// <param name="path">The path of the file.</param>
+      /// <returns>The header of the document.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="path"/> is <see langword="null"/>.</exception>
+      /// <exception cref="VssInvalidXmlDocumentException">The file does not contain a valid Backup Components Document.</exception>
+      /// <exception cref="IOException">The file could not be read.</exception>
+      public VssBackupDocumentHeader AddFile(string path)
+      {
+         if (path == null)
+            throw new ArgumentNullException(nameof(path));
+
+         using (FileStream stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, 64 * 1024, FileOptions.SequentialScan))
+         {
+            return Add(Path.GetFullPath(path), stream);
+         }
+      }
+
+      /// <summary>
+      /// Adds a saved Backup Components Document to the catalog, replacing any document with the same id.
+      /// </summary>
+      /// <param name="documentId">The id of the document, for instance the path or name under which it is stored. Ids are compared case-insensitively.</param>
+      /// <param name="stream">The stream containing the document. The stream is not closed.</param>
+      /// <returns>The header of the document.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="documentId"/> or <paramref name="stream"/> is <see langword="null"/>.</exception>
+      /// <exception cref="VssInvalidXmlDocumentException">The stream does not contain a valid Backup Components Document.</exception>
+      public VssBackupDocumentHeader Add(string documentId, Stream stream)
+      {
+         if (documentId == null)
+            throw new ArgumentNullException(nameof(documentId));
+
+         if (stream == null)
+            throw new ArgumentNullException(nameof(stream));
+
+         using (VssBackupDocumentReader reader = new VssBackupDocumentReader(stream))
+         {
+            return Add(documentId, reader);
+         }
+      }
+
+      /// <summary>
+      /// Adds a saved Backup Components Document to the catalog, replacing any document with the same id.
+      /// </summary>
+      /// <param name="documentId">The id of the document, for instance the path or name under which it is stored. Ids are compared case-insensitively.</param>
+      /// <param name="reader">The text reader providing the document. The reader is not closed.</param>
+      /// <returns>The header of the document.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="documentId"/> or <paramref name="reader"/> is <see langword="null"/>.</exception>
+      /// <exception cref="VssInvalidXmlDocumentException">The text reader does not provide a valid Backup Components Document.</exception>
+      public VssBackupDocumentHeader Add(string documentId, TextReader reader)
+      {
+         if (documentId == null)
+            throw new ArgumentNullException(nameof(documentId));
+
+         if (reader == null)
+            throw new ArgumentNullException(nameof(reader));
+
+         using (VssBackupDocumentReader documentReader = new VssBackupDocumentReader(reader))
+         {
+            return Add(documentId, documentReader);
+         }
+      }
+
+      /// <summary>
+      /// Removes a document from the catalog.
+      /// </summary>
+      /// <param name="documentId">The id of the document.</param>
+      /// <returns><see langword="true"/> if the document was removed; <see langword="false"/> if the catalog did not contain it.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="documentId"/> is <see langword="null"/>.</exception>
+      public bool Remove(string documentId)
+      {
+         if (documentId == null)
+            throw new ArgumentNullException(nameof(documentId));
+
+         lock (m_lock)
+         {
+            List<VssBackupCatalogEntry> entries;
+            if (!m_documents.TryGetValue(documentId, out entries))
+               return false;
+
+            m_documents.Remove(documentId);
+            m_count -= entries.Count;
+            foreach (VssBackupCatalogEntry entry in entries)
+            {
+               RemoveFromIndex(m_byComponent, GetComponentKey(entry.Key.WriterId, entry.Key.FullPath), entry);
+               if (entry.BackupStamp != null)
+                  RemoveFromIndex(m_byBackupStamp, entry.BackupStamp, entry);
+            }
+
+            return true;
+         }
+      }
+
+      /// <summary>
+      /// Gets the components of the specified document.
+      /// </summary>
+      /// <param name="documentId">The id of the document.</param>
+      /// <returns>The components of the document, in document order, or an empty list if the catalog does not contain the document.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="documentId"/> is <see langword="null"/>.</exception>
+      public IList<VssBackupCatalogEntry> GetDocument(string documentId)
+      {
+         if (documentId == null)
+            throw new ArgumentNullException(nameof(documentId));
+
+         lock (m_lock)
+         {
+            List<VssBackupCatalogEntry> entries;
+            return m_documents.TryGetValue(documentId, out entries) ? entries.ToList().AsReadOnly() : new List<VssBackupCatalogEntry>().AsReadOnly();
+         }
+      }
+
+      /// <summary>
+      /// Finds the backups of a component, over all instances of its writer class and all documents.
+      /// </summary>
+      /// <param name="writerId">The class id of the writer.</param>
+      /// <param name="logicalPath">The logical path of the component. May be <see langword="null"/>.</param>
+      /// <param name="componentName">The name of the component.</param>
+      /// <returns>The matching entries, in the order their documents were added.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="componentName"/> is <see langword="null"/>.</exception>
+      public IList<VssBackupCatalogEntry> Find(Guid writerId, string logicalPath, string componentName)
+      {
+         if (componentName == null)
+            throw new ArgumentNullException(nameof(componentName));
+
+         return Lookup(m_byComponent, GetComponentKey(writerId, VssComponentKey.GetFullPath(logicalPath, componentName)));
+      }
+
+      /// <summary>
+      /// Finds the components backed up with the specified backup stamp, for instance to find the backup an incremental or 
+      /// differential backup is based on from its <see cref="VssBackupCatalogEntry.PreviousBackupStamp"/>.
+      /// </summary>
+      /// <param name="backupStamp">The backup stamp. Backup stamps are compared case-sensitively.</param>
+      /// <returns>The matching entries, in the order their documents were added.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="backupStamp"/> is <see langword="null"/>.</exception>
+      public IList<VssBackupCatalogEntry> FindByBackupStamp(string backupStamp)
+      {
+         if (backupStamp == null)
+            throw new ArgumentNullException(nameof(backupStamp));
+
+         return Lookup(m_byBackupStamp, backupStamp);
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private VssBackupDocumentHeader Add(string documentId, VssBackupDocumentReader reader)
+      {
+         // Stream the document into entries outside the index lock, so that lookups are not blocked while it is read; the 
+         // file lists of each component are dropped as soon as the entry is created.
+         string id;
+         List<VssBackupCatalogEntry> entries = new List<VssBackupCatalogEntry>();
+         lock (m_pool)
+         {
+            id = m_pool.Intern(documentId);
+         }
+
+         while (reader.Read())
+         {
+            lock (m_pool)
+            {
+               entries.Add(new VssBackupCatalogEntry(id, reader.Header, reader.Current, m_pool));
+            }
+         }
+
+         lock (m_lock)
+         {
+            Remove(documentId);
+
+            foreach (VssBackupCatalogEntry entry in entries)
+            {
+               AddToIndex(m_byComponent, GetComponentKey(entry.Key.WriterId, entry.Key.FullPath), entry);
+               if (entry.BackupStamp != null)
+                  AddToIndex(m_byBackupStamp, entry.BackupStamp, entry);
+            }
+
+            m_documents.Add(id, entries);
+            m_count += entries.Count;
+         }
+
+         return reader.Header;
+      }
+
+      private IList<VssBackupCatalogEntry> Lookup(Dictionary<string, List<VssBackupCatalogEntry>> index, string key)
+      {
+         lock (m_lock)
+         {
+            List<VssBackupCatalogEntry> entries;
+            return index.TryGetValue(key, out entries) ? entries.ToList().AsReadOnly() : new List<VssBackupCatalogEntry>().AsReadOnly();
+         }
+      }
+
+      private static string GetComponentKey(Guid writerId, string fullPath)
+      {
+         return writerId.ToString("N") + "\\" + fullPath;
+      }
+
+      private static void AddToIndex(Dictionary<string, List<VssBackupCatalogEntry>> index, string key, VssBackupCatalogEntry entry)
+      {
+         List<VssBackupCatalogEntry> entries;
+         if (!index.TryGetValue(key, out entries))
+         {
+            entries = new List<VssBackupCatalogEntry>(1);
+            index.Add(key, entries);
+         }
+
+         entries.Add(entry);
+      }
+
+      private static void RemoveFromIndex(Dictionary<string, List<VssBackupCatalogEntry>> index, string key, VssBackupCatalogEntry entry)
+      {
+         List<VssBackupCatalogEntry> entries;
+         if (index.TryGetValue(key, out entries) && entries.Remove(entry) && entries.Count == 0)
+            index.Remove(key);
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,74 @@
+
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A component of a saved Backup Components Document in a <see cref="VssBackupCatalog"/>.
+   /// </summary>
+   /// <remarks>
+   ///   To keep the catalog small, an entry records only the number of partial and differenced files of the component. Use a 
+   ///   <see cref="VssBackupDocumentReader"/> on the document to read the files themselves.
+   /// </remarks>
+   [Serializable]
+   public sealed class VssBackupCatalogEntry
+   {
+      internal VssBackupCatalogEntry(string documentId, VssBackupDocumentHeader header, VssBackupDocumentComponent component, VssStringPool pool)
+      {
+         DocumentId = documentId;
+         Header = header;
+         Key = new VssComponentKey(component.Key.InstanceId, component.Key.WriterId, pool.Intern(component.Key.LogicalPath), pool.Intern(component.Key.ComponentName));
+         ComponentType = component.ComponentType;
+         BackupSucceeded = component.BackupSucceeded;
+         BackupStamp = pool.Intern(component.BackupStamp);
+         PreviousBackupStamp = pool.Intern(component.PreviousBackupStamp);
+         PartialFileCount = component.PartialFiles.Count;
+         DifferencedFileCount = component.DifferencedFiles.Count;
+      }
+
+      /// <summary>
+      /// Gets the id of the document containing the component, as specified when the document was added to the catalog.
+      /// </summary>
+      public string DocumentId { get; private set; }
+
+      /// <summary>
+      /// Gets the document-level attributes of the document containing the component.
+      /// </summary>
+      public VssBackupDocumentHeader Header { get; private set; }
+
+      /// <summary>
+      /// Gets the key identifying the component and its writer instance.
+      /// </summary>
+      public VssComponentKey Key { get; private set; }
+
+      /// <summary>
+      /// Gets the type of the component.
+      /// </summary>
+      public VssComponentType ComponentType { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the backup of the component succeeded.
+      /// </summary>
+      public bool BackupSucceeded { get; private set; }
+
+      /// <summary>
+      /// Gets the backup stamp of the component, or <see langword="null"/> if the writer did not set one.
+      /// </summary>
+      public string BackupStamp { get; private set; }
+
+      /// <summary>
+      /// Gets the backup stamp of the backup this backup is based on, or <see langword="null"/> if the requester did not set one.
+      /// </summary>
+      public string PreviousBackupStamp { get; private set; }
+
+      /// <summary>
+      /// Gets the number of partial files of the component.
+      /// </summary>
+      public int PartialFileCount { get; private set; }
+
+      /// <summary>
+      /// Gets the number of differenced files of the component.
+      /// </summary>
+      public int DifferencedFileCount { get; private set; }
+   }
+}
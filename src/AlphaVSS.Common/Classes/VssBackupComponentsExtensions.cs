@@ -0,0 +1,463 @@
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Provides batch operations and progress reporting on <see cref="IVssBackupComponents"/> instances.
+   /// </summary>
+   /// <remarks>
+   ///   Each batch method delegates to the <see cref="IVssBatchBackupComponents"/> implementation of the backup components object 
+   ///   if it has one, and otherwise falls back to the equivalent single item methods of <see cref="IVssBackupComponents"/>. 
+   ///   Likewise, each method reporting progress delegates to the <see cref="IVssProgressBackupComponents"/> implementation of 
+   ///   the backup components object if it has one. 
+   /// </remarks>
+   public static class VssBackupComponentsExtensions
+   {
+      // The longest report interval supported, in milliseconds; the longest due time of a System.Threading.Timer.
+      private const double MaxReportInterval = 4294967294.0;
+
+      // The longest delay supported by Task.Delay.
+      private static readonly TimeSpan s_maxDelay = TimeSpan.FromMilliseconds(Int32.MaxValue);
+
+      /// <summary>
+      /// 	Queries the completed shadow copies in the system that reside in the current context, fetching the properties of 
+      /// 	<paramref name="batchSize"/> shadow copies at a time from VSS.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object to query.</param>
+      /// <param name="batchSize">The maximum number of shadow copies to retrieve from VSS in a single call. Must be greater than zero.</param>
+      /// <returns>A lazily evaluated sequence of <see cref="VssSnapshotProperties"/> objects representing the requested information.</returns>
+      /// <remarks>
+      ///   See <see cref="IVssBatchBackupComponents.QuerySnapshots(int)"/> for more information. If <paramref name="backupComponents"/> 
+      ///   does not implement <see cref="IVssBatchBackupComponents"/>, <paramref name="batchSize"/> is validated and 
+      ///   <see cref="IVssBackupComponents.QuerySnapshots()"/> is called instead.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="batchSize"/> is less than one.</exception>
+      public static IEnumerable<VssSnapshotProperties> QuerySnapshots(this IVssBackupComponents backupComponents, int batchSize)
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException(nameof(backupComponents));
+
+         if (batchSize < 1)
+            throw new ArgumentOutOfRangeException(nameof(batchSize), "The batch size must be greater than zero.");
+
+         if (backupComponents is IVssBatchBackupComponents batchComponents)
+            return batchComponents.QuerySnapshots(batchSize);
+
+         return backupComponents.QuerySnapshots();
+      }
+
+      /// <summary>
+      ///   Captures the complete Writer Metadata Documents of all writers, as gathered by the last call to 
+      ///   <see cref="IVssBackupComponents.GatherWriterMetadata"/>.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object that gathered the writer metadata.</param>
+      /// <returns>
+      ///   A read-only list containing a <see cref="VssCapturedWriterMetadata"/> for each writer, in the order of 
+      ///   <see cref="IVssBackupComponents.WriterMetadata"/>.
+      /// </returns>
+      /// <remarks>
+      ///   See <see cref="IVssBatchBackupComponents.CaptureWriterMetadata"/> for more information. If <paramref name="backupComponents"/> 
+      ///   does not implement <see cref="IVssBatchBackupComponents"/>, the writer metadata returned by 
+      ///   <see cref="IVssBackupComponents.WriterMetadata"/> is captured using 
+      ///   <see cref="VssCapturedWriterMetadata.Capture(IEnumerable{IVssExamineWriterMetadata})"/> instead.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, or <see cref="IVssBackupComponents.GatherWriterMetadata"/> has not completed.</exception>
+      public static IList<VssCapturedWriterMetadata> CaptureWriterMetadata(this IVssBackupComponents backupComponents)
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException(nameof(backupComponents));
+
+         if (backupComponents is IVssBatchBackupComponents batchComponents)
+            return batchComponents.CaptureWriterMetadata();
+
+         return VssCapturedWriterMetadata.Capture(backupComponents.WriterMetadata);
+      }
+
+      /// <summary>
+      ///   Adds a batch of components to the backup set in the Backup Components Document, and sets the backup options and 
+      ///   previous backup stamp of each component that specifies them.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object to add the components to.</param>
+      /// <param name="components">The components to add.</param>
+      /// <returns>
+      ///   A read-only list describing the components that could not be added or updated, in batch order. The list is empty if 
+      ///   every component was processed successfully.
+      /// </returns>
+      /// <remarks>
+      ///   See <see cref="IVssBatchBackupComponents.AddComponents"/> for more information. If <paramref name="backupComponents"/> 
+      ///   does not implement <see cref="IVssBatchBackupComponents"/>, <see cref="IVssBackupComponents.AddComponent"/>, 
+      ///   <see cref="IVssBackupComponents.SetBackupOptions"/> and <see cref="IVssBackupComponents.SetPreviousBackupStamp"/> are 
+      ///   called for each component in turn instead, with the same handling of failures.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> or <paramref name="components"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="components"/> contains a <see langword="null"/> element, or an element whose <see cref="VssComponentSelection.ComponentName"/> is <see langword="null"/>. No component is processed in that case.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>
+      public static IList<VssComponentSelectionFailure> AddComponents(this IVssBackupComponents backupComponents, IEnumerable<VssComponentSelection> components)
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException(nameof(backupComponents));
+
+         if (backupComponents is IVssBatchBackupComponents batchComponents)
+            return batchComponents.AddComponents(components);
+
+         return SelectComponents(components, component =>
+         {
+            backupComponents.AddComponent(component.InstanceId, component.WriterId, component.ComponentType, component.LogicalPath, component.ComponentName);
+
+            if (component.BackupOptions != null)
+               backupComponents.SetBackupOptions(component.WriterId, component.ComponentType, component.LogicalPath, component.ComponentName, component.BackupOptions);
+
+            if (component.PreviousBackupStamp != null)
+               backupComponents.SetPreviousBackupStamp(component.WriterId, component.ComponentType, component.LogicalPath, component.ComponentName, component.PreviousBackupStamp);
+         });
+      }
+
+      /// <summary>
+      ///   Indicates whether the backup of each of a batch of components succeeded.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object to update.</param>
+      /// <param name="components">The components to update. Only the writer and component identification of each element is used.</param>
+      /// <param name="succeeded">
+      ///   <see langword="true"/> if the backup of the components succeeded, and <see langword="false"/> if it did not.
+      /// </param>
+      /// <returns>
+      ///   A read-only list describing the components that could not be updated, in batch order. The list is empty if 
+      ///   every component was updated successfully.
+      /// </returns>
+      /// <remarks>
+      ///   See <see cref="IVssBatchBackupComponents.SetBackupSucceeded"/> for more information. If <paramref name="backupComponents"/> 
+      ///   does not implement <see cref="IVssBatchBackupComponents"/>, 
+      ///   <see cref="IVssBackupComponents.SetBackupSucceeded(Guid, Guid, VssComponentType, string, string, bool)"/> is called for 
+      ///   each component in turn instead, with the same handling of failures.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> or <paramref name="components"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="components"/> contains a <see langword="null"/> element, or an element whose <see cref="VssComponentSelection.ComponentName"/> is <see langword="null"/>. No component is processed in that case.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>
+      public static IList<VssComponentSelectionFailure> SetBackupSucceeded(this IVssBackupComponents backupComponents, IEnumerable<VssComponentSelection> components, bool succeeded)
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException(nameof(backupComponents));
+
+         if (backupComponents is IVssBatchBackupComponents batchComponents)
+            return batchComponents.SetBackupSucceeded(components, succeeded);
+
+         return SelectComponents(components, component =>
+            backupComponents.SetBackupSucceeded(component.InstanceId, component.WriterId, component.ComponentType, component.LogicalPath, component.ComponentName, succeeded));
+      }
+
+      /// <summary>
+      /// Asynchronously causes VSS to notify writers to prepare for a backup, reporting periodic status samples of the operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object performing the operation.</param>
+      /// <param name="progress">The provider that receives periodic status samples of the operation. A final sample is reported when the operation has completed.</param>
+      /// <param name="reportInterval">The interval at which status samples are reported to <paramref name="progress"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
+      /// <returns>A <see cref="Task"/> that represents the asynchronous operation.</returns>
+      /// <remarks>
+      ///   See <see cref="IVssProgressBackupComponents.PrepareForBackupAsync(IProgress{VssAsyncProgress}, TimeSpan, CancellationToken)"/> for more 
+      ///   information. If <paramref name="backupComponents"/> does not implement <see cref="IVssProgressBackupComponents"/>, 
+      ///   <see cref="IVssBackupComponents.PrepareForBackupAsync(CancellationToken)"/> is called instead, and the samples report the 
+      ///   operation as pending until the task it returns has completed.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> or <paramref name="progress"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="reportInterval"/> is not greater than zero, or is greater than 4294967294 milliseconds.</exception>
+      public static Task PrepareForBackupAsync(this IVssBackupComponents backupComponents, IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken = default)
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException(nameof(backupComponents));
+
+         if (backupComponents is IVssProgressBackupComponents progressComponents)
+            return progressComponents.PrepareForBackupAsync(progress, reportInterval, cancellationToken);
+
+         return ReportProgress(backupComponents, token => backupComponents.PrepareForBackupAsync(token), progress, reportInterval, cancellationToken);
+      }
+
+      /// <summary>
+      /// Asynchronously commits all shadow copies in this set simultaneously, reporting periodic status samples of the operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object performing the operation.</param>
+      /// <param name="progress">The provider that receives periodic status samples of the operation. A final sample is reported when the operation has completed.</param>
+      /// <param name="reportInterval">The interval at which status samples are reported to <paramref name="progress"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
+      /// <returns>A <see cref="Task"/> that represents the asynchronous operation.</returns>
+      /// <remarks>
+      ///   See <see cref="IVssProgressBackupComponents.DoSnapshotSetAsync(IProgress{VssAsyncProgress}, TimeSpan, CancellationToken)"/> for more 
+      ///   information. If <paramref name="backupComponents"/> does not implement <see cref="IVssProgressBackupComponents"/>, 
+      ///   <see cref="IVssBackupComponents.DoSnapshotSetAsync(CancellationToken)"/> is called instead, and the samples report the 
+      ///   operation as pending until the task it returns has completed.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> or <paramref name="progress"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="reportInterval"/> is not greater than zero, or is greater than 4294967294 milliseconds.</exception>
+      public static Task DoSnapshotSetAsync(this IVssBackupComponents backupComponents, IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken = default)
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException(nameof(backupComponents));
+
+         if (backupComponents is IVssProgressBackupComponents progressComponents)
+            return progressComponents.DoSnapshotSetAsync(progress, reportInterval, cancellationToken);
+
+         return ReportProgress(backupComponents, token => backupComponents.DoSnapshotSetAsync(token), progress, reportInterval, cancellationToken);
+      }
+
+      /// <summary>
+      /// Asynchronously causes VSS to generate a <b>BackupComplete</b> event, which signals writers that the backup process has 
+      /// completed, reporting periodic status samples of the operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object performing the operation.</param>
+      /// <param name="progress">The provider that receives periodic status samples of the operation. A final sample is reported when the operation has completed.</param>
+      /// <param name="reportInterval">The interval at which status samples are reported to <paramref name="progress"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
+      /// <returns>A <see cref="Task"/> that represents the asynchronous operation.</returns>
+      /// <remarks>
+      ///   See <see cref="IVssProgressBackupComponents.BackupCompleteAsync(IProgress{VssAsyncProgress}, TimeSpan, CancellationToken)"/> for more 
+      ///   information. If <paramref name="backupComponents"/> does not implement <see cref="IVssProgressBackupComponents"/>, 
+      ///   <see cref="IVssBackupComponents.BackupCompleteAsync(CancellationToken)"/> is called instead, and the samples report the 
+      ///   operation as pending until the task it returns has completed.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> or <paramref name="progress"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="reportInterval"/> is not greater than zero, or is greater than 4294967294 milliseconds.</exception>
+      public static Task BackupCompleteAsync(this IVssBackupComponents backupComponents, IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken = default)
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException(nameof(backupComponents));
+
+         if (backupComponents is IVssProgressBackupComponents progressComponents)
+            return progressComponents.BackupCompleteAsync(progress, reportInterval, cancellationToken);
+
+         return ReportProgress(backupComponents, token => backupComponents.BackupCompleteAsync(token), progress, reportInterval, cancellationToken);
+      }
+
+      /// <summary>
+      /// Asynchronously prompts each writer to send the metadata they have collected, reporting periodic status samples of the 
+      /// operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object performing the operation.</param>
+      /// <param name="progress">The provider that receives periodic status samples of the operation. A final sample is reported when the operation has completed.</param>
+      /// <param name="reportInterval">The interval at which status samples are reported to <paramref name="progress"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
+      /// <returns>A <see cref="Task"/> that represents the asynchronous operation.</returns>
+      /// <remarks>
+      ///   See <see cref="IVssProgressBackupComponents.GatherWriterMetadataAsync(IProgress{VssAsyncProgress}, TimeSpan, CancellationToken)"/> for more 
+      ///   information. If <paramref name="backupComponents"/> does not implement <see cref="IVssProgressBackupComponents"/>, 
+      ///   <see cref="IVssBackupComponents.GatherWriterMetadataAsync(CancellationToken)"/> is called instead, and the samples report the 
+      ///   operation as pending until the task it returns has completed.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> or <paramref name="progress"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="reportInterval"/> is not greater than zero, or is greater than 4294967294 milliseconds.</exception>
+      public static Task GatherWriterMetadataAsync(this IVssBackupComponents backupComponents, IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken = default)
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException(nameof(backupComponents));
+
+         if (backupComponents is IVssProgressBackupComponents progressComponents)
+            return progressComponents.GatherWriterMetadataAsync(progress, reportInterval, cancellationToken);
+
+         return ReportProgress(backupComponents, token => backupComponents.GatherWriterMetadataAsync(token), progress, reportInterval, cancellationToken);
+      }
+
+      /// <summary>
+      /// Asynchronously prompts each writer to send a status message, reporting periodic status samples of the operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object performing the operation.</param>
+      /// <param name="progress">The provider that receives periodic status samples of the operation. A final sample is reported when the operation has completed.</param>
+      /// <param name="reportInterval">The interval at which status samples are reported to <paramref name="progress"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
+      /// <returns>A <see cref="Task"/> that represents the asynchronous operation.</returns>
+      /// <remarks>
+      ///   See <see cref="IVssProgressBackupComponents.GatherWriterStatusAsync(IProgress{VssAsyncProgress}, TimeSpan, CancellationToken)"/> for more 
+      ///   information. If <paramref name="backupComponents"/> does not implement <see cref="IVssProgressBackupComponents"/>, 
+      ///   <see cref="IVssBackupComponents.GatherWriterStatusAsync(CancellationToken)"/> is called instead, and the samples report the 
+      ///   operation as pending until the task it returns has completed.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> or <paramref name="progress"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="reportInterval"/> is not greater than zero, or is greater than 4294967294 milliseconds.</exception>
+      public static Task GatherWriterStatusAsync(this IVssBackupComponents backupComponents, IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken = default)
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException(nameof(backupComponents));
+
+         if (backupComponents is IVssProgressBackupComponents progressComponents)
+            return progressComponents.GatherWriterStatusAsync(progress, reportInterval, cancellationToken);
+
+         return ReportProgress(backupComponents, token => backupComponents.GatherWriterStatusAsync(token), progress, reportInterval, cancellationToken);
+      }
+
+      /// <summary>
+      /// Asynchronously notifies writers to prepare for a restore operation, reporting periodic status samples of the operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object performing the operation.</param>
+      /// <param name="progress">The provider that receives periodic status samples of the operation. A final sample is reported when the operation has completed.</param>
+      /// <param name="reportInterval">The interval at which status samples are reported to <paramref name="progress"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
+      /// <returns>A <see cref="Task"/> that represents the asynchronous operation.</returns>
+      /// <remarks>
+      ///   See <see cref="IVssProgressBackupComponents.PreRestoreAsync(IProgress{VssAsyncProgress}, TimeSpan, CancellationToken)"/> for more 
+      ///   information. If <paramref name="backupComponents"/> does not implement <see cref="IVssProgressBackupComponents"/>, 
+      ///   <see cref="IVssBackupComponents.PreRestoreAsync(CancellationToken)"/> is called instead, and the samples report the 
+      ///   operation as pending until the task it returns has completed.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> or <paramref name="progress"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="reportInterval"/> is not greater than zero, or is greater than 4294967294 milliseconds.</exception>
+      public static Task PreRestoreAsync(this IVssBackupComponents backupComponents, IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken = default)
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException(nameof(backupComponents));
+
+         if (backupComponents is IVssProgressBackupComponents progressComponents)
+            return progressComponents.PreRestoreAsync(progress, reportInterval, cancellationToken);
+
+         return ReportProgress(backupComponents, token => backupComponents.PreRestoreAsync(token), progress, reportInterval, cancellationToken);
+      }
+
+      /// <summary>
+      /// Asynchronously notifies writers that a restore has completed, reporting periodic status samples of the operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object performing the operation.</param>
+      /// <param name="progress">The provider that receives periodic status samples of the operation. A final sample is reported when the operation has completed.</param>
+      /// <param name="reportInterval">The interval at which status samples are reported to <paramref name="progress"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
+      /// <returns>A <see cref="Task"/> that represents the asynchronous operation.</returns>
+      /// <remarks>
+      ///   See <see cref="IVssProgressBackupComponents.PostRestoreAsync(IProgress{VssAsyncProgress}, TimeSpan, CancellationToken)"/> for more 
+      ///   information. If <paramref name="backupComponents"/> does not implement <see cref="IVssProgressBackupComponents"/>, 
+      ///   <see cref="IVssBackupComponents.PostRestoreAsync(CancellationToken)"/> is called instead, and the samples report the 
+      ///   operation as pending until the task it returns has completed.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> or <paramref name="progress"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="reportInterval"/> is not greater than zero, or is greater than 4294967294 milliseconds.</exception>
+      public static Task PostRestoreAsync(this IVssBackupComponents backupComponents, IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken = default)
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException(nameof(backupComponents));
+
+         if (backupComponents is IVssProgressBackupComponents progressComponents)
+            return progressComponents.PostRestoreAsync(progress, reportInterval, cancellationToken);
+
+         return ReportProgress(backupComponents, token => backupComponents.PostRestoreAsync(token), progress, reportInterval, cancellationToken);
+      }
+
+      /// <summary>
+      ///   Starts an operation of a backup components object that does not implement <see cref="IVssProgressBackupComponents"/>, 
+      ///   reporting samples of it as <see cref="IVssProgressBackupComponents"/> implementations do.
+      /// </summary>
+      /// <remarks>
+      ///   The writer status is retrieved before the operation is started, on the calling thread, so that VSS is not called 
+      ///   while the operation is in progress. The status of the operation is only known once its task has completed.
+      /// </remarks>
+      private static Task ReportProgress(IVssBackupComponents backupComponents, Func<CancellationToken, Task> start, IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         if (progress == null)
+            throw new ArgumentNullException(nameof(progress));
+
+         if (reportInterval <= TimeSpan.Zero || reportInterval.TotalMilliseconds > MaxReportInterval)
+            throw new ArgumentOutOfRangeException(nameof(reportInterval), "The report interval must be greater than zero and no greater than 4294967294 milliseconds.");
+
+         IReadOnlyList<VssWriterStatusInfo> writerStatus;
+         try
+         {
+            writerStatus = backupComponents.WriterStatus.ToList().AsReadOnly();
+         }
+         catch (VssException)
+         {
+            // Writer status is not available before it has been gathered.
+            writerStatus = null;
+         }
+
+         Stopwatch stopwatch = Stopwatch.StartNew();
+         return ReportProgressAsync(start(cancellationToken), progress, reportInterval, writerStatus, stopwatch);
+      }
+
+      private static async Task ReportProgressAsync(Task operation, IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, IReadOnlyList<VssWriterStatusInfo> writerStatus, Stopwatch stopwatch)
+      {
+         using (CancellationTokenSource delayCancellation = new CancellationTokenSource())
+         {
+            // Task.Delay does not support the longest report intervals, so long intervals are waited for in several steps. 
+            // The next sample is only due once the previous one has been reported, so that samples never overlap.
+            TimeSpan due = reportInterval;
+            while (true)
+            {
+               TimeSpan remaining = due - stopwatch.Elapsed;
+               Task delay = Task.Delay(remaining > s_maxDelay ? s_maxDelay : remaining > TimeSpan.Zero ? remaining : TimeSpan.Zero, delayCancellation.Token);
+               if (await Task.WhenAny(operation, delay).ConfigureAwait(false) == operation)
+                  break;
+
+               if (stopwatch.Elapsed >= due)
+               {
+                  Report(progress, stopwatch.Elapsed, VssError.AsyncPending, writerStatus);
+                  due = stopwatch.Elapsed + reportInterval;
+               }
+            }
+
+            delayCancellation.Cancel();
+         }
+
+         VssError status = operation.IsCanceled ? VssError.AsyncCanceled
+            : operation.IsFaulted ? (VssError)operation.Exception.InnerException.HResult
+            : VssError.AsyncFinished;
+         Report(progress, stopwatch.Elapsed, status, writerStatus);
+
+         await operation.ConfigureAwait(false);
+      }
+
+      // Like the platform specific implementation, a failing progress handler loses its sample, but neither fails nor masks 
+      // the outcome of the operation.
+      private static void Report(IProgress<VssAsyncProgress> progress, TimeSpan elapsed, VssError status, IReadOnlyList<VssWriterStatusInfo> writerStatus)
+      {
+         try
+         {
+            progress.Report(new VssAsyncProgress(elapsed, status, writerStatus));
+         }
+         catch (Exception)
+         {
+         }
+      }
+
+      /// <summary>
+      ///   Applies <paramref name="select"/> to each component of a batch, collecting the failures as 
+      ///   <see cref="IVssBatchBackupComponents"/> implementations report them.
+      /// </summary>
+      /// <remarks>
+      ///   The batch is copied and validated before any component is processed. Exceptions that do not concern the individual 
+      ///   component, i.e. <see cref="ArgumentNullException"/>, <see cref="ObjectDisposedException"/> and 
+      ///   <see cref="VssBadStateException"/>, are not collected but propagated, and stop the processing of the batch.
+      /// </remarks>
+      private static IList<VssComponentSelectionFailure> SelectComponents(IEnumerable<VssComponentSelection> components, Action<VssComponentSelection> select)
+      {
+         if (components == null)
+            throw new ArgumentNullException(nameof(components));
+
+         VssComponentSelection[] batch = components.ToArray();
+         for (int i = 0; i < batch.Length; i++)
+         {
+            if (batch[i] == null)
+               throw new ArgumentException(String.Format("The component batch contains a null element at index {0}.", i), nameof(components));
+
+            if (batch[i].ComponentName == null)
+               throw new ArgumentException(String.Format("The component at index {0} of the batch has no component name.", i), nameof(components));
+         }
+
+         List<VssComponentSelectionFailure> failures = new List<VssComponentSelectionFailure>();
+         for (int i = 0; i < batch.Length; i++)
+         {
+            try
+            {
+               select(batch[i]);
+            }
+            catch (Exception ex) when (!(ex is ArgumentNullException || ex is ObjectDisposedException || ex is VssBadStateException))
+            {
+               failures.Add(new VssComponentSelectionFailure(i, batch[i], ex));
+            }
+         }
+
+         return failures.AsReadOnly();
+      }
+   }
+}
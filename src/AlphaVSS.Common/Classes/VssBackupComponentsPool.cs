@@ -0,0 +1,280 @@
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Diagnostics.Tracing;
+using System.Threading.Tasks;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Keeps a number of backup components objects created and initialized for backup ahead of time, so that a backup session 
+   /// can start without waiting for <see cref="IVssFactory.CreateVssBackupComponents"/> and 
+   /// <see cref="IVssBackupComponents.InitializeForBackup"/>.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///     A backup components object can be used for a single backup session only, so rented objects are never returned to the 
+   ///     pool; the caller owns and disposes them. Instead, each <see cref="Rent"/> starts creating a replacement in the background, 
+   ///     on a thread pool thread, keeping up to <see cref="Capacity"/> objects ready.
+   ///   </para>
+   ///   <para>
+   ///     The creation of each object is reported as the <c>CreateVssBackupComponents</c> phase of <see cref="VssEventSource"/>. 
+   ///     A failure to create an object in the background is not reported otherwise; <see cref="Rent"/> then creates the object 
+   ///     on the calling thread, and throws the exception. After a failure the pool stops creating objects in the background, so 
+   ///     that an unavailable VSS service is not retried on every call, until an object has been created on the calling thread 
+   ///     by <see cref="Rent"/> or <see cref="Fill"/>.
+   ///   </para>
+   ///   <para>
+   ///     Objects created in the background are created on thread pool threads, which belong to the multithreaded apartment, and 
+   ///     the platform implementation calls them without marshaling. Rent objects from threads of the multithreaded apartment 
+   ///     only, such as thread pool threads, and not from single-threaded apartment threads such as user interface threads.
+   ///   </para>
+   ///   <para>
+   ///     An idle object holds a connection to the VSS service, but no writer or snapshot state: writer metadata is gathered 
+   ///     after the object has been rented. Objects therefore do not go stale while they wait in the pool, and are kept until 
+   ///     rented or until the pool is disposed. Size <see cref="Capacity"/> for the number of sessions expected to start at once, 
+   ///     and dispose the pool once no more sessions are expected.
+   ///   </para>
+   ///   <para>
+   ///     All members of this class are thread safe.
+   ///   </para>
+   /// </remarks>
+   public sealed class VssBackupComponentsPool : IDisposable
+   {
+      #region Private Fields
+
+      private const string CreatePhase = "CreateVssBackupComponents";
+
+      private readonly object m_lock = new object();
+      private readonly IVssFactory m_factory;
+      private readonly Queue<IVssBackupComponents> m_idle = new Queue<IVssBackupComponents>();
+      private int m_pending;
+      private bool m_faulted;
+      private bool m_disposed;
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssBackupComponentsPool"/> class. The pool is empty until <see cref="Fill"/> 
+      /// or <see cref="Rent"/> is called.
+      /// </summary>
+      /// <param name="factory">The factory creating the backup components objects.</param>
+      /// <param name="capacity">The number of objects to keep ready.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="factory"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="capacity"/> is less than one.</exception>
+      public VssBackupComponentsPool(IVssFactory factory, int capacity)
+      {
+         if (factory == null)
+            throw new ArgumentNullException(nameof(factory));
+
+         if (capacity < 1)
+            throw new ArgumentOutOfRangeException(nameof(capacity), "The capacity must be greater than zero.");
+
+         m_factory = factory;
+         Capacity = capacity;
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the number of objects the pool keeps ready.
+      /// </summary>
+      public int Capacity { get; private set; }
+
+      /// <summary>
+      /// Gets the number of objects currently ready to be rented.
+      /// </summary>
+      public int Count
+      {
+         get
+         {
+            lock (m_lock)
+            {
+               return m_idle.Count;
+            }
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Creates objects on the calling thread until the pool holds <see cref="Capacity"/> objects, counting those being created 
+      /// in the background.
+      /// </summary>
+      /// <exception cref="ObjectDisposedException">The pool has been disposed.</exception>
+      public void Fill()
+      {
+         lock (m_lock)
+            ThrowIfDisposed();
+
+         while (TryReserve(false))
+            CreateReserved(false);
+      }
+
+      /// <summary>
+      /// Rents a backup components object that has been initialized for backup, and starts creating a replacement in the background.
+      /// </summary>
+      /// <returns>
+      ///   A backup components object on which <see cref="IVssBackupComponents.InitializeForBackup"/> has been called with 
+      ///   <see langword="null"/>. The caller owns the object, and must dispose it.
+      /// </returns>
+      /// <remarks>
+      ///   If the pool is empty, the object is created on the calling thread. The replacement is not created while the pool is 
+      ///   stopped by a failure, in which case the object created on the calling thread restarts it.
+      /// </remarks>
+      /// <exception cref="ObjectDisposedException">The pool has been disposed.</exception>
+      public IVssBackupComponents Rent()
+      {
+         IVssBackupComponents backupComponents = null;
+         lock (m_lock)
+         {
+            ThrowIfDisposed();
+            if (m_idle.Count > 0)
+               backupComponents = m_idle.Dequeue();
+         }
+
+         Replenish();
+         if (backupComponents != null)
+            return backupComponents;
+
+         backupComponents = Create(false);
+         Replenish();
+         return backupComponents;
+      }
+
+      /// <summary>
+      /// Disposes the objects in the pool. Objects being created in the background are disposed as soon as they are ready.
+      /// </summary>
+      public void Dispose()
+      {
+         IVssBackupComponents[] idle;
+         lock (m_lock)
+         {
+            if (m_disposed)
+               return;
+
+            m_disposed = true;
+            idle = m_idle.ToArray();
+            m_idle.Clear();
+         }
+
+         foreach (IVssBackupComponents backupComponents in idle)
+            backupComponents.Dispose();
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private void Replenish()
+      {
+         while (TryReserve(true))
+         {
+            Task.Run(() =>
+            {
+               try
+               {
+                  CreateReserved(true);
+               }
+               catch (Exception)
+               {
+                  // Reported through VssEventSource by Create, which also stops the pool; Rent creates objects on the calling 
+                  // thread while the pool is empty.
+               }
+            });
+         }
+      }
+
+      // Reserves a slot for an object to be created, unless the pool is full counting the objects already being created, 
+      // or has been disposed. Objects are not created in the background while the pool is stopped by a failure.
+      private bool TryReserve(bool background)
+      {
+         lock (m_lock)
+         {
+            if (m_disposed || (background && m_faulted) || m_idle.Count + m_pending >= Capacity)
+               return false;
+
+            m_pending++;
+            return true;
+         }
+      }
+
+      private void CreateReserved(bool background)
+      {
+         IVssBackupComponents backupComponents = null;
+         try
+         {
+            backupComponents = Create(background);
+         }
+         finally
+         {
+            bool disposed;
+            lock (m_lock)
+            {
+               m_pending--;
+               disposed = m_disposed;
+               if (backupComponents != null && !disposed)
+                  m_idle.Enqueue(backupComponents);
+            }
+
+            if (backupComponents != null && disposed)
+               backupComponents.Dispose();
+         }
+      }
+
+      // A failure stops the creation of objects in the background, which only an object created on the calling thread restarts.
+      private IVssBackupComponents Create(bool background)
+      {
+         Stopwatch stopwatch = Stopwatch.StartNew();
+         bool reportPhase = VssEventSource.Log.IsEnabled(EventLevel.Informational, VssEventSource.Keywords.Phases);
+         if (reportPhase)
+            VssEventSource.Log.PhaseStarted(CreatePhase);
+
+         int hresult = 0;
+         IVssBackupComponents backupComponents = null;
+         try
+         {
+            backupComponents = m_factory.CreateVssBackupComponents();
+            backupComponents.InitializeForBackup(null);
+            if (!background)
+            {
+               lock (m_lock)
+                  m_faulted = false;
+            }
+
+            return backupComponents;
+         }
+         catch (Exception ex)
+         {
+            hresult = ex.HResult;
+            lock (m_lock)
+               m_faulted = true;
+
+            if (backupComponents != null)
+               backupComponents.Dispose();
+
+            throw;
+         }
+         finally
+         {
+            if (reportPhase)
+               VssEventSource.Log.PhaseCompleted(CreatePhase, hresult, stopwatch.Elapsed.TotalMilliseconds);
+         }
+      }
+
+      private void ThrowIfDisposed()
+      {
+         if (m_disposed)
+            throw new ObjectDisposedException(GetType().FullName);
+      }
+
+      #endregion
+   }
+}
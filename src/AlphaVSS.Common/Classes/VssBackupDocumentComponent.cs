@@ -0,0 +1,81 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A component of a saved Backup Components Document, as read by <see cref="VssBackupDocumentReader"/>.
+   /// </summary>
+   [Serializable]
+   public sealed class VssBackupDocumentComponent
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssBackupDocumentComponent"/> class.
+      /// </summary>
+      /// <param name="key">The key identifying the component and its writer instance.</param>
+      /// <param name="componentType">The type of the component.</param>
+      /// <param name="backupSucceeded"><see langword="true"/> if the backup of the component succeeded.</param>
+      /// <param name="backupStamp">The backup stamp of the component, or <see langword="null"/>.</param>
+      /// <param name="previousBackupStamp">The backup stamp of the backup this backup is based on, or <see langword="null"/>.</param>
+      /// <param name="backupOptions">The backup options of the component, or <see langword="null"/>.</param>
+      /// <param name="partialFiles">The partial files of the component.</param>
+      /// <param name="differencedFiles">The differenced files of the component.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="key"/>, <paramref name="partialFiles"/> or <paramref name="differencedFiles"/> is <see langword="null"/>.</exception>
+      public VssBackupDocumentComponent(VssComponentKey key, VssComponentType componentType, bool backupSucceeded, string backupStamp, string previousBackupStamp,
+         string backupOptions, IEnumerable<VssPartialFileInfo> partialFiles, IEnumerable<VssDifferencedFileInfo> differencedFiles)
+      {
+         if (key == null)
+            throw new ArgumentNullException(nameof(key));
+
+         Key = key;
+         ComponentType = componentType;
+         BackupSucceeded = backupSucceeded;
+         BackupStamp = backupStamp;
+         PreviousBackupStamp = previousBackupStamp;
+         BackupOptions = backupOptions;
+         PartialFiles = VssCapturedComponent.ToReadOnly(partialFiles, nameof(partialFiles));
+         DifferencedFiles = VssCapturedComponent.ToReadOnly(differencedFiles, nameof(differencedFiles));
+      }
+
+      /// <summary>
+      /// Gets the key identifying the component and its writer instance.
+      /// </summary>
+      public VssComponentKey Key { get; private set; }
+
+      /// <summary>
+      /// Gets the type of the component.
+      /// </summary>
+      public VssComponentType ComponentType { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the backup of the component succeeded.
+      /// </summary>
+      public bool BackupSucceeded { get; private set; }
+
+      /// <summary>
+      /// Gets the backup stamp of the component, or <see langword="null"/> if the writer did not set one.
+      /// </summary>
+      public string BackupStamp { get; private set; }
+
+      /// <summary>
+      /// Gets the backup stamp of the backup this backup is based on, or <see langword="null"/> if the requester did not set one.
+      /// </summary>
+      public string PreviousBackupStamp { get; private set; }
+
+      /// <summary>
+      /// Gets the backup options of the component, or <see langword="null"/> if the requester did not set any.
+      /// </summary>
+      public string BackupOptions { get; private set; }
+
+      /// <summary>
+      /// Gets the partial files of the component.
+      /// </summary>
+      public IList<VssPartialFileInfo> PartialFiles { get; private set; }
+
+      /// <summary>
+      /// Gets the differenced files of the component.
+      /// </summary>
+      public IList<VssDifferencedFileInfo> DifferencedFiles { get; private set; }
+   }
+}
@@ -0,0 +1,47 @@
+
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A component present in both of two saved Backup Components Documents compared by <see cref="VssBackupDocumentDiff"/>.
+   /// </summary>
+   [Serializable]
+   public sealed class VssBackupDocumentComponentChange
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssBackupDocumentComponentChange"/> class.
+      /// </summary>
+      /// <param name="previous">The component in the previous document.</param>
+      /// <param name="current">The component in the current document.</param>
+      /// <param name="changes">The properties of the component that differ between the documents.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="previous"/> or <paramref name="current"/> is <see langword="null"/>.</exception>
+      public VssBackupDocumentComponentChange(VssBackupDocumentComponent previous, VssBackupDocumentComponent current, VssBackupDocumentChanges changes)
+      {
+         if (previous == null)
+            throw new ArgumentNullException(nameof(previous));
+
+         if (current == null)
+            throw new ArgumentNullException(nameof(current));
+
+         Previous = previous;
+         Current = current;
+         Changes = changes;
+      }
+
+      /// <summary>
+      /// Gets the component in the previous document.
+      /// </summary>
+      public VssBackupDocumentComponent Previous { get; private set; }
+
+      /// <summary>
+      /// Gets the component in the current document.
+      /// </summary>
+      public VssBackupDocumentComponent Current { get; private set; }
+
+      /// <summary>
+      /// Gets the properties of the component that differ between the documents, or <see cref="VssBackupDocumentChanges.None"/> if it is unchanged.
+      /// </summary>
+      public VssBackupDocumentChanges Changes { get; private set; }
+   }
+}
@@ -0,0 +1,323 @@
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// The structural differences between two saved Backup Components Documents, usually the document of the last backup and 
+   /// that of the current backup session.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///     Components are matched by writer class id, logical path and component name, the identification used by 
+   ///     <see cref="IVssBackupComponents.SetPreviousBackupStamp"/>; writer instance ids are not stable across writer restarts. 
+   ///     Should a document contain the same component for several instances of a writer class, the instances are matched in 
+   ///     document order.
+   ///   </para>
+   ///   <para>
+   ///     The documents are read with <see cref="VssBackupDocumentReader"/>, without instantiating VSS. Comparing takes time linear 
+   ///     in the size of the documents; only the components of the previous document are held in memory while the current 
+   ///     document is streamed.
+   ///   </para>
+   /// </remarks>
+   [Serializable]
+   public sealed class VssBackupDocumentDiff
+   {
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssBackupDocumentDiff"/> class.
+      /// </summary>
+      /// <param name="added">The components of the current document that are not in the previous document.</param>
+      /// <param name="removed">The components of the previous document that are not in the current document.</param>
+      /// <param name="matched">The components present in both documents, changed or not.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="added"/>, <paramref name="removed"/> or <paramref name="matched"/> is <see langword="null"/>.</exception>
+      public VssBackupDocumentDiff(IEnumerable<VssBackupDocumentComponent> added, IEnumerable<VssBackupDocumentComponent> removed, IEnumerable<VssBackupDocumentComponentChange> matched)
+      {
+         Added = VssCapturedComponent.ToReadOnly(added, nameof(added));
+         Removed = VssCapturedComponent.ToReadOnly(removed, nameof(removed));
+         Matched = VssCapturedComponent.ToReadOnly(matched, nameof(matched));
+         Changed = VssCapturedComponent.ToReadOnly(Matched.Where(change => change.Changes != VssBackupDocumentChanges.None), nameof(matched));
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the components of the current document that are not in the previous document, in document order.
+      /// </summary>
+      public IList<VssBackupDocumentComponent> Added { get; private set; }
+
+      /// <summary>
+      /// Gets the components of the previous document that are not in the current document, in document order.
+      /// </summary>
+      public IList<VssBackupDocumentComponent> Removed { get; private set; }
+
+      /// <summary>
+      /// Gets the components present in both documents, changed or not, in the order of the current document.
+      /// </summary>
+      public IList<VssBackupDocumentComponentChange> Matched { get; private set; }
+
+      /// <summary>
+      /// Gets the components present in both documents that differ between them, in the order of the current document.
+      /// </summary>
+      public IList<VssBackupDocumentComponentChange> Changed { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the documents contain the same components with the same properties.
+      /// </summary>
+      public bool IsEmpty
+      {
+         get
+         {
+            return Added.Count == 0 && Removed.Count == 0 && Changed.Count == 0;
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Compares two saved Backup Components Documents.
+      /// </summary>
+      /// <param name="previous">The stream containing the previous document. The stream is not closed.</param>
+      /// <param name="current">The stream containing the current document. The stream is not closed.</param>
+      /// <returns>The differences between the documents.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="previous"/> or <paramref name="current"/> is <see langword="null"/>.</exception>
+      /// <exception cref="VssInvalidXmlDocumentException">A stream does not contain a valid Backup Components Document.</exception>
+      public static VssBackupDocumentDiff Compare(Stream previous, Stream current)
+      {
+         if (previous == null)
+            throw new ArgumentNullException(nameof(previous));
+
+         if (current == null)
+            throw new ArgumentNullException(nameof(current));
+
+         using (VssBackupDocumentReader previousReader = new VssBackupDocumentReader(previous))
+         using (VssBackupDocumentReader currentReader = new VssBackupDocumentReader(current))
+         {
+            return Compare(previousReader, currentReader);
+         }
+      }
+
+      /// <summary>
+      /// Compares two saved Backup Components Documents, for instance the results of <see cref="IVssBackupComponents.SaveAsXml"/> 
+      /// wrapped in a <see cref="StringReader"/>.
+      /// </summary>
+      /// <param name="previous">The text reader providing the previous document. The reader is not closed.</param>
+      /// <param name="current">The text reader providing the current document. The reader is not closed.</param>
+      /// <returns>The differences between the documents.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="previous"/> or <paramref name="current"/> is <see langword="null"/>.</exception>
+      /// <exception cref="VssInvalidXmlDocumentException">A text reader does not provide a valid Backup Components Document.</exception>
+      public static VssBackupDocumentDiff Compare(TextReader previous, TextReader current)
+      {
+         if (previous == null)
+            throw new ArgumentNullException(nameof(previous));
+
+         if (current == null)
+            throw new ArgumentNullException(nameof(current));
+
+         using (VssBackupDocumentReader previousReader = new VssBackupDocumentReader(previous))
+         using (VssBackupDocumentReader currentReader = new VssBackupDocumentReader(current))
+         {
+            return Compare(previousReader, currentReader);
+         }
+      }
+
+      /// <summary>
+      /// Compares the remaining components of two saved Backup Components Documents.
+      /// </summary>
+      /// <param name="previous">The reader of the previous document.</param>
+      /// <param name="current">The reader of the current document.</param>
+      /// <returns>The differences between the documents.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="previous"/> or <paramref name="current"/> is <see langword="null"/>.</exception>
+      /// <exception cref="VssInvalidXmlDocumentException">A document is not well-formed.</exception>
+      public static VssBackupDocumentDiff Compare(VssBackupDocumentReader previous, VssBackupDocumentReader current)
+      {
+         if (previous == null)
+            throw new ArgumentNullException(nameof(previous));
+
+         if (current == null)
+            throw new ArgumentNullException(nameof(current));
+
+         // The previous components by writer class and full path, in document order; matched components are dequeued.
+         List<VssBackupDocumentComponent> previousComponents = previous.ReadComponents().ToList();
+         bool[] matchedPrevious = new bool[previousComponents.Count];
+         Dictionary<string, Queue<int>> byComponent = new Dictionary<string, Queue<int>>(StringComparer.OrdinalIgnoreCase);
+         for (int i = 0; i < previousComponents.Count; i++)
+         {
+            string key = GetComponentKey(previousComponents[i].Key);
+            Queue<int> indices;
+            if (!byComponent.TryGetValue(key, out indices))
+            {
+               indices = new Queue<int>(1);
+               byComponent.Add(key, indices);
+            }
+
+            indices.Enqueue(i);
+         }
+
+         List<VssBackupDocumentComponent> added = new List<VssBackupDocumentComponent>();
+         List<VssBackupDocumentComponentChange> matched = new List<VssBackupDocumentComponentChange>();
+         while (current.Read())
+         {
+            VssBackupDocumentComponent component = current.Current;
+            Queue<int> indices;
+            if (!byComponent.TryGetValue(GetComponentKey(component.Key), out indices) || indices.Count == 0)
+            {
+               added.Add(component);
+               continue;
+            }
+
+            int index = indices.Dequeue();
+            matchedPrevious[index] = true;
+            matched.Add(new VssBackupDocumentComponentChange(previousComponents[index], component, GetChanges(previousComponents[index], component)));
+         }
+
+         return new VssBackupDocumentDiff(added, previousComponents.Where((component, i) => !matchedPrevious[i]), matched);
+      }
+
+      /// <summary>
+      /// Creates the selections to add the components of the current document to a new backup session that is based on the 
+      /// previous backup, for use with <see cref="VssBackupComponentsExtensions.AddComponents"/>.
+      /// </summary>
+      /// <returns>
+      ///   The added and matched components of the current document, in the order of the current document, with the backup 
+      ///   options of the current document. The previous backup stamp of a matched component is the backup stamp of the 
+      ///   previous document, if that backup succeeded.
+      /// </returns>
+      public IList<VssComponentSelection> CreateSelections()
+      {
+         Dictionary<VssBackupDocumentComponent, string> previousStamps = Matched.ToDictionary(change => change.Current, GetPreviousBackupStamp);
+         List<VssComponentSelection> selections = new List<VssComponentSelection>(Added.Count + Matched.Count);
+         foreach (VssBackupDocumentComponent component in Added.Concat(Matched.Select(change => change.Current)))
+         {
+            string previousBackupStamp;
+            previousStamps.TryGetValue(component, out previousBackupStamp);
+            selections.Add(new VssComponentSelection(component.Key.InstanceId, component.Key.WriterId, component.ComponentType, component.Key.LogicalPath,
+               component.Key.ComponentName, component.BackupOptions, previousBackupStamp));
+         }
+
+         return selections.AsReadOnly();
+      }
+
+      /// <summary>
+      /// Sets the previous backup stamp of each matched component in a backup session to the backup stamp of the previous document.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object of the session. The components must already have been added.</param>
+      /// <returns>The number of components whose previous backup stamp was set.</returns>
+      /// <remarks>
+      ///   Components whose previous backup did not succeed, or that have no backup stamp in the previous document, are skipped; 
+      ///   they need a full backup.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      public int ApplyPreviousBackupStamps(IVssBackupComponents backupComponents)
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException(nameof(backupComponents));
+
+         int count = 0;
+         foreach (VssBackupDocumentComponentChange change in Matched)
+         {
+            string previousBackupStamp = GetPreviousBackupStamp(change);
+            if (previousBackupStamp == null)
+               continue;
+
+            VssBackupDocumentComponent component = change.Current;
+            backupComponents.SetPreviousBackupStamp(component.Key.WriterId, component.ComponentType, component.Key.LogicalPath, component.Key.ComponentName, previousBackupStamp);
+            count++;
+         }
+
+         return count;
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private static string GetComponentKey(VssComponentKey key)
+      {
+         return key.WriterId.ToString("N") + "\\" + key.FullPath;
+      }
+
+      private static string GetPreviousBackupStamp(VssBackupDocumentComponentChange change)
+      {
+         return change.Previous.BackupSucceeded && !String.IsNullOrEmpty(change.Previous.BackupStamp) ? change.Previous.BackupStamp : null;
+      }
+
+      private static VssBackupDocumentChanges GetChanges(VssBackupDocumentComponent previous, VssBackupDocumentComponent current)
+      {
+         VssBackupDocumentChanges changes = VssBackupDocumentChanges.None;
+         if (previous.ComponentType != current.ComponentType)
+            changes |= VssBackupDocumentChanges.ComponentType;
+
+         if (previous.BackupSucceeded != current.BackupSucceeded)
+            changes |= VssBackupDocumentChanges.BackupSucceeded;
+
+         if (!String.Equals(previous.BackupStamp, current.BackupStamp, StringComparison.Ordinal))
+            changes |= VssBackupDocumentChanges.BackupStamp;
+
+         if (!String.Equals(previous.PreviousBackupStamp, current.PreviousBackupStamp, StringComparison.Ordinal))
+            changes |= VssBackupDocumentChanges.PreviousBackupStamp;
+
+         if (!String.Equals(previous.BackupOptions, current.BackupOptions, StringComparison.Ordinal))
+            changes |= VssBackupDocumentChanges.BackupOptions;
+
+         changes |= ComparePartialFiles(previous.PartialFiles, current.PartialFiles);
+
+         if (!previous.DifferencedFiles.SequenceEqual(current.DifferencedFiles, DifferencedFileComparer.Instance))
+            changes |= VssBackupDocumentChanges.DifferencedFiles;
+
+         return changes;
+      }
+
+      private static VssBackupDocumentChanges ComparePartialFiles(IList<VssPartialFileInfo> previous, IList<VssPartialFileInfo> current)
+      {
+         if (previous.Count != current.Count)
+            return VssBackupDocumentChanges.PartialFiles;
+
+         VssBackupDocumentChanges changes = VssBackupDocumentChanges.None;
+         for (int i = 0; i < previous.Count; i++)
+         {
+            if (!String.Equals(previous[i].Path, current[i].Path, StringComparison.OrdinalIgnoreCase)
+               || !String.Equals(previous[i].FileName, current[i].FileName, StringComparison.OrdinalIgnoreCase))
+               return VssBackupDocumentChanges.PartialFiles;
+
+            if (!String.Equals(previous[i].Range, current[i].Range, StringComparison.Ordinal)
+               || !String.Equals(previous[i].Metadata, current[i].Metadata, StringComparison.Ordinal))
+               changes = VssBackupDocumentChanges.PartialFileRanges;
+         }
+
+         return changes;
+      }
+
+      #endregion
+
+      #region Nested Types
+
+      private sealed class DifferencedFileComparer : IEqualityComparer<VssDifferencedFileInfo>
+      {
+         public static readonly DifferencedFileComparer Instance = new DifferencedFileComparer();
+
+         public bool Equals(VssDifferencedFileInfo x, VssDifferencedFileInfo y)
+         {
+            return String.Equals(x.Path, y.Path, StringComparison.OrdinalIgnoreCase)
+               && String.Equals(x.FileSpecification, y.FileSpecification, StringComparison.OrdinalIgnoreCase)
+               && x.IsRecursive == y.IsRecursive
+               && x.LastModifyTime == y.LastModifyTime;
+         }
+
+         public int GetHashCode(VssDifferencedFileInfo obj)
+         {
+            return StringComparer.OrdinalIgnoreCase.GetHashCode(obj.Path ?? String.Empty);
+         }
+      }
+
+      #endregion
+   }
+}
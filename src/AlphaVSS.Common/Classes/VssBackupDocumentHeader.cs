@@ -0,0 +1,61 @@
+
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// The document-level attributes of a saved Backup Components Document, as read by <see cref="VssBackupDocumentReader"/>.
+   /// </summary>
+   [Serializable]
+   public sealed class VssBackupDocumentHeader
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssBackupDocumentHeader"/> class.
+      /// </summary>
+      /// <param name="version">The schema version of the document, or <see langword="null"/> if not specified.</param>
+      /// <param name="backupType">The type of the backup.</param>
+      /// <param name="snapshotSetId">The id of the snapshot set of the backup, or <see cref="Guid.Empty"/> if not specified.</param>
+      /// <param name="selectComponents"><see langword="true"/> if the backup selected components explicitly.</param>
+      /// <param name="bootableSystemStateBackup"><see langword="true"/> if the backup is a bootable system state backup.</param>
+      /// <param name="partialFileSupport"><see langword="true"/> if the requester supported partial file backups.</param>
+      public VssBackupDocumentHeader(string version, VssBackupType backupType, Guid snapshotSetId, bool selectComponents, bool bootableSystemStateBackup, bool partialFileSupport)
+      {
+         Version = version;
+         BackupType = backupType;
+         SnapshotSetId = snapshotSetId;
+         SelectComponents = selectComponents;
+         BootableSystemStateBackup = bootableSystemStateBackup;
+         PartialFileSupport = partialFileSupport;
+      }
+
+      /// <summary>
+      /// Gets the schema version of the document, or <see langword="null"/> if not specified.
+      /// </summary>
+      public string Version { get; private set; }
+
+      /// <summary>
+      /// Gets the type of the backup.
+      /// </summary>
+      public VssBackupType BackupType { get; private set; }
+
+      /// <summary>
+      /// Gets the id of the snapshot set of the backup, or <see cref="Guid.Empty"/> if not specified.
+      /// </summary>
+      public Guid SnapshotSetId { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the backup selected components explicitly.
+      /// </summary>
+      public bool SelectComponents { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the backup is a bootable system state backup.
+      /// </summary>
+      public bool BootableSystemStateBackup { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the requester supported partial file backups.
+      /// </summary>
+      public bool PartialFileSupport { get; private set; }
+   }
+}
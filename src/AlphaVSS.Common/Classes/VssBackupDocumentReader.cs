@@ -0,0 +1,253 @@
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Xml;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A forward-only reader of the components of a saved Backup Components Document, as returned by 
+   /// <see cref="IVssBackupComponents.SaveAsXml"/>.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///     The reader parses the document directly, without instantiating VSS, and therefore also works on systems where VSS is 
+   ///     not available. It streams the document, so its memory use is bounded by the size of a single component rather than 
+   ///     that of the document. Writer and component metadata blobs are skipped without being materialized.
+   ///   </para>
+   ///   <para>
+   ///     The reader does not close the underlying stream or text reader. Instances are not thread safe.
+   ///   </para>
+   /// </remarks>
+   /// <example>
+   ///   <code>
+   ///   using (FileStream stream = File.OpenRead(path))
+   ///   using (VssBackupDocumentReader reader = new VssBackupDocumentReader(stream))
+   ///   {
+   ///      while (reader.Read())
+   ///         Console.WriteLine("{0} {1}", reader.Current.Key, reader.Current.BackupStamp);
+   ///   }
+   ///   </code>
+   /// </example>
+   public sealed class VssBackupDocumentReader : IDisposable
+   {
+      #region Private Fields
+
+      private const int RootDepth = 0;
+      private const int WriterDepth = 1;
+      private const int ComponentDepth = 2;
+
+      private readonly XmlReader m_reader;
+      private Guid m_instanceId;
+      private Guid m_writerId;
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssBackupDocumentReader"/> class reading from the specified stream.
+      /// </summary>
+      /// <param name="stream">The stream containing the document.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="stream"/> is <see langword="null"/>.</exception>
+      /// <exception cref="VssInvalidXmlDocumentException">The stream does not contain a Backup Components Document.</exception>
+      public VssBackupDocumentReader(Stream stream)
+      {
+         if (stream == null)
+            throw new ArgumentNullException(nameof(stream));
+
+         m_reader = XmlReader.Create(stream, CreateSettings());
+         Header = ReadHeader();
+      }
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssBackupDocumentReader"/> class reading from the specified text reader.
+      /// </summary>
+      /// <param name="reader">The text reader providing the document, for instance a <see cref="StringReader"/> over the result of <see cref="IVssBackupComponents.SaveAsXml"/>.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="reader"/> is <see langword="null"/>.</exception>
+      /// <exception cref="VssInvalidXmlDocumentException">The text reader does not provide a Backup Components Document.</exception>
+      public VssBackupDocumentReader(TextReader reader)
+      {
+         if (reader == null)
+            throw new ArgumentNullException(nameof(reader));
+
+         m_reader = XmlReader.Create(reader, CreateSettings());
+         Header = ReadHeader();
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the document-level attributes of the document.
+      /// </summary>
+      public VssBackupDocumentHeader Header { get; private set; }
+
+      /// <summary>
+      /// Gets the component read by the last successful call to <see cref="Read"/>.
+      /// </summary>
+      /// <value>The current component, or <see langword="null"/> if <see cref="Read"/> has not been called or has returned <see langword="false"/>.</value>
+      public VssBackupDocumentComponent Current { get; private set; }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Advances the reader to the next component of the document.
+      /// </summary>
+      /// <returns><see langword="true"/> if a component was read into <see cref="Current"/>; <see langword="false"/> if there are no more components.</returns>
+      /// <exception cref="VssInvalidXmlDocumentException">The document is not well-formed.</exception>
+      /// <exception cref="ObjectDisposedException">The reader has been disposed.</exception>
+      public bool Read()
+      {
+         try
+         {
+            bool advance = true;
+            while (true)
+            {
+               if (advance)
+               {
+                  if (m_reader.Depth == RootDepth && m_reader.NodeType == XmlNodeType.EndElement || !m_reader.Read())
+                     break;
+               }
+
+               advance = true;
+
+               if (m_reader.NodeType != XmlNodeType.Element)
+                  continue;
+
+               if (m_reader.Depth == WriterDepth && m_reader.LocalName == "WRITER_COMPONENTS")
+               {
+                  m_instanceId = VssXmlConvert.ToGuid(m_reader.GetAttribute("instanceId"));
+                  m_writerId = VssXmlConvert.ToGuid(m_reader.GetAttribute("writerId"));
+               }
+               else if (m_reader.Depth == ComponentDepth && m_reader.LocalName == "COMPONENT")
+               {
+                  Current = ReadComponent();
+                  return true;
+               }
+               else
+               {
+                  // Writer metadata, snapshot descriptions and component metadata blobs; Skip positions the reader on the 
+                  // node following the element.
+                  m_reader.Skip();
+                  advance = false;
+               }
+            }
+         }
+         catch (XmlException ex)
+         {
+            throw new VssInvalidXmlDocumentException(ex.Message, ex);
+         }
+
+         Current = null;
+         return false;
+      }
+
+      /// <summary>
+      /// Reads all remaining components of the document.
+      /// </summary>
+      /// <returns>The remaining components, read lazily as the sequence is enumerated.</returns>
+      /// <exception cref="VssInvalidXmlDocumentException">The document is not well-formed.</exception>
+      public IEnumerable<VssBackupDocumentComponent> ReadComponents()
+      {
+         while (Read())
+            yield return Current;
+      }
+
+      /// <summary>
+      /// Releases the resources used by the reader.
+      /// </summary>
+      public void Dispose()
+      {
+         m_reader.Dispose();
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private static XmlReaderSettings CreateSettings()
+      {
+         return new XmlReaderSettings
+         {
+            CloseInput = false,
+            DtdProcessing = DtdProcessing.Prohibit,
+            IgnoreComments = true,
+            IgnoreProcessingInstructions = true,
+            IgnoreWhitespace = true
+         };
+      }
+
+      private VssBackupDocumentHeader ReadHeader()
+      {
+         try
+         {
+            if (m_reader.MoveToContent() != XmlNodeType.Element || m_reader.LocalName != "BACKUP_COMPONENTS")
+               throw new VssInvalidXmlDocumentException();
+
+            VssBackupType backupType;
+            if (!Enum.TryParse(m_reader.GetAttribute("backupType"), true, out backupType))
+               backupType = VssBackupType.Undefined;
+
+            return new VssBackupDocumentHeader(m_reader.GetAttribute("version"), backupType,
+               VssXmlConvert.ToGuid(m_reader.GetAttribute("snapshotSetId")),
+               VssXmlConvert.ToBoolean(m_reader.GetAttribute("selectComponents")),
+               VssXmlConvert.ToBoolean(m_reader.GetAttribute("bootableSystemStateBackup")),
+               VssXmlConvert.ToBoolean(m_reader.GetAttribute("partialFileSupport")));
+         }
+         catch (XmlException ex)
+         {
+            throw new VssInvalidXmlDocumentException(ex.Message, ex);
+         }
+      }
+
+      private VssBackupDocumentComponent ReadComponent()
+      {
+         VssComponentKey key = new VssComponentKey(m_instanceId, m_writerId, m_reader.GetAttribute("logicalPath"), m_reader.GetAttribute("componentName") ?? String.Empty);
+         VssComponentType componentType = VssXmlConvert.ToComponentType(m_reader.GetAttribute("componentType"));
+         bool backupSucceeded = VssXmlConvert.ToBoolean(m_reader.GetAttribute("backupSucceeded"));
+         string backupStamp = m_reader.GetAttribute("backupStamp");
+         string previousBackupStamp = m_reader.GetAttribute("previousBackupStamp");
+         string backupOptions = m_reader.GetAttribute("backupOptions");
+
+         List<VssPartialFileInfo> partialFiles = new List<VssPartialFileInfo>();
+         List<VssDifferencedFileInfo> differencedFiles = new List<VssDifferencedFileInfo>();
+
+         if (!m_reader.IsEmptyElement)
+         {
+            bool advance = true;
+            while (!advance || m_reader.Read())
+            {
+               advance = true;
+               if (m_reader.Depth == ComponentDepth)
+                  break;
+
+               if (m_reader.NodeType != XmlNodeType.Element)
+                  continue;
+
+               if (m_reader.LocalName == "PARTIAL_FILE")
+               {
+                  partialFiles.Add(new VssPartialFileInfo(m_reader.GetAttribute("path") ?? String.Empty, m_reader.GetAttribute("filespec") ?? String.Empty,
+                     m_reader.GetAttribute("ranges"), m_reader.GetAttribute("metadata")));
+               }
+               else if (m_reader.LocalName == "DIFFERENCED_FILE")
+               {
+                  differencedFiles.Add(new VssDifferencedFileInfo(m_reader.GetAttribute("path"), m_reader.GetAttribute("filespec"),
+                     VssXmlConvert.ToBoolean(m_reader.GetAttribute("recursive")), VssXmlConvert.ToDateTime(m_reader.GetAttribute("lastModifyTime"))));
+               }
+
+               m_reader.Skip();
+               advance = false;
+            }
+         }
+
+         return new VssBackupDocumentComponent(key, componentType, backupSucceeded, backupStamp, previousBackupStamp, backupOptions, partialFiles, differencedFiles);
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,570 @@
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.Compression;
+using System.Text;
+using System.Xml;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A compact binary encoding of the XML documents produced by <see cref="IVssBackupComponents.SaveAsXml"/> and 
+   /// <see cref="IVssExamineWriterMetadata.SaveAsXml"/>, for storing documents in bulk.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///     The encoding replaces the markup of the document with single-byte tokens and stores every element name, attribute 
+   ///     name, attribute value and short text once, in a dictionary built while encoding; repeated writer ids, logical paths, 
+   ///     component names and file paths are then encoded as small indices. The token stream can optionally be compressed 
+   ///     with deflate.
+   ///   </para>
+   ///   <para>
+   ///     Decoding reproduces the original document exactly, character for character. The encoder verifies this by decoding 
+   ///     what it encoded; a document whose exact form cannot be reproduced from its tokens, for instance because it uses 
+   ///     character references where a literal character would do, or is not well-formed, is stored verbatim instead.
+   ///   </para>
+   /// </remarks>
+   public static class VssBinaryXmlEncoding
+   {
+      #region Private Fields
+
+      private static readonly byte[] s_magic = { (byte)'A', (byte)'V', (byte)'X', (byte)'B' };
+      private const byte FormatVersion = 1;
+
+      private const byte CompressedFlag = 0x01;
+      private const byte VerbatimFlag = 0x02;
+      private const byte SpacedEmptyElementsFlag = 0x04;
+
+      // Strings longer than this are encoded in place rather than added to the dictionary; long texts, such as metadata 
+      // blobs, rarely repeat.
+      private const int MaxDictionaryStringLength = 256;
+
+      #endregion
+
+      #region Token Types
+
+      private enum Token : byte
+      {
+         EndOfDocument = 0,
+         StartElement = 1,
+         EndElement = 2,
+         Text = 3,
+         Whitespace = 4,
+         CData = 5,
+         Comment = 6,
+         ProcessingInstruction = 7,
+         XmlDeclaration = 8
+      }
+
+      [Flags]
+      private enum ElementFlags : byte
+      {
+         None = 0,
+         Empty = 0x01,
+         SingleQuotes = 0x02
+      }
+
+      private enum StringReference
+      {
+         Literal = 0,
+         New = 1,
+         FirstIndex = 2
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Encodes the specified XML document.
+      /// </summary>
+      /// <param name="xml">The XML document, as returned by <see cref="IVssBackupComponents.SaveAsXml"/> or <see cref="IVssExamineWriterMetadata.SaveAsXml"/>.</param>
+      /// <param name="compress"><see langword="true"/> to compress the encoded document; otherwise <see langword="false"/>.</param>
+      /// <returns>The encoded document.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="xml"/> is <see langword="null"/>.</exception>
+      public static byte[] Encode(string xml, bool compress)
+      {
+         using (MemoryStream stream = new MemoryStream())
+         {
+            Encode(xml, stream, compress);
+            return stream.ToArray();
+         }
+      }
+
+      /// <summary>
+      /// Encodes the specified XML document to a stream.
+      /// </summary>
+      /// <param name="xml">The XML document, as returned by <see cref="IVssBackupComponents.SaveAsXml"/> or <see cref="IVssExamineWriterMetadata.SaveAsXml"/>.</param>
+      /// <param name="output">The stream to write the encoded document to. The stream is not closed.</param>
+      /// <param name="compress"><see langword="true"/> to compress the encoded document; otherwise <see langword="false"/>.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="xml"/> or <paramref name="output"/> is <see langword="null"/>.</exception>
+      public static void Encode(string xml, Stream output, bool compress)
+      {
+         if (xml == null)
+            throw new ArgumentNullException(nameof(xml));
+
+         if (output == null)
+            throw new ArgumentNullException(nameof(output));
+
+         byte flags = compress ? CompressedFlag : (byte)0;
+         bool spacedEmptyElements;
+         byte[] tokens = Tokenize(xml, out spacedEmptyElements);
+         if (spacedEmptyElements)
+            flags |= SpacedEmptyElementsFlag;
+
+         if (tokens == null)
+         {
+            flags |= VerbatimFlag;
+            using (MemoryStream verbatim = new MemoryStream())
+            {
+               WriteString(verbatim, xml);
+               tokens = verbatim.ToArray();
+            }
+         }
+
+         output.Write(s_magic, 0, s_magic.Length);
+         output.WriteByte(FormatVersion);
+         output.WriteByte(flags);
+
+         if (compress)
+         {
+            using (DeflateStream deflate = new DeflateStream(output, CompressionLevel.Optimal, true))
+            {
+               deflate.Write(tokens, 0, tokens.Length);
+            }
+         }
+         else
+         {
+            output.Write(tokens, 0, tokens.Length);
+         }
+      }
+
+      /// <summary>
+      /// Decodes a document encoded by <see cref="Encode(string, bool)"/>.
+      /// </summary>
+      /// <param name="data">The encoded document.</param>
+      /// <returns>The original XML document.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="data"/> is <see langword="null"/>.</exception>
+      /// <exception cref="InvalidDataException"><paramref name="data"/> is not a valid encoded document.</exception>
+      public static string Decode(byte[] data)
+      {
+         if (data == null)
+            throw new ArgumentNullException(nameof(data));
+
+         using (MemoryStream stream = new MemoryStream(data, false))
+         {
+            return Decode(stream);
+         }
+      }
+
+      /// <summary>
+      /// Decodes a document encoded by <see cref="Encode(string, Stream, bool)"/> from a stream.
+      /// </summary>
+      /// <param name="input">The stream to read the encoded document from. The stream is not closed.</param>
+      /// <returns>The original XML document.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="input"/> is <see langword="null"/>.</exception>
+      /// <exception cref="InvalidDataException">The stream does not contain a valid encoded document.</exception>
+      public static string Decode(Stream input)
+      {
+         if (input == null)
+            throw new ArgumentNullException(nameof(input));
+
+         byte[] header = new byte[s_magic.Length + 2];
+         if (ReadFully(input, header) != header.Length || header[0] != s_magic[0] || header[1] != s_magic[1] || header[2] != s_magic[2] || header[3] != s_magic[3])
+            throw new InvalidDataException("The data is not a binary encoded VSS document.");
+
+         if (header[4] != FormatVersion)
+            throw new InvalidDataException("The binary encoded VSS document has an unsupported format version.");
+
+         byte flags = header[5];
+         if ((flags & CompressedFlag) != 0)
+         {
+            using (DeflateStream deflate = new DeflateStream(input, CompressionMode.Decompress, true))
+            using (BufferedStream buffered = new BufferedStream(deflate))
+            {
+               return Decode(buffered, flags);
+            }
+         }
+
+         return Decode(input, flags);
+      }
+
+      #endregion
+
+      #region Encoding
+
+      private static byte[] Tokenize(string xml, out bool spacedEmptyElements)
+      {
+         spacedEmptyElements = false;
+         using (MemoryStream output = new MemoryStream(xml.Length / 2))
+         {
+            try
+            {
+               WriteTokens(xml, output);
+            }
+            catch (XmlException)
+            {
+               return null;
+            }
+
+            // Verify that the document is reproduced exactly, with empty elements written as <a/> (MSXML) or <a /> 
+            // (System.Xml); it is stored verbatim otherwise.
+            foreach (bool spaced in new[] { false, true })
+            {
+               output.Position = 0;
+               if (String.Equals(ReadTokens(output, spaced), xml, StringComparison.Ordinal))
+               {
+                  spacedEmptyElements = spaced;
+                  return output.ToArray();
+               }
+            }
+
+            return null;
+         }
+      }
+
+      private static void WriteTokens(string xml, Stream output)
+      {
+         Dictionary<string, int> dictionary = new Dictionary<string, int>(StringComparer.Ordinal);
+
+         // XmlTextReader, unlike the readers created by XmlReader.Create, can leave line endings and attribute values 
+         // unnormalized, and reports the quote character of attributes.
+         using (XmlTextReader reader = new XmlTextReader(new StringReader(xml)))
+         {
+            reader.DtdProcessing = DtdProcessing.Prohibit;
+            reader.EntityHandling = EntityHandling.ExpandEntities;
+            reader.Normalization = false;
+            reader.WhitespaceHandling = WhitespaceHandling.All;
+            reader.XmlResolver = null;
+
+            while (reader.Read())
+            {
+               switch (reader.NodeType)
+               {
+                  case XmlNodeType.Element:
+                     WriteElement(reader, output, dictionary);
+                     break;
+
+                  case XmlNodeType.EndElement:
+                     output.WriteByte((byte)Token.EndElement);
+                     break;
+
+                  case XmlNodeType.Text:
+                     WriteToken(output, Token.Text, reader.Value, dictionary);
+                     break;
+
+                  case XmlNodeType.Whitespace:
+                  case XmlNodeType.SignificantWhitespace:
+                     WriteToken(output, Token.Whitespace, reader.Value, dictionary);
+                     break;
+
+                  case XmlNodeType.CDATA:
+                     WriteToken(output, Token.CData, reader.Value, dictionary);
+                     break;
+
+                  case XmlNodeType.Comment:
+                     WriteToken(output, Token.Comment, reader.Value, dictionary);
+                     break;
+
+                  case XmlNodeType.ProcessingInstruction:
+                     output.WriteByte((byte)Token.ProcessingInstruction);
+                     WriteStringReference(output, reader.Name, dictionary);
+                     WriteStringReference(output, reader.Value, dictionary);
+                     break;
+
+                  case XmlNodeType.XmlDeclaration:
+                     WriteToken(output, Token.XmlDeclaration, reader.Value, dictionary);
+                     break;
+
+                  default:
+                     throw new XmlException("Unsupported node type " + reader.NodeType + ".");
+               }
+            }
+         }
+
+         output.WriteByte((byte)Token.EndOfDocument);
+      }
+
+      private static void WriteElement(XmlTextReader reader, Stream output, Dictionary<string, int> dictionary)
+      {
+         ElementFlags flags = reader.IsEmptyElement ? ElementFlags.Empty : ElementFlags.None;
+         string name = reader.Name;
+         int attributeCount = reader.AttributeCount;
+
+         // All attributes of an element are assumed to use the same quote character; if they do not, verification fails 
+         // and the document is stored verbatim.
+         if (attributeCount > 0)
+         {
+            reader.MoveToFirstAttribute();
+            if (reader.QuoteChar == '\'')
+               flags |= ElementFlags.SingleQuotes;
+         }
+
+         output.WriteByte((byte)Token.StartElement);
+         output.WriteByte((byte)flags);
+         WriteStringReference(output, name, dictionary);
+         WriteVarInt(output, attributeCount);
+
+         for (int i = 0; i < attributeCount; i++)
+         {
+            reader.MoveToAttribute(i);
+            WriteStringReference(output, reader.Name, dictionary);
+            WriteStringReference(output, reader.Value, dictionary);
+         }
+
+         reader.MoveToElement();
+      }
+
+      private static void WriteToken(Stream output, Token token, string value, Dictionary<string, int> dictionary)
+      {
+         output.WriteByte((byte)token);
+         WriteStringReference(output, value, dictionary);
+      }
+
+      private static void WriteStringReference(Stream output, string value, Dictionary<string, int> dictionary)
+      {
+         int index;
+         if (dictionary.TryGetValue(value, out index))
+         {
+            WriteVarInt(output, index + (int)StringReference.FirstIndex);
+         }
+         else if (value.Length > MaxDictionaryStringLength)
+         {
+            WriteVarInt(output, (int)StringReference.Literal);
+            WriteString(output, value);
+         }
+         else
+         {
+            dictionary.Add(value, dictionary.Count);
+            WriteVarInt(output, (int)StringReference.New);
+            WriteString(output, value);
+         }
+      }
+
+      private static void WriteString(Stream output, string value)
+      {
+         byte[] bytes = Encoding.UTF8.GetBytes(value);
+         WriteVarInt(output, bytes.Length);
+         output.Write(bytes, 0, bytes.Length);
+      }
+
+      private static void WriteVarInt(Stream output, int value)
+      {
+         uint remaining = (uint)value;
+         while (remaining >= 0x80)
+         {
+            output.WriteByte((byte)(remaining | 0x80));
+            remaining >>= 7;
+         }
+
+         output.WriteByte((byte)remaining);
+      }
+
+      #endregion
+
+      #region Decoding
+
+      private static string Decode(Stream input, byte flags)
+      {
+         try
+         {
+            return (flags & VerbatimFlag) != 0 ? ReadString(input) : ReadTokens(input, (flags & SpacedEmptyElementsFlag) != 0);
+         }
+         catch (EndOfStreamException ex)
+         {
+            throw new InvalidDataException("The binary encoded VSS document is truncated.", ex);
+         }
+      }
+
+      private static string ReadTokens(Stream input, bool spacedEmptyElements)
+      {
+         List<string> dictionary = new List<string>();
+         Stack<string> elements = new Stack<string>();
+         StringBuilder xml = new StringBuilder();
+
+         while (true)
+         {
+            Token token = (Token)ReadByte(input);
+            switch (token)
+            {
+               case Token.EndOfDocument:
+                  if (elements.Count != 0)
+                     throw new InvalidDataException("The binary encoded VSS document is truncated.");
+
+                  return xml.ToString();
+
+               case Token.StartElement:
+                  ReadElement(input, xml, elements, dictionary, spacedEmptyElements);
+                  break;
+
+               case Token.EndElement:
+                  if (elements.Count == 0)
+                     throw new InvalidDataException("The binary encoded VSS document contains an unmatched end element.");
+
+                  xml.Append("</").Append(elements.Pop()).Append('>');
+                  break;
+
+               case Token.Text:
+                  AppendEscaped(xml, ReadStringReference(input, dictionary), '\0');
+                  break;
+
+               case Token.Whitespace:
+                  xml.Append(ReadStringReference(input, dictionary));
+                  break;
+
+               case Token.CData:
+                  xml.Append("<![CDATA[").Append(ReadStringReference(input, dictionary)).Append("]]>");
+                  break;
+
+               case Token.Comment:
+                  xml.Append("<!--").Append(ReadStringReference(input, dictionary)).Append("-->");
+                  break;
+
+               case Token.ProcessingInstruction:
+                  xml.Append("<?").Append(ReadStringReference(input, dictionary));
+                  string value = ReadStringReference(input, dictionary);
+                  if (value.Length > 0)
+                     xml.Append(' ').Append(value);
+
+                  xml.Append("?>");
+                  break;
+
+               case Token.XmlDeclaration:
+                  xml.Append("<?xml ").Append(ReadStringReference(input, dictionary)).Append("?>");
+                  break;
+
+               default:
+                  throw new InvalidDataException("The binary encoded VSS document contains an invalid token.");
+            }
+         }
+      }
+
+      private static void ReadElement(Stream input, StringBuilder xml, Stack<string> elements, List<string> dictionary, bool spacedEmptyElements)
+      {
+         ElementFlags flags = (ElementFlags)ReadByte(input);
+         string name = ReadStringReference(input, dictionary);
+         int attributeCount = ReadVarInt(input);
+         char quote = (flags & ElementFlags.SingleQuotes) != 0 ? '\'' : '"';
+
+         xml.Append('<').Append(name);
+         for (int i = 0; i < attributeCount; i++)
+         {
+            xml.Append(' ').Append(ReadStringReference(input, dictionary)).Append('=').Append(quote);
+            AppendEscaped(xml, ReadStringReference(input, dictionary), quote);
+            xml.Append(quote);
+         }
+
+         if ((flags & ElementFlags.Empty) != 0)
+         {
+            xml.Append(spacedEmptyElements ? " />" : "/>");
+         }
+         else
+         {
+            xml.Append('>');
+            elements.Push(name);
+         }
+      }
+
+      private static void AppendEscaped(StringBuilder xml, string value, char quote)
+      {
+         foreach (char ch in value)
+         {
+            switch (ch)
+            {
+               case '&':
+                  xml.Append("&amp;");
+                  break;
+               case '<':
+                  xml.Append("&lt;");
+                  break;
+               case '>':
+                  xml.Append("&gt;");
+                  break;
+               case '"':
+                  xml.Append(quote == '"' ? "&quot;" : "\"");
+                  break;
+               case '\'':
+                  xml.Append(quote == '\'' ? "&apos;" : "'");
+                  break;
+               default:
+                  xml.Append(ch);
+                  break;
+            }
+         }
+      }
+
+      private static string ReadStringReference(Stream input, List<string> dictionary)
+      {
+         int reference = ReadVarInt(input);
+         if (reference == (int)StringReference.Literal)
+            return ReadString(input);
+
+         if (reference == (int)StringReference.New)
+         {
+            string value = ReadString(input);
+            dictionary.Add(value);
+            return value;
+         }
+
+         int index = reference - (int)StringReference.FirstIndex;
+         if (index >= dictionary.Count)
+            throw new InvalidDataException("The binary encoded VSS document contains an invalid string reference.");
+
+         return dictionary[index];
+      }
+
+      private static string ReadString(Stream input)
+      {
+         int length = ReadVarInt(input);
+         if (input.CanSeek && length > input.Length - input.Position)
+            throw new EndOfStreamException();
+
+         byte[] bytes = new byte[length];
+         if (ReadFully(input, bytes) != length)
+            throw new EndOfStreamException();
+
+         return Encoding.UTF8.GetString(bytes);
+      }
+
+      private static int ReadVarInt(Stream input)
+      {
+         uint result = 0;
+         for (int shift = 0; shift < 35; shift += 7)
+         {
+            byte b = ReadByte(input);
+            result |= (uint)(b & 0x7F) << shift;
+            if ((b & 0x80) == 0)
+            {
+               if (result > Int32.MaxValue)
+                  break;
+
+               return (int)result;
+            }
+         }
+
+         throw new InvalidDataException("The binary encoded VSS document contains an invalid length.");
+      }
+
+      private static byte ReadByte(Stream input)
+      {
+         int b = input.ReadByte();
+         if (b < 0)
+            throw new EndOfStreamException();
+
+         return (byte)b;
+      }
+
+      private static int ReadFully(Stream input, byte[] buffer)
+      {
+         int total = 0;
+         int read;
+         while (total < buffer.Length && (read = input.Read(buffer, total, buffer.Length - total)) > 0)
+            total += read;
+
+         return total;
+      }
+
+      #endregion
+   }
+}
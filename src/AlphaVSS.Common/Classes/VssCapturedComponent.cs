@@ -0,0 +1,167 @@
+
+using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     An immutable copy of the information about a component of a Writer Metadata Document, as captured by 
+   ///     <see cref="VssCapturedWriterMetadata"/>.
+   /// </summary>
+   /// <remarks>
+   ///     Unlike the <see cref="IVssWMComponent"/> instances obtained directly from VSS, a <see cref="VssCapturedComponent"/> 
+   ///     holds no VSS resources and makes no calls to VSS. Instances may safely be shared between threads, and need not be disposed.
+   /// </remarks>
+   [Serializable]
+   public sealed class VssCapturedComponent : IVssWMComponent
+   {
+      #region Private Fields
+
+      private readonly byte[] m_icon;
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      ///     Initializes a new instance of the <see cref="VssCapturedComponent"/> class.
+      /// </summary>
+      /// <param name="type">The component type.</param>
+      /// <param name="logicalPath">The logical path of the component. May be <see langword="null"/>.</param>
+      /// <param name="componentName">The name of the component.</param>
+      /// <param name="caption">The description of the component. May be <see langword="null"/>.</param>
+      /// <param name="icon">The icon of the component. May be <see langword="null"/>. The array is copied.</param>
+      /// <param name="restoreMetadata">Whether the component requires the Writer Metadata Document at restore time.</param>
+      /// <param name="notifyOnBackupComplete">Whether the writer is notified about the success of the backup of the component.</param>
+      /// <param name="selectable">Whether the component is selectable for backup.</param>
+      /// <param name="selectableForRestore">Whether the component is selectable for restore.</param>
+      /// <param name="componentFlags">The features supported by the component.</param>
+      /// <param name="files">The file descriptors of the component's file group.</param>
+      /// <param name="databaseFiles">The file descriptors of the component's database files.</param>
+      /// <param name="databaseLogFiles">The file descriptors of the component's database log files.</param>
+      /// <param name="dependencies">The dependencies of the component.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="componentName"/>, or one of the sequences, is <see langword="null"/>.</exception>
+      public VssCapturedComponent(VssComponentType type, string logicalPath, string componentName, string caption, byte[] icon,
+         bool restoreMetadata, bool notifyOnBackupComplete, bool selectable, bool selectableForRestore, VssComponentFlags componentFlags,
+         IEnumerable<VssWMFileDescriptor> files, IEnumerable<VssWMFileDescriptor> databaseFiles, IEnumerable<VssWMFileDescriptor> databaseLogFiles,
+         IEnumerable<VssWMDependency> dependencies)
+      {
+         if (componentName == null)
+            throw new ArgumentNullException(nameof(componentName));
+
+         Type = type;
+         LogicalPath = logicalPath;
+         ComponentName = componentName;
+         Caption = caption;
+         m_icon = icon == null ? null : (byte[])icon.Clone();
+         RestoreMetadata = restoreMetadata;
+         NotifyOnBackupComplete = notifyOnBackupComplete;
+         Selectable = selectable;
+         SelectableForRestore = selectableForRestore;
+         ComponentFlags = componentFlags;
+         Files = ToReadOnly(files, nameof(files));
+         DatabaseFiles = ToReadOnly(databaseFiles, nameof(databaseFiles));
+         DatabaseLogFiles = ToReadOnly(databaseLogFiles, nameof(databaseLogFiles));
+         Dependencies = ToReadOnly(dependencies, nameof(dependencies));
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      ///     Captures the information of the specified component.
+      /// </summary>
+      /// <param name="component">The component to capture.</param>
+      /// <returns>A <see cref="VssCapturedComponent"/> containing the information of <paramref name="component"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="component"/> is <see langword="null"/>.</exception>
+      public static VssCapturedComponent Capture(IVssWMComponent component)
+      {
+         return Capture(component, new VssStringPool());
+      }
+
+      #endregion
+
+      #region IVssWMComponent Members
+
+      /// <summary>Gets the type of the component.</summary>
+      public VssComponentType Type { get; private set; }
+
+      /// <summary>Gets the logical path of the component.</summary>
+      public string LogicalPath { get; private set; }
+
+      /// <summary>Gets the name of the component.</summary>
+      public string ComponentName { get; private set; }
+
+      /// <summary>Gets the description of the component.</summary>
+      public string Caption { get; private set; }
+
+      /// <summary>
+      ///     Gets a copy of the icon associated with the component.
+      /// </summary>
+      /// <returns>A copy of the icon, or <see langword="null"/> if the component has no icon.</returns>
+      public byte[] GetIcon()
+      {
+         return m_icon == null ? null : (byte[])m_icon.Clone();
+      }
+
+      /// <summary>Gets a value indicating whether there is private metadata associated with the restoration of the component.</summary>
+      public bool RestoreMetadata { get; private set; }
+
+      /// <summary>Gets a value indicating whether the writer expects to be notified that a backup has completed.</summary>
+      public bool NotifyOnBackupComplete { get; private set; }
+
+      /// <summary>Gets a value indicating whether the component can be selected for backup.</summary>
+      public bool Selectable { get; private set; }
+
+      /// <summary>Gets a value indicating whether the component can be selected for restore.</summary>
+      public bool SelectableForRestore { get; private set; }
+
+      /// <summary>Gets the features supported by the component.</summary>
+      public VssComponentFlags ComponentFlags { get; private set; }
+
+      /// <summary>Gets the file descriptors of the files of a file group component.</summary>
+      public IList<VssWMFileDescriptor> Files { get; private set; }
+
+      /// <summary>Gets the file descriptors of the database files of a database component.</summary>
+      public IList<VssWMFileDescriptor> DatabaseFiles { get; private set; }
+
+      /// <summary>Gets the file descriptors of the database log files of a database component.</summary>
+      public IList<VssWMFileDescriptor> DatabaseLogFiles { get; private set; }
+
+      /// <summary>Gets the dependencies of the component on components of other writers.</summary>
+      public IList<VssWMDependency> Dependencies { get; private set; }
+
+      void IDisposable.Dispose()
+      {
+      }
+
+      #endregion
+
+      #region Internal Methods
+
+      internal static VssCapturedComponent Capture(IVssWMComponent component, VssStringPool pool)
+      {
+         if (component == null)
+            throw new ArgumentNullException(nameof(component));
+
+         return new VssCapturedComponent(component.Type, pool.Intern(component.LogicalPath), pool.Intern(component.ComponentName),
+            pool.Intern(component.Caption), component.GetIcon(), component.RestoreMetadata, component.NotifyOnBackupComplete,
+            component.Selectable, component.SelectableForRestore, component.ComponentFlags,
+            component.Files.Select(pool.Intern), component.DatabaseFiles.Select(pool.Intern), component.DatabaseLogFiles.Select(pool.Intern),
+            component.Dependencies.Select(pool.Intern));
+      }
+
+      internal static IList<T> ToReadOnly<T>(IEnumerable<T> items, string paramName)
+      {
+         if (items == null)
+            throw new ArgumentNullException(paramName);
+
+         return new ReadOnlyCollection<T>(items.ToArray());
+      }
+
+      #endregion
+   }
+}
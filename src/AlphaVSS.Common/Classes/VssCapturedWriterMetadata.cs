@@ -0,0 +1,219 @@
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     An immutable copy of the contents of a Writer Metadata Document, including all of its components.
+   /// </summary>
+   /// <remarks>
+   ///     <para>
+   ///         The <see cref="IVssExamineWriterMetadata"/> instances obtained directly from VSS retrieve most of their contents 
+   ///         on demand, through one or more calls to VSS per property, component and file. A <see cref="VssCapturedWriterMetadata"/> 
+   ///         retrieves everything once when it is created, using <see cref="VssBackupComponentsExtensions.CaptureWriterMetadata"/> or 
+   ///         <see cref="Capture(IVssExamineWriterMetadata)"/>, and makes no further calls to VSS. Strings repeated within a 
+   ///         capture, such as paths and logical paths, are stored only once.
+   ///     </para>
+   ///     <para>
+   ///         Instances hold no VSS resources, may safely be shared between threads, and need not be disposed. 
+   ///         <see cref="LoadFromXml"/> is not supported.
+   ///     </para>
+   /// </remarks>
+   [Serializable]
+   public sealed class VssCapturedWriterMetadata : IVssExamineWriterMetadata
+   {
+      #region Private Fields
+
+      private readonly string m_xml;
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      ///     Initializes a new instance of the <see cref="VssCapturedWriterMetadata"/> class.
+      /// </summary>
+      /// <param name="instanceId">The instance id of the writer.</param>
+      /// <param name="writerId">The class id of the writer.</param>
+      /// <param name="writerName">The name of the writer.</param>
+      /// <param name="instanceName">The name of the writer instance. May be <see langword="null"/>.</param>
+      /// <param name="usage">The usage type of the writer.</param>
+      /// <param name="source">The type of data managed by the writer.</param>
+      /// <param name="backupSchema">The backup schema supported by the writer.</param>
+      /// <param name="version">The version of the writer, or <see langword="null"/> if it is not available.</param>
+      /// <param name="restoreMethod">The restore method of the writer, or <see langword="null"/> if none is specified.</param>
+      /// <param name="alternateLocationMappings">The alternate location mappings of the writer.</param>
+      /// <param name="excludeFiles">The file descriptors of the files excluded from backup.</param>
+      /// <param name="excludeFromSnapshotFiles">The file descriptors of the files excluded from the snapshots.</param>
+      /// <param name="components">The components of the writer.</param>
+      /// <param name="xml">The Writer Metadata Document, or <see langword="null"/> if it is not available.</param>
+      /// <exception cref="ArgumentNullException">One of the sequences is <see langword="null"/>.</exception>
+      public VssCapturedWriterMetadata(Guid instanceId, Guid writerId, string writerName, string instanceName, VssUsageType usage,
+         VssSourceType source, VssBackupSchema backupSchema, Version version, VssWMRestoreMethod restoreMethod,
+         IEnumerable<VssWMFileDescriptor> alternateLocationMappings, IEnumerable<VssWMFileDescriptor> excludeFiles,
+         IEnumerable<VssWMFileDescriptor> excludeFromSnapshotFiles, IEnumerable<VssCapturedComponent> components, string xml)
+      {
+         InstanceId = instanceId;
+         WriterId = writerId;
+         WriterName = writerName;
+         InstanceName = instanceName;
+         Usage = usage;
+         Source = source;
+         BackupSchema = backupSchema;
+         Version = version;
+         RestoreMethod = restoreMethod;
+         AlternateLocationMappings = VssCapturedComponent.ToReadOnly(alternateLocationMappings, nameof(alternateLocationMappings));
+         ExcludeFiles = VssCapturedComponent.ToReadOnly(excludeFiles, nameof(excludeFiles));
+         ExcludeFromSnapshotFiles = VssCapturedComponent.ToReadOnly(excludeFromSnapshotFiles, nameof(excludeFromSnapshotFiles));
+         Components = VssCapturedComponent.ToReadOnly<IVssWMComponent>(components, nameof(components));
+         m_xml = xml;
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      ///     Captures the complete contents of the specified Writer Metadata Document.
+      /// </summary>
+      /// <param name="metadata">The writer metadata to capture.</param>
+      /// <returns>A <see cref="VssCapturedWriterMetadata"/> containing the contents of <paramref name="metadata"/>.</returns>
+      /// <remarks>
+      ///     If <paramref name="metadata"/> is a <see cref="VssCapturedWriterMetadata"/>, it is returned as is. Properties that 
+      ///     are not supported by the operating system, such as <see cref="IVssExamineWriterMetadata.Version"/>, are captured 
+      ///     as <see langword="null"/> or as empty lists.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="metadata"/> is <see langword="null"/>.</exception>
+      public static VssCapturedWriterMetadata Capture(IVssExamineWriterMetadata metadata)
+      {
+         if (metadata == null)
+            throw new ArgumentNullException(nameof(metadata));
+
+         return Capture(metadata, new VssStringPool());
+      }
+
+      /// <summary>
+      ///     Captures the complete contents of the specified Writer Metadata Documents, sharing repeated strings between them.
+      /// </summary>
+      /// <param name="metadata">The writer metadata to capture.</param>
+      /// <returns>A read-only list containing the captured writer metadata, in the order of <paramref name="metadata"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="metadata"/> is <see langword="null"/>.</exception>
+      public static IList<VssCapturedWriterMetadata> Capture(IEnumerable<IVssExamineWriterMetadata> metadata)
+      {
+         if (metadata == null)
+            throw new ArgumentNullException(nameof(metadata));
+
+         VssStringPool pool = new VssStringPool();
+         return metadata.Select(item => Capture(item, pool)).ToList().AsReadOnly();
+      }
+
+      #endregion
+
+      #region IVssExamineWriterMetadata Members
+
+      /// <summary>Gets the instance id of the writer.</summary>
+      public Guid InstanceId { get; private set; }
+
+      /// <summary>Gets the class id of the writer.</summary>
+      public Guid WriterId { get; private set; }
+
+      /// <summary>Gets the name of the writer.</summary>
+      public string WriterName { get; private set; }
+
+      /// <summary>Gets the name of the writer instance.</summary>
+      public string InstanceName { get; private set; }
+
+      /// <summary>Gets the usage type of the writer.</summary>
+      public VssUsageType Usage { get; private set; }
+
+      /// <summary>Gets the type of data managed by the writer.</summary>
+      public VssSourceType Source { get; private set; }
+
+      /// <summary>Gets the backup schema supported by the writer.</summary>
+      public VssBackupSchema BackupSchema { get; private set; }
+
+      /// <summary>Gets the version of the writer, or <see langword="null"/> if it was not available.</summary>
+      public Version Version { get; private set; }
+
+      /// <summary>Gets the restore method of the writer, or <see langword="null"/> if none is specified.</summary>
+      public VssWMRestoreMethod RestoreMethod { get; private set; }
+
+      /// <summary>Gets the alternate location mappings of the writer.</summary>
+      public IList<VssWMFileDescriptor> AlternateLocationMappings { get; private set; }
+
+      /// <summary>Gets the file descriptors of the files excluded from backup.</summary>
+      public IList<VssWMFileDescriptor> ExcludeFiles { get; private set; }
+
+      /// <summary>Gets the file descriptors of the files excluded from the snapshots.</summary>
+      public IList<VssWMFileDescriptor> ExcludeFromSnapshotFiles { get; private set; }
+
+      /// <summary>Gets the components of the writer. Every element is a <see cref="VssCapturedComponent"/>.</summary>
+      public IList<IVssWMComponent> Components { get; private set; }
+
+      /// <summary>
+      ///     Not supported; captured writer metadata is immutable.
+      /// </summary>
+      /// <param name="xml">Not used.</param>
+      /// <returns>Does not return.</returns>
+      /// <exception cref="NotSupportedException">Always thrown.</exception>
+      public bool LoadFromXml(string xml)
+      {
+         throw new NotSupportedException("Captured writer metadata cannot be modified.");
+      }
+
+      /// <summary>
+      ///     Gets the Writer Metadata Document the metadata was captured from.
+      /// </summary>
+      /// <returns>The Writer Metadata Document, as an XML string.</returns>
+      /// <exception cref="NotSupportedException">The document was not captured.</exception>
+      public string SaveAsXml()
+      {
+         if (m_xml == null)
+            throw new NotSupportedException("The Writer Metadata Document was not captured.");
+
+         return m_xml;
+      }
+
+      void IDisposable.Dispose()
+      {
+      }
+
+      #endregion
+
+      #region Internal Methods
+
+      private static VssCapturedWriterMetadata Capture(IVssExamineWriterMetadata metadata, VssStringPool pool)
+      {
+         VssCapturedWriterMetadata captured = metadata as VssCapturedWriterMetadata;
+         if (captured != null)
+            return captured;
+
+         return Capture(metadata, pool, metadata.SaveAsXml());
+      }
+
+      internal static VssCapturedWriterMetadata Capture(IVssExamineWriterMetadata metadata, VssStringPool pool, string xml)
+      {
+
+         Version version = null;
+         IList<VssWMFileDescriptor> excludeFromSnapshotFiles = null;
+         try
+         {
+            version = metadata.Version;
+            excludeFromSnapshotFiles = metadata.ExcludeFromSnapshotFiles;
+         }
+         catch (UnsupportedOperatingSystemException)
+         {
+         }
+
+         return new VssCapturedWriterMetadata(metadata.InstanceId, metadata.WriterId, pool.Intern(metadata.WriterName),
+            pool.Intern(metadata.InstanceName), metadata.Usage, metadata.Source, metadata.BackupSchema, version, metadata.RestoreMethod,
+            metadata.AlternateLocationMappings.Select(pool.Intern), metadata.ExcludeFiles.Select(pool.Intern),
+            (excludeFromSnapshotFiles ?? new VssWMFileDescriptor[0]).Select(pool.Intern),
+            metadata.Components.Select(component => VssCapturedComponent.Capture(component, pool)), xml);
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,98 @@
+
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// The blocks of a file that changed since the previous run, as computed by <see cref="VssChangedBlockTracker"/>.
+   /// </summary>
+   public sealed class VssChangedBlockResult
+   {
+      internal VssChangedBlockResult(string originalVolumeName, string path, long length, int blockSize, ulong[] hashes, long previousLength, int changedBlockCount, VssFileRangeList changedRanges)
+      {
+         OriginalVolumeName = originalVolumeName;
+         Path = path;
+         Length = length;
+         BlockSize = blockSize;
+         Hashes = hashes;
+         PreviousLength = previousLength;
+         ChangedBlockCount = changedBlockCount;
+         ChangedRanges = changedRanges;
+      }
+
+      /// <summary>
+      /// Gets the name of the original volume of the file.
+      /// </summary>
+      public string OriginalVolumeName { get; private set; }
+
+      /// <summary>
+      /// Gets the path of the file, relative to the root of the volume.
+      /// </summary>
+      public string Path { get; private set; }
+
+      /// <summary>
+      /// Gets the current length of the file, in bytes.
+      /// </summary>
+      public long Length { get; private set; }
+
+      /// <summary>
+      /// Gets the size of the blocks the file was divided into, in bytes.
+      /// </summary>
+      public int BlockSize { get; private set; }
+
+      /// <summary>
+      /// Gets the number of blocks in the file.
+      /// </summary>
+      public int BlockCount
+      {
+         get
+         {
+            return Hashes.Length;
+         }
+      }
+
+      /// <summary>
+      /// Gets the number of blocks that changed since the previous run.
+      /// </summary>
+      public int ChangedBlockCount { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the file was compared with the block hashes of a previous run. If <see langword="false"/>, 
+      /// there was no usable previous run, and the whole file is reported as changed.
+      /// </summary>
+      public bool HasBaseline
+      {
+         get
+         {
+            return PreviousLength >= 0;
+         }
+      }
+
+      /// <summary>
+      /// Gets the length of the file recorded by the previous run, in bytes, or -1 if <see cref="HasBaseline"/> is <see langword="false"/>.
+      /// </summary>
+      public long PreviousLength { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the file is shorter than it was in the previous run.
+      /// </summary>
+      /// <remarks>
+      ///   The extents past the current end of a truncated file are not part of <see cref="ChangedRanges"/>, which only describes 
+      ///   the current contents; a copy of the previous version of the file must be truncated to <see cref="Length"/>.
+      /// </remarks>
+      public bool WasTruncated
+      {
+         get
+         {
+            return HasBaseline && Length < PreviousLength;
+         }
+      }
+
+      /// <summary>
+      /// Gets the extents of the file that changed since the previous run. Adjacent changed blocks are merged into a single extent.
+      /// </summary>
+      public VssFileRangeList ChangedRanges { get; private set; }
+
+      internal ulong[] Hashes { get; private set; }
+   }
+}
@@ -0,0 +1,438 @@
+
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Tracks the blocks of files that changed between consecutive snapshots of a volume, using block hashes persisted 
+   /// between runs.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///     Every file is divided into blocks of <see cref="BlockSize"/> bytes, and each block is hashed with a 64-bit 
+   ///     non-cryptographic hash (xxHash64). <see cref="ComputeChangesAsync(string, string, Stream, CancellationToken)"/> compares 
+   ///     the hashes of the current contents of a file, typically read from the latest snapshot, with the hashes stored by the 
+   ///     previous run, and reports the extents of the blocks that differ, along with the previous length of the file, which 
+   ///     reveals truncation. Once the changed extents have been backed up, <see cref="Commit"/> stores the new hashes as the 
+   ///     baseline of the next run; a backup that fails should not be committed.
+   ///   </para>
+   ///   <para>
+   ///     Entries are keyed by the <see cref="VssSnapshotProperties.OriginalVolumeName"/> of the snapshot and the path of the 
+   ///     file relative to the volume, both compared case-insensitively. The contents of a file are treated as an opaque 
+   ///     stream of bytes. Blocks are hashed in parallel while the next part of the file, of up to 16 MB, is read; the buffers 
+   ///     are sized by the remaining length of seekable streams, so that small files are not read into 16 MB buffers.
+   ///   </para>
+   ///   <para>
+   ///     Instances are not thread-safe, and a tracking directory should only be used by one process at a time.
+   ///   </para>
+   /// </remarks>
+   public sealed class VssChangedBlockTracker
+   {
+      #region Private Fields
+
+      private const string EntryExtension = ".cbt";
+      private const string EntryHeader = "AlphaVSS-CBT 1";
+      private const int ChunkSize = 16 * 1024 * 1024;
+
+      private const ulong Prime1 = 11400714785074694791;
+      private const ulong Prime2 = 14029467366897019727;
+      private const ulong Prime3 = 1609587929392839161;
+      private const ulong Prime4 = 9650029242287828579;
+      private const ulong Prime5 = 2870177450012600261;
+
+      private int m_blockSize = 64 * 1024;
+      private int m_maxDegreeOfParallelism = Environment.ProcessorCount;
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssChangedBlockTracker"/> class.
+      /// </summary>
+      /// <param name="directory">The directory holding the block hashes of the tracked files. It is created when the first entry is stored.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="directory"/> is <see langword="null"/>.</exception>
+      public VssChangedBlockTracker(string directory)
+      {
+         if (directory == null)
+            throw new ArgumentNullException(nameof(directory));
+
+         Directory = directory;
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the directory holding the block hashes of the tracked files.
+      /// </summary>
+      public string Directory { get; private set; }
+
+      /// <summary>
+      /// Gets or sets the size of the blocks files are divided into, in bytes. The value must be a multiple of 4096 bytes. 
+      /// Files whose previous run used a different block size are reported as entirely changed. The default is 64 KB.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is not a positive multiple of 4096, or is larger than 16 MB.</exception>
+      public int BlockSize
+      {
+         get
+         {
+            return m_blockSize;
+         }
+
+         set
+         {
+            if (value <= 0 || value % 4096 != 0 || value > ChunkSize)
+               throw new ArgumentOutOfRangeException(nameof(value), "The block size must be a positive multiple of 4096 bytes, not larger than 16 MB.");
+
+            m_blockSize = value;
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets the number of blocks hashed concurrently. The default is the number of processors.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is less than one.</exception>
+      public int MaxDegreeOfParallelism
+      {
+         get
+         {
+            return m_maxDegreeOfParallelism;
+         }
+
+         set
+         {
+            if (value < 1)
+               throw new ArgumentOutOfRangeException(nameof(value), "The degree of parallelism must be greater than zero.");
+
+            m_maxDegreeOfParallelism = value;
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Computes the changed blocks of a file in a snapshot.
+      /// </summary>
+      /// <param name="snapshot">The snapshot to read the file from.</param>
+      /// <param name="path">The path of the file, relative to the root of the volume.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests.</param>
+      /// <returns>A task whose result describes the changed extents of the file.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="snapshot"/> or <paramref name="path"/> is <see langword="null"/>.</exception>
+      public async Task<VssChangedBlockResult> ComputeChangesAsync(VssSnapshotProperties snapshot, string path, CancellationToken cancellationToken = default)
+      {
+         if (snapshot == null)
+            throw new ArgumentNullException(nameof(snapshot));
+
+         if (path == null)
+            throw new ArgumentNullException(nameof(path));
+
+         string snapshotPath = snapshot.SnapshotDeviceObject.TrimEnd('\\') + "\\" + path.TrimStart('\\');
+         using (FileStream stream = new FileStream(snapshotPath, FileMode.Open, FileAccess.Read, FileShare.ReadWrite | FileShare.Delete, 1, FileOptions.Asynchronous | FileOptions.SequentialScan))
+         {
+            return await ComputeChangesAsync(snapshot.OriginalVolumeName, path, stream, cancellationToken).ConfigureAwait(false);
+         }
+      }
+
+      /// <summary>
+      /// Computes the changed blocks of a file from its current contents.
+      /// </summary>
+      /// <param name="originalVolumeName">The name of the original volume of the file, e.g. the <see cref="VssSnapshotProperties.OriginalVolumeName"/> of the snapshot it is read from.</param>
+      /// <param name="path">The path of the file, relative to the root of the volume.</param>
+      /// <param name="contents">The stream to read the current contents of the file from. It is read to its end.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests.</param>
+      /// <returns>A task whose result describes the changed extents of the file.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="originalVolumeName"/>, <paramref name="path"/> or <paramref name="contents"/> is <see langword="null"/>.</exception>
+      public async Task<VssChangedBlockResult> ComputeChangesAsync(string originalVolumeName, string path, Stream contents, CancellationToken cancellationToken = default)
+      {
+         if (originalVolumeName == null)
+            throw new ArgumentNullException(nameof(originalVolumeName));
+
+         if (path == null)
+            throw new ArgumentNullException(nameof(path));
+
+         if (contents == null)
+            throw new ArgumentNullException(nameof(contents));
+
+         int blockSize = BlockSize;
+         long previousLength;
+         ulong[] previous = LoadEntry(originalVolumeName, path, blockSize, out previousLength);
+
+         // Chunks are whole multiples of the block size, so that no block spans two chunks.
+         int chunkSize = ChunkSize / blockSize * blockSize;
+         if (contents.CanSeek)
+         {
+            long remaining = Math.Max(contents.Length - contents.Position, 1);
+            if (remaining < chunkSize)
+               chunkSize = (int)((remaining + blockSize - 1) / blockSize * blockSize);
+         }
+
+         long length = 0;
+         List<ulong> hashes = new List<ulong>();
+         byte[] current = new byte[chunkSize];
+         byte[] next = null;
+         ParallelOptions options = new ParallelOptions { MaxDegreeOfParallelism = MaxDegreeOfParallelism, CancellationToken = cancellationToken };
+
+         int read = await ReadFullyAsync(contents, current, cancellationToken).ConfigureAwait(false);
+         while (read > 0)
+         {
+            // The next chunk is read while the blocks of the current one are hashed. The second buffer is only needed, and 
+            // allocated, if the file does not fit into the first.
+            Task<int> nextRead = Task.FromResult(0);
+            if (read == current.Length)
+            {
+               if (next == null)
+                  next = new byte[chunkSize];
+
+               nextRead = ReadFullyAsync(contents, next, cancellationToken);
+            }
+
+            byte[] chunk = current;
+            int chunkLength = read;
+            ulong[] chunkHashes = new ulong[(chunkLength + blockSize - 1) / blockSize];
+            Parallel.For(0, chunkHashes.Length, options, i =>
+            {
+               int offset = i * blockSize;
+               chunkHashes[i] = ComputeHash(chunk, offset, Math.Min(blockSize, chunkLength - offset));
+            });
+
+            hashes.AddRange(chunkHashes);
+            length += read;
+
+            read = await nextRead.ConfigureAwait(false);
+            current = next;
+            next = chunk;
+         }
+
+         ulong[] result = hashes.ToArray();
+         List<VssFileRange> changed = new List<VssFileRange>();
+         for (int i = 0; i < result.Length; i++)
+         {
+            if (previous == null || i >= previous.Length || previous[i] != result[i])
+            {
+               long offset = (long)i * blockSize;
+               changed.Add(new VssFileRange(offset, Math.Min(blockSize, length - offset)));
+            }
+         }
+
+         return new VssChangedBlockResult(originalVolumeName, path, length, blockSize, result, previous != null ? previousLength : -1, changed.Count, new VssFileRangeList(changed));
+      }
+
+      /// <summary>
+      /// Stores the block hashes of a file as the baseline of the next run, replacing the hashes stored by the previous run.
+      /// </summary>
+      /// <param name="result">The result of <see cref="ComputeChangesAsync(string, string, Stream, CancellationToken)"/> for the file.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="result"/> is <see langword="null"/>.</exception>
+      public void Commit(VssChangedBlockResult result)
+      {
+         if (result == null)
+            throw new ArgumentNullException(nameof(result));
+
+         System.IO.Directory.CreateDirectory(Directory);
+
+         // Written to a temporary file first, so that an interrupted write never leaves a truncated entry behind.
+         string path = GetEntryPath(result.OriginalVolumeName, result.Path);
+         string temporaryPath = path + ".tmp";
+         using (BinaryWriter writer = new BinaryWriter(new FileStream(temporaryPath, FileMode.Create, FileAccess.Write, FileShare.None, 64 * 1024), Encoding.UTF8))
+         {
+            writer.Write(EntryHeader);
+            writer.Write(GetKey(result.OriginalVolumeName, result.Path));
+            writer.Write(result.BlockSize);
+            writer.Write(result.Length);
+            writer.Write(result.Hashes.Length);
+            foreach (ulong hash in result.Hashes)
+               writer.Write(hash);
+         }
+
+         if (File.Exists(path))
+            File.Replace(temporaryPath, path, null);
+         else
+            File.Move(temporaryPath, path);
+      }
+
+      /// <summary>
+      /// Removes the stored block hashes of a file, so that it is reported as entirely changed by the next run.
+      /// </summary>
+      /// <param name="originalVolumeName">The name of the original volume of the file.</param>
+      /// <param name="path">The path of the file, relative to the root of the volume.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="originalVolumeName"/> or <paramref name="path"/> is <see langword="null"/>.</exception>
+      public void Remove(string originalVolumeName, string path)
+      {
+         if (originalVolumeName == null)
+            throw new ArgumentNullException(nameof(originalVolumeName));
+
+         if (path == null)
+            throw new ArgumentNullException(nameof(path));
+
+         File.Delete(GetEntryPath(originalVolumeName, path));
+      }
+
+      /// <summary>
+      /// Removes the stored block hashes of all files.
+      /// </summary>
+      public void Clear()
+      {
+         if (!System.IO.Directory.Exists(Directory))
+            return;
+
+         foreach (string path in System.IO.Directory.GetFiles(Directory, "*" + EntryExtension))
+            File.Delete(path);
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private static string GetKey(string originalVolumeName, string path)
+      {
+         return (originalVolumeName.TrimEnd('\\') + "\\" + path.TrimStart('\\')).ToUpperInvariant();
+      }
+
+      private string GetEntryPath(string originalVolumeName, string path)
+      {
+         return Path.Combine(Directory, VssWriterMetadataCache.ComputeFingerprint(GetKey(originalVolumeName, path)).ToString("x16", CultureInfo.InvariantCulture) + EntryExtension);
+      }
+
+      private ulong[] LoadEntry(string originalVolumeName, string path, int blockSize, out long length)
+      {
+         length = -1;
+         string entryPath = GetEntryPath(originalVolumeName, path);
+         if (!File.Exists(entryPath))
+            return null;
+
+         try
+         {
+            using (BinaryReader reader = new BinaryReader(new FileStream(entryPath, FileMode.Open, FileAccess.Read, FileShare.Read, 64 * 1024), Encoding.UTF8))
+            {
+               if (reader.ReadString() == EntryHeader && reader.ReadString() == GetKey(originalVolumeName, path))
+               {
+                  int entryBlockSize = reader.ReadInt32();
+                  long entryLength = reader.ReadInt64();
+                  int count = reader.ReadInt32();
+                  if (entryBlockSize != blockSize)
+                     return null;
+
+                  if (entryLength >= 0 && count >= 0 && count <= (reader.BaseStream.Length - reader.BaseStream.Position) / 8)
+                  {
+                     ulong[] hashes = new ulong[count];
+                     for (int i = 0; i < count; i++)
+                        hashes[i] = reader.ReadUInt64();
+
+                     length = entryLength;
+                     return hashes;
+                  }
+               }
+            }
+         }
+         catch (EndOfStreamException)
+         {
+         }
+
+         // The entry is damaged, was written by an incompatible version, or belongs to another file with the same 
+         // fingerprint; it is discarded, and the file reported as entirely changed.
+         File.Delete(entryPath);
+         return null;
+      }
+
+      private static async Task<int> ReadFullyAsync(Stream stream, byte[] buffer, CancellationToken cancellationToken)
+      {
+         int total = 0;
+         int read;
+         while (total < buffer.Length && (read = await stream.ReadAsync(buffer, total, buffer.Length - total, cancellationToken).ConfigureAwait(false)) > 0)
+            total += read;
+         return total;
+      }
+
+      // xxHash64 with a seed of zero. Reading the input as 64-bit words in four independent lanes keeps the processor's 
+      // execution units busy without requiring vector instructions.
+      private static ulong ComputeHash(byte[] data, int offset, int length)
+      {
+         int end = offset + length;
+         ulong hash;
+         if (length >= 32)
+         {
+            ulong v1 = unchecked(Prime1 + Prime2);
+            ulong v2 = Prime2;
+            ulong v3 = 0;
+            ulong v4 = unchecked(0 - Prime1);
+            int limit = end - 32;
+            do
+            {
+               v1 = Round(v1, BitConverter.ToUInt64(data, offset));
+               v2 = Round(v2, BitConverter.ToUInt64(data, offset + 8));
+               v3 = Round(v3, BitConverter.ToUInt64(data, offset + 16));
+               v4 = Round(v4, BitConverter.ToUInt64(data, offset + 24));
+               offset += 32;
+            }
+            while (offset <= limit);
+
+            hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+            hash = MergeRound(hash, v1);
+            hash = MergeRound(hash, v2);
+            hash = MergeRound(hash, v3);
+            hash = MergeRound(hash, v4);
+         }
+         else
+         {
+            hash = Prime5;
+         }
+
+         unchecked
+         {
+            hash += (ulong)length;
+
+            for (; offset + 8 <= end; offset += 8)
+               hash = RotateLeft(hash ^ Round(0, BitConverter.ToUInt64(data, offset)), 27) * Prime1 + Prime4;
+
+            if (offset + 4 <= end)
+            {
+               hash = RotateLeft(hash ^ (BitConverter.ToUInt32(data, offset) * Prime1), 23) * Prime2 + Prime3;
+               offset += 4;
+            }
+
+            for (; offset < end; offset++)
+               hash = RotateLeft(hash ^ (data[offset] * Prime5), 11) * Prime1;
+
+            hash ^= hash >> 33;
+            hash *= Prime2;
+            hash ^= hash >> 29;
+            hash *= Prime3;
+            hash ^= hash >> 32;
+         }
+
+         return hash;
+      }
+
+      private static ulong Round(ulong accumulator, ulong input)
+      {
+         unchecked
+         {
+            return RotateLeft(accumulator + input * Prime2, 31) * Prime1;
+         }
+      }
+
+      private static ulong MergeRound(ulong hash, ulong value)
+      {
+         unchecked
+         {
+            return (hash ^ Round(0, value)) * Prime1 + Prime4;
+         }
+      }
+
+      private static ulong RotateLeft(ulong value, int count)
+      {
+         return (value << count) | (value >> (64 - count));
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,515 @@
+
+using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// An indexed graph of the components of a set of writers and the dependencies between them, used to plan consistent 
+   /// component selections.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///     A <see cref="VssWMDependency"/> identifies the component it depends on by writer class id, logical path and name. The 
+   ///     graph resolves every dependency once, when it is built, to the matching components of all instances of that writer 
+   ///     class. Dependencies that match no component are reported by <see cref="UnresolvedDependencies"/>.
+   ///   </para>
+   ///   <para>
+   ///     Besides its declared dependencies, a component implicitly includes its subcomponents, i.e. the components of the same 
+   ///     writer instance whose logical path starts with its full path. Selecting a selectable component selects its whole 
+   ///     component set, so the dependencies of the subcomponents are part of its closure.
+   ///   </para>
+   ///   <para>
+   ///     Building the graph takes time proportional to the total number of components and dependencies; each query takes time 
+   ///     proportional to the size of its result. A graph is immutable once built, and may be used by multiple threads concurrently.
+   ///   </para>
+   /// </remarks>
+   public sealed class VssComponentDependencyGraph
+   {
+      #region Private Fields
+
+      private readonly List<Node> m_nodes = new List<Node>();
+      private readonly Dictionary<VssComponentKey, int> m_indexByKey = new Dictionary<VssComponentKey, int>();
+      private readonly List<KeyValuePair<VssComponentKey, VssWMDependency>> m_unresolved = new List<KeyValuePair<VssComponentKey, VssWMDependency>>();
+      private IList<IList<VssComponentKey>> m_cycles;
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssComponentDependencyGraph"/> class from the components of the specified writers.
+      /// </summary>
+      /// <param name="writers">The writer metadata, usually <see cref="IVssBackupComponents.WriterMetadata"/> or the result of <see cref="VssBackupComponentsExtensions.CaptureWriterMetadata"/>.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="writers"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException">A writer instance reports the same component more than once.</exception>
+      public VssComponentDependencyGraph(IEnumerable<IVssExamineWriterMetadata> writers)
+      {
+         if (writers == null)
+            throw new ArgumentNullException(nameof(writers));
+
+         // Components by writer class and full path, the identification used by dependencies, and by writer instance and full 
+         // path, used to find the parent component sets of each component.
+         Dictionary<string, List<int>> byWriterClass = new Dictionary<string, List<int>>(StringComparer.OrdinalIgnoreCase);
+         Dictionary<string, int> byWriterInstance = new Dictionary<string, int>(StringComparer.OrdinalIgnoreCase);
+
+         foreach (IVssExamineWriterMetadata writer in writers)
+         {
+            if (writer == null)
+               throw new ArgumentException("The sequence contains a null element.", nameof(writers));
+
+            foreach (IVssWMComponent component in writer.Components)
+            {
+               VssComponentKey key = VssComponentKey.FromComponent(writer, component);
+               if (m_indexByKey.ContainsKey(key))
+                  throw new ArgumentException("The component " + key + " is reported more than once.", nameof(writers));
+
+               int index = m_nodes.Count;
+               m_nodes.Add(new Node(key, writer, component));
+               m_indexByKey.Add(key, index);
+
+               string fullPath = key.FullPath;
+               List<int> matches;
+               string classKey = GetLookupKey(key.WriterId, fullPath);
+               if (!byWriterClass.TryGetValue(classKey, out matches))
+               {
+                  matches = new List<int>(1);
+                  byWriterClass.Add(classKey, matches);
+               }
+
+               matches.Add(index);
+               byWriterInstance[GetLookupKey(key.InstanceId, fullPath)] = index;
+            }
+         }
+
+         for (int i = 0; i < m_nodes.Count; i++)
+         {
+            Node node = m_nodes[i];
+
+            foreach (VssWMDependency dependency in node.Component.Dependencies)
+            {
+               List<int> targets;
+               if (byWriterClass.TryGetValue(GetLookupKey(dependency.WriterId, VssComponentKey.GetFullPath(dependency.LogicalPath, dependency.ComponentName)), out targets))
+                  node.Dependencies.AddRange(targets.Where(target => target != i));
+               else
+                  m_unresolved.Add(new KeyValuePair<VssComponentKey, VssWMDependency>(node.Key, dependency));
+            }
+
+            // The nearest ancestor component set; further ancestors are reached through it.
+            string logicalPath = node.Key.LogicalPath.TrimEnd('\\');
+            while (logicalPath.Length > 0)
+            {
+               int parent;
+               if (byWriterInstance.TryGetValue(GetLookupKey(node.Key.InstanceId, logicalPath), out parent))
+               {
+                  node.Parent = parent;
+                  m_nodes[parent].Subcomponents.Add(i);
+                  break;
+               }
+
+               int separator = logicalPath.LastIndexOf('\\');
+               logicalPath = separator < 0 ? String.Empty : logicalPath.Substring(0, separator);
+            }
+         }
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the number of components in the graph.
+      /// </summary>
+      public int Count
+      {
+         get
+         {
+            return m_nodes.Count;
+         }
+      }
+
+      /// <summary>
+      /// Gets the keys of all components in the graph, in the order of the writers and components the graph was built from.
+      /// </summary>
+      public IList<VssComponentKey> Keys
+      {
+         get
+         {
+            return m_nodes.Select(node => node.Key).ToList().AsReadOnly();
+         }
+      }
+
+      /// <summary>
+      /// Gets the dependencies that do not match any component in the graph, together with the key of the component declaring them.
+      /// </summary>
+      public IList<KeyValuePair<VssComponentKey, VssWMDependency>> UnresolvedDependencies
+      {
+         get
+         {
+            return m_unresolved.AsReadOnly();
+         }
+      }
+
+      /// <summary>
+      /// Gets the cycles of the dependency graph, i.e. its strongly connected sets of more than one component. 
+      /// </summary>
+      /// <remarks>
+      ///   The components of a cycle can only be backed up consistently together, and always end up in the same group 
+      ///   of <see cref="GetIndependentGroups"/>.
+      /// </remarks>
+      public IList<IList<VssComponentKey>> Cycles
+      {
+         get
+         {
+            // Computing the cycles is idempotent, so a race merely computes them twice.
+            if (m_cycles == null)
+               m_cycles = FindCycles();
+
+            return m_cycles;
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Determines whether the graph contains the specified component.
+      /// </summary>
+      /// <param name="key">The key of the component.</param>
+      /// <returns><see langword="true"/> if the graph contains the component; otherwise <see langword="false"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="key"/> is <see langword="null"/>.</exception>
+      public bool Contains(VssComponentKey key)
+      {
+         if (key == null)
+            throw new ArgumentNullException(nameof(key));
+
+         return m_indexByKey.ContainsKey(key);
+      }
+
+      /// <summary>
+      /// Gets the specified component.
+      /// </summary>
+      /// <param name="key">The key of the component.</param>
+      /// <returns>The component identified by <paramref name="key"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="key"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException">The graph does not contain the component.</exception>
+      public IVssWMComponent GetComponent(VssComponentKey key)
+      {
+         return m_nodes[IndexOf(key)].Component;
+      }
+
+      /// <summary>
+      /// Gets the writer metadata of the specified component.
+      /// </summary>
+      /// <param name="key">The key of the component.</param>
+      /// <returns>The writer metadata containing the component identified by <paramref name="key"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="key"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException">The graph does not contain the component.</exception>
+      public IVssExamineWriterMetadata GetWriter(VssComponentKey key)
+      {
+         return m_nodes[IndexOf(key)].Writer;
+      }
+
+      /// <summary>
+      /// Gets the components the specified component directly depends on.
+      /// </summary>
+      /// <param name="key">The key of the component.</param>
+      /// <returns>The keys of the components the component declares dependencies on. Unresolved dependencies are not included.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="key"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException">The graph does not contain the component.</exception>
+      public IList<VssComponentKey> GetDependencies(VssComponentKey key)
+      {
+         return m_nodes[IndexOf(key)].Dependencies.Select(index => m_nodes[index].Key).ToList().AsReadOnly();
+      }
+
+      /// <summary>
+      /// Gets the transitive closure of the specified components, i.e. the components themselves, their subcomponents, and 
+      /// everything they depend on directly or indirectly.
+      /// </summary>
+      /// <param name="selection">The keys of the selected components.</param>
+      /// <returns>The keys of all components in the closure, in graph order.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="selection"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException">The graph does not contain one of the components.</exception>
+      public IList<VssComponentKey> GetClosure(IEnumerable<VssComponentKey> selection)
+      {
+         bool[] included = ComputeClosure(selection);
+         return Enumerable.Range(0, m_nodes.Count).Where(i => included[i]).Select(i => m_nodes[i].Key).ToList().AsReadOnly();
+      }
+
+      /// <summary>
+      /// Partitions the closure of the specified components into groups that share no dependencies, and can therefore be 
+      /// snapshotted or copied independently of each other, for instance in parallel.
+      /// </summary>
+      /// <param name="selection">The keys of the selected components.</param>
+      /// <returns>The groups, each containing the keys of its components in graph order.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="selection"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException">The graph does not contain one of the components.</exception>
+      public IList<IList<VssComponentKey>> GetIndependentGroups(IEnumerable<VssComponentKey> selection)
+      {
+         bool[] included = ComputeClosure(selection);
+
+         // Union-find over the edges within the closure, both dependencies and component set membership.
+         int[] parents = Enumerable.Range(0, m_nodes.Count).ToArray();
+         for (int i = 0; i < m_nodes.Count; i++)
+         {
+            if (!included[i])
+               continue;
+
+            Node node = m_nodes[i];
+            foreach (int dependency in node.Dependencies)
+               Union(parents, i, dependency);
+
+            if (node.Parent >= 0 && included[node.Parent])
+               Union(parents, i, node.Parent);
+         }
+
+         Dictionary<int, List<VssComponentKey>> groups = new Dictionary<int, List<VssComponentKey>>();
+         List<IList<VssComponentKey>> result = new List<IList<VssComponentKey>>();
+         for (int i = 0; i < m_nodes.Count; i++)
+         {
+            if (!included[i])
+               continue;
+
+            int root = Find(parents, i);
+            List<VssComponentKey> group;
+            if (!groups.TryGetValue(root, out group))
+            {
+               group = new List<VssComponentKey>();
+               groups.Add(root, group);
+               result.Add(group);
+            }
+
+            group.Add(m_nodes[i].Key);
+         }
+
+         return result.Select(group => (IList<VssComponentKey>)((List<VssComponentKey>)group).AsReadOnly()).ToList().AsReadOnly();
+      }
+
+      /// <summary>
+      /// Computes the minimal set of components to add to the Backup Components Document, using 
+      /// <see cref="VssBackupComponentsExtensions.AddComponents"/> or <see cref="IVssBackupComponents.AddComponent"/>, to back up the closure 
+      /// of the specified components.
+      /// </summary>
+      /// <param name="selection">The keys of the selected components.</param>
+      /// <returns>The components to add, in graph order.</returns>
+      /// <remarks>
+      ///   A component in the closure is omitted if one of its ancestors is a selectable component that is also in the closure, 
+      ///   since it is then implicitly included as a member of that component set.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="selection"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException">The graph does not contain one of the components.</exception>
+      public IList<VssComponentSelection> Plan(IEnumerable<VssComponentKey> selection)
+      {
+         bool[] included = ComputeClosure(selection);
+         List<VssComponentSelection> result = new List<VssComponentSelection>();
+         for (int i = 0; i < m_nodes.Count; i++)
+         {
+            if (!included[i] || IsImplicitlyIncluded(i, included))
+               continue;
+
+            Node node = m_nodes[i];
+            result.Add(new VssComponentSelection(node.Key.InstanceId, node.Key.WriterId, node.Component.Type, node.Component.LogicalPath, node.Component.ComponentName));
+         }
+
+         return result.AsReadOnly();
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private static string GetLookupKey(Guid writerId, string fullPath)
+      {
+         return writerId.ToString("N") + "\\" + fullPath;
+      }
+
+      private int IndexOf(VssComponentKey key)
+      {
+         if (key == null)
+            throw new ArgumentNullException(nameof(key));
+
+         int index;
+         if (!m_indexByKey.TryGetValue(key, out index))
+            throw new ArgumentException("The component " + key + " is not part of the graph.", nameof(key));
+
+         return index;
+      }
+
+      private bool[] ComputeClosure(IEnumerable<VssComponentKey> selection)
+      {
+         if (selection == null)
+            throw new ArgumentNullException(nameof(selection));
+
+         bool[] included = new bool[m_nodes.Count];
+         Stack<int> pending = new Stack<int>();
+         foreach (VssComponentKey key in selection)
+         {
+            int index = IndexOf(key);
+            if (!included[index])
+            {
+               included[index] = true;
+               pending.Push(index);
+            }
+         }
+
+         while (pending.Count > 0)
+         {
+            Node node = m_nodes[pending.Pop()];
+            foreach (int next in node.Dependencies.Concat(node.Subcomponents))
+            {
+               if (!included[next])
+               {
+                  included[next] = true;
+                  pending.Push(next);
+               }
+            }
+         }
+
+         return included;
+      }
+
+      private bool IsImplicitlyIncluded(int index, bool[] included)
+      {
+         for (int parent = m_nodes[index].Parent; parent >= 0; parent = m_nodes[parent].Parent)
+         {
+            if (included[parent] && m_nodes[parent].Component.Selectable)
+               return true;
+         }
+
+         return false;
+      }
+
+      private IList<IList<VssComponentKey>> FindCycles()
+      {
+         // Tarjan's strongly connected components algorithm, iterative so that long dependency chains cannot exhaust the stack.
+         int count = m_nodes.Count;
+         int[] order = new int[count];
+         int[] lowLink = new int[count];
+         bool[] onStack = new bool[count];
+         for (int i = 0; i < count; i++)
+            order[i] = -1;
+
+         int nextOrder = 0;
+         Stack<int> component = new Stack<int>();
+         Stack<KeyValuePair<int, int>> work = new Stack<KeyValuePair<int, int>>();
+         List<IList<VssComponentKey>> cycles = new List<IList<VssComponentKey>>();
+
+         for (int start = 0; start < count; start++)
+         {
+            if (order[start] >= 0)
+               continue;
+
+            work.Push(new KeyValuePair<int, int>(start, 0));
+            while (work.Count > 0)
+            {
+               KeyValuePair<int, int> frame = work.Pop();
+               int v = frame.Key;
+               int edge = frame.Value;
+
+               if (edge == 0)
+               {
+                  order[v] = lowLink[v] = nextOrder++;
+                  component.Push(v);
+                  onStack[v] = true;
+               }
+
+               List<int> dependencies = m_nodes[v].Dependencies;
+               bool descended = false;
+               for (; edge < dependencies.Count; edge++)
+               {
+                  int w = dependencies[edge];
+                  if (order[w] < 0)
+                  {
+                     work.Push(new KeyValuePair<int, int>(v, edge + 1));
+                     work.Push(new KeyValuePair<int, int>(w, 0));
+                     descended = true;
+                     break;
+                  }
+
+                  if (onStack[w])
+                     lowLink[v] = Math.Min(lowLink[v], order[w]);
+               }
+
+               if (descended)
+                  continue;
+
+               if (lowLink[v] == order[v])
+               {
+                  List<VssComponentKey> members = new List<VssComponentKey>();
+                  int w;
+                  do
+                  {
+                     w = component.Pop();
+                     onStack[w] = false;
+                     members.Add(m_nodes[w].Key);
+                  }
+                  while (w != v);
+
+                  if (members.Count > 1)
+                  {
+                     members.Reverse();
+                     cycles.Add(members.AsReadOnly());
+                  }
+               }
+
+               // Propagate the low link to the caller, whose frame is now on top of the work stack.
+               if (work.Count > 0)
+               {
+                  int caller = work.Peek().Key;
+                  lowLink[caller] = Math.Min(lowLink[caller], lowLink[v]);
+               }
+            }
+         }
+
+         return new ReadOnlyCollection<IList<VssComponentKey>>(cycles);
+      }
+
+      private static int Find(int[] parents, int i)
+      {
+         while (parents[i] != i)
+         {
+            parents[i] = parents[parents[i]];
+            i = parents[i];
+         }
+
+         return i;
+      }
+
+      private static void Union(int[] parents, int a, int b)
+      {
+         int rootA = Find(parents, a);
+         int rootB = Find(parents, b);
+         if (rootA != rootB)
+            parents[Math.Max(rootA, rootB)] = Math.Min(rootA, rootB);
+      }
+
+      #endregion
+
+      #region Nested Types
+
+      private sealed class Node
+      {
+         public Node(VssComponentKey key, IVssExamineWriterMetadata writer, IVssWMComponent component)
+         {
+            Key = key;
+            Writer = writer;
+            Component = component;
+            Parent = -1;
+            Dependencies = new List<int>();
+            Subcomponents = new List<int>();
+         }
+
+         public VssComponentKey Key { get; private set; }
+         public IVssExamineWriterMetadata Writer { get; private set; }
+         public IVssWMComponent Component { get; private set; }
+         public int Parent { get; set; }
+         public List<int> Dependencies { get; private set; }
+         public List<int> Subcomponents { get; private set; }
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,293 @@
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Creates <see cref="VssComponentIndex{TComponent}"/> instances over the components of writers.
+   /// </summary>
+   public static class VssComponentIndex
+   {
+      /// <summary>
+      /// Creates an index over the components of the specified writers, usually <see cref="IVssBackupComponents.WriterMetadata"/>.
+      /// </summary>
+      /// <param name="writers">The writer metadata to index.</param>
+      /// <returns>An index over the components of <paramref name="writers"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="writers"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="writers"/> contains a <see langword="null"/> element, or a writer instance reports the same component more than once.</exception>
+      public static VssComponentIndex<IVssWMComponent> Create(IEnumerable<IVssExamineWriterMetadata> writers)
+      {
+         if (writers == null)
+            throw new ArgumentNullException(nameof(writers));
+
+         return new VssComponentIndex<IVssWMComponent>(writers.SelectMany(writer =>
+         {
+            if (writer == null)
+               throw new ArgumentException("The sequence contains a null element.", nameof(writers));
+
+            return writer.Components.Select(component => new KeyValuePair<VssComponentKey, IVssWMComponent>(VssComponentKey.FromComponent(writer, component), component));
+         }), component => component.Type, nameof(writers));
+      }
+
+      /// <summary>
+      /// Creates an index over the components of the Backup Components Document, usually <see cref="IVssBackupComponents.WriterComponents"/>.
+      /// </summary>
+      /// <param name="writers">The writer components to index.</param>
+      /// <returns>An index over the components of <paramref name="writers"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="writers"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="writers"/> contains a <see langword="null"/> element, or a writer instance contains the same component more than once.</exception>
+      public static VssComponentIndex<IVssComponent> Create(IEnumerable<IVssWriterComponents> writers)
+      {
+         if (writers == null)
+            throw new ArgumentNullException(nameof(writers));
+
+         return new VssComponentIndex<IVssComponent>(writers.SelectMany(writer =>
+         {
+            if (writer == null)
+               throw new ArgumentException("The sequence contains a null element.", nameof(writers));
+
+            return writer.Components.Select(component => new KeyValuePair<VssComponentKey, IVssComponent>(
+               new VssComponentKey(writer.InstanceId, writer.WriterId, component.LogicalPath, component.ComponentName), component));
+         }), component => component.ComponentType, nameof(writers));
+      }
+   }
+
+   /// <summary>
+   /// A hashed and prefix-searchable index over the components of a set of writers, identified by writer, logical path and 
+   /// component name.
+   /// </summary>
+   /// <typeparam name="TComponent">The type of the indexed components, <see cref="IVssWMComponent"/> or <see cref="IVssComponent"/>.</typeparam>
+   /// <remarks>
+   ///   <para>
+   ///     Use <see cref="VssComponentIndex.Create(IEnumerable{IVssExamineWriterMetadata})"/> or 
+   ///     <see cref="VssComponentIndex.Create(IEnumerable{IVssWriterComponents})"/> to create an index. The component lists are 
+   ///     enumerated once, when the index is created; lookups of a component of a specific writer instance then take constant time, 
+   ///     and lookups across the instances of a writer class and subtree queries take time logarithmic in the number of components 
+   ///     plus the size of the result.
+   ///   </para>
+   ///   <para>
+   ///     Logical paths and component names are compared case-insensitively, and trailing backslashes of logical paths are ignored. 
+   ///     An index does not reflect later changes to the writers or the Backup Components Document it was created from. It is 
+   ///     immutable, and may be used by multiple threads concurrently.
+   ///   </para>
+   /// </remarks>
+   public sealed class VssComponentIndex<TComponent> where TComponent : class
+   {
+      #region Private Fields
+
+      private static readonly IComparer<Entry> s_entryComparer = Comparer<Entry>.Create(CompareEntries);
+
+      // Sorted by writer class, full path and writer instance, so that the components of a writer class with a given full path, 
+      // and those below a given logical path, are contiguous.
+      private readonly Entry[] m_entries;
+      private readonly Dictionary<VssComponentKey, int> m_indexByKey;
+
+      #endregion
+
+      #region Constructors
+
+      internal VssComponentIndex(IEnumerable<KeyValuePair<VssComponentKey, TComponent>> components, Func<TComponent, VssComponentType> getType, string paramName)
+      {
+         m_entries = components.Select(pair => new Entry(pair.Key, getType(pair.Value), pair.Value)).ToArray();
+         Array.Sort(m_entries, s_entryComparer);
+
+         m_indexByKey = new Dictionary<VssComponentKey, int>(m_entries.Length);
+         for (int i = 0; i < m_entries.Length; i++)
+         {
+            if (m_indexByKey.ContainsKey(m_entries[i].LookupKey))
+               throw new ArgumentException("The component " + m_entries[i].Key + " is reported more than once.", paramName);
+
+            m_indexByKey.Add(m_entries[i].LookupKey, i);
+         }
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the number of components in the index.
+      /// </summary>
+      public int Count
+      {
+         get
+         {
+            return m_entries.Length;
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Finds the specified component of a specific writer instance.
+      /// </summary>
+      /// <param name="instanceId">The instance id of the writer.</param>
+      /// <param name="writerId">The class id of the writer.</param>
+      /// <param name="componentType">The type of the component.</param>
+      /// <param name="logicalPath">The logical path of the component. May be <see langword="null"/>.</param>
+      /// <param name="componentName">The name of the component.</param>
+      /// <returns>The component, or <see langword="null"/> if the index does not contain a component of type <paramref name="componentType"/> with the specified logical path and name.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="componentName"/> is <see langword="null"/>.</exception>
+      public TComponent Find(Guid instanceId, Guid writerId, VssComponentType componentType, string logicalPath, string componentName)
+      {
+         int index;
+         if (!m_indexByKey.TryGetValue(new VssComponentKey(instanceId, writerId, TrimLogicalPath(logicalPath), componentName), out index)
+            || m_entries[index].Type != componentType)
+            return null;
+
+         return m_entries[index].Component;
+      }
+
+      /// <summary>
+      /// Finds the specified component in all instances of a writer class.
+      /// </summary>
+      /// <param name="writerId">The class id of the writer.</param>
+      /// <param name="componentType">The type of the component.</param>
+      /// <param name="logicalPath">The logical path of the component. May be <see langword="null"/>.</param>
+      /// <param name="componentName">The name of the component.</param>
+      /// <returns>The keys and components of the matching components, ordered by writer instance id.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="componentName"/> is <see langword="null"/>.</exception>
+      public IList<KeyValuePair<VssComponentKey, TComponent>> Find(Guid writerId, VssComponentType componentType, string logicalPath, string componentName)
+      {
+         if (componentName == null)
+            throw new ArgumentNullException(nameof(componentName));
+
+         string fullPath = VssComponentKey.GetFullPath(logicalPath, componentName);
+         List<KeyValuePair<VssComponentKey, TComponent>> result = new List<KeyValuePair<VssComponentKey, TComponent>>();
+         for (int i = LowerBound(writerId, fullPath); i < m_entries.Length && m_entries[i].Key.WriterId == writerId
+            && String.Equals(m_entries[i].FullPath, fullPath, StringComparison.OrdinalIgnoreCase); i++)
+         {
+            if (m_entries[i].Type == componentType)
+               result.Add(m_entries[i].ToPair());
+         }
+
+         return result.AsReadOnly();
+      }
+
+      /// <summary>
+      /// Gets the components of all instances of a writer class at or below the specified logical path, i.e. the component 
+      /// whose full path is <paramref name="logicalPath"/>, if any, and all components whose logical path starts with it.
+      /// </summary>
+      /// <param name="writerId">The class id of the writer.</param>
+      /// <param name="logicalPath">The logical path. If <see langword="null"/> or empty, all components of the writer class are returned.</param>
+      /// <returns>The keys and components of the matching components, ordered by full path and writer instance id.</returns>
+      public IList<KeyValuePair<VssComponentKey, TComponent>> GetSubtree(Guid writerId, string logicalPath)
+      {
+         return GetSubtree(writerId, logicalPath, null);
+      }
+
+      /// <summary>
+      /// Gets the components of a specific writer instance at or below the specified logical path, i.e. the component whose full 
+      /// path is <paramref name="logicalPath"/>, if any, and all components whose logical path starts with it.
+      /// </summary>
+      /// <param name="instanceId">The instance id of the writer.</param>
+      /// <param name="writerId">The class id of the writer.</param>
+      /// <param name="logicalPath">The logical path. If <see langword="null"/> or empty, all components of the writer instance are returned.</param>
+      /// <returns>The keys and components of the matching components, ordered by full path.</returns>
+      public IList<KeyValuePair<VssComponentKey, TComponent>> GetSubtree(Guid instanceId, Guid writerId, string logicalPath)
+      {
+         return GetSubtree(writerId, logicalPath, instanceId);
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private IList<KeyValuePair<VssComponentKey, TComponent>> GetSubtree(Guid writerId, string logicalPath, Guid? instanceId)
+      {
+         string root = TrimLogicalPath(logicalPath);
+         List<KeyValuePair<VssComponentKey, TComponent>> result = new List<KeyValuePair<VssComponentKey, TComponent>>();
+
+         // The component defining the subtree sorts before its descendants, but possibly not immediately before them, 
+         // since characters such as '!' sort before the separator.
+         string prefix = root;
+         if (root.Length > 0)
+         {
+            for (int i = LowerBound(writerId, root); i < m_entries.Length && m_entries[i].Key.WriterId == writerId
+               && String.Equals(m_entries[i].FullPath, root, StringComparison.OrdinalIgnoreCase); i++)
+            {
+               if (instanceId == null || m_entries[i].Key.InstanceId == instanceId.Value)
+                  result.Add(m_entries[i].ToPair());
+            }
+
+            prefix = root + "\\";
+         }
+
+         for (int i = LowerBound(writerId, prefix); i < m_entries.Length && m_entries[i].Key.WriterId == writerId
+            && m_entries[i].FullPath.StartsWith(prefix, StringComparison.OrdinalIgnoreCase); i++)
+         {
+            if (instanceId == null || m_entries[i].Key.InstanceId == instanceId.Value)
+               result.Add(m_entries[i].ToPair());
+         }
+
+         return result.AsReadOnly();
+      }
+
+      private int LowerBound(Guid writerId, string fullPath)
+      {
+         int low = 0;
+         int high = m_entries.Length;
+         while (low < high)
+         {
+            int middle = low + (high - low) / 2;
+            int comparison = m_entries[middle].Key.WriterId.CompareTo(writerId);
+            if (comparison == 0)
+               comparison = String.Compare(m_entries[middle].FullPath, fullPath, StringComparison.OrdinalIgnoreCase);
+
+            if (comparison < 0)
+               low = middle + 1;
+            else
+               high = middle;
+         }
+
+         return low;
+      }
+
+      private static string TrimLogicalPath(string logicalPath)
+      {
+         return logicalPath == null ? String.Empty : logicalPath.TrimEnd('\\');
+      }
+
+      private static int CompareEntries(Entry x, Entry y)
+      {
+         int comparison = x.Key.WriterId.CompareTo(y.Key.WriterId);
+         if (comparison == 0)
+            comparison = String.Compare(x.FullPath, y.FullPath, StringComparison.OrdinalIgnoreCase);
+
+         return comparison != 0 ? comparison : x.Key.InstanceId.CompareTo(y.Key.InstanceId);
+      }
+
+      #endregion
+
+      #region Nested Types
+
+      private sealed class Entry
+      {
+         public Entry(VssComponentKey key, VssComponentType type, TComponent component)
+         {
+            Key = key;
+            Type = type;
+            Component = component;
+            FullPath = key.FullPath;
+            LookupKey = new VssComponentKey(key.InstanceId, key.WriterId, TrimLogicalPath(key.LogicalPath), key.ComponentName);
+         }
+
+         public VssComponentKey Key { get; private set; }
+         public VssComponentKey LookupKey { get; private set; }
+         public VssComponentType Type { get; private set; }
+         public TComponent Component { get; private set; }
+         public string FullPath { get; private set; }
+
+         public KeyValuePair<VssComponentKey, TComponent> ToPair()
+         {
+            return new KeyValuePair<VssComponentKey, TComponent>(Key, Component);
+         }
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,149 @@
+
+using System;
+using System.Globalization;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Identifies a component of a specific writer instance. Logical paths and component names are compared case-insensitively.
+   /// </summary>
+   [Serializable]
+   public sealed class VssComponentKey : IEquatable<VssComponentKey>
+   {
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssComponentKey"/> class.
+      /// </summary>
+      /// <param name="instanceId">The instance id of the writer.</param>
+      /// <param name="writerId">The class id of the writer.</param>
+      /// <param name="logicalPath">The logical path of the component. May be <see langword="null"/>, which is equivalent to an empty logical path.</param>
+      /// <param name="componentName">The name of the component.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="componentName"/> is <see langword="null"/>.</exception>
+      public VssComponentKey(Guid instanceId, Guid writerId, string logicalPath, string componentName)
+      {
+         if (componentName == null)
+            throw new ArgumentNullException(nameof(componentName));
+
+         InstanceId = instanceId;
+         WriterId = writerId;
+         LogicalPath = logicalPath ?? String.Empty;
+         ComponentName = componentName;
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the instance id of the writer.
+      /// </summary>
+      public Guid InstanceId { get; private set; }
+
+      /// <summary>
+      /// Gets the class id of the writer.
+      /// </summary>
+      public Guid WriterId { get; private set; }
+
+      /// <summary>
+      /// Gets the logical path of the component, or an empty string if the component has no logical path.
+      /// </summary>
+      public string LogicalPath { get; private set; }
+
+      /// <summary>
+      /// Gets the name of the component.
+      /// </summary>
+      public string ComponentName { get; private set; }
+
+      /// <summary>
+      /// Gets the full path of the component, i.e. its logical path and name separated by a backslash, as used to identify 
+      /// the component in dependencies and in the logical paths of its subcomponents.
+      /// </summary>
+      public string FullPath
+      {
+         get
+         {
+            return GetFullPath(LogicalPath, ComponentName);
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Creates the key of the specified component of the specified writer.
+      /// </summary>
+      /// <param name="writer">The writer metadata the component belongs to.</param>
+      /// <param name="component">The component.</param>
+      /// <returns>The key of <paramref name="component"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="writer"/> or <paramref name="component"/> is <see langword="null"/>.</exception>
+      public static VssComponentKey FromComponent(IVssExamineWriterMetadata writer, IVssWMComponent component)
+      {
+         if (writer == null)
+            throw new ArgumentNullException(nameof(writer));
+
+         if (component == null)
+            throw new ArgumentNullException(nameof(component));
+
+         return new VssComponentKey(writer.InstanceId, writer.WriterId, component.LogicalPath, component.ComponentName);
+      }
+
+      /// <summary>
+      /// Determines whether the specified key identifies the same component as this instance.
+      /// </summary>
+      /// <param name="other">The key to compare with.</param>
+      /// <returns><see langword="true"/> if <paramref name="other"/> identifies the same component; otherwise <see langword="false"/>.</returns>
+      public bool Equals(VssComponentKey other)
+      {
+         return other != null && InstanceId == other.InstanceId && WriterId == other.WriterId
+            && StringComparer.OrdinalIgnoreCase.Equals(LogicalPath, other.LogicalPath)
+            && StringComparer.OrdinalIgnoreCase.Equals(ComponentName, other.ComponentName);
+      }
+
+      /// <summary>
+      /// Determines whether the specified object is a <see cref="VssComponentKey"/> identifying the same component as this instance.
+      /// </summary>
+      /// <param name="obj">The object to compare with.</param>
+      /// <returns><see langword="true"/> if <paramref name="obj"/> identifies the same component; otherwise <see langword="false"/>.</returns>
+      public override bool Equals(object obj)
+      {
+         return Equals(obj as VssComponentKey);
+      }
+
+      /// <summary>
+      /// Returns a hash code for this instance.
+      /// </summary>
+      /// <returns>A hash code for this instance.</returns>
+      public override int GetHashCode()
+      {
+         unchecked
+         {
+            int hash = InstanceId.GetHashCode();
+            hash = hash * 31 + WriterId.GetHashCode();
+            hash = hash * 31 + StringComparer.OrdinalIgnoreCase.GetHashCode(LogicalPath);
+            return hash * 31 + StringComparer.OrdinalIgnoreCase.GetHashCode(ComponentName);
+         }
+      }
+
+      /// <summary>
+      /// Returns a string identifying the component.
+      /// </summary>
+      /// <returns>The writer instance id and the full path of the component.</returns>
+      public override string ToString()
+      {
+         return String.Format(CultureInfo.InvariantCulture, "{0:B}:{1}", InstanceId, FullPath);
+      }
+
+      #endregion
+
+      #region Internal Methods
+
+      internal static string GetFullPath(string logicalPath, string componentName)
+      {
+         return String.IsNullOrEmpty(logicalPath) ? componentName : logicalPath.TrimEnd('\\') + "\\" + componentName;
+      }
+
+      #endregion
+   }
+}
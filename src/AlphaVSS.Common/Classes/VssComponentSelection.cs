@@ -0,0 +1,95 @@
+
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Describes a component to be selected for backup by <see cref="VssBackupComponentsExtensions.AddComponents"/>, together with the 
+   /// backup options and previous backup stamp to set for it, if any.
+   /// </summary>
+   [Serializable]
+   public class VssComponentSelection
+   {
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssComponentSelection"/> class.
+      /// </summary>
+      /// <param name="instanceId">Identifies a specific instance of a writer.</param>
+      /// <param name="writerId">Writer class identifier.</param>
+      /// <param name="componentType">Identifies the type of the component.</param>
+      /// <param name="logicalPath">The logical path of the component. May be <see langword="null"/>.</param>
+      /// <param name="componentName">The name of the component. Cannot be <see langword="null"/>.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="componentName"/> is <see langword="null"/>.</exception>
+      public VssComponentSelection(Guid instanceId, Guid writerId, VssComponentType componentType, string logicalPath, string componentName)
+         : this(instanceId, writerId, componentType, logicalPath, componentName, null, null)
+      {
+      }
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssComponentSelection"/> class.
+      /// </summary>
+      /// <param name="instanceId">Identifies a specific instance of a writer.</param>
+      /// <param name="writerId">Writer class identifier.</param>
+      /// <param name="componentType">Identifies the type of the component.</param>
+      /// <param name="logicalPath">The logical path of the component. May be <see langword="null"/>.</param>
+      /// <param name="componentName">The name of the component. Cannot be <see langword="null"/>.</param>
+      /// <param name="backupOptions">The backup options to set for the component, or <see langword="null"/> to not set any.</param>
+      /// <param name="previousBackupStamp">The previous backup stamp to set for the component, or <see langword="null"/> to not set any.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="componentName"/> is <see langword="null"/>.</exception>
+      public VssComponentSelection(Guid instanceId, Guid writerId, VssComponentType componentType, string logicalPath, string componentName, string backupOptions, string previousBackupStamp)
+      {
+         if (componentName == null)
+            throw new ArgumentNullException(nameof(componentName));
+
+         InstanceId = instanceId;
+         WriterId = writerId;
+         ComponentType = componentType;
+         LogicalPath = logicalPath;
+         ComponentName = componentName;
+         BackupOptions = backupOptions;
+         PreviousBackupStamp = previousBackupStamp;
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the identifier of the writer instance.
+      /// </summary>
+      public Guid InstanceId { get; private set; }
+
+      /// <summary>
+      /// Gets the writer class identifier.
+      /// </summary>
+      public Guid WriterId { get; private set; }
+
+      /// <summary>
+      /// Gets the type of the component.
+      /// </summary>
+      public VssComponentType ComponentType { get; private set; }
+
+      /// <summary>
+      /// Gets the logical path of the component. May be <see langword="null"/>.
+      /// </summary>
+      public string LogicalPath { get; private set; }
+
+      /// <summary>
+      /// Gets the name of the component.
+      /// </summary>
+      public string ComponentName { get; private set; }
+
+      /// <summary>
+      /// Gets the backup options to set for the component, or <see langword="null"/> if none are set.
+      /// </summary>
+      public string BackupOptions { get; private set; }
+
+      /// <summary>
+      /// Gets the previous backup stamp to set for the component, or <see langword="null"/> if none is set.
+      /// </summary>
+      public string PreviousBackupStamp { get; private set; }
+
+      #endregion
+   }
+}
@@ -0,0 +1,46 @@
+
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Describes a component of a bulk selection that could not be selected or updated.
+   /// </summary>
+   /// <seealso cref="VssBackupComponentsExtensions.AddComponents"/>
+   [Serializable]
+   public class VssComponentSelectionFailure
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssComponentSelectionFailure"/> class.
+      /// </summary>
+      /// <param name="index">The zero-based position of the component in the batch.</param>
+      /// <param name="component">The component that failed.</param>
+      /// <param name="exception">The exception describing the failure.</param>
+      public VssComponentSelectionFailure(int index, VssComponentSelection component, Exception exception)
+      {
+         Index = index;
+         Component = component;
+         Exception = exception;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the zero-based position of the component in the batch.
+      /// </summary>
+      public int Index { get; private set; }
+
+      /// <summary>
+      /// Gets the component that failed.
+      /// </summary>
+      public VssComponentSelection Component { get; private set; }
+
+      /// <summary>
+      /// Gets the exception describing the failure, i.e. the exception that calling the corresponding individual method 
+      /// (such as <see cref="IVssBackupComponents.AddComponent"/>) for the component would have thrown.
+      /// </summary>
+      public Exception Exception { get; private set; }
+
+      #endregion
+   }
+}
@@ -0,0 +1,40 @@
+
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A changed file found by <see cref="VssDifferencedFileScanner"/>.
+   /// </summary>
+   [Serializable]
+   public sealed class VssDifferencedFileRecord
+   {
+      internal VssDifferencedFileRecord(string path, long length, DateTime lastWriteTimeUtc, VssDifferencedFileInfo differencedFile)
+      {
+         Path = path;
+         Length = length;
+         LastWriteTimeUtc = lastWriteTimeUtc;
+         DifferencedFile = differencedFile;
+      }
+
+      /// <summary>
+      /// Gets the full path of the file, i.e. the path it was found at in the snapshot.
+      /// </summary>
+      public string Path { get; private set; }
+
+      /// <summary>
+      /// Gets the size of the file, in bytes.
+      /// </summary>
+      public long Length { get; private set; }
+
+      /// <summary>
+      /// Gets the time the file was last written to, in coordinated universal time (UTC).
+      /// </summary>
+      public DateTime LastWriteTimeUtc { get; private set; }
+
+      /// <summary>
+      /// Gets the differenced file specification that matched the file.
+      /// </summary>
+      public VssDifferencedFileInfo DifferencedFile { get; private set; }
+   }
+}
@@ -0,0 +1,592 @@
+
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.Runtime.ExceptionServices;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Finds the files described by the <see cref="IVssComponent.DifferencedFiles"/> of components that changed since the 
+   /// last modification time specified by the writer, walking the directory trees in parallel.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///     The paths reported by writers refer to the original volume. Use the 
+   ///     <see cref="VssDifferencedFileScanner(string, string)"/> constructor to scan the corresponding directories of a 
+   ///     snapshot instead. Environment variables in the paths are expanded.
+   ///   </para>
+   ///   <para>
+   ///     A file is considered changed if it was last written to after the <see cref="VssDifferencedFileInfo.LastModifyTime"/> 
+   ///     of the differenced file specification it matches, or if no last modification time was specified. Directories are 
+   ///     distributed over the workers with work stealing: each worker processes the subdirectories it finds itself, most 
+   ///     recent first, while idle workers take the oldest pending directories of the other workers. Reparse points, such as 
+   ///     junctions and symbolic links, are not followed, unless they are the directory of a specification.
+   ///   </para>
+   ///   <para>
+   ///     The directory of a specification below the directory of a recursive specification is not walked separately. Its 
+   ///     specifications are applied when the walk of the enclosing tree reaches it, so that each file is enumerated once.
+   ///   </para>
+   /// </remarks>
+   public sealed class VssDifferencedFileScanner
+   {
+      #region Private Fields
+
+      private readonly string m_volumeName;
+      private readonly string m_snapshotRoot;
+      private int m_maxDegreeOfParallelism = Environment.ProcessorCount;
+      private int m_boundedCapacity = 4096;
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssDifferencedFileScanner"/> class that scans the paths reported by the 
+      /// writers as they are.
+      /// </summary>
+      public VssDifferencedFileScanner()
+      {
+      }
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssDifferencedFileScanner"/> class that scans the snapshot of a volume.
+      /// </summary>
+      /// <param name="volumeName">The name of the original volume, e.g. <c>C:\</c>. Paths below this volume are scanned in the snapshot; other paths are skipped.</param>
+      /// <param name="snapshotRoot">The root of the snapshot of the volume, for instance its <see cref="VssSnapshotProperties.SnapshotDeviceObject"/> or the path it was exposed at.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="volumeName"/> or <paramref name="snapshotRoot"/> is <see langword="null"/>.</exception>
+      public VssDifferencedFileScanner(string volumeName, string snapshotRoot)
+      {
+         if (volumeName == null)
+            throw new ArgumentNullException(nameof(volumeName));
+
+         if (snapshotRoot == null)
+            throw new ArgumentNullException(nameof(snapshotRoot));
+
+         m_volumeName = NormalizeDirectory(volumeName);
+         m_snapshotRoot = NormalizeDirectory(snapshotRoot);
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets or sets the number of directories scanned concurrently. The default is the number of processors.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is less than one.</exception>
+      public int MaxDegreeOfParallelism
+      {
+         get
+         {
+            return m_maxDegreeOfParallelism;
+         }
+
+         set
+         {
+            if (value < 1)
+               throw new ArgumentOutOfRangeException(nameof(value), "The degree of parallelism must be greater than zero.");
+
+            m_maxDegreeOfParallelism = value;
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets the number of found files <see cref="Scan"/> buffers before the workers wait for the caller to 
+      /// consume them. The default is 4096.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is less than one.</exception>
+      public int BoundedCapacity
+      {
+         get
+         {
+            return m_boundedCapacity;
+         }
+
+         set
+         {
+            if (value < 1)
+               throw new ArgumentOutOfRangeException(nameof(value), "The capacity must be greater than zero.");
+
+            m_boundedCapacity = value;
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets a value indicating whether directories that cannot be read are skipped. If <see langword="false"/>, 
+      /// the default, such a directory fails the scan. Directories that do not exist are always skipped.
+      /// </summary>
+      public bool SkipInaccessibleDirectories { get; set; }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Scans the specified differenced files, returning the changed files as they are found.
+      /// </summary>
+      /// <param name="differencedFiles">The differenced file specifications, typically the <see cref="IVssComponent.DifferencedFiles"/> of the components being backed up.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests.</param>
+      /// <returns>
+      ///   The changed files, in no particular order. The scan starts when enumeration starts, and is canceled if enumeration 
+      ///   is stopped early. A file matching several specifications is returned once, for the specification of the deepest 
+      ///   directory among them.
+      /// </returns>
+      /// <exception cref="ArgumentNullException"><paramref name="differencedFiles"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="differencedFiles"/> contains a <see langword="null"/> element.</exception>
+      public IEnumerable<VssDifferencedFileRecord> Scan(IEnumerable<VssDifferencedFileInfo> differencedFiles, CancellationToken cancellationToken = default)
+      {
+         Dictionary<string, Root> nestedRoots;
+         List<Root> roots = CreateRoots(differencedFiles, out nestedRoots);
+         return ScanIterator(roots, nestedRoots, cancellationToken);
+      }
+
+      /// <summary>
+      /// Scans the specified differenced files, passing the changed files to a callback as they are found.
+      /// </summary>
+      /// <param name="differencedFiles">The differenced file specifications, typically the <see cref="IVssComponent.DifferencedFiles"/> of the components being backed up.</param>
+      /// <param name="onFileFound">
+      ///   The callback receiving the changed files. It is called concurrently from several threads, and once for each file, 
+      ///   as described by <see cref="Scan"/>.
+      /// </param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests.</param>
+      /// <returns>A task whose result is the number of changed files found.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="differencedFiles"/> or <paramref name="onFileFound"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="differencedFiles"/> contains a <see langword="null"/> element.</exception>
+      public Task<long> ScanAsync(IEnumerable<VssDifferencedFileInfo> differencedFiles, Action<VssDifferencedFileRecord> onFileFound, CancellationToken cancellationToken = default)
+      {
+         if (onFileFound == null)
+            throw new ArgumentNullException(nameof(onFileFound));
+
+         Dictionary<string, Root> nestedRoots;
+         List<Root> roots = CreateRoots(differencedFiles, out nestedRoots);
+         return new Walk(this, roots, nestedRoots, onFileFound, cancellationToken).RunAsync();
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private IEnumerable<VssDifferencedFileRecord> ScanIterator(List<Root> roots, Dictionary<string, Root> nestedRoots, CancellationToken cancellationToken)
+      {
+         using (CancellationTokenSource cancellation = CancellationTokenSource.CreateLinkedTokenSource(cancellationToken))
+         using (BlockingCollection<VssDifferencedFileRecord> found = new BlockingCollection<VssDifferencedFileRecord>(BoundedCapacity))
+         {
+            Task<long> walk = new Walk(this, roots, nestedRoots, record => found.Add(record, cancellation.Token), cancellation.Token).RunAsync();
+            Task completion = walk.ContinueWith(task => found.CompleteAdding(), CancellationToken.None, TaskContinuationOptions.ExecuteSynchronously, TaskScheduler.Default);
+
+            try
+            {
+               foreach (VssDifferencedFileRecord record in found.GetConsumingEnumerable(cancellationToken))
+                  yield return record;
+
+               walk.GetAwaiter().GetResult();
+            }
+            finally
+            {
+               // If enumeration stopped early, stop the walk, and wait for it to stop adding to the collection before the 
+               // collection is disposed.
+               if (!walk.IsCompleted)
+                  cancellation.Cancel();
+
+               completion.Wait();
+            }
+         }
+      }
+
+      // Returns the directories to walk. The directories below the directory of a recursive specification are returned in 
+      // nestedRoots instead, keyed by path, to be merged into the walk of the enclosing tree when it reaches them.
+      private List<Root> CreateRoots(IEnumerable<VssDifferencedFileInfo> differencedFiles, out Dictionary<string, Root> nestedRoots)
+      {
+         if (differencedFiles == null)
+            throw new ArgumentNullException(nameof(differencedFiles));
+
+         // Specifications sharing a directory are scanned together, so that the directory is enumerated only once.
+         Dictionary<string, Root> roots = new Dictionary<string, Root>(StringComparer.OrdinalIgnoreCase);
+         List<Root> result = new List<Root>();
+         foreach (VssDifferencedFileInfo differencedFile in differencedFiles)
+         {
+            if (differencedFile == null)
+               throw new ArgumentException("The sequence contains a null element.", nameof(differencedFiles));
+
+            string path = MapPath(differencedFile.Path);
+            if (path == null)
+               continue;
+
+            Root root;
+            if (!roots.TryGetValue(path, out root))
+            {
+               root = new Root(path);
+               roots.Add(path, root);
+               result.Add(root);
+            }
+
+            root.Add(new Rule(differencedFile));
+         }
+
+         Dictionary<string, Root> nested = new Dictionary<string, Root>(StringComparer.OrdinalIgnoreCase);
+         foreach (Root root in result)
+         {
+            if (result.Exists(ancestor => ancestor.RecursiveRules.Count > 0 && ancestor.Path.Length < root.Path.Length && 
+                                          root.Path.StartsWith(ancestor.Path, StringComparison.OrdinalIgnoreCase)))
+            {
+               nested.Add(root.Path, root);
+            }
+         }
+
+         if (nested.Count > 0)
+            result.RemoveAll(root => nested.ContainsKey(root.Path));
+
+         nestedRoots = nested;
+         return result;
+      }
+
+      private string MapPath(string path)
+      {
+         if (String.IsNullOrEmpty(path))
+            return null;
+
+         path = NormalizeDirectory(Environment.ExpandEnvironmentVariables(path));
+         if (m_volumeName == null)
+            return path;
+
+         if (!path.StartsWith(m_volumeName, StringComparison.OrdinalIgnoreCase))
+            return null;
+
+         return m_snapshotRoot + path.Substring(m_volumeName.Length);
+      }
+
+      private static string NormalizeDirectory(string path)
+      {
+         if (Path.DirectorySeparatorChar != '\\')
+            path = path.Replace('\\', Path.DirectorySeparatorChar);
+
+         return path.Length > 0 && path[path.Length - 1] == Path.DirectorySeparatorChar ? path : path + Path.DirectorySeparatorChar;
+      }
+
+      #endregion
+
+      #region Nested Types
+
+      private sealed class Rule
+      {
+         private readonly Func<string, bool> m_isMatch;
+         private readonly DateTime m_since;
+
+         public Rule(VssDifferencedFileInfo differencedFile)
+         {
+            DifferencedFile = differencedFile;
+            m_isMatch = VssFileSpecificationMatcher.CreateNameMatcher(differencedFile.FileSpecification);
+
+            DateTime since = differencedFile.LastModifyTime;
+            m_since = since.Kind == DateTimeKind.Local ? since.ToUniversalTime() : since;
+         }
+
+         public VssDifferencedFileInfo DifferencedFile { get; private set; }
+
+         public bool IsRecursive
+         {
+            get
+            {
+               return DifferencedFile.IsRecursive;
+            }
+         }
+
+         public bool IsMatch(string name, DateTime lastWriteTimeUtc)
+         {
+            return lastWriteTimeUtc > m_since && m_isMatch(name);
+         }
+      }
+
+      private sealed class Root
+      {
+         public Root(string path)
+         {
+            Path = path;
+            Rules = new List<Rule>();
+            RecursiveRules = new List<Rule>();
+         }
+
+         public string Path { get; private set; }
+         public List<Rule> Rules { get; private set; }
+         public List<Rule> RecursiveRules { get; private set; }
+
+         public void Add(Rule rule)
+         {
+            Rules.Add(rule);
+            if (rule.IsRecursive)
+               RecursiveRules.Add(rule);
+         }
+      }
+
+      private struct WorkItem
+      {
+         public readonly string Directory;
+         public readonly List<Rule> Rules;
+         public readonly List<Rule> RecursiveRules;
+
+         public WorkItem(string directory, List<Rule> rules, List<Rule> recursiveRules)
+         {
+            Directory = directory;
+            Rules = rules;
+            RecursiveRules = recursiveRules;
+         }
+      }
+
+      // A double-ended queue of directories owned by a single worker. The owner pushes and pops at the tail; other workers 
+      // steal from the head, taking the oldest, and usually largest, pending subtrees.
+      private sealed class WorkQueue
+      {
+         private WorkItem[] m_items = new WorkItem[32];
+         private int m_head;
+         private int m_count;
+
+         public void Push(WorkItem item)
+         {
+            lock (this)
+            {
+               if (m_count == m_items.Length)
+               {
+                  WorkItem[] items = new WorkItem[m_items.Length * 2];
+                  for (int i = 0; i < m_count; i++)
+                     items[i] = m_items[(m_head + i) % m_items.Length];
+
+                  m_items = items;
+                  m_head = 0;
+               }
+
+               m_items[(m_head + m_count) % m_items.Length] = item;
+               m_count++;
+            }
+         }
+
+         public bool TryPop(out WorkItem item)
+         {
+            lock (this)
+            {
+               if (m_count == 0)
+               {
+                  item = default;
+                  return false;
+               }
+
+               m_count--;
+               int index = (m_head + m_count) % m_items.Length;
+               item = m_items[index];
+               m_items[index] = default;
+               return true;
+            }
+         }
+
+         public bool TrySteal(out WorkItem item)
+         {
+            lock (this)
+            {
+               if (m_count == 0)
+               {
+                  item = default;
+                  return false;
+               }
+
+               item = m_items[m_head];
+               m_items[m_head] = default;
+               m_head = (m_head + 1) % m_items.Length;
+               m_count--;
+               return true;
+            }
+         }
+      }
+
+      private sealed class Walk
+      {
+         private readonly VssDifferencedFileScanner m_scanner;
+         private readonly List<Root> m_roots;
+         private readonly Dictionary<string, Root> m_nestedRoots;
+         private readonly Action<VssDifferencedFileRecord> m_onFileFound;
+         private readonly CancellationToken m_cancellationToken;
+         private readonly WorkQueue[] m_queues;
+
+         // Counts the directories in all queues; a worker waits for it before taking a directory, which guarantees that 
+         // one is available somewhere.
+         private readonly SemaphoreSlim m_available = new SemaphoreSlim(0);
+
+         // Counts the directories queued or being scanned. The walk is complete when it drops to zero.
+         private int m_pending;
+         private long m_found;
+         private volatile bool m_done;
+         private Exception m_exception;
+
+         public Walk(VssDifferencedFileScanner scanner, List<Root> roots, Dictionary<string, Root> nestedRoots, Action<VssDifferencedFileRecord> onFileFound, CancellationToken cancellationToken)
+         {
+            m_scanner = scanner;
+            m_roots = roots;
+            m_nestedRoots = nestedRoots;
+            m_onFileFound = onFileFound;
+            m_cancellationToken = cancellationToken;
+            m_queues = new WorkQueue[scanner.MaxDegreeOfParallelism];
+            for (int i = 0; i < m_queues.Length; i++)
+               m_queues[i] = new WorkQueue();
+         }
+
+         public async Task<long> RunAsync()
+         {
+            m_cancellationToken.ThrowIfCancellationRequested();
+
+            for (int i = 0; i < m_roots.Count; i++)
+               Enqueue(i % m_queues.Length, new WorkItem(m_roots[i].Path, m_roots[i].Rules, m_roots[i].RecursiveRules));
+
+            if (m_roots.Count == 0)
+               return 0;
+
+            Task[] workers = new Task[m_queues.Length];
+            for (int i = 0; i < workers.Length; i++)
+            {
+               int worker = i;
+               workers[i] = Task.Factory.StartNew(() => RunWorker(worker), CancellationToken.None, TaskCreationOptions.LongRunning, TaskScheduler.Default);
+            }
+
+            try
+            {
+               await Task.WhenAll(workers).ConfigureAwait(false);
+            }
+            finally
+            {
+               m_available.Dispose();
+            }
+
+            if (m_exception != null)
+               ExceptionDispatchInfo.Capture(m_exception).Throw();
+
+            m_cancellationToken.ThrowIfCancellationRequested();
+            return Interlocked.Read(ref m_found);
+         }
+
+         private void Enqueue(int worker, WorkItem item)
+         {
+            Interlocked.Increment(ref m_pending);
+            m_queues[worker].Push(item);
+            m_available.Release();
+         }
+
+         private void RunWorker(int worker)
+         {
+            using (m_cancellationToken.Register(() => Stop(null)))
+            {
+               while (true)
+               {
+                  m_available.Wait();
+                  if (m_done)
+                     return;
+
+                  WorkItem item = Take(worker);
+                  try
+                  {
+                     ScanDirectory(worker, item);
+                  }
+                  catch (Exception ex)
+                  {
+                     Stop(ex);
+                     return;
+                  }
+
+                  if (Interlocked.Decrement(ref m_pending) == 0)
+                     Stop(null);
+               }
+            }
+         }
+
+         private WorkItem Take(int worker)
+         {
+            WorkItem item;
+            if (m_queues[worker].TryPop(out item))
+               return item;
+
+            // A directory is guaranteed to be queued, but another worker may be pushing it right now.
+            SpinWait spin = new SpinWait();
+            while (true)
+            {
+               for (int i = 1; i <= m_queues.Length; i++)
+               {
+                  if (m_queues[(worker + i) % m_queues.Length].TrySteal(out item))
+                     return item;
+               }
+
+               spin.SpinOnce();
+            }
+         }
+
+         private void Stop(Exception exception)
+         {
+            lock (m_queues)
+            {
+               if (m_done)
+                  return;
+
+               m_exception = exception;
+               m_done = true;
+               m_available.Release(m_queues.Length);
+            }
+         }
+
+         private void ScanDirectory(int worker, WorkItem item)
+         {
+            try
+            {
+               foreach (FileSystemInfo entry in new DirectoryInfo(item.Directory).EnumerateFileSystemInfos())
+               {
+                  if (m_done)
+                     return;
+
+                  if ((entry.Attributes & FileAttributes.Directory) != 0)
+                  {
+                     Root nested;
+                     if (m_nestedRoots.Count > 0 && m_nestedRoots.TryGetValue(NormalizeDirectory(entry.FullName), out nested))
+                        Enqueue(worker, Merge(entry.FullName, nested, item.RecursiveRules));
+                     else if (item.RecursiveRules.Count > 0 && (entry.Attributes & FileAttributes.ReparsePoint) == 0)
+                        Enqueue(worker, new WorkItem(entry.FullName, item.RecursiveRules, item.RecursiveRules));
+
+                     continue;
+                  }
+
+                  DateTime lastWriteTimeUtc = entry.LastWriteTimeUtc;
+                  foreach (Rule rule in item.Rules)
+                  {
+                     if (rule.IsMatch(entry.Name, lastWriteTimeUtc))
+                     {
+                        m_onFileFound(new VssDifferencedFileRecord(entry.FullName, ((FileInfo)entry).Length, lastWriteTimeUtc, rule.DifferencedFile));
+                        Interlocked.Increment(ref m_found);
+                        break;
+                     }
+                  }
+               }
+            }
+            catch (DirectoryNotFoundException)
+            {
+               // Writers may report directories that do not exist on this system.
+            }
+            catch (Exception ex) when ((ex is UnauthorizedAccessException || ex is IOException) && m_scanner.SkipInaccessibleDirectories)
+            {
+            }
+         }
+
+         // The specifications of a nested root come first, so that a file matching several is reported for the deepest one.
+         private static WorkItem Merge(string directory, Root nested, List<Rule> inheritedRecursiveRules)
+         {
+            List<Rule> rules = new List<Rule>(nested.Rules.Count + inheritedRecursiveRules.Count);
+            rules.AddRange(nested.Rules);
+            rules.AddRange(inheritedRecursiveRules);
+
+            List<Rule> recursiveRules = new List<Rule>(nested.RecursiveRules.Count + inheritedRecursiveRules.Count);
+            recursiveRules.AddRange(nested.RecursiveRules);
+            recursiveRules.AddRange(inheritedRecursiveRules);
+
+            return new WorkItem(directory, rules, recursiveRules);
+         }
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,131 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Provides batched enumeration on <see cref="IVssDifferentialSoftwareSnapshotManagement"/> instances.
+   /// </summary>
+   /// <remarks>
+   ///   Each method delegates to the <see cref="IVssBatchDifferentialSoftwareSnapshotManagement"/> implementation of the 
+   ///   management object if it has one, and otherwise falls back to the equivalent query method of 
+   ///   <see cref="IVssDifferentialSoftwareSnapshotManagement"/>, which retrieves all results before returning. 
+   /// </remarks>
+   public static class VssDifferentialSoftwareSnapshotManagementExtensions
+   {
+      /// <summary>
+      /// Lazily enumerates the shadow copy storage areas in use by the original volume associated with the input shadow copy.
+      /// </summary>
+      /// <param name="management">The management object to query.</param>
+      /// <param name="snapshotId">The snapshot id.</param>
+      /// <param name="batchSize">The maximum number of elements to retrieve from VSS in a single call. Must be greater than zero.</param>
+      /// <returns>A sequence of <see cref="VssDiffAreaProperties"/> describing the shadow copy storage areas in use by the 
+      /// shadow copy specified.</returns>
+      /// <remarks>
+      ///   See <see cref="IVssBatchDifferentialSoftwareSnapshotManagement.EnumerateDiffAreasForSnapshot"/> for more information. 
+      ///   If <paramref name="management"/> does not implement <see cref="IVssBatchDifferentialSoftwareSnapshotManagement"/>, 
+      ///   <paramref name="batchSize"/> is validated and 
+      ///   <see cref="IVssDifferentialSoftwareSnapshotManagement.QueryDiffAreasForSnapshot"/> is called instead.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="management"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="batchSize"/> is less than one.</exception>
+      public static IEnumerable<VssDiffAreaProperties> EnumerateDiffAreasForSnapshot(this IVssDifferentialSoftwareSnapshotManagement management, Guid snapshotId, int batchSize)
+      {
+         CheckArguments(management, batchSize);
+
+         if (management is IVssBatchDifferentialSoftwareSnapshotManagement batchManagement)
+            return batchManagement.EnumerateDiffAreasForSnapshot(snapshotId, batchSize);
+
+         return management.QueryDiffAreasForSnapshot(snapshotId);
+      }
+
+      /// <summary>
+      /// Lazily enumerates the shadow copy storage areas in use by the volume specified.
+      /// </summary>
+      /// <param name="management">The management object to query.</param>
+      /// <param name="volumeName">Name of the volume that contains shadow copy storage areas. See <see cref="IVssDifferentialSoftwareSnapshotManagement.QueryDiffAreasForVolume"/> for the supported formats.</param>
+      /// <param name="batchSize">The maximum number of elements to retrieve from VSS in a single call. Must be greater than zero.</param>
+      /// <returns>A sequence of <see cref="VssDiffAreaProperties"/> objects describing the shadow copy storage areas in use by 
+      /// the volume specified.</returns>
+      /// <remarks>
+      ///   See <see cref="IVssBatchDifferentialSoftwareSnapshotManagement.EnumerateDiffAreasForVolume"/> for more information. 
+      ///   If <paramref name="management"/> does not implement <see cref="IVssBatchDifferentialSoftwareSnapshotManagement"/>, 
+      ///   <paramref name="batchSize"/> is validated and 
+      ///   <see cref="IVssDifferentialSoftwareSnapshotManagement.QueryDiffAreasForVolume"/> is called instead.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="management"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="batchSize"/> is less than one.</exception>
+      public static IEnumerable<VssDiffAreaProperties> EnumerateDiffAreasForVolume(this IVssDifferentialSoftwareSnapshotManagement management, string volumeName, int batchSize)
+      {
+         CheckArguments(management, batchSize);
+
+         if (management is IVssBatchDifferentialSoftwareSnapshotManagement batchManagement)
+            return batchManagement.EnumerateDiffAreasForVolume(volumeName, batchSize);
+
+         return management.QueryDiffAreasForVolume(volumeName);
+      }
+
+      /// <summary>
+      /// Lazily enumerates the shadow copy storage areas that physically reside on the given volume.
+      /// </summary>
+      /// <param name="management">The management object to query.</param>
+      /// <param name="volumeName">Name of the volume that contains shadow copy storage areas. See <see cref="IVssDifferentialSoftwareSnapshotManagement.QueryDiffAreasOnVolume"/> for the supported formats.</param>
+      /// <param name="batchSize">The maximum number of elements to retrieve from VSS in a single call. Must be greater than zero.</param>
+      /// <returns>A sequence of <see cref="VssDiffAreaProperties"/> objects describing the shadow copy storage areas that 
+      /// physically reside on the given volume.</returns>
+      /// <remarks>
+      ///   See <see cref="IVssBatchDifferentialSoftwareSnapshotManagement.EnumerateDiffAreasOnVolume"/> for more information. 
+      ///   If <paramref name="management"/> does not implement <see cref="IVssBatchDifferentialSoftwareSnapshotManagement"/>, 
+      ///   <paramref name="batchSize"/> is validated and 
+      ///   <see cref="IVssDifferentialSoftwareSnapshotManagement.QueryDiffAreasOnVolume"/> is called instead.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="management"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="batchSize"/> is less than one.</exception>
+      public static IEnumerable<VssDiffAreaProperties> EnumerateDiffAreasOnVolume(this IVssDifferentialSoftwareSnapshotManagement management, string volumeName, int batchSize)
+      {
+         CheckArguments(management, batchSize);
+
+         if (management is IVssBatchDifferentialSoftwareSnapshotManagement batchManagement)
+            return batchManagement.EnumerateDiffAreasOnVolume(volumeName, batchSize);
+
+         return management.QueryDiffAreasOnVolume(volumeName);
+      }
+
+      /// <summary>
+      /// Lazily enumerates the volumes that support shadow copy storage areas (including volumes with disabled shadow copy 
+      /// storage areas).
+      /// </summary>
+      /// <param name="management">The management object to query.</param>
+      /// <param name="originalVolumeName">Name of the original volume that is the source of the shadow copies. See <see cref="IVssDifferentialSoftwareSnapshotManagement.QueryVolumesSupportedForDiffAreas"/> for the supported formats.</param>
+      /// <param name="batchSize">The maximum number of elements to retrieve from VSS in a single call. Must be greater than zero.</param>
+      /// <returns>A sequence of <see cref="VssDiffVolumeProperties"/> describing the volumes that support shadow copy storage 
+      /// areas (including volumes with disabled shadow copy storage areas).</returns>
+      /// <remarks>
+      ///   See <see cref="IVssBatchDifferentialSoftwareSnapshotManagement.EnumerateVolumesSupportedForDiffAreas"/> for more 
+      ///   information. If <paramref name="management"/> does not implement 
+      ///   <see cref="IVssBatchDifferentialSoftwareSnapshotManagement"/>, <paramref name="batchSize"/> is validated and 
+      ///   <see cref="IVssDifferentialSoftwareSnapshotManagement.QueryVolumesSupportedForDiffAreas"/> is called instead.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="management"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="batchSize"/> is less than one.</exception>
+      public static IEnumerable<VssDiffVolumeProperties> EnumerateVolumesSupportedForDiffAreas(this IVssDifferentialSoftwareSnapshotManagement management, string originalVolumeName, int batchSize)
+      {
+         CheckArguments(management, batchSize);
+
+         if (management is IVssBatchDifferentialSoftwareSnapshotManagement batchManagement)
+            return batchManagement.EnumerateVolumesSupportedForDiffAreas(originalVolumeName, batchSize);
+
+         return management.QueryVolumesSupportedForDiffAreas(originalVolumeName);
+      }
+
+      private static void CheckArguments(IVssDifferentialSoftwareSnapshotManagement management, int batchSize)
+      {
+         if (management == null)
+            throw new ArgumentNullException(nameof(management));
+
+         if (batchSize < 1)
+            throw new ArgumentOutOfRangeException(nameof(batchSize), "The batch size must be greater than zero.");
+      }
+   }
+}
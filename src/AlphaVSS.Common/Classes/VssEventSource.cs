@@ -0,0 +1,120 @@
+
+using System;
+using System.Diagnostics.Tracing;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// The <see cref="EventSource"/> through which AlphaVSS reports the duration and result of the VSS operations it performs.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///      Events are only produced while a listener (such as an ETW session, an EventPipe session or a <see cref="VssInstrumentationListener"/>)
+   ///      is attached, and the timing of operations is skipped entirely otherwise.
+   ///   </para>
+   ///   <para>
+   ///      The following events are reported:
+   ///      <list type="table">
+   ///         <listheader>
+   ///            <term>Event</term>
+   ///            <description>Description</description>
+   ///         </listheader>
+   ///         <item>
+   ///            <term><see cref="PhaseStarted"/>, <see cref="PhaseCompleted"/></term>
+   ///            <description>The start and the completion (including the wall time and resulting HRESULT) of every asynchronous VSS
+   ///            operation, such as <see cref="IVssBackupComponents.GatherWriterMetadata"/>, <see cref="IVssBackupComponents.PrepareForBackup"/>,
+   ///            <see cref="IVssBackupComponents.DoSnapshotSet"/>, <see cref="IVssBackupComponents.GatherWriterStatus"/> and
+   ///            <see cref="IVssBackupComponents.BackupComplete"/>. Enabled by <see cref="Keywords.Phases"/>.</description>
+   ///         </item>
+   ///         <item>
+   ///            <term><see cref="ComCallCompleted"/></term>
+   ///            <description>The latency and HRESULT of every individual COM call issued by AlphaVSS. Enabled by <see cref="Keywords.ComCalls"/>
+   ///            at <see cref="EventLevel.Verbose"/>.</description>
+   ///         </item>
+   ///         <item>
+   ///            <term><see cref="WriterCounts"/></term>
+   ///            <description>The number of writers that reported metadata and status, sampled after each phase that may change the
+   ///            writer information (such as <see cref="IVssBackupComponents.GatherWriterStatus"/>) has completed. Enabled
+   ///            by <see cref="Keywords.Writers"/>.</description>
+   ///         </item>
+   ///      </list>
+   ///   </para>
+   /// </remarks>
+   [EventSource(Name = "Alphaleonis-AlphaVSS")]
+   public sealed class VssEventSource : EventSource
+   {
+      /// <summary>
+      /// The single instance of <see cref="VssEventSource"/>.
+      /// </summary>
+      public static readonly VssEventSource Log = new VssEventSource();
+
+      internal const int PhaseStartedEventId = 1;
+      internal const int PhaseCompletedEventId = 2;
+      internal const int ComCallCompletedEventId = 3;
+      internal const int WriterCountsEventId = 4;
+
+      private VssEventSource()
+      {
+      }
+
+      /// <summary>
+      /// The keywords used by the events of the <see cref="VssEventSource"/>.
+      /// </summary>
+      public static class Keywords
+      {
+         /// <summary>Events reporting the start and completion of asynchronous VSS operations.</summary>
+         public const EventKeywords Phases = (EventKeywords)0x1;
+
+         /// <summary>Events reporting the latency of individual COM calls.</summary>
+         public const EventKeywords ComCalls = (EventKeywords)0x2;
+
+         /// <summary>Events reporting writer counts.</summary>
+         public const EventKeywords Writers = (EventKeywords)0x4;
+      }
+
+      /// <summary>
+      /// Reports that an asynchronous VSS operation was started.
+      /// </summary>
+      /// <param name="phase">The name of the operation, e.g. <c>DoSnapshotSet</c>.</param>
+      [Event(PhaseStartedEventId, Level = EventLevel.Informational, Keywords = Keywords.Phases)]
+      public void PhaseStarted(string phase)
+      {
+         WriteEvent(PhaseStartedEventId, phase);
+      }
+
+      /// <summary>
+      /// Reports that an asynchronous VSS operation has completed.
+      /// </summary>
+      /// <param name="phase">The name of the operation, e.g. <c>DoSnapshotSet</c>.</param>
+      /// <param name="hresult">The result of the operation.</param>
+      /// <param name="durationMilliseconds">The wall time of the operation in milliseconds, from the call that started it until its completion was observed.</param>
+      [Event(PhaseCompletedEventId, Level = EventLevel.Informational, Keywords = Keywords.Phases)]
+      public void PhaseCompleted(string phase, int hresult, double durationMilliseconds)
+      {
+         WriteEvent(PhaseCompletedEventId, phase, hresult, durationMilliseconds);
+      }
+
+      /// <summary>
+      /// Reports the latency of a single COM call.
+      /// </summary>
+      /// <param name="method">The name of the AlphaVSS method issuing the call.</param>
+      /// <param name="hresult">The result of the call.</param>
+      /// <param name="durationMilliseconds">The duration of the call in milliseconds.</param>
+      [Event(ComCallCompletedEventId, Level = EventLevel.Verbose, Keywords = Keywords.ComCalls)]
+      public void ComCallCompleted(string method, int hresult, double durationMilliseconds)
+      {
+         WriteEvent(ComCallCompletedEventId, method, hresult, durationMilliseconds);
+      }
+
+      /// <summary>
+      /// Reports the number of writers known to a backup components object.
+      /// </summary>
+      /// <param name="writerMetadataCount">The number of writers that reported metadata, or <c>-1</c> if not available.</param>
+      /// <param name="writerStatusCount">The number of writers that reported status, or <c>-1</c> if not available.</param>
+      [Event(WriterCountsEventId, Level = EventLevel.Informational, Keywords = Keywords.Writers)]
+      public void WriterCounts(int writerMetadataCount, int writerStatusCount)
+      {
+         WriteEvent(WriterCountsEventId, writerMetadataCount, writerStatusCount);
+      }
+   }
+}
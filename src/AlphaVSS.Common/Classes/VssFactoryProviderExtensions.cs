@@ -0,0 +1,49 @@
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Provides startup operations on <see cref="IVssFactoryProvider"/> instances.
+   /// </summary>
+   public static class VssFactoryProviderExtensions
+   {
+      /// <summary>
+      /// Performs the one-time initialization that otherwise delays the first backup session of the process: loading the platform
+      /// specific assembly, initializing COM and the VSS client, and querying the snapshot providers of the system.
+      /// </summary>
+      /// <param name="factoryProvider">The factory provider to warm up, usually <see cref="VssFactoryProvider.Default"/>.</param>
+      /// <returns>The snapshot providers registered on the system.</returns>
+      /// <remarks>
+      ///   Call this method at process startup, for instance on a background thread, so that the first job does not pay for it.
+      ///   The time each stage took is traced through <see cref="Trace"/>.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="factoryProvider"/> is <see langword="null"/>.</exception>
+      /// <exception cref="UnsupportedOperatingSystemException">This exception is thrown if running as a 32-bit process on a 64-bit operating system.</exception>
+      public static IList<VssProviderProperties> WarmUp(this IVssFactoryProvider factoryProvider)
+      {
+         if (factoryProvider == null)
+            throw new ArgumentNullException(nameof(factoryProvider));
+
+         Stopwatch stopwatch = Stopwatch.StartNew();
+         IVssFactory factory = factoryProvider.GetVssFactory();
+         Log($"Platform specific assembly ready after {stopwatch.ElapsedMilliseconds} ms.");
+
+         using (IVssBackupComponents backupComponents = factory.CreateVssBackupComponents())
+         {
+            backupComponents.InitializeForBackup(null);
+            IList<VssProviderProperties> providers = backupComponents.QueryProviders().ToList().AsReadOnly();
+            Log($"VSS initialized and {providers.Count} provider(s) queried after {stopwatch.ElapsedMilliseconds} ms.");
+            return providers;
+         }
+      }
+
+      private static void Log(string message)
+      {
+         Trace.WriteLine(message, "AlphaVSS");
+      }
+   }
+}
@@ -0,0 +1,50 @@
+
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// The outcome of copying a single file with <see cref="VssSnapshotCopyEngine"/>.
+   /// </summary>
+   public sealed class VssFileCopyResult
+   {
+      internal VssFileCopyResult(string relativePath, long bytesCopied, TimeSpan duration, Exception exception)
+      {
+         RelativePath = relativePath;
+         BytesCopied = bytesCopied;
+         Duration = duration;
+         Exception = exception;
+      }
+
+      /// <summary>
+      /// Gets the path of the file, relative to the source and destination roots.
+      /// </summary>
+      public string RelativePath { get; private set; }
+
+      /// <summary>
+      /// Gets the number of bytes copied. If the copy failed, this is the number of bytes copied before the failure.
+      /// </summary>
+      public long BytesCopied { get; private set; }
+
+      /// <summary>
+      /// Gets the time the copy took.
+      /// </summary>
+      public TimeSpan Duration { get; private set; }
+
+      /// <summary>
+      /// Gets the exception that caused the copy to fail, or <see langword="null"/> if the file was copied.
+      /// </summary>
+      public Exception Exception { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the file was copied.
+      /// </summary>
+      public bool Succeeded
+      {
+         get
+         {
+            return Exception == null;
+         }
+      }
+   }
+}
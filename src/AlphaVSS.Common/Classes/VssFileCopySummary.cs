@@ -0,0 +1,59 @@
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// The outcome of copying a list of files with <see cref="VssSnapshotCopyEngine"/>.
+   /// </summary>
+   public sealed class VssFileCopySummary
+   {
+      internal VssFileCopySummary(IList<VssFileCopyResult> results, long bytesCopied, TimeSpan elapsed, bool isCanceled)
+      {
+         Results = results;
+         BytesCopied = bytesCopied;
+         Elapsed = elapsed;
+         IsCanceled = isCanceled;
+         FailedCount = results.Count(result => !result.Succeeded);
+      }
+
+      /// <summary>
+      /// Gets the outcome of each file, in the order of the file list.
+      /// </summary>
+      public IList<VssFileCopyResult> Results { get; private set; }
+
+      /// <summary>
+      /// Gets the number of files that could not be copied.
+      /// </summary>
+      public int FailedCount { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the copy was canceled before every file was copied. The results of the files that were 
+      /// not copied because of the cancellation carry an <see cref="OperationCanceledException"/>.
+      /// </summary>
+      public bool IsCanceled { get; private set; }
+
+      /// <summary>
+      /// Gets the total number of bytes copied.
+      /// </summary>
+      public long BytesCopied { get; private set; }
+
+      /// <summary>
+      /// Gets the time the copy took, from start to the completion of the last file.
+      /// </summary>
+      public TimeSpan Elapsed { get; private set; }
+
+      /// <summary>
+      /// Gets the aggregate throughput of the copy, in megabytes (2<sup>20</sup> bytes) per second.
+      /// </summary>
+      public double MegabytesPerSecond
+      {
+         get
+         {
+            return Elapsed > TimeSpan.Zero ? BytesCopied / (1024.0 * 1024.0) / Elapsed.TotalSeconds : 0;
+         }
+      }
+   }
+}
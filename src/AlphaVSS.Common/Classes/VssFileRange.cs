@@ -0,0 +1,143 @@
+
+using System;
+using System.Globalization;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A contiguous range of bytes in a file, as used in the ranges of partial files.
+   /// </summary>
+   [Serializable]
+   public struct VssFileRange : IEquatable<VssFileRange>
+   {
+      #region Private Fields
+
+      private readonly long m_offset;
+      private readonly long m_length;
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssFileRange"/> structure.
+      /// </summary>
+      /// <param name="offset">The offset of the first byte of the range.</param>
+      /// <param name="length">The number of bytes in the range.</param>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="offset"/> or <paramref name="length"/> is negative, or the range extends beyond <see cref="Int64.MaxValue"/>.</exception>
+      public VssFileRange(long offset, long length)
+      {
+         if (offset < 0)
+            throw new ArgumentOutOfRangeException(nameof(offset), "The offset must not be negative.");
+
+         if (length < 0 || length > Int64.MaxValue - offset)
+            throw new ArgumentOutOfRangeException(nameof(length), "The length must not be negative, and the range must not extend beyond the largest possible offset.");
+
+         m_offset = offset;
+         m_length = length;
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the offset of the first byte of the range.
+      /// </summary>
+      public long Offset
+      {
+         get
+         {
+            return m_offset;
+         }
+      }
+
+      /// <summary>
+      /// Gets the number of bytes in the range.
+      /// </summary>
+      public long Length
+      {
+         get
+         {
+            return m_length;
+         }
+      }
+
+      /// <summary>
+      /// Gets the offset of the first byte following the range.
+      /// </summary>
+      public long End
+      {
+         get
+         {
+            return m_offset + m_length;
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Determines whether the specified range is equal to this instance.
+      /// </summary>
+      /// <param name="other">The range to compare with.</param>
+      /// <returns><see langword="true"/> if <paramref name="other"/> has the same offset and length; otherwise <see langword="false"/>.</returns>
+      public bool Equals(VssFileRange other)
+      {
+         return m_offset == other.m_offset && m_length == other.m_length;
+      }
+
+      /// <summary>
+      /// Determines whether the specified object is a <see cref="VssFileRange"/> equal to this instance.
+      /// </summary>
+      /// <param name="obj">The object to compare with.</param>
+      /// <returns><see langword="true"/> if <paramref name="obj"/> is an equal range; otherwise <see langword="false"/>.</returns>
+      public override bool Equals(object obj)
+      {
+         return obj is VssFileRange && Equals((VssFileRange)obj);
+      }
+
+      /// <summary>
+      /// Returns a hash code for this instance.
+      /// </summary>
+      /// <returns>A hash code for this instance.</returns>
+      public override int GetHashCode()
+      {
+         return m_offset.GetHashCode() * 31 + m_length.GetHashCode();
+      }
+
+      /// <summary>
+      /// Returns the range in the format used by the ranges of partial files.
+      /// </summary>
+      /// <returns>The offset and length of the range as hexadecimal numbers separated by a colon, e.g. <c>0x1000:0x200</c>.</returns>
+      public override string ToString()
+      {
+         return String.Format(CultureInfo.InvariantCulture, "0x{0:x}:0x{1:x}", m_offset, m_length);
+      }
+
+      /// <summary>
+      /// Determines whether two ranges are equal.
+      /// </summary>
+      /// <param name="left">The first range.</param>
+      /// <param name="right">The second range.</param>
+      /// <returns><see langword="true"/> if the ranges have the same offset and length; otherwise <see langword="false"/>.</returns>
+      public static bool operator ==(VssFileRange left, VssFileRange right)
+      {
+         return left.Equals(right);
+      }
+
+      /// <summary>
+      /// Determines whether two ranges are different.
+      /// </summary>
+      /// <param name="left">The first range.</param>
+      /// <param name="right">The second range.</param>
+      /// <returns><see langword="true"/> if the ranges differ in offset or length; otherwise <see langword="false"/>.</returns>
+      public static bool operator !=(VssFileRange left, VssFileRange right)
+      {
+         return !left.Equals(right);
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,628 @@
+
+using System;
+using System.Collections;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A normalized list of byte ranges in a file, i.e. sorted by offset with overlapping and adjacent ranges merged, as 
+   /// described by the <see cref="VssPartialFileInfo.Range"/> of a partial file or by a ranges file.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///     A range list is written as a comma separated list of ranges, each an offset and a length separated by a colon. 
+   ///     Numbers are hexadecimal if prefixed with <c>0x</c>, and decimal otherwise. A ranges file, as passed to 
+   ///     <see cref="IVssBackupComponents.SetRangesFilePath"/>, contains the number of ranges followed by the offset and length 
+   ///     of each range, all as little-endian 64-bit integers.
+   ///   </para>
+   ///   <para>
+   ///     Use <see cref="Coalesce"/> to plan the reads needed to back up the ranges, and <see cref="CopyTo"/> to copy the 
+   ///     ranges out of a file, typically the copy of the file in a snapshot, with as few reads as possible.
+   ///   </para>
+   /// </remarks>
+   [Serializable]
+   public sealed class VssFileRangeList : IReadOnlyList<VssFileRange>
+   {
+      #region Private Fields
+
+      private const int DefaultBufferSize = 1024 * 1024;
+
+      private static readonly VssFileRangeList s_empty = new VssFileRangeList(new VssFileRange[0]);
+
+      private readonly VssFileRange[] m_ranges;
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssFileRangeList"/> class containing the specified ranges.
+      /// </summary>
+      /// <param name="ranges">The ranges. They may be in any order, and may overlap.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="ranges"/> is <see langword="null"/>.</exception>
+      public VssFileRangeList(IEnumerable<VssFileRange> ranges)
+      {
+         if (ranges == null)
+            throw new ArgumentNullException(nameof(ranges));
+
+         List<long> offsets = new List<long>();
+         List<long> lengths = new List<long>();
+         foreach (VssFileRange range in ranges)
+         {
+            offsets.Add(range.Offset);
+            lengths.Add(range.Length);
+         }
+
+         m_ranges = Normalize(offsets.ToArray(), lengths.ToArray(), offsets.Count);
+      }
+
+      private VssFileRangeList(VssFileRange[] normalizedRanges)
+      {
+         m_ranges = normalizedRanges;
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets an empty range list.
+      /// </summary>
+      public static VssFileRangeList Empty
+      {
+         get
+         {
+            return s_empty;
+         }
+      }
+
+      /// <summary>
+      /// Gets the number of ranges in the list.
+      /// </summary>
+      public int Count
+      {
+         get
+         {
+            return m_ranges.Length;
+         }
+      }
+
+      /// <summary>
+      /// Gets the range at the specified index.
+      /// </summary>
+      /// <param name="index">The zero-based index of the range.</param>
+      /// <returns>The range at <paramref name="index"/>.</returns>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="index"/> is out of range.</exception>
+      public VssFileRange this[int index]
+      {
+         get
+         {
+            if (index < 0 || index >= m_ranges.Length)
+               throw new ArgumentOutOfRangeException(nameof(index));
+
+            return m_ranges[index];
+         }
+      }
+
+      /// <summary>
+      /// Gets the total number of bytes in the ranges of the list.
+      /// </summary>
+      public long TotalLength
+      {
+         get
+         {
+            long total = 0;
+            foreach (VssFileRange range in m_ranges)
+               total += range.Length;
+            return total;
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Parses a range list, such as the <see cref="VssPartialFileInfo.Range"/> of a partial file.
+      /// </summary>
+      /// <param name="ranges">The range list to parse. A <see langword="null"/> or blank string yields an empty list.</param>
+      /// <returns>The normalized ranges.</returns>
+      /// <exception cref="FormatException"><paramref name="ranges"/> is not a valid range list.</exception>
+      public static VssFileRangeList Parse(string ranges)
+      {
+         VssFileRangeList result;
+         string error = ParseCore(ranges, out result);
+         if (error != null)
+            throw new FormatException(error);
+
+         return result;
+      }
+
+      /// <summary>
+      /// Attempts to parse a range list, such as the <see cref="VssPartialFileInfo.Range"/> of a partial file.
+      /// </summary>
+      /// <param name="ranges">The range list to parse. A <see langword="null"/> or blank string yields an empty list.</param>
+      /// <param name="result">When this method returns, the normalized ranges if parsing succeeded; otherwise <see langword="null"/>.</param>
+      /// <returns><see langword="true"/> if <paramref name="ranges"/> is a valid range list; otherwise <see langword="false"/>.</returns>
+      public static bool TryParse(string ranges, out VssFileRangeList result)
+      {
+         return ParseCore(ranges, out result) == null;
+      }
+
+      /// <summary>
+      /// Reads the ranges from a ranges file.
+      /// </summary>
+      /// <param name="stream">The stream to read the ranges file from.</param>
+      /// <returns>The normalized ranges.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="stream"/> is <see langword="null"/>.</exception>
+      /// <exception cref="InvalidDataException">The stream does not contain a valid ranges file.</exception>
+      public static VssFileRangeList ReadRangesFile(Stream stream)
+      {
+         if (stream == null)
+            throw new ArgumentNullException(nameof(stream));
+
+         using (BinaryReader reader = new BinaryReader(stream, Encoding.UTF8, true))
+         {
+            try
+            {
+               ulong count = reader.ReadUInt64();
+               if (count > Int32.MaxValue || (stream.CanSeek && count > (ulong)(stream.Length - stream.Position) / 16))
+                  throw new InvalidDataException("The ranges file is truncated or contains an invalid number of ranges.");
+
+               long[] offsets = new long[count];
+               long[] lengths = new long[count];
+               for (int i = 0; i < offsets.Length; i++)
+               {
+                  offsets[i] = reader.ReadInt64();
+                  lengths[i] = reader.ReadInt64();
+                  if (offsets[i] < 0 || lengths[i] < 0 || lengths[i] > Int64.MaxValue - offsets[i])
+                     throw new InvalidDataException("The ranges file contains a range beyond the largest possible offset.");
+               }
+
+               return new VssFileRangeList(Normalize(offsets, lengths, offsets.Length));
+            }
+            catch (EndOfStreamException ex)
+            {
+               throw new InvalidDataException("The ranges file is truncated.", ex);
+            }
+         }
+      }
+
+      /// <summary>
+      /// Reads the ranges from the specified ranges file.
+      /// </summary>
+      /// <param name="path">The path of the ranges file.</param>
+      /// <returns>The normalized ranges.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="path"/> is <see langword="null"/>.</exception>
+      /// <exception cref="InvalidDataException">The file is not a valid ranges file.</exception>
+      public static VssFileRangeList ReadRangesFile(string path)
+      {
+         if (path == null)
+            throw new ArgumentNullException(nameof(path));
+
+         using (FileStream stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, 64 * 1024, FileOptions.SequentialScan))
+         {
+            return ReadRangesFile(stream);
+         }
+      }
+
+      /// <summary>
+      /// Writes the ranges to a stream in the format of a ranges file.
+      /// </summary>
+      /// <param name="stream">The stream to write the ranges file to.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="stream"/> is <see langword="null"/>.</exception>
+      public void WriteRangesFile(Stream stream)
+      {
+         if (stream == null)
+            throw new ArgumentNullException(nameof(stream));
+
+         using (BinaryWriter writer = new BinaryWriter(stream, Encoding.UTF8, true))
+         {
+            writer.Write((ulong)m_ranges.Length);
+            foreach (VssFileRange range in m_ranges)
+            {
+               writer.Write(range.Offset);
+               writer.Write(range.Length);
+            }
+         }
+      }
+
+      /// <summary>
+      /// Merges ranges separated by at most the specified number of bytes into the larger ranges that should be read to copy them.
+      /// </summary>
+      /// <param name="maxGap">
+      ///   The largest number of unneeded bytes between two ranges that are read rather than skipped. Reading a small gap is 
+      ///   usually cheaper than issuing another read.
+      /// </param>
+      /// <returns>The ranges to read, in ascending order.</returns>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="maxGap"/> is negative.</exception>
+      public IList<VssFileRange> Coalesce(long maxGap)
+      {
+         if (maxGap < 0)
+            throw new ArgumentOutOfRangeException(nameof(maxGap), "The gap must not be negative.");
+
+         List<VssFileRange> reads = new List<VssFileRange>();
+         int i = 0;
+         while (i < m_ranges.Length)
+         {
+            int last = FindSpanEnd(i, maxGap);
+            reads.Add(new VssFileRange(m_ranges[i].Offset, m_ranges[last].End - m_ranges[i].Offset));
+            i = last + 1;
+         }
+
+         return reads.AsReadOnly();
+      }
+
+      /// <summary>
+      /// Copies the bytes in the ranges of the list from a file to a stream, in ascending order of offset.
+      /// </summary>
+      /// <param name="source">The file to copy the ranges of. Must be seekable.</param>
+      /// <param name="destination">The stream to write the bytes of the ranges to.</param>
+      /// <param name="maxGap">The largest number of unneeded bytes between two ranges that are read rather than skipped. See <see cref="Coalesce"/>.</param>
+      /// <returns>The number of bytes written to <paramref name="destination"/>, i.e. <see cref="TotalLength"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="source"/> or <paramref name="destination"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="source"/> is not seekable.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="maxGap"/> is negative.</exception>
+      /// <exception cref="EndOfStreamException"><paramref name="source"/> ends before the last range.</exception>
+      public long CopyTo(Stream source, Stream destination, long maxGap)
+      {
+         CheckCopyArguments(source, destination, maxGap);
+
+         CopyCursor cursor = new CopyCursor(this, maxGap);
+         while (cursor.NextRead())
+         {
+            source.Position = cursor.ReadOffset;
+            int read = 0;
+            int chunk;
+            while (read < cursor.ReadLength && (chunk = source.Read(cursor.Buffer, read, cursor.ReadLength - read)) > 0)
+               read += chunk;
+
+            int start;
+            int count;
+            while (cursor.NextWrite(read, out start, out count))
+               destination.Write(cursor.Buffer, start, count);
+         }
+
+         return cursor.BytesWritten;
+      }
+
+      /// <summary>
+      /// Asynchronously copies the bytes in the ranges of the list from a file to a stream, in ascending order of offset.
+      /// </summary>
+      /// <param name="source">The file to copy the ranges of. Must be seekable.</param>
+      /// <param name="destination">The stream to write the bytes of the ranges to.</param>
+      /// <param name="maxGap">The largest number of unneeded bytes between two ranges that are read rather than skipped. See <see cref="Coalesce"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests.</param>
+      /// <returns>A task whose result is the number of bytes written to <paramref name="destination"/>, i.e. <see cref="TotalLength"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="source"/> or <paramref name="destination"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="source"/> is not seekable.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="maxGap"/> is negative.</exception>
+      /// <exception cref="EndOfStreamException"><paramref name="source"/> ends before the last range.</exception>
+      public async Task<long> CopyToAsync(Stream source, Stream destination, long maxGap, CancellationToken cancellationToken = default)
+      {
+         CheckCopyArguments(source, destination, maxGap);
+
+         CopyCursor cursor = new CopyCursor(this, maxGap);
+         while (cursor.NextRead())
+         {
+            source.Position = cursor.ReadOffset;
+            int read = 0;
+            int chunk;
+            while (read < cursor.ReadLength && (chunk = await source.ReadAsync(cursor.Buffer, read, cursor.ReadLength - read, cancellationToken).ConfigureAwait(false)) > 0)
+               read += chunk;
+
+            int start;
+            int count;
+            while (cursor.NextWrite(read, out start, out count))
+               await destination.WriteAsync(cursor.Buffer, start, count, cancellationToken).ConfigureAwait(false);
+         }
+
+         return cursor.BytesWritten;
+      }
+
+      /// <summary>
+      /// Returns an enumerator that iterates through the ranges of the list.
+      /// </summary>
+      /// <returns>An enumerator for the ranges of the list.</returns>
+      public IEnumerator<VssFileRange> GetEnumerator()
+      {
+         return ((IEnumerable<VssFileRange>)m_ranges).GetEnumerator();
+      }
+
+      IEnumerator IEnumerable.GetEnumerator()
+      {
+         return GetEnumerator();
+      }
+
+      /// <summary>
+      /// Returns the range list in the format used by the ranges of partial files.
+      /// </summary>
+      /// <returns>The ranges of the list separated by commas, e.g. <c>0x0:0x1000,0x4000:0x200</c>.</returns>
+      public override string ToString()
+      {
+         StringBuilder builder = new StringBuilder(m_ranges.Length * 16);
+         for (int i = 0; i < m_ranges.Length; i++)
+         {
+            if (i > 0)
+               builder.Append(',');
+            builder.Append(m_ranges[i].ToString());
+         }
+
+         return builder.ToString();
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      // Returns null on success, and the reason parsing failed otherwise.
+      private static string ParseCore(string ranges, out VssFileRangeList result)
+      {
+         result = null;
+         if (ranges == null)
+         {
+            result = s_empty;
+            return null;
+         }
+
+         // A range takes at least four characters, e.g. "0:1,", which bounds the number of ranges in the string.
+         int capacity = Math.Min(ranges.Length / 4 + 1, 1024);
+         long[] offsets = new long[capacity];
+         long[] lengths = new long[capacity];
+         int count = 0;
+
+         int position = SkipWhiteSpace(ranges, 0);
+         if (position == ranges.Length)
+         {
+            result = s_empty;
+            return null;
+         }
+
+         while (true)
+         {
+            long offset;
+            long length;
+            if (!TryParseNumber(ranges, ref position, out offset))
+               return "The range list contains an invalid offset at position " + position + ".";
+
+            position = SkipWhiteSpace(ranges, position);
+            if (position == ranges.Length || ranges[position] != ':')
+               return "The range list is missing a colon at position " + position + ".";
+
+            position = SkipWhiteSpace(ranges, position + 1);
+            if (!TryParseNumber(ranges, ref position, out length))
+               return "The range list contains an invalid length at position " + position + ".";
+
+            if (length > Int64.MaxValue - offset)
+               return "The range list contains a range beyond the largest possible offset.";
+
+            if (count == offsets.Length)
+            {
+               Array.Resize(ref offsets, count * 2);
+               Array.Resize(ref lengths, count * 2);
+            }
+
+            offsets[count] = offset;
+            lengths[count] = length;
+            count++;
+
+            position = SkipWhiteSpace(ranges, position);
+            if (position == ranges.Length)
+               break;
+
+            if (ranges[position] != ',')
+               return "The range list is missing a comma at position " + position + ".";
+
+            position = SkipWhiteSpace(ranges, position + 1);
+         }
+
+         result = new VssFileRangeList(Normalize(offsets, lengths, count));
+         return null;
+      }
+
+      private static int SkipWhiteSpace(string text, int position)
+      {
+         while (position < text.Length && Char.IsWhiteSpace(text[position]))
+            position++;
+         return position;
+      }
+
+      private static bool TryParseNumber(string text, ref int position, out long value)
+      {
+         value = 0;
+         int start = position;
+         ulong result = 0;
+         if (position + 1 < text.Length && text[position] == '0' && (text[position + 1] == 'x' || text[position + 1] == 'X'))
+         {
+            position += 2;
+            start = position;
+            for (; position < text.Length; position++)
+            {
+               char c = text[position];
+               uint digit;
+               if (c >= '0' && c <= '9')
+                  digit = (uint)(c - '0');
+               else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+                  digit = (uint)((c | 0x20) - 'a' + 10);
+               else
+                  break;
+
+               if (result > (UInt64.MaxValue >> 4))
+                  return false;
+
+               result = (result << 4) | digit;
+            }
+         }
+         else
+         {
+            for (; position < text.Length; position++)
+            {
+               uint digit = (uint)(text[position] - '0');
+               if (digit > 9)
+                  break;
+
+               if (result > (UInt64.MaxValue - digit) / 10)
+                  return false;
+
+               result = result * 10 + digit;
+            }
+         }
+
+         if (position == start || result > Int64.MaxValue)
+            return false;
+
+         value = (long)result;
+         return true;
+      }
+
+      private static VssFileRange[] Normalize(long[] offsets, long[] lengths, int count)
+      {
+         // Ranges are usually listed in ascending order already, in which case sorting is skipped.
+         bool sorted = true;
+         for (int i = 1; i < count && sorted; i++)
+            sorted = offsets[i - 1] <= offsets[i];
+
+         if (!sorted)
+            Array.Sort(offsets, lengths, 0, count);
+
+         List<VssFileRange> ranges = new List<VssFileRange>(count);
+         int current = -1;
+         long currentEnd = 0;
+         for (int i = 0; i < count; i++)
+         {
+            if (lengths[i] == 0)
+               continue;
+
+            long end = offsets[i] + lengths[i];
+            if (current >= 0 && offsets[i] <= currentEnd)
+            {
+               currentEnd = Math.Max(currentEnd, end);
+            }
+            else
+            {
+               if (current >= 0)
+                  ranges.Add(new VssFileRange(offsets[current], currentEnd - offsets[current]));
+
+               current = i;
+               currentEnd = end;
+            }
+         }
+
+         if (current >= 0)
+            ranges.Add(new VssFileRange(offsets[current], currentEnd - offsets[current]));
+
+         return ranges.ToArray();
+      }
+
+      private int FindSpanEnd(int first, long maxGap)
+      {
+         int last = first;
+         while (last + 1 < m_ranges.Length && m_ranges[last + 1].Offset - m_ranges[last].End <= maxGap)
+            last++;
+         return last;
+      }
+
+      private static void CheckCopyArguments(Stream source, Stream destination, long maxGap)
+      {
+         if (source == null)
+            throw new ArgumentNullException(nameof(source));
+
+         if (destination == null)
+            throw new ArgumentNullException(nameof(destination));
+
+         if (!source.CanSeek)
+            throw new ArgumentException("The source stream must be seekable.", nameof(source));
+
+         if (maxGap < 0)
+            throw new ArgumentOutOfRangeException(nameof(maxGap), "The gap must not be negative.");
+      }
+
+      #endregion
+
+      #region Nested Types
+
+      // Tracks the progress of copying the ranges of a list, shared by the synchronous and asynchronous copy. Coalesced 
+      // spans are read in windows of at most the buffer size, and the parts of each window covered by ranges are written.
+      private sealed class CopyCursor
+      {
+         private readonly VssFileRangeList m_list;
+         private readonly long m_maxGap;
+         private int m_range;
+         private int m_spanLast = -1;
+         private long m_spanEnd;
+         private long m_next;
+
+         public CopyCursor(VssFileRangeList list, long maxGap)
+         {
+            m_list = list;
+            m_maxGap = maxGap;
+
+            long largestSpan = 0;
+            for (int i = 0; i < list.m_ranges.Length; i = m_spanLast + 1)
+            {
+               m_spanLast = list.FindSpanEnd(i, maxGap);
+               largestSpan = Math.Max(largestSpan, list.m_ranges[m_spanLast].End - list.m_ranges[i].Offset);
+            }
+
+            m_spanLast = -1;
+            if (list.m_ranges.Length > 0)
+               m_next = list.m_ranges[0].Offset;
+
+            Buffer = new byte[Math.Max(1, Math.Min(largestSpan, DefaultBufferSize))];
+         }
+
+         public byte[] Buffer { get; private set; }
+         public long ReadOffset { get; private set; }
+         public int ReadLength { get; private set; }
+         public long BytesWritten { get; private set; }
+
+         public bool NextRead()
+         {
+            VssFileRange[] ranges = m_list.m_ranges;
+            if (m_range >= ranges.Length)
+               return false;
+
+            if (m_range > m_spanLast)
+            {
+               m_spanLast = m_list.FindSpanEnd(m_range, m_maxGap);
+               m_spanEnd = ranges[m_spanLast].End;
+            }
+
+            // The window starts at the next byte needed, skipping any gap that was not covered by the previous window.
+            ReadOffset = m_next;
+            ReadLength = (int)Math.Min(Buffer.Length, m_spanEnd - ReadOffset);
+            return true;
+         }
+
+         public bool NextWrite(int bytesRead, out int start, out int count)
+         {
+            start = count = 0;
+            VssFileRange[] ranges = m_list.m_ranges;
+            long windowEnd = ReadOffset + ReadLength;
+            if (m_range > m_spanLast || m_range >= ranges.Length || m_next >= windowEnd)
+               return false;
+
+            VssFileRange range = ranges[m_range];
+            long to = Math.Min(range.End, windowEnd);
+            if (ReadOffset + bytesRead < to)
+               throw new EndOfStreamException("The source stream ends before the end of the range " + range.ToString() + ".");
+
+            start = (int)(m_next - ReadOffset);
+            count = (int)(to - m_next);
+            BytesWritten += count;
+            m_next = to;
+            if (to == range.End && ++m_range < ranges.Length)
+               m_next = ranges[m_range].Offset;
+
+            return true;
+         }
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,55 @@
+
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A file descriptor of a Writer Metadata Document that matches a path, as reported by <see cref="VssFileSpecificationMatcher"/>.
+   /// </summary>
+   public sealed class VssFileSpecificationMatch
+   {
+      internal VssFileSpecificationMatch(IVssExamineWriterMetadata writer, IVssWMComponent component, VssWMFileDescriptor descriptor, VssFileSpecificationRole role)
+      {
+         Writer = writer;
+         Component = component;
+         Descriptor = descriptor;
+         Role = role;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the writer metadata the descriptor belongs to.
+      /// </summary>
+      public IVssExamineWriterMetadata Writer { get; private set; }
+
+      /// <summary>
+      /// Gets the component owning the descriptor, or <see langword="null"/> for the exclusions of a writer.
+      /// </summary>
+      public IVssWMComponent Component { get; private set; }
+
+      /// <summary>
+      /// Gets the matching file descriptor.
+      /// </summary>
+      public VssWMFileDescriptor Descriptor { get; private set; }
+
+      /// <summary>
+      /// Gets the list of the Writer Metadata Document the descriptor was taken from.
+      /// </summary>
+      public VssFileSpecificationRole Role { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the descriptor excludes the matching files from the backup, i.e. whether 
+      /// <see cref="Role"/> is <see cref="VssFileSpecificationRole.ExcludeFile"/> or <see cref="VssFileSpecificationRole.ExcludeFromSnapshotFile"/>.
+      /// </summary>
+      public bool IsExclusion
+      {
+         get
+         {
+            return Role == VssFileSpecificationRole.ExcludeFile || Role == VssFileSpecificationRole.ExcludeFromSnapshotFile;
+         }
+      }
+
+      #endregion
+   }
+}
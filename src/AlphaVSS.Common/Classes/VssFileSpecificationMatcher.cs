@@ -0,0 +1,506 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Classifies file paths against all file descriptors of one or more Writer Metadata Documents at once, to find the 
+   /// components that own a file and the exclusions that apply to it.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///     The matcher is built once from the <see cref="IVssWMComponent.Files"/>, <see cref="IVssWMComponent.DatabaseFiles"/>, 
+   ///     <see cref="IVssWMComponent.DatabaseLogFiles"/>, <see cref="IVssExamineWriterMetadata.ExcludeFiles"/> and 
+   ///     <see cref="IVssExamineWriterMetadata.ExcludeFromSnapshotFiles"/> of the writers. Descriptor paths are indexed in a 
+   ///     tree of directories, and the file specifications of each directory are indexed by exact name and by extension, so the 
+   ///     cost of classifying a path depends on its depth rather than on the number of descriptors. Classifying a path does not 
+   ///     allocate, other than when adding to the caller's collection.
+   ///   </para>
+   ///   <para>
+   ///     Paths are compared case-insensitively, environment variables in descriptor paths are expanded when the matcher is built, 
+   ///     and both <c>\</c> and <c>/</c> are accepted as separators. Like in Windows, the file specification <c>*.*</c> matches 
+   ///     every file name, including names without an extension. A descriptor matches the files in its directory, and if it is 
+   ///     recursive, the files in all subdirectories.
+   ///   </para>
+   ///   <para>
+   ///     A matcher is immutable once built, and may be used by multiple threads concurrently.
+   ///   </para>
+   /// </remarks>
+   public sealed class VssFileSpecificationMatcher
+   {
+      #region Private Fields
+
+      private static readonly SegmentComparer s_comparer = new SegmentComparer();
+
+      [ThreadStatic]
+      private static List<VssFileSpecificationMatch> t_matches;
+
+      private readonly Node m_root = new Node();
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssFileSpecificationMatcher"/> class from the file descriptors of the specified writers.
+      /// </summary>
+      /// <param name="writers">The writer metadata to build the matcher from.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="writers"/> is <see langword="null"/>.</exception>
+      public VssFileSpecificationMatcher(IEnumerable<IVssExamineWriterMetadata> writers)
+      {
+         if (writers == null)
+            throw new ArgumentNullException(nameof(writers));
+
+         foreach (IVssExamineWriterMetadata writer in writers)
+         {
+            if (writer == null)
+               throw new ArgumentException("The sequence contains a null element.", nameof(writers));
+
+            foreach (IVssWMComponent component in writer.Components)
+            {
+               Add(writer, component, component.Files, VssFileSpecificationRole.File);
+               Add(writer, component, component.DatabaseFiles, VssFileSpecificationRole.DatabaseFile);
+               Add(writer, component, component.DatabaseLogFiles, VssFileSpecificationRole.DatabaseLogFile);
+            }
+
+            Add(writer, null, writer.ExcludeFiles, VssFileSpecificationRole.ExcludeFile);
+
+            IList<VssWMFileDescriptor> excludeFromSnapshotFiles = null;
+            try
+            {
+               excludeFromSnapshotFiles = writer.ExcludeFromSnapshotFiles;
+            }
+            catch (UnsupportedOperatingSystemException)
+            {
+            }
+
+            if (excludeFromSnapshotFiles != null)
+               Add(writer, null, excludeFromSnapshotFiles, VssFileSpecificationRole.ExcludeFromSnapshotFile);
+         }
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the number of file descriptors the matcher was built from.
+      /// </summary>
+      public int DescriptorCount { get; private set; }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Finds the file descriptors matching the specified file path.
+      /// </summary>
+      /// <param name="path">The full path of the file.</param>
+      /// <returns>A list of the matching file descriptors, ordered from the least to the most specific directory. The list is empty if no descriptor matches.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="path"/> is <see langword="null"/>.</exception>
+      public IList<VssFileSpecificationMatch> Classify(string path)
+      {
+         List<VssFileSpecificationMatch> matches = new List<VssFileSpecificationMatch>();
+         Classify(path, matches);
+         return matches;
+      }
+
+      /// <summary>
+      /// Finds the file descriptors matching the specified file path, adding them to the specified collection.
+      /// </summary>
+      /// <param name="path">The full path of the file.</param>
+      /// <param name="matches">The collection to add the matching file descriptors to, ordered from the least to the most specific directory.</param>
+      /// <returns>The number of matching file descriptors.</returns>
+      /// <remarks>This overload allows a single collection to be reused for every file of a scan.</remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="path"/> or <paramref name="matches"/> is <see langword="null"/>.</exception>
+      public int Classify(string path, ICollection<VssFileSpecificationMatch> matches)
+      {
+         if (path == null)
+            throw new ArgumentNullException(nameof(path));
+
+         if (matches == null)
+            throw new ArgumentNullException(nameof(matches));
+
+         int start = SkipPrefix(path);
+         int nameStart = path.Length;
+         while (nameStart > start && !IsSeparator(path[nameStart - 1]))
+            nameStart--;
+
+         Segment name = new Segment(path, nameStart, path.Length - nameStart);
+         int count = 0;
+         Node node = m_root;
+         int position = start;
+         while (true)
+         {
+            int end = position;
+            while (end < nameStart && !IsSeparator(path[end]))
+               end++;
+
+            // Skip empty segments, such as the leading separators of a UNC path.
+            if (end == position)
+            {
+               if (end >= nameStart)
+                  return count + node.Rules.Match(name, false, matches);
+
+               position = end + 1;
+               continue;
+            }
+
+            if (node.HasRecursiveRules)
+               count += node.Rules.Match(name, true, matches);
+
+            Node child;
+            if (node.Children == null || !node.Children.TryGetValue(new Segment(path, position, end - position), out child))
+               return count;
+
+            node = child;
+            position = end + 1;
+         }
+      }
+
+      /// <summary>
+      /// Determines whether the specified file is excluded from the backup by any writer, through the 
+      /// <see cref="IVssExamineWriterMetadata.ExcludeFiles"/> or <see cref="IVssExamineWriterMetadata.ExcludeFromSnapshotFiles"/> 
+      /// of its metadata.
+      /// </summary>
+      /// <param name="path">The full path of the file.</param>
+      /// <returns><see langword="true"/> if the file is excluded; otherwise <see langword="false"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="path"/> is <see langword="null"/>.</exception>
+      public bool IsExcluded(string path)
+      {
+         List<VssFileSpecificationMatch> matches = t_matches ?? (t_matches = new List<VssFileSpecificationMatch>());
+         try
+         {
+            Classify(path, matches);
+            for (int i = 0; i < matches.Count; i++)
+            {
+               if (matches[i].IsExclusion)
+                  return true;
+            }
+
+            return false;
+         }
+         finally
+         {
+            matches.Clear();
+         }
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private void Add(IVssExamineWriterMetadata writer, IVssWMComponent component, IList<VssWMFileDescriptor> descriptors, VssFileSpecificationRole role)
+      {
+         foreach (VssWMFileDescriptor descriptor in descriptors)
+         {
+            string path = Environment.ExpandEnvironmentVariables(descriptor.Path ?? String.Empty);
+            Node node = m_root;
+            int position = SkipPrefix(path);
+            while (position < path.Length)
+            {
+               int end = position;
+               while (end < path.Length && !IsSeparator(path[end]))
+                  end++;
+
+               if (end > position)
+               {
+                  Segment segment = new Segment(path, position, end - position);
+                  if (node.Children == null)
+                     node.Children = new Dictionary<Segment, Node>(s_comparer);
+
+                  Node child;
+                  if (!node.Children.TryGetValue(segment, out child))
+                  {
+                     child = new Node();
+                     node.Children.Add(segment, child);
+                  }
+
+                  node = child;
+               }
+
+               position = end + 1;
+            }
+
+            node.Rules.Add(new Rule(new VssFileSpecificationMatch(writer, component, descriptor, role), descriptor.FileSpecification, descriptor.IsRecursive));
+            node.HasRecursiveRules |= descriptor.IsRecursive;
+            DescriptorCount++;
+         }
+      }
+
+      // Creates a predicate testing file names against a single file specification, using the same matching rules as 
+      // the matcher itself.
+      internal static Func<string, bool> CreateNameMatcher(string fileSpecification)
+      {
+         Rule rule = new Rule(null, fileSpecification, false);
+         return name => rule.IsMatch(new Segment(name));
+      }
+
+      private static bool IsSeparator(char c)
+      {
+         return c == '\\' || c == '/';
+      }
+
+      private static int SkipPrefix(string path)
+      {
+         // Extended-length paths (\\?\C:\...) are compared as the corresponding normal paths.
+         return path.StartsWith(@"\\?\", StringComparison.Ordinal) ? 4 : 0;
+      }
+
+      #endregion
+
+      #region Nested Types
+
+      private struct Segment
+      {
+         public readonly string Text;
+         public readonly int Start;
+         public readonly int Length;
+
+         public Segment(string text, int start, int length)
+         {
+            Text = text;
+            Start = start;
+            Length = length;
+         }
+
+         public Segment(string text)
+            : this(text, 0, text.Length)
+         {
+         }
+
+         public char this[int index]
+         {
+            get
+            {
+               return Text[Start + index];
+            }
+         }
+
+         public bool EndsWith(string value)
+         {
+            return Length >= value.Length && String.Compare(Text, Start + Length - value.Length, value, 0, value.Length, StringComparison.OrdinalIgnoreCase) == 0;
+         }
+
+         public bool StartsWith(string value)
+         {
+            return Length >= value.Length && String.Compare(Text, Start, value, 0, value.Length, StringComparison.OrdinalIgnoreCase) == 0;
+         }
+
+         public Segment GetExtension()
+         {
+            for (int i = Length - 1; i >= 0; i--)
+            {
+               if (this[i] == '.')
+                  return new Segment(Text, Start + i, Length - i);
+            }
+
+            return new Segment(Text, Start + Length, 0);
+         }
+      }
+
+      private sealed class SegmentComparer : IEqualityComparer<Segment>
+      {
+         public bool Equals(Segment x, Segment y)
+         {
+            return x.Length == y.Length && String.Compare(x.Text, x.Start, y.Text, y.Start, x.Length, StringComparison.OrdinalIgnoreCase) == 0;
+         }
+
+         public int GetHashCode(Segment obj)
+         {
+            int hash = 17;
+            for (int i = 0; i < obj.Length; i++)
+               hash = hash * 31 + Char.ToUpperInvariant(obj[i]);
+            return hash;
+         }
+      }
+
+      private enum PatternKind
+      {
+         All,
+         Exact,
+         Prefix,
+         Suffix,
+         Wildcard
+      }
+
+      private sealed class Rule
+      {
+         public Rule(VssFileSpecificationMatch match, string fileSpecification, bool isRecursive)
+         {
+            Match = match;
+            IsRecursive = isRecursive;
+
+            string pattern = String.IsNullOrEmpty(fileSpecification) || fileSpecification == "*.*" ? "*" : fileSpecification;
+            int wildcard = pattern.IndexOfAny(new[] { '*', '?' });
+            if (wildcard < 0)
+            {
+               Kind = PatternKind.Exact;
+               Literal = pattern;
+            }
+            else if (pattern == "*")
+            {
+               Kind = PatternKind.All;
+            }
+            else if (wildcard == 0 && pattern[0] == '*' && pattern.IndexOfAny(new[] { '*', '?' }, 1) < 0)
+            {
+               Kind = PatternKind.Suffix;
+               Literal = pattern.Substring(1);
+            }
+            else if (wildcard == pattern.Length - 1 && pattern[wildcard] == '*')
+            {
+               Kind = PatternKind.Prefix;
+               Literal = pattern.Substring(0, wildcard);
+            }
+            else
+            {
+               Kind = PatternKind.Wildcard;
+               Literal = pattern;
+            }
+         }
+
+         public VssFileSpecificationMatch Match { get; private set; }
+         public bool IsRecursive { get; private set; }
+         public PatternKind Kind { get; private set; }
+         public string Literal { get; private set; }
+
+         public bool IsMatch(Segment name)
+         {
+            switch (Kind)
+            {
+               case PatternKind.All:
+                  return true;
+               case PatternKind.Exact:
+                  return name.Length == Literal.Length && name.StartsWith(Literal);
+               case PatternKind.Prefix:
+                  return name.StartsWith(Literal);
+               case PatternKind.Suffix:
+                  return name.EndsWith(Literal);
+               default:
+                  return IsWildcardMatch(Literal, name);
+            }
+         }
+
+         private static bool IsWildcardMatch(string pattern, Segment name)
+         {
+            // Greedy matching with backtracking to the last '*', which is linear for the patterns seen in practice.
+            int p = 0, n = 0, star = -1, mark = 0;
+            while (n < name.Length)
+            {
+               if (p < pattern.Length && (pattern[p] == '?' || Char.ToUpperInvariant(pattern[p]) == Char.ToUpperInvariant(name[n])))
+               {
+                  p++;
+                  n++;
+               }
+               else if (p < pattern.Length && pattern[p] == '*')
+               {
+                  star = p++;
+                  mark = n;
+               }
+               else if (star >= 0)
+               {
+                  p = star + 1;
+                  n = ++mark;
+               }
+               else
+               {
+                  return false;
+               }
+            }
+
+            while (p < pattern.Length && pattern[p] == '*')
+               p++;
+
+            return p == pattern.Length;
+         }
+      }
+
+      private sealed class RuleSet
+      {
+         // Exact names and simple extensions (*.ext) are looked up by hash; all other patterns are tested in turn.
+         private Dictionary<Segment, List<Rule>> m_byName;
+         private Dictionary<Segment, List<Rule>> m_byExtension;
+         private List<Rule> m_others;
+
+         public void Add(Rule rule)
+         {
+            if (rule.Kind == PatternKind.Exact)
+            {
+               AddTo(ref m_byName, new Segment(rule.Literal), rule);
+            }
+            else if (rule.Kind == PatternKind.Suffix && rule.Literal.LastIndexOf('.') == 0)
+            {
+               AddTo(ref m_byExtension, new Segment(rule.Literal), rule);
+            }
+            else
+            {
+               if (m_others == null)
+                  m_others = new List<Rule>();
+               m_others.Add(rule);
+            }
+         }
+
+         public int Match(Segment name, bool recursiveOnly, ICollection<VssFileSpecificationMatch> matches)
+         {
+            int count = 0;
+            List<Rule> rules;
+            if (m_byName != null && m_byName.TryGetValue(name, out rules))
+               count += Match(rules, name, recursiveOnly, matches);
+
+            if (m_byExtension != null && m_byExtension.TryGetValue(name.GetExtension(), out rules))
+               count += Match(rules, name, recursiveOnly, matches);
+
+            if (m_others != null)
+               count += Match(m_others, name, recursiveOnly, matches);
+
+            return count;
+         }
+
+         private static int Match(List<Rule> rules, Segment name, bool recursiveOnly, ICollection<VssFileSpecificationMatch> matches)
+         {
+            int count = 0;
+            for (int i = 0; i < rules.Count; i++)
+            {
+               Rule rule = rules[i];
+               if ((!recursiveOnly || rule.IsRecursive) && rule.IsMatch(name))
+               {
+                  matches.Add(rule.Match);
+                  count++;
+               }
+            }
+
+            return count;
+         }
+
+         private static void AddTo(ref Dictionary<Segment, List<Rule>> index, Segment key, Rule rule)
+         {
+            if (index == null)
+               index = new Dictionary<Segment, List<Rule>>(s_comparer);
+
+            List<Rule> rules;
+            if (!index.TryGetValue(key, out rules))
+            {
+               rules = new List<Rule>();
+               index.Add(key, rules);
+            }
+
+            rules.Add(rule);
+         }
+      }
+
+      private sealed class Node
+      {
+         public Node()
+         {
+            Rules = new RuleSet();
+         }
+
+         public Dictionary<Segment, Node> Children;
+         public RuleSet Rules { get; private set; }
+         public bool HasRecursiveRules;
+      }
+
+      #endregion
+   }
+}
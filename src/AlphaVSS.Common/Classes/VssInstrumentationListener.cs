@@ -0,0 +1,206 @@
+
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Diagnostics.Tracing;
+using System.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// An in-process <see cref="EventListener"/> aggregating the events of the <see cref="VssEventSource"/> into latency histograms.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///      Creating an instance of this class enables the <see cref="VssEventSource"/>, and thereby the timing of VSS operations, for
+   ///      as long as the instance is not disposed. Phases and COM calls are aggregated by name across all backup components objects
+   ///      in the process.
+   ///   </para>
+   ///   <para>
+   ///      All members of this class are thread-safe.
+   ///   </para>
+   /// </remarks>
+   public sealed class VssInstrumentationListener : EventListener
+   {
+      #region Private Fields
+
+      private readonly ConcurrentDictionary<string, VssLatencyHistogram> m_phases = new ConcurrentDictionary<string, VssLatencyHistogram>(StringComparer.Ordinal);
+      private readonly ConcurrentDictionary<string, VssLatencyHistogram> m_comCalls = new ConcurrentDictionary<string, VssLatencyHistogram>(StringComparer.Ordinal);
+      private readonly ConcurrentDictionary<KeyValuePair<string, int>, long> m_results = new ConcurrentDictionary<KeyValuePair<string, int>, long>();
+      private readonly object m_writerCountLock = new object();
+      private readonly bool m_includeComCalls;
+      private int m_writerMetadataCount = -1;
+      private int m_writerStatusCount = -1;
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssInstrumentationListener"/> class, recording phases, COM calls and writer counts.
+      /// </summary>
+      public VssInstrumentationListener()
+         : this(true)
+      {
+      }
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssInstrumentationListener"/> class.
+      /// </summary>
+      /// <param name="includeComCalls">If set to <see langword="true"/>, the latency of every individual COM call is recorded in addition to
+      /// phases and writer counts.</param>
+      public VssInstrumentationListener(bool includeComCalls)
+      {
+         m_includeComCalls = includeComCalls;
+
+         // OnEventSourceCreated is invoked from the base class constructor, before m_includeComCalls has been assigned,
+         // so the source is (re-)enabled with the requested keywords here.
+         EnableEvents(VssEventSource.Log, includeComCalls ? EventLevel.Verbose : EventLevel.Informational, GetKeywords(includeComCalls));
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Gets the latency histograms of the phases observed so far, keyed by phase name (e.g. <c>DoSnapshotSet</c>).
+      /// </summary>
+      /// <returns>A snapshot of the phases observed so far. The histograms themselves continue to be updated.</returns>
+      public IReadOnlyDictionary<string, VssLatencyHistogram> GetPhaseLatencies()
+      {
+         return new Dictionary<string, VssLatencyHistogram>(m_phases, StringComparer.Ordinal);
+      }
+
+      /// <summary>
+      /// Gets the latency histograms of the COM calls observed so far, keyed by the name of the AlphaVSS method issuing the call.
+      /// </summary>
+      /// <returns>A snapshot of the COM calls observed so far. The histograms themselves continue to be updated.</returns>
+      public IReadOnlyDictionary<string, VssLatencyHistogram> GetComCallLatencies()
+      {
+         return new Dictionary<string, VssLatencyHistogram>(m_comCalls, StringComparer.Ordinal);
+      }
+
+      /// <summary>
+      /// Gets the number of times each result was observed for the specified phase or COM call.
+      /// </summary>
+      /// <param name="name">The name of a phase or of a method issuing COM calls.</param>
+      /// <returns>The number of occurrences of each result, keyed by result.</returns>
+      public IReadOnlyDictionary<VssError, long> GetResultCounts(string name)
+      {
+         if (name == null)
+            throw new ArgumentNullException(nameof(name));
+
+         return m_results.Where(entry => entry.Key.Key == name).ToDictionary(entry => (VssError)entry.Key.Value, entry => entry.Value);
+      }
+
+      /// <summary>
+      /// Discards everything recorded so far.
+      /// </summary>
+      public void Reset()
+      {
+         m_phases.Clear();
+         m_comCalls.Clear();
+         m_results.Clear();
+         lock (m_writerCountLock)
+         {
+            m_writerMetadataCount = -1;
+            m_writerStatusCount = -1;
+         }
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the most recently reported number of writers that reported metadata, or <c>-1</c> if no count has been reported.
+      /// </summary>
+      public int WriterMetadataCount
+      {
+         get
+         {
+            lock (m_writerCountLock)
+               return m_writerMetadataCount;
+         }
+      }
+
+      /// <summary>
+      /// Gets the most recently reported number of writers that reported status, or <c>-1</c> if no count has been reported.
+      /// </summary>
+      public int WriterStatusCount
+      {
+         get
+         {
+            lock (m_writerCountLock)
+               return m_writerStatusCount;
+         }
+      }
+
+      #endregion
+
+      #region Overrides
+
+      /// <summary>
+      /// Enables the <see cref="VssEventSource"/> when it is created.
+      /// </summary>
+      /// <param name="eventSource">The event source.</param>
+      protected override void OnEventSourceCreated(EventSource eventSource)
+      {
+         if (eventSource != null && eventSource.Name == VssEventSource.Log.Name)
+            EnableEvents(eventSource, m_includeComCalls ? EventLevel.Verbose : EventLevel.Informational, GetKeywords(m_includeComCalls));
+      }
+
+      /// <summary>
+      /// Records an event written by the <see cref="VssEventSource"/>.
+      /// </summary>
+      /// <param name="eventData">The event data.</param>
+      protected override void OnEventWritten(EventWrittenEventArgs eventData)
+      {
+         if (eventData == null || eventData.Payload == null)
+            return;
+
+         // EventWrittenEventArgs.EventName is not available on .NET Framework 4.5, so events are identified by id.
+         switch (eventData.EventId)
+         {
+            case VssEventSource.PhaseCompletedEventId:
+               Record(m_phases, (string)eventData.Payload[0], (int)eventData.Payload[1], (double)eventData.Payload[2]);
+               break;
+
+            case VssEventSource.ComCallCompletedEventId:
+               Record(m_comCalls, (string)eventData.Payload[0], (int)eventData.Payload[1], (double)eventData.Payload[2]);
+               break;
+
+            case VssEventSource.WriterCountsEventId:
+               lock (m_writerCountLock)
+               {
+                  m_writerMetadataCount = (int)eventData.Payload[0];
+                  m_writerStatusCount = (int)eventData.Payload[1];
+               }
+               break;
+         }
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private void Record(ConcurrentDictionary<string, VssLatencyHistogram> histograms, string name, int hresult, double durationMilliseconds)
+      {
+         if (name == null)
+            return;
+
+         histograms.GetOrAdd(name, key => new VssLatencyHistogram()).Record(durationMilliseconds);
+         m_results.AddOrUpdate(new KeyValuePair<string, int>(name, hresult), 1, (key, count) => count + 1);
+      }
+
+      private static EventKeywords GetKeywords(bool includeComCalls)
+      {
+         EventKeywords keywords = VssEventSource.Keywords.Phases | VssEventSource.Keywords.Writers;
+         if (includeComCalls)
+            keywords |= VssEventSource.Keywords.ComCalls;
+         return keywords;
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,197 @@
+
+using System;
+using System.Threading;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A thread-safe, fixed-size histogram of latencies, using exponentially sized buckets.
+   /// </summary>
+   /// <remarks>
+   /// Bucket <c>n</c> counts the durations from 2<sup>n</sup> up to (but not including) 2<sup>n+1</sup> microseconds (the first bucket 
+   /// also counting anything shorter), so recording a value never allocates, and percentiles are accurate to within a factor of two. 
+   /// The minimum, maximum, total and mean are exact to the microsecond.
+   /// </remarks>
+   public sealed class VssLatencyHistogram
+   {
+      #region Private Fields
+
+      private const int BucketCount = 40;
+
+      private readonly long[] m_buckets = new long[BucketCount];
+      private long m_count;
+      private long m_totalMicroseconds;
+      private long m_minMicroseconds = Int64.MaxValue;
+      private long m_maxMicroseconds;
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Records a duration, in milliseconds.
+      /// </summary>
+      /// <param name="milliseconds">The duration to record, in milliseconds. Negative values are recorded as zero.</param>
+      public void Record(double milliseconds)
+      {
+         long microseconds = milliseconds <= 0 ? 0 : (long)Math.Min(milliseconds * 1000.0, Int64.MaxValue / 2);
+
+         Interlocked.Increment(ref m_buckets[GetBucket(microseconds)]);
+         Interlocked.Increment(ref m_count);
+         Interlocked.Add(ref m_totalMicroseconds, microseconds);
+
+         long current = Interlocked.Read(ref m_minMicroseconds);
+         while (microseconds < current)
+         {
+            long previous = Interlocked.CompareExchange(ref m_minMicroseconds, microseconds, current);
+            if (previous == current)
+               break;
+            current = previous;
+         }
+
+         current = Interlocked.Read(ref m_maxMicroseconds);
+         while (microseconds > current)
+         {
+            long previous = Interlocked.CompareExchange(ref m_maxMicroseconds, microseconds, current);
+            if (previous == current)
+               break;
+            current = previous;
+         }
+      }
+
+      /// <summary>
+      /// Records a duration.
+      /// </summary>
+      /// <param name="duration">The duration to record.</param>
+      public void Record(TimeSpan duration)
+      {
+         Record(duration.TotalMilliseconds);
+      }
+
+      /// <summary>
+      /// Gets the approximate duration below which the specified percentage of the recorded durations fall.
+      /// </summary>
+      /// <param name="percentile">The percentile to retrieve, between 0 and 100 inclusive.</param>
+      /// <returns>The upper bound of the bucket containing the requested percentile, limited to <see cref="Maximum"/>, or
+      /// <see cref="TimeSpan.Zero"/> if no durations have been recorded.</returns>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="percentile"/> is less than 0 or greater than 100.</exception>
+      public TimeSpan GetPercentile(double percentile)
+      {
+         if (percentile < 0 || percentile > 100)
+            throw new ArgumentOutOfRangeException(nameof(percentile), percentile, "The percentile must be between 0 and 100.");
+
+         long count = Count;
+         if (count == 0)
+            return TimeSpan.Zero;
+
+         long rank = Math.Max(1, (long)Math.Ceiling(percentile / 100.0 * count));
+         long seen = 0;
+         for (int i = 0; i < BucketCount; i++)
+         {
+            seen += Interlocked.Read(ref m_buckets[i]);
+            if (seen >= rank)
+               return FromMicroseconds(Math.Min((1L << (i + 1)) - 1, Interlocked.Read(ref m_maxMicroseconds)));
+         }
+
+         return Maximum;
+      }
+
+      /// <summary>
+      /// Discards all recorded durations.
+      /// </summary>
+      /// <remarks>Durations recorded concurrently with a call to this method may or may not be discarded.</remarks>
+      public void Reset()
+      {
+         for (int i = 0; i < BucketCount; i++)
+            Interlocked.Exchange(ref m_buckets[i], 0);
+
+         Interlocked.Exchange(ref m_count, 0);
+         Interlocked.Exchange(ref m_totalMicroseconds, 0);
+         Interlocked.Exchange(ref m_minMicroseconds, Int64.MaxValue);
+         Interlocked.Exchange(ref m_maxMicroseconds, 0);
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the number of recorded durations.
+      /// </summary>
+      public long Count
+      {
+         get
+         {
+            return Interlocked.Read(ref m_count);
+         }
+      }
+
+      /// <summary>
+      /// Gets the sum of all recorded durations.
+      /// </summary>
+      public TimeSpan Total
+      {
+         get
+         {
+            return FromMicroseconds(Interlocked.Read(ref m_totalMicroseconds));
+         }
+      }
+
+      /// <summary>
+      /// Gets the mean of the recorded durations, or <see cref="TimeSpan.Zero"/> if no durations have been recorded.
+      /// </summary>
+      public TimeSpan Mean
+      {
+         get
+         {
+            long count = Count;
+            return count == 0 ? TimeSpan.Zero : FromMicroseconds(Interlocked.Read(ref m_totalMicroseconds) / count);
+         }
+      }
+
+      /// <summary>
+      /// Gets the shortest recorded duration, or <see cref="TimeSpan.Zero"/> if no durations have been recorded.
+      /// </summary>
+      public TimeSpan Minimum
+      {
+         get
+         {
+            long min = Interlocked.Read(ref m_minMicroseconds);
+            return min == Int64.MaxValue ? TimeSpan.Zero : FromMicroseconds(min);
+         }
+      }
+
+      /// <summary>
+      /// Gets the longest recorded duration, or <see cref="TimeSpan.Zero"/> if no durations have been recorded.
+      /// </summary>
+      public TimeSpan Maximum
+      {
+         get
+         {
+            return FromMicroseconds(Interlocked.Read(ref m_maxMicroseconds));
+         }
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private static int GetBucket(long microseconds)
+      {
+         int bucket = 0;
+         while (microseconds > 1 && bucket < BucketCount - 1)
+         {
+            microseconds >>= 1;
+            bucket++;
+         }
+         return bucket;
+      }
+
+      private static TimeSpan FromMicroseconds(long microseconds)
+      {
+         return TimeSpan.FromTicks(microseconds * (TimeSpan.TicksPerMillisecond / 1000));
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,307 @@
+
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Applies a <see cref="VssRetentionPolicy"/> to the snapshots on the system, deleting expired snapshot sets in batches.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///     Each batch of <see cref="BatchSize"/> snapshot sets is deleted through a single backup components object, saving 
+   ///     the cost of creating and initializing one per deletion. Failing to delete a snapshot set does not stop the others 
+   ///     from being deleted; the failures are reported in <see cref="VssRetentionResult.Failures"/>.
+   ///   </para>
+   ///   <para>
+   ///     VSS requires requesters to serialize the deletion of snapshots, so batches are run one at a time by default. A 
+   ///     <see cref="MaxDegreeOfParallelism"/> greater than one should only be used with providers known to support 
+   ///     concurrent deletions.
+   ///   </para>
+   ///   <para>
+   ///     <see cref="ApplyAsync"/> only applies the policy to the snapshots in a <see cref="VssRetentionScope"/>, so that 
+   ///     snapshots of other requesters are neither deleted nor counted against the policy. Cancellation does not discard 
+   ///     the work already done: the result reports the snapshot sets that were deleted, and those left in 
+   ///     <see cref="VssRetentionResult.Canceled"/>.
+   ///   </para>
+   /// </remarks>
+   public sealed class VssRetentionEngine
+   {
+      #region Private Fields
+
+      private readonly IVssFactory m_factory;
+      private int m_batchSize = 16;
+      private int m_maxDegreeOfParallelism = 1;
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssRetentionEngine"/> class.
+      /// </summary>
+      /// <param name="factory">The factory used to create the backup components objects that query and delete the snapshots.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="factory"/> is <see langword="null"/>.</exception>
+      public VssRetentionEngine(IVssFactory factory)
+      {
+         if (factory == null)
+            throw new ArgumentNullException(nameof(factory));
+
+         m_factory = factory;
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets or sets the number of snapshot sets deleted through each backup components object. The default is 16.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is less than one.</exception>
+      public int BatchSize
+      {
+         get
+         {
+            return m_batchSize;
+         }
+
+         set
+         {
+            if (value < 1)
+               throw new ArgumentOutOfRangeException(nameof(value), "The batch size must be greater than zero.");
+
+            m_batchSize = value;
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets the number of batches run concurrently. The default is 1.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is less than one.</exception>
+      public int MaxDegreeOfParallelism
+      {
+         get
+         {
+            return m_maxDegreeOfParallelism;
+         }
+
+         set
+         {
+            if (value < 1)
+               throw new ArgumentOutOfRangeException(nameof(value), "The degree of parallelism must be greater than zero.");
+
+            m_maxDegreeOfParallelism = value;
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets a value indicating whether the provider should do everything possible to delete the snapshots. See 
+      /// <see cref="IVssBackupComponents.DeleteSnapshotSet"/>.
+      /// </summary>
+      public bool ForceDelete { get; set; }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Queries the persistent snapshots in the specified scope, and deletes those that the specified policy does not retain.
+      /// </summary>
+      /// <param name="policy">The retention policy.</param>
+      /// <param name="scope">The snapshots the policy applies to. Snapshots outside the scope are neither counted by the policy nor deleted.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. Cancellation stops the deletion of further snapshot sets.</param>
+      /// <returns>A task whose result describes the deletions.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="policy"/> or <paramref name="scope"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="scope"/> is empty, and would include every persistent snapshot of a provider.</exception>
+      /// <exception cref="OperationCanceledException">The operation was canceled before the snapshots were queried.</exception>
+      public async Task<VssRetentionResult> ApplyAsync(VssRetentionPolicy policy, VssRetentionScope scope, CancellationToken cancellationToken = default)
+      {
+         if (policy == null)
+            throw new ArgumentNullException(nameof(policy));
+
+         if (scope == null)
+            throw new ArgumentNullException(nameof(scope));
+
+         if (scope.IsEmpty)
+            throw new ArgumentException("The scope must specify attributes or snapshot sets.", nameof(scope));
+
+         IList<VssSnapshotProperties> snapshots = await Task.Run(() =>
+         {
+            using (IVssBackupComponents backupComponents = CreateBackupComponents())
+               return backupComponents.QuerySnapshots().Where(snapshot => (snapshot.SnapshotAttributes & VssVolumeSnapshotAttributes.Persistent) != 0 && scope.Contains(snapshot)).ToList();
+         }, cancellationToken).ConfigureAwait(false);
+
+         return await ExecuteAsync(policy.CreatePlan(snapshots, DateTime.Now), cancellationToken).ConfigureAwait(false);
+      }
+
+      /// <summary>
+      /// Deletes the snapshot sets of the specified plan that are not retained.
+      /// </summary>
+      /// <param name="plan">The plan.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. Cancellation stops the deletion of 
+      /// further snapshot sets; the result then reports the sets that were not deleted in <see cref="VssRetentionResult.Canceled"/>.</param>
+      /// <returns>A task whose result describes the deletions.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="plan"/> is <see langword="null"/>.</exception>
+      public async Task<VssRetentionResult> ExecuteAsync(VssRetentionPlan plan, CancellationToken cancellationToken = default)
+      {
+         if (plan == null)
+            throw new ArgumentNullException(nameof(plan));
+
+         Stopwatch stopwatch = Stopwatch.StartNew();
+         IVssDifferentialSoftwareSnapshotManagement diffAreas = GetDiffAreaManagement();
+
+         // The storage areas of a volume are queried through one of its snapshots before they are deleted, and through 
+         // the volume itself afterwards, since it may not have any snapshots left.
+         Dictionary<string, long> usedBefore = new Dictionary<string, long>(StringComparer.OrdinalIgnoreCase);
+         if (diffAreas != null)
+         {
+            foreach (VssSnapshotProperties snapshot in plan.Deleted.SelectMany(entry => entry.Snapshots))
+            {
+               if (snapshot.OriginalVolumeName != null && !usedBefore.ContainsKey(snapshot.OriginalVolumeName))
+               {
+                  long? used = QueryUsedDiffSpace(() => diffAreas.QueryDiffAreasForSnapshot(snapshot.SnapshotId));
+                  if (used.HasValue)
+                     usedBefore.Add(snapshot.OriginalVolumeName, used.Value);
+               }
+            }
+         }
+
+         ConcurrentDictionary<Guid, Exception> failures = new ConcurrentDictionary<Guid, Exception>();
+         ConcurrentDictionary<Guid, bool> deletedSets = new ConcurrentDictionary<Guid, bool>();
+         int deletedSnapshots = 0;
+         List<VssRetentionPlanEntry>[] batches = plan.Deleted
+            .Select((entry, index) => new { entry, index })
+            .GroupBy(item => item.index / BatchSize, item => item.entry)
+            .Select(batch => batch.ToList())
+            .ToArray();
+
+         using (SemaphoreSlim throttle = new SemaphoreSlim(MaxDegreeOfParallelism))
+         {
+            Task[] tasks = batches.Select(batch => Task.Run(async () =>
+            {
+               await throttle.WaitAsync(cancellationToken).ConfigureAwait(false);
+               try
+               {
+                  Interlocked.Add(ref deletedSnapshots, DeleteBatch(batch, deletedSets, failures, cancellationToken));
+               }
+               finally
+               {
+                  throttle.Release();
+               }
+            })).ToArray();
+
+            try
+            {
+               await Task.WhenAll(tasks).ConfigureAwait(false);
+            }
+            catch (OperationCanceledException)
+            {
+               // Batches that were not started are reported as canceled below, once all running batches are complete.
+            }
+         }
+
+         long reclaimed = 0;
+         foreach (KeyValuePair<string, long> volume in usedBefore)
+         {
+            long? usedAfter = QueryUsedDiffSpace(() => diffAreas.QueryDiffAreasForVolume(volume.Key));
+            if (usedAfter.HasValue)
+               reclaimed += Math.Max(0, volume.Value - usedAfter.Value);
+         }
+
+         IList<VssRetentionPlanEntry> deleted = plan.Deleted.Where(entry => deletedSets.ContainsKey(entry.SnapshotSetId)).ToList().AsReadOnly();
+         IList<VssRetentionPlanEntry> canceled = plan.Deleted.Where(entry => !deletedSets.ContainsKey(entry.SnapshotSetId) && !failures.ContainsKey(entry.SnapshotSetId)).ToList().AsReadOnly();
+         return new VssRetentionResult(plan, deleted, canceled, new ReadOnlyDictionary<Guid, Exception>(failures), deletedSnapshots, reclaimed, stopwatch.Elapsed);
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private IVssBackupComponents CreateBackupComponents()
+      {
+         IVssBackupComponents backupComponents = m_factory.CreateVssBackupComponents();
+         try
+         {
+            backupComponents.InitializeForBackup(null);
+            backupComponents.SetContext(VssSnapshotContext.All);
+            return backupComponents;
+         }
+         catch
+         {
+            backupComponents.Dispose();
+            throw;
+         }
+      }
+
+      // Deletes the snapshot sets of the batch until canceled, recording the sets deleted and the failures; sets skipped 
+      // because of the cancellation are recorded in neither.
+      private int DeleteBatch(List<VssRetentionPlanEntry> batch, ConcurrentDictionary<Guid, bool> deletedSets, ConcurrentDictionary<Guid, Exception> failures, CancellationToken cancellationToken)
+      {
+         int deleted = 0;
+         IVssBackupComponents backupComponents;
+         try
+         {
+            backupComponents = CreateBackupComponents();
+         }
+         catch (Exception ex) when (ex is VssException || ex is UnauthorizedAccessException)
+         {
+            foreach (VssRetentionPlanEntry entry in batch)
+               failures[entry.SnapshotSetId] = ex;
+            return 0;
+         }
+
+         using (backupComponents)
+         {
+            foreach (VssRetentionPlanEntry entry in batch)
+            {
+               if (cancellationToken.IsCancellationRequested)
+                  break;
+
+               try
+               {
+                  deleted += backupComponents.DeleteSnapshotSet(entry.SnapshotSetId, ForceDelete);
+                  deletedSets[entry.SnapshotSetId] = true;
+               }
+               catch (Exception ex) when (ex is VssException || ex is UnauthorizedAccessException)
+               {
+                  failures[entry.SnapshotSetId] = ex;
+               }
+            }
+         }
+
+         return deleted;
+      }
+
+      private IVssDifferentialSoftwareSnapshotManagement GetDiffAreaManagement()
+      {
+         try
+         {
+            return m_factory.CreateVssSnapshotManagement().GetDifferentialSoftwareSnapshotManagementInterface();
+         }
+         catch (Exception ex) when (ex is VssException || ex is UnauthorizedAccessException || ex is NotSupportedException)
+         {
+            return null;
+         }
+      }
+
+      private static long? QueryUsedDiffSpace(Func<IList<VssDiffAreaProperties>> query)
+      {
+         try
+         {
+            return query().Sum(diffArea => diffArea.UsedDiffSpace);
+         }
+         catch (Exception ex) when (ex is VssException || ex is UnauthorizedAccessException || ex is ArgumentException)
+         {
+            return null;
+         }
+      }
+
+      #endregion
+   }
+}
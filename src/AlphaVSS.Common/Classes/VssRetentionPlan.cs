@@ -0,0 +1,34 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// The snapshot sets to retain and to delete, as computed by <see cref="VssRetentionPolicy.CreatePlan"/>.
+   /// </summary>
+   public sealed class VssRetentionPlan
+   {
+      internal VssRetentionPlan(IList<VssRetentionPlanEntry> entries, IList<VssRetentionPlanEntry> retained, IList<VssRetentionPlanEntry> deleted)
+      {
+         Entries = entries;
+         Retained = retained;
+         Deleted = deleted;
+      }
+
+      /// <summary>
+      /// Gets all snapshot sets, most recent first.
+      /// </summary>
+      public IList<VssRetentionPlanEntry> Entries { get; private set; }
+
+      /// <summary>
+      /// Gets the snapshot sets to retain, most recent first.
+      /// </summary>
+      public IList<VssRetentionPlanEntry> Retained { get; private set; }
+
+      /// <summary>
+      /// Gets the snapshot sets to delete, oldest first.
+      /// </summary>
+      public IList<VssRetentionPlanEntry> Deleted { get; private set; }
+   }
+}
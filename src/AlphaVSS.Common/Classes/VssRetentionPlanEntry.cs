@@ -0,0 +1,56 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// The decision of a <see cref="VssRetentionPolicy"/> about a single snapshot set.
+   /// </summary>
+   public sealed class VssRetentionPlanEntry
+   {
+      internal VssRetentionPlanEntry(Guid snapshotSetId, DateTime creationTimestamp, IList<VssSnapshotProperties> snapshots)
+      {
+         SnapshotSetId = snapshotSetId;
+         CreationTimestamp = creationTimestamp;
+         Snapshots = snapshots;
+      }
+
+      /// <summary>
+      /// Gets the id of the snapshot set.
+      /// </summary>
+      public Guid SnapshotSetId { get; private set; }
+
+      /// <summary>
+      /// Gets the creation time of the snapshot set, i.e. the earliest creation time of its snapshots.
+      /// </summary>
+      public DateTime CreationTimestamp { get; private set; }
+
+      /// <summary>
+      /// Gets the snapshots of the set.
+      /// </summary>
+      public IList<VssSnapshotProperties> Snapshots { get; private set; }
+
+      /// <summary>
+      /// Gets the rules of the policy that retain the snapshot set.
+      /// </summary>
+      public VssRetentionReasons Reasons { get; internal set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the snapshot set is deleted, despite being retained by <see cref="Reasons"/>, 
+      /// because it is one of the oldest sets on a volume exceeding <see cref="VssRetentionPolicy.MaxSnapshotsPerVolume"/>.
+      /// </summary>
+      public bool ExceedsVolumeLimit { get; internal set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the snapshot set is retained.
+      /// </summary>
+      public bool IsRetained
+      {
+         get
+         {
+            return Reasons != VssRetentionReasons.None && !ExceedsVolumeLimit;
+         }
+      }
+   }
+}
@@ -0,0 +1,335 @@
+
+using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A grandfather-father-son retention policy for persistent snapshots, deciding which snapshot sets to retain and which 
+   /// to delete.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///     A snapshot set is retained if it is one of the <see cref="KeepLatest"/> most recent sets, if it is younger than 
+   ///     <see cref="MinimumAge"/>, or if it is the most recent set of one of the most recent hours, days, weeks, months or 
+   ///     years, as specified by <see cref="KeepHourly"/>, <see cref="KeepDaily"/>, <see cref="KeepWeekly"/>, 
+   ///     <see cref="KeepMonthly"/> and <see cref="KeepYearly"/>. Periods without snapshots do not count. Periods are 
+   ///     determined from the <see cref="VssSnapshotProperties.CreationTimestamp"/> of the snapshots, which is local time.
+   ///   </para>
+   ///   <para>
+   ///     If <see cref="MaxSnapshotsPerVolume"/> is set, the oldest retained sets with snapshots of a volume exceeding the limit 
+   ///     are deleted as well, except for sets retained by <see cref="KeepLatest"/> or <see cref="MinimumAge"/>. Keeping the 
+   ///     limit below the 64 snapshots VSS supports per volume leaves room for the snapshots of the next backups.
+   ///   </para>
+   ///   <para>
+   ///     Snapshot sets are retained or deleted as a whole, since that is how they are deleted by 
+   ///     <see cref="IVssBackupComponents.DeleteSnapshotSet"/>. Planning sorts the snapshot sets once, and takes 
+   ///     O(n log n) time for n snapshot sets.
+   ///   </para>
+   /// </remarks>
+   public sealed class VssRetentionPolicy
+   {
+      #region Private Fields
+
+      private int m_keepLatest = 1;
+      private int m_keepHourly;
+      private int m_keepDaily;
+      private int m_keepWeekly;
+      private int m_keepMonthly;
+      private int m_keepYearly;
+      private int m_maxSnapshotsPerVolume;
+      private TimeSpan m_minimumAge;
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets or sets the number of most recent snapshot sets that are always retained. The default is 1.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is negative.</exception>
+      public int KeepLatest
+      {
+         get
+         {
+            return m_keepLatest;
+         }
+
+         set
+         {
+            m_keepLatest = CheckCount(value);
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets the age below which snapshot sets are always retained. The default is <see cref="TimeSpan.Zero"/>.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is negative.</exception>
+      public TimeSpan MinimumAge
+      {
+         get
+         {
+            return m_minimumAge;
+         }
+
+         set
+         {
+            if (value < TimeSpan.Zero)
+               throw new ArgumentOutOfRangeException(nameof(value), "The age must not be negative.");
+
+            m_minimumAge = value;
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets the number of hours for which the most recent snapshot set is retained. The default is 0.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is negative.</exception>
+      public int KeepHourly
+      {
+         get
+         {
+            return m_keepHourly;
+         }
+
+         set
+         {
+            m_keepHourly = CheckCount(value);
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets the number of days for which the most recent snapshot set is retained. The default is 0.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is negative.</exception>
+      public int KeepDaily
+      {
+         get
+         {
+            return m_keepDaily;
+         }
+
+         set
+         {
+            m_keepDaily = CheckCount(value);
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets the number of weeks for which the most recent snapshot set is retained. The default is 0.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is negative.</exception>
+      public int KeepWeekly
+      {
+         get
+         {
+            return m_keepWeekly;
+         }
+
+         set
+         {
+            m_keepWeekly = CheckCount(value);
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets the number of months for which the most recent snapshot set is retained. The default is 0.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is negative.</exception>
+      public int KeepMonthly
+      {
+         get
+         {
+            return m_keepMonthly;
+         }
+
+         set
+         {
+            m_keepMonthly = CheckCount(value);
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets the number of years for which the most recent snapshot set is retained. The default is 0.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is negative.</exception>
+      public int KeepYearly
+      {
+         get
+         {
+            return m_keepYearly;
+         }
+
+         set
+         {
+            m_keepYearly = CheckCount(value);
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets the first day of the week, used to determine the weeks of <see cref="KeepWeekly"/>. The default is 
+      /// <see cref="DayOfWeek.Monday"/>.
+      /// </summary>
+      public DayOfWeek FirstDayOfWeek { get; set; } = DayOfWeek.Monday;
+
+      /// <summary>
+      /// Gets or sets the largest number of snapshots retained per volume, or 0 for no limit. The default is 0.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is negative.</exception>
+      public int MaxSnapshotsPerVolume
+      {
+         get
+         {
+            return m_maxSnapshotsPerVolume;
+         }
+
+         set
+         {
+            m_maxSnapshotsPerVolume = CheckCount(value);
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Decides which of the specified snapshots to retain and which to delete.
+      /// </summary>
+      /// <param name="snapshots">The snapshots the policy applies to, typically the persistent snapshots returned by <see cref="IVssBackupComponents.QuerySnapshots()"/>.</param>
+      /// <param name="now">The current time, which the ages of the snapshots are measured against.</param>
+      /// <returns>The snapshot sets to retain and to delete.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="snapshots"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="snapshots"/> contains a <see langword="null"/> element.</exception>
+      public VssRetentionPlan CreatePlan(IEnumerable<VssSnapshotProperties> snapshots, DateTime now)
+      {
+         if (snapshots == null)
+            throw new ArgumentNullException(nameof(snapshots));
+
+         Dictionary<Guid, List<VssSnapshotProperties>> sets = new Dictionary<Guid, List<VssSnapshotProperties>>();
+         foreach (VssSnapshotProperties snapshot in snapshots)
+         {
+            if (snapshot == null)
+               throw new ArgumentException("The sequence contains a null element.", nameof(snapshots));
+
+            List<VssSnapshotProperties> set;
+            if (!sets.TryGetValue(snapshot.SnapshotSetId, out set))
+            {
+               set = new List<VssSnapshotProperties>();
+               sets.Add(snapshot.SnapshotSetId, set);
+            }
+
+            set.Add(snapshot);
+         }
+
+         VssRetentionPlanEntry[] entries = sets.Select(set => new VssRetentionPlanEntry(set.Key, set.Value.Min(snapshot => snapshot.CreationTimestamp), set.Value.AsReadOnly())).ToArray();
+         Array.Sort(entries, (x, y) =>
+         {
+            int result = y.CreationTimestamp.CompareTo(x.CreationTimestamp);
+            return result != 0 ? result : x.SnapshotSetId.CompareTo(y.SnapshotSetId);
+         });
+
+         for (int i = 0; i < entries.Length; i++)
+         {
+            if (i < KeepLatest)
+               entries[i].Reasons |= VssRetentionReasons.Latest;
+
+            if (GetAge(entries[i].CreationTimestamp, now) < MinimumAge)
+               entries[i].Reasons |= VssRetentionReasons.MinimumAge;
+         }
+
+         KeepPeriods(entries, KeepHourly, VssRetentionReasons.Hourly, timestamp => timestamp.Ticks / TimeSpan.TicksPerHour);
+         KeepPeriods(entries, KeepDaily, VssRetentionReasons.Daily, timestamp => timestamp.Ticks / TimeSpan.TicksPerDay);
+         KeepPeriods(entries, KeepWeekly, VssRetentionReasons.Weekly, timestamp => timestamp.Date.AddDays(-(((int)timestamp.DayOfWeek - (int)FirstDayOfWeek + 7) % 7)).Ticks);
+         KeepPeriods(entries, KeepMonthly, VssRetentionReasons.Monthly, timestamp => timestamp.Year * 12L + timestamp.Month);
+         KeepPeriods(entries, KeepYearly, VssRetentionReasons.Yearly, timestamp => timestamp.Year);
+
+         if (MaxSnapshotsPerVolume > 0)
+            EnforceVolumeLimit(entries);
+
+         List<VssRetentionPlanEntry> retained = new List<VssRetentionPlanEntry>();
+         List<VssRetentionPlanEntry> deleted = new List<VssRetentionPlanEntry>();
+         foreach (VssRetentionPlanEntry entry in entries)
+         {
+            if (entry.IsRetained)
+               retained.Add(entry);
+            else
+               deleted.Add(entry);
+         }
+
+         deleted.Reverse();
+         return new VssRetentionPlan(new ReadOnlyCollection<VssRetentionPlanEntry>(entries), retained.AsReadOnly(), deleted.AsReadOnly());
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private static int CheckCount(int value)
+      {
+         if (value < 0)
+            throw new ArgumentOutOfRangeException(nameof(value), "The count must not be negative.");
+
+         return value;
+      }
+
+      private static TimeSpan GetAge(DateTime timestamp, DateTime now)
+      {
+         if (timestamp.Kind != DateTimeKind.Unspecified && now.Kind != DateTimeKind.Unspecified)
+            return now.ToUniversalTime() - timestamp.ToUniversalTime();
+
+         return now - timestamp;
+      }
+
+      // Retains the most recent entry of each of the most recent periods, with entries sorted most recent first.
+      private static void KeepPeriods(VssRetentionPlanEntry[] entries, int count, VssRetentionReasons reason, Func<DateTime, long> getPeriod)
+      {
+         long? lastPeriod = null;
+         int kept = 0;
+         for (int i = 0; i < entries.Length && kept < count; i++)
+         {
+            long period = getPeriod(entries[i].CreationTimestamp);
+            if (period != lastPeriod)
+            {
+               entries[i].Reasons |= reason;
+               lastPeriod = period;
+               kept++;
+            }
+         }
+      }
+
+      private void EnforceVolumeLimit(VssRetentionPlanEntry[] entries)
+      {
+         Dictionary<string, int> counts = new Dictionary<string, int>(StringComparer.OrdinalIgnoreCase);
+         foreach (VssRetentionPlanEntry entry in entries.Where(entry => entry.IsRetained))
+         {
+            foreach (VssSnapshotProperties snapshot in entry.Snapshots)
+            {
+               int count;
+               counts.TryGetValue(snapshot.OriginalVolumeName ?? String.Empty, out count);
+               counts[snapshot.OriginalVolumeName ?? String.Empty] = count + 1;
+            }
+         }
+
+         // Oldest first, deleting every set with a snapshot of a volume that is still over the limit.
+         const VssRetentionReasons Protected = VssRetentionReasons.Latest | VssRetentionReasons.MinimumAge;
+         for (int i = entries.Length - 1; i >= 0; i--)
+         {
+            VssRetentionPlanEntry entry = entries[i];
+            if (!entry.IsRetained || (entry.Reasons & Protected) != 0)
+               continue;
+
+            if (entry.Snapshots.Any(snapshot => counts[snapshot.OriginalVolumeName ?? String.Empty] > MaxSnapshotsPerVolume))
+            {
+               entry.ExceedsVolumeLimit = true;
+               foreach (VssSnapshotProperties snapshot in entry.Snapshots)
+                  counts[snapshot.OriginalVolumeName ?? String.Empty]--;
+            }
+         }
+      }
+
+      #endregion
+   }
+}
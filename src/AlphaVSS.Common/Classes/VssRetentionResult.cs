@@ -0,0 +1,65 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// The outcome of running a <see cref="VssRetentionPlan"/> with <see cref="VssRetentionEngine"/>.
+   /// </summary>
+   public sealed class VssRetentionResult
+   {
+      internal VssRetentionResult(VssRetentionPlan plan, IList<VssRetentionPlanEntry> deleted, IList<VssRetentionPlanEntry> canceled, IDictionary<Guid, Exception> failures, int deletedSnapshotCount, long reclaimedDiffSpace, TimeSpan elapsed)
+      {
+         Plan = plan;
+         Deleted = deleted;
+         Canceled = canceled;
+         Failures = failures;
+         DeletedSnapshotCount = deletedSnapshotCount;
+         ReclaimedDiffSpace = reclaimedDiffSpace;
+         Elapsed = elapsed;
+      }
+
+      /// <summary>
+      /// Gets the plan that was run.
+      /// </summary>
+      public VssRetentionPlan Plan { get; private set; }
+
+      /// <summary>
+      /// Gets the snapshot sets that were deleted, oldest first.
+      /// </summary>
+      public IList<VssRetentionPlanEntry> Deleted { get; private set; }
+
+      /// <summary>
+      /// Gets the snapshot sets that were not deleted because the operation was canceled, oldest first.
+      /// </summary>
+      public IList<VssRetentionPlanEntry> Canceled { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the operation was canceled before all expired snapshot sets were deleted.
+      /// </summary>
+      public bool WasCanceled => Canceled.Count > 0;
+
+      /// <summary>
+      /// Gets the exceptions that prevented the deletion of snapshot sets, keyed by the id of the snapshot set.
+      /// </summary>
+      public IDictionary<Guid, Exception> Failures { get; private set; }
+
+      /// <summary>
+      /// Gets the number of snapshots deleted.
+      /// </summary>
+      public int DeletedSnapshotCount { get; private set; }
+
+      /// <summary>
+      /// Gets the number of bytes of shadow copy storage space released by the deletions, as reported by 
+      /// <see cref="IVssDifferentialSoftwareSnapshotManagement.QueryDiffAreasForSnapshot"/>. Volumes whose storage areas 
+      /// could not be queried are not included.
+      /// </summary>
+      public long ReclaimedDiffSpace { get; private set; }
+
+      /// <summary>
+      /// Gets the time it took to run the plan.
+      /// </summary>
+      public TimeSpan Elapsed { get; private set; }
+   }
+}
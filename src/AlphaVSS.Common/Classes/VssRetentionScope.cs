@@ -0,0 +1,59 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Limits the snapshots a <see cref="VssRetentionEngine"/> applies a <see cref="VssRetentionPolicy"/> to, so that it 
+   /// only deletes snapshots created by the caller.
+   /// </summary>
+   /// <remarks>
+   ///   A snapshot is in scope if it matches every criterion that is set. Snapshot sets or attributes must be set, since 
+   ///   snapshots created by other requesters, such as system restore points or the shadow copies of shared folders, are 
+   ///   persistent as well, and are created by the same provider.
+   /// </remarks>
+   public sealed class VssRetentionScope
+   {
+      /// <summary>
+      /// Gets or sets the id of the provider that must have created the snapshots, or <see langword="null"/> for any provider.
+      /// </summary>
+      public Guid? ProviderId { get; set; }
+
+      /// <summary>
+      /// Gets or sets the attributes the snapshots must all have. <see cref="VssVolumeSnapshotAttributes.Persistent"/> does 
+      /// not narrow the scope, since retention only applies to persistent snapshots. By default, no 
+      /// attributes are required.
+      /// </summary>
+      public VssVolumeSnapshotAttributes Attributes { get; set; }
+
+      /// <summary>
+      /// Gets the ids of the snapshot sets the snapshots must belong to, typically those recorded when the sets were created. 
+      /// If empty, snapshots of any set are in scope.
+      /// </summary>
+      public ISet<Guid> SnapshotSetIds { get; } = new HashSet<Guid>();
+
+      /// <summary>
+      /// Gets a value indicating whether neither snapshot sets nor attributes are set, in which case the scope would 
+      /// include every persistent snapshot of the provider, or of every provider, on the system. 
+      /// <see cref="ProviderId"/> alone does not limit the scope to the snapshots of the caller.
+      /// </summary>
+      public bool IsEmpty => (Attributes & ~VssVolumeSnapshotAttributes.Persistent) == 0 && SnapshotSetIds.Count == 0;
+
+      /// <summary>
+      /// Determines whether the specified snapshot is in scope.
+      /// </summary>
+      /// <param name="snapshot">The snapshot.</param>
+      /// <returns><see langword="true"/> if the snapshot matches every criterion that is set; otherwise, <see langword="false"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="snapshot"/> is <see langword="null"/>.</exception>
+      public bool Contains(VssSnapshotProperties snapshot)
+      {
+         if (snapshot == null)
+            throw new ArgumentNullException(nameof(snapshot));
+
+         return (ProviderId == null || snapshot.ProviderId == ProviderId.Value)
+            && (snapshot.SnapshotAttributes & Attributes) == Attributes
+            && (SnapshotSetIds.Count == 0 || SnapshotSetIds.Contains(snapshot.SnapshotSetId));
+      }
+   }
+}
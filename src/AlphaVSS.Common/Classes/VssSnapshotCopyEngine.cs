@@ -0,0 +1,370 @@
+
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Copies files out of a snapshot, or any other directory tree, using a bounded number of concurrent workers.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///     The source root is usually the <see cref="VssSnapshotProperties.SnapshotDeviceObject"/> of a snapshot, or the path it 
+   ///     was exposed at with <see cref="IVssBackupComponents.ExposeSnapshot"/>. Accessing the snapshot device object directly 
+   ///     requires support for <c>\\?\</c> paths, i.e. .NET Framework 4.6.2 or later, or .NET Core.
+   ///   </para>
+   ///   <para>
+   ///     Each worker owns two buffers of <see cref="BufferSize"/> bytes, reused for every file it copies. Files larger than 
+   ///     <see cref="SmallFileThreshold"/> are copied with overlapped I/O, reading the next block of the source while the 
+   ///     previous one is written. Smaller files are copied with a single read and write each, without overlapping them. Every 
+   ///     file is opened for asynchronous I/O, so no worker thread blocks on a read or write. Workers claim files 
+   ///     in batches that shrink as the list is consumed, so that long lists of small files incur little coordination while the 
+   ///     last files are still spread over all workers.
+   ///   </para>
+   ///   <para>
+   ///     Relative paths that resolve to a location outside of either root, such as <c>..\..\Windows\win.ini</c>, are not 
+   ///     copied; their results carry an <see cref="ArgumentException"/>.
+   ///   </para>
+   ///   <para>
+   ///     The engine only uses portable file APIs, and works on any platform and directory tree. Configure an instance before 
+   ///     calling <see cref="CopyAsync"/>; it should not be reconfigured while a copy is in progress.
+   ///   </para>
+   /// </remarks>
+   public sealed class VssSnapshotCopyEngine
+   {
+      #region Private Fields
+
+      private const int BufferAlignment = 4096;
+      private const int MaxBatchSize = 64;
+
+      private int m_maxDegreeOfParallelism = 4;
+      private int m_bufferSize = 1024 * 1024;
+      private int m_smallFileThreshold = 64 * 1024;
+      private readonly string m_sourcePrefix;
+      private readonly string m_destinationPrefix;
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssSnapshotCopyEngine"/> class.
+      /// </summary>
+      /// <param name="sourceRoot">The root of the files to copy, for instance the snapshot device object of a snapshot.</param>
+      /// <param name="destinationRoot">The directory to copy the files to. Directories are created as needed, and existing files are overwritten.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="sourceRoot"/> or <paramref name="destinationRoot"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="sourceRoot"/> or <paramref name="destinationRoot"/> is not a valid path.</exception>
+      public VssSnapshotCopyEngine(string sourceRoot, string destinationRoot)
+      {
+         if (sourceRoot == null)
+            throw new ArgumentNullException(nameof(sourceRoot));
+
+         if (destinationRoot == null)
+            throw new ArgumentNullException(nameof(destinationRoot));
+
+         SourceRoot = sourceRoot;
+         DestinationRoot = destinationRoot;
+         m_sourcePrefix = GetPrefix(sourceRoot);
+         m_destinationPrefix = GetPrefix(destinationRoot);
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the root of the files to copy.
+      /// </summary>
+      public string SourceRoot { get; private set; }
+
+      /// <summary>
+      /// Gets the directory the files are copied to.
+      /// </summary>
+      public string DestinationRoot { get; private set; }
+
+      /// <summary>
+      /// Gets or sets the number of files copied concurrently. The default is 4.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is less than one.</exception>
+      public int MaxDegreeOfParallelism
+      {
+         get
+         {
+            return m_maxDegreeOfParallelism;
+         }
+
+         set
+         {
+            if (value < 1)
+               throw new ArgumentOutOfRangeException(nameof(value), "The degree of parallelism must be greater than zero.");
+
+            m_maxDegreeOfParallelism = value;
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets the size of the buffers of each worker, in bytes. The value is rounded up to a multiple of 4096 bytes, 
+      /// the sector and page size, so that reads stay aligned. The default is 1 MB.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is less than one.</exception>
+      public int BufferSize
+      {
+         get
+         {
+            return m_bufferSize;
+         }
+
+         set
+         {
+            if (value < 1)
+               throw new ArgumentOutOfRangeException(nameof(value), "The buffer size must be greater than zero.");
+
+            m_bufferSize = (int)Math.Min(((long)value + BufferAlignment - 1) / BufferAlignment * BufferAlignment, Int32.MaxValue / BufferAlignment * BufferAlignment);
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets the size, in bytes, up to which files are copied synchronously with a single read and write. The value 
+      /// is capped at <see cref="BufferSize"/>. The default is 64 KB.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is negative.</exception>
+      public int SmallFileThreshold
+      {
+         get
+         {
+            return m_smallFileThreshold;
+         }
+
+         set
+         {
+            if (value < 0)
+               throw new ArgumentOutOfRangeException(nameof(value), "The threshold must not be negative.");
+
+            m_smallFileThreshold = value;
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Copies the specified files from <see cref="SourceRoot"/> to <see cref="DestinationRoot"/>.
+      /// </summary>
+      /// <param name="relativePaths">The paths of the files to copy, relative to the roots.</param>
+      /// <param name="progress">The provider receiving the result of each file as soon as it is copied, or <see langword="null"/>. Results may be reported concurrently.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests.</param>
+      /// <returns>
+      ///   A task whose result summarizes the copy. The task does not fail when files cannot be copied; the result of each such 
+      ///   file carries its exception. Nor does it fail when the copy is canceled: the files copied so far keep their results, 
+      ///   while the file being copied and the files not yet started carry an <see cref="OperationCanceledException"/>, and 
+      ///   <see cref="VssFileCopySummary.IsCanceled"/> is set.
+      /// </returns>
+      /// <exception cref="ArgumentNullException"><paramref name="relativePaths"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="relativePaths"/> contains a <see langword="null"/> element.</exception>
+      public async Task<VssFileCopySummary> CopyAsync(IEnumerable<string> relativePaths, IProgress<VssFileCopyResult> progress = null, CancellationToken cancellationToken = default)
+      {
+         if (relativePaths == null)
+            throw new ArgumentNullException(nameof(relativePaths));
+
+         string[] paths = relativePaths.ToArray();
+         if (paths.Contains(null))
+            throw new ArgumentException("The sequence contains a null element.", nameof(relativePaths));
+
+         CopyState state = new CopyState(paths, Math.Min(MaxDegreeOfParallelism, Math.Max(paths.Length, 1)), progress);
+         Stopwatch stopwatch = Stopwatch.StartNew();
+
+         Task[] workers = new Task[state.WorkerCount];
+         for (int i = 0; i < workers.Length; i++)
+            workers[i] = Task.Run(() => RunWorkerAsync(state, cancellationToken));
+
+         await Task.WhenAll(workers).ConfigureAwait(false);
+
+         bool canceled = false;
+         for (int i = 0; i < state.Results.Length; i++)
+         {
+            if (state.Results[i] == null)
+               state.Results[i] = new VssFileCopyResult(state.Paths[i], 0, TimeSpan.Zero, new OperationCanceledException(cancellationToken));
+
+            canceled |= state.Results[i].Exception is OperationCanceledException;
+         }
+
+         return new VssFileCopySummary(new ReadOnlyCollection<VssFileCopyResult>(state.Results), Interlocked.Read(ref state.BytesCopied), stopwatch.Elapsed, canceled);
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private async Task RunWorkerAsync(CopyState state, CancellationToken cancellationToken)
+      {
+         byte[] current = new byte[BufferSize];
+         byte[] next = new byte[BufferSize];
+
+         int start;
+         int count;
+         while (!cancellationToken.IsCancellationRequested && state.TryClaim(out start, out count))
+         {
+            // Files left unstarted on cancellation are given their results by CopyAsync.
+            for (int i = start; i < start + count && !cancellationToken.IsCancellationRequested; i++)
+            {
+               VssFileCopyResult result = await CopyFileAsync(state, state.Paths[i], current, next, cancellationToken).ConfigureAwait(false);
+               state.Results[i] = result;
+               if (state.Progress != null)
+                  state.Progress.Report(result);
+            }
+         }
+      }
+
+      private async Task<VssFileCopyResult> CopyFileAsync(CopyState state, string relativePath, byte[] current, byte[] next, CancellationToken cancellationToken)
+      {
+         Stopwatch stopwatch = Stopwatch.StartNew();
+         long copied = 0;
+         try
+         {
+            string sourcePath = GetContainedPath(m_sourcePrefix, relativePath);
+            string destinationPath = GetContainedPath(m_destinationPrefix, relativePath);
+            state.EnsureDirectory(Path.GetDirectoryName(destinationPath));
+
+            using (FileStream source = new FileStream(sourcePath, FileMode.Open, FileAccess.Read, FileShare.ReadWrite | FileShare.Delete, 1, FileOptions.Asynchronous | FileOptions.SequentialScan))
+            {
+               long length = source.Length;
+               using (FileStream destination = new FileStream(destinationPath, FileMode.Create, FileAccess.Write, FileShare.None, 1, FileOptions.Asynchronous))
+               {
+                  if (length <= Math.Min(SmallFileThreshold, BufferSize))
+                  {
+                     int read;
+                     while ((read = await source.ReadAsync(current, 0, current.Length, cancellationToken).ConfigureAwait(false)) > 0)
+                     {
+                        await destination.WriteAsync(current, 0, read, cancellationToken).ConfigureAwait(false);
+                        copied += read;
+                        Interlocked.Add(ref state.BytesCopied, read);
+                     }
+                  }
+                  else
+                  {
+                     // Preallocating the destination avoids growing, and fragmenting, it block by block.
+                     destination.SetLength(length);
+
+                     int read = await source.ReadAsync(current, 0, current.Length, cancellationToken).ConfigureAwait(false);
+                     while (read > 0)
+                     {
+                        Task write = destination.WriteAsync(current, 0, read, cancellationToken);
+                        Task<int> nextRead = source.ReadAsync(next, 0, next.Length, cancellationToken);
+                        await Task.WhenAll(write, nextRead).ConfigureAwait(false);
+
+                        copied += read;
+                        Interlocked.Add(ref state.BytesCopied, read);
+
+                        read = nextRead.Result;
+                        byte[] swap = current;
+                        current = next;
+                        next = swap;
+                     }
+
+                     // The source may have been shorter than reported.
+                     if (destination.Length != copied)
+                        destination.SetLength(copied);
+                  }
+               }
+
+               File.SetLastWriteTimeUtc(destinationPath, File.GetLastWriteTimeUtc(sourcePath));
+            }
+
+            return new VssFileCopyResult(relativePath, copied, stopwatch.Elapsed, null);
+         }
+         catch (Exception ex)
+         {
+            return new VssFileCopyResult(relativePath, copied, stopwatch.Elapsed, ex);
+         }
+      }
+
+      private static string GetPrefix(string root)
+      {
+         string prefix = Path.GetFullPath(root);
+         if (prefix[prefix.Length - 1] != Path.DirectorySeparatorChar && prefix[prefix.Length - 1] != Path.AltDirectorySeparatorChar)
+            prefix += Path.DirectorySeparatorChar;
+         return prefix;
+      }
+
+      private static string GetContainedPath(string prefix, string relativePath)
+      {
+         // Path.GetFullPath leaves \\?\ paths, such as a snapshot device object, unnormalized, so ".." segments are refused 
+         // explicitly as well.
+         if (Path.IsPathRooted(relativePath) || relativePath.Split(Path.DirectorySeparatorChar, Path.AltDirectorySeparatorChar).Contains(".."))
+            throw new ArgumentException("The path " + relativePath + " is not relative to the root.", nameof(relativePath));
+
+         string path = Path.GetFullPath(Path.Combine(prefix, relativePath));
+         if (path.Length <= prefix.Length || !path.StartsWith(prefix, StringComparison.Ordinal))
+            throw new ArgumentException("The path " + relativePath + " is not relative to the root.", nameof(relativePath));
+
+         return path;
+      }
+
+      #endregion
+
+      #region Nested Types
+
+      private sealed class CopyState
+      {
+         private readonly ConcurrentDictionary<string, bool> m_directories = new ConcurrentDictionary<string, bool>(StringComparer.OrdinalIgnoreCase);
+         private int m_next;
+
+         public long BytesCopied;
+
+         public CopyState(string[] paths, int workerCount, IProgress<VssFileCopyResult> progress)
+         {
+            Paths = paths;
+            Results = new VssFileCopyResult[paths.Length];
+            WorkerCount = workerCount;
+            Progress = progress;
+         }
+
+         public string[] Paths { get; private set; }
+         public VssFileCopyResult[] Results { get; private set; }
+         public int WorkerCount { get; private set; }
+         public IProgress<VssFileCopyResult> Progress { get; private set; }
+
+         // Guided self-scheduling: each claim takes a share of the remaining files proportional to the number of workers.
+         public bool TryClaim(out int start, out int count)
+         {
+            while (true)
+            {
+               int next = Volatile.Read(ref m_next);
+               int remaining = Paths.Length - next;
+               if (remaining <= 0)
+               {
+                  start = count = 0;
+                  return false;
+               }
+
+               int batch = Math.Max(1, Math.Min(MaxBatchSize, remaining / (2 * WorkerCount)));
+               if (Interlocked.CompareExchange(ref m_next, next + batch, next) == next)
+               {
+                  start = next;
+                  count = batch;
+                  return true;
+               }
+            }
+         }
+
+         public void EnsureDirectory(string directory)
+         {
+            if (!String.IsNullOrEmpty(directory) && !m_directories.ContainsKey(directory))
+            {
+               Directory.CreateDirectory(directory);
+               m_directories.TryAdd(directory, true);
+            }
+         }
+      }
+
+      #endregion
+   }
+}
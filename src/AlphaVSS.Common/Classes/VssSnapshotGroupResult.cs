@@ -0,0 +1,74 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// The outcome of creating the snapshot set of one consistency group with <see cref="VssSnapshotOrchestrator"/>.
+   /// </summary>
+   public sealed class VssSnapshotGroupResult
+   {
+      internal VssSnapshotGroupResult(IList<string> volumes, IVssBackupComponents backupComponents, Guid snapshotSetId, IList<VssSnapshotProperties> snapshots,
+         TimeSpan queueTime, TimeSpan snapshotTime, Exception exception)
+      {
+         Volumes = volumes;
+         BackupComponents = backupComponents;
+         SnapshotSetId = snapshotSetId;
+         Snapshots = snapshots;
+         QueueTime = queueTime;
+         SnapshotTime = snapshotTime;
+         Exception = exception;
+      }
+
+      /// <summary>
+      /// Gets the volumes of the consistency group.
+      /// </summary>
+      public IList<string> Volumes { get; private set; }
+
+      /// <summary>
+      /// Gets the backup components object that created the snapshot set, or <see langword="null"/> if the group failed.
+      /// </summary>
+      /// <remarks>
+      ///   The caller owns the object, and completes the backup with it, for instance by calling 
+      ///   <see cref="IVssBackupComponents.BackupComplete"/>, before disposing it. Disposing it deletes non-persistent snapshots.
+      /// </remarks>
+      public IVssBackupComponents BackupComponents { get; private set; }
+
+      /// <summary>
+      /// Gets the id of the snapshot set of the group, or <see cref="Guid.Empty"/> if the group failed before the snapshot set was started.
+      /// </summary>
+      public Guid SnapshotSetId { get; private set; }
+
+      /// <summary>
+      /// Gets the snapshots of the volumes of the group, or an empty list if the group failed.
+      /// </summary>
+      public IList<VssSnapshotProperties> Snapshots { get; private set; }
+
+      /// <summary>
+      /// Gets the time the group waited for other groups to finish creating their snapshot sets.
+      /// </summary>
+      public TimeSpan QueueTime { get; private set; }
+
+      /// <summary>
+      /// Gets the time <see cref="IVssBackupComponents.DoSnapshotSet"/> took for the group, which bounds the time writes were frozen.
+      /// </summary>
+      public TimeSpan SnapshotTime { get; private set; }
+
+      /// <summary>
+      /// Gets the exception that caused the group to fail, or <see langword="null"/> if its snapshot set was created.
+      /// </summary>
+      public Exception Exception { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the snapshot set of the group was created.
+      /// </summary>
+      public bool Succeeded
+      {
+         get
+         {
+            return Exception == null;
+         }
+      }
+   }
+}
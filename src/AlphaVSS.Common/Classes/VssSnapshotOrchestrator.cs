@@ -0,0 +1,406 @@
+
+using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Creates the snapshot sets of several independent consistency groups of volumes concurrently, one backup session per group.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///     A single backup components object creates a single snapshot set, so snapshotting many volumes without cross-volume 
+   ///     consistency requirements through one session freezes the writers of all of them for the whole snapshot. The 
+   ///     orchestrator instead runs the <see cref="IVssBackupComponents.GatherWriterMetadata"/>, 
+   ///     <see cref="IVssBackupComponents.PrepareForBackup"/> and <see cref="IVssBackupComponents.DoSnapshotSet"/> pipeline of each 
+   ///     group in a session of its own, overlapping the gathering of writer metadata and the configuration of the groups.
+   ///   </para>
+   ///   <para>
+   ///     VSS allows only one snapshot set on a system to be in progress, from <see cref="IVssBackupComponents.StartSnapshotSet"/> 
+   ///     until <see cref="IVssBackupComponents.DoSnapshotSet"/> completes or the backup is aborted. The groups are therefore queued 
+   ///     for that part of the pipeline, and run it one at a time. Should another requester on the system have a snapshot set in 
+   ///     progress, <see cref="IVssBackupComponents.StartSnapshotSet"/> or <see cref="IVssBackupComponents.DoSnapshotSet"/> is 
+   ///     retried as specified by <see cref="RetryCount"/> and <see cref="RetryDelay"/>.
+   ///   </para>
+   ///   <para>
+   ///     Use <see cref="Partition"/> to compute the consistency groups of a set of volumes. Configure an instance before calling 
+   ///     <see cref="CreateSnapshotSetsAsync"/>; it should not be reconfigured while snapshot sets are being created.
+   ///   </para>
+   /// </remarks>
+   public sealed class VssSnapshotOrchestrator
+   {
+      #region Private Fields
+
+      private readonly IVssFactory m_factory;
+      private int m_maxDegreeOfParallelism = Environment.ProcessorCount;
+      private int m_retryCount = 3;
+      private TimeSpan m_retryDelay = TimeSpan.FromSeconds(1);
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssSnapshotOrchestrator"/> class.
+      /// </summary>
+      /// <param name="factory">The factory creating the backup components object of each group.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="factory"/> is <see langword="null"/>.</exception>
+      public VssSnapshotOrchestrator(IVssFactory factory)
+      {
+         if (factory == null)
+            throw new ArgumentNullException(nameof(factory));
+
+         m_factory = factory;
+         Context = VssSnapshotContext.Backup;
+         BackupType = VssBackupType.Full;
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets or sets the context of the snapshots. The default is <see cref="VssSnapshotContext.Backup"/>.
+      /// </summary>
+      public VssSnapshotContext Context { get; set; }
+
+      /// <summary>
+      /// Gets or sets the type of the backup. The default is <see cref="VssBackupType.Full"/>.
+      /// </summary>
+      public VssBackupType BackupType { get; set; }
+
+      /// <summary>
+      /// Gets or sets a value indicating whether the backups select components explicitly, as specified to <see cref="IVssBackupComponents.SetBackupState"/>.
+      /// </summary>
+      public bool SelectComponents { get; set; }
+
+      /// <summary>
+      /// Gets or sets a value indicating whether the backups are bootable system state backups, as specified to <see cref="IVssBackupComponents.SetBackupState"/>.
+      /// </summary>
+      public bool BootableSystemStateBackup { get; set; }
+
+      /// <summary>
+      /// Gets or sets the action called for each group once writer metadata has been gathered, before the snapshot set is 
+      /// started, for instance to add the components of the group.
+      /// </summary>
+      /// <value>An action receiving the backup components object and the volumes of the group, or <see langword="null"/>.</value>
+      /// <remarks>The action may be called for several groups concurrently.</remarks>
+      public Action<IVssBackupComponents, IList<string>> ConfigureGroup { get; set; }
+
+      /// <summary>
+      /// Gets or sets the maximum number of groups processed concurrently. The default is the number of processors.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is less than one.</exception>
+      public int MaxDegreeOfParallelism
+      {
+         get
+         {
+            return m_maxDegreeOfParallelism;
+         }
+
+         set
+         {
+            if (value < 1)
+               throw new ArgumentOutOfRangeException(nameof(value), "The degree of parallelism must be greater than zero.");
+
+            m_maxDegreeOfParallelism = value;
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets how many times <see cref="IVssBackupComponents.StartSnapshotSet"/> and <see cref="IVssBackupComponents.DoSnapshotSet"/> 
+      /// are retried when another requester has a snapshot set in progress. The default is 3.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is negative.</exception>
+      public int RetryCount
+      {
+         get
+         {
+            return m_retryCount;
+         }
+
+         set
+         {
+            if (value < 0)
+               throw new ArgumentOutOfRangeException(nameof(value), "The retry count must not be negative.");
+
+            m_retryCount = value;
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets the time to wait before retrying <see cref="IVssBackupComponents.StartSnapshotSet"/> or 
+      /// <see cref="IVssBackupComponents.DoSnapshotSet"/>. The default is one second.
+      /// </summary>
+      /// <exception cref="ArgumentOutOfRangeException">The value is negative.</exception>
+      public TimeSpan RetryDelay
+      {
+         get
+         {
+            return m_retryDelay;
+         }
+
+         set
+         {
+            if (value < TimeSpan.Zero)
+               throw new ArgumentOutOfRangeException(nameof(value), "The retry delay must not be negative.");
+
+            m_retryDelay = value;
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Partitions volumes into the smallest consistency groups satisfying the specified constraints.
+      /// </summary>
+      /// <param name="volumes">The volumes to snapshot.</param>
+      /// <param name="constraints">
+      ///   Sets of volumes that must be snapshotted consistently, i.e. in the same snapshot set, for instance the volumes 
+      ///   containing the files of a single writer component. Volumes of a constraint that are not in <paramref name="volumes"/> 
+      ///   are added to the group. May be <see langword="null"/>, in which case every volume is a group of its own.
+      /// </param>
+      /// <returns>The consistency groups, ordered by the first occurrence of one of their volumes.</returns>
+      /// <remarks>Volume names are compared without regard to case or to a trailing backslash.</remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="volumes"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="volumes"/> or a constraint contains a <see langword="null"/> element.</exception>
+      public static IList<IList<string>> Partition(IEnumerable<string> volumes, IEnumerable<IEnumerable<string>> constraints)
+      {
+         if (volumes == null)
+            throw new ArgumentNullException(nameof(volumes));
+
+         Dictionary<string, int> indices = new Dictionary<string, int>(StringComparer.OrdinalIgnoreCase);
+         List<string> names = new List<string>();
+         List<int> parents = new List<int>();
+
+         Func<string, string, int> getIndex = (volume, paramName) =>
+         {
+            if (volume == null)
+               throw new ArgumentException("The sequence contains a null element.", paramName);
+
+            string key = volume.TrimEnd('\\');
+            int index;
+            if (!indices.TryGetValue(key, out index))
+            {
+               index = names.Count;
+               indices.Add(key, index);
+               names.Add(volume);
+               parents.Add(index);
+            }
+
+            return index;
+         };
+
+         foreach (string volume in volumes)
+            getIndex(volume, nameof(volumes));
+
+         if (constraints != null)
+         {
+            foreach (IEnumerable<string> constraint in constraints)
+            {
+               if (constraint == null)
+                  throw new ArgumentException("The sequence contains a null element.", nameof(constraints));
+
+               int first = -1;
+               foreach (string volume in constraint)
+               {
+                  int index = getIndex(volume, nameof(constraints));
+                  if (first < 0)
+                  {
+                     first = index;
+                     continue;
+                  }
+
+                  int rootA = Find(parents, first);
+                  int rootB = Find(parents, index);
+                  if (rootA != rootB)
+                     parents[Math.Max(rootA, rootB)] = Math.Min(rootA, rootB);
+               }
+            }
+         }
+
+         Dictionary<int, List<string>> groups = new Dictionary<int, List<string>>();
+         List<IList<string>> result = new List<IList<string>>();
+         for (int i = 0; i < names.Count; i++)
+         {
+            int root = Find(parents, i);
+            List<string> group;
+            if (!groups.TryGetValue(root, out group))
+            {
+               group = new List<string>();
+               groups.Add(root, group);
+               result.Add(group.AsReadOnly());
+            }
+
+            group.Add(names[i]);
+         }
+
+         return result.AsReadOnly();
+      }
+
+      /// <summary>
+      /// Creates a snapshot set for each of the specified consistency groups.
+      /// </summary>
+      /// <param name="groups">The consistency groups, each a non-empty set of volumes, usually computed by <see cref="Partition"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests.</param>
+      /// <returns>
+      ///   A task whose result contains the outcome of each group, in the order of <paramref name="groups"/>. The task does not fail 
+      ///   when groups fail; the result of a failed group carries its exception, and its session has been aborted and disposed. 
+      ///   Cancellation fails the groups whose snapshot sets have not been created yet.
+      /// </returns>
+      /// <exception cref="ArgumentNullException"><paramref name="groups"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="groups"/> contains a <see langword="null"/> or empty group.</exception>
+      public async Task<IList<VssSnapshotGroupResult>> CreateSnapshotSetsAsync(IEnumerable<IEnumerable<string>> groups, CancellationToken cancellationToken = default)
+      {
+         if (groups == null)
+            throw new ArgumentNullException(nameof(groups));
+
+         List<IList<string>> volumeGroups = new List<IList<string>>();
+         foreach (IEnumerable<string> group in groups)
+         {
+            IList<string> volumes = group == null ? null : new ReadOnlyCollection<string>(group.ToArray());
+            if (volumes == null || volumes.Count == 0 || volumes.Contains(null))
+               throw new ArgumentException("A group is null, empty or contains a null volume name.", nameof(groups));
+
+            volumeGroups.Add(volumes);
+         }
+
+         using (SemaphoreSlim throttle = new SemaphoreSlim(MaxDegreeOfParallelism))
+         using (SemaphoreSlim snapshotCreation = new SemaphoreSlim(1))
+         {
+            VssSnapshotGroupResult[] results = await Task.WhenAll(volumeGroups.Select(volumes =>
+               CreateSnapshotSetAsync(volumes, throttle, snapshotCreation, cancellationToken))).ConfigureAwait(false);
+
+            return new ReadOnlyCollection<VssSnapshotGroupResult>(results);
+         }
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private async Task<VssSnapshotGroupResult> CreateSnapshotSetAsync(IList<string> volumes, SemaphoreSlim throttle, SemaphoreSlim snapshotCreation, CancellationToken cancellationToken)
+      {
+         IVssBackupComponents backupComponents = null;
+         Guid snapshotSetId = Guid.Empty;
+         TimeSpan queueTime = TimeSpan.Zero;
+         TimeSpan snapshotTime = TimeSpan.Zero;
+         bool throttled = false;
+         bool aborted = false;
+         try
+         {
+            await throttle.WaitAsync(cancellationToken).ConfigureAwait(false);
+            throttled = true;
+
+            backupComponents = m_factory.CreateVssBackupComponents();
+            backupComponents.InitializeForBackup(null);
+            backupComponents.SetContext(Context);
+            backupComponents.SetBackupState(SelectComponents, BootableSystemStateBackup, BackupType, false);
+            await backupComponents.GatherWriterMetadataAsync(cancellationToken).ConfigureAwait(false);
+
+            Action<IVssBackupComponents, IList<string>> configureGroup = ConfigureGroup;
+            if (configureGroup != null)
+               configureGroup(backupComponents, volumes);
+
+            // The snapshot set is in progress from StartSnapshotSet until DoSnapshotSet completes, and only one snapshot set may 
+            // be in progress on the system at a time; the groups take turns from here.
+            List<Guid> snapshotIds = new List<Guid>(volumes.Count);
+            Stopwatch stopwatch = Stopwatch.StartNew();
+            await snapshotCreation.WaitAsync(cancellationToken).ConfigureAwait(false);
+            try
+            {
+               queueTime = stopwatch.Elapsed;
+               await RetryAsync(() => { snapshotSetId = backupComponents.StartSnapshotSet(); return Task.FromResult(0); }, cancellationToken).ConfigureAwait(false);
+               foreach (string volume in volumes)
+                  snapshotIds.Add(backupComponents.AddToSnapshotSet(volume));
+
+               await backupComponents.PrepareForBackupAsync(cancellationToken).ConfigureAwait(false);
+
+               stopwatch.Restart();
+               await RetryAsync(() => backupComponents.DoSnapshotSetAsync(cancellationToken), cancellationToken).ConfigureAwait(false);
+               snapshotTime = stopwatch.Elapsed;
+            }
+            catch (Exception)
+            {
+               // Abort before the next group starts its snapshot set, so that this one is no longer in progress.
+               aborted = true;
+               Abort(backupComponents);
+               throw;
+            }
+            finally
+            {
+               snapshotCreation.Release();
+            }
+
+            List<VssSnapshotProperties> snapshots = snapshotIds.Select(backupComponents.GetSnapshotProperties).ToList();
+            return new VssSnapshotGroupResult(volumes, backupComponents, snapshotSetId, snapshots.AsReadOnly(), queueTime, snapshotTime, null);
+         }
+         catch (Exception ex)
+         {
+            if (backupComponents != null)
+            {
+               if (!aborted)
+                  Abort(backupComponents);
+
+               backupComponents.Dispose();
+            }
+
+            return new VssSnapshotGroupResult(volumes, null, snapshotSetId, new List<VssSnapshotProperties>().AsReadOnly(), queueTime, snapshotTime, ex);
+         }
+         finally
+         {
+            if (throttled)
+               throttle.Release();
+         }
+      }
+
+      private async Task RetryAsync(Func<Task> operation, CancellationToken cancellationToken)
+      {
+         for (int attempt = 0; ; attempt++)
+         {
+            try
+            {
+               await operation().ConfigureAwait(false);
+               return;
+            }
+            catch (VssSnapshotSetInProgressException) when (attempt < RetryCount)
+            {
+            }
+
+            await Task.Delay(RetryDelay, cancellationToken).ConfigureAwait(false);
+         }
+      }
+
+      private static void Abort(IVssBackupComponents backupComponents)
+      {
+         try
+         {
+            backupComponents.AbortBackup();
+         }
+         catch (Exception)
+         {
+            // The session may not have progressed far enough to be aborted; the original exception is the one to report.
+         }
+      }
+
+      private static int Find(List<int> parents, int i)
+      {
+         while (parents[i] != i)
+         {
+            parents[i] = parents[parents[i]];
+            i = parents[i];
+         }
+
+         return i;
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,41 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Interns the strings of captured writer metadata. Paths, file specifications and logical paths repeat heavily across 
+   /// the components and writers of a system, so sharing a single instance of each saves most of the memory of a capture.
+   /// </summary>
+   /// <remarks>
+   /// Unlike <see cref="String.Intern"/>, the pool is not process-wide, and its strings are collected with the captured metadata.
+   /// </remarks>
+   internal sealed class VssStringPool
+   {
+      private readonly Dictionary<string, string> m_strings = new Dictionary<string, string>(StringComparer.Ordinal);
+
+      public string Intern(string value)
+      {
+         if (value == null)
+            return null;
+
+         string pooled;
+         if (m_strings.TryGetValue(value, out pooled))
+            return pooled;
+
+         m_strings.Add(value, value);
+         return value;
+      }
+
+      public VssWMFileDescriptor Intern(VssWMFileDescriptor file)
+      {
+         return new VssWMFileDescriptor(Intern(file.AlternateLocation), file.BackupTypeMask, Intern(file.FileSpecification), Intern(file.Path), file.IsRecursive);
+      }
+
+      public VssWMDependency Intern(VssWMDependency dependency)
+      {
+         return new VssWMDependency(dependency.WriterId, Intern(dependency.LogicalPath), Intern(dependency.ComponentName));
+      }
+   }
+}
@@ -0,0 +1,328 @@
+
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A persistent, on-disk cache of Writer Metadata Documents, keyed by writer class and instance.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///     <see cref="IVssBackupComponents.GatherWriterMetadata"/> is usually the slowest step of a backup, since every writer on the 
+   ///     system has to respond, yet the metadata of a writer instance rarely changes between backups. The cache allows a 
+   ///     requester to start planning and selecting components from the metadata of the previous backup, using <see cref="Load(IVssFactory)"/>, 
+   ///     while the live metadata is gathered by <see cref="RefreshAsync"/>. The <see cref="VssWriterMetadataDiff"/> reported by 
+   ///     <see cref="RefreshAsync"/> tells the requester whether, and for which writers, the plan needs to be revised.
+   ///   </para>
+   ///   <para>
+   ///     Every entry stores the document returned by <see cref="IVssExamineWriterMetadata.SaveAsXml"/>, the writer version, and 
+   ///     a 64-bit FNV-1a fingerprint of the document. The fingerprint protects the entry against damage: entries whose document 
+   ///     no longer matches their fingerprint, or that VSS fails to load, are discarded. Cached and live documents are compared 
+   ///     directly by <see cref="Compare"/>.
+   ///   </para>
+   ///   <para>
+   ///     Instances are not thread-safe, and a cache directory should only be used by one process at a time.
+   ///   </para>
+   /// </remarks>
+   public sealed class VssWriterMetadataCache
+   {
+      #region Private Fields
+
+      private const string EntryExtension = ".wmd";
+      private const string EntryHeader = "AlphaVSS-WMD 1";
+      private const ulong FnvOffsetBasis = 14695981039346656037;
+      private const ulong FnvPrime = 1099511628211;
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssWriterMetadataCache"/> class.
+      /// </summary>
+      /// <param name="directory">The directory holding the cache entries. It is created when the first entry is stored.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="directory"/> is <see langword="null"/>.</exception>
+      public VssWriterMetadataCache(string directory)
+      {
+         if (directory == null)
+            throw new ArgumentNullException(nameof(directory));
+
+         Directory = directory;
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the directory holding the cache entries.
+      /// </summary>
+      public string Directory { get; private set; }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Computes the 64-bit FNV-1a fingerprint of a Writer Metadata Document.
+      /// </summary>
+      /// <param name="xml">The document.</param>
+      /// <returns>The fingerprint of <paramref name="xml"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="xml"/> is <see langword="null"/>.</exception>
+      public static ulong ComputeFingerprint(string xml)
+      {
+         if (xml == null)
+            throw new ArgumentNullException(nameof(xml));
+
+         ulong hash = FnvOffsetBasis;
+         for (int i = 0; i < xml.Length; i++)
+         {
+            char c = xml[i];
+            hash = (hash ^ (byte)c) * FnvPrime;
+            hash = (hash ^ (byte)(c >> 8)) * FnvPrime;
+         }
+
+         return hash;
+      }
+
+      /// <summary>
+      /// Loads all cached writer metadata.
+      /// </summary>
+      /// <param name="factory">The factory used to load the cached documents, through <see cref="IVssFactory.CreateVssExamineWriterMetadata"/>.</param>
+      /// <returns>A read-only list containing the cached metadata of every writer instance. The list is empty if nothing is cached.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="factory"/> is <see langword="null"/>.</exception>
+      public IList<VssCapturedWriterMetadata> Load(IVssFactory factory)
+      {
+         if (factory == null)
+            throw new ArgumentNullException(nameof(factory));
+
+         List<VssCapturedWriterMetadata> result = new List<VssCapturedWriterMetadata>();
+         if (!System.IO.Directory.Exists(Directory))
+            return result.AsReadOnly();
+
+         VssStringPool pool = new VssStringPool();
+         foreach (string path in System.IO.Directory.GetFiles(Directory, "*" + EntryExtension))
+         {
+            VssCapturedWriterMetadata metadata = LoadEntry(factory, path, pool);
+            if (metadata != null)
+               result.Add(metadata);
+         }
+
+         return result.AsReadOnly();
+      }
+
+      /// <summary>
+      /// Loads the cached metadata of the specified writer instance.
+      /// </summary>
+      /// <param name="factory">The factory used to load the cached document, through <see cref="IVssFactory.CreateVssExamineWriterMetadata"/>.</param>
+      /// <param name="writerId">The class id of the writer.</param>
+      /// <param name="instanceId">The instance id of the writer.</param>
+      /// <returns>The cached metadata, or <see langword="null"/> if the writer instance is not cached.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="factory"/> is <see langword="null"/>.</exception>
+      public VssCapturedWriterMetadata Load(IVssFactory factory, Guid writerId, Guid instanceId)
+      {
+         if (factory == null)
+            throw new ArgumentNullException(nameof(factory));
+
+         string path = GetEntryPath(writerId, instanceId);
+         return File.Exists(path) ? LoadEntry(factory, path, new VssStringPool()) : null;
+      }
+
+      /// <summary>
+      /// Stores the specified writer metadata in the cache, replacing any entry for the same writer instance.
+      /// </summary>
+      /// <param name="metadata">The writer metadata to store.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="metadata"/> is <see langword="null"/>.</exception>
+      public void Store(IVssExamineWriterMetadata metadata)
+      {
+         if (metadata == null)
+            throw new ArgumentNullException(nameof(metadata));
+
+         string xml = metadata.SaveAsXml();
+         Version version = GetVersion(metadata);
+
+         StringBuilder entry = new StringBuilder(xml.Length + 64);
+         entry.Append(EntryHeader).Append('\n');
+         entry.Append(version == null ? "-" : version.ToString()).Append('\n');
+         entry.Append(ComputeFingerprint(xml).ToString("x16", CultureInfo.InvariantCulture)).Append('\n');
+         entry.Append(xml);
+
+         System.IO.Directory.CreateDirectory(Directory);
+
+         // Written to a temporary file first, so that an interrupted write never leaves a truncated entry behind.
+         string path = GetEntryPath(metadata.WriterId, metadata.InstanceId);
+         string temporaryPath = path + ".tmp";
+         File.WriteAllText(temporaryPath, entry.ToString(), Encoding.UTF8);
+         if (File.Exists(path))
+            File.Replace(temporaryPath, path, null);
+         else
+            File.Move(temporaryPath, path);
+      }
+
+      /// <summary>
+      /// Replaces the contents of the cache with the specified writer metadata.
+      /// </summary>
+      /// <param name="metadata">The metadata of all writers.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="metadata"/> is <see langword="null"/>.</exception>
+      public void StoreAll(IEnumerable<IVssExamineWriterMetadata> metadata)
+      {
+         if (metadata == null)
+            throw new ArgumentNullException(nameof(metadata));
+
+         HashSet<string> stored = new HashSet<string>(StringComparer.OrdinalIgnoreCase);
+         foreach (IVssExamineWriterMetadata item in metadata)
+         {
+            Store(item);
+            stored.Add(GetEntryPath(item.WriterId, item.InstanceId));
+         }
+
+         if (System.IO.Directory.Exists(Directory))
+         {
+            foreach (string path in System.IO.Directory.GetFiles(Directory, "*" + EntryExtension))
+            {
+               if (!stored.Contains(path))
+                  File.Delete(path);
+            }
+         }
+      }
+
+      /// <summary>
+      /// Removes all entries from the cache.
+      /// </summary>
+      public void Clear()
+      {
+         if (!System.IO.Directory.Exists(Directory))
+            return;
+
+         foreach (string path in System.IO.Directory.GetFiles(Directory, "*" + EntryExtension))
+            File.Delete(path);
+      }
+
+      /// <summary>
+      /// Compares cached writer metadata with live writer metadata.
+      /// </summary>
+      /// <param name="cached">The cached writer metadata, as returned by <see cref="Load(IVssFactory)"/>.</param>
+      /// <param name="live">The live writer metadata.</param>
+      /// <returns>The differences between <paramref name="cached"/> and <paramref name="live"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="cached"/> or <paramref name="live"/> is <see langword="null"/>.</exception>
+      public static VssWriterMetadataDiff Compare(IEnumerable<VssCapturedWriterMetadata> cached, IEnumerable<VssCapturedWriterMetadata> live)
+      {
+         if (cached == null)
+            throw new ArgumentNullException(nameof(cached));
+
+         if (live == null)
+            throw new ArgumentNullException(nameof(live));
+
+         Dictionary<Guid, VssCapturedWriterMetadata> remaining = cached.ToDictionary(metadata => metadata.InstanceId);
+         List<VssCapturedWriterMetadata> added = new List<VssCapturedWriterMetadata>();
+         List<VssCapturedWriterMetadata> changed = new List<VssCapturedWriterMetadata>();
+
+         foreach (VssCapturedWriterMetadata metadata in live)
+         {
+            VssCapturedWriterMetadata previous;
+            if (!remaining.TryGetValue(metadata.InstanceId, out previous))
+            {
+               added.Add(metadata);
+               continue;
+            }
+
+            remaining.Remove(metadata.InstanceId);
+            // The documents are compared ordinally, which stops at the first difference and, unlike hashing both documents, 
+            // costs nothing beyond a length check when their lengths differ.
+            if (previous.WriterId != metadata.WriterId || !Equals(previous.Version, metadata.Version) ||
+               !String.Equals(previous.SaveAsXml(), metadata.SaveAsXml(), StringComparison.Ordinal))
+            {
+               changed.Add(metadata);
+            }
+         }
+
+         return new VssWriterMetadataDiff(added, remaining.Values, changed);
+      }
+
+      /// <summary>
+      /// Gathers the live writer metadata, compares it with the cached writer metadata, and updates the cache.
+      /// </summary>
+      /// <param name="backupComponents">
+      ///   A backup components object that has been initialized for backup, and on which writer metadata has not yet been gathered.
+      /// </param>
+      /// <param name="cached">The cached writer metadata, as returned by <see cref="Load(IVssFactory)"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests.</param>
+      /// <returns>A task whose result is the difference between <paramref name="cached"/> and the live writer metadata.</returns>
+      /// <remarks>
+      ///   When the task completes, the live writer metadata is available through <see cref="IVssBackupComponents.WriterMetadata"/> 
+      ///   of <paramref name="backupComponents"/>, and has replaced the contents of the cache.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> or <paramref name="cached"/> is <see langword="null"/>.</exception>
+      public async Task<VssWriterMetadataDiff> RefreshAsync(IVssBackupComponents backupComponents, IEnumerable<VssCapturedWriterMetadata> cached, CancellationToken cancellationToken)
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException(nameof(backupComponents));
+
+         if (cached == null)
+            throw new ArgumentNullException(nameof(cached));
+
+         await backupComponents.GatherWriterMetadataAsync(cancellationToken).ConfigureAwait(false);
+
+         IList<VssCapturedWriterMetadata> live = backupComponents.CaptureWriterMetadata();
+         VssWriterMetadataDiff diff = Compare(cached, live);
+         if (!diff.IsEmpty)
+            StoreAll(live);
+
+         return diff;
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private string GetEntryPath(Guid writerId, Guid instanceId)
+      {
+         return Path.Combine(Directory, writerId.ToString("N", CultureInfo.InvariantCulture) + "-" + instanceId.ToString("N", CultureInfo.InvariantCulture) + EntryExtension);
+      }
+
+      private static Version GetVersion(IVssExamineWriterMetadata metadata)
+      {
+         try
+         {
+            return metadata.Version;
+         }
+         catch (UnsupportedOperatingSystemException)
+         {
+            return null;
+         }
+      }
+
+      private static VssCapturedWriterMetadata LoadEntry(IVssFactory factory, string path, VssStringPool pool)
+      {
+         string[] entry = File.ReadAllText(path, Encoding.UTF8).Split(new[] { '\n' }, 4);
+
+         ulong fingerprint;
+         if (entry.Length == 4 && entry[0] == EntryHeader &&
+            UInt64.TryParse(entry[2], NumberStyles.AllowHexSpecifier, CultureInfo.InvariantCulture, out fingerprint) &&
+            fingerprint == ComputeFingerprint(entry[3]))
+         {
+            try
+            {
+               using (IVssExamineWriterMetadata metadata = factory.CreateVssExamineWriterMetadata(entry[3]))
+                  return VssCapturedWriterMetadata.Capture(metadata, pool, entry[3]);
+            }
+            catch (VssInvalidXmlDocumentException)
+            {
+            }
+         }
+
+         // The entry is damaged, or was written by an incompatible version; it is discarded rather than reported.
+         File.Delete(path);
+         return null;
+      }
+
+      #endregion
+   }
+}
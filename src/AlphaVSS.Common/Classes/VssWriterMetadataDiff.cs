@@ -0,0 +1,57 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// The differences between cached writer metadata and the writer metadata gathered from the live writers, as reported by 
+   /// <see cref="VssWriterMetadataCache.RefreshAsync"/> and <see cref="VssWriterMetadataCache.Compare"/>.
+   /// </summary>
+   [Serializable]
+   public sealed class VssWriterMetadataDiff
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssWriterMetadataDiff"/> class.
+      /// </summary>
+      /// <param name="added">The live metadata of writer instances that were not cached.</param>
+      /// <param name="removed">The cached metadata of writer instances that are no longer present.</param>
+      /// <param name="changed">The live metadata of writer instances whose metadata differs from the cached metadata.</param>
+      public VssWriterMetadataDiff(IEnumerable<VssCapturedWriterMetadata> added, IEnumerable<VssCapturedWriterMetadata> removed, IEnumerable<VssCapturedWriterMetadata> changed)
+      {
+         Added = VssCapturedComponent.ToReadOnly(added, nameof(added));
+         Removed = VssCapturedComponent.ToReadOnly(removed, nameof(removed));
+         Changed = VssCapturedComponent.ToReadOnly(changed, nameof(changed));
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the live metadata of writer instances that were not cached.
+      /// </summary>
+      public IList<VssCapturedWriterMetadata> Added { get; private set; }
+
+      /// <summary>
+      /// Gets the cached metadata of writer instances that are no longer present.
+      /// </summary>
+      public IList<VssCapturedWriterMetadata> Removed { get; private set; }
+
+      /// <summary>
+      /// Gets the live metadata of writer instances whose Writer Metadata Document, including its version, differs from the cached one.
+      /// </summary>
+      public IList<VssCapturedWriterMetadata> Changed { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the cached metadata matched the live metadata exactly.
+      /// </summary>
+      public bool IsEmpty
+      {
+         get
+         {
+            return Added.Count == 0 && Removed.Count == 0 && Changed.Count == 0;
+         }
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,116 @@
+
+using System;
+using System.Globalization;
+using System.Xml;
+using System.Xml.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Conversions between attribute values of VSS XML documents and their managed counterparts.
+   /// </summary>
+   internal static class VssXmlConvert
+   {
+      public static string ToString(bool value)
+      {
+         return value ? "yes" : "no";
+      }
+
+      public static string ToString(Guid value)
+      {
+         return value.ToString("D", CultureInfo.InvariantCulture);
+      }
+
+      public static string ToString(VssComponentType value)
+      {
+         switch (value)
+         {
+            case VssComponentType.Database:
+               return "database";
+            case VssComponentType.FileGroup:
+               return "filegroup";
+            default:
+               return "undefined";
+         }
+      }
+
+      public static bool ToBoolean(string value)
+      {
+         return value != null && (value.Equals("yes", StringComparison.OrdinalIgnoreCase) || value.Equals("true", StringComparison.OrdinalIgnoreCase) || value == "1");
+      }
+
+      public static string ToString(DateTime value)
+      {
+         return XmlConvert.ToString(value, XmlDateTimeSerializationMode.Utc);
+      }
+
+      public static Guid ToGuid(string value)
+      {
+         Guid result;
+         return value != null && Guid.TryParse(value, out result) ? result : Guid.Empty;
+      }
+
+      public static DateTime ToDateTime(string value)
+      {
+         if (String.IsNullOrEmpty(value))
+            return DateTime.MinValue;
+
+         // Accept both XML timestamps and FILETIME values, decimal or hexadecimal with a 0x prefix.
+         long fileTime;
+         if (value.StartsWith("0x", StringComparison.OrdinalIgnoreCase)
+               ? Int64.TryParse(value.Substring(2), NumberStyles.AllowHexSpecifier, CultureInfo.InvariantCulture, out fileTime)
+               : Int64.TryParse(value, NumberStyles.None, CultureInfo.InvariantCulture, out fileTime))
+            return fileTime > 0 && fileTime <= DateTime.MaxValue.ToFileTimeUtc() ? DateTime.FromFileTimeUtc(fileTime) : DateTime.MinValue;
+
+         DateTime result;
+         return DateTime.TryParse(value, CultureInfo.InvariantCulture, DateTimeStyles.AdjustToUniversal | DateTimeStyles.AssumeUniversal, out result) ? result : DateTime.MinValue;
+      }
+
+      public static VssComponentType ToComponentType(string value)
+      {
+         if ("database".Equals(value, StringComparison.OrdinalIgnoreCase))
+            return VssComponentType.Database;
+
+         if ("filegroup".Equals(value, StringComparison.OrdinalIgnoreCase))
+            return VssComponentType.FileGroup;
+
+         return VssComponentType.Undefined;
+      }
+
+      public static string GetString(XElement element, string attributeName)
+      {
+         XAttribute attribute = element.Attribute(attributeName);
+         return attribute == null ? null : attribute.Value;
+      }
+
+      public static bool GetBoolean(XElement element, string attributeName)
+      {
+         return ToBoolean(GetString(element, attributeName));
+      }
+
+      public static Guid GetGuid(XElement element, string attributeName)
+      {
+         return ToGuid(GetString(element, attributeName));
+      }
+
+      public static int GetInt32(XElement element, string attributeName)
+      {
+         string value = GetString(element, attributeName);
+         int result;
+         return value != null && Int32.TryParse(value, NumberStyles.Integer, CultureInfo.InvariantCulture, out result) ? result : 0;
+      }
+
+      public static T GetEnum<T>(XElement element, string attributeName) where T : struct
+      {
+         string value = GetString(element, attributeName);
+         T result;
+         return value != null && Enum.TryParse(value, true, out result) ? result : default(T);
+      }
+
+      public static void SetAttribute(XElement element, string attributeName, string value)
+      {
+         if (value != null)
+            element.SetAttributeValue(attributeName, value);
+      }
+   }
+}
@@ -0,0 +1,58 @@
+
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Identifies the properties of a component that differ between two saved Backup Components Documents, as reported by 
+   /// <see cref="VssBackupDocumentDiff"/>.
+   /// </summary>
+   [Flags]
+   public enum VssBackupDocumentChanges
+   {
+      /// <summary>
+      /// The component is the same in both documents.
+      /// </summary>
+      None = 0,
+
+      /// <summary>
+      /// The type of the component differs.
+      /// </summary>
+      ComponentType = 0x01,
+
+      /// <summary>
+      /// Whether the backup of the component succeeded differs.
+      /// </summary>
+      BackupSucceeded = 0x02,
+
+      /// <summary>
+      /// The backup stamp of the component differs.
+      /// </summary>
+      BackupStamp = 0x04,
+
+      /// <summary>
+      /// The previous backup stamp of the component differs.
+      /// </summary>
+      PreviousBackupStamp = 0x08,
+
+      /// <summary>
+      /// The backup options of the component differ.
+      /// </summary>
+      BackupOptions = 0x10,
+
+      /// <summary>
+      /// The set of partial files of the component differs, i.e. files were added or removed.
+      /// </summary>
+      PartialFiles = 0x20,
+
+      /// <summary>
+      /// The partial files of the component are the same, but their ranges or metadata differ.
+      /// </summary>
+      PartialFileRanges = 0x40,
+
+      /// <summary>
+      /// The differenced files of the component differ.
+      /// </summary>
+      DifferencedFiles = 0x80
+   }
+}
@@ -0,0 +1,39 @@
+
+using System;
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// 	Identifies the list of a Writer Metadata Document that a <see cref="VssWMFileDescriptor"/> was taken from, and thereby 
+   /// 	the role of the files it describes.
+   /// </summary>
+   /// <seealso cref="VssFileSpecificationMatcher"/>
+   public enum VssFileSpecificationRole
+   {
+      /// <summary>
+      /// 	The descriptor is one of the <see cref="IVssWMComponent.Files"/> of a file group component.
+      /// </summary>
+      File = 0,
+
+      /// <summary>
+      /// 	The descriptor is one of the <see cref="IVssWMComponent.DatabaseFiles"/> of a database component.
+      /// </summary>
+      DatabaseFile = 1,
+
+      /// <summary>
+      /// 	The descriptor is one of the <see cref="IVssWMComponent.DatabaseLogFiles"/> of a database component.
+      /// </summary>
+      DatabaseLogFile = 2,
+
+      /// <summary>
+      /// 	The descriptor is one of the <see cref="IVssExamineWriterMetadata.ExcludeFiles"/> of a writer; matching files 
+      /// 	should not be backed up.
+      /// </summary>
+      ExcludeFile = 3,
+
+      /// <summary>
+      /// 	The descriptor is one of the <see cref="IVssExamineWriterMetadata.ExcludeFromSnapshotFiles"/> of a writer; matching 
+      /// 	files are not consistent in the snapshot, and should not be backed up from it.
+      /// </summary>
+      ExcludeFromSnapshotFile = 4
+   }
+}
@@ -0,0 +1,52 @@
+
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Identifies the rules of a <see cref="VssRetentionPolicy"/> that retain a snapshot set.
+   /// </summary>
+   [Flags]
+   public enum VssRetentionReasons
+   {
+      /// <summary>
+      /// No rule retains the snapshot set; it has expired.
+      /// </summary>
+      None = 0,
+
+      /// <summary>
+      /// The snapshot set is one of the most recent sets, as specified by <see cref="VssRetentionPolicy.KeepLatest"/>.
+      /// </summary>
+      Latest = 0x01,
+
+      /// <summary>
+      /// The snapshot set is younger than <see cref="VssRetentionPolicy.MinimumAge"/>.
+      /// </summary>
+      MinimumAge = 0x02,
+
+      /// <summary>
+      /// The snapshot set is the most recent of its hour, as specified by <see cref="VssRetentionPolicy.KeepHourly"/>.
+      /// </summary>
+      Hourly = 0x04,
+
+      /// <summary>
+      /// The snapshot set is the most recent of its day, as specified by <see cref="VssRetentionPolicy.KeepDaily"/>.
+      /// </summary>
+      Daily = 0x08,
+
+      /// <summary>
+      /// The snapshot set is the most recent of its week, as specified by <see cref="VssRetentionPolicy.KeepWeekly"/>.
+      /// </summary>
+      Weekly = 0x10,
+
+      /// <summary>
+      /// The snapshot set is the most recent of its month, as specified by <see cref="VssRetentionPolicy.KeepMonthly"/>.
+      /// </summary>
+      Monthly = 0x20,
+
+      /// <summary>
+      /// The snapshot set is the most recent of its year, as specified by <see cref="VssRetentionPolicy.KeepYearly"/>.
+      /// </summary>
+      Yearly = 0x40
+   }
+}
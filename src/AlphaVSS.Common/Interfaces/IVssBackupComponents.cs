@@ -670,11 +670,11 @@ namespace Alphaleonis.Win32.Vss
       void EndGatherWriterMetadata(IAsyncResult asyncResult);
 
       /// <summary>      
-      /// 	The <see cref="GatherWriterMetadataAsync"/> method asynchronously prompts each writer to send the metadata they have collected. 
+      /// 	The <see cref="GatherWriterMetadataAsync(CancellationToken)"/> method asynchronously prompts each writer to send the metadata they have collected. 
       /// 	The method will generate an <c>Identify</c> event to communicate with writers.
       /// </summary>
       /// <remarks>
-      /// <para><see cref="GatherWriterMetadataAsync"/> should be called only once during the lifetime of a given <see cref="IVssBackupComponents"/> object.</para>
+      /// <para><see cref="GatherWriterMetadataAsync(CancellationToken)"/> should be called only once during the lifetime of a given <see cref="IVssBackupComponents"/> object.</para>
       /// </remarks>
       /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>      
       /// <returns>
@@ -704,7 +704,7 @@ namespace Alphaleonis.Win32.Vss
       void GatherWriterStatus();
 
       /// <summary>
-      /// 	The <see cref="GatherWriterStatusAsync"/> method asynchronously prompts each writer to send a status message.
+      /// 	The <see cref="GatherWriterStatusAsync(CancellationToken)"/> method asynchronously prompts each writer to send a status message.
       /// </summary>
       /// <remarks>
       /// <para>The caller of this method should also call <see cref="IVssBackupComponents.FreeWriterStatus"/> after receiving the status of each writer.</para>
@@ -867,7 +867,7 @@ namespace Alphaleonis.Win32.Vss
       /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>		
       /// <exception cref="VssObjectNotFoundException">The specified shadow copy does not exist.</exception>
       IList<VssWriterStatusInfo> WriterStatus { get; }
-      
+
       #region ImportSnapshots
 
       /// <summary>
@@ -1059,7 +1059,7 @@ namespace Alphaleonis.Win32.Vss
       void PostRestore();
 
       /// <summary>
-      ///	The <see cref="PostRestoreAsync"/> method will asynchronously cause VSS to generate a <c>PostRestore</c> event, signaling writers that the current 
+      ///	The <see cref="PostRestoreAsync(CancellationToken)"/> method will asynchronously cause VSS to generate a <c>PostRestore</c> event, signaling writers that the current 
       ///	restore operation has finished.
       /// </summary>
       /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
@@ -1132,12 +1132,12 @@ namespace Alphaleonis.Win32.Vss
       void PrepareForBackup();
       
       /// <summary>
-      /// 	The <see cref="PrepareForBackupAsync"/> method will asynchronously cause VSS to generate a PrepareForBackup event, signaling writers to prepare for an upcoming 
+      /// 	The <see cref="PrepareForBackupAsync(CancellationToken)"/> method will asynchronously cause VSS to generate a PrepareForBackup event, signaling writers to prepare for an upcoming 
       /// 	backup operation. This makes a requester's Backup Components Document available to writers.
       /// </summary>
       /// <remarks>
       /// 	<para>
-      /// 		<see cref="PrepareForBackupAsync"/> generates a <c>PrepareForBackup</c> event, which is handled by each instance of each writer 
+      /// 		<see cref="PrepareForBackupAsync(CancellationToken)"/> generates a <c>PrepareForBackup</c> event, which is handled by each instance of each writer 
       /// 		through the CVssWriter::OnPrepareBackup method.
       /// 	</para>
       /// 	<para>
@@ -1208,7 +1208,7 @@ namespace Alphaleonis.Win32.Vss
       void PreRestore();
 
       /// <summary>
-      /// The <see cref="PreRestoreAsync"/> method will asynchronously cause VSS to generate a <c>PreRestore</c> event, signaling writers to prepare for a 
+      /// The <see cref="PreRestoreAsync(CancellationToken)"/> method will asynchronously cause VSS to generate a <c>PreRestore</c> event, signaling writers to prepare for a 
       /// coming restore operation.
       /// </summary>
       /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
@@ -1256,13 +1256,13 @@ namespace Alphaleonis.Win32.Vss
       #endregion
 
       /// <summary>
-      /// 	The <see cref="QuerySnapshots"/> method queries the completed shadow copies in the system that reside in the current context. 
+      /// 	The <see cref="QuerySnapshots()"/> method queries the completed shadow copies in the system that reside in the current context. 
       /// 	The method can be called only during backup operations.
       /// </summary>
       /// <returns>A list of <see cref="VssSnapshotProperties"/> objects representing the requested information.</returns>
       /// <remarks>
       /// 	 <para>
-      /// 		Because <see cref="QuerySnapshots"/> returns only information on completed shadow copies, the only shadow copy state it can disclose 
+      /// 		Because <see cref="QuerySnapshots()"/> returns only information on completed shadow copies, the only shadow copy state it can disclose 
       /// 		is <see cref="VssSnapshotState.Created"/>.
       /// 	 </para>
       /// 	 <para>
@@ -1272,9 +1272,13 @@ namespace Alphaleonis.Win32.Vss
       /// 	 <para>
       /// 		The method will return only information 
       /// 		about shadow copies with the current context (set by <see cref="IVssBackupComponents.SetContext(VssSnapshotContext)"/>). For instance, if the 
-      /// 		<see cref="VssSnapshotContext"/> context is set to <see cref="VssSnapshotContext.Backup"/>, <see cref="QuerySnapshots"/> will not 
+      /// 		<see cref="VssSnapshotContext"/> context is set to <see cref="VssSnapshotContext.Backup"/>, <see cref="QuerySnapshots()"/> will not 
       /// 		return information on a shadow copy created with a context of <see cref="VssSnapshotContext.FileShareBackup" />.
       /// 	 </para>
+      /// 	 <para>
+      /// 		The properties of all shadow copies are retrieved before this method returns. To enumerate them lazily, fetching the 
+      /// 		properties in batches of a specific size, use <see cref="VssBackupComponentsExtensions.QuerySnapshots(IVssBackupComponents, int)"/>.
+      /// 	 </para>
       /// </remarks>
       /// <exception cref="ArgumentException">One of the parameter values is not valid.</exception>
       /// <exception cref="UnauthorizedAccessException">The caller is not an administrator or a backup operator.</exception>
@@ -1427,7 +1431,7 @@ namespace Alphaleonis.Win32.Vss
       /// <remarks>
       /// 	<para>For a typical backup operation, SaveAsXml should not be called until after both writers and the requester are finished modifying the Backup Components Document.</para>
       /// 	<para>Writers can continue to modify the Backup Components Document until their successful return from handling the PostSnapshot event (CVssWriter::OnPostSnapshot), or equivalently upon the completion of <see cref="DoSnapshotSet"/>.</para>
-      /// 	<para>Requesters will need to continue to modify the Backup Components Document as the backup progresses. In particular, a requester will store a component-by-component record of the success or failure of the backup through calls to the <see cref="SetBackupSucceeded"/> method.</para>
+      /// 	<para>Requesters will need to continue to modify the Backup Components Document as the backup progresses. In particular, a requester will store a component-by-component record of the success or failure of the backup through calls to the <see cref="SetBackupSucceeded(Guid, Guid, VssComponentType, string, string, bool)"/> method.</para>
       /// 	<para>Once the requester has finished modifying the Backup Components Document, the requester should use <see cref="SaveAsXml"/> to save a copy of the document to the backup media.</para>
       /// 	<para>A Backup Components Document can be saved at earlier points in the life cycle of a backup operation, for instance, to support the generation of transportable shadow copies to be handled on remote machines.</para>
       /// 	<para>However, <see cref="SaveAsXml"/> should never be called prior to <see cref="PrepareForBackup"/>, because the Backup Components Document will not have been filled by the requester and the writers.</para>
@@ -1628,7 +1632,7 @@ namespace Alphaleonis.Win32.Vss
       /// 		writers the state of each components backup using <see cref="IVssComponent.BackupSucceeded"/>.
       /// 	</para>
       /// 	<para>
-      /// 		Therefore, a well-behaved backup application (requester) must call <see cref="SetBackupSucceeded"/> after each component has been 
+      /// 		Therefore, a well-behaved backup application (requester) must call <see cref="SetBackupSucceeded(Guid, Guid, VssComponentType, string, string, bool)"/> after each component has been 
       /// 		processed and prior to calling <see cref="BackupComplete"/>.
       /// 	</para>
       /// </remarks>
@@ -0,0 +1,178 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Optional interface implemented by <see cref="IVssBackupComponents"/> implementations that support retrieving and 
+   /// updating information in batches. 
+   /// </summary>
+   /// <remarks>
+   ///   Callers should not call the methods of this interface directly, but rather the extension methods of 
+   ///   <see cref="VssBackupComponentsExtensions"/>, which fall back to the single item methods of <see cref="IVssBackupComponents"/> 
+   ///   for implementations that do not implement this interface. 
+   /// </remarks>
+   public interface IVssBatchBackupComponents : IVssBackupComponents
+   {
+      /// <summary>
+      /// 	The <see cref="QuerySnapshots(int)"/> method queries the completed shadow copies in the system that reside in the current context,
+      /// 	fetching the properties of <paramref name="batchSize"/> shadow copies at a time from VSS.
+      /// 	The method can be called only during backup operations.
+      /// </summary>
+      /// <param name="batchSize">The maximum number of shadow copies to retrieve from VSS in a single call. Must be greater than zero.</param>
+      /// <returns>A lazily evaluated sequence of <see cref="VssSnapshotProperties"/> objects representing the requested information.</returns>
+      /// <remarks>
+      /// 	 <para>
+      /// 		The query is issued when this method is called, but the shadow copy properties are retrieved from VSS in batches and 
+      /// 		converted to <see cref="VssSnapshotProperties"/> instances only as the returned sequence is enumerated. This 
+      /// 		avoids one round trip to the VSS service per shadow copy, and avoids keeping the properties of all shadow copies in 
+      /// 		memory at once. 
+      /// 	 </para>
+      /// 	 <para>
+      /// 		Errors reported by VSS while retrieving the properties are thrown from <see cref="System.Collections.IEnumerator.MoveNext"/> 
+      /// 		rather than from this method. The sequence can be enumerated only once; the underlying VSS enumerator is released 
+      /// 		as soon as the enumeration completes or its enumerator is disposed.
+      /// 	 </para>
+      /// 	 <para>
+      /// 		Unlike this method, <see cref="IVssBackupComponents.QuerySnapshots()"/> retrieves the properties of all shadow copies 
+      /// 		before returning. See <see cref="IVssBackupComponents.QuerySnapshots()"/> for more information.
+      /// 	 </para>
+      /// </remarks>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="batchSize"/> is less than one.</exception>
+      /// <exception cref="ArgumentException">One of the parameter values is not valid.</exception>
+      /// <exception cref="UnauthorizedAccessException">The caller is not an administrator or a backup operator.</exception>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>		
+      /// <exception cref="VssObjectNotFoundException">The queried object is not found.</exception>
+      /// <exception cref="VssProviderVetoException">Expected provider error. The provider logged the error in the event log.</exception>
+      /// <exception cref="VssUnexpectedProviderErrorException">Unexpected provider error. The error code is logged in the error log.</exception>		
+      IEnumerable<VssSnapshotProperties> QuerySnapshots(int batchSize);
+
+      /// <summary>
+      /// The <b>AddComponents</b> method adds a batch of components to the backup set in the Backup Components Document, and sets 
+      /// the backup options and previous backup stamp of each component that specifies them.
+      /// </summary>
+      /// <param name="components">The components to add.</param>
+      /// <returns>
+      ///   A read-only list describing the components that could not be added or updated, in batch order. The list is empty if 
+      ///   every component was processed successfully.
+      /// </returns>
+      /// <remarks>
+      ///   <para>
+      ///     The result is the same as calling <see cref="IVssBackupComponents.AddComponent"/>, followed by 
+      ///     <see cref="IVssBackupComponents.SetBackupOptions"/> and <see cref="IVssBackupComponents.SetPreviousBackupStamp"/> where 
+      ///     specified, for each component in turn. However, the calls are made without copying the strings of each component to 
+      ///     unmanaged memory, and a failure to process one component does not prevent the remaining components from being 
+      ///     processed. If adding a component fails, its backup options and previous backup stamp are not set.
+      ///   </para>
+      ///   <para>
+      ///     A <see cref="VssBadStateException"/> is not reported for an individual component, since it applies to the backup 
+      ///     components object rather than to the component. It is thrown as soon as it occurs, and the remaining components are 
+      ///     not processed.
+      ///   </para>
+      ///   <para>
+      ///     This method is intended for requesters selecting large numbers of components, such as the databases of a 
+      ///     database server.
+      ///   </para>
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="components"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="components"/> contains a <see langword="null"/> element, or an element whose <see cref="VssComponentSelection.ComponentName"/> is <see langword="null"/>. No component is processed in that case.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>
+      IList<VssComponentSelectionFailure> AddComponents(IEnumerable<VssComponentSelection> components);
+
+      /// <summary>
+      /// The <b>SetBackupSucceeded</b> method indicates whether the backup of each of a batch of components succeeded.
+      /// </summary>
+      /// <param name="components">The components to update. Only the writer and component identification of each element is used.</param>
+      /// <param name="succeeded">
+      ///   <see langword="true"/> if the backup of the components succeeded, and <see langword="false"/> if it did not.
+      /// </param>
+      /// <returns>
+      ///   A read-only list describing the components that could not be updated, in batch order. The list is empty if 
+      ///   every component was updated successfully.
+      /// </returns>
+      /// <remarks>
+      ///   The result is the same as calling <see cref="IVssBackupComponents.SetBackupSucceeded(Guid, Guid, VssComponentType, string, string, bool)"/> 
+      ///   for each component in turn, except that a failure to update one component does not prevent the remaining components 
+      ///   from being updated. See <see cref="AddComponents"/> for more information.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="components"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="components"/> contains a <see langword="null"/> element, or an element whose <see cref="VssComponentSelection.ComponentName"/> is <see langword="null"/>. No component is processed in that case.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>
+      IList<VssComponentSelectionFailure> SetBackupSucceeded(IEnumerable<VssComponentSelection> components, bool succeeded);
+
+      /// <summary>
+      ///     Gets or sets a value indicating whether the lists returned by <see cref="IVssBackupComponents.WriterMetadata"/>, 
+      ///     <see cref="IVssBackupComponents.WriterComponents"/> and <see cref="IVssBackupComponents.WriterStatus"/>, as well as 
+      ///     the lists of the components obtained through them, capture their contents on first use.
+      /// </summary>
+      /// <value>
+      ///     <see langword="true"/> if the lists capture their contents on first use; <see langword="false"/> if every access 
+      ///     is forwarded to VSS. The default is <see langword="false"/>.
+      /// </value>
+      /// <remarks>
+      ///     <para>
+      ///         By default every access to one of these lists, including the <see cref="ICollection{T}.Count"/> check performed 
+      ///         for every step of an enumeration, results in a call to VSS and a new instance of the requested element. 
+      ///     </para>
+      ///     <para>
+      ///         When this property is set to <see langword="true"/>, the first enumeration of a list (or the first call to 
+      ///         <see cref="ICollection{T}.Contains"/>, <see cref="IList{T}.IndexOf"/> or <see cref="ICollection{T}.CopyTo"/>) 
+      ///         retrieves the count and all elements once, and subsequent enumerations, lookups and indexing are served from 
+      ///         the captured elements. The captured elements are discarded whenever an operation that may change the contents 
+      ///         of the lists is performed through this instance, such as <see cref="IVssBackupComponents.GatherWriterMetadata"/>, 
+      ///         <see cref="IVssBackupComponents.GatherWriterStatus"/>, <see cref="IVssBackupComponents.FreeWriterMetadata"/>, 
+      ///         <see cref="IVssBackupComponents.PrepareForBackup"/> or <see cref="IVssBackupComponents.AddComponent"/>, and are 
+      ///         retrieved again on the next enumeration.
+      ///     </para>
+      ///     <para>
+      ///         Changing the value of this property discards any captured elements. Component lists of 
+      ///         <see cref="IVssWriterComponents"/> instances already obtained are not affected.
+      ///     </para>
+      ///     <para>
+      ///         Implementations that do not implement <see cref="IVssBatchBackupComponents"/> always forward every access to VSS.
+      ///     </para>
+      ///     <para>
+      ///         Captured elements are owned by the list they were captured by. Elements implementing <see cref="IDisposable"/>, 
+      ///         such as <see cref="IVssExamineWriterMetadata"/> and <see cref="IVssComponent"/> instances, must not be disposed by 
+      ///         the caller. Discarding the captured elements does not dispose them, so that elements obtained from an enumeration 
+      ///         or the indexer remain usable while the lists are changed, for instance by calling 
+      ///         <see cref="IVssBackupComponents.SetBackupSucceeded(Guid, Guid, VssComponentType, string, string, bool)"/> for each 
+      ///         component of an enumeration of <see cref="IVssBackupComponents.WriterComponents"/>. All captured elements are 
+      ///         disposed when this instance is disposed. Elements obtained while this property is <see langword="false"/> are 
+      ///         owned by the caller, as before.
+      ///     </para>
+      /// </remarks>
+      bool MaterializeCollections { get; set; }
+
+      /// <summary>
+      /// 	The <see cref="CaptureWriterMetadata"/> method captures the complete Writer Metadata Documents of all writers, as gathered by 
+      /// 	the last call to <see cref="IVssBackupComponents.GatherWriterMetadata"/>, in a single pass.
+      /// </summary>
+      /// <returns>
+      /// 	A read-only list containing a <see cref="VssCapturedWriterMetadata"/> for each writer, in the order of <see cref="IVssBackupComponents.WriterMetadata"/>.
+      /// </returns>
+      /// <remarks>
+      /// 	<para>
+      /// 		The <see cref="IVssExamineWriterMetadata"/> instances returned by <see cref="IVssBackupComponents.WriterMetadata"/> retrieve their contents on demand, 
+      /// 		and hold on to VSS resources until they are disposed. This method instead retrieves the identity, restore method, files, 
+      /// 		components and dependencies of every writer at once, and releases all VSS resources before it returns.
+      /// 	</para>
+      /// 	<para>
+      /// 		The returned objects are immutable and make no further calls to VSS, so they remain usable after this instance 
+      /// 		is disposed, and may safely be shared between threads.
+      /// 	</para>
+      /// 	<para>
+      /// 		Unlike this method, <see cref="VssCapturedWriterMetadata.Capture(IEnumerable{IVssExamineWriterMetadata})"/> retrieves 
+      /// 		each property of each writer through <see cref="IVssBackupComponents.WriterMetadata"/>, one call to VSS at a time.
+      /// 	</para>
+      /// </remarks>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, or <see cref="IVssBackupComponents.GatherWriterMetadata"/> has not completed.</exception>		
+      /// <exception cref="VssInvalidXmlDocumentException">The XML document is not valid. Check the event log for details.</exception>
+      IList<VssCapturedWriterMetadata> CaptureWriterMetadata();
+   }
+}
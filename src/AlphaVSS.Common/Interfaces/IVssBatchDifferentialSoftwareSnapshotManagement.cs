@@ -0,0 +1,113 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Optional interface implemented by <see cref="IVssDifferentialSoftwareSnapshotManagement"/> implementations that support 
+   /// enumerating shadow copy storage areas and volumes lazily, in batches. 
+   /// </summary>
+   /// <remarks>
+   ///   Callers should not use this interface directly, but rather the extension methods of 
+   ///   <see cref="VssDifferentialSoftwareSnapshotManagementExtensions"/>, which fall back to the query methods of 
+   ///   <see cref="IVssDifferentialSoftwareSnapshotManagement"/> for implementations that do not implement this interface. 
+   /// </remarks>
+   public interface IVssBatchDifferentialSoftwareSnapshotManagement : IVssDifferentialSoftwareSnapshotManagement
+   {
+      /// <summary>
+      /// The <see cref="EnumerateDiffAreasForSnapshot"/> method lazily enumerates the shadow copy storage areas in use by the 
+      /// original volume associated with the input shadow copy.
+      /// </summary>
+      /// <param name="snapshotId">The snapshot id.</param>
+      /// <param name="batchSize">The maximum number of elements to retrieve from VSS in a single call. Must be greater than zero.</param>
+      /// <returns>A lazily evaluated sequence of <see cref="VssDiffAreaProperties"/> describing the shadow copy storage areas in use by the 
+      /// shadow copy specified.</returns>
+      /// <remarks>
+      ///     The query is issued when this method is called, but the results are retrieved from VSS in batches of 
+      ///     <paramref name="batchSize"/> elements and converted to managed objects only as the returned sequence is enumerated, 
+      ///     releasing the native memory of each element as it goes. Errors reported by VSS while retrieving the results are thrown 
+      ///     during enumeration. The returned sequence can be enumerated only once, and the underlying VSS enumerator is released as 
+      ///     soon as the enumeration completes or its enumerator is disposed. See <see cref="IVssDifferentialSoftwareSnapshotManagement.QueryDiffAreasForSnapshot"/> for more information.
+      /// </remarks>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="batchSize"/> is less than one.</exception>
+      /// <exception cref="UnauthorizedAccessException">Caller does not have sufficient backup privileges or is not an administrator.</exception>
+      /// <exception cref="OutOfMemoryException">The caller is out of memory or other system resources.</exception>
+      /// <exception cref="ArgumentException">One of the parameter values is not valid.</exception>
+      /// <exception cref="ArgumentNullException">One of the arguments was <see langword="null"/></exception>
+      /// <exception cref="SystemException">Unexpected error. The error code is logged in the error log file.</exception>
+      /// <exception cref="VssProviderVetoException">Expected provider error. The provider logged the error in the event log.</exception>        
+      IEnumerable<VssDiffAreaProperties> EnumerateDiffAreasForSnapshot(Guid snapshotId, int batchSize);
+
+      /// <summary>
+      /// The <see cref="EnumerateDiffAreasForVolume"/> method lazily enumerates the shadow copy storage areas in use by the volume specified.
+      /// </summary>
+      /// <param name="volumeName">Name of the volume that contains shadow copy storage areas. See <see cref="IVssDifferentialSoftwareSnapshotManagement.QueryDiffAreasForVolume"/> for the supported formats.</param>
+      /// <param name="batchSize">The maximum number of elements to retrieve from VSS in a single call. Must be greater than zero.</param>
+      /// <returns>A lazily evaluated sequence of <see cref="VssDiffAreaProperties"/> objects describing the shadow 
+      /// copy storage areas in use by the volume specified.</returns>
+      /// <remarks>
+      ///     The query is issued when this method is called, but the results are retrieved from VSS in batches of 
+      ///     <paramref name="batchSize"/> elements and converted to managed objects only as the returned sequence is enumerated, 
+      ///     releasing the native memory of each element as it goes. Errors reported by VSS while retrieving the results are thrown 
+      ///     during enumeration. The returned sequence can be enumerated only once, and the underlying VSS enumerator is released as 
+      ///     soon as the enumeration completes or its enumerator is disposed. See <see cref="IVssDifferentialSoftwareSnapshotManagement.QueryDiffAreasForVolume"/> for more information.
+      /// </remarks>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="batchSize"/> is less than one.</exception>
+      /// <exception cref="UnauthorizedAccessException">Caller does not have sufficient backup privileges or is not an administrator.</exception>
+      /// <exception cref="OutOfMemoryException">The caller is out of memory or other system resources.</exception>
+      /// <exception cref="ArgumentException">One of the parameter values is not valid.</exception>
+      /// <exception cref="ArgumentNullException">One of the arguments was <see langword="null"/></exception>
+      /// <exception cref="SystemException">Unexpected error. The error code is logged in the error log file.</exception>
+      /// <exception cref="VssProviderVetoException">Expected provider error. The provider logged the error in the event log.</exception>        
+      IEnumerable<VssDiffAreaProperties> EnumerateDiffAreasForVolume(string volumeName, int batchSize);
+
+      /// <summary>
+      /// The <see cref="EnumerateDiffAreasOnVolume"/> method lazily enumerates the shadow copy storage areas that physically 
+      /// reside on the given volume.
+      /// </summary>
+      /// <param name="volumeName">Name of the volume that contains shadow copy storage areas. See <see cref="IVssDifferentialSoftwareSnapshotManagement.QueryDiffAreasOnVolume"/> for the supported formats.</param>
+      /// <param name="batchSize">The maximum number of elements to retrieve from VSS in a single call. Must be greater than zero.</param>
+      /// <returns>A lazily evaluated sequence of <see cref="VssDiffAreaProperties"/> objects describing the 
+      /// shadow copy storage areas that physically reside on the given volume.</returns>
+      /// <remarks>
+      ///     The query is issued when this method is called, but the results are retrieved from VSS in batches of 
+      ///     <paramref name="batchSize"/> elements and converted to managed objects only as the returned sequence is enumerated, 
+      ///     releasing the native memory of each element as it goes. Errors reported by VSS while retrieving the results are thrown 
+      ///     during enumeration. The returned sequence can be enumerated only once, and the underlying VSS enumerator is released as 
+      ///     soon as the enumeration completes or its enumerator is disposed. See <see cref="IVssDifferentialSoftwareSnapshotManagement.QueryDiffAreasOnVolume"/> for more information.
+      /// </remarks>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="batchSize"/> is less than one.</exception>
+      /// <exception cref="UnauthorizedAccessException">Caller does not have sufficient backup privileges or is not an administrator.</exception>
+      /// <exception cref="OutOfMemoryException">The caller is out of memory or other system resources.</exception>
+      /// <exception cref="ArgumentException">One of the parameter values is not valid.</exception>
+      /// <exception cref="ArgumentNullException">One of the arguments was <see langword="null"/></exception>
+      /// <exception cref="SystemException">Unexpected error. The error code is logged in the error log file.</exception>
+      /// <exception cref="VssProviderVetoException">Expected provider error. The provider logged the error in the event log.</exception>        
+      IEnumerable<VssDiffAreaProperties> EnumerateDiffAreasOnVolume(string volumeName, int batchSize);
+
+      /// <summary>
+      /// The <see cref="EnumerateVolumesSupportedForDiffAreas"/> method lazily enumerates the volumes that support shadow copy storage 
+      /// areas (including volumes with disabled shadow copy storage areas).
+      /// </summary>
+      /// <param name="originalVolumeName">Name of the original volume that is the source of the shadow copies. See <see cref="IVssDifferentialSoftwareSnapshotManagement.QueryVolumesSupportedForDiffAreas"/> for the supported formats.</param>
+      /// <param name="batchSize">The maximum number of elements to retrieve from VSS in a single call. Must be greater than zero.</param>
+      /// <returns>A lazily evaluated sequence of <see cref="VssDiffVolumeProperties"/> describing the volumes that support shadow 
+      /// copy storage areas (including volumes with disabled shadow copy storage areas).</returns>
+      /// <remarks>
+      ///     The query is issued when this method is called, but the results are retrieved from VSS in batches of 
+      ///     <paramref name="batchSize"/> elements and converted to managed objects only as the returned sequence is enumerated, 
+      ///     releasing the native memory of each element as it goes. Errors reported by VSS while retrieving the results are thrown 
+      ///     during enumeration. The returned sequence can be enumerated only once, and the underlying VSS enumerator is released as 
+      ///     soon as the enumeration completes or its enumerator is disposed. See <see cref="IVssDifferentialSoftwareSnapshotManagement.QueryVolumesSupportedForDiffAreas"/> for more information.
+      /// </remarks>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="batchSize"/> is less than one.</exception>
+      /// <exception cref="UnauthorizedAccessException">Caller does not have sufficient backup privileges or is not an administrator.</exception>
+      /// <exception cref="OutOfMemoryException">The caller is out of memory or other system resources.</exception>
+      /// <exception cref="ArgumentException">One of the parameter values is not valid.</exception>
+      /// <exception cref="ArgumentNullException">One of the arguments was <see langword="null"/></exception>
+      /// <exception cref="SystemException">Unexpected error. The error code is logged in the error log file.</exception>
+      /// <exception cref="VssProviderVetoException">Expected provider error. The provider logged the error in the event log.</exception>        
+      IEnumerable<VssDiffVolumeProperties> EnumerateVolumesSupportedForDiffAreas(string originalVolumeName, int batchSize);
+   }
+}
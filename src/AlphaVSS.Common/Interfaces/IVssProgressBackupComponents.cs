@@ -0,0 +1,260 @@
+
+using System;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Optional interface implemented by <see cref="IVssBackupComponents"/> implementations that support reporting the progress 
+   /// of their asynchronous operations. 
+   /// </summary>
+   /// <remarks>
+   ///   Callers should not use this interface directly, but rather the extension methods of <see cref="VssBackupComponentsExtensions"/>, 
+   ///   which report progress from the asynchronous methods of <see cref="IVssBackupComponents"/> for implementations that do not 
+   ///   implement this interface. 
+   /// </remarks>
+   public interface IVssProgressBackupComponents : IVssBackupComponents
+   {
+      /// <summary>
+      /// This method asynchronously causes VSS to generate a <b>BackupComplete</b> event, which signals writers that the backup
+      /// process has completed.
+      /// </summary>
+      /// <param name="progress">The provider that receives periodic status samples of the operation. A final sample is reported when the operation has completed.</param>
+      /// <param name="reportInterval">The interval at which status samples are reported to <paramref name="progress"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
+      /// <returns>
+      /// A <see cref="Task"/> that represents the asynchronous operation.
+      /// </returns>
+      /// <remarks>
+      ///     <para>
+      ///         Each sample contains the time elapsed since the operation was started, the status of the operation as last reported 
+      ///         by VSS and, where available, the status of the writers as last gathered by 
+      ///         <see cref="IVssBackupComponents.GatherWriterStatus"/> before the operation was started.
+      ///     </para>
+      ///     <para>
+      ///         Samples are reported from a thread-pool thread. The next sample is not scheduled until the progress provider has 
+      ///         returned, so a slow provider delays the samples but never the operation itself.
+      ///     </para>
+      ///     <para>
+      ///         See <see cref="IVssBackupComponents.BackupCompleteAsync(CancellationToken)"/> for more information.
+      ///     </para>
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="progress"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="reportInterval"/> is not greater than zero, or is greater than 4294967294 milliseconds.</exception>
+      /// <exception cref="OperationCanceledException">Thrown if the operation was canceled by the <paramref name="cancellationToken"/></exception>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>
+      /// <exception cref="VssUnexpectedWriterErrorException">An unexpected error occurred during communication with writers. The error code is logged in the error log file.</exception>
+      Task BackupCompleteAsync(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken = default);
+
+      /// <summary>
+      /// Commits all shadow copies in this set simultaneously as an asynchronous operation.
+      /// </summary>
+      /// <param name="progress">The provider that receives periodic status samples of the operation. A final sample is reported when the operation has completed.</param>
+      /// <param name="reportInterval">The interval at which status samples are reported to <paramref name="progress"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
+      /// <returns>
+      /// A <see cref="Task"/> that represents the asynchronous operation.
+      /// </returns>
+      /// <remarks>
+      ///     <para>
+      ///         Each sample contains the time elapsed since the operation was started, the status of the operation as last reported 
+      ///         by VSS and, where available, the status of the writers as last gathered by 
+      ///         <see cref="IVssBackupComponents.GatherWriterStatus"/> before the operation was started.
+      ///     </para>
+      ///     <para>
+      ///         Samples are reported from a thread-pool thread. The next sample is not scheduled until the progress provider has 
+      ///         returned, so a slow provider delays the samples but never the operation itself.
+      ///     </para>
+      ///     <para>
+      ///         See <see cref="IVssBackupComponents.DoSnapshotSetAsync(CancellationToken)"/> for more information.
+      ///     </para>
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="progress"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="reportInterval"/> is not greater than zero, or is greater than 4294967294 milliseconds.</exception>
+      /// <exception cref="OperationCanceledException">Thrown if the operation was canceled by the <paramref name="cancellationToken"/></exception>
+      /// <exception cref="UnauthorizedAccessException">The caller does not have sufficient backup privileges or is not an administrator.</exception>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object has not been initialized or the prerequisite calls for a given shadow copy context have not been made prior to calling <b>DoSnapshotSet</b>. </exception>
+      /// <exception cref="VssInsufficientStorageException">The system or provider has insufficient storage space. If possible delete any old or unnecessary persistent shadow copies and try again.</exception>
+      /// <exception cref="VssFlushWritesTimeoutException">The system was unable to flush I/O writes. This can be a transient problem. It is recommended to wait ten minutes and try again, up to three times.</exception>
+      /// <exception cref="VssHoldWritesTimeoutException">The system was unable to hold I/O writes. This can be a transient problem. It is recommended to wait ten minutes and try again, up to three times.</exception>
+      /// <exception cref="VssProviderVetoException">The provider was unable to perform the request at this time. This can be a transient problem. It is recommended to wait ten minutes and try again, up to three times.</exception>
+      /// <exception cref="VssRebootRequiredException">The provider encountered an error that requires the user to restart the computer.</exception>
+      /// <exception cref="VssTransactionFreezeTimeoutException">The system was unable to freeze the Distributed Transaction Coordinator (DTC) or the Kernel Transaction Manager (KTM).</exception>
+      /// <exception cref="VssTransactionThawTimeoutException">The system was unable to freeze the Distributed Transaction Coordinator (DTC) or the Kernel Transaction Manager (KTM).</exception>
+      /// <exception cref="VssUnexpectedProviderErrorException">The provider returned an unexpected error code. This can be a transient problem. It is recommended to wait ten minutes and try again, up to three times.</exception> 
+      Task DoSnapshotSetAsync(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken = default);
+
+      /// <summary>      
+      /// 	The <see cref="IVssBackupComponents.GatherWriterMetadataAsync(CancellationToken)"/> method asynchronously prompts each writer to send the metadata they have collected. 
+      /// 	The method will generate an <c>Identify</c> event to communicate with writers.
+      /// </summary>
+      /// <param name="progress">The provider that receives periodic status samples of the operation. A final sample is reported when the operation has completed.</param>
+      /// <param name="reportInterval">The interval at which status samples are reported to <paramref name="progress"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
+      /// <returns>
+      /// A <see cref="Task"/> that represents the asynchronous operation.
+      /// </returns>
+      /// <remarks>
+      ///     <para>
+      ///         Each sample contains the time elapsed since the operation was started, the status of the operation as last reported 
+      ///         by VSS and, where available, the status of the writers as last gathered by 
+      ///         <see cref="IVssBackupComponents.GatherWriterStatus"/> before the operation was started.
+      ///     </para>
+      ///     <para>
+      ///         Samples are reported from a thread-pool thread. The next sample is not scheduled until the progress provider has 
+      ///         returned, so a slow provider delays the samples but never the operation itself.
+      ///     </para>
+      ///     <para>
+      ///         See <see cref="IVssBackupComponents.GatherWriterMetadataAsync(CancellationToken)"/> for more information.
+      ///     </para>
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="progress"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="reportInterval"/> is not greater than zero, or is greater than 4294967294 milliseconds.</exception>
+      /// <exception cref="OperationCanceledException">Thrown if the operation was canceled by the <paramref name="cancellationToken"/></exception>  
+      /// <exception cref="UnauthorizedAccessException">The caller does not have sufficient backup privileges or is not an administrator.</exception>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>		
+      /// <exception cref="VssWriterInfrastructureException">The writer infrastructure is not operating properly. Check that the Event Service and VSS have been started, and check for errors associated with those services in the error log.</exception>
+      Task GatherWriterMetadataAsync(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken = default);
+
+      /// <summary>
+      /// 	The <see cref="IVssBackupComponents.GatherWriterStatusAsync(CancellationToken)"/> method asynchronously prompts each writer to send a status message.
+      /// </summary>
+      /// <param name="progress">The provider that receives periodic status samples of the operation. A final sample is reported when the operation has completed.</param>
+      /// <param name="reportInterval">The interval at which status samples are reported to <paramref name="progress"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
+      /// <returns>
+      /// A <see cref="Task"/> that represents the asynchronous operation.
+      /// </returns>
+      /// <remarks>
+      ///     <para>
+      ///         Each sample contains the time elapsed since the operation was started, the status of the operation as last reported 
+      ///         by VSS and, where available, the status of the writers as last gathered by 
+      ///         <see cref="IVssBackupComponents.GatherWriterStatus"/> before the operation was started.
+      ///     </para>
+      ///     <para>
+      ///         Samples are reported from a thread-pool thread. The next sample is not scheduled until the progress provider has 
+      ///         returned, so a slow provider delays the samples but never the operation itself.
+      ///     </para>
+      ///     <para>
+      ///         See <see cref="IVssBackupComponents.GatherWriterStatusAsync(CancellationToken)"/> for more information.
+      ///     </para>
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="progress"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="reportInterval"/> is not greater than zero, or is greater than 4294967294 milliseconds.</exception>
+      /// <exception cref="OperationCanceledException">Thrown if the operation was canceled by the <paramref name="cancellationToken"/></exception>
+      /// <exception cref="UnauthorizedAccessException">The caller does not have sufficient backup privileges or is not an administrator.</exception>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>		
+      /// <exception cref="VssWriterInfrastructureException">The writer infrastructure is not operating properly. Check that the Event Service and VSS have been started, and check for errors associated with those services in the error log.</exception>
+      Task GatherWriterStatusAsync(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken = default);
+
+      /// <summary>
+      ///	The <see cref="IVssBackupComponents.PostRestoreAsync(CancellationToken)"/> method will asynchronously cause VSS to generate a <c>PostRestore</c> event, signaling writers that the current 
+      ///	restore operation has finished.
+      /// </summary>
+      /// <param name="progress">The provider that receives periodic status samples of the operation. A final sample is reported when the operation has completed.</param>
+      /// <param name="reportInterval">The interval at which status samples are reported to <paramref name="progress"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
+      /// <returns>
+      /// A <see cref="Task"/> that represents the asynchronous operation.
+      /// </returns>
+      /// <remarks>
+      ///     <para>
+      ///         Each sample contains the time elapsed since the operation was started, the status of the operation as last reported 
+      ///         by VSS and, where available, the status of the writers as last gathered by 
+      ///         <see cref="IVssBackupComponents.GatherWriterStatus"/> before the operation was started.
+      ///     </para>
+      ///     <para>
+      ///         Samples are reported from a thread-pool thread. The next sample is not scheduled until the progress provider has 
+      ///         returned, so a slow provider delays the samples but never the operation itself.
+      ///     </para>
+      ///     <para>
+      ///         See <see cref="IVssBackupComponents.PostRestoreAsync(CancellationToken)"/> for more information.
+      ///     </para>
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="progress"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="reportInterval"/> is not greater than zero, or is greater than 4294967294 milliseconds.</exception>
+      /// <exception cref="OperationCanceledException">Thrown if the operation was canceled by the <paramref name="cancellationToken"/></exception>
+      /// <exception cref="UnauthorizedAccessException">The caller does not have sufficient backup privileges or is not an administrator.</exception>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>		
+      /// <exception cref="VssObjectNotFoundException">The specified volume was not found or was not available.</exception>
+      /// <exception cref="VssProviderVetoException">Expected provider error. The provider logged the error in the event log.</exception>
+      Task PostRestoreAsync(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken = default);
+
+      /// <summary>
+      /// 	The <see cref="IVssBackupComponents.PrepareForBackupAsync(CancellationToken)"/> method will asynchronously cause VSS to generate a PrepareForBackup event, signaling writers to prepare for an upcoming 
+      /// 	backup operation. This makes a requester's Backup Components Document available to writers.
+      /// </summary>
+      /// <param name="progress">The provider that receives periodic status samples of the operation. A final sample is reported when the operation has completed.</param>
+      /// <param name="reportInterval">The interval at which status samples are reported to <paramref name="progress"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
+      /// <returns>
+      /// A <see cref="Task"/> that represents the asynchronous operation.
+      /// </returns>
+      /// <remarks>
+      ///     <para>
+      ///         Each sample contains the time elapsed since the operation was started, the status of the operation as last reported 
+      ///         by VSS and, where available, the status of the writers as last gathered by 
+      ///         <see cref="IVssBackupComponents.GatherWriterStatus"/> before the operation was started.
+      ///     </para>
+      ///     <para>
+      ///         Samples are reported from a thread-pool thread. The next sample is not scheduled until the progress provider has 
+      ///         returned, so a slow provider delays the samples but never the operation itself.
+      ///     </para>
+      ///     <para>
+      ///         See <see cref="IVssBackupComponents.PrepareForBackupAsync(CancellationToken)"/> for more information.
+      ///     </para>
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="progress"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="reportInterval"/> is not greater than zero, or is greater than 4294967294 milliseconds.</exception>
+      /// <exception cref="OperationCanceledException">Thrown if the operation was canceled by the <paramref name="cancellationToken"/></exception>
+      /// <exception cref="UnauthorizedAccessException">The caller does not have sufficient backup privileges or is not an administrator.</exception>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>		
+      Task PrepareForBackupAsync(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken = default);
+
+      /// <summary>
+      /// The <see cref="IVssBackupComponents.PreRestoreAsync(CancellationToken)"/> method will asynchronously cause VSS to generate a <c>PreRestore</c> event, signaling writers to prepare for a 
+      /// coming restore operation.
+      /// </summary>
+      /// <param name="progress">The provider that receives periodic status samples of the operation. A final sample is reported when the operation has completed.</param>
+      /// <param name="reportInterval">The interval at which status samples are reported to <paramref name="progress"/>.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. The default value is <see cref="CancellationToken.None"/>.</param>
+      /// <returns>
+      /// A <see cref="Task"/> that represents the asynchronous operation.
+      /// </returns>
+      /// <remarks>
+      ///     <para>
+      ///         Each sample contains the time elapsed since the operation was started, the status of the operation as last reported 
+      ///         by VSS and, where available, the status of the writers as last gathered by 
+      ///         <see cref="IVssBackupComponents.GatherWriterStatus"/> before the operation was started.
+      ///     </para>
+      ///     <para>
+      ///         Samples are reported from a thread-pool thread. The next sample is not scheduled until the progress provider has 
+      ///         returned, so a slow provider delays the samples but never the operation itself.
+      ///     </para>
+      ///     <para>
+      ///         See <see cref="IVssBackupComponents.PreRestoreAsync(CancellationToken)"/> for more information.
+      ///     </para>
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="progress"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="reportInterval"/> is not greater than zero, or is greater than 4294967294 milliseconds.</exception>
+      /// <exception cref="OperationCanceledException">Thrown if the operation was canceled by the <paramref name="cancellationToken"/></exception>
+      /// <exception cref="UnauthorizedAccessException">The caller does not have sufficient backup privileges or is not an administrator.</exception>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>		
+      Task PreRestoreAsync(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken = default);
+   }
+}
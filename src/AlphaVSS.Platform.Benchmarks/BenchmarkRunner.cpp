@@ -0,0 +1,157 @@
+#include "pch.h"
+
+#include "BenchmarkRunner.h"
+
+using namespace System::Diagnostics;
+using namespace System::Globalization;
+using namespace System::Reflection;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   BenchmarkRunner::BenchmarkRunner(TextWriter^ log)
+      : m_log(log), m_benchmarks(gcnew List<Benchmark^>())
+   {
+      if (log == nullptr)
+         throw gcnew ArgumentNullException(L"log");
+
+      AppDomain::MonitoringIsEnabled = true;
+   }
+
+   void BenchmarkRunner::Add(String^ name, BenchmarkBody^ body)
+   {
+      if (name == nullptr)
+         throw gcnew ArgumentNullException(L"name");
+
+      if (body == nullptr)
+         throw gcnew ArgumentNullException(L"body");
+
+      Benchmark^ benchmark = gcnew Benchmark();
+      benchmark->Name = name;
+      benchmark->Body = body;
+      m_benchmarks->Add(benchmark);
+   }
+
+   void BenchmarkRunner::AddOnce(String^ name, int operations, Action^ setup, BenchmarkBody^ body, Action^ teardown)
+   {
+      if (name == nullptr)
+         throw gcnew ArgumentNullException(L"name");
+
+      if (operations < 1)
+         throw gcnew ArgumentOutOfRangeException(L"operations");
+
+      if (body == nullptr)
+         throw gcnew ArgumentNullException(L"body");
+
+      Benchmark^ benchmark = gcnew Benchmark();
+      benchmark->Name = name;
+      benchmark->Body = body;
+      benchmark->Operations = operations;
+      benchmark->Setup = setup;
+      benchmark->Teardown = teardown;
+      m_benchmarks->Add(benchmark);
+   }
+
+   IList<BenchmarkResult^>^ BenchmarkRunner::Run(String^ filter)
+   {
+      List<BenchmarkResult^>^ results = gcnew List<BenchmarkResult^>();
+      for each (Benchmark^ benchmark in m_benchmarks)
+      {
+         if (filter != nullptr && benchmark->Name->IndexOf(filter, StringComparison::OrdinalIgnoreCase) < 0)
+            continue;
+
+         BenchmarkResult^ result = benchmark->Operations > 0 ? MeasureOnce(benchmark) : Measure(benchmark->Name, benchmark->Body);
+         m_log->WriteLine(String::Format(CultureInfo::InvariantCulture, L"{0,-40} {1,12:F1} ns/op {2,10:F1} B/op",
+            result->Name, result->NanosecondsPerOperation, result->BytesPerOperation));
+         results->Add(result);
+      }
+
+      return results;
+   }
+
+   BenchmarkResult^ BenchmarkRunner::Measure(String^ name, BenchmarkBody^ body)
+   {
+      // Warm up, so that neither JIT compilation nor first-call initialization is measured.
+      body(1000);
+
+      // Calibrate the number of iterations, so that the resolution of the stopwatch does not matter.
+      int iterations = 1000;
+      Stopwatch^ stopwatch = Stopwatch::StartNew();
+      body(iterations);
+      while (stopwatch->ElapsedMilliseconds < MinimumRoundTime && iterations < Int32::MaxValue / 2)
+      {
+         iterations *= 2;
+         stopwatch->Restart();
+         body(iterations);
+      }
+
+      array<double>^ nanoseconds = gcnew array<double>(Rounds);
+      Int64 allocated = 0;
+      for (int round = 0; round < Rounds; round++)
+      {
+         GC::Collect();
+         GC::WaitForPendingFinalizers();
+         GC::Collect();
+
+         Int64 allocatedBefore = AppDomain::CurrentDomain->MonitoringTotalAllocatedMemorySize;
+         stopwatch->Restart();
+         body(iterations);
+         stopwatch->Stop();
+         allocated += AppDomain::CurrentDomain->MonitoringTotalAllocatedMemorySize - allocatedBefore;
+
+         nanoseconds[round] = stopwatch->Elapsed.TotalMilliseconds * 1000000.0 / iterations;
+      }
+
+      Array::Sort(nanoseconds);
+      return gcnew BenchmarkResult(name, (Int64)iterations * Rounds, nanoseconds[Rounds / 2], (double)allocated / ((double)iterations * Rounds));
+   }
+
+   BenchmarkResult^ BenchmarkRunner::MeasureOnce(Benchmark^ benchmark)
+   {
+      if (benchmark->Setup != nullptr)
+         benchmark->Setup();
+
+      Int64 allocatedBefore = AppDomain::CurrentDomain->MonitoringTotalAllocatedMemorySize;
+      Stopwatch^ stopwatch = Stopwatch::StartNew();
+      benchmark->Body(benchmark->Operations);
+      stopwatch->Stop();
+      Int64 allocated = AppDomain::CurrentDomain->MonitoringTotalAllocatedMemorySize - allocatedBefore;
+
+      if (benchmark->Teardown != nullptr)
+         benchmark->Teardown();
+
+      return gcnew BenchmarkResult(benchmark->Name, benchmark->Operations, stopwatch->Elapsed.TotalMilliseconds * 1000000.0 / benchmark->Operations,
+         (double)allocated / benchmark->Operations);
+   }
+
+   void BenchmarkRunner::WriteJson(TextWriter^ writer, IList<BenchmarkResult^>^ results)
+   {
+      if (writer == nullptr)
+         throw gcnew ArgumentNullException(L"writer");
+
+      if (results == nullptr)
+         throw gcnew ArgumentNullException(L"results");
+
+      CultureInfo^ culture = CultureInfo::InvariantCulture;
+      writer->WriteLine(L"{");
+      writer->WriteLine(String::Format(culture, L"  \"version\": {0},", ToJsonString(VssError::typeid->Assembly->GetName()->Version->ToString())));
+      writer->WriteLine(String::Format(culture, L"  \"runtime\": {0},", ToJsonString(Environment::Version->ToString())));
+      writer->WriteLine(String::Format(culture, L"  \"platform\": {0},", ToJsonString(Environment::Is64BitProcess ? L"x64" : L"x86")));
+      writer->WriteLine(String::Format(culture, L"  \"machine\": {0},", ToJsonString(Environment::MachineName)));
+      writer->WriteLine(String::Format(culture, L"  \"timestamp\": {0},", ToJsonString(DateTime::UtcNow.ToString(L"o", culture))));
+      writer->WriteLine(L"  \"results\": [");
+      for (int i = 0; i < results->Count; i++)
+      {
+         BenchmarkResult^ result = results[i];
+         writer->WriteLine(String::Format(culture, L"    {{ \"name\": {0}, \"iterations\": {1}, \"nsPerOp\": {2:R}, \"bytesPerOp\": {3:R} }}{4}",
+            ToJsonString(result->Name), result->Iterations, result->NanosecondsPerOperation, result->BytesPerOperation, i < results->Count - 1 ? L"," : L""));
+      }
+      writer->WriteLine(L"  ]");
+      writer->WriteLine(L"}");
+   }
+
+   String^ BenchmarkRunner::ToJsonString(String^ value)
+   {
+      return L"\"" + value->Replace(L"\\", L"\\\\")->Replace(L"\"", L"\\\"") + L"\"";
+   }
+}
+} } }
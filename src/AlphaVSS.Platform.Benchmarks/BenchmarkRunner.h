@@ -0,0 +1,85 @@
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::IO;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   // Runs the operation being measured the specified number of times.
+   public delegate void BenchmarkBody(int iterations);
+
+   //
+   // The measurement of a single benchmark.
+   //
+   public ref class BenchmarkResult sealed
+   {
+   public:
+      BenchmarkResult(String^ name, Int64 iterations, double nanosecondsPerOperation, double bytesPerOperation)
+         : m_name(name), m_iterations(iterations), m_nanosecondsPerOperation(nanosecondsPerOperation), m_bytesPerOperation(bytesPerOperation)
+      {
+      }
+
+      property String^ Name { String^ get() { return m_name; } }
+      property Int64 Iterations { Int64 get() { return m_iterations; } }
+      property double NanosecondsPerOperation { double get() { return m_nanosecondsPerOperation; } }
+      property double BytesPerOperation { double get() { return m_bytesPerOperation; } }
+
+   private:
+      String^ m_name;
+      Int64 m_iterations;
+      double m_nanosecondsPerOperation;
+      double m_bytesPerOperation;
+   };
+
+   //
+   // A minimal benchmark harness. Each benchmark is warmed up, its iteration count is calibrated so that a round
+   // takes at least MinimumRoundTime, and it is then measured for a number of rounds. The median time per operation
+   // of the rounds is reported, along with the managed memory allocated per operation.
+   //
+   // Allocations are measured with AppDomain resource monitoring, which counts the memory allocated by every thread
+   // of the application domain; benchmarks must therefore run on a single thread.
+   //
+   // Benchmarks added with AddOnce are instead measured a single time, without warm-up or calibration, for operations
+   // too slow to be repeated thousands of times, or whose first call is what is being measured.
+   //
+   public ref class BenchmarkRunner sealed
+   {
+   public:
+      literal int Rounds = 7;
+      literal int MinimumRoundTime = 100;
+
+      BenchmarkRunner(TextWriter^ log);
+
+      void Add(String^ name, BenchmarkBody^ body);
+
+      // Adds a benchmark whose body is called once with the specified number of operations. The setup and teardown
+      // actions, either of which may be null, run before and after the body and are not measured.
+      void AddOnce(String^ name, int operations, Action^ setup, BenchmarkBody^ body, Action^ teardown);
+
+      // Runs the benchmarks whose name contains filter (all benchmarks if filter is null), in the order they were added.
+      IList<BenchmarkResult^>^ Run(String^ filter);
+
+      // Writes the results as a JSON document, for the results of different versions to be compared.
+      static void WriteJson(TextWriter^ writer, IList<BenchmarkResult^>^ results);
+
+   private:
+      ref class Benchmark sealed
+      {
+      public:
+         String^ Name;
+         BenchmarkBody^ Body;
+         int Operations;      // Zero for benchmarks that are calibrated and measured in rounds.
+         Action^ Setup;
+         Action^ Teardown;
+      };
+
+      BenchmarkResult^ Measure(String^ name, BenchmarkBody^ body);
+      BenchmarkResult^ MeasureOnce(Benchmark^ benchmark);
+      static String^ ToJsonString(String^ value);
+
+      TextWriter^ m_log;
+      List<Benchmark^>^ m_benchmarks;
+   };
+}
+} } }
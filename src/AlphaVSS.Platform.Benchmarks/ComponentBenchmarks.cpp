@@ -0,0 +1,163 @@
+#include "pch.h"
+
+#include "ComponentBenchmarks.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   void ComponentBenchmarks::AddTo(BenchmarkRunner^ runner)
+   {
+      s_writers = CreateWriters();
+      s_graph = gcnew VssComponentDependencyGraph(s_writers);
+
+      // Every 64th component, spread over all writers.
+      IList<VssComponentKey^>^ keys = s_graph->Keys;
+      List<VssComponentKey^>^ selection = gcnew List<VssComponentKey^>();
+      for (int i = 0; i < keys->Count; i += 64)
+         selection->Add(keys[i]);
+      s_selection = selection;
+      s_index = VssComponentIndex::Create(s_writers);
+
+      runner->Add(L"VssComponentDependencyGraph, build (10,240 components)", gcnew BenchmarkBody(&ComponentBenchmarks::BuildGraph));
+      runner->Add(L"VssComponentDependencyGraph, build and find cycles", gcnew BenchmarkBody(&ComponentBenchmarks::FindCycles));
+      runner->Add(L"VssComponentDependencyGraph, closure of 160 components", gcnew BenchmarkBody(&ComponentBenchmarks::GetClosure));
+      runner->Add(L"VssComponentDependencyGraph, independent groups of 160 components", gcnew BenchmarkBody(&ComponentBenchmarks::GetIndependentGroups));
+      runner->Add(L"VssComponentDependencyGraph, plan of 160 components", gcnew BenchmarkBody(&ComponentBenchmarks::Plan));
+      runner->Add(L"VssComponentIndex, create (10,240 components)", gcnew BenchmarkBody(&ComponentBenchmarks::CreateIndex));
+      runner->Add(L"Component lookup, walking the writer lists (baseline)", gcnew BenchmarkBody(&ComponentBenchmarks::FindByWalking));
+      runner->Add(L"VssComponentIndex, find in writer instance", gcnew BenchmarkBody(&ComponentBenchmarks::FindInInstance));
+      runner->Add(L"VssComponentIndex, find in writer class", gcnew BenchmarkBody(&ComponentBenchmarks::FindInClass));
+      runner->Add(L"VssComponentIndex, subtree of 16 components", gcnew BenchmarkBody(&ComponentBenchmarks::GetSubtree));
+   }
+
+   void ComponentBenchmarks::BuildGraph(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = (gcnew VssComponentDependencyGraph(s_writers))->Count;
+   }
+
+   void ComponentBenchmarks::FindCycles(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = (gcnew VssComponentDependencyGraph(s_writers))->Cycles->Count;
+   }
+
+   void ComponentBenchmarks::GetClosure(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = s_graph->GetClosure(s_selection)->Count;
+   }
+
+   void ComponentBenchmarks::GetIndependentGroups(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = s_graph->GetIndependentGroups(s_selection)->Count;
+   }
+
+   void ComponentBenchmarks::Plan(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = s_graph->Plan(s_selection)->Count;
+   }
+
+   void ComponentBenchmarks::CreateIndex(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = VssComponentIndex::Create(s_writers)->Count;
+   }
+
+   void ComponentBenchmarks::FindByWalking(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+      {
+         VssComponentKey^ key = s_selection[i % s_selection->Count];
+         for each (IVssExamineWriterMetadata^ writer in s_writers)
+         {
+            if (writer->InstanceId != key->InstanceId || writer->WriterId != key->WriterId)
+               continue;
+
+            for each (IVssWMComponent^ component in writer->Components)
+            {
+               if (String::Equals(component->LogicalPath, key->LogicalPath, StringComparison::OrdinalIgnoreCase)
+                  && String::Equals(component->ComponentName, key->ComponentName, StringComparison::OrdinalIgnoreCase))
+               {
+                  s_sink = (int)component->Type;
+                  break;
+               }
+            }
+         }
+      }
+   }
+
+   void ComponentBenchmarks::FindInInstance(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+      {
+         VssComponentKey^ key = s_selection[i % s_selection->Count];
+         s_sink = (int)s_index->Find(key->InstanceId, key->WriterId, VssComponentType::FileGroup, key->LogicalPath, key->ComponentName)->Type;
+      }
+   }
+
+   void ComponentBenchmarks::FindInClass(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+      {
+         VssComponentKey^ key = s_selection[i % s_selection->Count];
+         s_sink = s_index->Find(key->WriterId, VssComponentType::FileGroup, key->LogicalPath, key->ComponentName)->Count;
+      }
+   }
+
+   void ComponentBenchmarks::GetSubtree(int iterations)
+   {
+      // Every 64th component is selected, so each selected component is the root of a component set of 16.
+      for (int i = 0; i < iterations; i++)
+      {
+         VssComponentKey^ key = s_selection[i % s_selection->Count];
+         s_sink = s_index->GetSubtree(key->InstanceId, key->WriterId, key->FullPath)->Count;
+      }
+   }
+
+   IList<IVssExamineWriterMetadata^>^ ComponentBenchmarks::CreateWriters()
+   {
+      array<Guid>^ writerIds = gcnew array<Guid>(WriterClasses);
+      for (int i = 0; i < WriterClasses; i++)
+         writerIds[i] = Guid(i + 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+      // A fixed seed keeps the graph, and therefore the results, comparable between runs.
+      Random^ random = gcnew Random(14);
+      array<VssWMFileDescriptor^>^ none = gcnew array<VssWMFileDescriptor^>(0);
+      List<IVssExamineWriterMetadata^>^ writers = gcnew List<IVssExamineWriterMetadata^>();
+      for (int writer = 0; writer < WriterClasses; writer++)
+      {
+         for (int instance = 0; instance < InstancesPerClass; instance++)
+         {
+            List<VssCapturedComponent^>^ components = gcnew List<VssCapturedComponent^>(ComponentsPerInstance);
+            for (int component = 0; component < ComponentsPerInstance; component++)
+            {
+               // The first component of each set is its root; the others are its members.
+               int set = component / ComponentSetSize;
+               bool isRoot = component % ComponentSetSize == 0;
+               String^ logicalPath = isRoot ? L"Sets" : String::Format(L"Sets\\Set{0}", set);
+               String^ name = isRoot ? String::Format(L"Set{0}", set) : String::Format(L"Component{0}", component);
+
+               array<VssWMDependency^>^ dependencies = gcnew array<VssWMDependency^>(2);
+               for (int i = 0; i < dependencies->Length; i++)
+               {
+                  int target = (writer + 1 + random->Next(WriterClasses - 1)) % WriterClasses;
+                  int targetSet = random->Next(ComponentsPerInstance / ComponentSetSize);
+                  dependencies[i] = gcnew VssWMDependency(writerIds[target], String::Format(L"Sets\\Set{0}", targetSet),
+                     String::Format(L"Component{0}", targetSet * ComponentSetSize + 1 + random->Next(ComponentSetSize - 1)));
+               }
+
+               components->Add(gcnew VssCapturedComponent(VssComponentType::FileGroup, logicalPath, name, nullptr, nullptr,
+                  false, false, true, true, VssComponentFlags::None, none, none, none, dependencies));
+            }
+
+            writers->Add(gcnew VssCapturedWriterMetadata(Guid::NewGuid(), writerIds[writer], String::Format(L"Writer {0}", writer), nullptr,
+               VssUsageType::UserData, VssSourceType::Other, VssBackupSchema::Undefined, nullptr, nullptr, none, none, none, components, nullptr));
+         }
+      }
+
+      return writers->AsReadOnly();
+   }
+}
+} } }
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "BenchmarkRunner.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   //
+   // Measures VssComponentDependencyGraph and VssComponentIndex over a synthetic set of 10,240 components: 20 writer
+   // classes of two instances each, with 256 components per instance in component sets of 16, and two dependencies per
+   // component on components of other writer classes. The index lookups are compared to a walk of the component lists.
+   //
+   private ref class ComponentBenchmarks abstract sealed
+   {
+   public:
+      literal int WriterClasses = 20;
+      literal int InstancesPerClass = 2;
+      literal int ComponentsPerInstance = 256;
+      literal int ComponentSetSize = 16;
+
+      static void AddTo(BenchmarkRunner^ runner);
+
+   private:
+      static void BuildGraph(int iterations);
+      static void FindCycles(int iterations);
+      static void GetClosure(int iterations);
+      static void GetIndependentGroups(int iterations);
+      static void Plan(int iterations);
+      static void CreateIndex(int iterations);
+      static void FindByWalking(int iterations);
+      static void FindInInstance(int iterations);
+      static void FindInClass(int iterations);
+      static void GetSubtree(int iterations);
+
+      static IList<IVssExamineWriterMetadata^>^ CreateWriters();
+
+      static IList<IVssExamineWriterMetadata^>^ s_writers;
+      static VssComponentDependencyGraph^ s_graph;
+      static IList<VssComponentKey^>^ s_selection;
+      static VssComponentIndex<IVssWMComponent^>^ s_index;
+
+      // Results are stored here so that the operations measured cannot be optimized away.
+      static int s_sink;
+   };
+}
+} } }
@@ -0,0 +1,62 @@
+#include "pch.h"
+
+#include "CopyBenchmarks.h"
+
+using namespace System::Threading;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   void CopyBenchmarks::AddTo(BenchmarkRunner^ runner)
+   {
+      runner->AddOnce(L"VssSnapshotCopyEngine, 4 x 32 MB files (per MB)", LargeFileCount * (LargeFileSize / (1024 * 1024)),
+         gcnew Action(&CopyBenchmarks::CreateLargeFiles), gcnew BenchmarkBody(&CopyBenchmarks::Copy), gcnew Action(&CopyBenchmarks::DeleteFiles));
+      runner->AddOnce(L"VssSnapshotCopyEngine, 2048 x 16 KB files (per MB)", SmallFileCount / (1024 * 1024 / SmallFileSize),
+         gcnew Action(&CopyBenchmarks::CreateSmallFiles), gcnew BenchmarkBody(&CopyBenchmarks::Copy), gcnew Action(&CopyBenchmarks::DeleteFiles));
+   }
+
+   void CopyBenchmarks::CreateLargeFiles()
+   {
+      CreateFiles(LargeFileCount, LargeFileSize);
+   }
+
+   void CopyBenchmarks::CreateSmallFiles()
+   {
+      CreateFiles(SmallFileCount, SmallFileSize);
+   }
+
+   void CopyBenchmarks::CreateFiles(int count, int size)
+   {
+      s_root = Path::Combine(Path::GetTempPath(), L"AlphaVSS.Benchmarks." + Guid::NewGuid().ToString(L"N"));
+      s_paths = gcnew array<String^>(count);
+
+      array<Byte>^ data = gcnew array<Byte>(size);
+      (gcnew Random(count))->NextBytes(data);
+
+      // The files are spread over directories of 256 files, like a typical tree.
+      for (int i = 0; i < count; i++)
+      {
+         s_paths[i] = Path::Combine(String::Format(L"{0:D3}", i / 256), String::Format(L"{0:D5}.bin", i));
+         String^ path = Path::Combine(s_root, L"Source", s_paths[i]);
+         Directory::CreateDirectory(Path::GetDirectoryName(path));
+         File::WriteAllBytes(path, data);
+      }
+   }
+
+   void CopyBenchmarks::Copy(int operations)
+   {
+      VssSnapshotCopyEngine^ engine = gcnew VssSnapshotCopyEngine(Path::Combine(s_root, L"Source"), Path::Combine(s_root, L"Destination"));
+      VssFileCopySummary^ summary = engine->CopyAsync(s_paths, nullptr, CancellationToken::None)->Result;
+      if (summary->FailedCount != 0)
+         throw gcnew InvalidOperationException(String::Format(L"{0} files could not be copied.", summary->FailedCount));
+
+      s_sink = summary->BytesCopied / operations;
+   }
+
+   void CopyBenchmarks::DeleteFiles()
+   {
+      Directory::Delete(s_root, true);
+      s_root = nullptr;
+      s_paths = nullptr;
+   }
+}
+} } }
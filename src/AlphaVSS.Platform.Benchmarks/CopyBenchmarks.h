@@ -0,0 +1,37 @@
+#pragma once
+
+#include "BenchmarkRunner.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   //
+   // Measures the throughput of VssSnapshotCopyEngine over a plain directory tree in the temporary directory, once for
+   // a few large files, copied with overlapped reads and writes, and once for many small files, copied with a single
+   // read and write each. Each operation is one megabyte copied. The copy runs on several threads, so the allocations
+   // reported include those of every worker.
+   //
+   private ref class CopyBenchmarks abstract sealed
+   {
+   public:
+      literal int LargeFileCount = 4;
+      literal int LargeFileSize = 32 * 1024 * 1024;
+      literal int SmallFileCount = 2048;
+      literal int SmallFileSize = 16 * 1024;
+
+      static void AddTo(BenchmarkRunner^ runner);
+
+   private:
+      static void CreateLargeFiles();
+      static void CreateSmallFiles();
+      static void CreateFiles(int count, int size);
+      static void Copy(int operations);
+      static void DeleteFiles();
+
+      static String^ s_root;
+      static array<String^>^ s_paths;
+
+      // Results are stored here so that the operations measured cannot be optimized away.
+      static long long s_sink;
+   };
+}
+} } }
@@ -0,0 +1,88 @@
+#include "pch.h"
+
+#include "EncodingBenchmarks.h"
+
+using namespace System::Globalization;
+using namespace System::Text;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   void EncodingBenchmarks::AddTo(BenchmarkRunner^ runner, TextWriter^ log)
+   {
+      if (log == nullptr)
+         throw gcnew ArgumentNullException(L"log");
+
+      s_xml = CreateDocument();
+      s_encoded = VssBinaryXmlEncoding::Encode(s_xml, false);
+      s_compressed = VssBinaryXmlEncoding::Encode(s_xml, true);
+
+      int xmlSize = Encoding::UTF8->GetByteCount(s_xml);
+      log->WriteLine(L"VssBinaryXmlEncoding: {0:N0} bytes of UTF-8 XML encode to {1:N0} bytes ({2:P1}), or {3:N0} bytes compressed ({4:P1}).",
+         xmlSize, s_encoded->Length, (double)s_encoded->Length / xmlSize, s_compressed->Length, (double)s_compressed->Length / xmlSize);
+
+      runner->Add(L"VssBinaryXmlEncoding, encode backup document", gcnew BenchmarkBody(&EncodingBenchmarks::Encode));
+      runner->Add(L"VssBinaryXmlEncoding, encode backup document, compressed", gcnew BenchmarkBody(&EncodingBenchmarks::EncodeCompressed));
+      runner->Add(L"VssBinaryXmlEncoding, decode backup document", gcnew BenchmarkBody(&EncodingBenchmarks::Decode));
+      runner->Add(L"VssBinaryXmlEncoding, decode backup document, compressed", gcnew BenchmarkBody(&EncodingBenchmarks::DecodeCompressed));
+   }
+
+   void EncodingBenchmarks::Encode(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = VssBinaryXmlEncoding::Encode(s_xml, false)->Length;
+   }
+
+   void EncodingBenchmarks::EncodeCompressed(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = VssBinaryXmlEncoding::Encode(s_xml, true)->Length;
+   }
+
+   void EncodingBenchmarks::Decode(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = VssBinaryXmlEncoding::Decode(s_encoded)->Length;
+   }
+
+   void EncodingBenchmarks::DecodeCompressed(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = VssBinaryXmlEncoding::Decode(s_compressed)->Length;
+   }
+
+   String^ EncodingBenchmarks::CreateDocument()
+   {
+      CultureInfo^ culture = CultureInfo::InvariantCulture;
+      StringBuilder^ xml = gcnew StringBuilder();
+      xml->AppendFormat(culture, L"<BACKUP_COMPONENTS xmlns=\"x-schema:#VssComponentMetadata\" version=\"1.2\" bootableSystemStateBackup=\"no\" "
+         L"selectComponents=\"yes\" backupType=\"FULL\" partialFileSupport=\"yes\" snapshotSetId=\"{0}\">", Guid::NewGuid().ToString(L"D"));
+
+      for (int writer = 0; writer < WriterCount; writer++)
+      {
+         xml->AppendFormat(culture, L"<WRITER_COMPONENTS instanceId=\"{0}\" writerId=\"{1}\"><WRITER_METADATA><![CDATA[opaque]]></WRITER_METADATA>",
+            Guid::NewGuid().ToString(L"D"), Guid::NewGuid().ToString(L"D"));
+
+         for (int component = 0; component < ComponentsPerWriter; component++)
+         {
+            String^ directory = String::Format(culture, L"C:\\Data\\Writer{0}\\Component{1}", writer, component);
+            xml->AppendFormat(culture, L"<COMPONENT logicalPath=\"Writer{0}\\Sets\" componentName=\"Component{1}\" componentType=\"filegroup\" "
+               L"backupSucceeded=\"yes\" backupStamp=\"{2:X16}\"><COMPONENT_METADATA><![CDATA[blob]]></COMPONENT_METADATA>",
+               writer, component, (long long)writer * ComponentsPerWriter + component);
+            xml->AppendFormat(culture, L"<PARTIAL_FILE path=\"{0}\" filespec=\"data.mdf\" ranges=\"0x0:0x10000,0x80000:0x2000\" metadata=\"\"/>", directory);
+
+            for (int file = 0; file < 4; file++)
+            {
+               xml->AppendFormat(culture, L"<DIFFERENCED_FILE path=\"{0}\\Files\" filespec=\"*.log{1}\" recursive=\"yes\" lastModifyTime=\"0x{2:X}\"/>",
+                  directory, file, DateTime(2020, 1, 1, 0, 0, 0, DateTimeKind::Utc).AddMinutes(component * 4 + file).ToFileTimeUtc());
+            }
+
+            xml->Append(L"</COMPONENT>");
+         }
+
+         xml->Append(L"</WRITER_COMPONENTS>");
+      }
+
+      return xml->Append(L"</BACKUP_COMPONENTS>")->ToString();
+   }
+}
+} } }
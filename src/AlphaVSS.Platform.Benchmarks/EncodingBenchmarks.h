@@ -0,0 +1,38 @@
+#pragma once
+
+#include "BenchmarkRunner.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   //
+   // Measures VssBinaryXmlEncoding over a synthetic saved Backup Components Document of 32 writers with 64 components
+   // each, every component with a partial file and four differenced files, encoding and decoding it with and without
+   // compression. Every operation processes the whole document, of about 1.7 MB of XML; its sizes, from which the
+   // throughput follows, and the size of the encoded documents relative to the XML are written to the log when the
+   // benchmarks are added.
+   //
+   private ref class EncodingBenchmarks abstract sealed
+   {
+   public:
+      literal int WriterCount = 32;
+      literal int ComponentsPerWriter = 64;
+
+      static void AddTo(BenchmarkRunner^ runner, TextWriter^ log);
+
+   private:
+      static void Encode(int iterations);
+      static void EncodeCompressed(int iterations);
+      static void Decode(int iterations);
+      static void DecodeCompressed(int iterations);
+
+      static String^ CreateDocument();
+
+      static String^ s_xml;
+      static array<Byte>^ s_encoded;
+      static array<Byte>^ s_compressed;
+
+      // Results are stored here so that the operations measured cannot be optimized away.
+      static int s_sink;
+   };
+}
+} } }
@@ -0,0 +1,57 @@
+#include "pch.h"
+
+#include "EnumerationBenchmarks.h"
+#include "FakeVssEnumObject.h"
+#include "VssBatchEnumerable.h"
+#include "VssSnapshotObjectTraits.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   namespace
+   {
+      typedef VssBatchEnumerable<IVssEnumObject, VSS_OBJECT_PROP, VssSnapshotProperties, SnapshotObjectTraits> SnapshotEnumerable;
+   }
+
+   void EnumerationBenchmarks::AddTo(BenchmarkRunner^ runner)
+   {
+      runner->Add(L"QuerySnapshots, batch size 1 (baseline)", gcnew BenchmarkBody(&EnumerationBenchmarks::EnumerateOneAtATime));
+      runner->Add(L"QuerySnapshots, default batch size", gcnew BenchmarkBody(&EnumerationBenchmarks::EnumerateInBatches));
+      runner->Add(L"QuerySnapshots, copied to list", gcnew BenchmarkBody(&EnumerationBenchmarks::CopyToList));
+   }
+
+   void EnumerationBenchmarks::EnumerateOneAtATime(int iterations)
+   {
+      Enumerate(iterations, 1);
+   }
+
+   void EnumerationBenchmarks::EnumerateInBatches(int iterations)
+   {
+      Enumerate(iterations, SnapshotEnumerable::DefaultBatchSize);
+   }
+
+   void EnumerationBenchmarks::CopyToList(int iterations)
+   {
+      FakeVssEnumObject snapshots(iterations);
+
+      SnapshotEnumerable^ enumerable = gcnew SnapshotEnumerable(&snapshots, SnapshotEnumerable::DefaultBatchSize);
+      try
+      {
+         s_sink = (gcnew List<VssSnapshotProperties^>(enumerable))->Count;
+      }
+      finally
+      {
+         delete enumerable;
+      }
+   }
+
+   void EnumerationBenchmarks::Enumerate(int iterations, int batchSize)
+   {
+      FakeVssEnumObject snapshots(iterations);
+
+      int sink = 0;
+      for each (VssSnapshotProperties^ snapshot in gcnew SnapshotEnumerable(&snapshots, batchSize))
+         sink ^= (int)snapshot->SnapshotsCount;
+      s_sink = sink;
+   }
+}
+} } }
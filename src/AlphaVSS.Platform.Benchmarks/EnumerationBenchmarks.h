@@ -0,0 +1,28 @@
+#pragma once
+
+#include "BenchmarkRunner.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   //
+   // Measures the per-snapshot cost of enumerating the result of a snapshot query: lazily, one snapshot per call to
+   // IVssEnumObject::Next as QuerySnapshots used to fetch them, lazily in batches of the default size, and eagerly
+   // into a list, as QuerySnapshots() returns them. Each operation is the enumeration of one snapshot.
+   //
+   private ref class EnumerationBenchmarks abstract sealed
+   {
+   public:
+      static void AddTo(BenchmarkRunner^ runner);
+
+   private:
+      static void EnumerateOneAtATime(int iterations);
+      static void EnumerateInBatches(int iterations);
+      static void CopyToList(int iterations);
+
+      static void Enumerate(int iterations, int batchSize);
+
+      // Results are stored here so that the operations measured cannot be optimized away.
+      static int s_sink;
+   };
+}
+} } }
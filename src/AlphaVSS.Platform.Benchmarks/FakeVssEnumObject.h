@@ -0,0 +1,136 @@
+#pragma once
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   //
+   // In-memory IVssEnumObject, standing in for the enumerator returned by a snapshot query so that the cost of
+   // enumerating it can be measured without the VSS service. Next returns the specified number of snapshots, with
+   // their strings allocated by CoTaskMemAlloc as VSS allocates them. The snapshots are generated as they are
+   // fetched, so that creating the fake costs the same whatever the number of snapshots.
+   //
+   // Next costs far less than the round trip to the VSS service it stands in for, so the benchmarks using the fake
+   // measure the per-snapshot overhead of the wrapper, not the savings of fetching snapshots in batches.
+   //
+   // The fake tracks its reference count. It is owned by the benchmark creating it, and is not deleted when its
+   // reference count drops to zero.
+   //
+   class FakeVssEnumObject : public IVssEnumObject
+   {
+   public:
+      FakeVssEnumObject(ULONG count)
+         : m_refCount(1), m_count(count), m_position(0)
+      {
+         m_snapshotSetId = Vss::ToVssId(Guid::NewGuid());
+         m_providerId = Vss::ToVssId(Guid::NewGuid());
+      }
+
+      virtual ~FakeVssEnumObject()
+      {
+      }
+
+      ULONG GetRefCount() const
+      {
+         return m_refCount;
+      }
+
+      //
+      // IUnknown
+      //
+      STDMETHOD(QueryInterface)(REFIID riid, void **ppvObject)
+      {
+         if (ppvObject == NULL)
+            return E_POINTER;
+
+         if (riid == IID_IUnknown || riid == __uuidof(IVssEnumObject))
+         {
+            *ppvObject = static_cast<IVssEnumObject *>(this);
+            AddRef();
+            return S_OK;
+         }
+
+         *ppvObject = NULL;
+         return E_NOINTERFACE;
+      }
+
+      STDMETHOD_(ULONG, AddRef)()
+      {
+         return ++m_refCount;
+      }
+
+      STDMETHOD_(ULONG, Release)()
+      {
+         return --m_refCount;
+      }
+
+      //
+      // IVssEnumObject
+      //
+      STDMETHOD(Next)(ULONG celt, VSS_OBJECT_PROP *rgelt, ULONG *pceltFetched)
+      {
+         if (rgelt == NULL || pceltFetched == NULL)
+            return E_POINTER;
+
+         ULONG fetched = 0;
+         while (fetched < celt && m_position < m_count)
+            ToProperties(m_position++, rgelt[fetched++]);
+
+         *pceltFetched = fetched;
+         return fetched == celt ? S_OK : S_FALSE;
+      }
+
+      STDMETHOD(Skip)(ULONG celt)
+      {
+         m_position = (m_count - m_position > celt) ? m_position + celt : m_count;
+         return m_position < m_count ? S_OK : S_FALSE;
+      }
+
+      STDMETHOD(Reset)()
+      {
+         m_position = 0;
+         return S_OK;
+      }
+
+      STDMETHOD(Clone)(IVssEnumObject **ppenum)
+      {
+         UNREFERENCED_PARAMETER(ppenum);
+         return E_NOTIMPL;
+      }
+
+   private:
+      static VSS_PWSZ Duplicate(const wchar_t *value)
+      {
+         size_t size = (wcslen(value) + 1) * sizeof(wchar_t);
+         VSS_PWSZ copy = static_cast<VSS_PWSZ>(::CoTaskMemAlloc(size));
+         memcpy(copy, value, size);
+         return copy;
+      }
+
+      void ToProperties(ULONG index, VSS_OBJECT_PROP &prop)
+      {
+         prop.Type = VSS_OBJECT_SNAPSHOT;
+
+         VSS_SNAPSHOT_PROP &snap = prop.Obj.Snap;
+         snap.m_SnapshotId = m_snapshotSetId;
+         snap.m_SnapshotId.Data1 = index;
+         snap.m_SnapshotSetId = m_snapshotSetId;
+         snap.m_lSnapshotsCount = 1;
+         snap.m_pwszSnapshotDeviceObject = Duplicate(L"\\\\?\\GLOBALROOT\\Device\\HarddiskVolumeShadowCopy42");
+         snap.m_pwszOriginalVolumeName = Duplicate(L"\\\\?\\Volume{8d5d6b3b-2f7a-11e3-93e1-806e6f6e6963}\\");
+         snap.m_pwszOriginatingMachine = Duplicate(L"host.example.com");
+         snap.m_pwszServiceMachine = Duplicate(L"host.example.com");
+         snap.m_pwszExposedName = NULL;
+         snap.m_pwszExposedPath = NULL;
+         snap.m_ProviderId = m_providerId;
+         snap.m_lSnapshotAttributes = VSS_CTX_CLIENT_ACCESSIBLE;
+         snap.m_tsCreationTimestamp = 132000000000000000LL;
+         snap.m_eStatus = VSS_SS_CREATED;
+      }
+
+      ULONG m_refCount;
+      ULONG m_count;
+      ULONG m_position;
+      VSS_ID m_snapshotSetId;
+      VSS_ID m_providerId;
+   };
+}
+} } }
@@ -0,0 +1,130 @@
+#pragma once
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   //
+   // In-memory IVssWMComponent, standing in for the component of a writer's metadata document so that the cost
+   // of wrapping it can be measured without the VSS service. GetComponentInfo allocates the component info and
+   // its strings as VSS does, and FreeComponentInfo frees them again. The component has no files or dependencies.
+   //
+   // The fake tracks its reference count. It is owned by the benchmark creating it, and is not deleted when its
+   // reference count drops to zero.
+   //
+   class FakeVssWMComponent : public IVssWMComponent
+   {
+   public:
+      FakeVssWMComponent()
+         : m_refCount(1)
+      {
+      }
+
+      virtual ~FakeVssWMComponent()
+      {
+      }
+
+      ULONG GetRefCount() const
+      {
+         return m_refCount;
+      }
+
+      //
+      // IUnknown
+      //
+      STDMETHOD(QueryInterface)(REFIID riid, void **ppvObject)
+      {
+         if (ppvObject == NULL)
+            return E_POINTER;
+
+         if (riid == IID_IUnknown)
+         {
+            *ppvObject = static_cast<IUnknown *>(this);
+            AddRef();
+            return S_OK;
+         }
+
+         *ppvObject = NULL;
+         return E_NOINTERFACE;
+      }
+
+      STDMETHOD_(ULONG, AddRef)()
+      {
+         return ++m_refCount;
+      }
+
+      STDMETHOD_(ULONG, Release)()
+      {
+         return --m_refCount;
+      }
+
+      //
+      // IVssWMComponent
+      //
+      STDMETHOD(GetComponentInfo)(PVSSCOMPONENTINFO *ppInfo)
+      {
+         if (ppInfo == NULL)
+            return E_POINTER;
+
+         PVSSCOMPONENTINFO info = static_cast<PVSSCOMPONENTINFO>(::CoTaskMemAlloc(sizeof(VSS_COMPONENTINFO)));
+         if (info == NULL)
+            return E_OUTOFMEMORY;
+
+         ZeroMemory(info, sizeof(VSS_COMPONENTINFO));
+         info->type = VSS_CT_FILEGROUP;
+         info->bstrLogicalPath = ::SysAllocString(L"Registry");
+         info->bstrComponentName = ::SysAllocString(L"Registry Writer Component");
+         info->bstrCaption = ::SysAllocString(L"The system registry hives");
+         info->bRestoreMetadata = false;
+         info->bNotifyOnBackupComplete = true;
+         info->bSelectable = true;
+         info->bSelectableForRestore = true;
+         info->dwComponentFlags = VSS_CF_APP_ROLLBACK_RECOVERY;
+
+         *ppInfo = info;
+         return S_OK;
+      }
+
+      STDMETHOD(FreeComponentInfo)(PVSSCOMPONENTINFO pInfo)
+      {
+         if (pInfo == NULL)
+            return S_OK;
+
+         ::SysFreeString(pInfo->bstrLogicalPath);
+         ::SysFreeString(pInfo->bstrComponentName);
+         ::SysFreeString(pInfo->bstrCaption);
+         ::CoTaskMemFree(pInfo);
+         return S_OK;
+      }
+
+      STDMETHOD(GetFile)(UINT iFile, IVssWMFiledesc **ppFiledesc)
+      {
+         UNREFERENCED_PARAMETER(iFile);
+         UNREFERENCED_PARAMETER(ppFiledesc);
+         return E_INVALIDARG;
+      }
+
+      STDMETHOD(GetDatabaseFile)(UINT iDBFile, IVssWMFiledesc **ppFiledesc)
+      {
+         UNREFERENCED_PARAMETER(iDBFile);
+         UNREFERENCED_PARAMETER(ppFiledesc);
+         return E_INVALIDARG;
+      }
+
+      STDMETHOD(GetDatabaseLogFile)(UINT iDbLogFile, IVssWMFiledesc **ppFiledesc)
+      {
+         UNREFERENCED_PARAMETER(iDbLogFile);
+         UNREFERENCED_PARAMETER(ppFiledesc);
+         return E_INVALIDARG;
+      }
+
+      STDMETHOD(GetDependency)(UINT iDependency, IVssWMDependency **ppDependency)
+      {
+         UNREFERENCED_PARAMETER(iDependency);
+         UNREFERENCED_PARAMETER(ppDependency);
+         return E_INVALIDARG;
+      }
+
+   private:
+      ULONG m_refCount;
+   };
+}
+} } }
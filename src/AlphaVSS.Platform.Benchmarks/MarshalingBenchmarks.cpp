@@ -0,0 +1,180 @@
+#include "pch.h"
+
+#include "MarshalingBenchmarks.h"
+#include "FakeVssWMComponent.h"
+#include "VssWMComponent.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   namespace
+   {
+      const wchar_t VolumeName[] = L"\\\\?\\Volume{8d5d6b3b-2f7a-11e3-93e1-806e6f6e6963}\\";
+   }
+
+   void MarshalingBenchmarks::AddTo(BenchmarkRunner^ runner)
+   {
+      runner->Add(L"ToVssId", gcnew BenchmarkBody(&MarshalingBenchmarks::ToVssId));
+      runner->Add(L"ToGuid", gcnew BenchmarkBody(&MarshalingBenchmarks::ToGuid));
+      runner->Add(L"VssIds, 4 ids (inline)", gcnew BenchmarkBody(&MarshalingBenchmarks::VssIdsInline));
+      runner->Add(L"VssIds, 32 ids (native array)", gcnew BenchmarkBody(&MarshalingBenchmarks::VssIdsHeap));
+      runner->Add(L"AutoMStr", gcnew BenchmarkBody(&MarshalingBenchmarks::AutoMStr));
+      runner->Add(L"AutoMBStr", gcnew BenchmarkBody(&MarshalingBenchmarks::AutoMBStr));
+      runner->Add(L"SysAllocString (baseline)", gcnew BenchmarkBody(&MarshalingBenchmarks::SysAllocString));
+      runner->Add(L"AutoBStr to String", gcnew BenchmarkBody(&MarshalingBenchmarks::AutoBStrToString));
+      runner->Add(L"CreateVssSnapshotProperties", gcnew BenchmarkBody(&MarshalingBenchmarks::CreateVssSnapshotProperties));
+      runner->Add(L"VssWMComponent::Adopt", gcnew BenchmarkBody(&MarshalingBenchmarks::VssWMComponentAdopt));
+   }
+
+   void MarshalingBenchmarks::ToVssId(int iterations)
+   {
+      Guid guid = Guid::NewGuid();
+      int sink = 0;
+      for (int i = 0; i < iterations; i++)
+      {
+         VSS_ID id = Vss::ToVssId(guid);
+         sink ^= id.Data1;
+      }
+      s_sink = sink;
+   }
+
+   void MarshalingBenchmarks::ToGuid(int iterations)
+   {
+      VSS_ID id = Vss::ToVssId(Guid::NewGuid());
+      for (int i = 0; i < iterations; i++)
+      {
+         id.Data1 = i;
+         s_guid = Vss::ToGuid(id);
+      }
+   }
+
+   void MarshalingBenchmarks::VssIdsInline(int iterations)
+   {
+      ConvertIds(iterations, 4);
+   }
+
+   void MarshalingBenchmarks::VssIdsHeap(int iterations)
+   {
+      ConvertIds(iterations, 32);
+   }
+
+   // The ids of a DisableWriterClasses or EnableWriterClasses call; neither conversion should allocate managed memory.
+   void MarshalingBenchmarks::ConvertIds(int iterations, int count)
+   {
+      array<Guid>^ guids = gcnew array<Guid>(count);
+      for (int i = 0; i < count; i++)
+         guids[i] = Guid::NewGuid();
+
+      int sink = 0;
+      for (int i = 0; i < iterations; i++)
+      {
+         Vss::VssIds ids(guids);
+         sink ^= ((VSS_ID *)ids)[count - 1].Data1;
+      }
+      s_sink = sink;
+   }
+
+   void MarshalingBenchmarks::AutoMStr(int iterations)
+   {
+      String^ value = gcnew String(VolumeName);
+      int sink = 0;
+      for (int i = 0; i < iterations; i++)
+      {
+         Vss::AutoMStr str(value);
+         sink ^= ((VSS_PWSZ)str)[4];
+      }
+      s_sink = sink;
+   }
+
+   void MarshalingBenchmarks::AutoMBStr(int iterations)
+   {
+      String^ value = gcnew String(VolumeName);
+      int sink = 0;
+      for (int i = 0; i < iterations; i++)
+      {
+         Vss::AutoMBStr str(value);
+         sink ^= ((BSTR)str)[4];
+      }
+      s_sink = sink;
+   }
+
+   // The cost of the BSTR allocation VSS performs, included in the AutoBStr measurement below.
+   void MarshalingBenchmarks::SysAllocString(int iterations)
+   {
+      int sink = 0;
+      for (int i = 0; i < iterations; i++)
+      {
+         BSTR str = ::SysAllocString(VolumeName);
+         sink ^= str[4];
+         ::SysFreeString(str);
+      }
+      s_sink = sink;
+   }
+
+   void MarshalingBenchmarks::AutoBStrToString(int iterations)
+   {
+      int sink = 0;
+      for (int i = 0; i < iterations; i++)
+      {
+         AutoBStr str(::SysAllocString(VolumeName));
+         String^ value = str;
+         sink ^= value->Length;
+      }
+      s_sink = sink;
+   }
+
+   // Includes allocating the six strings of the structure, which VSS allocates and CreateVssSnapshotProperties frees.
+   void MarshalingBenchmarks::CreateVssSnapshotProperties(int iterations)
+   {
+      VSS_ID snapshotId = Vss::ToVssId(Guid::NewGuid());
+      VSS_ID snapshotSetId = Vss::ToVssId(Guid::NewGuid());
+      VSS_ID providerId = Vss::ToVssId(Guid::NewGuid());
+
+      int sink = 0;
+      for (int i = 0; i < iterations; i++)
+      {
+         VSS_SNAPSHOT_PROP prop;
+         prop.m_SnapshotId = snapshotId;
+         prop.m_SnapshotSetId = snapshotSetId;
+         prop.m_lSnapshotsCount = 1;
+         prop.m_pwszSnapshotDeviceObject = Duplicate(L"\\\\?\\GLOBALROOT\\Device\\HarddiskVolumeShadowCopy42");
+         prop.m_pwszOriginalVolumeName = Duplicate(VolumeName);
+         prop.m_pwszOriginatingMachine = Duplicate(L"host.example.com");
+         prop.m_pwszServiceMachine = Duplicate(L"host.example.com");
+         prop.m_pwszExposedName = Duplicate(L"");
+         prop.m_pwszExposedPath = Duplicate(L"");
+         prop.m_ProviderId = providerId;
+         prop.m_lSnapshotAttributes = VSS_CTX_BACKUP;
+         prop.m_tsCreationTimestamp = 132000000000000000LL;
+         prop.m_eStatus = VSS_SS_CREATED;
+
+         VssSnapshotProperties^ properties = Vss::CreateVssSnapshotProperties(&prop);
+         sink ^= (int)properties->SnapshotsCount;
+      }
+      s_sink = sink;
+   }
+
+   void MarshalingBenchmarks::VssWMComponentAdopt(int iterations)
+   {
+      FakeVssWMComponent component;
+
+      int sink = 0;
+      for (int i = 0; i < iterations; i++)
+      {
+         // Adopt takes ownership of a reference, which is released when the wrapper is disposed.
+         component.AddRef();
+         VssWMComponent^ wrapper = VssWMComponent::Adopt(&component);
+         sink ^= wrapper->ComponentName->Length;
+         delete wrapper;
+      }
+      s_sink = sink;
+   }
+
+   VSS_PWSZ MarshalingBenchmarks::Duplicate(const wchar_t *value)
+   {
+      size_t size = (wcslen(value) + 1) * sizeof(wchar_t);
+      VSS_PWSZ copy = static_cast<VSS_PWSZ>(::CoTaskMemAlloc(size));
+      memcpy(copy, value, size);
+      return copy;
+   }
+}
+} } }
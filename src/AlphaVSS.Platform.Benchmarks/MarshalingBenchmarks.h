@@ -0,0 +1,37 @@
+#pragma once
+
+#include "BenchmarkRunner.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   //
+   // Measures the per-call cost of the conversions the platform assembly performs between managed values and 
+   // the values passed to and returned by VSS: GUIDs, the string wrappers of Utils.h, and the construction of 
+   // the managed objects wrapping VSS structures and interfaces.
+   //
+   private ref class MarshalingBenchmarks abstract sealed
+   {
+   public:
+      static void AddTo(BenchmarkRunner^ runner);
+
+   private:
+      static void ToVssId(int iterations);
+      static void ToGuid(int iterations);
+      static void VssIdsInline(int iterations);
+      static void VssIdsHeap(int iterations);
+      static void ConvertIds(int iterations, int count);
+      static void AutoMStr(int iterations);
+      static void AutoMBStr(int iterations);
+      static void SysAllocString(int iterations);
+      static void AutoBStrToString(int iterations);
+      static void CreateVssSnapshotProperties(int iterations);
+      static void VssWMComponentAdopt(int iterations);
+
+      static VSS_PWSZ Duplicate(const wchar_t *value);
+
+      // Results are stored here so that the operations measured cannot be optimized away.
+      static int s_sink;
+      static Guid s_guid;
+   };
+}
+} } }
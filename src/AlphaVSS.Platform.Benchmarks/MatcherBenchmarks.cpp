@@ -0,0 +1,98 @@
+#include "pch.h"
+
+#include "MatcherBenchmarks.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   void MatcherBenchmarks::AddTo(BenchmarkRunner^ runner)
+   {
+      s_writers = CreateWriters();
+      s_matcher = gcnew VssFileSpecificationMatcher(s_writers);
+      s_paths = CreatePaths();
+      s_matches = gcnew List<VssFileSpecificationMatch^>();
+
+      runner->Add(L"VssFileSpecificationMatcher, build (1,960 descriptors)", gcnew BenchmarkBody(&MatcherBenchmarks::Build));
+      runner->Add(L"VssFileSpecificationMatcher, classify path", gcnew BenchmarkBody(&MatcherBenchmarks::Classify));
+      runner->Add(L"VssFileSpecificationMatcher, is path excluded", gcnew BenchmarkBody(&MatcherBenchmarks::IsExcluded));
+   }
+
+   void MatcherBenchmarks::Build(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = (gcnew VssFileSpecificationMatcher(s_writers))->DescriptorCount;
+   }
+
+   void MatcherBenchmarks::Classify(int iterations)
+   {
+      // The collection is reused, as a scan of a volume would.
+      int sink = 0;
+      for (int i = 0; i < iterations; i++)
+      {
+         s_matches->Clear();
+         sink += s_matcher->Classify(s_paths[i % PathCount], s_matches);
+      }
+      s_sink = sink;
+   }
+
+   void MatcherBenchmarks::IsExcluded(int iterations)
+   {
+      int sink = 0;
+      for (int i = 0; i < iterations; i++)
+         sink += s_matcher->IsExcluded(s_paths[i % PathCount]) ? 1 : 0;
+      s_sink = sink;
+   }
+
+   IList<IVssExamineWriterMetadata^>^ MatcherBenchmarks::CreateWriters()
+   {
+      array<VssWMFileDescriptor^>^ none = gcnew array<VssWMFileDescriptor^>(0);
+      array<VssWMDependency^>^ noDependencies = gcnew array<VssWMDependency^>(0);
+      List<IVssExamineWriterMetadata^>^ writers = gcnew List<IVssExamineWriterMetadata^>();
+      for (int writer = 0; writer < WriterCount; writer++)
+      {
+         List<VssCapturedComponent^>^ components = gcnew List<VssCapturedComponent^>(ComponentsPerWriter);
+         for (int component = 0; component < ComponentsPerWriter; component++)
+         {
+            String^ directory = String::Format(L"C:\\Data\\Writer{0}\\Component{1}", writer, component);
+            array<VssWMFileDescriptor^>^ files = gcnew array<VssWMFileDescriptor^>
+            {
+               gcnew VssWMFileDescriptor(nullptr, VssFileSpecificationBackupType::FullBackupRequired, L"*", directory + L"\\Files", true),
+               gcnew VssWMFileDescriptor(nullptr, VssFileSpecificationBackupType::FullBackupRequired, L"*.dat", directory, component % 2 == 0),
+               gcnew VssWMFileDescriptor(nullptr, VssFileSpecificationBackupType::FullBackupRequired, L"settings.ini", directory, false),
+            };
+
+            components->Add(gcnew VssCapturedComponent(VssComponentType::FileGroup, nullptr, String::Format(L"Component{0}", component), nullptr, nullptr,
+               false, false, true, true, VssComponentFlags::None, files, none, none, noDependencies));
+         }
+
+         array<VssWMFileDescriptor^>^ excludeFiles = gcnew array<VssWMFileDescriptor^>
+         {
+            gcnew VssWMFileDescriptor(nullptr, VssFileSpecificationBackupType::FullBackupRequired, L"*.tmp", String::Format(L"C:\\Data\\Writer{0}", writer), true),
+         };
+
+         writers->Add(gcnew VssCapturedWriterMetadata(Guid::NewGuid(), Guid::NewGuid(), String::Format(L"Writer {0}", writer), nullptr,
+            VssUsageType::UserData, VssSourceType::Other, VssBackupSchema::Undefined, nullptr, nullptr, none, excludeFiles, none, components, nullptr));
+      }
+
+      return writers->AsReadOnly();
+   }
+
+   array<String^>^ MatcherBenchmarks::CreatePaths()
+   {
+      // A fixed seed keeps the paths, and therefore the results, comparable between runs.
+      Random^ random = gcnew Random(13);
+      array<String^>^ extensions = gcnew array<String^> { L".dat", L".tmp", L".txt", L".ini", L".log" };
+      array<String^>^ paths = gcnew array<String^>(PathCount);
+      for (int i = 0; i < PathCount; i++)
+      {
+         int writer = random->Next(WriterCount * 2);
+         String^ root = writer < WriterCount ? String::Format(L"C:\\Data\\Writer{0}", writer) : String::Format(L"C:\\Users\\User{0}\\Documents", writer);
+         String^ directory = String::Format(L"{0}\\Component{1}{2}", root, random->Next(ComponentsPerWriter),
+            random->Next(3) == 0 ? L"\\Files\\Nested" : (random->Next(2) == 0 ? L"" : L"\\Sub"));
+         String^ name = random->Next(20) == 0 ? L"settings.ini" : String::Format(L"file{0}{1}", i, extensions[random->Next(extensions->Length)]);
+         paths[i] = directory + L"\\" + name;
+      }
+
+      return paths;
+   }
+}
+} } }
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "BenchmarkRunner.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   //
+   // Measures VssFileSpecificationMatcher over the descriptors of 40 synthetic writers, each with 16 components of
+   // three descriptors (all files, an extension and a literal file name, recursive or not) and an exclusion, classifying
+   // 100,000 synthetic paths, over a quarter of which match a descriptor.
+   //
+   private ref class MatcherBenchmarks abstract sealed
+   {
+   public:
+      literal int WriterCount = 40;
+      literal int ComponentsPerWriter = 16;
+      literal int PathCount = 100000;
+
+      static void AddTo(BenchmarkRunner^ runner);
+
+   private:
+      static void Build(int iterations);
+      static void Classify(int iterations);
+      static void IsExcluded(int iterations);
+
+      static IList<IVssExamineWriterMetadata^>^ CreateWriters();
+      static array<String^>^ CreatePaths();
+
+      static IList<IVssExamineWriterMetadata^>^ s_writers;
+      static VssFileSpecificationMatcher^ s_matcher;
+      static array<String^>^ s_paths;
+      static List<VssFileSpecificationMatch^>^ s_matches;
+
+      // Results are stored here so that the operations measured cannot be optimized away.
+      static int s_sink;
+   };
+}
+} } }
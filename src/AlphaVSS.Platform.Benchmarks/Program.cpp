@@ -0,0 +1,85 @@
+#include "pch.h"
+
+#include "BenchmarkRunner.h"
+#include "ComponentBenchmarks.h"
+#include "CopyBenchmarks.h"
+#include "EncodingBenchmarks.h"
+#include "EnumerationBenchmarks.h"
+#include "MarshalingBenchmarks.h"
+#include "MatcherBenchmarks.h"
+#include "RangeBenchmarks.h"
+#include "StartupBenchmarks.h"
+
+using namespace System;
+using namespace System::IO;
+using namespace Alphaleonis::Win32::Vss::Benchmarks;
+
+//
+// Runs the AlphaVSS platform benchmarks. Does not require the VSS service, or administrative privileges, unless the
+// startup benchmarks are run. The copy benchmarks need about 300 MB of free space in the temporary directory.
+//
+// Usage: AlphaVSS.Platform.Benchmarks [--filter <text>] [--output <file>] [--startup <directory>]
+//
+//    --filter   Runs only the benchmarks whose name contains the specified text.
+//    --output   Writes the results to the specified file as JSON, to be compared between versions.
+//    --startup  Also runs the startup benchmarks, against the VSS service, with the platform specific assembly
+//               (AlphaVSS.x64.dll or AlphaVSS.x86.dll) loaded from the specified directory.
+//
+int main(array<String^>^ args)
+{
+   String^ filter = nullptr;
+   String^ output = nullptr;
+   String^ startup = nullptr;
+
+   for (int i = 0; i < args->Length; i++)
+   {
+      if (String::Equals(args[i], L"--filter", StringComparison::OrdinalIgnoreCase) && i + 1 < args->Length)
+      {
+         filter = args[++i];
+      }
+      else if (String::Equals(args[i], L"--output", StringComparison::OrdinalIgnoreCase) && i + 1 < args->Length)
+      {
+         output = args[++i];
+      }
+      else if (String::Equals(args[i], L"--startup", StringComparison::OrdinalIgnoreCase) && i + 1 < args->Length)
+      {
+         startup = args[++i];
+      }
+      else
+      {
+         Console::Error->WriteLine(L"Usage: AlphaVSS.Platform.Benchmarks [--filter <text>] [--output <file>] [--startup <directory>]");
+         return 1;
+      }
+   }
+
+   BenchmarkRunner^ runner = gcnew BenchmarkRunner(Console::Out);
+
+   // The startup benchmarks come first, since they measure the initialization the first session of a process pays for.
+   if (startup != nullptr)
+      StartupBenchmarks::AddTo(runner, startup);
+
+   MarshalingBenchmarks::AddTo(runner);
+   EnumerationBenchmarks::AddTo(runner);
+   ComponentBenchmarks::AddTo(runner);
+   MatcherBenchmarks::AddTo(runner);
+   RangeBenchmarks::AddTo(runner);
+   EncodingBenchmarks::AddTo(runner, Console::Out);
+   CopyBenchmarks::AddTo(runner);
+
+   IList<BenchmarkResult^>^ results = runner->Run(filter);
+
+   if (output != nullptr)
+   {
+      StreamWriter^ writer = gcnew StreamWriter(output);
+      try
+      {
+         BenchmarkRunner::WriteJson(writer, results);
+      }
+      finally
+      {
+         delete writer;
+      }
+   }
+
+   return 0;
+}
@@ -0,0 +1,71 @@
+#include "pch.h"
+
+#include "RangeBenchmarks.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   void RangeBenchmarks::AddTo(BenchmarkRunner^ runner)
+   {
+      // A fixed seed keeps the order of the ranges, and therefore the results, comparable between runs.
+      Random^ random = gcnew Random(22);
+      s_ranges = gcnew array<VssFileRange>(RangeCount);
+      for (int i = 0; i < RangeCount; i++)
+         s_ranges[i] = VssFileRange((long long)i * RangeStride, i % 10 == 0 ? RangeStride + RangeLength : RangeLength);
+      for (int i = RangeCount - 1; i > 0; i--)
+      {
+         int j = random->Next(i + 1);
+         VssFileRange swap = s_ranges[i];
+         s_ranges[i] = s_ranges[j];
+         s_ranges[j] = swap;
+      }
+
+      System::Text::StringBuilder^ builder = gcnew System::Text::StringBuilder();
+      for (int i = 0; i < RangeCount; i++)
+         builder->Append(i == 0 ? L"" : L",")->Append(s_ranges[i].ToString());
+      s_rangeString = builder->ToString();
+      s_list = gcnew VssFileRangeList(s_ranges);
+
+      MemoryStream^ rangesFile = gcnew MemoryStream();
+      s_list->WriteRangesFile(rangesFile);
+      s_rangesFile = rangesFile->ToArray();
+
+      s_source = gcnew MemoryStream(gcnew array<Byte>(RangeCount * RangeStride + RangeLength), false);
+
+      runner->Add(L"VssFileRangeList, parse 100,000 ranges", gcnew BenchmarkBody(&RangeBenchmarks::Parse));
+      runner->Add(L"VssFileRangeList, normalize 100,000 ranges", gcnew BenchmarkBody(&RangeBenchmarks::Normalize));
+      runner->Add(L"VssFileRangeList, read ranges file of 100,000 ranges", gcnew BenchmarkBody(&RangeBenchmarks::ReadRangesFile));
+      runner->Add(L"VssFileRangeList, coalesce 100,000 ranges", gcnew BenchmarkBody(&RangeBenchmarks::Coalesce));
+      runner->Add(L"VssFileRangeList, copy 100,000 ranges", gcnew BenchmarkBody(&RangeBenchmarks::Copy));
+   }
+
+   void RangeBenchmarks::Parse(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = VssFileRangeList::Parse(s_rangeString)->Count;
+   }
+
+   void RangeBenchmarks::Normalize(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = (gcnew VssFileRangeList(s_ranges))->Count;
+   }
+
+   void RangeBenchmarks::ReadRangesFile(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = VssFileRangeList::ReadRangesFile(gcnew MemoryStream(s_rangesFile, false))->Count;
+   }
+
+   void RangeBenchmarks::Coalesce(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = s_list->Coalesce(MaxGap)->Count;
+   }
+
+   void RangeBenchmarks::Copy(int iterations)
+   {
+      for (int i = 0; i < iterations; i++)
+         s_sink = s_list->CopyTo(s_source, Stream::Null, MaxGap);
+   }
+}
+} } }
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "BenchmarkRunner.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   //
+   // Measures VssFileRangeList over 100,000 ranges of 64 bytes, one every 256 bytes of a 25 MB file, given in shuffled
+   // order with every tenth range overlapping its successor: parsing the range string, normalizing the ranges, reading a
+   // ranges file, coalescing the ranges into reads, and copying the ranges out of an in-memory file.
+   //
+   private ref class RangeBenchmarks abstract sealed
+   {
+   public:
+      literal int RangeCount = 100000;
+      literal int RangeLength = 64;
+      literal int RangeStride = 256;
+      literal int MaxGap = 4096;
+
+      static void AddTo(BenchmarkRunner^ runner);
+
+   private:
+      static void Parse(int iterations);
+      static void Normalize(int iterations);
+      static void ReadRangesFile(int iterations);
+      static void Coalesce(int iterations);
+      static void Copy(int iterations);
+
+      static array<VssFileRange>^ s_ranges;
+      static String^ s_rangeString;
+      static array<Byte>^ s_rangesFile;
+      static VssFileRangeList^ s_list;
+      static MemoryStream^ s_source;
+
+      // Results are stored here so that the operations measured cannot be optimized away.
+      static long long s_sink;
+   };
+}
+} } }
@@ -0,0 +1,60 @@
+#include "pch.h"
+
+#include "StartupBenchmarks.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   void StartupBenchmarks::AddTo(BenchmarkRunner^ runner, String^ platformDirectory)
+   {
+      if (platformDirectory == nullptr)
+         throw gcnew ArgumentNullException(L"platformDirectory");
+
+      s_factoryProvider = gcnew VssFactoryProvider(gcnew DirectoryAssemblyResolver(Path::GetFullPath(platformDirectory)));
+
+      runner->AddOnce(L"WarmUp (first call)", 1, nullptr, gcnew BenchmarkBody(&StartupBenchmarks::WarmUp), nullptr);
+      runner->AddOnce(L"Session, created on demand", Sessions, nullptr, gcnew BenchmarkBody(&StartupBenchmarks::CreateSession), nullptr);
+      runner->AddOnce(L"Session, rented from pool", Sessions, gcnew Action(&StartupBenchmarks::FillPool),
+         gcnew BenchmarkBody(&StartupBenchmarks::RentSession), gcnew Action(&StartupBenchmarks::DisposePool));
+   }
+
+   void StartupBenchmarks::WarmUp(int operations)
+   {
+      for (int i = 0; i < operations; i++)
+         s_sink = VssFactoryProviderExtensions::WarmUp(s_factoryProvider)->Count;
+   }
+
+   void StartupBenchmarks::CreateSession(int operations)
+   {
+      for (int i = 0; i < operations; i++)
+      {
+         IVssBackupComponents^ backupComponents = s_factoryProvider->GetVssFactory()->CreateVssBackupComponents();
+         try
+         {
+            backupComponents->InitializeForBackup(nullptr);
+         }
+         finally
+         {
+            delete backupComponents;
+         }
+      }
+   }
+
+   void StartupBenchmarks::FillPool()
+   {
+      s_pool = gcnew VssBackupComponentsPool(s_factoryProvider->GetVssFactory(), Sessions);
+      s_pool->Fill();
+   }
+
+   void StartupBenchmarks::RentSession(int operations)
+   {
+      for (int i = 0; i < operations; i++)
+         delete s_pool->Rent();
+   }
+
+   void StartupBenchmarks::DisposePool()
+   {
+      delete s_pool;
+      s_pool = nullptr;
+   }
+}
+} } }
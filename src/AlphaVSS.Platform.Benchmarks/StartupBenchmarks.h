@@ -0,0 +1,58 @@
+#pragma once
+
+#include "BenchmarkRunner.h"
+
+using namespace System::Reflection;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Benchmarks
+{
+   //
+   // Measures the latency until a backup session can start: the one-time initialization VssFactoryProvider's WarmUp
+   // front-loads, and the creation of a backup components object initialized for backup, on demand and when rented
+   // from a filled VssBackupComponentsPool. Each session includes the disposal of its object.
+   //
+   // Unlike the other benchmarks, these require the VSS service and administrative privileges, and load the platform
+   // assembly from the specified directory. They are measured once, and must be added before any other benchmark
+   // initializes COM, so that WarmUp measures the cost the first session of a process pays. The allocations reported
+   // for the pool include those of the replacements it creates in the background.
+   //
+   private ref class StartupBenchmarks abstract sealed
+   {
+   public:
+      // The number of sessions measured by each session benchmark, and the capacity of the pool.
+      literal int Sessions = 8;
+
+      static void AddTo(BenchmarkRunner^ runner, String^ platformDirectory);
+
+   private:
+      ref class DirectoryAssemblyResolver sealed : IVssAssemblyResolver
+      {
+      public:
+         DirectoryAssemblyResolver(String^ directory)
+            : m_directory(directory)
+         {
+         }
+
+         virtual Assembly^ LoadAssembly(AssemblyName^ assemblyName)
+         {
+            return Assembly::LoadFrom(Path::Combine(m_directory, assemblyName->Name + L".dll"));
+         }
+
+      private:
+         String^ m_directory;
+      };
+
+      static void WarmUp(int operations);
+      static void CreateSession(int operations);
+      static void FillPool();
+      static void RentSession(int operations);
+      static void DisposePool();
+
+      static IVssFactoryProvider^ s_factoryProvider;
+      static VssBackupComponentsPool^ s_pool;
+
+      // Results are stored here so that the operations measured cannot be optimized away.
+      static int s_sink;
+   };
+}
+} } }
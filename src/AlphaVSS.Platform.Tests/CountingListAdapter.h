@@ -0,0 +1,95 @@
+#pragma once
+
+#include "VssListAdapter.h"
+
+using namespace System;
+using namespace System::Threading;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Tests
+{
+   //
+   // Disposable list element, recording whether it has been disposed.
+   //
+   public ref class TrackedElement sealed : IDisposable
+   {
+   public:
+      TrackedElement(int value)
+         : m_value(value), m_isDisposed(false)
+      {
+      }
+
+      ~TrackedElement()
+      {
+         m_isDisposed = true;
+      }
+
+      property int Value
+      {
+         int get() { return m_value; }
+      }
+
+      property bool IsDisposed
+      {
+         bool get() { return m_isDisposed; }
+      }
+
+   private:
+      int m_value;
+      bool m_isDisposed;
+   };
+
+   //
+   // VssListAdapter over an in-memory collection of the specified size, counting the calls made to GetCount and
+   // GetItem. Stands in for the adapters over VSS collections, where each of these calls is a COM call. Every call
+   // to GetItem returns a new element, as the VSS adapters do.
+   //
+   ref class CountingListAdapter sealed : VssListAdapter<TrackedElement^>
+   {
+   public:
+      CountingListAdapter(int count)
+         : m_count(count), m_countCalls(0), m_itemCalls(0)
+      {
+      }
+
+      property int CountCalls
+      {
+         int get() { return m_countCalls; }
+      }
+
+      property int ItemCalls
+      {
+         int get() { return m_itemCalls; }
+      }
+
+      // Changes the size of the underlying collection.
+      void Resize(int count)
+      {
+         m_count = count;
+      }
+
+      void ResetCalls()
+      {
+         m_countCalls = 0;
+         m_itemCalls = 0;
+      }
+
+   protected:
+      virtual int GetCount() override
+      {
+         Interlocked::Increment(m_countCalls);
+         return m_count;
+      }
+
+      virtual TrackedElement^ GetItem(int index) override
+      {
+         Interlocked::Increment(m_itemCalls);
+         return gcnew TrackedElement(index);
+      }
+
+   private:
+      int m_count;
+      int m_countCalls;
+      int m_itemCalls;
+   };
+}
+} } }
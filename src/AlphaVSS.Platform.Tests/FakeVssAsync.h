@@ -0,0 +1,123 @@
+#pragma once
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Tests
+{
+   //
+   // In-memory IVssAsync, used to test the tracking of asynchronous VSS operations without the VSS service.
+   // The operation stays pending until the tick count (GetTickCount64) passes its deadline, or until it is
+   // cancelled, after which QueryStatus reports the configured result.
+   //
+   // The fake counts the calls made to QueryStatus and tracks its reference count. It is owned by the test
+   // creating it, and is not deleted when its reference count drops to zero.
+   //
+   class FakeVssAsync : public IVssAsync
+   {
+   public:
+      FakeVssAsync()
+         : m_refCount(1), m_deadline(0), m_result(VSS_S_ASYNC_FINISHED), m_cancelled(0), m_throwOnQuery(false), m_queryCalls(0)
+      {
+      }
+
+      virtual ~FakeVssAsync()
+      {
+      }
+
+      // Keeps the operation pending until GetTickCount64 reaches the specified value.
+      void CompleteAt(ULONGLONG deadline, HRESULT hrResult)
+      {
+         m_deadline = deadline;
+         m_result = hrResult;
+      }
+
+      // Makes QueryStatus throw an exception instead of reporting a status, as a broken proxy would.
+      void ThrowOnQuery()
+      {
+         m_throwOnQuery = true;
+      }
+
+      ULONG GetRefCount() const
+      {
+         return static_cast<ULONG>(m_refCount);
+      }
+
+      ULONG GetQueryCallCount() const
+      {
+         return static_cast<ULONG>(m_queryCalls);
+      }
+
+      //
+      // IUnknown
+      //
+      STDMETHOD(QueryInterface)(REFIID riid, void **ppvObject)
+      {
+         if (ppvObject == NULL)
+            return E_POINTER;
+
+         if (riid == IID_IUnknown || riid == __uuidof(IVssAsync))
+         {
+            *ppvObject = static_cast<IVssAsync *>(this);
+            AddRef();
+            return S_OK;
+         }
+
+         *ppvObject = NULL;
+         return E_NOINTERFACE;
+      }
+
+      STDMETHOD_(ULONG, AddRef)()
+      {
+         return static_cast<ULONG>(::InterlockedIncrement(&m_refCount));
+      }
+
+      STDMETHOD_(ULONG, Release)()
+      {
+         return static_cast<ULONG>(::InterlockedDecrement(&m_refCount));
+      }
+
+      //
+      // IVssAsync
+      //
+      STDMETHOD(Cancel)()
+      {
+         ::InterlockedExchange(&m_cancelled, 1);
+         return S_OK;
+      }
+
+      STDMETHOD(Wait)(DWORD dwMilliseconds)
+      {
+         UNREFERENCED_PARAMETER(dwMilliseconds);
+         return E_NOTIMPL;
+      }
+
+      STDMETHOD(QueryStatus)(HRESULT *pHrResult, INT *pReserved)
+      {
+         UNREFERENCED_PARAMETER(pReserved);
+
+         ::InterlockedIncrement(&m_queryCalls);
+
+         if (m_throwOnQuery)
+            throw gcnew System::Runtime::InteropServices::SEHException();
+
+         if (pHrResult == NULL)
+            return E_POINTER;
+
+         if (m_cancelled != 0)
+            *pHrResult = VSS_S_ASYNC_CANCELLED;
+         else if (::GetTickCount64() >= m_deadline)
+            *pHrResult = m_result;
+         else
+            *pHrResult = VSS_S_ASYNC_PENDING;
+
+         return S_OK;
+      }
+
+   private:
+      volatile LONG m_refCount;
+      ULONGLONG m_deadline;
+      HRESULT m_result;
+      volatile LONG m_cancelled;
+      bool m_throwOnQuery;
+      volatile LONG m_queryCalls;
+   };
+}
+} } }
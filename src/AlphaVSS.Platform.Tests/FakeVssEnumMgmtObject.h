@@ -0,0 +1,181 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Tests
+{
+   //
+   // In-memory IVssEnumMgmtObject, used to test the code consuming VSS management object enumerators without
+   // the VSS service. Elements are returned in the order they were added, with their strings allocated by
+   // CoTaskMemAlloc as VSS allocates them.
+   //
+   // The fake counts the calls made to Next and tracks its reference count. It is owned by the test creating
+   // it, and is not deleted when its reference count drops to zero.
+   //
+   class FakeVssEnumMgmtObject : public IVssEnumMgmtObject
+   {
+   public:
+      FakeVssEnumMgmtObject()
+         : m_refCount(1), m_position(0), m_nextCalls(0), m_failingCall(0), m_failure(S_OK)
+      {
+      }
+
+      virtual ~FakeVssEnumMgmtObject()
+      {
+      }
+
+      void AddVolume(const wchar_t *volumeName, const wchar_t *volumeDisplayName)
+      {
+         Element element = { VSS_MGMT_OBJECT_VOLUME, volumeName, volumeDisplayName, 0, 0, 0 };
+         m_elements.push_back(element);
+      }
+
+      void AddDiffVolume(const wchar_t *volumeName, const wchar_t *volumeDisplayName, LONGLONG volumeFreeSpace, LONGLONG volumeTotalSpace)
+      {
+         Element element = { VSS_MGMT_OBJECT_DIFF_VOLUME, volumeName, volumeDisplayName, volumeFreeSpace, volumeTotalSpace, 0 };
+         m_elements.push_back(element);
+      }
+
+      void AddDiffArea(const wchar_t *volumeName, const wchar_t *diffAreaVolumeName, LONGLONG maximumDiffSpace, LONGLONG allocatedDiffSpace, LONGLONG usedDiffSpace)
+      {
+         Element element = { VSS_MGMT_OBJECT_DIFF_AREA, volumeName, diffAreaVolumeName, maximumDiffSpace, allocatedDiffSpace, usedDiffSpace };
+         m_elements.push_back(element);
+      }
+
+      // Makes the specified call to Next (1 being the first call) fail with the specified error code.
+      void FailNextCall(ULONG call, HRESULT hr)
+      {
+         m_failingCall = call;
+         m_failure = hr;
+      }
+
+      ULONG GetRefCount() const
+      {
+         return m_refCount;
+      }
+
+      ULONG GetNextCallCount() const
+      {
+         return m_nextCalls;
+      }
+
+      //
+      // IUnknown
+      //
+      STDMETHOD(QueryInterface)(REFIID riid, void **ppvObject)
+      {
+         if (ppvObject == NULL)
+            return E_POINTER;
+
+         if (riid == IID_IUnknown || riid == __uuidof(IVssEnumMgmtObject))
+         {
+            *ppvObject = static_cast<IVssEnumMgmtObject *>(this);
+            AddRef();
+            return S_OK;
+         }
+
+         *ppvObject = NULL;
+         return E_NOINTERFACE;
+      }
+
+      STDMETHOD_(ULONG, AddRef)()
+      {
+         return ++m_refCount;
+      }
+
+      STDMETHOD_(ULONG, Release)()
+      {
+         return --m_refCount;
+      }
+
+      //
+      // IVssEnumMgmtObject
+      //
+      STDMETHOD(Next)(ULONG celt, VSS_MGMT_OBJECT_PROP *rgelt, ULONG *pceltFetched)
+      {
+         if (++m_nextCalls == m_failingCall)
+            return m_failure;
+
+         if (rgelt == NULL || pceltFetched == NULL)
+            return E_POINTER;
+
+         ULONG fetched = 0;
+         while (fetched < celt && m_position < m_elements.size())
+            ToProperties(m_elements[m_position++], rgelt[fetched++]);
+
+         *pceltFetched = fetched;
+         return fetched == celt ? S_OK : S_FALSE;
+      }
+
+      STDMETHOD(Skip)(ULONG celt)
+      {
+         m_position = (m_elements.size() - m_position > celt) ? m_position + celt : m_elements.size();
+         return m_position < m_elements.size() ? S_OK : S_FALSE;
+      }
+
+      STDMETHOD(Reset)()
+      {
+         m_position = 0;
+         return S_OK;
+      }
+
+      STDMETHOD(Clone)(IVssEnumMgmtObject **ppenum)
+      {
+         UNREFERENCED_PARAMETER(ppenum);
+         return E_NOTIMPL;
+      }
+
+   private:
+      struct Element
+      {
+         VSS_MGMT_OBJECT_TYPE Type;
+         std::wstring FirstName;
+         std::wstring SecondName;
+         LONGLONG FirstValue;
+         LONGLONG SecondValue;
+         LONGLONG ThirdValue;
+      };
+
+      static VSS_PWSZ Duplicate(const std::wstring &value)
+      {
+         size_t size = (value.size() + 1) * sizeof(wchar_t);
+         VSS_PWSZ copy = static_cast<VSS_PWSZ>(::CoTaskMemAlloc(size));
+         memcpy(copy, value.c_str(), size);
+         return copy;
+      }
+
+      static void ToProperties(const Element &element, VSS_MGMT_OBJECT_PROP &prop)
+      {
+         prop.Type = element.Type;
+         switch (element.Type)
+         {
+         case VSS_MGMT_OBJECT_VOLUME:
+            prop.Obj.Vol.m_pwszVolumeName = Duplicate(element.FirstName);
+            prop.Obj.Vol.m_pwszVolumeDisplayName = Duplicate(element.SecondName);
+            break;
+         case VSS_MGMT_OBJECT_DIFF_VOLUME:
+            prop.Obj.DiffVol.m_pwszVolumeName = Duplicate(element.FirstName);
+            prop.Obj.DiffVol.m_pwszVolumeDisplayName = Duplicate(element.SecondName);
+            prop.Obj.DiffVol.m_llVolumeFreeSpace = element.FirstValue;
+            prop.Obj.DiffVol.m_llVolumeTotalSpace = element.SecondValue;
+            break;
+         case VSS_MGMT_OBJECT_DIFF_AREA:
+            prop.Obj.DiffArea.m_pwszVolumeName = Duplicate(element.FirstName);
+            prop.Obj.DiffArea.m_pwszDiffAreaVolumeName = Duplicate(element.SecondName);
+            prop.Obj.DiffArea.m_llMaximumDiffSpace = element.FirstValue;
+            prop.Obj.DiffArea.m_llAllocatedDiffSpace = element.SecondValue;
+            prop.Obj.DiffArea.m_llUsedDiffSpace = element.ThirdValue;
+            break;
+         }
+      }
+
+      std::vector<Element> m_elements;
+      ULONG m_refCount;
+      size_t m_position;
+      ULONG m_nextCalls;
+      ULONG m_failingCall;
+      HRESULT m_failure;
+   };
+}
+} } }
@@ -0,0 +1,372 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Tests
+{
+   //
+   // In-memory implementations of the native writer metadata interfaces, used to test the code capturing
+   // Writer Metadata Documents without the VSS service. Strings are returned as newly allocated BSTRs, as
+   // VSS returns them.
+   //
+   // Like FakeVssEnumMgmtObject, each fake tracks its reference count and is not deleted when the count drops
+   // to zero; a fake is owned by the test or by the fake that created it.
+   //
+   template <typename TInterface>
+   class FakeUnknown : public TInterface
+   {
+   public:
+      FakeUnknown()
+         : m_refCount(1)
+      {
+      }
+
+      virtual ~FakeUnknown()
+      {
+      }
+
+      ULONG GetRefCount() const
+      {
+         return m_refCount;
+      }
+
+      STDMETHOD(QueryInterface)(REFIID riid, void **ppvObject)
+      {
+         if (ppvObject == NULL)
+            return E_POINTER;
+
+         if (riid == IID_IUnknown)
+         {
+            *ppvObject = static_cast<IUnknown *>(this);
+            AddRef();
+            return S_OK;
+         }
+
+         *ppvObject = NULL;
+         return E_NOINTERFACE;
+      }
+
+      STDMETHOD_(ULONG, AddRef)()
+      {
+         return ++m_refCount;
+      }
+
+      STDMETHOD_(ULONG, Release)()
+      {
+         return --m_refCount;
+      }
+
+   protected:
+      static HRESULT Copy(const std::wstring &value, BSTR *pbstr)
+      {
+         if (pbstr == NULL)
+            return E_POINTER;
+
+         *pbstr = ::SysAllocStringLen(value.c_str(), (UINT)value.size());
+         return *pbstr == NULL ? E_OUTOFMEMORY : S_OK;
+      }
+
+      template <typename TElement, typename TResult>
+      static HRESULT Get(const std::vector<std::unique_ptr<TElement> > &elements, UINT index, TResult **ppResult)
+      {
+         if (ppResult == NULL)
+            return E_POINTER;
+
+         if (index >= elements.size())
+            return E_INVALIDARG;
+
+         *ppResult = elements[index].get();
+         (*ppResult)->AddRef();
+         return S_OK;
+      }
+
+   private:
+      ULONG m_refCount;
+   };
+
+   class FakeVssWMFiledesc : public FakeUnknown<IVssWMFiledesc>
+   {
+   public:
+      FakeVssWMFiledesc(const wchar_t *path, const wchar_t *filespec, bool recursive, const wchar_t *alternateLocation, DWORD typeMask)
+         : m_path(path), m_filespec(filespec), m_recursive(recursive), m_alternateLocation(alternateLocation), m_typeMask(typeMask)
+      {
+      }
+
+      STDMETHOD(GetPath)(BSTR *pbstrPath) { return Copy(m_path, pbstrPath); }
+      STDMETHOD(GetFilespec)(BSTR *pbstrFilespec) { return Copy(m_filespec, pbstrFilespec); }
+      STDMETHOD(GetAlternateLocation)(BSTR *pbstrAlternateLocation) { return Copy(m_alternateLocation, pbstrAlternateLocation); }
+
+      STDMETHOD(GetRecursive)(bool *pbRecursive)
+      {
+         *pbRecursive = m_recursive;
+         return S_OK;
+      }
+
+      STDMETHOD(GetBackupTypeMask)(DWORD *pdwTypeMask)
+      {
+         *pdwTypeMask = m_typeMask;
+         return S_OK;
+      }
+
+   private:
+      std::wstring m_path;
+      std::wstring m_filespec;
+      bool m_recursive;
+      std::wstring m_alternateLocation;
+      DWORD m_typeMask;
+   };
+
+   class FakeVssWMDependency : public FakeUnknown<IVssWMDependency>
+   {
+   public:
+      FakeVssWMDependency(const VSS_ID &writerId, const wchar_t *logicalPath, const wchar_t *componentName)
+         : m_writerId(writerId), m_logicalPath(logicalPath), m_componentName(componentName)
+      {
+      }
+
+      STDMETHOD(GetWriterId)(VSS_ID *pWriterId)
+      {
+         *pWriterId = m_writerId;
+         return S_OK;
+      }
+
+      STDMETHOD(GetLogicalPath)(BSTR *pbstrLogicalPath) { return Copy(m_logicalPath, pbstrLogicalPath); }
+      STDMETHOD(GetComponentName)(BSTR *pbstrComponentName) { return Copy(m_componentName, pbstrComponentName); }
+
+   private:
+      VSS_ID m_writerId;
+      std::wstring m_logicalPath;
+      std::wstring m_componentName;
+   };
+
+   class FakeVssWMComponent : public FakeUnknown<IVssWMComponent>
+   {
+   public:
+      FakeVssWMComponent(VSS_COMPONENT_TYPE type, const wchar_t *logicalPath, const wchar_t *componentName, const wchar_t *caption)
+         : m_type(type), m_logicalPath(logicalPath), m_componentName(componentName), m_caption(caption), m_outstandingInfos(0), m_failure(S_OK)
+      {
+      }
+
+      FakeVssWMFiledesc &AddFile(const wchar_t *path, const wchar_t *filespec, bool recursive)
+      {
+         m_files.push_back(std::unique_ptr<FakeVssWMFiledesc>(new FakeVssWMFiledesc(path, filespec, recursive, L"", VSS_FSBT_ALL_BACKUP_REQUIRED)));
+         return *m_files.back();
+      }
+
+      FakeVssWMFiledesc &AddDatabaseFile(const wchar_t *path, const wchar_t *filespec)
+      {
+         m_databaseFiles.push_back(std::unique_ptr<FakeVssWMFiledesc>(new FakeVssWMFiledesc(path, filespec, false, L"", VSS_FSBT_ALL_BACKUP_REQUIRED)));
+         return *m_databaseFiles.back();
+      }
+
+      FakeVssWMFiledesc &AddDatabaseLogFile(const wchar_t *path, const wchar_t *filespec)
+      {
+         m_databaseLogFiles.push_back(std::unique_ptr<FakeVssWMFiledesc>(new FakeVssWMFiledesc(path, filespec, false, L"", VSS_FSBT_ALL_BACKUP_REQUIRED)));
+         return *m_databaseLogFiles.back();
+      }
+
+      FakeVssWMDependency &AddDependency(const VSS_ID &writerId, const wchar_t *logicalPath, const wchar_t *componentName)
+      {
+         m_dependencies.push_back(std::unique_ptr<FakeVssWMDependency>(new FakeVssWMDependency(writerId, logicalPath, componentName)));
+         return *m_dependencies.back();
+      }
+
+      // Makes GetFile fail with the specified error code.
+      void FailGetFile(HRESULT hr)
+      {
+         m_failure = hr;
+      }
+
+      // The number of component infos returned by GetComponentInfo that have not been freed.
+      int GetOutstandingInfoCount() const
+      {
+         return m_outstandingInfos;
+      }
+
+      const std::vector<std::unique_ptr<FakeVssWMFiledesc> > &GetFiles() const
+      {
+         return m_files;
+      }
+
+      const std::vector<std::unique_ptr<FakeVssWMDependency> > &GetDependencies() const
+      {
+         return m_dependencies;
+      }
+
+      STDMETHOD(GetComponentInfo)(PVSSCOMPONENTINFO *ppInfo)
+      {
+         if (ppInfo == NULL)
+            return E_POINTER;
+
+         VSS_COMPONENTINFO *info = new VSS_COMPONENTINFO();
+         info->type = m_type;
+         info->bstrLogicalPath = ::SysAllocString(m_logicalPath.c_str());
+         info->bstrComponentName = ::SysAllocString(m_componentName.c_str());
+         info->bstrCaption = ::SysAllocString(m_caption.c_str());
+         info->bSelectable = true;
+         info->cFileCount = (UINT)m_files.size();
+         info->cDatabases = (UINT)m_databaseFiles.size();
+         info->cLogFiles = (UINT)m_databaseLogFiles.size();
+         info->cDependencies = (UINT)m_dependencies.size();
+
+         m_outstandingInfos++;
+         *ppInfo = info;
+         return S_OK;
+      }
+
+      STDMETHOD(FreeComponentInfo)(PVSSCOMPONENTINFO pInfo)
+      {
+         VSS_COMPONENTINFO *info = const_cast<VSS_COMPONENTINFO *>(pInfo);
+         ::SysFreeString(info->bstrLogicalPath);
+         ::SysFreeString(info->bstrComponentName);
+         ::SysFreeString(info->bstrCaption);
+         delete info;
+
+         m_outstandingInfos--;
+         return S_OK;
+      }
+
+      STDMETHOD(GetFile)(UINT iFile, IVssWMFiledesc **ppFiledesc)
+      {
+         return FAILED(m_failure) ? m_failure : Get(m_files, iFile, ppFiledesc);
+      }
+
+      STDMETHOD(GetDatabaseFile)(UINT iDBFile, IVssWMFiledesc **ppFiledesc) { return Get(m_databaseFiles, iDBFile, ppFiledesc); }
+      STDMETHOD(GetDatabaseLogFile)(UINT iDbLogFile, IVssWMFiledesc **ppFiledesc) { return Get(m_databaseLogFiles, iDbLogFile, ppFiledesc); }
+      STDMETHOD(GetDependency)(UINT iDependency, IVssWMDependency **ppDependency) { return Get(m_dependencies, iDependency, ppDependency); }
+
+   private:
+      VSS_COMPONENT_TYPE m_type;
+      std::wstring m_logicalPath;
+      std::wstring m_componentName;
+      std::wstring m_caption;
+      std::vector<std::unique_ptr<FakeVssWMFiledesc> > m_files;
+      std::vector<std::unique_ptr<FakeVssWMFiledesc> > m_databaseFiles;
+      std::vector<std::unique_ptr<FakeVssWMFiledesc> > m_databaseLogFiles;
+      std::vector<std::unique_ptr<FakeVssWMDependency> > m_dependencies;
+      int m_outstandingInfos;
+      HRESULT m_failure;
+   };
+
+   //
+   // Implements only IVssExamineWriterMetadata, like the writer metadata of Windows versions before Vista; the
+   // extended interfaces are not available through QueryInterface.
+   //
+   class FakeVssExamineWriterMetadata : public FakeUnknown<IVssExamineWriterMetadata>
+   {
+   public:
+      FakeVssExamineWriterMetadata(const VSS_ID &instanceId, const VSS_ID &writerId, const wchar_t *writerName)
+         : m_instanceId(instanceId), m_writerId(writerId), m_writerName(writerName), m_hasRestoreMethod(false),
+           m_xml(L"<WRITER_METADATA/>")
+      {
+      }
+
+      void SetRestoreMethod(VSS_RESTOREMETHOD_ENUM method, const wchar_t *service)
+      {
+         m_hasRestoreMethod = true;
+         m_restoreMethod = method;
+         m_service = service;
+      }
+
+      FakeVssWMFiledesc &AddExcludeFile(const wchar_t *path, const wchar_t *filespec, bool recursive)
+      {
+         m_excludeFiles.push_back(std::unique_ptr<FakeVssWMFiledesc>(new FakeVssWMFiledesc(path, filespec, recursive, L"", 0)));
+         return *m_excludeFiles.back();
+      }
+
+      FakeVssWMFiledesc &AddAlternateLocationMapping(const wchar_t *path, const wchar_t *filespec, const wchar_t *alternateLocation)
+      {
+         m_mappings.push_back(std::unique_ptr<FakeVssWMFiledesc>(new FakeVssWMFiledesc(path, filespec, false, alternateLocation, 0)));
+         return *m_mappings.back();
+      }
+
+      FakeVssWMComponent &AddComponent(VSS_COMPONENT_TYPE type, const wchar_t *logicalPath, const wchar_t *componentName)
+      {
+         m_components.push_back(std::unique_ptr<FakeVssWMComponent>(new FakeVssWMComponent(type, logicalPath, componentName, componentName)));
+         return *m_components.back();
+      }
+
+      const std::vector<std::unique_ptr<FakeVssWMComponent> > &GetComponents() const
+      {
+         return m_components;
+      }
+
+      STDMETHOD(GetIdentity)(VSS_ID *pidInstance, VSS_ID *pidWriter, BSTR *pbstrWriterName, VSS_USAGE_TYPE *pUsage, VSS_SOURCE_TYPE *pSource)
+      {
+         *pidInstance = m_instanceId;
+         *pidWriter = m_writerId;
+         *pUsage = VSS_UT_USERDATA;
+         *pSource = VSS_ST_OTHER;
+         return Copy(m_writerName, pbstrWriterName);
+      }
+
+      STDMETHOD(GetFileCounts)(UINT *pcIncludeFiles, UINT *pcExcludeFiles, UINT *pcComponents)
+      {
+         *pcIncludeFiles = 0;
+         *pcExcludeFiles = (UINT)m_excludeFiles.size();
+         *pcComponents = (UINT)m_components.size();
+         return S_OK;
+      }
+
+      STDMETHOD(GetIncludeFile)(UINT iFile, IVssWMFiledesc **ppFiledesc)
+      {
+         UNREFERENCED_PARAMETER(iFile);
+         UNREFERENCED_PARAMETER(ppFiledesc);
+         return E_NOTIMPL;
+      }
+
+      STDMETHOD(GetExcludeFile)(UINT iFile, IVssWMFiledesc **ppFiledesc) { return Get(m_excludeFiles, iFile, ppFiledesc); }
+      STDMETHOD(GetComponent)(UINT iComponent, IVssWMComponent **ppComponent) { return Get(m_components, iComponent, ppComponent); }
+
+      STDMETHOD(GetRestoreMethod)(VSS_RESTOREMETHOD_ENUM *pMethod, BSTR *pbstrService, BSTR *pbstrUserProcedure, VSS_WRITERRESTORE_ENUM *pwriterRestore, bool *pbRebootRequired, UINT *pcMappings)
+      {
+         // VSS reports a writer without a restore method with S_FALSE.
+         if (!m_hasRestoreMethod)
+            return S_FALSE;
+
+         *pMethod = m_restoreMethod;
+         *pwriterRestore = VSS_WRE_ALWAYS;
+         *pbRebootRequired = false;
+         *pcMappings = (UINT)m_mappings.size();
+         *pbstrUserProcedure = NULL;
+         return Copy(m_service, pbstrService);
+      }
+
+      STDMETHOD(GetAlternateLocationMapping)(UINT iMapping, IVssWMFiledesc **ppFiledesc) { return Get(m_mappings, iMapping, ppFiledesc); }
+
+      STDMETHOD(GetBackupSchema)(DWORD *pdwSchemaMask)
+      {
+         *pdwSchemaMask = VSS_BS_DIFFERENTIAL | VSS_BS_INCREMENTAL;
+         return S_OK;
+      }
+
+      STDMETHOD(GetDocument)(IXMLDOMDocument **pDoc)
+      {
+         UNREFERENCED_PARAMETER(pDoc);
+         return E_NOTIMPL;
+      }
+
+      STDMETHOD(SaveAsXML)(BSTR *pbstrXML) { return Copy(m_xml, pbstrXML); }
+
+      STDMETHOD(LoadFromXML)(BSTR bstrXML)
+      {
+         UNREFERENCED_PARAMETER(bstrXML);
+         return E_NOTIMPL;
+      }
+
+   private:
+      VSS_ID m_instanceId;
+      VSS_ID m_writerId;
+      std::wstring m_writerName;
+      bool m_hasRestoreMethod;
+      VSS_RESTOREMETHOD_ENUM m_restoreMethod;
+      std::wstring m_service;
+      std::wstring m_xml;
+      std::vector<std::unique_ptr<FakeVssWMFiledesc> > m_excludeFiles;
+      std::vector<std::unique_ptr<FakeVssWMFiledesc> > m_mappings;
+      std::vector<std::unique_ptr<FakeVssWMComponent> > m_components;
+   };
+}
+} } }
@@ -0,0 +1,81 @@
+#include "pch.h"
+
+using namespace System;
+using namespace Microsoft::VisualStudio::TestTools::UnitTesting;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Tests
+{
+   // {12345678-9abc-def0-1122-334455667788}
+   static const VSS_ID s_id = { 0x12345678, 0x9abc, 0xdef0, { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 } };
+
+   [TestClass]
+   public ref class UtilsTests
+   {
+   public:
+      [TestMethod]
+      void ToVssId_ConvertsEveryField()
+      {
+         VSS_ID id = ToVssId(Guid(L"12345678-9abc-def0-1122-334455667788"));
+
+         Assert::IsTrue(IsEqualGUID(s_id, id) != FALSE);
+      }
+
+      [TestMethod]
+      void ToGuid_IsInverseOfToVssId()
+      {
+         Guid guid = Guid::NewGuid();
+
+         Assert::AreEqual<Guid>(guid, ToGuid(ToVssId(guid)));
+         Assert::AreEqual<Guid>(Guid(L"12345678-9abc-def0-1122-334455667788"), ToGuid(s_id));
+      }
+
+      [TestMethod]
+      void ToVssId_DoesNotAllocate()
+      {
+         // Guid::ToByteArray would allocate 40 bytes per call; the bound leaves room for allocations made by other
+         // threads while the conversions run.
+         const int Iterations = 100000;
+         Guid guid = Guid::NewGuid();
+         AppDomain::MonitoringIsEnabled = true;
+
+         Int64 allocatedBefore = AppDomain::CurrentDomain->MonitoringTotalAllocatedMemorySize;
+         ULONG sum = 0;
+         for (int i = 0; i < Iterations; i++)
+            sum += ToVssId(guid).Data1;
+         Int64 allocated = AppDomain::CurrentDomain->MonitoringTotalAllocatedMemorySize - allocatedBefore;
+
+         Assert::AreEqual<ULONG>((ULONG)Iterations * ToVssId(guid).Data1, sum);
+         Assert::IsTrue(allocated < Iterations, String::Format(L"{0} bytes allocated by {1} conversions.", allocated, Iterations));
+      }
+
+      [TestMethod]
+      void VssIds_ConvertsInlineAndNativeArrays()
+      {
+         for each (int count in gcnew array<int> { 0, 1, VssIds::InlineCapacity, VssIds::InlineCapacity + 1, 100 })
+         {
+            array<Guid>^ guids = gcnew array<Guid>(count);
+            for (int i = 0; i < count; i++)
+               guids[i] = Guid::NewGuid();
+
+            VssIds ids(guids);
+            VSS_ID *converted = ids;
+            for (int i = 0; i < count; i++)
+               Assert::AreEqual<Guid>(guids[i], ToGuid(converted[i]));
+         }
+      }
+
+      [TestMethod]
+      void VssIds_Null_Throws()
+      {
+         try
+         {
+            VssIds ids(nullptr);
+            Assert::Fail(L"Expected ArgumentNullException.");
+         }
+         catch (ArgumentNullException^)
+         {
+         }
+      }
+   };
+}
+} } }
@@ -0,0 +1,182 @@
+#include "pch.h"
+
+#include "VssAsyncCompletionService.h"
+#include "FakeVssAsync.h"
+
+using namespace System;
+using namespace System::Diagnostics;
+using namespace System::Threading;
+using namespace Microsoft::VisualStudio::TestTools::UnitTesting;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Tests
+{
+   [TestClass]
+   public ref class VssAsyncCompletionServiceTests
+   {
+   public:
+      [TestMethod]
+      void Register_CompletesWithFinalStatusAndReleasesOperation()
+      {
+         FakeVssAsync fake;
+         fake.CompleteAt(::GetTickCount64() + 50, VSS_S_ASYNC_FINISHED);
+
+         CompletionRecorder^ recorder = gcnew CompletionRecorder(1);
+         Register(&fake, recorder, 0);
+
+         Assert::IsTrue(recorder->Wait(10000));
+         Assert::AreEqual<int>(VSS_S_ASYNC_FINISHED, recorder->Results[0]);
+         Assert::AreEqual<int>(0, (int)fake.GetRefCount());
+      }
+
+      [TestMethod]
+      void Register_FailedOperation_CompletesWithError()
+      {
+         FakeVssAsync fake;
+         fake.CompleteAt(0, VSS_E_SNAPSHOT_SET_IN_PROGRESS);
+
+         CompletionRecorder^ recorder = gcnew CompletionRecorder(1);
+         Register(&fake, recorder, 0);
+
+         Assert::IsTrue(recorder->Wait(10000));
+         Assert::AreEqual<int>(VSS_E_SNAPSHOT_SET_IN_PROGRESS, recorder->Results[0]);
+      }
+
+      [TestMethod]
+      void Cancel_CompletesOperationAsCancelled()
+      {
+         FakeVssAsync fake;
+         fake.CompleteAt(::GetTickCount64() + 600000, VSS_S_ASYNC_FINISHED);
+
+         CompletionRecorder^ recorder = gcnew CompletionRecorder(1);
+         VssAsyncOperation^ operation = Register(&fake, recorder, 0);
+         operation->Cancel();
+
+         Assert::IsTrue(recorder->Wait(10000));
+         Assert::AreEqual<int>(VSS_S_ASYNC_CANCELLED, recorder->Results[0]);
+         Assert::AreEqual<int>(0, (int)fake.GetRefCount());
+      }
+
+      [TestMethod]
+      void Poll_Throws_FailsOperationAndKeepsServiceRunning()
+      {
+         FakeVssAsync broken;
+         broken.ThrowOnQuery();
+
+         CompletionRecorder^ failed = gcnew CompletionRecorder(1);
+         Register(&broken, failed, 0);
+
+         Assert::IsTrue(failed->Wait(10000));
+         Assert::IsTrue(FAILED(failed->Results[0]));
+         Assert::AreEqual<int>(0, (int)broken.GetRefCount());
+
+         FakeVssAsync healthy;
+         healthy.CompleteAt(::GetTickCount64() + 50, VSS_S_ASYNC_FINISHED);
+
+         CompletionRecorder^ completed = gcnew CompletionRecorder(1);
+         Register(&healthy, completed, 0);
+
+         Assert::IsTrue(completed->Wait(10000));
+         Assert::AreEqual<int>(VSS_S_ASYNC_FINISHED, completed->Results[0]);
+      }
+
+      //
+      // Stress benchmark: 1,000 concurrent operations completing at staggered times over two seconds, which
+      // would occupy 1,000 thread-pool threads if each were waited for by IVssAsync::Wait. Reports how late
+      // completions are observed and how many QueryStatus calls the polling costs.
+      //
+      [TestMethod, TestCategory("Benchmark")]
+      void Register_ThousandConcurrentOperations_CompleteWithBoundedLatency()
+      {
+         const int count = 1000;
+
+         FakeVssAsync *fakes = new FakeVssAsync[count];
+         try
+         {
+            CompletionRecorder^ recorder = gcnew CompletionRecorder(count);
+            array<UInt64>^ deadlines = gcnew array<UInt64>(count);
+            Stopwatch^ stopwatch = Stopwatch::StartNew();
+
+            ULONGLONG start = ::GetTickCount64();
+            for (int i = 0; i < count; i++)
+            {
+               deadlines[i] = start + (i % 200) * 10;
+               fakes[i].CompleteAt(deadlines[i], VSS_S_ASYNC_FINISHED);
+               Register(&fakes[i], recorder, i);
+            }
+
+            Assert::IsTrue(recorder->Wait(30000), L"Not all operations completed.");
+            stopwatch->Stop();
+
+            Int64 totalLatency = 0;
+            Int64 maxLatency = 0;
+            Int64 queryCalls = 0;
+            for (int i = 0; i < count; i++)
+            {
+               Assert::AreEqual<int>(VSS_S_ASYNC_FINISHED, recorder->Results[i]);
+               Assert::AreEqual<int>(0, (int)fakes[i].GetRefCount());
+
+               Int64 latency = (Int64)(recorder->CompletedAt[i] - deadlines[i]);
+               totalLatency += latency;
+               maxLatency = Math::Max(maxLatency, latency);
+               queryCalls += fakes[i].GetQueryCallCount();
+            }
+
+            Int64 averageLatency = totalLatency / count;
+            Console::WriteLine(L"{0} operations completed in {1} ms; completion latency avg {2} ms, max {3} ms; {4} QueryStatus calls.",
+               count, stopwatch->ElapsedMilliseconds, averageLatency, maxLatency, queryCalls);
+
+            // Completions are observed within one poll interval, give or take the tick count resolution.
+            Assert::IsTrue(averageLatency <= 2 * VssAsyncCompletionService::MaxPollInterval,
+               String::Format(L"Average completion latency of {0} ms.", averageLatency));
+         }
+         finally
+         {
+            delete[] fakes;
+         }
+      }
+
+   private:
+      ref class CompletionRecorder sealed
+      {
+      public:
+         CompletionRecorder(int count)
+            : m_results(gcnew array<int>(count)), m_completedAt(gcnew array<UInt64>(count)), m_remaining(gcnew CountdownEvent(count))
+         {
+         }
+
+         property array<int>^ Results
+         {
+            array<int>^ get() { return m_results; }
+         }
+
+         property array<UInt64>^ CompletedAt
+         {
+            array<UInt64>^ get() { return m_completedAt; }
+         }
+
+         bool Wait(int millisecondsTimeout)
+         {
+            return m_remaining->Wait(millisecondsTimeout);
+         }
+
+         void OnCompleted(HRESULT hrResult, Object^ state)
+         {
+            int index = safe_cast<int>(state);
+            m_completedAt[index] = ::GetTickCount64();
+            m_results[index] = hrResult;
+            m_remaining->Signal();
+         }
+
+      private:
+         array<int>^ m_results;
+         array<UInt64>^ m_completedAt;
+         CountdownEvent^ m_remaining;
+      };
+
+      static VssAsyncOperation^ Register(FakeVssAsync *fake, CompletionRecorder^ recorder, int index)
+      {
+         return VssAsyncCompletionService::Register(fake, gcnew VssAsyncCompletedCallback(recorder, &CompletionRecorder::OnCompleted), index, nullptr);
+      }
+   };
+}
+} } }
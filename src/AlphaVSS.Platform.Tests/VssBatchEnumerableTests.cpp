@@ -0,0 +1,238 @@
+#include "pch.h"
+
+#include "VssBatchEnumerable.h"
+#include "VssMgmtObjectTraits.h"
+#include "FakeVssEnumMgmtObject.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace Microsoft::VisualStudio::TestTools::UnitTesting;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Tests
+{
+   typedef VssBatchEnumerable<IVssEnumMgmtObject, VSS_MGMT_OBJECT_PROP, VssDiffAreaProperties,
+      MgmtObjectTraits<VssDiffAreaProperties, VSS_MGMT_OBJECT_DIFF_AREA> > DiffAreaEnumerable;
+
+   [TestClass]
+   public ref class VssBatchEnumerableTests
+   {
+   public:
+      [TestMethod]
+      void Enumerate_FetchesElementsInBatches()
+      {
+         FakeVssEnumMgmtObject fake;
+         AddDiffAreas(fake, 10);
+
+         DiffAreaEnumerable^ enumerable = gcnew DiffAreaEnumerable(&fake, 4);
+         try
+         {
+            List<VssDiffAreaProperties^>^ result = gcnew List<VssDiffAreaProperties^>(enumerable);
+
+            Assert::AreEqual<int>(10, result->Count);
+            Assert::AreEqual<int>(3, (int)fake.GetNextCallCount());
+            for (int i = 0; i < result->Count; i++)
+            {
+               Assert::AreEqual<String^>(String::Format(L"\\\\?\\Volume{{{0}}}\\", i), result[i]->VolumeName);
+               Assert::AreEqual<String^>(L"\\\\?\\Volume{diff}\\", result[i]->DiffAreaVolumeName);
+               Assert::AreEqual<Int64>(i * 1000, result[i]->MaximumDiffSpace);
+               Assert::AreEqual<Int64>(i * 100, result[i]->AllocatedDiffSpace);
+               Assert::AreEqual<Int64>(i * 10, result[i]->UsedDiffSpace);
+            }
+         }
+         finally
+         {
+            delete enumerable;
+         }
+      }
+
+      [TestMethod]
+      void Enumerate_FullBatches_StopsAtShortBatch()
+      {
+         FakeVssEnumMgmtObject fake;
+         AddDiffAreas(fake, 8);
+
+         DiffAreaEnumerable^ enumerable = gcnew DiffAreaEnumerable(&fake, 4);
+         try
+         {
+            Assert::AreEqual<int>(8, (gcnew List<VssDiffAreaProperties^>(enumerable))->Count);
+            Assert::AreEqual<int>(3, (int)fake.GetNextCallCount());
+         }
+         finally
+         {
+            delete enumerable;
+         }
+      }
+
+      [TestMethod]
+      void Enumerate_ReleasesEnumeratorWhenEnumerationCompletes()
+      {
+         FakeVssEnumMgmtObject fake;
+         AddDiffAreas(fake, 5);
+
+         DiffAreaEnumerable^ enumerable = gcnew DiffAreaEnumerable(&fake, 2);
+         IEnumerator<VssDiffAreaProperties^>^ enumerator = enumerable->GetEnumerator();
+         try
+         {
+            int count = 0;
+            while (enumerator->MoveNext())
+               count++;
+
+            // Neither the enumerator nor the sequence has been disposed yet.
+            Assert::AreEqual<int>(5, count);
+            Assert::AreEqual<int>(0, (int)fake.GetRefCount());
+         }
+         finally
+         {
+            delete enumerator;
+            delete enumerable;
+         }
+
+         Assert::AreEqual<int>(0, (int)fake.GetRefCount());
+      }
+
+      [TestMethod]
+      void Dispose_PartiallyEnumerated_ReleasesEnumerator()
+      {
+         FakeVssEnumMgmtObject fake;
+         AddDiffAreas(fake, 10);
+
+         DiffAreaEnumerable^ enumerable = gcnew DiffAreaEnumerable(&fake, 4);
+         try
+         {
+            IEnumerator<VssDiffAreaProperties^>^ enumerator = enumerable->GetEnumerator();
+            Assert::IsTrue(enumerator->MoveNext());
+            Assert::AreEqual<int>(1, (int)fake.GetRefCount());
+
+            delete enumerator;
+            Assert::AreEqual<int>(0, (int)fake.GetRefCount());
+         }
+         finally
+         {
+            delete enumerable;
+         }
+      }
+
+      [TestMethod]
+      void GetEnumerator_CalledTwice_Throws()
+      {
+         FakeVssEnumMgmtObject fake;
+         AddDiffAreas(fake, 3);
+
+         DiffAreaEnumerable^ enumerable = gcnew DiffAreaEnumerable(&fake, 4);
+         try
+         {
+            Assert::AreEqual<int>(3, (gcnew List<VssDiffAreaProperties^>(enumerable))->Count);
+
+            try
+            {
+               enumerable->GetEnumerator();
+               Assert::Fail(L"Expected InvalidOperationException.");
+            }
+            catch (InvalidOperationException^)
+            {
+            }
+         }
+         finally
+         {
+            delete enumerable;
+         }
+      }
+
+      [TestMethod]
+      void Enumerate_UnexpectedObjectType_Throws()
+      {
+         FakeVssEnumMgmtObject fake;
+         AddDiffAreas(fake, 1);
+         fake.AddVolume(L"\\\\?\\Volume{1}\\", L"C:\\");
+         AddDiffAreas(fake, 1);
+
+         DiffAreaEnumerable^ enumerable = gcnew DiffAreaEnumerable(&fake, 4);
+         try
+         {
+            IEnumerator<VssDiffAreaProperties^>^ enumerator = enumerable->GetEnumerator();
+            try
+            {
+               Assert::IsTrue(enumerator->MoveNext());
+               enumerator->MoveNext();
+               Assert::Fail(L"Expected InvalidOperationException.");
+            }
+            catch (InvalidOperationException^)
+            {
+            }
+            finally
+            {
+               delete enumerator;
+            }
+
+            Assert::AreEqual<int>(0, (int)fake.GetRefCount());
+         }
+         finally
+         {
+            delete enumerable;
+         }
+      }
+
+      [TestMethod]
+      void Enumerate_NextFails_ThrowsMappedException()
+      {
+         FakeVssEnumMgmtObject fake;
+         AddDiffAreas(fake, 10);
+         fake.FailNextCall(2, E_ACCESSDENIED);
+
+         DiffAreaEnumerable^ enumerable = gcnew DiffAreaEnumerable(&fake, 4);
+         try
+         {
+            IEnumerator<VssDiffAreaProperties^>^ enumerator = enumerable->GetEnumerator();
+            try
+            {
+               for (int i = 0; i < 4; i++)
+                  Assert::IsTrue(enumerator->MoveNext());
+
+               enumerator->MoveNext();
+               Assert::Fail(L"Expected UnauthorizedAccessException.");
+            }
+            catch (UnauthorizedAccessException^)
+            {
+            }
+            finally
+            {
+               delete enumerator;
+            }
+
+            Assert::AreEqual<int>(0, (int)fake.GetRefCount());
+         }
+         finally
+         {
+            delete enumerable;
+         }
+      }
+
+      [TestMethod]
+      void Constructor_InvalidBatchSize_ThrowsAndReleasesEnumerator()
+      {
+         FakeVssEnumMgmtObject fake;
+
+         try
+         {
+            gcnew DiffAreaEnumerable(&fake, 0);
+            Assert::Fail(L"Expected ArgumentOutOfRangeException.");
+         }
+         catch (ArgumentOutOfRangeException^)
+         {
+         }
+
+         Assert::AreEqual<int>(0, (int)fake.GetRefCount());
+      }
+
+   private:
+      static void AddDiffAreas(FakeVssEnumMgmtObject &fake, int count)
+      {
+         for (int i = 0; i < count; i++)
+         {
+            pin_ptr<const wchar_t> volumeName = PtrToStringChars(String::Format(L"\\\\?\\Volume{{{0}}}\\", i));
+            fake.AddDiffArea(volumeName, L"\\\\?\\Volume{diff}\\", i * 1000, i * 100, i * 10);
+         }
+      }
+   };
+}
+} } }
@@ -0,0 +1,259 @@
+#include "pch.h"
+
+#include "CountingListAdapter.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Threading;
+using namespace Microsoft::VisualStudio::TestTools::UnitTesting;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Tests
+{
+   [TestClass]
+   public ref class VssListAdapterTests
+   {
+   public:
+      [TestMethod]
+      void Enumerate_Live_ReadsCountPerStepAndEachElementOnce()
+      {
+         CountingListAdapter^ list = gcnew CountingListAdapter(5);
+
+         int count = 0;
+         for each (TrackedElement^ element in list)
+            Assert::AreEqual<int>(count++, element->Value);
+
+         Assert::AreEqual<int>(5, count);
+         Assert::AreEqual<int>(6, list->CountCalls);
+         Assert::AreEqual<int>(5, list->ItemCalls);
+      }
+
+      [TestMethod]
+      void Enumerate_Live_ObservesChangesOfUnderlyingCollection()
+      {
+         CountingListAdapter^ list = gcnew CountingListAdapter(5);
+
+         int count = 0;
+         for each (TrackedElement^ element in list)
+         {
+            if (count++ == 1)
+               list->Resize(3);
+         }
+
+         Assert::AreEqual<int>(3, count);
+      }
+
+      [TestMethod]
+      void Materialized_ReadsUnderlyingCollectionOnce()
+      {
+         CountingListAdapter^ list = gcnew CountingListAdapter(5);
+         list->MaterializeOnRead = true;
+
+         for (int pass = 0; pass < 3; pass++)
+         {
+            int count = 0;
+            for each (TrackedElement^ element in list)
+               count++;
+
+            Assert::AreEqual<int>(5, count);
+         }
+
+         TrackedElement^ third = list[2];
+         Assert::AreEqual<int>(2, third->Value);
+         Assert::AreEqual<int>(2, list->IndexOf(third));
+         Assert::IsTrue(list->Contains(third));
+         Assert::AreEqual<int>(5, list->Count);
+
+         array<TrackedElement^>^ copy = gcnew array<TrackedElement^>(5);
+         list->CopyTo(copy, 0);
+         Assert::AreSame(third, copy[2]);
+
+         Assert::AreEqual<int>(1, list->CountCalls);
+         Assert::AreEqual<int>(5, list->ItemCalls);
+      }
+
+      [TestMethod]
+      void Invalidate_KeepsCapturedElementsAndReadsAgain()
+      {
+         CountingListAdapter^ list = gcnew CountingListAdapter(4);
+         list->MaterializeOnRead = true;
+
+         List<TrackedElement^>^ captured = gcnew List<TrackedElement^>(list);
+         list->Invalidate();
+
+         for each (TrackedElement^ element in captured)
+            Assert::IsFalse(element->IsDisposed);
+
+         List<TrackedElement^>^ recaptured = gcnew List<TrackedElement^>(list);
+         Assert::AreEqual<int>(4, recaptured->Count);
+         for each (TrackedElement^ element in recaptured)
+         {
+            Assert::IsFalse(element->IsDisposed);
+            Assert::IsFalse(captured->Contains(element));
+         }
+
+         // The List constructor reads Count, which does not capture the elements, before copying them.
+         Assert::AreEqual<int>(4, list->CountCalls);
+         Assert::AreEqual<int>(8, list->ItemCalls);
+      }
+
+      [TestMethod]
+      void Invalidate_WhileEnumerating_DoesNotDisposeElementsHandedOut()
+      {
+         CountingListAdapter^ list = gcnew CountingListAdapter(4);
+         list->MaterializeOnRead = true;
+
+         // As a backup components setter does, invalidating the list for every element of the enumeration.
+         List<TrackedElement^>^ enumerated = gcnew List<TrackedElement^>();
+         for each (TrackedElement^ element in list)
+         {
+            list->Invalidate();
+            Assert::IsFalse(element->IsDisposed);
+            enumerated->Add(element);
+         }
+
+         TrackedElement^ indexed = list[1];
+         list->Invalidate();
+         Assert::IsFalse(indexed->IsDisposed);
+
+         for each (TrackedElement^ element in enumerated)
+            Assert::IsFalse(element->IsDisposed);
+
+         list->DisposeCapturedItems();
+
+         for each (TrackedElement^ element in enumerated)
+            Assert::IsTrue(element->IsDisposed);
+         Assert::IsTrue(indexed->IsDisposed);
+      }
+
+      [TestMethod]
+      void DisposeCapturedItems_DisposesCurrentAndDiscardedElements()
+      {
+         CountingListAdapter^ list = gcnew CountingListAdapter(3);
+         list->MaterializeOnRead = true;
+
+         List<TrackedElement^>^ discarded = gcnew List<TrackedElement^>(list);
+         list->Invalidate();
+         List<TrackedElement^>^ current = gcnew List<TrackedElement^>(list);
+
+         list->DisposeCapturedItems();
+
+         for each (TrackedElement^ element in discarded)
+            Assert::IsTrue(element->IsDisposed);
+         for each (TrackedElement^ element in current)
+            Assert::IsTrue(element->IsDisposed);
+
+         // Disposing again does not dispose the same elements twice, and the list reads the collection again.
+         list->DisposeCapturedItems();
+         list->ResetCalls();
+         Assert::AreEqual<int>(3, (gcnew List<TrackedElement^>(list))->Count);
+         Assert::AreEqual<int>(3, list->ItemCalls);
+      }
+
+      [TestMethod]
+      void Invalidate_Live_DoesNotDisposeElementsOwnedByCaller()
+      {
+         CountingListAdapter^ list = gcnew CountingListAdapter(3);
+
+         List<TrackedElement^>^ elements = gcnew List<TrackedElement^>(list);
+         list->Invalidate();
+
+         for each (TrackedElement^ element in elements)
+            Assert::IsFalse(element->IsDisposed);
+      }
+
+      [TestMethod]
+      void MaterializeOnRead_Changed_KeepsCapturedElementsUntilDisposed()
+      {
+         CountingListAdapter^ list = gcnew CountingListAdapter(3);
+         list->MaterializeOnRead = true;
+
+         List<TrackedElement^>^ captured = gcnew List<TrackedElement^>(list);
+         list->MaterializeOnRead = false;
+
+         for each (TrackedElement^ element in captured)
+            Assert::IsFalse(element->IsDisposed);
+
+         list->ResetCalls();
+         Assert::AreEqual<int>(3, (gcnew List<TrackedElement^>(list))->Count);
+         Assert::AreEqual<int>(2, list->CountCalls);
+
+         list->DisposeCapturedItems();
+         for each (TrackedElement^ element in captured)
+            Assert::IsTrue(element->IsDisposed);
+      }
+
+      [TestMethod]
+      void Invalidate_ConcurrentWithReads_ServesConsistentSnapshots()
+      {
+         CountingListAdapter^ list = gcnew CountingListAdapter(16);
+         list->MaterializeOnRead = true;
+
+         ConcurrentReader^ reader = gcnew ConcurrentReader(list);
+         Thread^ thread = gcnew Thread(gcnew ThreadStart(reader, &ConcurrentReader::Run));
+         thread->Start();
+
+         for (int i = 0; i < 10000; i++)
+            list->Invalidate();
+
+         reader->Stop();
+         thread->Join();
+
+         Assert::IsNull(reader->Error, reader->Error == nullptr ? nullptr : reader->Error->ToString());
+         Assert::IsTrue(reader->Reads > 0);
+      }
+
+   private:
+      ref class ConcurrentReader sealed
+      {
+      public:
+         ConcurrentReader(CountingListAdapter^ list)
+            : m_list(list), m_stop(0), m_reads(0), m_error(nullptr)
+         {
+         }
+
+         property int Reads
+         {
+            int get() { return m_reads; }
+         }
+
+         property Exception^ Error
+         {
+            Exception^ get() { return m_error; }
+         }
+
+         void Stop()
+         {
+            Interlocked::Exchange(m_stop, 1);
+         }
+
+         void Run()
+         {
+            try
+            {
+               while (Volatile::Read(m_stop) == 0)
+               {
+                  int count = 0;
+                  for each (TrackedElement^ element in m_list)
+                     Assert::AreEqual<int>(count++, element->Value);
+
+                  Assert::AreEqual<int>(16, count);
+                  Assert::AreEqual<int>(16, m_list->Count);
+                  Assert::AreEqual<int>(7, m_list[7]->Value);
+                  m_reads++;
+               }
+            }
+            catch (Exception^ ex)
+            {
+               m_error = ex;
+            }
+         }
+
+      private:
+         CountingListAdapter^ m_list;
+         int m_stop;
+         int m_reads;
+         Exception^ m_error;
+      };
+   };
+}
+} } }
@@ -0,0 +1,138 @@
+#include "pch.h"
+
+#include "WriterMetadataCapture.h"
+#include "FakeVssWriterMetadata.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace Microsoft::VisualStudio::TestTools::UnitTesting;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Tests
+{
+   // {6a1d2b7e-3c4f-4e21-9a8b-0c5d6e7f8091}
+   static const VSS_ID s_writerId = { 0x6a1d2b7e, 0x3c4f, 0x4e21, { 0x9a, 0x8b, 0x0c, 0x5d, 0x6e, 0x7f, 0x80, 0x91 } };
+   // {0f9e8d7c-6b5a-4c3d-8e2f-1a0b9c8d7e6f}
+   static const VSS_ID s_instanceId = { 0x0f9e8d7c, 0x6b5a, 0x4c3d, { 0x8e, 0x2f, 0x1a, 0x0b, 0x9c, 0x8d, 0x7e, 0x6f } };
+
+   [TestClass]
+   public ref class WriterMetadataCaptureTests
+   {
+   public:
+      [TestMethod]
+      void Capture_CopiesIdentityRestoreMethodFilesAndComponents()
+      {
+         FakeVssExamineWriterMetadata fake(s_instanceId, s_writerId, L"Test Writer");
+         fake.SetRestoreMethod(VSS_RME_RESTORE_IF_NOT_THERE, L"TestService");
+         fake.AddAlternateLocationMapping(L"C:\\Data", L"*.db", L"D:\\Restore");
+         fake.AddExcludeFile(L"C:\\Data\\Temp", L"*.tmp", true);
+         FakeVssWMComponent &component = fake.AddComponent(VSS_CT_DATABASE, L"Databases", L"Main");
+         component.AddDatabaseFile(L"C:\\Data", L"main.db");
+         component.AddDatabaseLogFile(L"C:\\Data\\Logs", L"*.log");
+         component.AddDependency(s_writerId, L"Databases", L"Other");
+
+         VssCapturedWriterMetadata^ metadata = (gcnew WriterMetadataCapture())->Capture(&fake);
+
+         Assert::AreEqual<Guid>(ToGuid(s_instanceId), metadata->InstanceId);
+         Assert::AreEqual<Guid>(ToGuid(s_writerId), metadata->WriterId);
+         Assert::AreEqual<String^>(L"Test Writer", metadata->WriterName);
+         Assert::AreEqual<VssUsageType>(VssUsageType::UserData, metadata->Usage);
+         Assert::AreEqual<VssBackupSchema>(VssBackupSchema::Differential | VssBackupSchema::Incremental, metadata->BackupSchema);
+         Assert::IsNull(metadata->Version);
+         Assert::AreEqual<int>(0, metadata->ExcludeFromSnapshotFiles->Count);
+         Assert::AreEqual<String^>(L"<WRITER_METADATA/>", metadata->SaveAsXml());
+
+         Assert::AreEqual<VssRestoreMethod>(VssRestoreMethod::RestoreIfNotThere, metadata->RestoreMethod->Method);
+         Assert::AreEqual<String^>(L"TestService", metadata->RestoreMethod->Service);
+         Assert::AreEqual<int>(1, metadata->RestoreMethod->MappingCount);
+         Assert::AreEqual<String^>(L"D:\\Restore", metadata->AlternateLocationMappings[0]->AlternateLocation);
+
+         Assert::AreEqual<int>(1, metadata->ExcludeFiles->Count);
+         Assert::AreEqual<String^>(L"C:\\Data\\Temp", metadata->ExcludeFiles[0]->Path);
+         Assert::AreEqual<String^>(L"*.tmp", metadata->ExcludeFiles[0]->FileSpecification);
+         Assert::IsTrue(metadata->ExcludeFiles[0]->IsRecursive);
+
+         IVssWMComponent^ captured = metadata->Components[0];
+         Assert::AreEqual<VssComponentType>(VssComponentType::Database, captured->Type);
+         Assert::AreEqual<String^>(L"Databases", captured->LogicalPath);
+         Assert::AreEqual<String^>(L"Main", captured->ComponentName);
+         Assert::IsTrue(captured->Selectable);
+         Assert::AreEqual<int>(0, captured->Files->Count);
+         Assert::AreEqual<String^>(L"main.db", captured->DatabaseFiles[0]->FileSpecification);
+         Assert::AreEqual<String^>(L"C:\\Data\\Logs", captured->DatabaseLogFiles[0]->Path);
+         Assert::AreEqual<Guid>(ToGuid(s_writerId), captured->Dependencies[0]->WriterId);
+         Assert::AreEqual<String^>(L"Other", captured->Dependencies[0]->ComponentName);
+      }
+
+      [TestMethod]
+      void Capture_WithoutRestoreMethod_CapturesNullRestoreMethod()
+      {
+         FakeVssExamineWriterMetadata fake(s_instanceId, s_writerId, L"Test Writer");
+
+         VssCapturedWriterMetadata^ metadata = (gcnew WriterMetadataCapture())->Capture(&fake);
+
+         Assert::IsNull(metadata->RestoreMethod);
+         Assert::AreEqual<int>(0, metadata->AlternateLocationMappings->Count);
+         Assert::AreEqual<int>(0, metadata->Components->Count);
+      }
+
+      [TestMethod]
+      void Capture_ReleasesEveryInterfaceAndComponentInfo()
+      {
+         FakeVssExamineWriterMetadata fake(s_instanceId, s_writerId, L"Test Writer");
+         fake.AddExcludeFile(L"C:\\Temp", L"*", true);
+         FakeVssWMComponent &component = fake.AddComponent(VSS_CT_FILEGROUP, L"Files", L"Documents");
+         component.AddFile(L"C:\\Documents", L"*", true);
+         component.AddFile(L"C:\\Settings", L"*.ini", false);
+         component.AddDependency(s_writerId, L"Files", L"Other");
+
+         (gcnew WriterMetadataCapture())->Capture(&fake);
+
+         Assert::AreEqual<int>(1, (int)fake.GetRefCount());
+         Assert::AreEqual<int>(1, (int)component.GetRefCount());
+         Assert::AreEqual<int>(0, component.GetOutstandingInfoCount());
+         for (size_t i = 0; i < component.GetFiles().size(); i++)
+            Assert::AreEqual<int>(1, (int)component.GetFiles()[i]->GetRefCount());
+         Assert::AreEqual<int>(1, (int)component.GetDependencies()[0]->GetRefCount());
+      }
+
+      [TestMethod]
+      void Capture_FailingComponent_ThrowsAndFreesComponentInfo()
+      {
+         FakeVssExamineWriterMetadata fake(s_instanceId, s_writerId, L"Test Writer");
+         FakeVssWMComponent &component = fake.AddComponent(VSS_CT_FILEGROUP, L"Files", L"Documents");
+         component.AddFile(L"C:\\Documents", L"*", true);
+         component.FailGetFile(VSS_E_BAD_STATE);
+
+         try
+         {
+            (gcnew WriterMetadataCapture())->Capture(&fake);
+            Assert::Fail(L"Expected VssBadStateException.");
+         }
+         catch (VssBadStateException^)
+         {
+         }
+
+         Assert::AreEqual<int>(0, component.GetOutstandingInfoCount());
+         Assert::AreEqual<int>(1, (int)component.GetRefCount());
+      }
+
+      [TestMethod]
+      void Capture_SameInstance_SharesRepeatedStrings()
+      {
+         FakeVssExamineWriterMetadata first(s_instanceId, s_writerId, L"Test Writer");
+         first.AddComponent(VSS_CT_FILEGROUP, L"Files", L"Documents").AddFile(L"C:\\Documents", L"*", true);
+         FakeVssExamineWriterMetadata second(s_instanceId, s_writerId, L"Test Writer");
+         second.AddComponent(VSS_CT_FILEGROUP, L"Files", L"Pictures").AddFile(L"C:\\Documents", L"*", true);
+
+         WriterMetadataCapture^ capture = gcnew WriterMetadataCapture();
+         VssCapturedWriterMetadata^ firstMetadata = capture->Capture(&first);
+         VssCapturedWriterMetadata^ secondMetadata = capture->Capture(&second);
+
+         Assert::IsTrue(Object::ReferenceEquals(firstMetadata->WriterName, secondMetadata->WriterName));
+         Assert::IsTrue(Object::ReferenceEquals(firstMetadata->Components[0]->LogicalPath, secondMetadata->Components[0]->LogicalPath));
+         Assert::IsTrue(Object::ReferenceEquals(firstMetadata->Components[0]->Files[0]->Path, secondMetadata->Components[0]->Files[0]->Path));
+         Assert::IsFalse(Object::ReferenceEquals(firstMetadata->Components[0]->ComponentName, secondMetadata->Components[0]->ComponentName));
+      }
+   };
+}
+} } }
@@ -0,0 +1,26 @@
+// pch.h: This is a precompiled header file.
+// The headers below mirror those of the AlphaVSS.Platform project, so that the platform sources compiled
+// into the test assembly (see AlphaVSS.Platform.Tests.vcxproj) see the same declarations.
+
+#ifndef PCH_H
+#define PCH_H
+
+#pragma once
+
+#include <windows.h>
+#include <winbase.h>
+
+#include <vss.h>
+#include <vsWriter.h>
+#include <vsBackup.h>
+#include <VsMgmt.h>
+
+#include "Utils.h"
+#include "Macros.h"
+#include "Error.h"
+#include "Instrumentation.h"
+
+#include <atlbase.h>
+#include <vcclr.h>
+
+#endif //PCH_H
@@ -102,13 +102,20 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       }
    }
 
-   void WaitCheckAndReleaseVssAsyncOperation(::IVssAsync *pAsync)
+   void WaitCheckAndReleaseVssAsyncOperation(::IVssAsync *pAsync, VssPhaseTimer^ phase)
    {
       CComPtr<::IVssAsync> spAsync;
       spAsync.Attach(pAsync);
-      CheckCom(spAsync->Wait());
-      HRESULT hr;
-      CheckCom(spAsync->QueryStatus(&hr, NULL));
+      HRESULT hr = spAsync->Wait();
+      if (SUCCEEDED(hr))
+      {
+         HRESULT hrResult;
+         hr = spAsync->QueryStatus(&hrResult, NULL);
+         if (SUCCEEDED(hr))
+            hr = hrResult;
+      }
+
+      VssInstrumentation::CompletePhase(phase, hr);
       CheckCom(hr);
       if (hr == VSS_S_ASYNC_CANCELLED)
          throw gcnew OperationCanceledException();
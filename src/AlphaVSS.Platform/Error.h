@@ -4,8 +4,10 @@
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
+   ref class VssPhaseTimer;
+
    Exception ^GetExceptionForHr(HRESULT errorCode);
    void ThrowException(HRESULT errorCode);
-   void WaitCheckAndReleaseVssAsyncOperation(::IVssAsync *pAsync);
+   void WaitCheckAndReleaseVssAsyncOperation(::IVssAsync *pAsync, VssPhaseTimer^ phase);
 }	
 } }
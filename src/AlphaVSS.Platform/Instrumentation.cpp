@@ -0,0 +1,76 @@
+#include "pch.h"
+#include "Instrumentation.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   /****************************************************************************************
+   *  VssPhaseTimer
+   ****************************************************************************************/
+
+   VssPhaseTimer::VssPhaseTimer(String^ phase)
+      : m_phase(phase), m_start(Stopwatch::GetTimestamp()), m_completed(0)
+   {
+      VssEventSource::Log->PhaseStarted(phase);
+   }
+
+   void VssPhaseTimer::Complete(HRESULT hrResult)
+   {
+      if (Interlocked::Exchange(m_completed, 1) != 0)
+         return;
+
+      VssEventSource::Log->PhaseCompleted(m_phase, hrResult, VssInstrumentation::GetElapsedMilliseconds(m_start));
+   }
+
+   /****************************************************************************************
+   *  VssInstrumentation
+   ****************************************************************************************/
+
+   void VssInstrumentation::ReportComCall(const char *function, HRESULT hrResult, Int64 start)
+   {
+      double duration = GetElapsedMilliseconds(start);
+      VssEventSource::Log->ComCallCompleted(GetFunctionName(function), hrResult, duration);
+   }
+
+   VssPhaseTimer^ VssInstrumentation::StartPhase(String^ phase)
+   {
+      if (!VssEventSource::Log->IsEnabled(EventLevel::Informational, VssEventSource::Keywords::Phases))
+         return nullptr;
+
+      return gcnew VssPhaseTimer(phase);
+   }
+
+   String^ VssInstrumentation::GetFunctionName(const char *function)
+   {
+      // __FUNCTION__ yields a string literal, so its address identifies the calling function and the 
+      // converted name only needs to be created once.
+      IntPtr key((void *)function);
+      String^ name;
+
+      Monitor::Enter(s_functionNames);
+      try
+      {
+         if (s_functionNames->TryGetValue(key, name))
+            return name;
+      }
+      finally
+      {
+         Monitor::Exit(s_functionNames);
+      }
+
+      name = gcnew String(function);
+      if (name->StartsWith(L"Alphaleonis::Win32::Vss::", StringComparison::Ordinal))
+         name = name->Substring(25);
+
+      Monitor::Enter(s_functionNames);
+      try
+      {
+         s_functionNames[key] = name;
+      }
+      finally
+      {
+         Monitor::Exit(s_functionNames);
+      }
+
+      return name;
+   }
+}}}
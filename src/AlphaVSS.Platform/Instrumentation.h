@@ -0,0 +1,94 @@
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Diagnostics;
+using namespace System::Diagnostics::Tracing;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   //
+   // The timing of an asynchronous VSS operation (a "phase", such as DoSnapshotSet), from the call starting
+   // it until its completion was observed. Instances are only created while phases are being recorded, so
+   // a null VssPhaseTimer is valid everywhere one is accepted.
+   //
+   private ref class VssPhaseTimer sealed
+   {
+   public:
+      VssPhaseTimer(String^ phase);
+
+      // Reports the completion of the phase. Only the first call has any effect.
+      void Complete(HRESULT hrResult);
+
+   private:
+      initonly String^ m_phase;
+      initonly Int64 m_start;
+      int m_completed;
+   };
+
+   //
+   // Forwards timing information to the VssEventSource. Every method checks whether the relevant events are
+   // enabled first, so that nothing is timed or allocated while no listener is attached.
+   //
+   private ref class VssInstrumentation abstract sealed
+   {
+   public:
+      // Returns true if the latency of individual COM calls is being recorded.
+      static bool IsComCallTimingEnabled()
+      {
+         return VssEventSource::Log->IsEnabled(EventLevel::Verbose, VssEventSource::Keywords::ComCalls);
+      }
+
+      // Reports a COM call issued by function, started at the Stopwatch timestamp start.
+      static void ReportComCall(const char *function, HRESULT hrResult, Int64 start);
+
+      // Starts timing the specified phase. Returns null if phases are not being recorded.
+      static VssPhaseTimer^ StartPhase(String^ phase);
+
+      // Completes the specified phase, if any.
+      static void CompletePhase(VssPhaseTimer^ phase, HRESULT hrResult)
+      {
+         if (phase != nullptr)
+            phase->Complete(hrResult);
+      }
+
+   internal:
+      static double GetElapsedMilliseconds(Int64 start)
+      {
+         return (Stopwatch::GetTimestamp() - start) * 1000.0 / Stopwatch::Frequency;
+      }
+
+   private:
+      static VssInstrumentation()
+      {
+         s_functionNames = gcnew Dictionary<IntPtr, String^>();
+      }
+
+      static String^ GetFunctionName(const char *function);
+
+      static initonly Dictionary<IntPtr, String^>^ s_functionNames;
+   };
+
+   //
+   // Times a single COM call made through CheckCom. Lives on the stack of the calling function; when COM calls
+   // are not being recorded, the only cost is the IsEnabled check.
+   //
+   class ComCallTimer
+   {
+   public:
+      explicit ComCallTimer(const char *function)
+         : m_function(function), m_start(VssInstrumentation::IsComCallTimingEnabled() ? Stopwatch::GetTimestamp() : 0)
+      {
+      }
+
+      void Complete(HRESULT hrResult)
+      {
+         if (m_start != 0)
+            VssInstrumentation::ReportComCall(m_function, hrResult, m_start);
+      }
+
+   private:
+      const char *m_function;
+      __int64 m_start;
+   };
+}}}
@@ -22,14 +22,34 @@
 // Utility macro assisting CheckCom, takes a HRESULT error code and a text
 // describing the error. If the error code indicates an error,
 // an appropriate exception will be thrown, using GenerateVssException,
-// otherwise nothing will happen.
+// otherwise nothing will happen. The error code is evaluated exactly once, 
+// and timed as a COM call of the enclosing function (see Instrumentation.h).
 //
 #define CheckComError( ErrorCode, Text )							\
 {																	\
-   HRESULT hrInternal = ErrorCode;									\
+   ComCallTimer timerInternal(__FUNCTION__);						\
+   HRESULT hrInternal = (ErrorCode);								\
+   timerInternal.Complete(hrInternal);								\
    if (FAILED(hrInternal))											\
    {																\
-   ThrowException( ErrorCode );	\
+   ThrowException( hrInternal );	\
+   }																\
+}	
+
+//
+// Like CheckCom, for a call starting the asynchronous operation timed by Phase
+// (a VssPhaseTimer^). If the call fails, the phase is completed with its error
+// code before the exception is thrown.
+//
+#define CheckComPhase( Phase, Call )								\
+{																	\
+   ComCallTimer timerInternal(__FUNCTION__);						\
+   HRESULT hrInternal = (Call);										\
+   timerInternal.Complete(hrInternal);								\
+   if (FAILED(hrInternal))											\
+   {																\
+   VssInstrumentation::CompletePhase( Phase, hrInternal );			\
+   ThrowException( hrInternal );	\
    }																\
 }	
 
@@ -20,13 +20,13 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
          guid.Data4[ 6 ], guid.Data4[ 7 ] );
    }
 
-   // Convert from System::Guid to VSS_ID
+   // Convert from System::Guid to VSS_ID. System::Guid has the same memory layout as GUID, so
+   // the value is copied directly rather than going through Guid::ToByteArray(), which would
+   // allocate on the managed heap for every call.
    inline VSS_ID ToVssId( System::Guid guid ) 
    {
-      array<Byte>^ guidData = guid.ToByteArray();
-      pin_ptr<Byte> data = &(guidData[ 0 ]);
-
-      return *(_GUID *)data;
+      pin_ptr<System::Guid> data = &guid;
+      return *reinterpret_cast<const _GUID *>(data);
    }
 
 
@@ -36,7 +36,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    //
 
    // Convert from FILETIME to System::DateTime
-   inline System::DateTime ToDateTime(FILETIME &ft)
+   inline System::DateTime ToDateTime(const FILETIME &ft)
    {
       UInt64 t = (UInt64)( (((UInt64)ft.dwHighDateTime) << 32) | ((UInt64)ft.dwLowDateTime) );
       return DateTime::FromFileTime(t);
@@ -185,18 +185,23 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    //
    // Helper class for managing an array of VSS_ID objects, originating from
-   // a managed array of Guid objects.
+   // a managed array of Guid objects. Arrays of up to InlineCapacity ids, which
+   // covers nearly all writer class and instance lists, are stored in the object
+   // itself; only longer arrays are allocated on the native heap.
    //
    class VssIds
    {
    public:
+      static const int InlineCapacity = 16;
+
       VssIds(array<System::Guid> ^ guids)
-         : m_ids(0)
+         : m_ids(m_inline)
       {
          if (guids == nullptr)
             throw gcnew ArgumentNullException();
 
-         m_ids = new VSS_ID[guids->Length];
+         if (guids->Length > InlineCapacity)
+            m_ids = new VSS_ID[guids->Length];
 
          for (int i = 0; i < guids->Length; i++)
          {
@@ -206,7 +211,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
       ~VssIds()
       {
-         delete [] m_ids;
+         if (m_ids != m_inline)
+            delete [] m_ids;
       }
 
       (operator VSS_ID *)()
@@ -215,6 +221,10 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       }
 
    private:
+      VssIds(const VssIds &);
+      VssIds &operator=(const VssIds &);
+
+      VSS_ID m_inline[InlineCapacity];
       VSS_ID *m_ids;
    };
 
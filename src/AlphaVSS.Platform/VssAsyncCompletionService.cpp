@@ -0,0 +1,254 @@
+#include "pch.h"
+#include "VssAsyncCompletionService.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   /****************************************************************************************
+   *  VssAsyncOperation
+   ****************************************************************************************/
+
+   VssAsyncOperation::VssAsyncOperation(::IVssAsync *pAsync, VssAsyncCompletedCallback^ callback, Object^ state, VssPhaseTimer^ phase, Int64 now)
+      : m_async(pAsync), m_callback(callback), m_state(state), m_phase(phase), m_hrResult(VSS_S_ASYNC_PENDING), m_lock(gcnew Object()),
+        NextPoll(now + VssAsyncCompletionService::MinPollInterval), PollInterval(VssAsyncCompletionService::MinPollInterval)
+   {
+   }
+
+   void VssAsyncOperation::Cancel()
+   {
+      Monitor::Enter(m_lock);
+      try
+      {
+         if (m_async == 0)
+            return;
+
+         m_async->Cancel();
+      }
+      finally
+      {
+         Monitor::Exit(m_lock);
+      }
+
+      VssAsyncCompletionService::Wake(this);
+   }
+
+   bool VssAsyncOperation::Poll()
+   {
+      HRESULT hrResult;
+      HRESULT hr;
+
+      Monitor::Enter(m_lock);
+      try
+      {
+         hr = m_async->QueryStatus(&hrResult, NULL);
+      }
+      finally
+      {
+         Monitor::Exit(m_lock);
+      }
+
+      if (FAILED(hr))
+         hrResult = hr;
+
+      m_hrResult = hrResult;
+      return hrResult != VSS_S_ASYNC_PENDING;
+   }
+
+   void VssAsyncOperation::Fail(HRESULT hrResult)
+   {
+      m_hrResult = FAILED(hrResult) ? hrResult : E_FAIL;
+   }
+
+   void VssAsyncOperation::Complete()
+   {
+      try
+      {
+         Monitor::Enter(m_lock);
+         try
+         {
+            if (m_async != 0)
+            {
+               m_async->Release();
+               m_async = 0;
+            }
+         }
+         finally
+         {
+            Monitor::Exit(m_lock);
+         }
+
+         VssInstrumentation::CompletePhase(m_phase, m_hrResult);
+      }
+      catch (Exception^)
+      {
+         // Neither releasing the operation nor recording its phase may keep the callback from running.
+      }
+
+      // Never run the callback (and any task continuations it triggers) on the completion thread itself,
+      // unless it cannot be queued at all.
+      try
+      {
+         ThreadPool::QueueUserWorkItem(gcnew WaitCallback(this, &VssAsyncOperation::InvokeCallback), nullptr);
+      }
+      catch (Exception^)
+      {
+         try
+         {
+            InvokeCallback(nullptr);
+         }
+         catch (Exception^)
+         {
+            // A failing callback must not take down the completion thread.
+         }
+      }
+   }
+
+   void VssAsyncOperation::InvokeCallback(Object^ state)
+   {
+      m_callback(m_hrResult, m_state);
+   }
+
+   /****************************************************************************************
+   *  VssAsyncCompletionService
+   ****************************************************************************************/
+
+   VssAsyncOperation^ VssAsyncCompletionService::Register(::IVssAsync *pAsync, VssAsyncCompletedCallback^ callback, Object^ state, VssPhaseTimer^ phase)
+   {
+      if (pAsync == 0)
+         throw gcnew ArgumentNullException(L"pAsync");
+
+      try
+      {
+         if (callback == nullptr)
+            throw gcnew ArgumentNullException(L"callback");
+
+         Monitor::Enter(s_lock);
+         try
+         {
+            if (s_thread == nullptr)
+               StartThread();
+
+            VssAsyncOperation^ operation = gcnew VssAsyncOperation(pAsync, callback, state, phase, s_clock->ElapsedMilliseconds);
+            s_pending->Add(operation);
+            s_wakeEvent->Set();
+            return operation;
+         }
+         finally
+         {
+            Monitor::Exit(s_lock);
+         }
+      }
+      catch (...)
+      {
+         VssInstrumentation::CompletePhase(phase, E_FAIL);
+         pAsync->Release();
+         throw;
+      }
+   }
+
+   void VssAsyncCompletionService::Wake(VssAsyncOperation^ operation)
+   {
+      Monitor::Enter(s_lock);
+      try
+      {
+         operation->NextPoll = 0;
+         operation->PollInterval = MinPollInterval;
+      }
+      finally
+      {
+         Monitor::Exit(s_lock);
+      }
+      s_wakeEvent->Set();
+   }
+
+   void VssAsyncCompletionService::StartThread()
+   {
+      Thread^ thread = gcnew Thread(gcnew ThreadStart(&VssAsyncCompletionService::Run));
+      thread->IsBackground = true;
+      thread->Name = L"AlphaVSS async completion";
+      thread->SetApartmentState(ApartmentState::MTA);
+      thread->Start();
+      s_thread = thread;
+   }
+
+   void VssAsyncCompletionService::Run()
+   {
+      List<VssAsyncOperation^>^ due = gcnew List<VssAsyncOperation^>();
+      List<VssAsyncOperation^>^ completed = gcnew List<VssAsyncOperation^>();
+
+      while (true)
+      {
+         Monitor::Enter(s_lock);
+         try
+         {
+            Int64 now = s_clock->ElapsedMilliseconds;
+            for (int i = 0; i < s_pending->Count; i++)
+            {
+               if (s_pending[i]->NextPoll <= now)
+                  due->Add(s_pending[i]);
+            }
+         }
+         finally
+         {
+            Monitor::Exit(s_lock);
+         }
+
+         // QueryStatus is called outside of the lock, so that registration never waits for VSS.
+         for (int i = 0; i < due->Count; i++)
+         {
+            try
+            {
+               if (due[i]->Poll())
+                  completed->Add(due[i]);
+            }
+            catch (Exception^ ex)
+            {
+               // Fail the offending operation only, instead of every operation tracked by this thread.
+               due[i]->Fail(ex->HResult);
+               completed->Add(due[i]);
+            }
+         }
+
+         int timeout = Timeout::Infinite;
+
+         Monitor::Enter(s_lock);
+         try
+         {
+            for (int i = 0; i < completed->Count; i++)
+               s_pending->Remove(completed[i]);
+
+            Int64 now = s_clock->ElapsedMilliseconds;
+            for (int i = 0; i < due->Count; i++)
+            {
+               VssAsyncOperation^ operation = due[i];
+
+               // An operation woken while it was being polled keeps its reset schedule.
+               if (operation->NextPoll != 0)
+               {
+                  operation->PollInterval = Math::Min(operation->PollInterval * 2, (int)MaxPollInterval);
+                  operation->NextPoll = now + operation->PollInterval;
+               }
+            }
+
+            for (int i = 0; i < s_pending->Count; i++)
+            {
+               Int64 wait = Math::Max(s_pending[i]->NextPoll - now, (Int64)0);
+               if (timeout == Timeout::Infinite || wait < timeout)
+                  timeout = (int)wait;
+            }
+         }
+         finally
+         {
+            Monitor::Exit(s_lock);
+         }
+
+         for (int i = 0; i < completed->Count; i++)
+            completed[i]->Complete();
+
+         due->Clear();
+         completed->Clear();
+
+         if (timeout != 0)
+            s_wakeEvent->WaitOne(timeout);
+      }
+   }
+}}}
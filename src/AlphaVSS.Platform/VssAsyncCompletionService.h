@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vss.h>
+#include "Instrumentation.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Diagnostics;
+using namespace System::Threading;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   // Invoked on a thread-pool thread once an operation registered with the VssAsyncCompletionService has
+   // completed. hrResult is the status reported by IVssAsync::QueryStatus (VSS_S_ASYNC_FINISHED or
+   // VSS_S_ASYNC_CANCELLED), or the error code of the operation.
+   private delegate void VssAsyncCompletedCallback(HRESULT hrResult, Object^ state);
+
+   //
+   // An IVssAsync operation tracked by the VssAsyncCompletionService.
+   //
+   private ref class VssAsyncOperation sealed
+   {
+   public:
+      // Requests cancellation of the operation. Has no effect if the operation has already completed.
+      void Cancel();
+
+      // The status reported by the most recent call to QueryStatus, VSS_S_ASYNC_PENDING if the operation 
+      // has not been polled yet.
+      property HRESULT LastStatus { HRESULT get() { return m_hrResult; } }
+
+   internal:
+      VssAsyncOperation(::IVssAsync *pAsync, VssAsyncCompletedCallback^ callback, Object^ state, VssPhaseTimer^ phase, Int64 now);
+
+      // Queries the status of the operation. Returns true if the operation is no longer pending.
+      bool Poll();
+
+      // Marks the operation as failed with the specified error code, e.g. because polling it threw an exception.
+      void Fail(HRESULT hrResult);
+
+      // Releases the IVssAsync instance, completes the phase and invokes the completion callback on the thread pool.
+      // Never throws, so that the callback is guaranteed to run once the operation has completed.
+      void Complete();
+
+      // Scheduling state, owned by the completion thread (and guarded by the service lock).
+      Int64 NextPoll;
+      int PollInterval;
+
+   private:
+      void InvokeCallback(Object^ state);
+
+      ::IVssAsync *m_async;
+      VssAsyncCompletedCallback^ m_callback;
+      Object^ m_state;
+      VssPhaseTimer^ m_phase;
+      volatile HRESULT m_hrResult;
+      initonly Object^ m_lock;
+   };
+
+   //
+   // Tracks outstanding IVssAsync operations on a single dedicated background thread, instead of blocking
+   // one thread-pool thread in IVssAsync::Wait per operation. Each operation is polled using QueryStatus,
+   // starting with a short interval that is doubled up to MaxPollInterval for as long as the operation
+   // remains pending, so that short operations complete promptly while long running ones (such as
+   // DoSnapshotSet on a busy host) cost next to nothing while they wait.
+   //
+   // An operation that fails to be polled or completed is completed with the error, and never takes down
+   // the completion thread.
+   //
+   private ref class VssAsyncCompletionService abstract sealed
+   {
+   public:
+      literal int MinPollInterval = 10;
+      literal int MaxPollInterval = 100;
+
+      // Starts tracking the specified operation, taking ownership of pAsync. pAsync is released once the
+      // operation has completed, or immediately if registration fails. phase, which may be null, is completed 
+      // with the result of the operation as soon as its completion has been observed.
+      static VssAsyncOperation^ Register(::IVssAsync *pAsync, VssAsyncCompletedCallback^ callback, Object^ state, VssPhaseTimer^ phase);
+
+   internal:
+      // Causes the specified operation to be polled as soon as possible, e.g. after it has been cancelled.
+      static void Wake(VssAsyncOperation^ operation);
+
+   private:
+      static VssAsyncCompletionService()
+      {
+         s_lock = gcnew Object();
+         s_pending = gcnew List<VssAsyncOperation^>();
+         s_wakeEvent = gcnew AutoResetEvent(false);
+         s_clock = Stopwatch::StartNew();
+      }
+
+      // Starts the completion thread. Must be called with s_lock held.
+      static void StartThread();
+
+      static void Run();
+
+      static initonly Object^ s_lock;
+      static initonly List<VssAsyncOperation^>^ s_pending;
+      static initonly AutoResetEvent^ s_wakeEvent;
+      static initonly Stopwatch^ s_clock;
+      static Thread^ s_thread;
+   };
+}}}
@@ -5,32 +5,17 @@
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
-   VssAsyncResult::VssAsyncResult(::IVssAsync *vssAsync, AsyncCallback^ userCallback, Object^ asyncState)
-      : m_isComplete(0), m_asyncCallback(userCallback), m_asyncState(asyncState), m_asyncWaitHandle(nullptr), m_vssAsync(vssAsync), m_exception(nullptr)
+   VssAsyncResult::VssAsyncResult(AsyncCallback^ userCallback, Object^ asyncState)
+      : m_isComplete(0), m_asyncCallback(userCallback), m_asyncState(asyncState), m_asyncWaitHandle(nullptr), m_operation(nullptr), m_exception(nullptr)
    {
-      if (!ThreadPool::QueueUserWorkItem(gcnew WaitCallback(this, &VssAsyncResult::WaitForAsyncCompletion)))
-      {
-         throw gcnew Exception(L"ThreadPool::QueueUserWorkItem failed.");
-      }
    }
 
-   void VssAsyncResult::WaitForAsyncCompletion(Object^ state)
+   void VssAsyncResult::OnAsyncCompleted(HRESULT hrResult, Object^ state)
    {
-      HRESULT hrResult;
-      
-      hrResult = m_vssAsync->Wait();
-
       int prevState = Interlocked::Exchange(m_isComplete, -1);
 
       if (prevState != 0)
-         throw gcnew InvalidOperationException("WaitForAsyncCompletion can only be called once.");
-
-      if (SUCCEEDED(hrResult))
-      {
-         HRESULT hr = m_vssAsync->QueryStatus(&hrResult, NULL);
-         if (FAILED(hr))
-            hrResult = hr;
-      }
+         throw gcnew InvalidOperationException("OnAsyncCompleted can only be called once.");
 
       if (FAILED(hrResult))
          m_exception = GetExceptionForHr(hrResult);
@@ -96,34 +81,36 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       return Thread::VolatileRead(m_isComplete) != 0;
    }
 
-   VssAsyncResult^ VssAsyncResult::Create(::IVssAsync *vssAsync, AsyncCallback^ userCallback, Object^ asyncState)
+   VssAsyncResult^ VssAsyncResult::Create(::IVssAsync *vssAsync, VssPhaseTimer^ phase, AsyncCallback^ userCallback, Object^ asyncState)
    {
+      VssAsyncResult^ result;
       try
       {
-         return gcnew VssAsyncResult(vssAsync, userCallback, asyncState);
+         result = gcnew VssAsyncResult(userCallback, asyncState);
       }
       catch (...)
       {
+         VssInstrumentation::CompletePhase(phase, E_FAIL);
          vssAsync->Release();
          throw;
       }
-   }
 
-   VssAsyncResult::~VssAsyncResult()
-   {
-      this->!VssAsyncResult();
+      // The completion service takes ownership of vssAsync, and releases it once the operation has completed.
+      result->m_operation = VssAsyncCompletionService::Register(vssAsync, gcnew VssAsyncCompletedCallback(result, &VssAsyncResult::OnAsyncCompleted), nullptr, phase);
+      return result;
    }
 
-   VssAsyncResult::!VssAsyncResult()
+   VssAsyncResult::~VssAsyncResult()
    {
-      if (m_vssAsync != 0)
+      if (IsCompleted && m_asyncWaitHandle != nullptr)
       {
-         m_vssAsync->Release();
-         m_vssAsync = 0;
+         m_asyncWaitHandle->Close();
+         m_asyncWaitHandle = nullptr;
       }
    }
 
    void VssAsyncResult::Cancel()
    {       
+      m_operation->Cancel();
    }
-}}}
\ No newline at end of file
+}}}
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <vss.h>
+#include "VssAsyncCompletionService.h"
 
 using namespace System;
 using namespace System::Collections::Generic;
@@ -15,17 +16,14 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       Object^ m_asyncState;
       int m_isComplete;
       ManualResetEvent^ m_asyncWaitHandle;
-      ::IVssAsync *m_vssAsync;
+      VssAsyncOperation^ m_operation;
       Exception^ m_exception;
 
-      VssAsyncResult(::IVssAsync *vssAsync, AsyncCallback^ userCallback, Object^ asyncState);
-      void WaitForAsyncCompletion(Object^ state);
+      VssAsyncResult(AsyncCallback^ userCallback, Object^ asyncState);
+      void OnAsyncCompleted(HRESULT hrResult, Object^ state);
    public:
-      /// <summary>Destructor.</summary>
-      ~VssAsyncResult();
-
       /// <summary>Releases resources used by the <see cref="VssAsyncResult"/> object.</summary>
-      !VssAsyncResult();
+      ~VssAsyncResult();
 
       property Object^ AsyncState { virtual Object^ get(); }
       property bool CompletedSynchronously { virtual bool get(); }
@@ -35,6 +33,6 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    internal:
       void EndInvoke();
 
-      static VssAsyncResult^ Create(::IVssAsync *vssAsync, AsyncCallback^ userCallback, Object^ asyncState);
+      static VssAsyncResult^ Create(::IVssAsync *vssAsync, VssPhaseTimer^ phase, AsyncCallback^ userCallback, Object^ asyncState);
    };
 }}}
\ No newline at end of file
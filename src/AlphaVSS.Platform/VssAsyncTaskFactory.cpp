@@ -5,27 +5,60 @@ namespace Alphaleonis {
    namespace Win32 {
       namespace Vss {
 
-         VssAsyncTaskFactory::VssAsyncInfo::VssAsyncInfo(::IVssAsync* pVssAsync, System::Threading::CancellationToken cancellationToken)
-            : _vssAsync(pVssAsync), _cancellationToken(cancellationToken), _lock(gcnew Object())
+         VssAsyncTaskFactory::VssAsyncTaskState::VssAsyncTaskState()
+            : _taskCompletionSource(gcnew TaskCompletionSource<Object^>()), _hasRegistration(false), _isCompleted(false), _lock(gcnew Object()),
+              _progress(nullptr), _writerStatus(nullptr), _stopwatch(nullptr), _timer(nullptr), _operation(nullptr), _reportLock(gcnew Object())
          {
          }
 
-         VssAsyncTaskFactory::VssAsyncInfo::~VssAsyncInfo()
+         VssAsyncTaskFactory::VssAsyncTaskState::VssAsyncTaskState(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, IReadOnlyList<VssWriterStatusInfo^>^ writerStatus)
+            : _taskCompletionSource(gcnew TaskCompletionSource<Object^>()), _hasRegistration(false), _isCompleted(false), _lock(gcnew Object()),
+              _progress(progress), _writerStatus(writerStatus), _reportInterval(reportInterval), _stopwatch(Stopwatch::StartNew()), 
+              _timer(nullptr), _operation(nullptr), _reportLock(gcnew Object())
          {
-            this->!VssAsyncInfo();
          }
 
-         VssAsyncTaskFactory::VssAsyncInfo::!VssAsyncInfo()
+         void VssAsyncTaskFactory::VssAsyncTaskState::StartProgress(VssAsyncOperation^ operation)
          {
             bool taken = false;
             try
             {
                Monitor::Enter(_lock, taken);
-               if (_vssAsync != 0)
-               {
-                  _vssAsync->Release();
-                  _vssAsync = 0;
-               }
+               _operation = operation;
+
+               // If the operation has already completed, the final sample has already been reported.
+               if (!_isCompleted)
+                  _timer = gcnew Timer(gcnew TimerCallback(this, &VssAsyncTaskState::ReportWorker), nullptr, _reportInterval, Timeout::InfiniteTimeSpan);
+            }
+            finally
+            {
+               if (taken)
+                  Monitor::Exit(_lock);
+            }
+         }
+
+         void VssAsyncTaskFactory::VssAsyncTaskState::ReportWorker(Object^ state)
+         {
+            Monitor::Enter(_reportLock);
+            try
+            {
+               if (_isCompleted)
+                  return;
+
+               Report(_operation->LastStatus);
+            }
+            finally
+            {
+               Monitor::Exit(_reportLock);
+            }
+
+            // The timer is re-armed only once the sample has been reported, so that samples never overlap.
+            bool taken = false;
+            try
+            {
+               Monitor::Enter(_lock, taken);
+               if (_timer != nullptr)
+                  _timer->Change(_reportInterval, Timeout::InfiniteTimeSpan);
             }
             finally
             {
@@ -34,25 +67,36 @@ namespace Alphaleonis {
             }
          }
 
-         ::IVssAsync* VssAsyncTaskFactory::VssAsyncInfo::VssAsyncPtr::get()
+         void VssAsyncTaskFactory::VssAsyncTaskState::Report(HRESULT hrResult)
          {
-            return _vssAsync;
+            // Reporting runs on a timer or completion thread, where an exception would either take down the process or 
+            // keep the task from completing. A lost sample is preferable to both. No VSS method is called here; the 
+            // writer status was captured before the operation was started.
+            try
+            {
+               _progress->Report(gcnew VssAsyncProgress(_stopwatch->Elapsed, (VssError)hrResult, _writerStatus));
+            }
+            catch (Exception^)
+            {
+            }
          }
 
-         CancellationToken VssAsyncTaskFactory::VssAsyncInfo::CancellationToken::get()
+         System::Threading::Tasks::Task^ VssAsyncTaskFactory::VssAsyncTaskState::Task::get()
          {
-            return _cancellationToken;
+            return _taskCompletionSource->Task;
          }
 
-         void VssAsyncTaskFactory::VssAsyncInfo::Cancel()
+         void VssAsyncTaskFactory::VssAsyncTaskState::SetRegistration(CancellationTokenRegistration registration)
          {
             bool taken = false;
             try
             {
                Monitor::Enter(_lock, taken);
-               if (_vssAsync != 0)
+               if (!_isCompleted)
                {
-                  auto hr = _vssAsync->Cancel();
+                  _registration = registration;
+                  _hasRegistration = true;
+                  return;
                }
             }
             finally
@@ -60,54 +104,137 @@ namespace Alphaleonis {
                if (taken)
                   Monitor::Exit(_lock);
             }
-         }
 
-         Task^ VssAsyncTaskFactory::AsTask(::IVssAsync* vssAsync, CancellationToken cancellationToken)
-         {
-            // We deliberately pass CancellationToken::None to Task.Factory.StartNew here, because the task continuation is responsible for 
-            // cleanup of vssAsync, so we definitely want the task to start either way here. (The cancellation token is used in the WaitWorker
-            // method.
-            return Task::Factory->StartNew(gcnew Action<Object^>(&WaitWorker), gcnew VssAsyncInfo(vssAsync, cancellationToken), CancellationToken::None, TaskCreationOptions::DenyChildAttach, TaskScheduler::Default);
+            // The operation completed before the registration was made.
+            registration.Dispose();
          }
 
-         void VssAsyncTaskFactory::CancelWorker(Object^ state)
+         void VssAsyncTaskFactory::VssAsyncTaskState::Complete(HRESULT hrResult)
          {
-            VssAsyncInfo^ vssAsyncInfo = (VssAsyncInfo^)state;
-            vssAsyncInfo->Cancel();
+            bool hasRegistration = false;
+            CancellationTokenRegistration registration;
+            Timer^ timer = nullptr;
+            bool taken = false;
+            try
+            {
+               Monitor::Enter(_lock, taken);
+               _isCompleted = true;
+               hasRegistration = _hasRegistration;
+               registration = _registration;
+               _hasRegistration = false;
+               timer = _timer;
+               _timer = nullptr;
+            }
+            finally
+            {
+               if (taken)
+                  Monitor::Exit(_lock);
+            }
+
+            try
+            {
+               if (hasRegistration)
+                  registration.Dispose();
+
+               if (timer != nullptr)
+                  delete timer;
+
+               // Report the final sample before completing the task, after any sample currently being reported.
+               if (_progress != nullptr)
+               {
+                  Monitor::Enter(_reportLock);
+                  try
+                  {
+                     Report(hrResult);
+                  }
+                  finally
+                  {
+                     Monitor::Exit(_reportLock);
+                  }
+               }
+            }
+            finally
+            {
+               // Whatever happens above, the task must complete.
+               if (FAILED(hrResult))
+                  _taskCompletionSource->TrySetException(GetExceptionForHr(hrResult));
+               else if (hrResult == VSS_S_ASYNC_CANCELLED)
+                  _taskCompletionSource->TrySetCanceled();
+               else if (hrResult == VSS_S_ASYNC_FINISHED)
+                  _taskCompletionSource->TrySetResult(nullptr);
+               else // this really should not happen
+                  _taskCompletionSource->TrySetException(gcnew InvalidOperationException(String::Format("Operation is not complete. HResult is {0}.", hrResult)));
+            }
          }
 
-         void VssAsyncTaskFactory::WaitWorker(Object^ state)
+         Task^ VssAsyncTaskFactory::AsTask(::IVssAsync* vssAsync, VssPhaseTimer^ phase, CancellationToken cancellationToken)
          {
-            VssAsyncInfo^ vssAsyncInfo = (VssAsyncInfo^)state;
-            IVssAsync* vssAsync = vssAsyncInfo->VssAsyncPtr;
-            CancellationToken cancellationToken = vssAsyncInfo->CancellationToken;
+            // No thread is blocked while the operation is in progress; the completion service polls the operation 
+            // and completes the task once it has finished. The completion service takes ownership of vssAsync.
+            VssAsyncTaskState^ state;
+            try
+            {
+               state = gcnew VssAsyncTaskState();
+            }
+            catch (...)
+            {
+               VssInstrumentation::CompletePhase(phase, E_FAIL);
+               vssAsync->Release();
+               throw;
+            }
+
+            VssAsyncOperation^ operation = VssAsyncCompletionService::Register(vssAsync, gcnew VssAsyncCompletedCallback(&CompletedWorker), state, phase);
 
             if (cancellationToken.CanBeCanceled)
-               cancellationToken.Register(gcnew Action<Object^>(&CancelWorker), state);
+               state->SetRegistration(cancellationToken.Register(gcnew Action<Object^>(&CancelWorker), operation));
 
-            HRESULT hrResult;
-            hrResult = vssAsync->Wait();
+            return state->Task;
+         }
 
-            if (SUCCEEDED(hrResult))
+         Task^ VssAsyncTaskFactory::AsTask(::IVssAsync* vssAsync, VssPhaseTimer^ phase, CancellationToken cancellationToken, IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, IReadOnlyList<VssWriterStatusInfo^>^ writerStatus)
+         {
+            VssAsyncTaskState^ state;
+            try
             {
-               HRESULT hr = vssAsync->QueryStatus(&hrResult, NULL);
-               if (FAILED(hr))
-                  hrResult = hr;
+               CheckProgressArguments(progress, reportInterval);
+               state = gcnew VssAsyncTaskState(progress, reportInterval, writerStatus);
             }
-
-            delete vssAsyncInfo;
-
-            if (FAILED(hrResult))
-               throw GetExceptionForHr(hrResult);
-            else if (hrResult == VSS_S_ASYNC_CANCELLED)
+            catch (...)
             {
-               throw gcnew OperationCanceledException(cancellationToken);
+               VssInstrumentation::CompletePhase(phase, E_FAIL);
+               vssAsync->Release();
+               throw;
             }
-            else if (hrResult == VSS_S_ASYNC_FINISHED)
-               return;
-            else // this really should not happen
-               throw gcnew InvalidOperationException(String::Format("Operation is not complete. HResult is {0}.", hrResult));
+
+            VssAsyncOperation^ operation = VssAsyncCompletionService::Register(vssAsync, gcnew VssAsyncCompletedCallback(&CompletedWorker), state, phase);
+            state->StartProgress(operation);
+
+            if (cancellationToken.CanBeCanceled)
+               state->SetRegistration(cancellationToken.Register(gcnew Action<Object^>(&CancelWorker), operation));
+
+            return state->Task;
+         }
+
+         void VssAsyncTaskFactory::CheckProgressArguments(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval)
+         {
+            if (progress == nullptr)
+               throw gcnew ArgumentNullException(L"progress");
+
+            if (reportInterval <= TimeSpan::Zero || reportInterval.TotalMilliseconds > MaxReportInterval)
+               throw gcnew ArgumentOutOfRangeException(L"reportInterval", L"The report interval must be greater than zero and no greater than 4294967294 milliseconds.");
+         }
+
+         void VssAsyncTaskFactory::CancelWorker(Object^ state)
+         {
+            VssAsyncOperation^ operation = (VssAsyncOperation^)state;
+            operation->Cancel();
+         }
+
+         void VssAsyncTaskFactory::CompletedWorker(HRESULT hrResult, Object^ state)
+         {
+            VssAsyncTaskState^ taskState = (VssAsyncTaskState^)state;
+            taskState->Complete(hrResult);
          }
       }
    }
-}
\ No newline at end of file
+}
@@ -1,6 +1,9 @@
 #pragma once
 #include "pch.h"
+#include "VssAsyncCompletionService.h"
 
+using namespace System::Collections::Generic;
+using namespace System::Diagnostics;
 using namespace System::Threading::Tasks;
 using namespace System::Threading;
 
@@ -11,35 +14,57 @@ namespace Alphaleonis {
          ref class VssAsyncTaskFactory abstract sealed
          {
          private:
-            ref class VssAsyncInfo
+            ref class VssAsyncTaskState
             {
             private:
-               ::IVssAsync* _vssAsync;
-               CancellationToken _cancellationToken;
+               TaskCompletionSource<Object^>^ _taskCompletionSource;
+               CancellationTokenRegistration _registration;
+               bool _hasRegistration;
+               bool _isCompleted;
                initonly Object^ _lock;
 
-            public:
-               VssAsyncInfo(::IVssAsync* vssAsync, CancellationToken cancellationToken);
-               ~VssAsyncInfo();
-               !VssAsyncInfo();
+               IProgress<VssAsyncProgress^>^ _progress;
+               IReadOnlyList<VssWriterStatusInfo^>^ _writerStatus;
+               TimeSpan _reportInterval;
+               Stopwatch^ _stopwatch;
+               Timer^ _timer;
+               VssAsyncOperation^ _operation;
+               initonly Object^ _reportLock;
 
-               void Cancel();
+               void ReportWorker(Object^ state);
+               void Report(HRESULT hrResult);
 
-               property IVssAsync* VssAsyncPtr {
-                     IVssAsync * get();
-               }
+            public:
+               VssAsyncTaskState();
+               VssAsyncTaskState(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, IReadOnlyList<VssWriterStatusInfo^>^ writerStatus);
+
+               void SetRegistration(CancellationTokenRegistration registration);
+               void Complete(HRESULT hrResult);
+               void StartProgress(VssAsyncOperation^ operation);
 
-               property System::Threading::CancellationToken CancellationToken {
-                  System::Threading::CancellationToken get();
+               property System::Threading::Tasks::Task^ Task {
+                  System::Threading::Tasks::Task^ get();
                }
             };
 
-            static void WaitWorker(Object^ state);
+            static void CompletedWorker(HRESULT hrResult, Object^ state);
             static void CancelWorker(Object^ state);
          public:
-            static Task^ AsTask(::IVssAsync* vssAsync, CancellationToken cancellationToken);
+            // The longest report interval supported, in milliseconds; the longest due time of a System.Threading.Timer.
+            literal double MaxReportInterval = 4294967294.0;
+
+            // Returns a task completing with vssAsync, taking ownership of vssAsync. phase may be null.
+            static Task^ AsTask(::IVssAsync* vssAsync, VssPhaseTimer^ phase, CancellationToken cancellationToken);
+
+            // As above, additionally reporting a VssAsyncProgress sample to progress every reportInterval, and a final 
+            // sample once the operation has completed. writerStatus is the writer status captured before the operation 
+            // was started, reported by every sample, or null if it was not available.
+            static Task^ AsTask(::IVssAsync* vssAsync, VssPhaseTimer^ phase, CancellationToken cancellationToken, IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, IReadOnlyList<VssWriterStatusInfo^>^ writerStatus);
+
+            // Validates the progress arguments of the asynchronous methods. Should be called before the operation is started.
+            static void CheckProgressArguments(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval);
          };
 
       }
    }
-}
\ No newline at end of file
+}
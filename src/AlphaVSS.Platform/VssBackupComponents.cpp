@@ -4,6 +4,10 @@
 #include "VsBackup.h"
 #include "VssBackupComponents.h"
 #include "VssAsyncResult.h"
+#include "VssSnapshotObjectTraits.h"
+#include "WriterMetadataCapture.h"
+
+#include <vcclr.h>
 
 #include "Utils.h"
 #include "Macros.h"
@@ -17,6 +21,7 @@ namespace Alphaleonis {
       {
          VssBackupComponents::VssBackupComponents()
             : m_backup(0),
+            m_lifetimeLock(gcnew Object()),
             m_IVssBackupComponentsEx(0),
             m_IVssBackupComponentsEx2(0),
             m_IVssBackupComponentsEx3(0),
@@ -36,7 +41,21 @@ namespace Alphaleonis {
 
          VssBackupComponents::~VssBackupComponents()
          {
-            this->!VssBackupComponents();
+            // Waits for any completion work using m_backup on another thread.
+            Monitor::Enter(m_lifetimeLock);
+            try
+            {
+               // Disposes the writer metadata and writer components captured by the lists, including those 
+               // discarded by earlier invalidations, which callers may have been using until now.
+               m_writerMetadata->DisposeCapturedItems();
+               m_writerComponents->DisposeCapturedItems();
+               m_writerStatus->DisposeCapturedItems();
+               this->!VssBackupComponents();
+            }
+            finally
+            {
+               Monitor::Exit(m_lifetimeLock);
+            }
          }
 
          VssBackupComponents::!VssBackupComponents()
@@ -75,11 +94,13 @@ namespace Alphaleonis {
 
          void VssBackupComponents::AbortBackup()
          {
+            InvalidateLists();
             CheckCom(m_backup->AbortBackup());
          }
 
          void VssBackupComponents::AddAlternativeLocationMapping(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, String^ path, String^ filespec, bool recursive, String^ destination)
          {
+            m_writerComponents->Invalidate();
             CheckCom(m_backup->AddAlternativeLocationMapping(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType,
                AutoMStr(logicalPath), NoNullAutoMStr(componentName), NoNullAutoMStr(path),
                NoNullAutoMStr(filespec), recursive, NoNullAutoMStr(destination)));
@@ -87,12 +108,63 @@ namespace Alphaleonis {
 
          void VssBackupComponents::AddComponent(Guid instanceId, Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName)
          {
+            m_writerComponents->Invalidate();
             CheckCom(m_backup->AddComponent(ToVssId(instanceId), ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType,
                AutoMStr(logicalPath), NoNullAutoMStr(componentName)));
          }
 
+         IList<VssComponentSelectionFailure^>^ VssBackupComponents::AddComponents(IEnumerable<VssComponentSelection^>^ components)
+         {
+            array<VssComponentSelection^>^ batch = ToComponentBatch(components);
+            List<VssComponentSelectionFailure^>^ failures = gcnew List<VssComponentSelectionFailure^>();
+
+            m_writerComponents->Invalidate();
+            for (int i = 0; i < batch->Length; i++)
+            {
+               VssComponentSelection^ component = batch[i];
+               VSS_ID writerId = ToVssId(component->WriterId);
+               VSS_COMPONENT_TYPE componentType = (VSS_COMPONENT_TYPE)component->ComponentType;
+
+               // Managed strings are null-terminated, so they are passed to VSS in place, pinned for the 
+               // duration of the calls, rather than copied to unmanaged memory as AutoMStr would.
+               pin_ptr<const wchar_t> logicalPath = PtrToStringChars(component->LogicalPath);
+               pin_ptr<const wchar_t> componentName = PtrToStringChars(component->ComponentName);
+
+               // Each COM call is timed on its own, as CheckCom would.
+               ComCallTimer addTimer(__FUNCTION__);
+               HRESULT hr = m_backup->AddComponent(ToVssId(component->InstanceId), writerId, componentType, logicalPath, componentName);
+               addTimer.Complete(hr);
+
+               if (SUCCEEDED(hr) && component->BackupOptions != nullptr)
+               {
+                  pin_ptr<const wchar_t> backupOptions = PtrToStringChars(component->BackupOptions);
+                  ComCallTimer optionsTimer(__FUNCTION__);
+                  hr = m_backup->SetBackupOptions(writerId, componentType, logicalPath, componentName, backupOptions);
+                  optionsTimer.Complete(hr);
+               }
+
+               if (SUCCEEDED(hr) && component->PreviousBackupStamp != nullptr)
+               {
+                  pin_ptr<const wchar_t> previousBackupStamp = PtrToStringChars(component->PreviousBackupStamp);
+                  ComCallTimer stampTimer(__FUNCTION__);
+                  hr = m_backup->SetPreviousBackupStamp(writerId, componentType, logicalPath, componentName, previousBackupStamp);
+                  stampTimer.Complete(hr);
+               }
+
+               // A bad state concerns the backup components object rather than the component, and stops the batch.
+               if (hr == VSS_E_BAD_STATE)
+                  ThrowException(hr);
+
+               if (FAILED(hr))
+                  failures->Add(gcnew VssComponentSelectionFailure(i, component, GetExceptionForHr(hr)));
+            }
+
+            return failures->AsReadOnly();
+         }
+
          void VssBackupComponents::AddNewTarget(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, String^ path, String^ fileName, bool recursive, String^ alternatePath)
          {
+            m_writerComponents->Invalidate();
             CheckCom(m_backup->AddNewTarget(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType,
                AutoMStr(logicalPath), NoNullAutoMStr(componentName),
                NoNullAutoMStr(path), NoNullAutoMStr(fileName),
@@ -101,6 +173,7 @@ namespace Alphaleonis {
 
          void VssBackupComponents::AddRestoreSubcomponent(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, String^ subcomponentLogicalPath, String^ subcomponentName)
          {
+            m_writerComponents->Invalidate();
             CheckCom(m_backup->AddRestoreSubcomponent(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType,
                AutoMStr(logicalPath),
                NoNullAutoMStr(componentName),
@@ -126,29 +199,55 @@ namespace Alphaleonis {
          [SecurityPermissionAttribute(SecurityAction::LinkDemand)]
          void VssBackupComponents::BackupComplete()
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->BackupComplete(&pAsync));
-            WaitCheckAndReleaseVssAsyncOperation(pAsync);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"BackupComplete");
+            CheckComPhase(phase, m_backup->BackupComplete(&pAsync));
+            WaitCheckAndReleaseVssAsyncOperation(pAsync, phase);
+            ReportWriterCounts();
          }
 
          Task^ VssBackupComponents::BackupCompleteAsync(CancellationToken cancellationToken)
          {
+            InvalidateLists();
+            ::IVssAsync* pAsync;
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"BackupComplete");
+            CheckComPhase(phase, m_backup->BackupComplete(&pAsync));
+            return InvalidateListsOnCompletion(VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken));
+         }
+
+         Task^ VssBackupComponents::BackupCompleteAsync(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+         {
+            VssAsyncTaskFactory::CheckProgressArguments(progress, reportInterval);
+            IReadOnlyList<VssWriterStatusInfo^>^ writerStatus = CaptureWriterStatus();
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->BackupComplete(&pAsync));
-            return VssAsyncTaskFactory::AsTask(pAsync, cancellationToken);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"BackupComplete");
+            CheckComPhase(phase, m_backup->BackupComplete(&pAsync));
+            return InvalidateListsOnCompletion(VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken, progress, reportInterval, writerStatus));
          }
 
          IVssAsyncResult^ VssBackupComponents::BeginBackupComplete(AsyncCallback^ userCallback, Object^ stateObject)
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->BackupComplete(&pAsync));
-            return VssAsyncResult::Create(pAsync, userCallback, stateObject);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"BackupComplete");
+            CheckComPhase(phase, m_backup->BackupComplete(&pAsync));
+            return VssAsyncResult::Create(pAsync, phase, userCallback, stateObject);
          }
 
          void VssBackupComponents::EndBackupComplete(IAsyncResult^ asyncResult)
          {
             VssAsyncResult^ result = safe_cast<VssAsyncResult^>(asyncResult);
-            result->EndInvoke();
+            try
+            {
+               result->EndInvoke();
+            }
+            finally
+            {
+               InvalidateLists();
+               ReportWriterCounts();
+            }
          }
 
          void VssBackupComponents::BreakSnapshotSet(Guid snapshotSetId)
@@ -159,22 +258,25 @@ namespace Alphaleonis {
          void VssBackupComponents::BreakSnapshotSet(Guid snapshotSetId, VssHardwareOptions breakFlags)
          {
             ::IVssAsync* pAsync;
-            CheckCom(RequireIVssBackupComponentsEx2()->BreakSnapshotSetEx(ToVssId(snapshotSetId), (_VSS_HARDWARE_OPTIONS)breakFlags, &pAsync));
-            WaitCheckAndReleaseVssAsyncOperation(pAsync);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"BreakSnapshotSet");
+            CheckComPhase(phase, RequireIVssBackupComponentsEx2()->BreakSnapshotSetEx(ToVssId(snapshotSetId), (_VSS_HARDWARE_OPTIONS)breakFlags, &pAsync));
+            WaitCheckAndReleaseVssAsyncOperation(pAsync, phase);
          }
 
          Task^ VssBackupComponents::BreakSnapshotSetAsync(Guid snapshotSetId, VssHardwareOptions breakFlags, CancellationToken cancellationToken)
          {
             ::IVssAsync* pAsync;
-            CheckCom(RequireIVssBackupComponentsEx2()->BreakSnapshotSetEx(ToVssId(snapshotSetId), (_VSS_HARDWARE_OPTIONS)breakFlags, &pAsync));
-            return VssAsyncTaskFactory::AsTask(pAsync, cancellationToken);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"BreakSnapshotSet");
+            CheckComPhase(phase, RequireIVssBackupComponentsEx2()->BreakSnapshotSetEx(ToVssId(snapshotSetId), (_VSS_HARDWARE_OPTIONS)breakFlags, &pAsync));
+            return VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken);
          }
 
          IVssAsyncResult^ VssBackupComponents::BeginBreakSnapshotSet(Guid snapshotSetId, VssHardwareOptions breakFlags, AsyncCallback^ userCallback, Object^ stateObject)
          {
             ::IVssAsync* pAsync;
-            CheckCom(RequireIVssBackupComponentsEx2()->BreakSnapshotSetEx(ToVssId(snapshotSetId), (_VSS_HARDWARE_OPTIONS)breakFlags, &pAsync));
-            return VssAsyncResult::Create(pAsync, userCallback, stateObject);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"BreakSnapshotSet");
+            CheckComPhase(phase, RequireIVssBackupComponentsEx2()->BreakSnapshotSetEx(ToVssId(snapshotSetId), (_VSS_HARDWARE_OPTIONS)breakFlags, &pAsync));
+            return VssAsyncResult::Create(pAsync, phase, userCallback, stateObject);
          }
 
          void VssBackupComponents::EndBreakSnapshotSet(IAsyncResult^ asyncResult)
@@ -216,29 +318,55 @@ namespace Alphaleonis {
 
          void VssBackupComponents::DoSnapshotSet()
          {
+            InvalidateLists();
             ::IVssAsync* vssAsync;
-            CheckCom(m_backup->DoSnapshotSet(&vssAsync));
-            WaitCheckAndReleaseVssAsyncOperation(vssAsync);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"DoSnapshotSet");
+            CheckComPhase(phase, m_backup->DoSnapshotSet(&vssAsync));
+            WaitCheckAndReleaseVssAsyncOperation(vssAsync, phase);
+            ReportWriterCounts();
          }
 
          Task^ VssBackupComponents::DoSnapshotSetAsync(CancellationToken cancellationToken)
          {
+            InvalidateLists();
             ::IVssAsync* vssAsync;
-            CheckCom(m_backup->DoSnapshotSet(&vssAsync));
-            return VssAsyncTaskFactory::AsTask(vssAsync, cancellationToken);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"DoSnapshotSet");
+            CheckComPhase(phase, m_backup->DoSnapshotSet(&vssAsync));
+            return InvalidateListsOnCompletion(VssAsyncTaskFactory::AsTask(vssAsync, phase, cancellationToken));
+         }
+
+         Task^ VssBackupComponents::DoSnapshotSetAsync(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+         {
+            VssAsyncTaskFactory::CheckProgressArguments(progress, reportInterval);
+            IReadOnlyList<VssWriterStatusInfo^>^ writerStatus = CaptureWriterStatus();
+            InvalidateLists();
+            ::IVssAsync* vssAsync;
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"DoSnapshotSet");
+            CheckComPhase(phase, m_backup->DoSnapshotSet(&vssAsync));
+            return InvalidateListsOnCompletion(VssAsyncTaskFactory::AsTask(vssAsync, phase, cancellationToken, progress, reportInterval, writerStatus));
          }
 
          IVssAsyncResult^ VssBackupComponents::BeginDoSnapshotSet(AsyncCallback^ userCallback, Object^ stateObject)
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->DoSnapshotSet(&pAsync));
-            return VssAsyncResult::Create(pAsync, userCallback, stateObject);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"DoSnapshotSet");
+            CheckComPhase(phase, m_backup->DoSnapshotSet(&pAsync));
+            return VssAsyncResult::Create(pAsync, phase, userCallback, stateObject);
          }
 
          void VssBackupComponents::EndDoSnapshotSet(IAsyncResult^ asyncResult)
          {
             VssAsyncResult^ result = safe_cast<VssAsyncResult^>(asyncResult);
-            result->EndInvoke();
+            try
+            {
+               result->EndInvoke();
+            }
+            finally
+            {
+               InvalidateLists();
+               ReportWriterCounts();
+            }
          }
 
          void VssBackupComponents::EnableWriterClasses(array<Guid>^ writerClassIds)
@@ -258,66 +386,120 @@ namespace Alphaleonis {
 
          void VssBackupComponents::FreeWriterMetadata()
          {
+            InvalidateLists();
             CheckCom(m_backup->FreeWriterMetadata());
          }
 
          void VssBackupComponents::FreeWriterStatus()
          {
+            InvalidateLists();
             CheckCom(m_backup->FreeWriterStatus());
          }
 
          void VssBackupComponents::GatherWriterMetadata()
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->GatherWriterMetadata(&pAsync));
-            WaitCheckAndReleaseVssAsyncOperation(pAsync);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"GatherWriterMetadata");
+            CheckComPhase(phase, m_backup->GatherWriterMetadata(&pAsync));
+            WaitCheckAndReleaseVssAsyncOperation(pAsync, phase);
+            ReportWriterCounts();
          }
 
          Task^ VssBackupComponents::GatherWriterMetadataAsync(CancellationToken cancellationToken)
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->GatherWriterMetadata(&pAsync));
-            return VssAsyncTaskFactory::AsTask(pAsync, cancellationToken);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"GatherWriterMetadata");
+            CheckComPhase(phase, m_backup->GatherWriterMetadata(&pAsync));
+            return InvalidateListsOnCompletion(VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken));
+         }
+
+         Task^ VssBackupComponents::GatherWriterMetadataAsync(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+         {
+            VssAsyncTaskFactory::CheckProgressArguments(progress, reportInterval);
+            IReadOnlyList<VssWriterStatusInfo^>^ writerStatus = CaptureWriterStatus();
+            InvalidateLists();
+            ::IVssAsync* pAsync;
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"GatherWriterMetadata");
+            CheckComPhase(phase, m_backup->GatherWriterMetadata(&pAsync));
+            return InvalidateListsOnCompletion(VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken, progress, reportInterval, writerStatus));
          }
 
          IVssAsyncResult^ VssBackupComponents::BeginGatherWriterMetadata(AsyncCallback^ userCallback, Object^ stateObject)
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->GatherWriterMetadata(&pAsync));
-            return VssAsyncResult::Create(pAsync, userCallback, stateObject);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"GatherWriterMetadata");
+            CheckComPhase(phase, m_backup->GatherWriterMetadata(&pAsync));
+            return VssAsyncResult::Create(pAsync, phase, userCallback, stateObject);
          }
 
          void VssBackupComponents::EndGatherWriterMetadata(IAsyncResult^ asyncResult)
          {
             VssAsyncResult^ result = safe_cast<VssAsyncResult^>(asyncResult);
-            result->EndInvoke();
+            try
+            {
+               result->EndInvoke();
+            }
+            finally
+            {
+               InvalidateLists();
+               ReportWriterCounts();
+            }
          }
 
          void VssBackupComponents::GatherWriterStatus()
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->GatherWriterStatus(&pAsync));
-            WaitCheckAndReleaseVssAsyncOperation(pAsync);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"GatherWriterStatus");
+            CheckComPhase(phase, m_backup->GatherWriterStatus(&pAsync));
+            WaitCheckAndReleaseVssAsyncOperation(pAsync, phase);
+            ReportWriterCounts();
          }
 
          Task^ VssBackupComponents::GatherWriterStatusAsync(CancellationToken cancellationToken)
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->GatherWriterStatus(&pAsync));
-            return VssAsyncTaskFactory::AsTask(pAsync, cancellationToken);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"GatherWriterStatus");
+            CheckComPhase(phase, m_backup->GatherWriterStatus(&pAsync));
+            return InvalidateListsOnCompletion(VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken));
+         }
+
+         Task^ VssBackupComponents::GatherWriterStatusAsync(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+         {
+            VssAsyncTaskFactory::CheckProgressArguments(progress, reportInterval);
+            IReadOnlyList<VssWriterStatusInfo^>^ writerStatus = CaptureWriterStatus();
+            InvalidateLists();
+            ::IVssAsync* pAsync;
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"GatherWriterStatus");
+            CheckComPhase(phase, m_backup->GatherWriterStatus(&pAsync));
+            return InvalidateListsOnCompletion(VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken, progress, reportInterval, writerStatus));
          }
 
          IVssAsyncResult^ VssBackupComponents::BeginGatherWriterStatus(AsyncCallback^ userCallback, Object^ stateObject)
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->GatherWriterStatus(&pAsync));
-            return VssAsyncResult::Create(pAsync, userCallback, stateObject);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"GatherWriterStatus");
+            CheckComPhase(phase, m_backup->GatherWriterStatus(&pAsync));
+            return VssAsyncResult::Create(pAsync, phase, userCallback, stateObject);
          }
 
          void VssBackupComponents::EndGatherWriterStatus(IAsyncResult^ asyncResult)
          {
             VssAsyncResult^ result = safe_cast<VssAsyncResult^>(asyncResult);
-            result->EndInvoke();
+            try
+            {
+               result->EndInvoke();
+            }
+            finally
+            {
+               InvalidateLists();
+               ReportWriterCounts();
+            }
          }
 
          VssSnapshotProperties^ VssBackupComponents::GetSnapshotProperties(Guid snapshotId)
@@ -332,7 +514,7 @@ namespace Alphaleonis {
          {
          }
 
-         int VssBackupComponents::WriterStatusList::Count::get()
+         int VssBackupComponents::WriterStatusList::GetCount()
          {
             if (m_backupComponents->m_backup == 0)
                throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
@@ -342,11 +524,8 @@ namespace Alphaleonis {
             return (int)cWriters;
          }
 
-         VssWriterStatusInfo^ VssBackupComponents::WriterStatusList::default::get(int index)
+         VssWriterStatusInfo^ VssBackupComponents::WriterStatusList::GetItem(int index)
          {
-            if (index < 0 || index > Count)
-               throw gcnew ArgumentOutOfRangeException("index");
-
             if (m_backupComponents->m_backup == 0)
                throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
@@ -374,7 +553,7 @@ namespace Alphaleonis {
          {
          }
 
-         int VssBackupComponents::WriterComponentsList::Count::get()
+         int VssBackupComponents::WriterComponentsList::GetCount()
          {
             if (m_backupComponents->m_backup == 0)
                throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
@@ -384,17 +563,14 @@ namespace Alphaleonis {
             return (int)cComponent;
          }
 
-         IVssWriterComponents^ VssBackupComponents::WriterComponentsList::default::get(int index)
+         IVssWriterComponents^ VssBackupComponents::WriterComponentsList::GetItem(int index)
          {
-            if (index < 0 || index > Count)
-               throw gcnew ArgumentOutOfRangeException("index");
-
             if (m_backupComponents->m_backup == 0)
                throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
             IVssWriterComponentsExt* pWriterComponents;
             CheckCom(m_backupComponents->m_backup->GetWriterComponents(index, &pWriterComponents));
-            return VssWriterComponents::Adopt(pWriterComponents);
+            return VssWriterComponents::Adopt(pWriterComponents, MaterializeOnRead);
          }
 
          VssBackupComponents::WriterMetadataList::WriterMetadataList(VssBackupComponents^ backupComponents)
@@ -402,7 +578,7 @@ namespace Alphaleonis {
          {
          }
 
-         int VssBackupComponents::WriterMetadataList::Count::get()
+         int VssBackupComponents::WriterMetadataList::GetCount()
          {
             if (m_backupComponents->m_backup == 0)
                throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
@@ -412,11 +588,8 @@ namespace Alphaleonis {
             return (int)iCount;
          }
 
-         IVssExamineWriterMetadata^ VssBackupComponents::WriterMetadataList::default::get(int index)
+         IVssExamineWriterMetadata^ VssBackupComponents::WriterMetadataList::GetItem(int index)
          {
-            if (index < 0 || index > Count)
-               throw gcnew ArgumentOutOfRangeException("index");
-
             if (m_backupComponents->m_backup == 0)
                throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
@@ -431,6 +604,14 @@ namespace Alphaleonis {
             return m_writerMetadata;
          }
 
+         IList<VssCapturedWriterMetadata^>^ VssBackupComponents::CaptureWriterMetadata()
+         {
+            if (m_backup == 0)
+               throw gcnew ObjectDisposedException(GetType()->Name);
+
+            return (gcnew WriterMetadataCapture())->CaptureAll(m_backup);
+         }
+
          IList<IVssWriterComponents^>^ VssBackupComponents::WriterComponents::get()
          {
             return m_writerComponents;
@@ -441,25 +622,126 @@ namespace Alphaleonis {
             return m_writerStatus;
          }
 
+         bool VssBackupComponents::MaterializeCollections::get()
+         {
+            return m_writerMetadata->MaterializeOnRead;
+         }
+
+         void VssBackupComponents::MaterializeCollections::set(bool value)
+         {
+            m_writerMetadata->MaterializeOnRead = value;
+            m_writerComponents->MaterializeOnRead = value;
+            m_writerStatus->MaterializeOnRead = value;
+         }
+
+         void VssBackupComponents::InvalidateLists()
+         {
+            m_writerMetadata->Invalidate();
+            m_writerComponents->Invalidate();
+            m_writerStatus->Invalidate();
+         }
+
+         Task^ VssBackupComponents::InvalidateListsOnCompletion(Task^ task)
+         {
+            // Registered before the task is handed to the caller, so this runs ahead of any 
+            // continuation the caller attaches.
+            task->ContinueWith(gcnew Action<Task^>(this, &VssBackupComponents::OnListSourceOperationCompleted), TaskContinuationOptions::ExecuteSynchronously);
+            return task;
+         }
+
+         void VssBackupComponents::OnListSourceOperationCompleted(Task^ task)
+         {
+            Monitor::Enter(m_lifetimeLock);
+            try
+            {
+               if (m_backup == 0)
+                  return;
+
+               InvalidateLists();
+               ReportWriterCounts();
+            }
+            finally
+            {
+               Monitor::Exit(m_lifetimeLock);
+            }
+         }
+
+         array<VssComponentSelection^>^ VssBackupComponents::ToComponentBatch(IEnumerable<VssComponentSelection^>^ components)
+         {
+            if (components == nullptr)
+               throw gcnew ArgumentNullException("components");
+
+            // The batch is copied and validated up front, so that no component is processed if it is invalid. The 
+            // strings of the components are passed to VSS as is, bypassing the checks of NoNullAutoMStr.
+            array<VssComponentSelection^>^ batch = (gcnew List<VssComponentSelection^>(components))->ToArray();
+            for (int i = 0; i < batch->Length; i++)
+            {
+               if (batch[i] == nullptr)
+                  throw gcnew ArgumentException(String::Format("The component batch contains a null element at index {0}.", i), "components");
+
+               if (batch[i]->ComponentName == nullptr)
+                  throw gcnew ArgumentException(String::Format("The component at index {0} of the batch has no component name.", i), "components");
+            }
+
+            return batch;
+         }
+
+         void VssBackupComponents::ReportWriterCounts()
+         {
+            if (m_backup == 0 || !VssEventSource::Log->IsEnabled(EventLevel::Informational, VssEventSource::Keywords::Writers))
+               return;
+
+            // Either count is unavailable in some states of the backup (e.g. before writer status has been gathered), 
+            // which is reported as -1 rather than as an error.
+            UINT writerMetadataCount;
+            if (FAILED(m_backup->GetWriterMetadataCount(&writerMetadataCount)))
+               writerMetadataCount = (UINT)-1;
+
+            UINT writerStatusCount;
+            if (FAILED(m_backup->GetWriterStatusCount(&writerStatusCount)))
+               writerStatusCount = (UINT)-1;
+
+            VssEventSource::Log->WriterCounts((int)writerMetadataCount, (int)writerStatusCount);
+         }
+
+         IReadOnlyList<VssWriterStatusInfo^>^ VssBackupComponents::CaptureWriterStatus()
+         {
+            // Called on the calling thread before an operation reporting progress is started, since retrieving the writer 
+            // status from a timer thread would call VSS concurrently with the operation. Every sample reports this copy.
+            try
+            {
+               return Array::AsReadOnly(m_writerStatus->ToArray());
+            }
+            catch (VssException^)
+            {
+               // Writer status is not available before it has been gathered. A sample without writer status is 
+               // preferable to failing the operation in that case.
+               return nullptr;
+            }
+         }
+
          void VssBackupComponents::ImportSnapshots()
          {
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->ImportSnapshots(&pAsync));
-            WaitCheckAndReleaseVssAsyncOperation(pAsync);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"ImportSnapshots");
+            CheckComPhase(phase, m_backup->ImportSnapshots(&pAsync));
+            WaitCheckAndReleaseVssAsyncOperation(pAsync, phase);
          }
          
          Task^ VssBackupComponents::ImportSnapshotsAsync(CancellationToken cancellationToken)
          {
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->ImportSnapshots(&pAsync));
-            return VssAsyncTaskFactory::AsTask(pAsync, cancellationToken);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"ImportSnapshots");
+            CheckComPhase(phase, m_backup->ImportSnapshots(&pAsync));
+            return VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken);
          }
 
          IVssAsyncResult^ VssBackupComponents::BeginImportSnapshots(AsyncCallback^ userCallback, Object^ stateObject)
          {
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->ImportSnapshots(&pAsync));
-            return VssAsyncResult::Create(pAsync, userCallback, stateObject);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"ImportSnapshots");
+            CheckComPhase(phase, m_backup->ImportSnapshots(&pAsync));
+            return VssAsyncResult::Create(pAsync, phase, userCallback, stateObject);
          }
 
          void VssBackupComponents::EndImportSnapshots(IAsyncResult^ asyncResult)
@@ -470,11 +752,13 @@ namespace Alphaleonis {
 
          void VssBackupComponents::InitializeForBackup(String^ xml)
          {
+            InvalidateLists();
             CheckCom(m_backup->InitializeForBackup(AutoMBStr(xml)));
          }
 
          void VssBackupComponents::InitializeForRestore(String^ xml)
          {
+            InvalidateLists();
             CheckCom(m_backup->InitializeForRestore(NoNullAutoMBStr(xml)));
          }
 
@@ -494,116 +778,191 @@ namespace Alphaleonis {
 
          void VssBackupComponents::PostRestore()
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->PostRestore(&pAsync));
-            WaitCheckAndReleaseVssAsyncOperation(pAsync);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"PostRestore");
+            CheckComPhase(phase, m_backup->PostRestore(&pAsync));
+            WaitCheckAndReleaseVssAsyncOperation(pAsync, phase);
+            ReportWriterCounts();
          }
 
          Task^ VssBackupComponents::PostRestoreAsync(CancellationToken cancellationToken)
          {
+            InvalidateLists();
+            ::IVssAsync* pAsync;
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"PostRestore");
+            CheckComPhase(phase, m_backup->PostRestore(&pAsync));
+            return InvalidateListsOnCompletion(VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken));
+         }
+
+         Task^ VssBackupComponents::PostRestoreAsync(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+         {
+            VssAsyncTaskFactory::CheckProgressArguments(progress, reportInterval);
+            IReadOnlyList<VssWriterStatusInfo^>^ writerStatus = CaptureWriterStatus();
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->PostRestore(&pAsync));
-            return VssAsyncTaskFactory::AsTask(pAsync, cancellationToken);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"PostRestore");
+            CheckComPhase(phase, m_backup->PostRestore(&pAsync));
+            return InvalidateListsOnCompletion(VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken, progress, reportInterval, writerStatus));
          }
 
          IVssAsyncResult^ VssBackupComponents::BeginPostRestore(AsyncCallback^ userCallback, Object^ stateObject)
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->PostRestore(&pAsync));
-            return VssAsyncResult::Create(pAsync, userCallback, stateObject);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"PostRestore");
+            CheckComPhase(phase, m_backup->PostRestore(&pAsync));
+            return VssAsyncResult::Create(pAsync, phase, userCallback, stateObject);
          }
 
          void VssBackupComponents::EndPostRestore(IAsyncResult^ asyncResult)
          {
             VssAsyncResult^ result = safe_cast<VssAsyncResult^>(asyncResult);
-            result->EndInvoke();
+            try
+            {
+               result->EndInvoke();
+            }
+            finally
+            {
+               InvalidateLists();
+               ReportWriterCounts();
+            }
          }
 
          void VssBackupComponents::PrepareForBackup()
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->PrepareForBackup(&pAsync));
-            WaitCheckAndReleaseVssAsyncOperation(pAsync);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"PrepareForBackup");
+            CheckComPhase(phase, m_backup->PrepareForBackup(&pAsync));
+            WaitCheckAndReleaseVssAsyncOperation(pAsync, phase);
+            ReportWriterCounts();
          }
 
          Task^ VssBackupComponents::PrepareForBackupAsync(CancellationToken cancellationToken)
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->PrepareForBackup(&pAsync));
-            return VssAsyncTaskFactory::AsTask(pAsync, cancellationToken);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"PrepareForBackup");
+            CheckComPhase(phase, m_backup->PrepareForBackup(&pAsync));
+            return InvalidateListsOnCompletion(VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken));
+         }
+
+         Task^ VssBackupComponents::PrepareForBackupAsync(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+         {
+            VssAsyncTaskFactory::CheckProgressArguments(progress, reportInterval);
+            IReadOnlyList<VssWriterStatusInfo^>^ writerStatus = CaptureWriterStatus();
+            InvalidateLists();
+            ::IVssAsync* pAsync;
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"PrepareForBackup");
+            CheckComPhase(phase, m_backup->PrepareForBackup(&pAsync));
+            return InvalidateListsOnCompletion(VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken, progress, reportInterval, writerStatus));
          }
 
          IVssAsyncResult^ VssBackupComponents::BeginPrepareForBackup(AsyncCallback^ userCallback, Object^ stateObject)
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->PrepareForBackup(&pAsync));
-            return VssAsyncResult::Create(pAsync, userCallback, stateObject);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"PrepareForBackup");
+            CheckComPhase(phase, m_backup->PrepareForBackup(&pAsync));
+            return VssAsyncResult::Create(pAsync, phase, userCallback, stateObject);
          }
 
          void VssBackupComponents::EndPrepareForBackup(IAsyncResult^ asyncResult)
          {
             VssAsyncResult^ result = safe_cast<VssAsyncResult^>(asyncResult);
-            result->EndInvoke();
+            try
+            {
+               result->EndInvoke();
+            }
+            finally
+            {
+               InvalidateLists();
+               ReportWriterCounts();
+            }
          }
 
          void VssBackupComponents::PreRestore()
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->PreRestore(&pAsync));
-            WaitCheckAndReleaseVssAsyncOperation(pAsync);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"PreRestore");
+            CheckComPhase(phase, m_backup->PreRestore(&pAsync));
+            WaitCheckAndReleaseVssAsyncOperation(pAsync, phase);
+            ReportWriterCounts();
          }
 
          Task^ VssBackupComponents::PreRestoreAsync(CancellationToken cancellationToken)
          {
+            InvalidateLists();
+            ::IVssAsync* pAsync;
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"PreRestore");
+            CheckComPhase(phase, m_backup->PreRestore(&pAsync));
+            return InvalidateListsOnCompletion(VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken));
+         }
+
+         Task^ VssBackupComponents::PreRestoreAsync(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+         {
+            VssAsyncTaskFactory::CheckProgressArguments(progress, reportInterval);
+            IReadOnlyList<VssWriterStatusInfo^>^ writerStatus = CaptureWriterStatus();
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->PreRestore(&pAsync));
-            return VssAsyncTaskFactory::AsTask(pAsync, cancellationToken);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"PreRestore");
+            CheckComPhase(phase, m_backup->PreRestore(&pAsync));
+            return InvalidateListsOnCompletion(VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken, progress, reportInterval, writerStatus));
          }
 
          IVssAsyncResult^ VssBackupComponents::BeginPreRestore(AsyncCallback^ userCallback, Object^ stateObject)
          {
+            InvalidateLists();
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->PreRestore(&pAsync));
-            return VssAsyncResult::Create(pAsync, userCallback, stateObject);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"PreRestore");
+            CheckComPhase(phase, m_backup->PreRestore(&pAsync));
+            return VssAsyncResult::Create(pAsync, phase, userCallback, stateObject);
          }
 
          void VssBackupComponents::EndPreRestore(IAsyncResult^ asyncResult)
          {
             VssAsyncResult^ result = safe_cast<VssAsyncResult^>(asyncResult);
-            result->EndInvoke();
+            try
+            {
+               result->EndInvoke();
+            }
+            finally
+            {
+               InvalidateLists();
+               ReportWriterCounts();
+            }
          }
 
          IEnumerable<VssSnapshotProperties^>^ VssBackupComponents::QuerySnapshots()
          {
             IVssEnumObject* pEnum;
-            VSS_OBJECT_PROP rgelt;
-            ULONG celtFetched = 0;
-            IList<VssSnapshotProperties^>^ list = gcnew List<VssSnapshotProperties^>();
-
             CheckCom(m_backup->Query(GUID_NULL, VSS_OBJECT_NONE, VSS_OBJECT_SNAPSHOT, &pEnum));
 
+            // The snapshots are still fetched in batches, but all of them are retrieved before returning, so that errors 
+            // are thrown from this method and the list returned can be enumerated any number of times.
+            SnapshotEnumerable^ enumerable = gcnew SnapshotEnumerable(pEnum, SnapshotEnumerable::DefaultBatchSize);
             try
             {
-               while (true)
-               {
-                  CheckCom(pEnum->Next(1, &rgelt, &celtFetched));
-
-                  if (celtFetched == 0)
-                     return list;
-
-                  // Should always be snapshot, but just in case it isn't, we simply skip it.
-                  if (rgelt.Type == VSS_OBJECT_SNAPSHOT)
-                  {
-                     list->Add(CreateVssSnapshotProperties(&rgelt.Obj.Snap));
-                  }
-               }
+               return gcnew List<VssSnapshotProperties^>(enumerable);
             }
             finally
             {
-               pEnum->Release();
+               delete enumerable;
             }
          }
 
+         IEnumerable<VssSnapshotProperties^>^ VssBackupComponents::QuerySnapshots(int batchSize)
+         {
+            if (batchSize < 1)
+               throw gcnew ArgumentOutOfRangeException("batchSize", "The batch size must be greater than zero.");
+
+            IVssEnumObject* pEnum;
+            CheckCom(m_backup->Query(GUID_NULL, VSS_OBJECT_NONE, VSS_OBJECT_SNAPSHOT, &pEnum));
+            return gcnew SnapshotEnumerable(pEnum, batchSize);
+         }
+
          IEnumerable<VssProviderProperties^>^ VssBackupComponents::QueryProviders()
          {
             IVssEnumObject* pEnum;
@@ -638,16 +997,18 @@ namespace Alphaleonis {
          Task^ VssBackupComponents::QueryRevertStatusAsync(String^ volume, CancellationToken cancellationToken)
          {
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->QueryRevertStatus(NoNullAutoMStr(volume), &pAsync));
-            return VssAsyncTaskFactory::AsTask(pAsync, cancellationToken);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"QueryRevertStatus");
+            CheckComPhase(phase, m_backup->QueryRevertStatus(NoNullAutoMStr(volume), &pAsync));
+            return VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken);
          }
 
 
          IVssAsyncResult^ VssBackupComponents::BeginQueryRevertStatus(String^ volume, AsyncCallback^ userCallback, Object^ stateObject)
          {
             ::IVssAsync* pAsync;
-            CheckCom(m_backup->QueryRevertStatus(NoNullAutoMStr(volume), &pAsync));
-            return VssAsyncResult::Create(pAsync, userCallback, stateObject);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"QueryRevertStatus");
+            CheckComPhase(phase, m_backup->QueryRevertStatus(NoNullAutoMStr(volume), &pAsync));
+            return VssAsyncResult::Create(pAsync, phase, userCallback, stateObject);
          }
 
          void VssBackupComponents::EndQueryRevertStatus(IAsyncResult^ asyncResult)
@@ -671,21 +1032,25 @@ namespace Alphaleonis {
 
          void VssBackupComponents::SetAdditionalRestores(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, bool additionalResources)
          {
+            m_writerComponents->Invalidate();
             CheckCom(m_backup->SetAdditionalRestores(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), additionalResources));
          }
 
          void VssBackupComponents::SetAuthoritativeRestore(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, bool isAuthorative)
          {
+            m_writerComponents->Invalidate();
             CheckCom(RequireIVssBackupComponentsEx2()->SetAuthoritativeRestore(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), isAuthorative));
          }
 
          void VssBackupComponents::SetRestoreName(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, String^ restoreName)
          {
+            m_writerComponents->Invalidate();
             CheckCom(RequireIVssBackupComponentsEx2()->SetRestoreName(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), NoNullAutoMStr(restoreName)));
          }
 
          void VssBackupComponents::SetBackupOptions(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, String^ backupOptions)
          {
+            m_writerComponents->Invalidate();
             CheckCom(m_backup->SetBackupOptions(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), NoNullAutoMStr(backupOptions)));
          }
 
@@ -696,9 +1061,37 @@ namespace Alphaleonis {
 
          void VssBackupComponents::SetBackupSucceeded(Guid instanceId, Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, bool succeeded)
          {
+            m_writerComponents->Invalidate();
             CheckCom(m_backup->SetBackupSucceeded(ToVssId(instanceId), ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), succeeded));
          }
 
+         IList<VssComponentSelectionFailure^>^ VssBackupComponents::SetBackupSucceeded(IEnumerable<VssComponentSelection^>^ components, bool succeeded)
+         {
+            array<VssComponentSelection^>^ batch = ToComponentBatch(components);
+            List<VssComponentSelectionFailure^>^ failures = gcnew List<VssComponentSelectionFailure^>();
+
+            m_writerComponents->Invalidate();
+            for (int i = 0; i < batch->Length; i++)
+            {
+               VssComponentSelection^ component = batch[i];
+               pin_ptr<const wchar_t> logicalPath = PtrToStringChars(component->LogicalPath);
+               pin_ptr<const wchar_t> componentName = PtrToStringChars(component->ComponentName);
+
+               ComCallTimer timer(__FUNCTION__);
+               HRESULT hr = m_backup->SetBackupSucceeded(ToVssId(component->InstanceId), ToVssId(component->WriterId),
+                  (VSS_COMPONENT_TYPE)component->ComponentType, logicalPath, componentName, succeeded);
+               timer.Complete(hr);
+
+               if (hr == VSS_E_BAD_STATE)
+                  ThrowException(hr);
+
+               if (FAILED(hr))
+                  failures->Add(gcnew VssComponentSelectionFailure(i, component, GetExceptionForHr(hr)));
+            }
+
+            return failures->AsReadOnly();
+         }
+
          void VssBackupComponents::SetContext(VssVolumeSnapshotAttributes context)
          {
             CheckCom(m_backup->SetContext((LONG)context));
@@ -711,21 +1104,25 @@ namespace Alphaleonis {
 
          void VssBackupComponents::SetFileRestoreStatus(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, VssFileRestoreStatus status)
          {
+            m_writerComponents->Invalidate();
             CheckCom(m_backup->SetFileRestoreStatus(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), (VSS_FILE_RESTORE_STATUS)status));
          }
 
          void VssBackupComponents::SetPreviousBackupStamp(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, String^ previousBackupStamp)
          {
+            m_writerComponents->Invalidate();
             CheckCom(m_backup->SetPreviousBackupStamp(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), NoNullAutoMStr(previousBackupStamp)));
          }
 
          void VssBackupComponents::SetRangesFilePath(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, int partialFileIndex, String^ rangesFile)
          {
+            m_writerComponents->Invalidate();
             CheckCom(m_backup->SetRangesFilePath(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), partialFileIndex, NoNullAutoMStr(rangesFile)));
          }
 
          void VssBackupComponents::SetRestoreOptions(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, String^ restoreOptions)
          {
+            m_writerComponents->Invalidate();
             CheckCom(m_backup->SetRestoreOptions(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), NoNullAutoMStr(restoreOptions)));
          }
 
@@ -736,16 +1133,19 @@ namespace Alphaleonis {
 
          void VssBackupComponents::SetRollForward(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, VssRollForwardType rollType, String^ rollForwardPoint)
          {
+            m_writerComponents->Invalidate();
             CheckCom(RequireIVssBackupComponentsEx2()->SetRollForward(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), (VSS_ROLLFORWARD_TYPE)rollType, NoNullAutoMStr(rollForwardPoint)));
          }
 
          void VssBackupComponents::SetSelectedForRestore(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, bool selectedForRestore)
          {
+            m_writerComponents->Invalidate();
             CheckCom(m_backup->SetSelectedForRestore(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), selectedForRestore));
          }
 
          void VssBackupComponents::SetSelectedForRestore(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, bool selectedForRestore, Guid instanceId)
          {
+            m_writerComponents->Invalidate();
             CheckCom(RequireIVssBackupComponentsEx()->SetSelectedForRestoreEx(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), selectedForRestore, ToVssId(instanceId)));
          }
 
@@ -776,22 +1176,25 @@ namespace Alphaleonis {
          void VssBackupComponents::RecoverSet(VssRecoveryOptions options)
          {
             ::IVssAsync* pAsync;
-            CheckCom(RequireIVssBackupComponentsEx3()->RecoverSet((DWORD)options, &pAsync));
-            WaitCheckAndReleaseVssAsyncOperation(pAsync);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"RecoverSet");
+            CheckComPhase(phase, RequireIVssBackupComponentsEx3()->RecoverSet((DWORD)options, &pAsync));
+            WaitCheckAndReleaseVssAsyncOperation(pAsync, phase);
          }
 
          Task^ VssBackupComponents::RecoverSetAsync(VssRecoveryOptions options, CancellationToken cancellationToken)
          {
             ::IVssAsync* pAsync;
-            CheckCom(RequireIVssBackupComponentsEx3()->RecoverSet((DWORD)options, &pAsync));
-            return VssAsyncTaskFactory::AsTask(pAsync, cancellationToken);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"RecoverSet");
+            CheckComPhase(phase, RequireIVssBackupComponentsEx3()->RecoverSet((DWORD)options, &pAsync));
+            return VssAsyncTaskFactory::AsTask(pAsync, phase, cancellationToken);
          }
 
          IVssAsyncResult^ VssBackupComponents::BeginRecoverSet(VssRecoveryOptions options, AsyncCallback^ userCallback, Object^ stateObject)
          {
             ::IVssAsync* pAsync;
-            CheckCom(RequireIVssBackupComponentsEx3()->RecoverSet((DWORD)options, &pAsync));
-            return VssAsyncResult::Create(pAsync, userCallback, stateObject);
+            VssPhaseTimer^ phase = VssInstrumentation::StartPhase(L"RecoverSet");
+            CheckComPhase(phase, RequireIVssBackupComponentsEx3()->RecoverSet((DWORD)options, &pAsync));
+            return VssAsyncResult::Create(pAsync, phase, userCallback, stateObject);
          }
 
          void VssBackupComponents::EndRecoverSet(IAsyncResult^ asyncResult)
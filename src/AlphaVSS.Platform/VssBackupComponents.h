@@ -3,6 +3,7 @@
 
 #include "VssWriterComponents.h"
 #include "VssExamineWriterMetadata.h"
+#include "VssBatchEnumerable.h"
 #include "Macros.h"
 
 using namespace System;
@@ -12,7 +13,9 @@ using namespace System::Threading;
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
-   private ref class VssBackupComponents : IDisposable, IVssBackupComponents, MarshalByRefObject
+   struct SnapshotObjectTraits;
+
+   private ref class VssBackupComponents : IDisposable, IVssBatchBackupComponents, IVssProgressBackupComponents, MarshalByRefObject
    {
    public:
       VssBackupComponents();
@@ -22,6 +25,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       virtual void AbortBackup();
       virtual void AddAlternativeLocationMapping(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, String^ path, String^ filespec, bool recursive, String^ destination);
       virtual void AddComponent(Guid instanceId, Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName);
+      virtual IList<VssComponentSelectionFailure^>^ AddComponents(IEnumerable<VssComponentSelection^>^ components);
       virtual void AddNewTarget(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, String^ path, String^ fileName, bool recursive, String^ alternatePath);
       virtual void AddRestoreSubcomponent(Guid writerId, VssComponentType componentType, String^ logicalPath, String ^componentName, String^ subcomponentLogicalPath, String^ subcomponentName);
 
@@ -30,6 +34,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
       virtual void BackupComplete();
       virtual Task^ BackupCompleteAsync(CancellationToken cancellationToken);
+      virtual Task^ BackupCompleteAsync(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, CancellationToken cancellationToken);
       virtual IVssAsyncResult^ BeginBackupComplete(AsyncCallback^ userCallback, Object^ stateObject);
       virtual void EndBackupComplete(IAsyncResult ^asyncResult);      
 
@@ -48,6 +53,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       
       virtual void DoSnapshotSet();
       virtual Task^ DoSnapshotSetAsync(CancellationToken cancellationToken);
+      virtual Task^ DoSnapshotSetAsync(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, CancellationToken cancellationToken);
       virtual IVssAsyncResult^ BeginDoSnapshotSet(AsyncCallback^ userCallback, Object^ stateObject);
       virtual void EndDoSnapshotSet(IAsyncResult ^asyncResult);      
 
@@ -58,18 +64,22 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
       virtual void GatherWriterMetadata();
       virtual Task^ GatherWriterMetadataAsync(CancellationToken cancellationToken);
+      virtual Task^ GatherWriterMetadataAsync(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, CancellationToken cancellationToken);
       virtual IVssAsyncResult^ BeginGatherWriterMetadata(AsyncCallback^ userCallback, Object^ stateObject);
       virtual void EndGatherWriterMetadata(IAsyncResult ^asyncResult);
 
       virtual void GatherWriterStatus();
       virtual Task^ GatherWriterStatusAsync(CancellationToken cancellationToken);
+      virtual Task^ GatherWriterStatusAsync(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, CancellationToken cancellationToken);
       virtual IVssAsyncResult^ BeginGatherWriterStatus(AsyncCallback^ userCallback, Object^ stateObject);
       virtual void EndGatherWriterStatus(IAsyncResult ^asyncResult);      
 
       virtual VssSnapshotProperties^ GetSnapshotProperties(Guid snapshotId);
       property IList<IVssWriterComponents^>^ WriterComponents { virtual IList<IVssWriterComponents^>^ get(); }
       property IList<IVssExamineWriterMetadata^>^ WriterMetadata { virtual IList<IVssExamineWriterMetadata^>^ get(); }
+      virtual IList<VssCapturedWriterMetadata^>^ CaptureWriterMetadata();
       property IList<VssWriterStatusInfo^>^ WriterStatus { virtual IList<VssWriterStatusInfo^>^ get(); }
+      property bool MaterializeCollections { virtual bool get(); virtual void set(bool value); }
       
       virtual void ImportSnapshots();
       virtual Task^ ImportSnapshotsAsync(CancellationToken cancellationToken);
@@ -83,20 +93,24 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       
       virtual void PostRestore();
       virtual Task^ PostRestoreAsync(CancellationToken cancellationToken);
+      virtual Task^ PostRestoreAsync(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, CancellationToken cancellationToken);
       virtual IVssAsyncResult^ BeginPostRestore(AsyncCallback^ userCallback, Object^ stateObject);
       virtual void EndPostRestore(IAsyncResult ^asyncResult);      
       
       virtual void PrepareForBackup();
       virtual Task^ PrepareForBackupAsync(CancellationToken cancellationToken);
+      virtual Task^ PrepareForBackupAsync(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, CancellationToken cancellationToken);
       virtual IVssAsyncResult^ BeginPrepareForBackup(AsyncCallback^ userCallback, Object^ stateObject);
       virtual void EndPrepareForBackup(IAsyncResult ^asyncResult);      
       
       virtual void PreRestore();
       virtual Task^ PreRestoreAsync(CancellationToken cancellationToken);
+      virtual Task^ PreRestoreAsync(IProgress<VssAsyncProgress^>^ progress, TimeSpan reportInterval, CancellationToken cancellationToken);
       virtual IVssAsyncResult^ BeginPreRestore(AsyncCallback^ userCallback, Object^ stateObject);
       virtual void EndPreRestore(IAsyncResult ^asyncResult);      
 
       virtual System::Collections::Generic::IEnumerable<VssSnapshotProperties^> ^QuerySnapshots();
+      virtual System::Collections::Generic::IEnumerable<VssSnapshotProperties^> ^QuerySnapshots(int batchSize);
       virtual System::Collections::Generic::IEnumerable<VssProviderProperties^> ^QueryProviders();
       
       virtual IVssAsyncResult^ BeginQueryRevertStatus(String^ volumeName, AsyncCallback^ userCallback, Object^ stateObject);
@@ -111,6 +125,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       virtual void SetBackupOptions(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, String^ backupOptions);
       virtual void SetBackupState(bool selectComponents, bool backupBootableSystemState, VssBackupType backupType, bool partialFileSupport);
       virtual void SetBackupSucceeded(Guid instanceId, Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, bool succeeded);
+      virtual IList<VssComponentSelectionFailure^>^ SetBackupSucceeded(IEnumerable<VssComponentSelection^>^ components, bool succeeded);
       virtual void SetContext(VssVolumeSnapshotAttributes context);
       virtual void SetContext(VssSnapshotContext context);
       virtual void SetFileRestoreStatus(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, VssFileRestoreStatus status);
@@ -137,8 +152,21 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       virtual VssRootAndLogicalPrefixPaths^ GetRootAndLogicalPrefixPaths(String^ filePath, bool normalizeFQDNforRootPath);
 
    private:
+      void InvalidateLists();
+      Task^ InvalidateListsOnCompletion(Task^ task);
+      void OnListSourceOperationCompleted(Task^ task);
+      IReadOnlyList<VssWriterStatusInfo^>^ CaptureWriterStatus();
+      void ReportWriterCounts();
+      static array<VssComponentSelection^>^ ToComponentBatch(IEnumerable<VssComponentSelection^>^ components);
+
+      typedef VssBatchEnumerable<IVssEnumObject, VSS_OBJECT_PROP, VssSnapshotProperties, SnapshotObjectTraits> SnapshotEnumerable;
+
       ::IVssBackupComponents *m_backup;
 
+      // Taken by Dispose, and by the work that reads m_backup on another thread once an asynchronous operation 
+      // completes (list invalidation), so that m_backup is never released while in use.
+      initonly Object^ m_lifetimeLock;
+
       DEFINE_EX_INTERFACE_ACCESSOR(IVssBackupComponentsEx, m_backup)
       DEFINE_EX_INTERFACE_ACCESSOR(IVssBackupComponentsEx2, m_backup)
       DEFINE_EX_INTERFACE_ACCESSOR(IVssBackupComponentsEx3, m_backup)
@@ -149,8 +177,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       public:
          WriterMetadataList(VssBackupComponents^ backupComponents);
 
-         property int Count { virtual int get() override; }
-         property IVssExamineWriterMetadata^ default[int] { virtual IVssExamineWriterMetadata^ get(int index) override; }
+      protected:
+         virtual int GetCount() override;
+         virtual IVssExamineWriterMetadata^ GetItem(int index) override;
       private:
          VssBackupComponents^ m_backupComponents;
       };
@@ -161,8 +190,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       public:
          WriterComponentsList(VssBackupComponents^ backupComponents);
 
-         property int Count { virtual int get() override; }
-         property IVssWriterComponents^ default[int] { virtual IVssWriterComponents^ get(int index) override; }
+      protected:
+         virtual int GetCount() override;
+         virtual IVssWriterComponents^ GetItem(int index) override;
       private:
          VssBackupComponents^ m_backupComponents;
       };
@@ -172,8 +202,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       public:
          WriterStatusList(VssBackupComponents^ backupComponents);
 
-         property int Count { virtual int get() override; }
-         property VssWriterStatusInfo^ default[int] { virtual VssWriterStatusInfo^ get(int index) override; }
+      protected:
+         virtual int GetCount() override;
+         virtual VssWriterStatusInfo^ GetItem(int index) override;
       private:
          VssBackupComponents^ m_backupComponents;
       };
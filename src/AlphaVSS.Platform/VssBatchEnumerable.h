@@ -0,0 +1,192 @@
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   //
+   // Lazily evaluated sequence over a VSS enumerator interface (IVssEnumObject, IVssEnumMgmtObject).
+   // Elements are fetched from the underlying enumerator in batches of a configurable size, and are
+   // converted to their managed representation one at a time as the sequence is enumerated.
+   //
+   // TEnum   - The native enumerator interface. Must provide Next(ULONG, TProp *, ULONG *) and Release().
+   // TProp   - The native property structure returned by the enumerator.
+   // T       - The managed type of the elements in the sequence.
+   // TTraits - A class providing the following static methods:
+   //              bool IsMatch(TProp &prop)  - Returns true if the element should be included in the sequence, false
+   //                                           if it should be skipped. May throw if the element is not valid.
+   //              T^ Create(TProp &prop)     - Creates the managed object, releasing the memory held by prop.
+   //              void Free(TProp &prop)     - Releases the memory held by prop without creating a managed object.
+   //
+   // The sequence takes ownership of the enumerator passed to it, and can be enumerated only once. The native
+   // enumerator is released as soon as its last batch has been fetched, or when the enumerator of the sequence
+   // is disposed, so that callers enumerating the sequence with foreach need not dispose the sequence itself.
+   // Errors returned by the native enumerator are thrown from MoveNext.
+   //
+   template <typename TEnum, typename TProp, typename T, typename TTraits>
+   private ref class VssBatchEnumerable sealed : IEnumerable<T^>
+   {
+   public:
+      literal int DefaultBatchSize = 64;
+
+      VssBatchEnumerable(TEnum *pEnum, int batchSize)
+         : m_enum(pEnum), m_batchSize(batchSize), m_isStarted(false)
+      {
+         if (pEnum == 0)
+            throw gcnew ArgumentNullException(L"pEnum");
+
+         if (batchSize < 1)
+         {
+            pEnum->Release();
+            throw gcnew ArgumentOutOfRangeException(L"batchSize", L"The batch size must be greater than zero.");
+         }
+      }
+
+      ~VssBatchEnumerable()
+      {
+         this->!VssBatchEnumerable();
+      }
+
+      !VssBatchEnumerable()
+      {
+         ReleaseEnumerator();
+      }
+
+      virtual IEnumerator<T^>^ GetEnumerator()
+      {
+         if (m_isStarted)
+            throw gcnew InvalidOperationException(L"The sequence can be enumerated only once.");
+
+         if (m_enum == 0)
+            throw gcnew ObjectDisposedException(L"Sequence used after the object creating it was disposed.");
+
+         m_isStarted = true;
+         return gcnew Enumerator(this);
+      }
+
+      virtual System::Collections::IEnumerator^ GetEnumeratorNG() = System::Collections::IEnumerable::GetEnumerator
+      {
+         return GetEnumerator();
+      }
+
+   private:
+      void ReleaseEnumerator()
+      {
+         if (m_enum != 0)
+         {
+            m_enum->Release();
+            m_enum = 0;
+         }
+      }
+
+      ref class Enumerator sealed : IEnumerator<T^>
+      {
+      public:
+         Enumerator(VssBatchEnumerable^ owner)
+            : m_owner(owner), m_buffer(0), m_fetched(0), m_position(0), m_isDone(false), m_current(nullptr)
+         {
+            m_buffer = new TProp[owner->m_batchSize];
+         }
+
+         ~Enumerator()
+         {
+            this->!Enumerator();
+            m_owner->ReleaseEnumerator();
+         }
+
+         !Enumerator()
+         {
+            if (m_buffer != 0)
+            {
+               // Release any elements fetched from the enumerator but never handed out.
+               for (ULONG i = m_position; i < m_fetched; i++)
+                  TTraits::Free(m_buffer[i]);
+
+               delete [] m_buffer;
+               m_buffer = 0;
+            }
+         }
+
+         virtual bool MoveNext()
+         {
+            if (m_buffer == 0)
+               throw gcnew ObjectDisposedException(L"Enumerator used after it was disposed.");
+
+            while (true)
+            {
+               if (m_position < m_fetched)
+               {
+                  // The element is still owned by the buffer while IsMatch runs, so that it is freed with the
+                  // rest of the batch if IsMatch throws.
+                  TProp &prop = m_buffer[m_position];
+                  bool isMatch = TTraits::IsMatch(prop);
+                  m_position++;
+
+                  if (isMatch)
+                  {
+                     m_current = TTraits::Create(prop);
+                     return true;
+                  }
+
+                  TTraits::Free(prop);
+                  continue;
+               }
+
+               if (m_isDone)
+               {
+                  m_current = nullptr;
+                  return false;
+               }
+
+               if (m_owner->m_enum == 0)
+                  throw gcnew ObjectDisposedException(L"Sequence used after the object creating it was disposed.");
+
+               m_position = 0;
+               m_fetched = 0;
+
+               ULONG celtFetched = 0;
+               HRESULT hr = m_owner->m_enum->Next(m_owner->m_batchSize, m_buffer, &celtFetched);
+               if (FAILED(hr))
+                  ThrowException(hr);
+
+               // S_FALSE (or a short batch) indicates that the end of the sequence was reached.
+               m_fetched = celtFetched;
+               if (hr == S_FALSE || celtFetched < (ULONG)m_owner->m_batchSize)
+               {
+                  m_isDone = true;
+                  m_owner->ReleaseEnumerator();
+               }
+            }
+         }
+
+         virtual void Reset()
+         {
+            throw gcnew NotSupportedException();
+         }
+
+         property T^ Current
+         {
+            virtual T^ get() { return m_current; }
+         }
+
+         property Object^ CurrentObject
+         {
+            virtual Object^ get() = System::Collections::IEnumerator::Current::get { return m_current; }
+         }
+
+      private:
+         VssBatchEnumerable^ m_owner;
+         TProp *m_buffer;
+         ULONG m_fetched;
+         ULONG m_position;
+         bool m_isDone;
+         T^ m_current;
+      };
+
+      TEnum *m_enum;
+      int m_batchSize;
+      bool m_isStarted;
+   };
+}
+} }
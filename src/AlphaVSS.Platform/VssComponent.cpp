@@ -6,11 +6,21 @@
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
-   VssComponent^ VssComponent::Adopt(::IVssComponent *vssWriterComponents)
+   VssComponent^ VssComponent::Adopt(::IVssComponent *vssWriterComponents, bool materializeLists)
    {
       try
       {
-         return gcnew VssComponent(vssWriterComponents);
+         VssComponent^ component = gcnew VssComponent(vssWriterComponents);
+
+         // The component is read-only, so any captured elements of its lists remain valid for 
+         // the lifetime of the object.
+         component->m_alternateLocationMappings->MaterializeOnRead = materializeLists;
+         component->m_directedTargets->MaterializeOnRead = materializeLists;
+         component->m_differencedFiles->MaterializeOnRead = materializeLists;
+         component->m_restoreSubcomponents->MaterializeOnRead = materializeLists;
+         component->m_partialFiles->MaterializeOnRead = materializeLists;
+         component->m_newTargets->MaterializeOnRead = materializeLists;
+         return component;
       }
       catch (...)
       {
@@ -281,7 +291,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    {
    }
 
-   int VssComponent::DirectedTargetList::Count::get()
+   int VssComponent::DirectedTargetList::GetCount()
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
@@ -291,14 +301,11 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       return count;
    }
 
-   VssDirectedTargetInfo^ VssComponent::DirectedTargetList::default::get(int index)
+   VssDirectedTargetInfo^ VssComponent::DirectedTargetList::GetItem(int index)
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
-      if (index < 0 || index >= Count)
-         throw gcnew ArgumentOutOfRangeException("index");
-
       AutoBStr bsSourcePath, bsSourceFileName, bsSourceRangeList;
       AutoBStr bsDestPath, bsDestFileName, bsDestRangeList;
 
@@ -313,7 +320,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    //
    // NewTargetList 
    //
-   int VssComponent::NewTargetList::Count::get()
+   int VssComponent::NewTargetList::GetCount()
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
@@ -324,14 +331,11 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    }
 
    
-   VssWMFileDescriptor^ VssComponent::NewTargetList::default::get(int index)
+   VssWMFileDescriptor^ VssComponent::NewTargetList::GetItem(int index)
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
-      if (index < 0 || index >= Count)
-         throw gcnew ArgumentOutOfRangeException("index");
-
       IVssWMFiledesc *vssWMFiledesc;
       CheckCom(m_component->m_vssComponent->GetNewTarget(index, &vssWMFiledesc));
       return CreateVssWMFileDescriptor(vssWMFiledesc);
@@ -345,7 +349,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    //
    // PartialFileList 
    //
-   int VssComponent::PartialFileList::Count::get()
+   int VssComponent::PartialFileList::GetCount()
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
@@ -356,14 +360,11 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    }
 
    
-   VssPartialFileInfo^ VssComponent::PartialFileList::default::get(int index)
+   VssPartialFileInfo^ VssComponent::PartialFileList::GetItem(int index)
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
-      if (index < 0 || index >= Count)
-         throw gcnew ArgumentOutOfRangeException("index");
-
       AutoBStr bsPath, bsFileName, bsRange, bsMetadata;
       CheckCom(m_component->m_vssComponent->GetPartialFile(index, &bsPath, &bsFileName, &bsRange, &bsMetadata));
       return gcnew VssPartialFileInfo(bsPath, bsFileName, bsRange, bsMetadata);
@@ -377,7 +378,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    //
    // DifferencedFileList 
    //
-   int VssComponent::DifferencedFileList::Count::get()
+   int VssComponent::DifferencedFileList::GetCount()
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
@@ -387,14 +388,11 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       return count;
    }
 
-   VssDifferencedFileInfo^ VssComponent::DifferencedFileList::default::get(int index)
+   VssDifferencedFileInfo^ VssComponent::DifferencedFileList::GetItem(int index)
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
-      if (index < 0 || index >= Count)
-         throw gcnew ArgumentOutOfRangeException("index");
-
       AutoBStr bstrPath, bstrFilespec, bstrLsnString;
       BOOL bRecursive;
       FILETIME ftLastModifyTime;
@@ -410,7 +408,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    //
    // RestoreSubcomponentList 
    //
-   int VssComponent::RestoreSubcomponentList::Count::get()
+   int VssComponent::RestoreSubcomponentList::GetCount()
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
@@ -420,14 +418,11 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       return count;
    }
 
-   VssRestoreSubcomponentInfo^ VssComponent::RestoreSubcomponentList::default::get(int index)
+   VssRestoreSubcomponentInfo^ VssComponent::RestoreSubcomponentList::GetItem(int index)
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
-      if (index < 0 || index >= Count)
-         throw gcnew ArgumentOutOfRangeException("index");
-
       AutoBStr bsLogicalPath, bsComponentName;
       bool bRepair;
       CheckCom(m_component->m_vssComponent->GetRestoreSubcomponent(index, &bsLogicalPath, &bsComponentName, &bRepair));
@@ -443,7 +438,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    //
    // AlternateLocationMappingList 
    //
-   int VssComponent::AlternateLocationMappingList::Count::get()
+   int VssComponent::AlternateLocationMappingList::GetCount()
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
@@ -454,14 +449,11 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    }
 
    
-   VssWMFileDescriptor^ VssComponent::AlternateLocationMappingList::default::get(int index)
+   VssWMFileDescriptor^ VssComponent::AlternateLocationMappingList::GetItem(int index)
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
-      if (index < 0 || index >= Count)
-         throw gcnew ArgumentOutOfRangeException("index");
-
       IVssWMFiledesc *vssWMFiledesc;
       CheckCom(m_component->m_vssComponent->GetAlternateLocationMapping(index, &vssWMFiledesc));
       return CreateVssWMFileDescriptor(vssWMFiledesc);
@@ -53,7 +53,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       property VssComponentFailure^ Failure { virtual VssComponentFailure^ get(); virtual void set(VssComponentFailure^ value); }
 
    internal:
-      static VssComponent^ Adopt(::IVssComponent *vssWriterComponents);
+      static VssComponent^ Adopt(::IVssComponent *vssWriterComponents, bool materializeLists);
    private:
       VssComponent(::IVssComponent *vssWriterComponents);
       ::IVssComponent *m_vssComponent;
@@ -67,8 +67,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       public:
          DirectedTargetList(VssComponent^ component);
 
-         property int Count { virtual int get() override; }
-         property VssDirectedTargetInfo^ default[int] { virtual VssDirectedTargetInfo^ get(int index) override; }
+      protected:
+         virtual int GetCount() override;
+         virtual VssDirectedTargetInfo^ GetItem(int index) override;
       private:
          VssComponent^ m_component;
       };
@@ -78,8 +79,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       public:
          NewTargetList(VssComponent^ component);
 
-         property int Count { virtual int get() override; }
-         property VssWMFileDescriptor^ default[int] { virtual VssWMFileDescriptor^ get(int index) override; }
+      protected:
+         virtual int GetCount() override;
+         virtual VssWMFileDescriptor^ GetItem(int index) override;
       private:
          VssComponent^ m_component;
       };
@@ -89,8 +91,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       public:
          AlternateLocationMappingList(VssComponent^ component);
 
-         property int Count { virtual int get() override; }
-         property VssWMFileDescriptor^ default[int] { virtual VssWMFileDescriptor^ get(int index) override; }
+      protected:
+         virtual int GetCount() override;
+         virtual VssWMFileDescriptor^ GetItem(int index) override;
       private:
          VssComponent^ m_component;
       };
@@ -100,8 +103,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       public:
          PartialFileList(VssComponent^ component);
 
-         property int Count { virtual int get() override; }
-         property VssPartialFileInfo^ default[int] { virtual VssPartialFileInfo^ get(int index) override; }
+      protected:
+         virtual int GetCount() override;
+         virtual VssPartialFileInfo^ GetItem(int index) override;
       private:
          VssComponent^ m_component;
       };
@@ -111,8 +115,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       public:
          DifferencedFileList(VssComponent^ component);
 
-         property int Count { virtual int get() override; }
-         property VssDifferencedFileInfo^ default[int] { virtual VssDifferencedFileInfo^ get(int index) override; }
+      protected:
+         virtual int GetCount() override;
+         virtual VssDifferencedFileInfo^ GetItem(int index) override;
       private:
          VssComponent^ m_component;
       };
@@ -122,8 +127,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       public:
          RestoreSubcomponentList(VssComponent^ component);
 
-         property int Count { virtual int get() override; }
-         property VssRestoreSubcomponentInfo^ default[int] { virtual VssRestoreSubcomponentInfo^ get(int index) override; }
+      protected:
+         virtual int GetCount() override;
+         virtual VssRestoreSubcomponentInfo^ GetItem(int index) override;
       private:
          VssComponent^ m_component;
       };
@@ -3,112 +3,40 @@
 #include "pch.h"
 
 #include "VssDifferentialSoftwareSnapshotManagement.h"
+#include "VssMgmtObjectTraits.h"
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
 
    /****************************************************************************************
-     Helper methods for creating properties objects and lists
+     Helper methods for creating lists
     ****************************************************************************************/
 
-   template <typename IF>
-   static IF^ CreatePropertiesObject(VSS_MGMT_OBJECT_PROP &prop)
+   template <typename IF, VSS_MGMT_OBJECT_TYPE ObjectType>
+   static IEnumerable<IF^>^ CreateEnumerableFromEnumMgmtObject(IVssEnumMgmtObject *pEnum, int batchSize)
    {
-      throw gcnew NotImplementedException(String::Format(L"Unknown type in VSS_MGMT_OBJECT_PROP: {0}", (Int32)prop.Type));
+      return gcnew VssBatchEnumerable<IVssEnumMgmtObject, VSS_MGMT_OBJECT_PROP, IF, MgmtObjectTraits<IF, ObjectType> >(pEnum, batchSize);
    }
 
-   
-   template <>
-   static VssVolumeProperties^ CreatePropertiesObject<VssVolumeProperties>(VSS_MGMT_OBJECT_PROP &prop)
-   {
-      try
-      {
-         System::Diagnostics::Debug::Assert(prop.Type == VSS_MGMT_OBJECT_VOLUME, 
-            L"Unexpected type in VSS_MGMT_OBJECT_PROP object",
-            String::Format(L"Expected type to be VSS_MGMT_OBJECT_VOLUME ({0}), but it was {1}",
-            (Int32)VSS_MGMT_OBJECT_VOLUME, (Int32)prop.Type));
-         return gcnew VssVolumeProperties(gcnew String(prop.Obj.Vol.m_pwszVolumeName), gcnew String(prop.Obj.Vol.m_pwszVolumeDisplayName));
-      }
-      finally
-      {
-         ::CoTaskMemFree(prop.Obj.Vol.m_pwszVolumeName);
-         ::CoTaskMemFree(prop.Obj.Vol.m_pwszVolumeDisplayName);
-      }
-   }
-
-   
-   template <>
-   static VssDiffVolumeProperties^ CreatePropertiesObject<VssDiffVolumeProperties>(VSS_MGMT_OBJECT_PROP &prop)
-   {
-      try
-      {
-         System::Diagnostics::Debug::Assert(prop.Type == VSS_MGMT_OBJECT_DIFF_VOLUME, 
-            L"Unexpected type in VSS_MGMT_OBJECT_PROP object",
-            String::Format(L"Expected type to be VSS_MGMT_OBJECT_DIFF_VOLUME ({0}), but it was {1}",
-            (Int32)VSS_MGMT_OBJECT_DIFF_VOLUME, (Int32)prop.Type));
-         return gcnew VssDiffVolumeProperties(gcnew String(prop.Obj.DiffVol.m_pwszVolumeName), 
-                                       gcnew String(prop.Obj.DiffVol.m_pwszVolumeDisplayName), 
-                                       prop.Obj.DiffVol.m_llVolumeFreeSpace, 
-                                       prop.Obj.DiffVol.m_llVolumeTotalSpace);
-      }
-      finally
-      {
-         ::CoTaskMemFree(prop.Obj.DiffVol.m_pwszVolumeName);
-         ::CoTaskMemFree(prop.Obj.DiffVol.m_pwszVolumeDisplayName);
-      }
-   }
-
-   
-   template <>
-   static VssDiffAreaProperties^ CreatePropertiesObject<VssDiffAreaProperties>(VSS_MGMT_OBJECT_PROP &prop)
+   template <typename IF, VSS_MGMT_OBJECT_TYPE ObjectType>
+   static IList<IF^>^ CreateListFromEnumMgmtObject(IVssEnumMgmtObject *pEnum)
    {
+      VssBatchEnumerable<IVssEnumMgmtObject, VSS_MGMT_OBJECT_PROP, IF, MgmtObjectTraits<IF, ObjectType> >^ enumerable = 
+         gcnew VssBatchEnumerable<IVssEnumMgmtObject, VSS_MGMT_OBJECT_PROP, IF, MgmtObjectTraits<IF, ObjectType> >(pEnum, VssDifferentialSoftwareSnapshotManagement::DefaultBatchSize);
       try
       {
-         System::Diagnostics::Debug::Assert(prop.Type == VSS_MGMT_OBJECT_DIFF_AREA, 
-            L"Unexpected type in VSS_MGMT_OBJECT_PROP object",
-            String::Format(L"Expected type to be VSS_MGMT_OBJECT_DIFF_AREA ({0}), but it was {1}",
-            (Int32)VSS_MGMT_OBJECT_DIFF_AREA, (Int32)prop.Type));
-         return gcnew VssDiffAreaProperties(gcnew String(prop.Obj.DiffArea.m_pwszVolumeName),
-                                      gcnew String(prop.Obj.DiffArea.m_pwszDiffAreaVolumeName),
-                                      prop.Obj.DiffArea.m_llMaximumDiffSpace,
-                                      prop.Obj.DiffArea.m_llAllocatedDiffSpace,
-                                      prop.Obj.DiffArea.m_llUsedDiffSpace);
+         return gcnew List<IF^>(enumerable);
       }
       finally
       {
-         ::CoTaskMemFree(prop.Obj.DiffArea.m_pwszVolumeName);
-         ::CoTaskMemFree(prop.Obj.DiffArea.m_pwszDiffAreaVolumeName);
+         delete enumerable;
       }
    }
 
-   
-   template <typename IF>
-   static IList<IF^>^ CreateListFromEnumMgmtObject(IVssEnumMgmtObject *pEnum)
+   static void CheckBatchSize(int batchSize)
    {
-      try
-      {
-         List<IF^>^ list = gcnew List<IF^>();
-
-         while (true)
-         {
-            VSS_MGMT_OBJECT_PROP prop;
-            ULONG celtFetched;
-            HRESULT hr = pEnum->Next(1, &prop, &celtFetched);
-            
-            if (FAILED(hr))		// An error occured
-               ThrowException(hr);
-            
-            if (celtFetched < 1) // We are done
-               break;
-
-            list->Add(CreatePropertiesObject<IF>(prop));
-         }
-         return list;
-      }
-      finally
-      {
-         pEnum->Release();
-      }	
+      if (batchSize < 1)
+         throw gcnew ArgumentOutOfRangeException("batchSize", "The batch size must be greater than zero.");
    }
 
    /****************************************************************************************
@@ -162,32 +90,61 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    {
       IVssEnumMgmtObject *pEnum;
       CheckCom(m_mgmt->QueryDiffAreasForSnapshot(ToVssId(snapshotId), &pEnum));
-      return CreateListFromEnumMgmtObject<VssDiffAreaProperties>(pEnum);
+      return CreateListFromEnumMgmtObject<VssDiffAreaProperties, VSS_MGMT_OBJECT_DIFF_AREA>(pEnum);
    }
 
     IList<VssDiffAreaProperties^>^ VssDifferentialSoftwareSnapshotManagement::QueryDiffAreasForVolume(String^ volumeName)
    {
       IVssEnumMgmtObject *pEnum;
       CheckCom(m_mgmt->QueryDiffAreasForVolume(NoNullAutoMStr(volumeName), &pEnum));
-      return CreateListFromEnumMgmtObject<VssDiffAreaProperties>(pEnum);
+      return CreateListFromEnumMgmtObject<VssDiffAreaProperties, VSS_MGMT_OBJECT_DIFF_AREA>(pEnum);
    }
 
     IList<VssDiffAreaProperties^>^ VssDifferentialSoftwareSnapshotManagement::QueryDiffAreasOnVolume(String^ volumeName)
    {
       IVssEnumMgmtObject *pEnum;
       CheckCom(m_mgmt->QueryDiffAreasOnVolume(NoNullAutoMStr(volumeName), &pEnum));
-      return CreateListFromEnumMgmtObject<VssDiffAreaProperties>(pEnum);
+      return CreateListFromEnumMgmtObject<VssDiffAreaProperties, VSS_MGMT_OBJECT_DIFF_AREA>(pEnum);
    }
 
     IList<VssDiffVolumeProperties^>^ VssDifferentialSoftwareSnapshotManagement::QueryVolumesSupportedForDiffAreas(String^ originalVolumeName)
    {
       IVssEnumMgmtObject *pEnum;
       CheckCom(m_mgmt->QueryVolumesSupportedForDiffAreas(NoNullAutoMStr(originalVolumeName), &pEnum));
-      return CreateListFromEnumMgmtObject<VssDiffVolumeProperties>(pEnum);
+      return CreateListFromEnumMgmtObject<VssDiffVolumeProperties, VSS_MGMT_OBJECT_DIFF_VOLUME>(pEnum);
    }
 
+   IEnumerable<VssDiffAreaProperties^>^ VssDifferentialSoftwareSnapshotManagement::EnumerateDiffAreasForSnapshot(Guid snapshotId, int batchSize)
+   {
+      CheckBatchSize(batchSize);
+      IVssEnumMgmtObject *pEnum;
+      CheckCom(m_mgmt->QueryDiffAreasForSnapshot(ToVssId(snapshotId), &pEnum));
+      return CreateEnumerableFromEnumMgmtObject<VssDiffAreaProperties, VSS_MGMT_OBJECT_DIFF_AREA>(pEnum, batchSize);
+   }
 
+   IEnumerable<VssDiffAreaProperties^>^ VssDifferentialSoftwareSnapshotManagement::EnumerateDiffAreasForVolume(String^ volumeName, int batchSize)
+   {
+      CheckBatchSize(batchSize);
+      IVssEnumMgmtObject *pEnum;
+      CheckCom(m_mgmt->QueryDiffAreasForVolume(NoNullAutoMStr(volumeName), &pEnum));
+      return CreateEnumerableFromEnumMgmtObject<VssDiffAreaProperties, VSS_MGMT_OBJECT_DIFF_AREA>(pEnum, batchSize);
+   }
+
+   IEnumerable<VssDiffAreaProperties^>^ VssDifferentialSoftwareSnapshotManagement::EnumerateDiffAreasOnVolume(String^ volumeName, int batchSize)
+   {
+      CheckBatchSize(batchSize);
+      IVssEnumMgmtObject *pEnum;
+      CheckCom(m_mgmt->QueryDiffAreasOnVolume(NoNullAutoMStr(volumeName), &pEnum));
+      return CreateEnumerableFromEnumMgmtObject<VssDiffAreaProperties, VSS_MGMT_OBJECT_DIFF_AREA>(pEnum, batchSize);
+   }
 
+   IEnumerable<VssDiffVolumeProperties^>^ VssDifferentialSoftwareSnapshotManagement::EnumerateVolumesSupportedForDiffAreas(String^ originalVolumeName, int batchSize)
+   {
+      CheckBatchSize(batchSize);
+      IVssEnumMgmtObject *pEnum;
+      CheckCom(m_mgmt->QueryVolumesSupportedForDiffAreas(NoNullAutoMStr(originalVolumeName), &pEnum));
+      return CreateEnumerableFromEnumMgmtObject<VssDiffVolumeProperties, VSS_MGMT_OBJECT_DIFF_VOLUME>(pEnum, batchSize);
+   }
 
     //
     // From IVssDifferentialSoftwareSnapshotMgmt2
@@ -4,13 +4,14 @@
 #include <vss.h>
 
 #include <VsMgmt.h>
+#include "VssBatchEnumerable.h"
 #include "Macros.h"
 
 using namespace System::Collections::Generic;
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
-   public ref class VssDifferentialSoftwareSnapshotManagement : IVssDifferentialSoftwareSnapshotManagement, MarshalByRefObject
+   public ref class VssDifferentialSoftwareSnapshotManagement : IVssBatchDifferentialSoftwareSnapshotManagement, MarshalByRefObject
    {
    public:
       ~VssDifferentialSoftwareSnapshotManagement();
@@ -23,6 +24,11 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       virtual IList<VssDiffAreaProperties^>^ QueryDiffAreasOnVolume(String^ volumeName);
       virtual IList<VssDiffVolumeProperties^>^ QueryVolumesSupportedForDiffAreas(String^ originalVolumeName);
 
+      virtual IEnumerable<VssDiffAreaProperties^>^ EnumerateDiffAreasForSnapshot(Guid snapshotId, int batchSize);
+      virtual IEnumerable<VssDiffAreaProperties^>^ EnumerateDiffAreasForVolume(String^ volumeName, int batchSize);
+      virtual IEnumerable<VssDiffAreaProperties^>^ EnumerateDiffAreasOnVolume(String^ volumeName, int batchSize);
+      virtual IEnumerable<VssDiffVolumeProperties^>^ EnumerateVolumesSupportedForDiffAreas(String^ originalVolumeName, int batchSize);
+
       //
       // From IVssDifferentialSoftwareSnapshotMgmt2
       //
@@ -37,6 +43,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       virtual void SetVolumeProtectionLevel(String^ volumeName, VssProtectionLevel protectionLevel);
 
    internal:
+      // The number of elements fetched per call to IVssEnumMgmtObject::Next by the Query methods.
+      literal int DefaultBatchSize = 64;
+
       VssDifferentialSoftwareSnapshotManagement(::IVssDifferentialSoftwareSnapshotMgmt *pMgmt);
    private:
       ::IVssDifferentialSoftwareSnapshotMgmt *m_mgmt;
@@ -233,6 +233,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
          DWORD dwMajorVersion = 0;
          DWORD dwMinorVersion = 0;
          CheckCom(RequireIVssExamineWriterMetadataEx2()->GetVersion(&dwMajorVersion, &dwMinorVersion));
+         m_version = gcnew System::Version((int)dwMajorVersion, (int)dwMinorVersion);
       }
       return m_version;
    }
@@ -253,9 +254,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
          CheckCom(RequireIVssExamineWriterMetadataEx2()->GetExcludeFromSnapshotFile(i, &filedesc));
          list->Add(CreateVssWMFileDescriptor(filedesc));
       }
-      m_excludeFiles = list;
+      m_excludeFilesFromSnapshot = list;
 
-      return m_excludeFiles;
+      return m_excludeFilesFromSnapshot;
    }
 
 }
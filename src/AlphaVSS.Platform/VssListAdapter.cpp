@@ -2,6 +2,8 @@
 #include "pch.h"
 #include "VssListAdapter.h"
 
+using namespace System::Threading;
+
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
 	generic<typename T>
@@ -16,13 +18,187 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		throw gcnew NotSupportedException(L"Cannot modify read-only list");
 	}
 
+	generic<typename T>
+	VssListAdapter<T>::VssListAdapter()
+		: m_lock(gcnew Object()), m_materializeOnRead(false), m_items(nullptr), m_discardedItems(gcnew System::Collections::Generic::List<array<T>^>())
+	{
+	}
+
+	generic<typename T>
+	bool VssListAdapter<T>::MaterializeOnRead::get()
+	{
+		return m_materializeOnRead;
+	}
+
+	generic<typename T>
+	void VssListAdapter<T>::MaterializeOnRead::set(bool value)
+	{
+		bool taken = false;
+		try
+		{
+			Monitor::Enter(m_lock, taken);
+			m_materializeOnRead = value;
+			DiscardItems();
+		}
+		finally
+		{
+			if (taken)
+				Monitor::Exit(m_lock);
+		}
+	}
+
+	generic<typename T>
+	void VssListAdapter<T>::Invalidate()
+	{
+		bool taken = false;
+		try
+		{
+			Monitor::Enter(m_lock, taken);
+			DiscardItems();
+		}
+		finally
+		{
+			if (taken)
+				Monitor::Exit(m_lock);
+		}
+	}
+
+	generic<typename T>
+	void VssListAdapter<T>::DisposeCapturedItems()
+	{
+		array<array<T>^>^ discarded;
+		bool taken = false;
+		try
+		{
+			Monitor::Enter(m_lock, taken);
+			DiscardItems();
+			discarded = m_discardedItems->ToArray();
+			m_discardedItems->Clear();
+		}
+		finally
+		{
+			if (taken)
+				Monitor::Exit(m_lock);
+		}
+
+		for (int i = 0; i < discarded->Length; i++)
+			DisposeItems(discarded[i]);
+	}
+
+	// Must be called with m_lock held. The elements are only disposed by DisposeCapturedItems(), since 
+	// enumerators and callers of the indexer may still be using them.
+	generic<typename T>
+	void VssListAdapter<T>::DiscardItems()
+	{
+		if (m_items != nullptr)
+		{
+			m_discardedItems->Add(m_items);
+			m_items = nullptr;
+		}
+	}
+
+	generic<typename T>
+	void VssListAdapter<T>::DisposeItems(array<T>^ items)
+	{
+		if (items == nullptr)
+			return;
+
+		for (int i = 0; i < items->Length; i++)
+		{
+			IDisposable^ disposable = dynamic_cast<IDisposable^>((Object^)items[i]);
+			if (disposable != nullptr)
+				delete disposable;
+		}
+	}
+
+	generic<typename T>
+	array<T>^ VssListAdapter<T>::ToArray()
+	{
+		array<T>^ items = GetCapturedItems();
+		if (items == nullptr)
+			items = ReadItems();
+
+		return items;
+	}
+
+	generic<typename T>
+	array<T>^ VssListAdapter<T>::ReadItems()
+	{
+		int count = GetCount();
+		array<T>^ items = gcnew array<T>(count);
+		for (int i = 0; i < count; i++)
+			items[i] = GetItem(i);
+
+		return items;
+	}
+
+	generic<typename T>
+	array<T>^ VssListAdapter<T>::GetCapturedItems()
+	{
+		bool taken = false;
+		try
+		{
+			Monitor::Enter(m_lock, taken);
+			return m_items;
+		}
+		finally
+		{
+			if (taken)
+				Monitor::Exit(m_lock);
+		}
+	}
+
+	generic<typename T>
+	array<T>^ VssListAdapter<T>::GetMaterializedItems()
+	{
+		bool taken = false;
+		try
+		{
+			Monitor::Enter(m_lock, taken);
+			if (m_items == nullptr && m_materializeOnRead)
+				m_items = ReadItems();
+
+			return m_items;
+		}
+		finally
+		{
+			if (taken)
+				Monitor::Exit(m_lock);
+		}
+	}
+
+	generic<typename T>
+	int VssListAdapter<T>::Count::get()
+	{
+		array<T>^ items = GetCapturedItems();
+		if (items != nullptr)
+			return items->Length;
+
+		return GetCount();
+	}
+
+	generic<typename T>
+	T VssListAdapter<T>::default::get(int index)
+	{
+		array<T>^ items = GetCapturedItems();
+		if (items != nullptr)
+		{
+			if (index < 0 || index >= items->Length)
+				throw gcnew ArgumentOutOfRangeException("index");
+
+			return items[index];
+		}
+
+		if (index < 0 || index >= GetCount())
+			throw gcnew ArgumentOutOfRangeException("index");
+
+		return GetItem(index);
+	}
+
 	generic<typename T>
 	bool VssListAdapter<T>::Contains(T item)
 	{
-		for (int i = 0; i < Count; i++)
-			if (this[i]->Equals(item))
-				return true;
-		return false;
+		return IndexOf(item) != -1;
 	}
 
 	generic<typename T>
@@ -37,30 +213,51 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		if (arr->Rank != 1)
 			throw gcnew ArgumentException("array must be one-dimensional", "arr");
 
-		if (arrayIndex + Count > arr->Length)
+		array<T>^ items = GetMaterializedItems();
+		if (items != nullptr)
+		{
+			if (arrayIndex + items->Length > arr->Length)
+				throw gcnew ArgumentException("invalid arrayIndex");
+
+			Array::Copy(items, 0, arr, arrayIndex, items->Length);
+			return;
+		}
+
+		int count = GetCount();
+		if (arrayIndex + count > arr->Length)
 			throw gcnew ArgumentException("invalid arrayIndex");
 
-		for (int i = 0; i < Count; i++)
-			arr[i + arrayIndex] = this[i];
+		for (int i = 0; i < count; i++)
+			arr[i + arrayIndex] = GetItem(i);
 	}
 
 	generic<typename T>
 	System::Collections::Generic::IEnumerator<T>^ VssListAdapter<T>::GetEnumerator()
 	{
-		return gcnew Enumerator(this);
+		return gcnew Enumerator(this, GetMaterializedItems());
 	}
 
 	generic<typename T>
 	System::Collections::IEnumerator^ VssListAdapter<T>::GetEnumeratorNG()
 	{
-		return gcnew Enumerator(this);
+		return gcnew Enumerator(this, GetMaterializedItems());
 	}
 
 	generic<typename T>
 	int VssListAdapter<T>::IndexOf(T item)
 	{
-		for (int i = 0; i < Count; i++)
-			if (this[i]->Equals(item))
+		array<T>^ items = GetMaterializedItems();
+		if (items != nullptr)
+		{
+			for (int i = 0; i < items->Length; i++)
+				if (items[i]->Equals(item))
+					return i;
+			return -1;
+		}
+
+		int count = GetCount();
+		for (int i = 0; i < count; i++)
+			if (GetItem(i)->Equals(item))
 				return i;
 		return -1;
 	}
@@ -96,8 +293,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 	}		
 
 	generic<typename T>
-	VssListAdapter<T>::Enumerator::Enumerator(VssListAdapter<T>^ list)
-		: m_list(list), m_index(-1)
+	VssListAdapter<T>::Enumerator::Enumerator(VssListAdapter<T>^ list, array<T>^ items)
+		: m_list(list), m_items(items), m_index(-1), m_count(0)
 	{
 	}
 
@@ -114,10 +311,12 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 	generic<typename T>
 	bool VssListAdapter<T>::Enumerator::MoveNext()
 	{
-		int count = m_list->Count;
-		if (++m_index >= count)
+		// The count of a live (non-materialized) list is re-read on every step, since the 
+		// underlying collection may change during enumeration.
+		m_count = (m_items != nullptr) ? m_items->Length : m_list->GetCount();
+		if (++m_index >= m_count)
 		{
-			m_index = count;
+			m_index = m_count;
 			return false;
 		}
 		return true;
@@ -132,14 +331,19 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 	generic<typename T>
 	Object^ VssListAdapter<T>::Enumerator::CurrentObject::get()
 	{
-		return m_list[m_index];
+		return Current;
 	}
 
 	generic<typename T>
 	T VssListAdapter<T>::Enumerator::Current::get()
 	{
-		return m_list[m_index];
-	}
+		if (m_index < 0 || m_index >= m_count)
+			throw gcnew InvalidOperationException(L"Enumeration has either not started or has already finished.");
+
+		if (m_items != nullptr)
+			return m_items[m_index];
 
+		return m_list->GetItem(m_index);
+	}
 
 } } }
\ No newline at end of file
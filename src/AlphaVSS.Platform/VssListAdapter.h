@@ -21,7 +21,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
 		property int Count 
 		{ 
-			virtual int get() abstract; 
+			virtual int get(); 
 		}
 		
 		property bool IsReadOnly 
@@ -31,15 +31,70 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		
 		property T default[int] 
 		{
-			virtual T get (int index) abstract;
+			virtual T get (int index);
 			virtual void set (int index, T value);
 		};
 
+	internal:
+		// When set, the first enumeration of the list (or the first call to Contains, IndexOf or CopyTo) 
+		// captures the count and all elements of the underlying collection, and all subsequent accesses 
+		// are served from the captured elements until Invalidate() is called.
+		//
+		// The captured elements are owned by the list, and must not be disposed by the callers they are 
+		// handed out to. Since callers may still be using them, elements are not disposed when they are 
+		// discarded, but only by DisposeCapturedItems(). Elements read while the list is not capturing are 
+		// owned by the caller, as before.
+		property bool MaterializeOnRead 
+		{ 
+			bool get(); 
+			void set(bool value); 
+		}
+
+		// Discards any elements captured from the underlying collection, so that the next access reads 
+		// it again. The discarded elements remain valid until DisposeCapturedItems() is called. May be 
+		// called from any thread.
+		void Invalidate();
+
+		// Disposes the captured elements implementing IDisposable, including those discarded since the 
+		// list was created, and discards them. Called by the object owning the list when it is disposed.
+		void DisposeCapturedItems();
+
+		// Returns the captured elements if available, otherwise reads the current elements of the 
+		// underlying collection without capturing them.
+		array<T>^ ToArray();
+
+	protected:
+		VssListAdapter();
+
+		// Retrieves the number of elements in the underlying collection.
+		virtual int GetCount() abstract;
+
+		// Retrieves the element at the specified index from the underlying collection. The index 
+		// has already been validated by the caller.
+		virtual T GetItem(int index) abstract;
+
+	private:
+		array<T>^ GetCapturedItems();
+		array<T>^ GetMaterializedItems();
+		array<T>^ ReadItems();
+		void DiscardItems();
+		static void DisposeItems(array<T>^ items);
+
+		// Guards m_materializeOnRead, m_items and m_discardedItems, since the lists may be read by progress 
+		// reporting on a thread pool thread while the owning object is being used.
+		initonly Object^ m_lock;
+		bool m_materializeOnRead;
+		array<T>^ m_items;
+
+		// Captured elements discarded by Invalidate() or by changing MaterializeOnRead, kept to be disposed 
+		// by DisposeCapturedItems().
+		initonly System::Collections::Generic::List<array<T>^>^ m_discardedItems;
+
 	protected:
 		ref class Enumerator sealed : System::Collections::Generic::IEnumerator<T>
 		{
 		public:
-			Enumerator(VssListAdapter<T>^ list);
+			Enumerator(VssListAdapter<T>^ list, array<T>^ items);
 			~Enumerator();
 			!Enumerator();
 
@@ -57,7 +112,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 			}
 		private:
 			VssListAdapter<T>^ m_list;
+			array<T>^ m_items;
 			int m_index;
+			int m_count;
 		};
 	};
 } } }
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <vss.h>
+#include <VsMgmt.h>
+
+using namespace System;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   /****************************************************************************************
+     Helper methods for creating properties objects from VSS_MGMT_OBJECT_PROP structures
+    ****************************************************************************************/
+
+   template <typename IF>
+   inline IF^ CreatePropertiesObject(VSS_MGMT_OBJECT_PROP &prop)
+   {
+      throw gcnew NotImplementedException(String::Format(L"Unknown type in VSS_MGMT_OBJECT_PROP: {0}", (Int32)prop.Type));
+   }
+
+   
+   template <>
+   inline VssVolumeProperties^ CreatePropertiesObject<VssVolumeProperties>(VSS_MGMT_OBJECT_PROP &prop)
+   {
+      try
+      {
+         System::Diagnostics::Debug::Assert(prop.Type == VSS_MGMT_OBJECT_VOLUME, 
+            L"Unexpected type in VSS_MGMT_OBJECT_PROP object",
+            String::Format(L"Expected type to be VSS_MGMT_OBJECT_VOLUME ({0}), but it was {1}",
+            (Int32)VSS_MGMT_OBJECT_VOLUME, (Int32)prop.Type));
+         return gcnew VssVolumeProperties(gcnew String(prop.Obj.Vol.m_pwszVolumeName), gcnew String(prop.Obj.Vol.m_pwszVolumeDisplayName));
+      }
+      finally
+      {
+         ::CoTaskMemFree(prop.Obj.Vol.m_pwszVolumeName);
+         ::CoTaskMemFree(prop.Obj.Vol.m_pwszVolumeDisplayName);
+      }
+   }
+
+   
+   template <>
+   inline VssDiffVolumeProperties^ CreatePropertiesObject<VssDiffVolumeProperties>(VSS_MGMT_OBJECT_PROP &prop)
+   {
+      try
+      {
+         System::Diagnostics::Debug::Assert(prop.Type == VSS_MGMT_OBJECT_DIFF_VOLUME, 
+            L"Unexpected type in VSS_MGMT_OBJECT_PROP object",
+            String::Format(L"Expected type to be VSS_MGMT_OBJECT_DIFF_VOLUME ({0}), but it was {1}",
+            (Int32)VSS_MGMT_OBJECT_DIFF_VOLUME, (Int32)prop.Type));
+         return gcnew VssDiffVolumeProperties(gcnew String(prop.Obj.DiffVol.m_pwszVolumeName), 
+                                       gcnew String(prop.Obj.DiffVol.m_pwszVolumeDisplayName), 
+                                       prop.Obj.DiffVol.m_llVolumeFreeSpace, 
+                                       prop.Obj.DiffVol.m_llVolumeTotalSpace);
+      }
+      finally
+      {
+         ::CoTaskMemFree(prop.Obj.DiffVol.m_pwszVolumeName);
+         ::CoTaskMemFree(prop.Obj.DiffVol.m_pwszVolumeDisplayName);
+      }
+   }
+
+   
+   template <>
+   inline VssDiffAreaProperties^ CreatePropertiesObject<VssDiffAreaProperties>(VSS_MGMT_OBJECT_PROP &prop)
+   {
+      try
+      {
+         System::Diagnostics::Debug::Assert(prop.Type == VSS_MGMT_OBJECT_DIFF_AREA, 
+            L"Unexpected type in VSS_MGMT_OBJECT_PROP object",
+            String::Format(L"Expected type to be VSS_MGMT_OBJECT_DIFF_AREA ({0}), but it was {1}",
+            (Int32)VSS_MGMT_OBJECT_DIFF_AREA, (Int32)prop.Type));
+         return gcnew VssDiffAreaProperties(gcnew String(prop.Obj.DiffArea.m_pwszVolumeName),
+                                      gcnew String(prop.Obj.DiffArea.m_pwszDiffAreaVolumeName),
+                                      prop.Obj.DiffArea.m_llMaximumDiffSpace,
+                                      prop.Obj.DiffArea.m_llAllocatedDiffSpace,
+                                      prop.Obj.DiffArea.m_llUsedDiffSpace);
+      }
+      finally
+      {
+         ::CoTaskMemFree(prop.Obj.DiffArea.m_pwszVolumeName);
+         ::CoTaskMemFree(prop.Obj.DiffArea.m_pwszDiffAreaVolumeName);
+      }
+   }
+
+   
+   inline void FreePropertiesObject(VSS_MGMT_OBJECT_PROP &prop)
+   {
+      switch (prop.Type)
+      {
+      case VSS_MGMT_OBJECT_VOLUME:
+         ::CoTaskMemFree(prop.Obj.Vol.m_pwszVolumeName);
+         ::CoTaskMemFree(prop.Obj.Vol.m_pwszVolumeDisplayName);
+         break;
+      case VSS_MGMT_OBJECT_DIFF_VOLUME:
+         ::CoTaskMemFree(prop.Obj.DiffVol.m_pwszVolumeName);
+         ::CoTaskMemFree(prop.Obj.DiffVol.m_pwszVolumeDisplayName);
+         break;
+      case VSS_MGMT_OBJECT_DIFF_AREA:
+         ::CoTaskMemFree(prop.Obj.DiffArea.m_pwszVolumeName);
+         ::CoTaskMemFree(prop.Obj.DiffArea.m_pwszDiffAreaVolumeName);
+         break;
+      }
+   }
+
+   //
+   // Traits used by VssBatchEnumerable for enumerating objects of the specified type from an IVssEnumMgmtObject.
+   // Each element's strings are released as soon as the corresponding managed object has been created.
+   //
+   template <typename IF, VSS_MGMT_OBJECT_TYPE ObjectType>
+   struct MgmtObjectTraits
+   {
+      // An IVssEnumMgmtObject returned by a query only ever contains objects of the queried type, so anything
+      // else indicates a broken enumerator and is reported rather than skipped.
+      static bool IsMatch(VSS_MGMT_OBJECT_PROP &prop)
+      {
+         if (prop.Type != ObjectType)
+            throw gcnew InvalidOperationException(String::Format(L"Unexpected type in VSS_MGMT_OBJECT_PROP object. Expected type to be {0}, but it was {1}.",
+               (Int32)ObjectType, (Int32)prop.Type));
+
+         return true;
+      }
+
+      static IF^ Create(VSS_MGMT_OBJECT_PROP &prop)
+      {
+         return CreatePropertiesObject<IF>(prop);
+      }
+
+      static void Free(VSS_MGMT_OBJECT_PROP &prop)
+      {
+         FreePropertiesObject(prop);
+      }
+   };
+}
+}}
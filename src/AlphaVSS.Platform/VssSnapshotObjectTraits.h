@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vss.h>
+
+#include "FactoryMethods.h"
+
+using namespace System;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   //
+   // Traits used by VssBatchEnumerable for enumerating snapshots from an IVssEnumObject.
+   // Each element's strings are released as soon as the corresponding managed object has been created.
+   //
+   struct SnapshotObjectTraits
+   {
+      // An IVssEnumObject returned by a snapshot query only ever contains snapshots, so anything else indicates
+      // a broken enumerator and is reported rather than skipped, as MgmtObjectTraits does.
+      static bool IsMatch(VSS_OBJECT_PROP &prop)
+      {
+         if (prop.Type != VSS_OBJECT_SNAPSHOT)
+            throw gcnew InvalidOperationException(String::Format(L"Unexpected type in VSS_OBJECT_PROP object. Expected type to be {0}, but it was {1}.",
+               (Int32)VSS_OBJECT_SNAPSHOT, (Int32)prop.Type));
+
+         return true;
+      }
+
+      static VssSnapshotProperties^ Create(VSS_OBJECT_PROP &prop)
+      {
+         return CreateVssSnapshotProperties(&prop.Obj.Snap);
+      }
+
+      static void Free(VSS_OBJECT_PROP &prop)
+      {
+         if (prop.Type == VSS_OBJECT_SNAPSHOT)
+         {
+            ::VssFreeSnapshotProperties(&prop.Obj.Snap);
+         }
+         else if (prop.Type == VSS_OBJECT_PROVIDER)
+         {
+            ::CoTaskMemFree(prop.Obj.Prov.m_pwszProviderName);
+            ::CoTaskMemFree(prop.Obj.Prov.m_pwszProviderVersion);
+         }
+      }
+   };
+}
+}}
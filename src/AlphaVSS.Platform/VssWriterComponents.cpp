@@ -5,11 +5,13 @@
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
-	VssWriterComponents^ VssWriterComponents::Adopt(IVssWriterComponentsExt *vssWriterComponents)
+	VssWriterComponents^ VssWriterComponents::Adopt(IVssWriterComponentsExt *vssWriterComponents, bool materializeLists)
 	{
 		try
 		{
-			return gcnew VssWriterComponents(vssWriterComponents);
+			VssWriterComponents^ writerComponents = gcnew VssWriterComponents(vssWriterComponents);
+			writerComponents->m_components->MaterializeOnRead = materializeLists;
+			return writerComponents;
 		}
 		catch (...)
 		{
@@ -30,6 +32,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
 	VssWriterComponents::~VssWriterComponents()
 	{
+		// Disposes any components captured by the component list.
+		m_components->DisposeCapturedItems();
 		this->!VssWriterComponents();
 	}
 
@@ -57,7 +61,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 	{
 	}
 
-	int VssWriterComponents::ComponentList::Count::get()
+	int VssWriterComponents::ComponentList::GetCount()
 	{
 		if (mWriterComponents->mVssWriterComponents == 0)
 			throw gcnew ObjectDisposedException("Instance of IVssListAdapter must not be used after the object from which it was obtained has been disposed.");
@@ -67,14 +71,14 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		return cComponents;
 	}
 
-	IVssComponent^ VssWriterComponents::ComponentList::default::get(int index)
+	IVssComponent^ VssWriterComponents::ComponentList::GetItem(int index)
 	{
 		if (mWriterComponents->mVssWriterComponents == 0)
 			throw gcnew ObjectDisposedException("Instance of IVssListAdapter must not be used after the object from which it was obtained has been disposed.");
 
 		::IVssComponent *component;
 		CheckCom(mWriterComponents->mVssWriterComponents->GetComponent(index, &component));
-		return VssComponent::Adopt(component);
+		return VssComponent::Adopt(component, MaterializeOnRead);
 	}
 
 	IList<IVssComponent^>^ VssWriterComponents::Components::get()
@@ -18,7 +18,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		property Guid WriterId { virtual Guid get(); }
 
 	internal:
-		static VssWriterComponents^ Adopt(IVssWriterComponentsExt *vssWriterComponents);
+		static VssWriterComponents^ Adopt(IVssWriterComponentsExt *vssWriterComponents, bool materializeLists);
 	private:
 		VssWriterComponents(IVssWriterComponentsExt *vssWriterComponents);
 		IVssWriterComponentsExt *mVssWriterComponents;
@@ -28,8 +28,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		public:
 			ComponentList(VssWriterComponents^ component);
 
-			property int Count { virtual int get() override; }
-			property IVssComponent^ default[int] { virtual IVssComponent^ get(int index) override; }
+		protected:
+			virtual int GetCount() override;
+			virtual IVssComponent^ GetItem(int index) override;
 		private:
 			VssWriterComponents^ mWriterComponents;
 		};
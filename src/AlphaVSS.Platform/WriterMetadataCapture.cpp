@@ -0,0 +1,226 @@
+#include "pch.h"
+
+#include "WriterMetadataCapture.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   WriterMetadataCapture::WriterMetadataCapture()
+      : m_strings(gcnew Dictionary<String^, String^>(StringComparer::Ordinal))
+   {
+   }
+
+   IList<VssCapturedWriterMetadata^>^ WriterMetadataCapture::CaptureAll(::IVssBackupComponents *backup)
+   {
+      UINT cWriters;
+      CheckCom(backup->GetWriterMetadataCount(&cWriters));
+
+      List<VssCapturedWriterMetadata^>^ list = gcnew List<VssCapturedWriterMetadata^>(cWriters);
+      for (UINT i = 0; i < cWriters; i++)
+      {
+         VSS_ID idWriterInstance;
+         CComPtr<::IVssExamineWriterMetadata> spMetadata;
+         CheckCom(backup->GetWriterMetadata(i, &idWriterInstance, &spMetadata));
+         list->Add(Capture(spMetadata));
+      }
+
+      return list->AsReadOnly();
+   }
+
+   VssCapturedWriterMetadata^ WriterMetadataCapture::Capture(::IVssExamineWriterMetadata *metadata)
+   {
+      // Identity
+      VSS_ID idInstance, idWriter;
+      AutoBStr bsWriterName, bsInstanceName;
+      VSS_USAGE_TYPE usage;
+      VSS_SOURCE_TYPE source;
+
+      CComQIPtr<IVssExamineWriterMetadataEx> spMetadataEx(metadata);
+      if (spMetadataEx != 0)
+      {
+         CheckCom(spMetadataEx->GetIdentityEx(&idInstance, &idWriter, &bsWriterName, &bsInstanceName, &usage, &source));
+      }
+      else
+      {
+         CheckCom(metadata->GetIdentity(&idInstance, &idWriter, &bsWriterName, &usage, &source));
+      }
+
+      DWORD schema;
+      CheckCom(metadata->GetBackupSchema(&schema));
+
+      // Restore method and alternate location mappings
+      VSS_RESTOREMETHOD_ENUM eMethod;
+      AutoBStr bsService, bsUserProcedure;
+      VSS_WRITERRESTORE_ENUM eWriterRestore;
+      bool bRebootRequired;
+      UINT cMappings = 0;
+      HRESULT hr = metadata->GetRestoreMethod(&eMethod, &bsService, &bsUserProcedure, &eWriterRestore, &bRebootRequired, &cMappings);
+      if (FAILED(hr))
+         ThrowException(hr);
+
+      VssWMRestoreMethod^ restoreMethod = nullptr;
+      List<VssWMFileDescriptor^>^ alternateLocationMappings = gcnew List<VssWMFileDescriptor^>(hr == S_FALSE ? 0 : cMappings);
+      if (hr != S_FALSE)
+      {
+         restoreMethod = gcnew VssWMRestoreMethod((VssRestoreMethod)eMethod, Intern(bsService), Intern(bsUserProcedure), (VssWriterRestore)eWriterRestore, bRebootRequired, cMappings);
+         for (UINT i = 0; i < cMappings; i++)
+         {
+            IVssWMFiledesc *filedesc;
+            CheckCom(metadata->GetAlternateLocationMapping(i, &filedesc));
+            alternateLocationMappings->Add(CaptureFile(filedesc));
+         }
+      }
+
+      // Excluded files and components
+      UINT cIncludeFiles, cExcludeFiles, cComponents;
+      CheckCom(metadata->GetFileCounts(&cIncludeFiles, &cExcludeFiles, &cComponents));
+
+      List<VssWMFileDescriptor^>^ excludeFiles = gcnew List<VssWMFileDescriptor^>(cExcludeFiles);
+      for (UINT i = 0; i < cExcludeFiles; i++)
+      {
+         IVssWMFiledesc *filedesc;
+         CheckCom(metadata->GetExcludeFile(i, &filedesc));
+         excludeFiles->Add(CaptureFile(filedesc));
+      }
+
+      List<VssCapturedComponent^>^ components = gcnew List<VssCapturedComponent^>(cComponents);
+      for (UINT i = 0; i < cComponents; i++)
+      {
+         CComPtr<::IVssWMComponent> spComponent;
+         CheckCom(metadata->GetComponent(i, &spComponent));
+         components->Add(CaptureComponent(spComponent));
+      }
+
+      // Version and files excluded from snapshots, only available through IVssExamineWriterMetadataEx2
+      System::Version^ version = nullptr;
+      List<VssWMFileDescriptor^>^ excludeFromSnapshotFiles;
+      CComQIPtr<IVssExamineWriterMetadataEx2> spMetadataEx2(metadata);
+      if (spMetadataEx2 != 0)
+      {
+         DWORD dwMajorVersion, dwMinorVersion;
+         CheckCom(spMetadataEx2->GetVersion(&dwMajorVersion, &dwMinorVersion));
+         version = gcnew System::Version((int)dwMajorVersion, (int)dwMinorVersion);
+
+         UINT cExcludedFromSnapshot;
+         CheckCom(spMetadataEx2->GetExcludeFromSnapshotCount(&cExcludedFromSnapshot));
+         excludeFromSnapshotFiles = gcnew List<VssWMFileDescriptor^>(cExcludedFromSnapshot);
+         for (UINT i = 0; i < cExcludedFromSnapshot; i++)
+         {
+            IVssWMFiledesc *filedesc;
+            CheckCom(spMetadataEx2->GetExcludeFromSnapshotFile(i, &filedesc));
+            excludeFromSnapshotFiles->Add(CaptureFile(filedesc));
+         }
+      }
+      else
+      {
+         excludeFromSnapshotFiles = gcnew List<VssWMFileDescriptor^>(0);
+      }
+
+      AutoBStr bsXml;
+      CheckCom(metadata->SaveAsXML(&bsXml));
+
+      return gcnew VssCapturedWriterMetadata(ToGuid(idInstance), ToGuid(idWriter), Intern(bsWriterName), Intern(bsInstanceName),
+         (VssUsageType)usage, (VssSourceType)source, (VssBackupSchema)schema, version, restoreMethod,
+         alternateLocationMappings, excludeFiles, excludeFromSnapshotFiles, components, bsXml);
+   }
+
+   VssCapturedComponent^ WriterMetadataCapture::CaptureComponent(::IVssWMComponent *component)
+   {
+      PVSSCOMPONENTINFO info;
+      CheckCom(component->GetComponentInfo(&info));
+      try
+      {
+         array<byte>^ icon = nullptr;
+         if (info->pbIcon != 0)
+         {
+            icon = gcnew array<byte>(info->cbIcon);
+            System::Runtime::InteropServices::Marshal::Copy((IntPtr)info->pbIcon, icon, 0, info->cbIcon);
+         }
+
+         List<VssWMFileDescriptor^>^ files = gcnew List<VssWMFileDescriptor^>(info->cFileCount);
+         for (UINT i = 0; i < info->cFileCount; i++)
+         {
+            IVssWMFiledesc *filedesc;
+            CheckCom(component->GetFile(i, &filedesc));
+            files->Add(CaptureFile(filedesc));
+         }
+
+         List<VssWMFileDescriptor^>^ databaseFiles = gcnew List<VssWMFileDescriptor^>(info->cDatabases);
+         for (UINT i = 0; i < info->cDatabases; i++)
+         {
+            IVssWMFiledesc *filedesc;
+            CheckCom(component->GetDatabaseFile(i, &filedesc));
+            databaseFiles->Add(CaptureFile(filedesc));
+         }
+
+         List<VssWMFileDescriptor^>^ databaseLogFiles = gcnew List<VssWMFileDescriptor^>(info->cLogFiles);
+         for (UINT i = 0; i < info->cLogFiles; i++)
+         {
+            IVssWMFiledesc *filedesc;
+            CheckCom(component->GetDatabaseLogFile(i, &filedesc));
+            databaseLogFiles->Add(CaptureFile(filedesc));
+         }
+
+         List<VssWMDependency^>^ dependencies = gcnew List<VssWMDependency^>(info->cDependencies);
+         for (UINT i = 0; i < info->cDependencies; i++)
+         {
+            IVssWMDependency *dependency;
+            CheckCom(component->GetDependency(i, &dependency));
+            dependencies->Add(CaptureDependency(dependency));
+         }
+
+         return gcnew VssCapturedComponent((VssComponentType)info->type, Intern(FromBStr(info->bstrLogicalPath)), Intern(FromBStr(info->bstrComponentName)),
+            Intern(FromBStr(info->bstrCaption)), icon, info->bRestoreMetadata, info->bNotifyOnBackupComplete, info->bSelectable,
+            info->bSelectableForRestore, (VssComponentFlags)info->dwComponentFlags, files, databaseFiles, databaseLogFiles, dependencies);
+      }
+      finally
+      {
+         component->FreeComponentInfo(info);
+      }
+   }
+
+   VssWMFileDescriptor^ WriterMetadataCapture::CaptureFile(IVssWMFiledesc *filedesc)
+   {
+      // Like CreateVssWMFileDescriptor, but with interned strings.
+      CComPtr<IVssWMFiledesc> spFiledesc;
+      spFiledesc.Attach(filedesc);
+
+      AutoBStr bsAlternateLocation, bsFilespec, bsPath;
+      DWORD dwTypeMask = 0;
+      bool bRecursive;
+      CheckCom(spFiledesc->GetAlternateLocation(&bsAlternateLocation));
+      CheckCom(spFiledesc->GetBackupTypeMask(&dwTypeMask));
+      CheckCom(spFiledesc->GetFilespec(&bsFilespec));
+      CheckCom(spFiledesc->GetPath(&bsPath));
+      CheckCom(spFiledesc->GetRecursive(&bRecursive));
+
+      return gcnew VssWMFileDescriptor(Intern(bsAlternateLocation), (VssFileSpecificationBackupType)dwTypeMask, Intern(bsFilespec), Intern(bsPath), bRecursive);
+   }
+
+   VssWMDependency^ WriterMetadataCapture::CaptureDependency(IVssWMDependency *dependency)
+   {
+      CComPtr<IVssWMDependency> spDependency;
+      spDependency.Attach(dependency);
+
+      VSS_ID id;
+      AutoBStr bsLogicalPath, bsComponentName;
+      CheckCom(spDependency->GetWriterId(&id));
+      CheckCom(spDependency->GetLogicalPath(&bsLogicalPath));
+      CheckCom(spDependency->GetComponentName(&bsComponentName));
+
+      return gcnew VssWMDependency(ToGuid(id), Intern(bsLogicalPath), Intern(bsComponentName));
+   }
+
+   String^ WriterMetadataCapture::Intern(String^ str)
+   {
+      if (str == nullptr)
+         return nullptr;
+
+      String^ pooled;
+      if (m_strings->TryGetValue(str, pooled))
+         return pooled;
+
+      m_strings->Add(str, str);
+      return str;
+   }
+}
+} }
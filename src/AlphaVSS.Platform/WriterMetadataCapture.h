@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vss.h>
+#include <vsbackup.h>
+
+using namespace System::Collections::Generic;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   //
+   // Captures the complete contents of Writer Metadata Documents as VssCapturedWriterMetadata, in a single 
+   // pass over the native interfaces. Every count is retrieved once, every interface is released as soon as 
+   // it has been read, and strings are interned across all documents captured by the same instance.
+   //
+   private ref class WriterMetadataCapture sealed
+   {
+   public:
+      WriterMetadataCapture();
+
+      // Captures all writer metadata gathered by the specified backup components object.
+      IList<VssCapturedWriterMetadata^>^ CaptureAll(::IVssBackupComponents *backup);
+
+      // Captures the specified writer metadata. Does not release metadata.
+      VssCapturedWriterMetadata^ Capture(::IVssExamineWriterMetadata *metadata);
+
+   private:
+      VssCapturedComponent^ CaptureComponent(::IVssWMComponent *component);
+      VssWMFileDescriptor^ CaptureFile(IVssWMFiledesc *filedesc);
+      VssWMDependency^ CaptureDependency(IVssWMDependency *dependency);
+      String^ Intern(String^ str);
+
+      Dictionary<String^, String^>^ m_strings;
+   };
+}
+} }
@@ -23,6 +23,7 @@
 #include "Utils.h"
 #include "Macros.h"
 #include "Error.h"
+#include "Instrumentation.h"
 
 #include "FactoryMethods.h"
 #include "VssAsyncTaskFactory.h"
@@ -0,0 +1,92 @@
+
+using System;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// The <see cref="IVssAsyncResult"/> of an asynchronous operation of a simulated backup components object.
+   /// </summary>
+   internal sealed class VssSimulatedAsyncResult : IVssAsyncResult
+   {
+      #region Private Fields
+
+      private readonly CancellationTokenSource m_cancellationTokenSource;
+      private readonly Task m_task;
+      private readonly object m_state;
+
+      #endregion
+
+      #region Constructors
+
+      public VssSimulatedAsyncResult(Func<CancellationToken, Task> operation, AsyncCallback userCallback, object state)
+      {
+         m_cancellationTokenSource = new CancellationTokenSource();
+         m_state = state;
+         m_task = operation(m_cancellationTokenSource.Token);
+
+         if (userCallback != null)
+            m_task.ContinueWith(task => userCallback(this), CancellationToken.None, TaskContinuationOptions.ExecuteSynchronously, TaskScheduler.Default);
+      }
+
+      #endregion
+
+      #region IVssAsyncResult Members
+
+      public object AsyncState
+      {
+         get
+         {
+            return m_state;
+         }
+      }
+
+      public WaitHandle AsyncWaitHandle
+      {
+         get
+         {
+            return ((IAsyncResult)m_task).AsyncWaitHandle;
+         }
+      }
+
+      public bool CompletedSynchronously
+      {
+         get
+         {
+            return false;
+         }
+      }
+
+      public bool IsCompleted
+      {
+         get
+         {
+            return m_task.IsCompleted;
+         }
+      }
+
+      public void Cancel()
+      {
+         if (!m_task.IsCompleted)
+            m_cancellationTokenSource.Cancel();
+      }
+
+      public void Dispose()
+      {
+         if (m_task.IsCompleted)
+            m_cancellationTokenSource.Dispose();
+      }
+
+      #endregion
+
+      #region Internal Methods
+
+      internal void EndInvoke()
+      {
+         m_task.GetAwaiter().GetResult();
+      }
+
+      #endregion
+   }
+}
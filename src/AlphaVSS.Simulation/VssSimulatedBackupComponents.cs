@@ -0,0 +1,1316 @@
+
+using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Diagnostics;
+using System.Diagnostics.Tracing;
+using System.Globalization;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using System.Xml;
+using System.Xml.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// The <see cref="IVssBackupComponents"/> implementation of a <see cref="VssSimulatedFactory"/>.
+   /// </summary>
+   /// <remarks>
+   /// Like a VSS backup components object, an instance allows only one asynchronous operation at a time, and is not otherwise
+   /// thread-safe. Non-persistent snapshots created by an instance are deleted when the instance is disposed.
+   /// </remarks>
+   internal sealed class VssSimulatedBackupComponents : IVssBatchBackupComponents, IVssProgressBackupComponents
+   {
+      #region Private Types
+
+      private enum Mode
+      {
+         Uninitialized,
+         Backup,
+         Restore
+      }
+
+      #endregion
+
+      #region Private Fields
+
+      // The longest report interval supported, in milliseconds; the longest due time of a Timer.
+      private const double MaxReportInterval = 4294967294.0;
+
+      private readonly VssSimulatedFactory m_factory;
+      private readonly object m_lock = new object();
+      private readonly Guid m_sessionId = Guid.NewGuid();
+      private readonly List<VssSimulatedWriterComponents> m_writerComponents = new List<VssSimulatedWriterComponents>();
+      private readonly List<KeyValuePair<Guid, string>> m_snapshotSetVolumes = new List<KeyValuePair<Guid, string>>();
+      private readonly List<Guid> m_createdSnapshots = new List<Guid>();
+      private readonly HashSet<Guid> m_enabledWriterClasses = new HashSet<Guid>();
+      private readonly HashSet<Guid> m_disabledWriterClasses = new HashSet<Guid>();
+      private readonly HashSet<Guid> m_disabledWriterInstances = new HashSet<Guid>();
+
+      private Mode m_mode;
+      private VssVolumeSnapshotAttributes m_context;
+      private bool m_selectComponents;
+      private bool m_backupBootableSystemState;
+      private VssBackupType m_backupType;
+      private bool m_partialFileSupport;
+      private VssRestoreType m_restoreType;
+      private List<VssSimulatedWriter> m_writerMetadata;
+      private List<VssWriterStatusInfo> m_writerStatus;
+      private Guid m_snapshotSetId;
+      private bool m_preparedForBackup;
+      private bool m_snapshotSetCreated;
+      private int m_operationInProgress;
+      private bool m_disposed;
+
+      #endregion
+
+      #region Constructors
+
+      public VssSimulatedBackupComponents(VssSimulatedFactory factory)
+      {
+         m_factory = factory;
+         m_backupType = VssBackupType.Full;
+      }
+
+      #endregion
+
+      #region Lifetime
+
+      public void Dispose()
+      {
+         if (m_disposed)
+            return;
+
+         m_disposed = true;
+         m_factory.ExitSnapshotCreation(this);
+
+         // As with VSS, snapshots that are not persistent only live as long as the backup components object that created them.
+         if ((m_context & VssVolumeSnapshotAttributes.Persistent) == 0)
+         {
+            HashSet<Guid> created;
+            lock (m_lock)
+               created = new HashSet<Guid>(m_createdSnapshots);
+
+            if (created.Count > 0)
+               m_factory.DeleteSnapshots(snapshot => created.Contains(snapshot.SnapshotId));
+         }
+      }
+
+      #endregion
+
+      #region Initialization and State
+
+      public void InitializeForBackup(string xml)
+      {
+         Enter();
+         RequireMode(Mode.Uninitialized);
+         if (xml != null)
+            LoadDocument(xml);
+         m_mode = Mode.Backup;
+      }
+
+      public void InitializeForRestore(string xml)
+      {
+         if (xml == null)
+            throw new ArgumentNullException(nameof(xml));
+
+         Enter();
+         RequireMode(Mode.Uninitialized);
+         LoadDocument(xml);
+         m_mode = Mode.Restore;
+      }
+
+      public void SetContext(VssVolumeSnapshotAttributes context)
+      {
+         Enter();
+         if (m_snapshotSetId != Guid.Empty)
+            throw new VssBadStateException();
+         m_context = context;
+      }
+
+      public void SetContext(VssSnapshotContext context)
+      {
+         SetContext((VssVolumeSnapshotAttributes)context);
+      }
+
+      public void SetBackupState(bool selectComponents, bool backupBootableSystemState, VssBackupType backupType, bool partialFileSupport)
+      {
+         Enter();
+         RequireMode(Mode.Backup);
+         m_selectComponents = selectComponents;
+         m_backupBootableSystemState = backupBootableSystemState;
+         m_backupType = backupType;
+         m_partialFileSupport = partialFileSupport;
+      }
+
+      public void SetRestoreState(VssRestoreType restoreType)
+      {
+         Enter();
+         RequireMode(Mode.Restore);
+         m_restoreType = restoreType;
+      }
+
+      public Guid GetSessionId()
+      {
+         Enter();
+         return m_sessionId;
+      }
+
+      public bool MaterializeCollections { get; set; }
+
+      public string SaveAsXml()
+      {
+         Enter();
+         if (m_mode == Mode.Uninitialized)
+            throw new VssBadStateException();
+
+         XElement root = new XElement("BACKUP_COMPONENTS",
+            new XAttribute("version", "1.2"),
+            new XAttribute("selectComponents", VssXmlConvert.ToString(m_selectComponents)),
+            new XAttribute("bootableSystemStateBackup", VssXmlConvert.ToString(m_backupBootableSystemState)),
+            new XAttribute("backupType", m_backupType),
+            new XAttribute("partialFileSupport", VssXmlConvert.ToString(m_partialFileSupport)),
+            new XAttribute("restoreType", m_restoreType),
+            new XAttribute("context", (int)m_context));
+
+         if (m_snapshotSetId != Guid.Empty)
+            root.SetAttributeValue("snapshotSetId", VssXmlConvert.ToString(m_snapshotSetId));
+
+         lock (m_lock)
+         {
+            foreach (VssSimulatedWriterComponents writer in m_writerComponents)
+            {
+               root.Add(new XElement("WRITER_COMPONENTS",
+                  new XAttribute("instanceId", VssXmlConvert.ToString(writer.InstanceId)),
+                  new XAttribute("writerId", VssXmlConvert.ToString(writer.WriterId)),
+                  writer.Components.Cast<VssSimulatedComponentState>().Select(component => component.ToXml())));
+            }
+         }
+
+         return root.ToString(SaveOptions.DisableFormatting);
+      }
+
+      #endregion
+
+      #region Writers
+
+      public void EnableWriterClasses(params Guid[] writerClassIds)
+      {
+         UpdateWriterFilter(m_enabledWriterClasses, writerClassIds);
+      }
+
+      public void DisableWriterClasses(params Guid[] writerClassIds)
+      {
+         UpdateWriterFilter(m_disabledWriterClasses, writerClassIds);
+      }
+
+      public void DisableWriterInstances(params Guid[] writerInstanceIds)
+      {
+         UpdateWriterFilter(m_disabledWriterInstances, writerInstanceIds);
+      }
+
+      public void GatherWriterMetadata()
+      {
+         Wait(GatherWriterMetadataAsync(CancellationToken.None));
+      }
+
+      public Task GatherWriterMetadataAsync(CancellationToken cancellationToken)
+      {
+         return StartGatherWriterMetadata(null, TimeSpan.Zero, cancellationToken);
+      }
+
+      public Task GatherWriterMetadataAsync(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         CheckProgressArguments(progress, reportInterval);
+         return StartGatherWriterMetadata(progress, reportInterval, cancellationToken);
+      }
+
+      private Task StartGatherWriterMetadata(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         Enter();
+         if (m_mode == Mode.Uninitialized)
+            throw new VssBadStateException();
+
+         return StartOperation("GatherWriterMetadata", () =>
+         {
+            m_writerMetadata = m_factory.Options.Writers.Where(IsWriterEnabled).ToList();
+            m_writerStatus = null;
+         }, progress, reportInterval, cancellationToken);
+      }
+
+      public IVssAsyncResult BeginGatherWriterMetadata(AsyncCallback userCallback, object state)
+      {
+         return Begin(GatherWriterMetadataAsync, userCallback, state);
+      }
+
+      public void EndGatherWriterMetadata(IAsyncResult asyncResult)
+      {
+         End(asyncResult);
+      }
+
+      public void GatherWriterStatus()
+      {
+         Wait(GatherWriterStatusAsync(CancellationToken.None));
+      }
+
+      public Task GatherWriterStatusAsync(CancellationToken cancellationToken)
+      {
+         return StartGatherWriterStatus(null, TimeSpan.Zero, cancellationToken);
+      }
+
+      public Task GatherWriterStatusAsync(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         CheckProgressArguments(progress, reportInterval);
+         return StartGatherWriterStatus(progress, reportInterval, cancellationToken);
+      }
+
+      private Task StartGatherWriterStatus(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         Enter();
+         if (m_writerMetadata == null)
+            throw new VssBadStateException();
+
+         return StartOperation("GatherWriterStatus", () =>
+         {
+            m_writerStatus = m_writerMetadata.Select(writer => new VssWriterStatusInfo(writer.InstanceId, writer.WriterId, writer.WriterName, writer.State, writer.Failure)).ToList();
+         }, progress, reportInterval, cancellationToken);
+      }
+
+      public IVssAsyncResult BeginGatherWriterStatus(AsyncCallback userCallback, object state)
+      {
+         return Begin(GatherWriterStatusAsync, userCallback, state);
+      }
+
+      public void EndGatherWriterStatus(IAsyncResult asyncResult)
+      {
+         End(asyncResult);
+      }
+
+      public void FreeWriterMetadata()
+      {
+         Enter();
+         lock (m_lock)
+            m_writerMetadata = null;
+      }
+
+      public void FreeWriterStatus()
+      {
+         Enter();
+         lock (m_lock)
+            m_writerStatus = null;
+      }
+
+      public IList<IVssExamineWriterMetadata> WriterMetadata
+      {
+         get
+         {
+            Enter();
+            lock (m_lock)
+            {
+               if (m_writerMetadata == null || m_operationInProgress != 0)
+                  throw new VssBadStateException();
+
+               return new ReadOnlyCollection<IVssExamineWriterMetadata>(m_writerMetadata.ToArray());
+            }
+         }
+      }
+
+      public IList<VssCapturedWriterMetadata> CaptureWriterMetadata()
+      {
+         return VssCapturedWriterMetadata.Capture(WriterMetadata);
+      }
+
+      public IList<VssWriterStatusInfo> WriterStatus
+      {
+         get
+         {
+            Enter();
+            lock (m_lock)
+            {
+               if (m_writerStatus == null || m_operationInProgress != 0)
+                  throw new VssBadStateException();
+
+               return new ReadOnlyCollection<VssWriterStatusInfo>(m_writerStatus.ToArray());
+            }
+         }
+      }
+
+      public IList<IVssWriterComponents> WriterComponents
+      {
+         get
+         {
+            Enter();
+            lock (m_lock)
+               return new ReadOnlyCollection<IVssWriterComponents>(m_writerComponents.ToArray());
+         }
+      }
+
+      #endregion
+
+      #region Components
+
+      public void AddComponent(Guid instanceId, Guid writerId, VssComponentType componentType, string logicalPath, string componentName)
+      {
+         if (componentName == null)
+            throw new ArgumentNullException(nameof(componentName));
+
+         Enter();
+         RequireMode(Mode.Backup);
+         if (m_writerMetadata == null)
+            throw new VssBadStateException();
+
+         VssSimulatedWriter writer = m_writerMetadata.FirstOrDefault(w => w.InstanceId == instanceId && w.WriterId == writerId);
+         if (writer == null || !writer.Components.Any(c => c.Type == componentType && String.Equals(c.LogicalPath ?? String.Empty, logicalPath ?? String.Empty, StringComparison.OrdinalIgnoreCase) && String.Equals(c.ComponentName, componentName, StringComparison.OrdinalIgnoreCase)))
+            throw new VssObjectNotFoundException();
+
+         lock (m_lock)
+         {
+            VssSimulatedWriterComponents components = m_writerComponents.FirstOrDefault(w => w.InstanceId == instanceId && w.WriterId == writerId);
+            if (components == null)
+            {
+               components = new VssSimulatedWriterComponents(instanceId, writerId);
+               m_writerComponents.Add(components);
+            }
+            else if (components.Components.Cast<VssSimulatedComponentState>().Any(c => c.Matches(componentType, logicalPath, componentName)))
+            {
+               throw new VssObjectAlreadyExistsException();
+            }
+
+            components.Components.Add(new VssSimulatedComponentState(componentType, logicalPath, componentName));
+         }
+      }
+
+      public IList<VssComponentSelectionFailure> AddComponents(IEnumerable<VssComponentSelection> components)
+      {
+         return SelectComponents(components, component =>
+         {
+            AddComponent(component.InstanceId, component.WriterId, component.ComponentType, component.LogicalPath, component.ComponentName);
+
+            if (component.BackupOptions != null)
+               SetBackupOptions(component.WriterId, component.ComponentType, component.LogicalPath, component.ComponentName, component.BackupOptions);
+
+            if (component.PreviousBackupStamp != null)
+               SetPreviousBackupStamp(component.WriterId, component.ComponentType, component.LogicalPath, component.ComponentName, component.PreviousBackupStamp);
+         });
+      }
+
+      public IList<VssComponentSelectionFailure> SetBackupSucceeded(IEnumerable<VssComponentSelection> components, bool succeeded)
+      {
+         return SelectComponents(components, component =>
+            SetBackupSucceeded(component.InstanceId, component.WriterId, component.ComponentType, component.LogicalPath, component.ComponentName, succeeded));
+      }
+
+      public void SetBackupSucceeded(Guid instanceId, Guid writerId, VssComponentType componentType, string logicalPath, string componentName, bool succeeded)
+      {
+         FindComponent(instanceId, writerId, componentType, logicalPath, componentName).BackupSucceeded = succeeded;
+      }
+
+      public void SetBackupOptions(Guid writerId, VssComponentType componentType, string logicalPath, string componentName, string backupOptions)
+      {
+         FindComponent(writerId, componentType, logicalPath, componentName).BackupOptions = backupOptions;
+      }
+
+      public void SetPreviousBackupStamp(Guid writerId, VssComponentType componentType, string logicalPath, string componentName, string previousBackupStamp)
+      {
+         FindComponent(writerId, componentType, logicalPath, componentName).PreviousBackupStamp = previousBackupStamp;
+      }
+
+      public void SetRangesFilePath(Guid writerId, VssComponentType componentType, string logicalPath, string componentName, int partialFileIndex, string rangesFile)
+      {
+         VssSimulatedComponentState component = FindComponent(writerId, componentType, logicalPath, componentName);
+         if (partialFileIndex < 0 || partialFileIndex >= component.PartialFiles.Count)
+            throw new VssObjectNotFoundException();
+
+         VssPartialFileInfo partialFile = component.PartialFiles[partialFileIndex];
+         component.PartialFiles[partialFileIndex] = new VssPartialFileInfo(partialFile.Path, partialFile.FileName, rangesFile, partialFile.Metadata);
+      }
+
+      public void SetAdditionalRestores(Guid writerId, VssComponentType componentType, string logicalPath, string componentName, bool additionalResources)
+      {
+         FindComponent(writerId, componentType, logicalPath, componentName).AdditionalRestores = additionalResources;
+      }
+
+      public void SetFileRestoreStatus(Guid writerId, VssComponentType componentType, string logicalPath, string componentName, VssFileRestoreStatus status)
+      {
+         FindComponent(writerId, componentType, logicalPath, componentName).FileRestoreStatus = status;
+      }
+
+      public void SetRestoreOptions(Guid writerId, VssComponentType componentType, string logicalPath, string componentName, string restoreOptions)
+      {
+         FindComponent(writerId, componentType, logicalPath, componentName).RestoreOptions = restoreOptions;
+      }
+
+      public void SetSelectedForRestore(Guid writerId, VssComponentType componentType, string logicalPath, string componentName, bool selectedForRestore)
+      {
+         FindComponent(writerId, componentType, logicalPath, componentName).IsSelectedForRestore = selectedForRestore;
+      }
+
+      public void SetSelectedForRestore(Guid writerId, VssComponentType componentType, string logicalPath, string componentName, bool selectedForRestore, Guid instanceId)
+      {
+         FindComponent(instanceId, writerId, componentType, logicalPath, componentName).IsSelectedForRestore = selectedForRestore;
+      }
+
+      public void SetAuthoritativeRestore(Guid writerId, VssComponentType componentType, string logicalPath, string componentName, bool isAuthorative)
+      {
+         FindComponent(writerId, componentType, logicalPath, componentName).IsAuthoritativeRestore = isAuthorative;
+      }
+
+      public void SetRestoreName(Guid writerId, VssComponentType componentType, string logicalPath, string componentName, string restoreName)
+      {
+         FindComponent(writerId, componentType, logicalPath, componentName).RestoreName = restoreName;
+      }
+
+      public void SetRollForward(Guid writerId, VssComponentType componentType, string logicalPath, string componentName, VssRollForwardType rollType, string rollForwardPoint)
+      {
+         VssSimulatedComponentState component = FindComponent(writerId, componentType, logicalPath, componentName);
+         component.RollForwardType = rollType;
+         component.RollForwardRestorePoint = rollForwardPoint;
+      }
+
+      public void AddAlternativeLocationMapping(Guid writerId, VssComponentType componentType, string logicalPath, string componentName, string path, string filespec, bool recursive, string destination)
+      {
+         CheckNotNull(path, filespec, destination);
+         FindComponent(writerId, componentType, logicalPath, componentName).AlternateLocationMappings.Add(
+            new VssWMFileDescriptor(destination, VssFileSpecificationBackupType.Unknown, filespec, path, recursive));
+      }
+
+      public void AddNewTarget(Guid writerId, VssComponentType componentType, string logicalPath, string componentName, string path, string fileName, bool recursive, string alternatePath)
+      {
+         CheckNotNull(path, fileName, alternatePath);
+         VssSimulatedComponentState component = FindComponent(writerId, componentType, logicalPath, componentName);
+         component.NewTargets.Add(new VssWMFileDescriptor(alternatePath, VssFileSpecificationBackupType.Unknown, fileName, path, recursive));
+         component.RestoreTarget = VssRestoreTarget.Alternate;
+      }
+
+      public void AddRestoreSubcomponent(Guid writerId, VssComponentType componentType, string logicalPath, string componentName, string subcomponentLogicalPath, string subcomponentName)
+      {
+         CheckNotNull(subcomponentLogicalPath, subcomponentName, String.Empty);
+         FindComponent(writerId, componentType, logicalPath, componentName).RestoreSubcomponents.Add(
+            new VssRestoreSubcomponentInfo(subcomponentLogicalPath, subcomponentName));
+      }
+
+      #endregion
+
+      #region Snapshot Sets
+
+      public Guid StartSnapshotSet()
+      {
+         Enter();
+         if (m_mode == Mode.Uninitialized)
+            throw new VssBadStateException();
+
+         if (m_snapshotSetId != Guid.Empty || !m_factory.TryEnterSnapshotCreation(this))
+            throw new VssSnapshotSetInProgressException();
+
+         m_snapshotSetId = Guid.NewGuid();
+         return m_snapshotSetId;
+      }
+
+      public Guid AddToSnapshotSet(string volumeName)
+      {
+         return AddToSnapshotSet(volumeName, Guid.Empty);
+      }
+
+      public Guid AddToSnapshotSet(string volumeName, Guid providerId)
+      {
+         if (volumeName == null)
+            throw new ArgumentNullException(nameof(volumeName));
+
+         Enter();
+         if (m_snapshotSetId == Guid.Empty || m_snapshotSetCreated)
+            throw new VssBadStateException();
+
+         if (providerId != Guid.Empty && providerId != m_factory.Options.ProviderId)
+            throw new VssProviderNotRegisteredException();
+
+         string volume = m_factory.FindVolume(volumeName);
+         if (volume == null)
+            throw new VssVolumeNotSupportedException();
+
+         lock (m_lock)
+         {
+            if (m_snapshotSetVolumes.Any(entry => entry.Value == volume))
+               throw new VssObjectAlreadyExistsException();
+
+            Guid snapshotId = Guid.NewGuid();
+            m_snapshotSetVolumes.Add(new KeyValuePair<Guid, string>(snapshotId, volume));
+            return snapshotId;
+         }
+      }
+
+      public void PrepareForBackup()
+      {
+         Wait(PrepareForBackupAsync(CancellationToken.None));
+      }
+
+      public Task PrepareForBackupAsync(CancellationToken cancellationToken)
+      {
+         return StartPrepareForBackup(null, TimeSpan.Zero, cancellationToken);
+      }
+
+      public Task PrepareForBackupAsync(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         CheckProgressArguments(progress, reportInterval);
+         return StartPrepareForBackup(progress, reportInterval, cancellationToken);
+      }
+
+      private Task StartPrepareForBackup(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         Enter();
+         RequireMode(Mode.Backup);
+         if (m_snapshotSetId == Guid.Empty || m_snapshotSetCreated)
+            throw new VssBadStateException();
+
+         return StartOperation("PrepareForBackup", () => m_preparedForBackup = true, progress, reportInterval, cancellationToken);
+      }
+
+      public IVssAsyncResult BeginPrepareForBackup(AsyncCallback userCallback, object state)
+      {
+         return Begin(PrepareForBackupAsync, userCallback, state);
+      }
+
+      public void EndPrepareForBackup(IAsyncResult asyncResult)
+      {
+         End(asyncResult);
+      }
+
+      public void DoSnapshotSet()
+      {
+         Wait(DoSnapshotSetAsync(CancellationToken.None));
+      }
+
+      public Task DoSnapshotSetAsync(CancellationToken cancellationToken)
+      {
+         return StartDoSnapshotSet(null, TimeSpan.Zero, cancellationToken);
+      }
+
+      public Task DoSnapshotSetAsync(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         CheckProgressArguments(progress, reportInterval);
+         return StartDoSnapshotSet(progress, reportInterval, cancellationToken);
+      }
+
+      private Task StartDoSnapshotSet(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         Enter();
+         bool requiresPrepare = m_mode == Mode.Backup && (m_context & VssVolumeSnapshotAttributes.NoWriters) == 0;
+         if (m_snapshotSetId == Guid.Empty || m_snapshotSetCreated || m_snapshotSetVolumes.Count == 0 || (requiresPrepare && !m_preparedForBackup))
+            throw new VssBadStateException();
+
+         // The snapshot set is normally still in progress since StartSnapshotSet, unless a failed DoSnapshotSet is retried.
+         if (!m_factory.TryEnterSnapshotCreation(this))
+            throw new VssSnapshotSetInProgressException();
+
+         try
+         {
+            return StartOperation("DoSnapshotSet", CreateSnapshots, progress, reportInterval, true, cancellationToken);
+         }
+         catch
+         {
+            m_factory.ExitSnapshotCreation(this);
+            throw;
+         }
+      }
+
+      public IVssAsyncResult BeginDoSnapshotSet(AsyncCallback userCallback, object state)
+      {
+         return Begin(DoSnapshotSetAsync, userCallback, state);
+      }
+
+      public void EndDoSnapshotSet(IAsyncResult asyncResult)
+      {
+         End(asyncResult);
+      }
+
+      public void BackupComplete()
+      {
+         Wait(BackupCompleteAsync(CancellationToken.None));
+      }
+
+      public Task BackupCompleteAsync(CancellationToken cancellationToken)
+      {
+         return StartBackupComplete(null, TimeSpan.Zero, cancellationToken);
+      }
+
+      public Task BackupCompleteAsync(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         CheckProgressArguments(progress, reportInterval);
+         return StartBackupComplete(progress, reportInterval, cancellationToken);
+      }
+
+      private Task StartBackupComplete(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         Enter();
+         RequireMode(Mode.Backup);
+         if (!m_snapshotSetCreated)
+            throw new VssBadStateException();
+
+         return StartOperation("BackupComplete", () => { }, progress, reportInterval, cancellationToken);
+      }
+
+      public IVssAsyncResult BeginBackupComplete(AsyncCallback userCallback, object state)
+      {
+         return Begin(BackupCompleteAsync, userCallback, state);
+      }
+
+      public void EndBackupComplete(IAsyncResult asyncResult)
+      {
+         End(asyncResult);
+      }
+
+      public void AbortBackup()
+      {
+         Enter();
+         RequireMode(Mode.Backup);
+         m_factory.ExitSnapshotCreation(this);
+         m_snapshotSetId = Guid.Empty;
+         m_snapshotSetCreated = false;
+         m_preparedForBackup = false;
+         lock (m_lock)
+            m_snapshotSetVolumes.Clear();
+      }
+
+      #endregion
+
+      #region Restore
+
+      public void PreRestore()
+      {
+         Wait(PreRestoreAsync(CancellationToken.None));
+      }
+
+      public Task PreRestoreAsync(CancellationToken cancellationToken)
+      {
+         return StartPreRestore(null, TimeSpan.Zero, cancellationToken);
+      }
+
+      public Task PreRestoreAsync(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         CheckProgressArguments(progress, reportInterval);
+         return StartPreRestore(progress, reportInterval, cancellationToken);
+      }
+
+      private Task StartPreRestore(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         Enter();
+         RequireMode(Mode.Restore);
+         return StartOperation("PreRestore", () => { }, progress, reportInterval, cancellationToken);
+      }
+
+      public IVssAsyncResult BeginPreRestore(AsyncCallback userCallback, object state)
+      {
+         return Begin(PreRestoreAsync, userCallback, state);
+      }
+
+      public void EndPreRestore(IAsyncResult asyncResult)
+      {
+         End(asyncResult);
+      }
+
+      public void PostRestore()
+      {
+         Wait(PostRestoreAsync(CancellationToken.None));
+      }
+
+      public Task PostRestoreAsync(CancellationToken cancellationToken)
+      {
+         return StartPostRestore(null, TimeSpan.Zero, cancellationToken);
+      }
+
+      public Task PostRestoreAsync(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         CheckProgressArguments(progress, reportInterval);
+         return StartPostRestore(progress, reportInterval, cancellationToken);
+      }
+
+      private Task StartPostRestore(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         Enter();
+         RequireMode(Mode.Restore);
+         return StartOperation("PostRestore", () => { }, progress, reportInterval, cancellationToken);
+      }
+
+      public IVssAsyncResult BeginPostRestore(AsyncCallback userCallback, object state)
+      {
+         return Begin(PostRestoreAsync, userCallback, state);
+      }
+
+      public void EndPostRestore(IAsyncResult asyncResult)
+      {
+         End(asyncResult);
+      }
+
+      #endregion
+
+      #region Snapshots
+
+      public VssSnapshotProperties GetSnapshotProperties(Guid snapshotId)
+      {
+         Enter();
+         return m_factory.GetSnapshot(snapshotId);
+      }
+
+      public IEnumerable<VssSnapshotProperties> QuerySnapshots()
+      {
+         Enter();
+         return m_factory.GetSnapshots();
+      }
+
+      public IEnumerable<VssSnapshotProperties> QuerySnapshots(int batchSize)
+      {
+         if (batchSize < 1)
+            throw new ArgumentOutOfRangeException(nameof(batchSize), "The batch size must be greater than zero.");
+
+         Enter();
+         return QuerySnapshotBatches(batchSize);
+      }
+
+      // Like the platform specific implementation, the snapshots are fetched a batch at a time as the sequence is enumerated, 
+      // so snapshots created or deleted during enumeration may or may not be returned.
+      private IEnumerable<VssSnapshotProperties> QuerySnapshotBatches(int batchSize)
+      {
+         for (int position = 0; ; position += batchSize)
+         {
+            VssSnapshotProperties[] batch = m_factory.GetSnapshots(position, batchSize);
+            foreach (VssSnapshotProperties snapshot in batch)
+               yield return snapshot;
+
+            if (batch.Length < batchSize)
+               yield break;
+         }
+      }
+
+      public IEnumerable<VssProviderProperties> QueryProviders()
+      {
+         Enter();
+         VssSimulationOptions options = m_factory.Options;
+         return new[] { new VssProviderProperties(options.ProviderId, options.ProviderName, VssProviderType.System, "1.0.0.7", options.ProviderId, options.ProviderId) };
+      }
+
+      public void DeleteSnapshot(Guid snapshotId, bool forceDelete)
+      {
+         Enter();
+         if (m_factory.DeleteSnapshots(snapshot => snapshot.SnapshotId == snapshotId) == 0)
+            throw new VssObjectNotFoundException();
+      }
+
+      public int DeleteSnapshotSet(Guid snapshotSetId, bool forceDelete)
+      {
+         Enter();
+         int count = m_factory.DeleteSnapshots(snapshot => snapshot.SnapshotSetId == snapshotSetId);
+         if (count == 0)
+            throw new VssObjectNotFoundException();
+         return count;
+      }
+
+      public string ExposeSnapshot(Guid snapshotId, string pathFromRoot, VssVolumeSnapshotAttributes attributes, string expose)
+      {
+         Enter();
+         VssSnapshotProperties snapshot = m_factory.GetSnapshot(snapshotId);
+         if (snapshot.ExposedName != null)
+            throw new VssObjectAlreadyExistsException();
+
+         string exposedName = expose ?? snapshot.SnapshotId.ToString("B", CultureInfo.InvariantCulture);
+         m_factory.ReplaceSnapshot(new VssSnapshotProperties(snapshot.SnapshotId, snapshot.SnapshotSetId, snapshot.SnapshotsCount,
+            snapshot.SnapshotDeviceObject, snapshot.OriginalVolumeName, snapshot.OriginatingMachine, snapshot.ServiceMachine,
+            exposedName, pathFromRoot, snapshot.ProviderId, snapshot.SnapshotAttributes | attributes, snapshot.CreationTimestamp, snapshot.Status));
+         return exposedName;
+      }
+
+      public void UnexposeSnapshot(Guid snapshotId)
+      {
+         Enter();
+         VssSnapshotProperties snapshot = m_factory.GetSnapshot(snapshotId);
+         if (snapshot.ExposedName == null)
+            throw new VssObjectNotFoundException();
+
+         m_factory.ReplaceSnapshot(new VssSnapshotProperties(snapshot.SnapshotId, snapshot.SnapshotSetId, snapshot.SnapshotsCount,
+            snapshot.SnapshotDeviceObject, snapshot.OriginalVolumeName, snapshot.OriginatingMachine, snapshot.ServiceMachine,
+            null, null, snapshot.ProviderId,
+            snapshot.SnapshotAttributes & ~(VssVolumeSnapshotAttributes.ExposedLocally | VssVolumeSnapshotAttributes.ExposedRemotely),
+            snapshot.CreationTimestamp, snapshot.Status));
+      }
+
+      public bool IsVolumeSupported(string volumeName)
+      {
+         return IsVolumeSupported(volumeName, Guid.Empty);
+      }
+
+      public bool IsVolumeSupported(string volumeName, Guid providerId)
+      {
+         Enter();
+         return (providerId == Guid.Empty || providerId == m_factory.Options.ProviderId) && m_factory.FindVolume(volumeName) != null;
+      }
+
+      public void BreakSnapshotSet(Guid snapshotSetId)
+      {
+         Enter();
+         if (m_factory.DeleteSnapshots(snapshot => snapshot.SnapshotSetId == snapshotSetId) == 0)
+            throw new VssObjectNotFoundException();
+      }
+
+      public void BreakSnapshotSet(Guid snapshotSetId, VssHardwareOptions breakFlags)
+      {
+         Wait(BreakSnapshotSetAsync(snapshotSetId, breakFlags, CancellationToken.None));
+      }
+
+      public Task BreakSnapshotSetAsync(Guid snapshotSetId, VssHardwareOptions breakFlags, CancellationToken cancellationToken)
+      {
+         Enter();
+         if (!m_factory.GetSnapshots().Any(snapshot => snapshot.SnapshotSetId == snapshotSetId))
+            throw new VssObjectNotFoundException();
+
+         return StartOperation("BreakSnapshotSet", () => m_factory.DeleteSnapshots(snapshot => snapshot.SnapshotSetId == snapshotSetId), null, TimeSpan.Zero, cancellationToken);
+      }
+
+      public IVssAsyncResult BeginBreakSnapshotSet(Guid snapshotSetId, VssHardwareOptions breakFlags, AsyncCallback userCallback, object state)
+      {
+         return Begin(cancellationToken => BreakSnapshotSetAsync(snapshotSetId, breakFlags, cancellationToken), userCallback, state);
+      }
+
+      public void EndBreakSnapshotSet(IAsyncResult asyncResult)
+      {
+         End(asyncResult);
+      }
+
+      public Task QueryRevertStatusAsync(string volumeName, CancellationToken cancellationToken)
+      {
+         if (volumeName == null)
+            throw new ArgumentNullException(nameof(volumeName));
+
+         Enter();
+         if (m_factory.FindVolume(volumeName) == null)
+            throw new VssObjectNotFoundException();
+
+         // No volume of the simulated system is ever being reverted.
+         return StartOperation("QueryRevertStatus", () => { }, null, TimeSpan.Zero, cancellationToken);
+      }
+
+      public IVssAsyncResult BeginQueryRevertStatus(string volumeName, AsyncCallback userCallback, object state)
+      {
+         return Begin(cancellationToken => QueryRevertStatusAsync(volumeName, cancellationToken), userCallback, state);
+      }
+
+      public void EndQueryRevertStatus(IAsyncResult asyncResult)
+      {
+         End(asyncResult);
+      }
+
+      public VssRootAndLogicalPrefixPaths GetRootAndLogicalPrefixPaths(string filePath, bool normalizeFQDNforRootPath)
+      {
+         if (filePath == null)
+            throw new ArgumentNullException(nameof(filePath));
+
+         Enter();
+         string volume = m_factory.Options.Volumes.FirstOrDefault(v => filePath.StartsWith(v.TrimEnd('\\') + "\\", StringComparison.OrdinalIgnoreCase)
+            || String.Equals(filePath.TrimEnd('\\'), v.TrimEnd('\\'), StringComparison.OrdinalIgnoreCase));
+         if (volume == null)
+            throw new VssObjectNotFoundException();
+
+         return new VssRootAndLogicalPrefixPaths(volume, volume);
+      }
+
+      #endregion
+
+      #region Unsupported Operations
+
+      public void ImportSnapshots()
+      {
+         throw new NotSupportedException("Transportable snapshots are not supported by the simulation.");
+      }
+
+      public Task ImportSnapshotsAsync(CancellationToken cancellationToken)
+      {
+         throw new NotSupportedException("Transportable snapshots are not supported by the simulation.");
+      }
+
+      public IVssAsyncResult BeginImportSnapshots(AsyncCallback userCallback, object state)
+      {
+         throw new NotSupportedException("Transportable snapshots are not supported by the simulation.");
+      }
+
+      public void EndImportSnapshots(IAsyncResult asyncResult)
+      {
+         End(asyncResult);
+      }
+
+      public void RevertToSnapshot(Guid snapshotId, bool forceDismount)
+      {
+         throw new NotSupportedException("Reverting volumes is not supported by the simulation.");
+      }
+
+      public void AddSnapshotToRecoverySet(Guid snapshotId, string destinationVolume)
+      {
+         throw new NotSupportedException("Recovery sets are not supported by the simulation.");
+      }
+
+      public void RecoverSet(VssRecoveryOptions options)
+      {
+         throw new NotSupportedException("Recovery sets are not supported by the simulation.");
+      }
+
+      public Task RecoverSetAsync(VssRecoveryOptions options, CancellationToken cancellationToken)
+      {
+         throw new NotSupportedException("Recovery sets are not supported by the simulation.");
+      }
+
+      public IVssAsyncResult BeginRecoverSet(VssRecoveryOptions options, AsyncCallback userCallback, object state)
+      {
+         throw new NotSupportedException("Recovery sets are not supported by the simulation.");
+      }
+
+      public void EndRecoverSet(IAsyncResult asyncResult)
+      {
+         End(asyncResult);
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private void Enter()
+      {
+         if (m_disposed)
+            throw new ObjectDisposedException(GetType().Name);
+
+         m_factory.SimulateCall();
+      }
+
+      private void RequireMode(Mode mode)
+      {
+         if (m_mode != mode)
+            throw new VssBadStateException();
+      }
+
+      private static void CheckNotNull(string first, string second, string third)
+      {
+         if (first == null || second == null || third == null)
+            throw new ArgumentNullException(first == null ? "path" : second == null ? "filespec" : "destination");
+      }
+
+      private static void Wait(Task task)
+      {
+         task.GetAwaiter().GetResult();
+      }
+
+      private static IVssAsyncResult Begin(Func<CancellationToken, Task> operation, AsyncCallback userCallback, object state)
+      {
+         return new VssSimulatedAsyncResult(operation, userCallback, state);
+      }
+
+      private static void End(IAsyncResult asyncResult)
+      {
+         if (asyncResult == null)
+            throw new ArgumentNullException(nameof(asyncResult));
+
+         VssSimulatedAsyncResult result = asyncResult as VssSimulatedAsyncResult;
+         if (result == null)
+            throw new ArgumentException("The IAsyncResult was not returned by this instance.", nameof(asyncResult));
+
+         result.EndInvoke();
+      }
+
+      private void UpdateWriterFilter(HashSet<Guid> filter, Guid[] writerIds)
+      {
+         if (writerIds == null)
+            throw new ArgumentNullException(nameof(writerIds));
+
+         Enter();
+         if (m_writerMetadata != null)
+            throw new VssBadStateException();
+
+         filter.UnionWith(writerIds);
+      }
+
+      private bool IsWriterEnabled(VssSimulatedWriter writer)
+      {
+         return (m_enabledWriterClasses.Count == 0 || m_enabledWriterClasses.Contains(writer.WriterId))
+            && !m_disabledWriterClasses.Contains(writer.WriterId)
+            && !m_disabledWriterInstances.Contains(writer.InstanceId);
+      }
+
+      private static IList<VssComponentSelectionFailure> SelectComponents(IEnumerable<VssComponentSelection> components, Action<VssComponentSelection> select)
+      {
+         if (components == null)
+            throw new ArgumentNullException(nameof(components));
+
+         VssComponentSelection[] batch = components.ToArray();
+         for (int i = 0; i < batch.Length; i++)
+         {
+            if (batch[i] == null)
+               throw new ArgumentException(String.Format("The component batch contains a null element at index {0}.", i), nameof(components));
+
+            if (batch[i].ComponentName == null)
+               throw new ArgumentException(String.Format("The component at index {0} of the batch has no component name.", i), nameof(components));
+         }
+
+         // As on the platform, a bad state concerns the backup components object rather than the component, and stops 
+         // the batch.
+         List<VssComponentSelectionFailure> failures = new List<VssComponentSelectionFailure>();
+         for (int i = 0; i < batch.Length; i++)
+         {
+            try
+            {
+               select(batch[i]);
+            }
+            catch (Exception ex) when (!(ex is ArgumentNullException || ex is ObjectDisposedException || ex is VssBadStateException))
+            {
+               failures.Add(new VssComponentSelectionFailure(i, batch[i], ex));
+            }
+         }
+
+         return failures.AsReadOnly();
+      }
+
+      private VssSimulatedComponentState FindComponent(Guid writerId, VssComponentType componentType, string logicalPath, string componentName)
+      {
+         return FindComponent(null, writerId, componentType, logicalPath, componentName);
+      }
+
+      private VssSimulatedComponentState FindComponent(Guid? instanceId, Guid writerId, VssComponentType componentType, string logicalPath, string componentName)
+      {
+         if (componentName == null)
+            throw new ArgumentNullException(nameof(componentName));
+
+         Enter();
+         if (m_mode == Mode.Uninitialized)
+            throw new VssBadStateException();
+
+         lock (m_lock)
+         {
+            VssSimulatedComponentState component = m_writerComponents
+               .Where(writer => writer.WriterId == writerId && (instanceId == null || writer.InstanceId == instanceId.Value))
+               .SelectMany(writer => writer.Components.Cast<VssSimulatedComponentState>())
+               .FirstOrDefault(c => c.Matches(componentType, logicalPath, componentName));
+
+            if (component == null)
+               throw new VssObjectNotFoundException();
+
+            return component;
+         }
+      }
+
+      private void LoadDocument(string xml)
+      {
+         XElement root;
+         try
+         {
+            root = XElement.Parse(xml);
+         }
+         catch (XmlException ex)
+         {
+            throw new VssInvalidXmlDocumentException(ex.Message, ex);
+         }
+
+         if (root.Name.LocalName != "BACKUP_COMPONENTS")
+            throw new VssInvalidXmlDocumentException();
+
+         m_selectComponents = VssXmlConvert.GetBoolean(root, "selectComponents");
+         m_backupBootableSystemState = VssXmlConvert.GetBoolean(root, "bootableSystemStateBackup");
+         m_backupType = VssXmlConvert.GetEnum<VssBackupType>(root, "backupType");
+         m_partialFileSupport = VssXmlConvert.GetBoolean(root, "partialFileSupport");
+
+         lock (m_lock)
+         {
+            m_writerComponents.Clear();
+            foreach (XElement writer in root.Elements("WRITER_COMPONENTS"))
+            {
+               VssSimulatedWriterComponents components = new VssSimulatedWriterComponents(VssXmlConvert.GetGuid(writer, "instanceId"), VssXmlConvert.GetGuid(writer, "writerId"));
+               foreach (XElement component in writer.Elements("COMPONENT"))
+                  components.Components.Add(VssSimulatedComponentState.FromXml(component));
+               m_writerComponents.Add(components);
+            }
+         }
+      }
+
+      private void CreateSnapshots()
+      {
+         DateTime created = DateTime.Now;
+         VssSnapshotProperties[] snapshots = m_snapshotSetVolumes.Select(entry => m_factory.CreateSnapshot(entry.Key, m_snapshotSetId,
+            m_snapshotSetVolumes.Count, entry.Value, m_context, created)).ToArray();
+
+         m_factory.AddSnapshots(snapshots);
+         m_createdSnapshots.AddRange(snapshots.Select(snapshot => snapshot.SnapshotId));
+         m_snapshotSetCreated = true;
+
+         // Writers record a backup stamp in each component they back up, which a later incremental or differential
+         // backup passes back as the previous backup stamp.
+         string backupStamp = created.ToUniversalTime().ToString("o", CultureInfo.InvariantCulture);
+         foreach (VssSimulatedComponentState component in m_writerComponents.SelectMany(writer => writer.Components).Cast<VssSimulatedComponentState>())
+            component.BackupStamp = backupStamp;
+      }
+
+      // Like the platform specific implementation, the writer status is captured once on the calling thread, before the 
+      // operation is started, and reported by every sample of the operation.
+      private IReadOnlyList<VssWriterStatusInfo> CaptureWriterStatus()
+      {
+         List<VssWriterStatusInfo> writerStatus = m_writerStatus;
+         return writerStatus == null ? null : writerStatus.AsReadOnly();
+      }
+
+      // Like the platform specific implementation, the progress arguments are validated before the operation is started.
+      private static void CheckProgressArguments(IProgress<VssAsyncProgress> progress, TimeSpan reportInterval)
+      {
+         if (progress == null)
+            throw new ArgumentNullException(nameof(progress));
+
+         if (reportInterval <= TimeSpan.Zero || reportInterval.TotalMilliseconds > MaxReportInterval)
+            throw new ArgumentOutOfRangeException(nameof(reportInterval), "The report interval must be greater than zero and no greater than 4294967294 milliseconds.");
+      }
+
+      private Task StartOperation(string phase, Action complete, IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, CancellationToken cancellationToken)
+      {
+         return StartOperation(phase, complete, progress, reportInterval, false, cancellationToken);
+      }
+
+      // An operation creating a snapshot set must have entered snapshot creation on the factory; it exits it when it completes.
+      private Task StartOperation(string phase, Action complete, IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, bool createsSnapshotSet, CancellationToken cancellationToken)
+      {
+         // Like VSS, only one asynchronous operation may be in progress at a time.
+         if (Interlocked.CompareExchange(ref m_operationInProgress, 1, 0) != 0)
+            throw new VssBadStateException();
+
+         IReadOnlyList<VssWriterStatusInfo> writerStatus = progress == null ? null : CaptureWriterStatus();
+         return RunOperationAsync(phase, complete, progress, reportInterval, writerStatus, createsSnapshotSet, cancellationToken);
+      }
+
+      private async Task RunOperationAsync(string phase, Action complete, IProgress<VssAsyncProgress> progress, TimeSpan reportInterval, IReadOnlyList<VssWriterStatusInfo> writerStatus, bool createsSnapshotSet, CancellationToken cancellationToken)
+      {
+         Stopwatch stopwatch = Stopwatch.StartNew();
+         bool reportPhase = VssEventSource.Log.IsEnabled(EventLevel.Informational, VssEventSource.Keywords.Phases);
+         if (reportPhase)
+            VssEventSource.Log.PhaseStarted(phase);
+
+         object reportLock = new object();
+         Timer timer = null;
+         VssError status = VssError.AsyncPending;
+         try
+         {
+            if (progress != null)
+            {
+               timer = new Timer(state =>
+               {
+                  // A report still in progress when the next one is due is not overlapped; the next one is skipped instead.
+                  if (!Monitor.TryEnter(reportLock))
+                     return;
+
+                  try
+                  {
+                     if (status == VssError.AsyncPending)
+                        Report(progress, stopwatch.Elapsed, VssError.AsyncPending, writerStatus);
+                  }
+                  finally
+                  {
+                     Monitor.Exit(reportLock);
+                  }
+               }, null, reportInterval, reportInterval);
+            }
+
+            await m_factory.SimulateOperationAsync(createsSnapshotSet ? m_factory.Options.SnapshotLatency : TimeSpan.Zero, cancellationToken).ConfigureAwait(false);
+
+            lock (m_lock)
+               complete();
+
+            status = VssError.AsyncFinished;
+         }
+         catch (OperationCanceledException)
+         {
+            status = VssError.AsyncCanceled;
+            throw;
+         }
+         catch (Exception ex)
+         {
+            status = ToVssError(ex);
+            throw;
+         }
+         finally
+         {
+            if (timer != null)
+               timer.Dispose();
+
+            Interlocked.Exchange(ref m_operationInProgress, 0);
+            if (createsSnapshotSet)
+               m_factory.ExitSnapshotCreation(this);
+
+            if (reportPhase)
+               VssEventSource.Log.PhaseCompleted(phase, (int)status, stopwatch.Elapsed.TotalMilliseconds);
+
+            if (progress != null)
+            {
+               lock (reportLock)
+                  Report(progress, stopwatch.Elapsed, status, writerStatus);
+            }
+         }
+      }
+
+      // Like the platform specific implementation, a failing progress handler loses its sample, but neither fails nor masks
+      // the outcome of the operation.
+      private static void Report(IProgress<VssAsyncProgress> progress, TimeSpan elapsed, VssError status, IReadOnlyList<VssWriterStatusInfo> writerStatus)
+      {
+         try
+         {
+            progress.Report(new VssAsyncProgress(elapsed, status, writerStatus));
+         }
+         catch (Exception)
+         {
+         }
+      }
+
+      // The status VSS reports for an operation failing with the specified exception; the inverse of the mapping of VSS
+      // error codes to exceptions performed by the platform specific implementation. Other exceptions are reported as 
+      // unexpected errors, as their HResult is not a VSS error code.
+      private static VssError ToVssError(Exception ex)
+      {
+         switch (ex)
+         {
+            case VssBadStateException _:
+               return VssError.BadState;
+            case VssObjectNotFoundException _:
+               return VssError.ObjectNotFound;
+            case VssObjectAlreadyExistsException _:
+               return VssError.ObjectAlreadyExists;
+            case VssInvalidXmlDocumentException _:
+               return VssError.InvalidXmlDocument;
+            case VssProviderNotRegisteredException _:
+               return VssError.ProviderNotRegistered;
+            case VssProviderVetoException _:
+               return VssError.ProviderVeto;
+            case VssSnapshotSetInProgressException _:
+               return VssError.SnapshotSetInProgress;
+            case VssVolumeNotSupportedException _:
+               return VssError.VolumeNotSupported;
+            case VssVolumeNotSupportedByProviderException _:
+               return VssError.VolumeNotSupportedByProvider;
+            case VssVolumeInUseException _:
+               return VssError.VolumeInUse;
+            case VssInsufficientStorageException _:
+               return VssError.InsufficientStorage;
+            case VssMaximumNumberOfVolumesReachedException _:
+               return VssError.MaximumNumberOfVolumesReached;
+            case VssMaximumNumberOfSnapshotsReachedException _:
+               return VssError.MaximumNumberOfSnapshotsReached;
+            case VssMaximumDiffAreaAssociationsReachedException _:
+               return VssError.MaximumDiffareaAssociationsReached;
+            case VssUnsupportedContextException _:
+               return VssError.UnsupportedContext;
+            case VssFlushWritesTimeoutException _:
+               return VssError.FlushWritesTimeout;
+            case VssHoldWritesTimeoutException _:
+               return VssError.HoldWritesTimeout;
+            case VssWriterNotRespondingException _:
+               return VssError.WriterNotResponding;
+            case VssWriterStatusNotAvailableException _:
+               return VssError.WriterStatusNotAvailable;
+            case VssUnexpectedProviderErrorException _:
+               return VssError.UnexpectedProviderError;
+            case VssUnexpectedWriterErrorException _:
+               return VssError.UnexpectedWriterError;
+            default:
+               return VssError.Unexpected;
+         }
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,201 @@
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Xml.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A component of a <see cref="VssSimulatedWriter"/>, as reported in the writer metadata of a simulated writer.
+   /// </summary>
+   public class VssSimulatedComponent : IVssWMComponent
+   {
+      #region Private Fields
+
+      private byte[] m_icon;
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssSimulatedComponent"/> class.
+      /// </summary>
+      /// <param name="type">The type of the component.</param>
+      /// <param name="logicalPath">The logical path of the component. May be <see langword="null"/>.</param>
+      /// <param name="componentName">The name of the component.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="componentName"/> is <see langword="null"/>.</exception>
+      public VssSimulatedComponent(VssComponentType type, string logicalPath, string componentName)
+      {
+         if (componentName == null)
+            throw new ArgumentNullException(nameof(componentName));
+
+         Type = type;
+         LogicalPath = logicalPath;
+         ComponentName = componentName;
+         Selectable = true;
+         SelectableForRestore = true;
+         Files = new List<VssWMFileDescriptor>();
+         DatabaseFiles = new List<VssWMFileDescriptor>();
+         DatabaseLogFiles = new List<VssWMFileDescriptor>();
+         Dependencies = new List<VssWMDependency>();
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>Gets the type of the component.</summary>
+      public VssComponentType Type { get; private set; }
+
+      /// <summary>Gets the logical path of the component.</summary>
+      public string LogicalPath { get; private set; }
+
+      /// <summary>Gets the name of the component.</summary>
+      public string ComponentName { get; private set; }
+
+      /// <summary>Gets or sets the description of the component.</summary>
+      public string Caption { get; set; }
+
+      /// <summary>Gets or sets a value indicating whether there is private metadata associated with the restoration of the component.</summary>
+      public bool RestoreMetadata { get; set; }
+
+      /// <summary>Gets or sets a value indicating whether the writer expects to be notified that a backup has completed.</summary>
+      public bool NotifyOnBackupComplete { get; set; }
+
+      /// <summary>Gets or sets a value indicating whether the component can be selected for backup. The default is <see langword="true"/>.</summary>
+      public bool Selectable { get; set; }
+
+      /// <summary>Gets or sets a value indicating whether the component can be selected for restore. The default is <see langword="true"/>.</summary>
+      public bool SelectableForRestore { get; set; }
+
+      /// <summary>Gets or sets the features supported by the component.</summary>
+      public VssComponentFlags ComponentFlags { get; set; }
+
+      /// <summary>Gets the file descriptors of the files of a file group component.</summary>
+      public IList<VssWMFileDescriptor> Files { get; private set; }
+
+      /// <summary>Gets the file descriptors of the database files of a database component.</summary>
+      public IList<VssWMFileDescriptor> DatabaseFiles { get; private set; }
+
+      /// <summary>Gets the file descriptors of the log files of a database component.</summary>
+      public IList<VssWMFileDescriptor> DatabaseLogFiles { get; private set; }
+
+      /// <summary>Gets the dependencies of the component on components of other writers.</summary>
+      public IList<VssWMDependency> Dependencies { get; private set; }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>Gets the icon associated with the component.</summary>
+      /// <returns>A copy of the icon set using <see cref="SetIcon"/>, or <see langword="null"/> if no icon was set.</returns>
+      public byte[] GetIcon()
+      {
+         return m_icon == null ? null : (byte[])m_icon.Clone();
+      }
+
+      /// <summary>Sets the icon associated with the component.</summary>
+      /// <param name="icon">The icon, or <see langword="null"/> to remove the icon.</param>
+      public void SetIcon(byte[] icon)
+      {
+         m_icon = icon == null ? null : (byte[])icon.Clone();
+      }
+
+      void IDisposable.Dispose()
+      {
+         // Simulated components hold no resources; they remain usable after having been returned by a simulated writer.
+      }
+
+      #endregion
+
+      #region Internal Methods
+
+      internal XElement ToXml()
+      {
+         XElement element = new XElement("COMPONENT",
+            new XAttribute("componentType", VssXmlConvert.ToString(Type)),
+            new XAttribute("componentName", ComponentName),
+            new XAttribute("restoreMetadata", VssXmlConvert.ToString(RestoreMetadata)),
+            new XAttribute("notifyOnBackupComplete", VssXmlConvert.ToString(NotifyOnBackupComplete)),
+            new XAttribute("selectable", VssXmlConvert.ToString(Selectable)),
+            new XAttribute("selectableForRestore", VssXmlConvert.ToString(SelectableForRestore)),
+            new XAttribute("componentFlags", (int)ComponentFlags));
+
+         VssXmlConvert.SetAttribute(element, "logicalPath", LogicalPath);
+         VssXmlConvert.SetAttribute(element, "caption", Caption);
+         if (m_icon != null)
+            element.SetAttributeValue("icon", Convert.ToBase64String(m_icon));
+
+         element.Add(Files.Select(file => FileDescriptorToXml("FILE_LIST", file)));
+         element.Add(DatabaseFiles.Select(file => FileDescriptorToXml("DATABASE_FILES", file)));
+         element.Add(DatabaseLogFiles.Select(file => FileDescriptorToXml("DATABASE_LOGFILES", file)));
+         element.Add(Dependencies.Select(dependency => new XElement("DEPENDENCY",
+            new XAttribute("writerId", VssXmlConvert.ToString(dependency.WriterId)),
+            new XAttribute("logicalPath", dependency.LogicalPath ?? String.Empty),
+            new XAttribute("componentName", dependency.ComponentName ?? String.Empty))));
+
+         return element;
+      }
+
+      internal static VssSimulatedComponent FromXml(XElement element)
+      {
+         VssSimulatedComponent component = new VssSimulatedComponent(
+            VssXmlConvert.ToComponentType(VssXmlConvert.GetString(element, "componentType")),
+            VssXmlConvert.GetString(element, "logicalPath"),
+            VssXmlConvert.GetString(element, "componentName") ?? String.Empty);
+
+         component.Caption = VssXmlConvert.GetString(element, "caption");
+         component.RestoreMetadata = VssXmlConvert.GetBoolean(element, "restoreMetadata");
+         component.NotifyOnBackupComplete = VssXmlConvert.GetBoolean(element, "notifyOnBackupComplete");
+         component.Selectable = VssXmlConvert.GetBoolean(element, "selectable");
+         component.SelectableForRestore = VssXmlConvert.GetBoolean(element, "selectableForRestore");
+         component.ComponentFlags = (VssComponentFlags)VssXmlConvert.GetInt32(element, "componentFlags");
+
+         string icon = VssXmlConvert.GetString(element, "icon");
+         if (icon != null)
+            component.m_icon = Convert.FromBase64String(icon);
+
+         foreach (XElement file in element.Elements("FILE_LIST"))
+            component.Files.Add(FileDescriptorFromXml(file));
+
+         foreach (XElement file in element.Elements("DATABASE_FILES"))
+            component.DatabaseFiles.Add(FileDescriptorFromXml(file));
+
+         foreach (XElement file in element.Elements("DATABASE_LOGFILES"))
+            component.DatabaseLogFiles.Add(FileDescriptorFromXml(file));
+
+         foreach (XElement dependency in element.Elements("DEPENDENCY"))
+         {
+            component.Dependencies.Add(new VssWMDependency(VssXmlConvert.GetGuid(dependency, "writerId"),
+               VssXmlConvert.GetString(dependency, "logicalPath"), VssXmlConvert.GetString(dependency, "componentName")));
+         }
+
+         return component;
+      }
+
+      internal static XElement FileDescriptorToXml(string elementName, VssWMFileDescriptor file)
+      {
+         XElement element = new XElement(elementName,
+            new XAttribute("path", file.Path ?? String.Empty),
+            new XAttribute("filespec", file.FileSpecification ?? String.Empty),
+            new XAttribute("recursive", VssXmlConvert.ToString(file.IsRecursive)),
+            new XAttribute("filespecBackupType", (int)file.BackupTypeMask));
+
+         VssXmlConvert.SetAttribute(element, "alternatePath", file.AlternateLocation);
+         return element;
+      }
+
+      internal static VssWMFileDescriptor FileDescriptorFromXml(XElement element)
+      {
+         return new VssWMFileDescriptor(VssXmlConvert.GetString(element, "alternatePath"),
+            (VssFileSpecificationBackupType)VssXmlConvert.GetInt32(element, "filespecBackupType"),
+            VssXmlConvert.GetString(element, "filespec"),
+            VssXmlConvert.GetString(element, "path"),
+            VssXmlConvert.GetBoolean(element, "recursive"));
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,176 @@
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Xml.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A component added to the backup components document of a simulated backup components object.
+   /// </summary>
+   internal sealed class VssSimulatedComponentState : IVssComponent
+   {
+      #region Constructors
+
+      public VssSimulatedComponentState(VssComponentType componentType, string logicalPath, string componentName)
+      {
+         ComponentType = componentType;
+         LogicalPath = logicalPath;
+         ComponentName = componentName;
+         AlternateLocationMappings = new List<VssWMFileDescriptor>();
+         DirectedTargets = new List<VssDirectedTargetInfo>();
+         NewTargets = new List<VssWMFileDescriptor>();
+         PartialFiles = new List<VssPartialFileInfo>();
+         DifferencedFiles = new List<VssDifferencedFileInfo>();
+         RestoreSubcomponents = new List<VssRestoreSubcomponentInfo>();
+      }
+
+      #endregion
+
+      #region IVssComponent Members
+
+      public bool AdditionalRestores { get; set; }
+      public string BackupOptions { get; set; }
+      public string BackupStamp { get; set; }
+      public bool BackupSucceeded { get; set; }
+      public string ComponentName { get; private set; }
+      public VssComponentType ComponentType { get; private set; }
+      public VssFileRestoreStatus FileRestoreStatus { get; set; }
+      public string LogicalPath { get; private set; }
+      public string PostRestoreFailureMsg { get; set; }
+      public string PreRestoreFailureMsg { get; set; }
+      public string PreviousBackupStamp { get; set; }
+      public string RestoreOptions { get; set; }
+      public VssRestoreTarget RestoreTarget { get; set; }
+      public bool IsSelectedForRestore { get; set; }
+      public IList<VssWMFileDescriptor> AlternateLocationMappings { get; private set; }
+      public IList<VssDirectedTargetInfo> DirectedTargets { get; private set; }
+      public IList<VssWMFileDescriptor> NewTargets { get; private set; }
+      public IList<VssPartialFileInfo> PartialFiles { get; private set; }
+      public IList<VssDifferencedFileInfo> DifferencedFiles { get; private set; }
+      public IList<VssRestoreSubcomponentInfo> RestoreSubcomponents { get; private set; }
+      public bool IsAuthoritativeRestore { get; set; }
+      public string PostSnapshotFailureMsg { get; private set; }
+      public string PrepareForBackupFailureMsg { get; private set; }
+      public string RestoreName { get; set; }
+      public string RollForwardRestorePoint { get; set; }
+      public VssRollForwardType RollForwardType { get; set; }
+      public VssComponentFailure Failure { get; set; }
+
+      public void SetPrepareForBackupFailureMsg(string message)
+      {
+         PrepareForBackupFailureMsg = message;
+      }
+
+      public void SetPostSnapshotFailureMsg(string message)
+      {
+         PostSnapshotFailureMsg = message;
+      }
+
+      public void Dispose()
+      {
+      }
+
+      #endregion
+
+      #region Internal Methods
+
+      internal bool Matches(VssComponentType componentType, string logicalPath, string componentName)
+      {
+         return ComponentType == componentType
+            && String.Equals(LogicalPath ?? String.Empty, logicalPath ?? String.Empty, StringComparison.OrdinalIgnoreCase)
+            && String.Equals(ComponentName, componentName, StringComparison.OrdinalIgnoreCase);
+      }
+
+      internal XElement ToXml()
+      {
+         XElement element = new XElement("COMPONENT",
+            new XAttribute("componentType", VssXmlConvert.ToString(ComponentType)),
+            new XAttribute("componentName", ComponentName),
+            new XAttribute("backupSucceeded", VssXmlConvert.ToString(BackupSucceeded)),
+            new XAttribute("additionalRestores", VssXmlConvert.ToString(AdditionalRestores)),
+            new XAttribute("selectedForRestore", VssXmlConvert.ToString(IsSelectedForRestore)),
+            new XAttribute("authoritativeRestore", VssXmlConvert.ToString(IsAuthoritativeRestore)),
+            new XAttribute("fileRestoreStatus", FileRestoreStatus),
+            new XAttribute("restoreTarget", RestoreTarget),
+            new XAttribute("rollForwardType", RollForwardType));
+
+         VssXmlConvert.SetAttribute(element, "logicalPath", LogicalPath);
+         VssXmlConvert.SetAttribute(element, "backupStamp", BackupStamp);
+         VssXmlConvert.SetAttribute(element, "previousBackupStamp", PreviousBackupStamp);
+         VssXmlConvert.SetAttribute(element, "backupOptions", BackupOptions);
+         VssXmlConvert.SetAttribute(element, "restoreOptions", RestoreOptions);
+         VssXmlConvert.SetAttribute(element, "restoreName", RestoreName);
+         VssXmlConvert.SetAttribute(element, "rollForwardRestorePoint", RollForwardRestorePoint);
+
+         element.Add(AlternateLocationMappings.Select(file => VssSimulatedComponent.FileDescriptorToXml("ALTERNATE_LOCATION_MAPPING", file)));
+         element.Add(NewTargets.Select(file => VssSimulatedComponent.FileDescriptorToXml("RESTORE_TARGET", file)));
+         element.Add(RestoreSubcomponents.Select(subcomponent => new XElement("RESTORE_SUBCOMPONENT",
+            new XAttribute("logicalPath", subcomponent.LogicalPath ?? String.Empty),
+            new XAttribute("componentName", subcomponent.ComponentName ?? String.Empty))));
+         element.Add(PartialFiles.Select(file => new XElement("PARTIAL_FILE",
+            new XAttribute("path", file.Path),
+            new XAttribute("filespec", file.FileName),
+            new XAttribute("ranges", file.Range ?? String.Empty),
+            new XAttribute("metadata", file.Metadata ?? String.Empty))));
+         element.Add(DifferencedFiles.Select(file => new XElement("DIFFERENCED_FILE",
+            new XAttribute("path", file.Path ?? String.Empty),
+            new XAttribute("filespec", file.FileSpecification ?? String.Empty),
+            new XAttribute("recursive", VssXmlConvert.ToString(file.IsRecursive)),
+            new XAttribute("lastModifyTime", VssXmlConvert.ToString(file.LastModifyTime)))));
+
+         return element;
+      }
+
+      internal static VssSimulatedComponentState FromXml(XElement element)
+      {
+         VssSimulatedComponentState component = new VssSimulatedComponentState(
+            VssXmlConvert.ToComponentType(VssXmlConvert.GetString(element, "componentType")),
+            VssXmlConvert.GetString(element, "logicalPath"),
+            VssXmlConvert.GetString(element, "componentName") ?? String.Empty);
+
+         component.BackupSucceeded = VssXmlConvert.GetBoolean(element, "backupSucceeded");
+         component.AdditionalRestores = VssXmlConvert.GetBoolean(element, "additionalRestores");
+         component.IsSelectedForRestore = VssXmlConvert.GetBoolean(element, "selectedForRestore");
+         component.IsAuthoritativeRestore = VssXmlConvert.GetBoolean(element, "authoritativeRestore");
+         component.FileRestoreStatus = VssXmlConvert.GetEnum<VssFileRestoreStatus>(element, "fileRestoreStatus");
+         component.RestoreTarget = VssXmlConvert.GetEnum<VssRestoreTarget>(element, "restoreTarget");
+         component.RollForwardType = VssXmlConvert.GetEnum<VssRollForwardType>(element, "rollForwardType");
+         component.BackupStamp = VssXmlConvert.GetString(element, "backupStamp");
+         component.PreviousBackupStamp = VssXmlConvert.GetString(element, "previousBackupStamp");
+         component.BackupOptions = VssXmlConvert.GetString(element, "backupOptions");
+         component.RestoreOptions = VssXmlConvert.GetString(element, "restoreOptions");
+         component.RestoreName = VssXmlConvert.GetString(element, "restoreName");
+         component.RollForwardRestorePoint = VssXmlConvert.GetString(element, "rollForwardRestorePoint");
+
+         foreach (XElement file in element.Elements("ALTERNATE_LOCATION_MAPPING"))
+            component.AlternateLocationMappings.Add(VssSimulatedComponent.FileDescriptorFromXml(file));
+
+         foreach (XElement file in element.Elements("RESTORE_TARGET"))
+            component.NewTargets.Add(VssSimulatedComponent.FileDescriptorFromXml(file));
+
+         foreach (XElement subcomponent in element.Elements("RESTORE_SUBCOMPONENT"))
+         {
+            component.RestoreSubcomponents.Add(new VssRestoreSubcomponentInfo(VssXmlConvert.GetString(subcomponent, "logicalPath"),
+               VssXmlConvert.GetString(subcomponent, "componentName")));
+         }
+
+         foreach (XElement file in element.Elements("PARTIAL_FILE"))
+         {
+            component.PartialFiles.Add(new VssPartialFileInfo(VssXmlConvert.GetString(file, "path") ?? String.Empty,
+               VssXmlConvert.GetString(file, "filespec") ?? String.Empty, VssXmlConvert.GetString(file, "ranges"), VssXmlConvert.GetString(file, "metadata")));
+         }
+
+         foreach (XElement file in element.Elements("DIFFERENCED_FILE"))
+         {
+            component.DifferencedFiles.Add(new VssDifferencedFileInfo(VssXmlConvert.GetString(file, "path"), VssXmlConvert.GetString(file, "filespec"),
+               VssXmlConvert.GetBoolean(file, "recursive"), VssXmlConvert.ToDateTime(VssXmlConvert.GetString(file, "lastModifyTime"))));
+         }
+
+         return component;
+      }
+
+      #endregion
+   }
+}
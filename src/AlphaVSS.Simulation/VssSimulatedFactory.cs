@@ -0,0 +1,311 @@
+
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// An <see cref="IVssFactory"/> backed by an in-memory simulation of the VSS service, rather than by the platform specific AlphaVSS assembly.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///      The simulation runs on any platform supported by .NET, and allows code written against the AlphaVSS interfaces to be tested 
+   ///      and load-tested without a live VSS service. The writers, volumes, existing snapshots and latencies of the simulated system are 
+   ///      described by a <see cref="VssSimulationOptions"/> instance.
+   ///   </para>
+   ///   <para>
+   ///      The simulation replaces the platform specific assembly as a whole. None of its code runs, so the simulation does not exercise 
+   ///      the marshaling of VSS structures, the enumeration of VSS objects or the completion of VSS asynchronous operations performed 
+   ///      by that assembly; those must be tested against the platform specific assembly itself.
+   ///   </para>
+   ///   <para>
+   ///      Snapshots are shared by all objects created by the same factory. The simulation follows the sequence of calls and the state
+   ///      checks of a backup or restore as performed by VSS, but does not access any volumes, and does not support transportable snapshots,
+   ///      recovery sets or reverting volumes. Asynchronous operations are reported to the <see cref="VssEventSource"/> like those of the
+   ///      platform specific implementation.
+   ///   </para>
+   ///   <para>
+   ///      All members of this class are thread-safe.
+   ///   </para>
+   /// </remarks>
+   public sealed class VssSimulatedFactory : IVssFactory
+   {
+      #region Private Fields
+
+      private readonly object m_lock = new object();
+      private readonly List<VssSnapshotProperties> m_snapshots = new List<VssSnapshotProperties>();
+      private readonly List<VssDiffAreaProperties> m_diffAreas = new List<VssDiffAreaProperties>();
+      private readonly Dictionary<string, VssProtectionLevel> m_protectionLevels = new Dictionary<string, VssProtectionLevel>(StringComparer.OrdinalIgnoreCase);
+      private long m_deviceCount;
+      private object m_snapshotSetOwner;
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssSimulatedFactory"/> class, simulating the system described by the default <see cref="VssSimulationOptions"/>.
+      /// </summary>
+      public VssSimulatedFactory()
+         : this(new VssSimulationOptions())
+      {
+      }
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssSimulatedFactory"/> class.
+      /// </summary>
+      /// <param name="options">The description of the simulated system.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="options"/> is <see langword="null"/>.</exception>
+      public VssSimulatedFactory(VssSimulationOptions options)
+      {
+         if (options == null)
+            throw new ArgumentNullException(nameof(options));
+
+         Options = options;
+
+         if (options.SnapshotCount > 0 && options.Volumes.Count > 0)
+         {
+            DateTime created = DateTime.Now;
+            for (int i = 0; i < options.SnapshotCount; i++)
+            {
+               m_snapshots.Add(CreateSnapshot(Guid.NewGuid(), Guid.NewGuid(), 1, options.Volumes[i % options.Volumes.Count],
+                  (VssVolumeSnapshotAttributes)VssSnapshotContext.ClientAccessible, created));
+            }
+         }
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the description of the simulated system.
+      /// </summary>
+      public VssSimulationOptions Options { get; private set; }
+
+      #endregion
+
+      #region IVssFactory Members
+
+      /// <summary>
+      /// Creates a simulated <see cref="IVssBackupComponents"/> instance.
+      /// </summary>
+      /// <returns>A simulated <see cref="IVssBackupComponents"/> instance.</returns>
+      public IVssBackupComponents CreateVssBackupComponents()
+      {
+         return new VssSimulatedBackupComponents(this);
+      }
+
+      /// <summary>
+      /// Creates a simulated <see cref="IVssSnapshotManagement"/> instance.
+      /// </summary>
+      /// <returns>A simulated <see cref="IVssSnapshotManagement"/> instance.</returns>
+      public IVssSnapshotManagement CreateVssSnapshotManagement()
+      {
+         return new VssSimulatedSnapshotManagement(this);
+      }
+
+      /// <summary>
+      /// Loads writer metadata saved by <see cref="VssSimulatedWriter.SaveAsXml"/>.
+      /// </summary>
+      /// <param name="xml">The writer metadata document.</param>
+      /// <returns>A <see cref="VssSimulatedWriter"/> loaded from <paramref name="xml"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="xml"/> is <see langword="null"/>.</exception>
+      /// <exception cref="VssInvalidXmlDocumentException"><paramref name="xml"/> is not a valid writer metadata document.</exception>
+      public IVssExamineWriterMetadata CreateVssExamineWriterMetadata(string xml)
+      {
+         if (xml == null)
+            throw new ArgumentNullException(nameof(xml));
+
+         SimulateCall();
+         VssSimulatedWriter writer = new VssSimulatedWriter();
+         if (!writer.LoadFromXml(xml))
+            throw new VssInvalidXmlDocumentException();
+
+         return writer;
+      }
+
+      /// <summary>
+      /// Gets a simulated <see cref="IVssInfoProvider"/> instance.
+      /// </summary>
+      /// <returns>A simulated <see cref="IVssInfoProvider"/> instance.</returns>
+      public IVssInfoProvider GetInfoProvider()
+      {
+         return new InfoProvider(this);
+      }
+
+      #endregion
+
+      #region Internal Methods
+
+      internal void SimulateCall()
+      {
+         TimeSpan latency = Options.CallLatency;
+         if (latency > TimeSpan.Zero)
+            Thread.Sleep(latency);
+      }
+
+      internal Task SimulateOperationAsync(CancellationToken cancellationToken)
+      {
+         return SimulateOperationAsync(TimeSpan.Zero, cancellationToken);
+      }
+
+      internal Task SimulateOperationAsync(TimeSpan additionalLatency, CancellationToken cancellationToken)
+      {
+         TimeSpan latency = Options.OperationLatency + additionalLatency;
+         if (latency > TimeSpan.Zero)
+            return Task.Delay(latency, cancellationToken);
+
+         cancellationToken.ThrowIfCancellationRequested();
+         return Task.FromResult(0);
+      }
+
+      // Only one snapshot set can be in the process of being created on a system at a time; as with VSS, a snapshot set is
+      // in progress from StartSnapshotSet until DoSnapshotSet completes or the backup is aborted.
+      internal bool TryEnterSnapshotCreation(object owner)
+      {
+         object current = Interlocked.CompareExchange(ref m_snapshotSetOwner, owner, null);
+         return current == null || current == owner;
+      }
+
+      internal void ExitSnapshotCreation(object owner)
+      {
+         Interlocked.CompareExchange(ref m_snapshotSetOwner, null, owner);
+      }
+
+      // Returns the configured name of the specified volume, or null if the volume is not part of the simulated system.
+      internal string FindVolume(string volumeName)
+      {
+         if (volumeName == null)
+            throw new ArgumentNullException(nameof(volumeName));
+
+         string normalized = volumeName.TrimEnd('\\');
+         return Options.Volumes.FirstOrDefault(volume => String.Equals(volume.TrimEnd('\\'), normalized, StringComparison.OrdinalIgnoreCase));
+      }
+
+      internal VssSnapshotProperties CreateSnapshot(Guid snapshotId, Guid snapshotSetId, long snapshotCount, string volumeName, VssVolumeSnapshotAttributes attributes, DateTime created)
+      {
+         long device = Interlocked.Increment(ref m_deviceCount);
+         return new VssSnapshotProperties(snapshotId, snapshotSetId, snapshotCount,
+            String.Format(CultureInfo.InvariantCulture, @"\\?\GLOBALROOT\Device\HarddiskVolumeShadowCopy{0}", device),
+            volumeName, Options.MachineName, Options.MachineName, null, null, Options.ProviderId, attributes, created, VssSnapshotState.Created);
+      }
+
+      internal void AddSnapshots(IEnumerable<VssSnapshotProperties> snapshots)
+      {
+         lock (m_lock)
+            m_snapshots.AddRange(snapshots);
+      }
+
+      internal VssSnapshotProperties[] GetSnapshots()
+      {
+         lock (m_lock)
+            return m_snapshots.ToArray();
+      }
+
+      internal VssSnapshotProperties[] GetSnapshots(int position, int count)
+      {
+         lock (m_lock)
+         {
+            if (position >= m_snapshots.Count)
+               return new VssSnapshotProperties[0];
+
+            return m_snapshots.GetRange(position, Math.Min(count, m_snapshots.Count - position)).ToArray();
+         }
+      }
+
+      internal VssSnapshotProperties GetSnapshot(Guid snapshotId)
+      {
+         lock (m_lock)
+         {
+            VssSnapshotProperties snapshot = m_snapshots.Find(s => s.SnapshotId == snapshotId);
+            if (snapshot == null)
+               throw new VssObjectNotFoundException();
+            return snapshot;
+         }
+      }
+
+      internal void ReplaceSnapshot(VssSnapshotProperties snapshot)
+      {
+         lock (m_lock)
+         {
+            int index = m_snapshots.FindIndex(s => s.SnapshotId == snapshot.SnapshotId);
+            if (index < 0)
+               throw new VssObjectNotFoundException();
+            m_snapshots[index] = snapshot;
+         }
+      }
+
+      internal int DeleteSnapshots(Predicate<VssSnapshotProperties> match)
+      {
+         lock (m_lock)
+            return m_snapshots.RemoveAll(match);
+      }
+
+      internal List<VssDiffAreaProperties> DiffAreas
+      {
+         get
+         {
+            return m_diffAreas;
+         }
+      }
+
+      internal Dictionary<string, VssProtectionLevel> ProtectionLevels
+      {
+         get
+         {
+            return m_protectionLevels;
+         }
+      }
+
+      internal object SyncRoot
+      {
+         get
+         {
+            return m_lock;
+         }
+      }
+
+      #endregion
+
+      #region Nested Types
+
+      private sealed class InfoProvider : IVssInfoProvider
+      {
+         private readonly VssSimulatedFactory m_factory;
+
+         public InfoProvider(VssSimulatedFactory factory)
+         {
+            m_factory = factory;
+         }
+
+         public bool IsVolumeSnapshotted(string volumeName)
+         {
+            string volume = m_factory.FindVolume(volumeName);
+            return volume != null && m_factory.GetSnapshots().Any(snapshot => snapshot.OriginalVolumeName == volume);
+         }
+
+         public VssSnapshotCompatibility GetSnapshotCompatibility(string volumeName)
+         {
+            if (m_factory.FindVolume(volumeName) == null)
+               throw new VssObjectNotFoundException();
+
+            return VssSnapshotCompatibility.None;
+         }
+
+         public bool ShouldBlockRevert(string volumeName)
+         {
+            if (m_factory.FindVolume(volumeName) == null)
+               throw new VssObjectNotFoundException();
+
+            return false;
+         }
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,211 @@
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// The snapshot management and differential software snapshot management of a <see cref="VssSimulatedFactory"/>.
+   /// </summary>
+   /// <remarks>
+   /// Diff areas are kept in memory, and shared by all objects created by the same factory. Any volume of the simulated system can
+   /// hold a diff area for any other volume, and reports unlimited free space.
+   /// </remarks>
+   internal sealed class VssSimulatedSnapshotManagement : IVssSnapshotManagement, IVssBatchDifferentialSoftwareSnapshotManagement
+   {
+      #region Private Fields
+
+      private const long MinDiffAreaSize = 320 * 1024 * 1024;
+
+      private readonly VssSimulatedFactory m_factory;
+
+      #endregion
+
+      #region Constructors
+
+      public VssSimulatedSnapshotManagement(VssSimulatedFactory factory)
+      {
+         m_factory = factory;
+      }
+
+      #endregion
+
+      #region IVssSnapshotManagement Members
+
+      public IVssDifferentialSoftwareSnapshotManagement GetDifferentialSoftwareSnapshotManagementInterface()
+      {
+         return this;
+      }
+
+      public long GetMinDiffAreaSize()
+      {
+         m_factory.SimulateCall();
+         return MinDiffAreaSize;
+      }
+
+      #endregion
+
+      #region IVssDifferentialSoftwareSnapshotManagement Members
+
+      public void AddDiffArea(string volumeName, string diffAreaVolumeName, long maximumDiffSpace)
+      {
+         m_factory.SimulateCall();
+         string volume = RequireVolume(volumeName);
+         string diffAreaVolume = RequireVolume(diffAreaVolumeName);
+         if (maximumDiffSpace != -1 && maximumDiffSpace < MinDiffAreaSize)
+            throw new ArgumentOutOfRangeException(nameof(maximumDiffSpace), maximumDiffSpace, "The maximum diff space is less than the minimum diff area size.");
+
+         lock (m_factory.SyncRoot)
+         {
+            if (m_factory.DiffAreas.Any(diffArea => diffArea.VolumeName == volume && diffArea.DiffAreaVolumeName == diffAreaVolume))
+               throw new VssObjectAlreadyExistsException();
+
+            m_factory.DiffAreas.Add(new VssDiffAreaProperties(volume, diffAreaVolume, maximumDiffSpace, 0, 0));
+         }
+      }
+
+      public void ChangeDiffAreaMaximumSize(string volumeName, string diffAreaVolumeName, long maximumDiffSpace)
+      {
+         ChangeDiffAreaMaximumSize(volumeName, diffAreaVolumeName, maximumDiffSpace, false);
+      }
+
+      public void ChangeDiffAreaMaximumSize(string volumeName, string diffAreaVolumeName, long maximumDiffSpace, bool isVolatile)
+      {
+         m_factory.SimulateCall();
+         string volume = RequireVolume(volumeName);
+         string diffAreaVolume = RequireVolume(diffAreaVolumeName);
+
+         lock (m_factory.SyncRoot)
+         {
+            int index = m_factory.DiffAreas.FindIndex(diffArea => diffArea.VolumeName == volume && diffArea.DiffAreaVolumeName == diffAreaVolume);
+            if (index < 0)
+               throw new VssObjectNotFoundException();
+
+            VssDiffAreaProperties current = m_factory.DiffAreas[index];
+            if (maximumDiffSpace == 0)
+               m_factory.DiffAreas.RemoveAt(index);
+            else
+               m_factory.DiffAreas[index] = new VssDiffAreaProperties(volume, diffAreaVolume, maximumDiffSpace, current.AllocatedDiffSpace, current.UsedDiffSpace);
+         }
+      }
+
+      public IList<VssDiffAreaProperties> QueryDiffAreasForSnapshot(Guid snapshotId)
+      {
+         return EnumerateDiffAreasForSnapshot(snapshotId, Int32.MaxValue).ToList();
+      }
+
+      public IList<VssDiffAreaProperties> QueryDiffAreasForVolume(string volumeName)
+      {
+         return EnumerateDiffAreasForVolume(volumeName, Int32.MaxValue).ToList();
+      }
+
+      public IList<VssDiffAreaProperties> QueryDiffAreasOnVolume(string volumeName)
+      {
+         return EnumerateDiffAreasOnVolume(volumeName, Int32.MaxValue).ToList();
+      }
+
+      public IList<VssDiffVolumeProperties> QueryVolumesSupportedForDiffAreas(string originalVolumeName)
+      {
+         return EnumerateVolumesSupportedForDiffAreas(originalVolumeName, Int32.MaxValue).ToList();
+      }
+
+      public IEnumerable<VssDiffAreaProperties> EnumerateDiffAreasForSnapshot(Guid snapshotId, int batchSize)
+      {
+         CheckBatchSize(batchSize);
+         m_factory.SimulateCall();
+         string volume = m_factory.GetSnapshot(snapshotId).OriginalVolumeName;
+         return GetDiffAreas(diffArea => diffArea.VolumeName == volume);
+      }
+
+      public IEnumerable<VssDiffAreaProperties> EnumerateDiffAreasForVolume(string volumeName, int batchSize)
+      {
+         CheckBatchSize(batchSize);
+         m_factory.SimulateCall();
+         string volume = RequireVolume(volumeName);
+         return GetDiffAreas(diffArea => diffArea.VolumeName == volume);
+      }
+
+      public IEnumerable<VssDiffAreaProperties> EnumerateDiffAreasOnVolume(string volumeName, int batchSize)
+      {
+         CheckBatchSize(batchSize);
+         m_factory.SimulateCall();
+         string volume = RequireVolume(volumeName);
+         return GetDiffAreas(diffArea => diffArea.DiffAreaVolumeName == volume);
+      }
+
+      public IEnumerable<VssDiffVolumeProperties> EnumerateVolumesSupportedForDiffAreas(string originalVolumeName, int batchSize)
+      {
+         CheckBatchSize(batchSize);
+         m_factory.SimulateCall();
+         RequireVolume(originalVolumeName);
+         return m_factory.Options.Volumes.Select(volume => new VssDiffVolumeProperties(volume, volume, Int64.MaxValue, Int64.MaxValue)).ToArray();
+      }
+
+      public void ClearVolumeProtectFault(string volumeName)
+      {
+         m_factory.SimulateCall();
+         RequireVolume(volumeName);
+      }
+
+      public void DeleteUnusedDiffAreas(string diffAreaVolumeName)
+      {
+         m_factory.SimulateCall();
+         string diffAreaVolume = RequireVolume(diffAreaVolumeName);
+         HashSet<string> snapshotted = new HashSet<string>(m_factory.GetSnapshots().Select(snapshot => snapshot.OriginalVolumeName));
+
+         lock (m_factory.SyncRoot)
+            m_factory.DiffAreas.RemoveAll(diffArea => diffArea.DiffAreaVolumeName == diffAreaVolume && !snapshotted.Contains(diffArea.VolumeName));
+      }
+
+      public VssVolumeProtectionInfo GetVolumeProtectionLevel(string volumeName)
+      {
+         m_factory.SimulateCall();
+         string volume = RequireVolume(volumeName);
+
+         VssProtectionLevel level;
+         lock (m_factory.SyncRoot)
+         {
+            if (!m_factory.ProtectionLevels.TryGetValue(volume, out level))
+               level = VssProtectionLevel.OriginalVolume;
+         }
+
+         return new VssVolumeProtectionInfo(level, false, VssProtectionFault.None, 0, false);
+      }
+
+      public void SetVolumeProtectionLevel(string volumeName, VssProtectionLevel protectionLevel)
+      {
+         m_factory.SimulateCall();
+         string volume = RequireVolume(volumeName);
+
+         lock (m_factory.SyncRoot)
+            m_factory.ProtectionLevels[volume] = protectionLevel;
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private string RequireVolume(string volumeName)
+      {
+         string volume = m_factory.FindVolume(volumeName);
+         if (volume == null)
+            throw new VssObjectNotFoundException();
+         return volume;
+      }
+
+      private VssDiffAreaProperties[] GetDiffAreas(Predicate<VssDiffAreaProperties> match)
+      {
+         lock (m_factory.SyncRoot)
+            return m_factory.DiffAreas.FindAll(match).ToArray();
+      }
+
+      private static void CheckBatchSize(int batchSize)
+      {
+         if (batchSize < 1)
+            throw new ArgumentOutOfRangeException(nameof(batchSize), "The batch size must be greater than zero.");
+      }
+
+      #endregion
+   }
+}
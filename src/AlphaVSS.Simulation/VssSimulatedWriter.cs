@@ -0,0 +1,247 @@
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Xml;
+using System.Xml.Linq;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// A writer of the system simulated by a <see cref="VssSimulatedFactory"/>.
+   /// </summary>
+   /// <remarks>
+   ///   <para>
+   ///      An instance of this class both configures the writer and serves as its metadata; it is the object returned by
+   ///      <see cref="IVssBackupComponents.WriterMetadata"/> of a simulated backup components object once writer metadata has been gathered.
+   ///   </para>
+   ///   <para>
+   ///      Setting <see cref="State"/> and <see cref="Failure"/> allows simulating writers that fail, as reported by
+   ///      <see cref="IVssBackupComponents.WriterStatus"/>.
+   ///   </para>
+   /// </remarks>
+   public class VssSimulatedWriter : IVssExamineWriterMetadata
+   {
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new, empty instance of the <see cref="VssSimulatedWriter"/> class, to be populated using <see cref="LoadFromXml"/>.
+      /// </summary>
+      public VssSimulatedWriter()
+         : this(Guid.Empty, Guid.Empty, String.Empty)
+      {
+      }
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssSimulatedWriter"/> class.
+      /// </summary>
+      /// <param name="writerId">The class identifier of the writer.</param>
+      /// <param name="instanceId">The instance identifier of the writer.</param>
+      /// <param name="writerName">The name of the writer.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="writerName"/> is <see langword="null"/>.</exception>
+      public VssSimulatedWriter(Guid writerId, Guid instanceId, string writerName)
+      {
+         if (writerName == null)
+            throw new ArgumentNullException(nameof(writerName));
+
+         WriterId = writerId;
+         InstanceId = instanceId;
+         WriterName = writerName;
+         Usage = VssUsageType.UserData;
+         Source = VssSourceType.Other;
+         Version = new Version(1, 0);
+         State = VssWriterState.Stable;
+         Failure = VssError.Success;
+         RestoreMethod = new VssWMRestoreMethod(VssRestoreMethod.RestoreIfNotThere, null, null, VssWriterRestore.Never, false, 0);
+         Components = new List<IVssWMComponent>();
+         AlternateLocationMappings = new List<VssWMFileDescriptor>();
+         ExcludeFiles = new List<VssWMFileDescriptor>();
+         ExcludeFromSnapshotFiles = new List<VssWMFileDescriptor>();
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>Gets or sets the class identifier of the writer.</summary>
+      public Guid WriterId { get; set; }
+
+      /// <summary>Gets or sets the instance identifier of the writer.</summary>
+      public Guid InstanceId { get; set; }
+
+      /// <summary>Gets or sets the name of the writer.</summary>
+      public string WriterName { get; set; }
+
+      /// <summary>Gets or sets the name of the writer instance.</summary>
+      public string InstanceName { get; set; }
+
+      /// <summary>Gets or sets the usage type of the data backed up by the writer. The default is <see cref="VssUsageType.UserData"/>.</summary>
+      public VssUsageType Usage { get; set; }
+
+      /// <summary>Gets or sets the type of the data source of the writer. The default is <see cref="VssSourceType.Other"/>.</summary>
+      public VssSourceType Source { get; set; }
+
+      /// <summary>Gets or sets the backup schema supported by the writer.</summary>
+      public VssBackupSchema BackupSchema { get; set; }
+
+      /// <summary>Gets or sets the version of the writer. The default is 1.0.</summary>
+      public Version Version { get; set; }
+
+      /// <summary>Gets or sets the restore method of the writer.</summary>
+      public VssWMRestoreMethod RestoreMethod { get; set; }
+
+      /// <summary>Gets the components of the writer. Components added to this list must be <see cref="VssSimulatedComponent"/> instances.</summary>
+      public IList<IVssWMComponent> Components { get; private set; }
+
+      /// <summary>Gets the alternate location mappings of the writer.</summary>
+      public IList<VssWMFileDescriptor> AlternateLocationMappings { get; private set; }
+
+      /// <summary>Gets the files excluded from backup by the writer.</summary>
+      public IList<VssWMFileDescriptor> ExcludeFiles { get; private set; }
+
+      /// <summary>Gets the files excluded from snapshots by the writer.</summary>
+      public IList<VssWMFileDescriptor> ExcludeFromSnapshotFiles { get; private set; }
+
+      /// <summary>Gets or sets the state reported for the writer by <see cref="IVssBackupComponents.GatherWriterStatus"/>. The default is <see cref="VssWriterState.Stable"/>.</summary>
+      public VssWriterState State { get; set; }
+
+      /// <summary>Gets or sets the failure reported for the writer by <see cref="IVssBackupComponents.GatherWriterStatus"/>. The default is <see cref="VssError.Success"/>.</summary>
+      public VssError Failure { get; set; }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Adds a component to the writer.
+      /// </summary>
+      /// <param name="type">The type of the component.</param>
+      /// <param name="logicalPath">The logical path of the component. May be <see langword="null"/>.</param>
+      /// <param name="componentName">The name of the component.</param>
+      /// <returns>The new component, which may be further configured.</returns>
+      public VssSimulatedComponent AddComponent(VssComponentType type, string logicalPath, string componentName)
+      {
+         VssSimulatedComponent component = new VssSimulatedComponent(type, logicalPath, componentName);
+         Components.Add(component);
+         return component;
+      }
+
+      /// <summary>
+      /// Loads the writer from an XML document created by <see cref="SaveAsXml"/>, replacing its current configuration.
+      /// </summary>
+      /// <param name="xml">The XML document.</param>
+      /// <returns><see langword="true"/> if the document was loaded, or <see langword="false"/> if it is not a valid writer metadata document.</returns>
+      public bool LoadFromXml(string xml)
+      {
+         if (xml == null)
+            throw new ArgumentNullException(nameof(xml));
+
+         XElement root;
+         try
+         {
+            root = XElement.Parse(xml);
+         }
+         catch (XmlException)
+         {
+            return false;
+         }
+
+         if (root.Name.LocalName != "WRITER_METADATA")
+            return false;
+
+         WriterId = VssXmlConvert.GetGuid(root, "writerId");
+         InstanceId = VssXmlConvert.GetGuid(root, "instanceId");
+         WriterName = VssXmlConvert.GetString(root, "friendlyName") ?? String.Empty;
+         InstanceName = VssXmlConvert.GetString(root, "instanceName");
+         Usage = VssXmlConvert.GetEnum<VssUsageType>(root, "usage");
+         Source = VssXmlConvert.GetEnum<VssSourceType>(root, "dataSource");
+         BackupSchema = (VssBackupSchema)VssXmlConvert.GetInt32(root, "backupSchema");
+
+         Version version;
+         Version = Version.TryParse(VssXmlConvert.GetString(root, "version") ?? String.Empty, out version) ? version : new Version(0, 0);
+
+         XElement restoreMethod = root.Element("RESTORE_METHOD");
+         RestoreMethod = restoreMethod == null ? null : new VssWMRestoreMethod(
+            VssXmlConvert.GetEnum<VssRestoreMethod>(restoreMethod, "method"),
+            VssXmlConvert.GetString(restoreMethod, "service"),
+            VssXmlConvert.GetString(restoreMethod, "userProcedure"),
+            VssXmlConvert.GetEnum<VssWriterRestore>(restoreMethod, "writerRestore"),
+            VssXmlConvert.GetBoolean(restoreMethod, "rebootRequired"),
+            VssXmlConvert.GetInt32(restoreMethod, "mappings"));
+
+         Load(AlternateLocationMappings, root, "ALTERNATE_LOCATION_MAPPING");
+         Load(ExcludeFiles, root, "EXCLUDE_FILES");
+         Load(ExcludeFromSnapshotFiles, root, "EXCLUDE_FROM_SNAPSHOT");
+
+         Components.Clear();
+         foreach (XElement component in root.Elements("COMPONENT"))
+            Components.Add(VssSimulatedComponent.FromXml(component));
+
+         return true;
+      }
+
+      /// <summary>
+      /// Saves the writer as an XML document that can be loaded using <see cref="LoadFromXml"/> or <see cref="IVssFactory.CreateVssExamineWriterMetadata"/>.
+      /// </summary>
+      /// <returns>The XML document.</returns>
+      public string SaveAsXml()
+      {
+         XElement root = new XElement("WRITER_METADATA",
+            new XAttribute("writerId", VssXmlConvert.ToString(WriterId)),
+            new XAttribute("instanceId", VssXmlConvert.ToString(InstanceId)),
+            new XAttribute("friendlyName", WriterName ?? String.Empty),
+            new XAttribute("usage", Usage),
+            new XAttribute("dataSource", Source),
+            new XAttribute("backupSchema", (int)BackupSchema));
+
+         VssXmlConvert.SetAttribute(root, "instanceName", InstanceName);
+         if (Version != null)
+            root.SetAttributeValue("version", Version.ToString());
+
+         if (RestoreMethod != null)
+         {
+            XElement restoreMethod = new XElement("RESTORE_METHOD",
+               new XAttribute("method", RestoreMethod.Method),
+               new XAttribute("writerRestore", RestoreMethod.WriterRestore),
+               new XAttribute("rebootRequired", VssXmlConvert.ToString(RestoreMethod.RebootRequired)),
+               new XAttribute("mappings", RestoreMethod.MappingCount));
+            VssXmlConvert.SetAttribute(restoreMethod, "service", RestoreMethod.Service);
+            VssXmlConvert.SetAttribute(restoreMethod, "userProcedure", RestoreMethod.UserProcedure);
+            root.Add(restoreMethod);
+         }
+
+         root.Add(AlternateLocationMappings.Select(file => VssSimulatedComponent.FileDescriptorToXml("ALTERNATE_LOCATION_MAPPING", file)));
+         root.Add(ExcludeFiles.Select(file => VssSimulatedComponent.FileDescriptorToXml("EXCLUDE_FILES", file)));
+         root.Add(ExcludeFromSnapshotFiles.Select(file => VssSimulatedComponent.FileDescriptorToXml("EXCLUDE_FROM_SNAPSHOT", file)));
+         root.Add(Components.Select(component => GetSimulatedComponent(component).ToXml()));
+
+         return root.ToString(SaveOptions.DisableFormatting);
+      }
+
+      void IDisposable.Dispose()
+      {
+         // A simulated writer is its own metadata, and remains usable after the metadata has been disposed.
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private static void Load(IList<VssWMFileDescriptor> list, XElement root, string elementName)
+      {
+         list.Clear();
+         foreach (XElement file in root.Elements(elementName))
+            list.Add(VssSimulatedComponent.FileDescriptorFromXml(file));
+      }
+
+      private static VssSimulatedComponent GetSimulatedComponent(IVssWMComponent component)
+      {
+         VssSimulatedComponent simulated = component as VssSimulatedComponent;
+         if (simulated == null)
+            throw new InvalidOperationException("The components of a simulated writer must be VssSimulatedComponent instances.");
+         return simulated;
+      }
+
+      #endregion
+   }
+}
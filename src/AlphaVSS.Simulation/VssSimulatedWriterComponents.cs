@@ -0,0 +1,25 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// The components of a single writer instance added to the backup components document of a simulated backup components object.
+   /// </summary>
+   internal sealed class VssSimulatedWriterComponents : IVssWriterComponents
+   {
+      public VssSimulatedWriterComponents(Guid instanceId, Guid writerId)
+      {
+         InstanceId = instanceId;
+         WriterId = writerId;
+         Components = new List<IVssComponent>();
+      }
+
+      public IList<IVssComponent> Components { get; private set; }
+
+      public Guid InstanceId { get; private set; }
+
+      public Guid WriterId { get; private set; }
+   }
+}
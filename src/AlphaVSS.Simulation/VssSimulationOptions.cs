@@ -0,0 +1,93 @@
+
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   /// Describes the system simulated by a <see cref="VssSimulatedFactory"/>: its writers, volumes, existing snapshots and
+   /// the latency of the simulated VSS service.
+   /// </summary>
+   /// <remarks>
+   /// The options are read by the <see cref="VssSimulatedFactory"/> whenever they are needed, so changes made after the
+   /// factory has been created affect subsequent operations. The options must not be modified while operations are in progress.
+   /// </remarks>
+   public class VssSimulationOptions
+   {
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssSimulationOptions"/> class, describing a system with a single volume
+      /// (<c>C:\</c>), no writers, no existing snapshots and no latency.
+      /// </summary>
+      public VssSimulationOptions()
+      {
+         Writers = new List<VssSimulatedWriter>();
+         Volumes = new List<string> { @"C:\" };
+         ProviderId = new Guid("b5946137-7b9f-4925-af80-51abd60b20d5");
+         ProviderName = "Microsoft Software Shadow Copy provider 1.0";
+         MachineName = "SIMULATED";
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the writers reporting metadata and status to the simulated requester.
+      /// </summary>
+      public IList<VssSimulatedWriter> Writers { get; private set; }
+
+      /// <summary>
+      /// Gets the names of the volumes that can be added to a snapshot set.
+      /// </summary>
+      /// <remarks>Volume names are compared without regard to case or to a trailing backslash.</remarks>
+      public IList<string> Volumes { get; private set; }
+
+      /// <summary>
+      /// Gets or sets the number of persistent snapshots existing when the <see cref="VssSimulatedFactory"/> is created.
+      /// </summary>
+      /// <remarks>The snapshots are distributed evenly over <see cref="Volumes"/>, one snapshot set per snapshot.</remarks>
+      public int SnapshotCount { get; set; }
+
+      /// <summary>
+      /// Gets or sets the time each asynchronous operation (such as <see cref="IVssBackupComponents.DoSnapshotSet"/>) takes to complete.
+      /// </summary>
+      public TimeSpan OperationLatency { get; set; }
+
+      /// <summary>
+      /// Gets or sets the additional time <see cref="IVssBackupComponents.DoSnapshotSet"/> takes to complete, simulating the 
+      /// time writes are frozen while the snapshots are created.
+      /// </summary>
+      /// <remarks>
+      ///   Like VSS, the simulated system creates one snapshot set at a time; <see cref="IVssBackupComponents.StartSnapshotSet"/> 
+      ///   throws <see cref="VssSnapshotSetInProgressException"/> while another simulated backup components object of the same 
+      ///   <see cref="VssSimulatedFactory"/> has started a snapshot set that <see cref="IVssBackupComponents.DoSnapshotSet"/> 
+      ///   has not yet completed, and that has not been aborted.
+      /// </remarks>
+      public TimeSpan SnapshotLatency { get; set; }
+
+      /// <summary>
+      /// Gets or sets the time each synchronous call (such as <see cref="IVssBackupComponents.AddComponent"/>) takes to complete.
+      /// </summary>
+      /// <remarks>Latencies below the resolution of the system timer are not simulated accurately.</remarks>
+      public TimeSpan CallLatency { get; set; }
+
+      /// <summary>
+      /// Gets or sets the identifier of the single snapshot provider of the simulated system.
+      /// </summary>
+      public Guid ProviderId { get; set; }
+
+      /// <summary>
+      /// Gets or sets the name of the single snapshot provider of the simulated system.
+      /// </summary>
+      public string ProviderName { get; set; }
+
+      /// <summary>
+      /// Gets or sets the name of the simulated machine, reported as the originating and service machine of snapshots.
+      /// </summary>
+      public string MachineName { get; set; }
+
+      #endregion
+   }
+}